@@ -0,0 +1,111 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "kdlib/dbgtypedef.h"
+#include "kdlib/instruction.h"
+
+namespace kdlib {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The control flow graph of a function. The code is followed from the entry
+// by the direct jumps and branches, the parts of the function range not
+// reached so ( switch cases ) are taken as the entries of more blocks. The
+// alignment padding is not a part of the graph.
+
+struct BasicBlock {
+    MEMOFFSET_64  begin;
+    MEMOFFSET_64  end;
+    size_t  firstInstruction;       // index in FunctionGraph::instructions
+    size_t  instructionCount;
+};
+
+enum FlowEdgeKind {
+    EdgeFallThrough,
+    EdgeJump,
+    EdgeBranch                      // a conditional jump is taken
+};
+
+struct FlowEdge {
+    size_t  from;                   // index in FunctionGraph::blocks
+    size_t  to;
+    FlowEdgeKind  kind;
+};
+
+struct FunctionGraph {
+    MEMOFFSET_64  begin;
+    MEMOFFSET_64  end;
+    InstructionList  instructions;  // by the offset
+    std::vector<BasicBlock>  blocks;    // by the offset, the entry block first
+    std::vector<FlowEdge>  edges;       // by the source block
+};
+
+typedef boost::shared_ptr<const FunctionGraph>  FunctionGraphPtr;
+
+// The graph of the function containing the offset. The function range is
+// taken from the function symbol or from the unwind data of the module.
+// throws DbgException if there is no function at the offset
+FunctionGraphPtr getFunctionGraph( MEMOFFSET_64 offset );
+
+// The graph of the code range, the entry is the beginning of the range
+FunctionGraphPtr getFunctionGraph( MEMOFFSET_64 begin, MEMOFFSET_64 end );
+
+// The graph of the code in the buffer placed at the begin offset
+FunctionGraphPtr getFunctionGraph( const void* buffer, size_t length, MEMOFFSET_64 begin, CPUType cpuMode );
+
+const size_t  NoBasicBlock = ~size_t(0);
+
+// the block containing the offset, NoBasicBlock if there is no such block
+size_t findBasicBlock( const FunctionGraph &graph, MEMOFFSET_64 offset );
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The cross references of the module code: the targets of the direct calls,
+// jumps and branches and the memory operands with a known address ( RIP
+// relative or absolute ). Only the references into the module are kept.
+
+enum CrossReferenceKind {
+    XrefCall,
+    XrefJump,
+    XrefBranch,
+    XrefData
+};
+
+struct CrossReference {
+    MEMOFFSET_64  from;             // the instruction
+    MEMOFFSET_64  to;
+    CrossReferenceKind  kind;
+};
+
+typedef std::vector<CrossReference>  CrossReferenceList;
+
+struct CrossReferenceOptions {
+
+    CrossReferenceOptions() :
+        threadCount(0)
+        {}
+
+    unsigned long  threadCount;     // 0 - one worker per CPU
+    std::wstring  cacheDirectory;   // empty - the index is not saved to the disk
+};
+
+// Builds the cross reference index of the module. The code of the functions
+// from the unwind data ( or of the executable sections if there is no unwind
+// data ) is read by the calling thread and decoded on a worker pool. With the
+// cache directory the index is loaded from the file of the module with the
+// same timestamp and checksum, a built index is saved there. The index is
+// kept until the module is unloaded.
+void buildCrossReferences( MEMOFFSET_64 moduleBase, const CrossReferenceOptions& options = CrossReferenceOptions() );
+
+// The references to and from the offset, by the source offset. The index of
+// the module containing the offset is built on the first call.
+CrossReferenceList getReferencesTo( MEMOFFSET_64 offset );
+CrossReferenceList getReferencesFrom( MEMOFFSET_64 offset );
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
@@ -21,6 +21,7 @@ typedef unsigned long           ACCESS_TYPE;
 typedef unsigned long long      EXTENSION_ID;
 typedef unsigned long           RELREG_ID;
 typedef unsigned long long      SYMBOL_ID;
+typedef unsigned long           NAME_ID;
 
 enum DebugCallbackResult {
     DebugCallbackProceed = 0,
@@ -16,9 +16,16 @@ class DbgException : public std::exception
 public:
 
     DbgException( const std::string  &desc ) :
-        std::exception( desc.c_str() )
+        m_desc( desc )
         {}
 
+    virtual const char* what() const throw() {
+        return m_desc.c_str();
+    }
+
+private:
+
+    std::string  m_desc;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,971 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "kdlib/dbgtypedef.h"
+
+namespace kdlib {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The x86 and AMD64 instructions decoded without the debug engine. The VEX and
+// EVEX forms of the SSE instructions have the mnemonic of the legacy form, the
+// text gets the "v" prefix.
+
+enum InstructionMnemonic {
+    MnemonicInvalid,
+    MnemonicAaa,
+    MnemonicAad,
+    MnemonicAam,
+    MnemonicAas,
+    MnemonicAdc,
+    MnemonicAdcx,
+    MnemonicAdd,
+    MnemonicAddpd,
+    MnemonicAddps,
+    MnemonicAddsd,
+    MnemonicAddss,
+    MnemonicAddsubpd,
+    MnemonicAddsubps,
+    MnemonicAdox,
+    MnemonicAesdec,
+    MnemonicAesdeclast,
+    MnemonicAesenc,
+    MnemonicAesenclast,
+    MnemonicAesimc,
+    MnemonicAeskeygenassist,
+    MnemonicAnd,
+    MnemonicAndn,
+    MnemonicAndnpd,
+    MnemonicAndnps,
+    MnemonicAndpd,
+    MnemonicAndps,
+    MnemonicArpl,
+    MnemonicBextr,
+    MnemonicBlendpd,
+    MnemonicBlendps,
+    MnemonicBlendvpd,
+    MnemonicBlendvps,
+    MnemonicBlsi,
+    MnemonicBlsmsk,
+    MnemonicBlsr,
+    MnemonicBound,
+    MnemonicBsf,
+    MnemonicBsr,
+    MnemonicBswap,
+    MnemonicBt,
+    MnemonicBtc,
+    MnemonicBtr,
+    MnemonicBts,
+    MnemonicBzhi,
+    MnemonicCall,
+    MnemonicCbw,
+    MnemonicCdq,
+    MnemonicCdqe,
+    MnemonicClac,
+    MnemonicClc,
+    MnemonicCld,
+    MnemonicClflush,
+    MnemonicClgi,
+    MnemonicCli,
+    MnemonicClts,
+    MnemonicClzero,
+    MnemonicCmc,
+    MnemonicCmova,
+    MnemonicCmovae,
+    MnemonicCmovb,
+    MnemonicCmovbe,
+    MnemonicCmove,
+    MnemonicCmovg,
+    MnemonicCmovge,
+    MnemonicCmovl,
+    MnemonicCmovle,
+    MnemonicCmovne,
+    MnemonicCmovno,
+    MnemonicCmovnp,
+    MnemonicCmovns,
+    MnemonicCmovo,
+    MnemonicCmovp,
+    MnemonicCmovs,
+    MnemonicCmp,
+    MnemonicCmpeqpd,
+    MnemonicCmpeqps,
+    MnemonicCmpeqsd,
+    MnemonicCmpeqss,
+    MnemonicCmplepd,
+    MnemonicCmpleps,
+    MnemonicCmplesd,
+    MnemonicCmpless,
+    MnemonicCmpltpd,
+    MnemonicCmpltps,
+    MnemonicCmpltsd,
+    MnemonicCmpltss,
+    MnemonicCmpneqpd,
+    MnemonicCmpneqps,
+    MnemonicCmpneqsd,
+    MnemonicCmpneqss,
+    MnemonicCmpnlepd,
+    MnemonicCmpnleps,
+    MnemonicCmpnlesd,
+    MnemonicCmpnless,
+    MnemonicCmpnltpd,
+    MnemonicCmpnltps,
+    MnemonicCmpnltsd,
+    MnemonicCmpnltss,
+    MnemonicCmpordpd,
+    MnemonicCmpordps,
+    MnemonicCmpordsd,
+    MnemonicCmpordss,
+    MnemonicCmppd,
+    MnemonicCmpps,
+    MnemonicCmps,
+    MnemonicCmpsd,
+    MnemonicCmpss,
+    MnemonicCmpunordpd,
+    MnemonicCmpunordps,
+    MnemonicCmpunordsd,
+    MnemonicCmpunordss,
+    MnemonicCmpxchg,
+    MnemonicCmpxchg16b,
+    MnemonicCmpxchg8b,
+    MnemonicComisd,
+    MnemonicComiss,
+    MnemonicCpuid,
+    MnemonicCqo,
+    MnemonicCrc32,
+    MnemonicCvtdq2pd,
+    MnemonicCvtdq2ps,
+    MnemonicCvtpd2dq,
+    MnemonicCvtpd2pi,
+    MnemonicCvtpd2ps,
+    MnemonicCvtpi2pd,
+    MnemonicCvtpi2ps,
+    MnemonicCvtps2dq,
+    MnemonicCvtps2pd,
+    MnemonicCvtps2pi,
+    MnemonicCvtsd2si,
+    MnemonicCvtsd2ss,
+    MnemonicCvtsi2sd,
+    MnemonicCvtsi2ss,
+    MnemonicCvtss2sd,
+    MnemonicCvtss2si,
+    MnemonicCvttpd2dq,
+    MnemonicCvttpd2pi,
+    MnemonicCvttps2dq,
+    MnemonicCvttps2pi,
+    MnemonicCvttsd2si,
+    MnemonicCvttss2si,
+    MnemonicCwd,
+    MnemonicCwde,
+    MnemonicDaa,
+    MnemonicDas,
+    MnemonicDec,
+    MnemonicDiv,
+    MnemonicDivpd,
+    MnemonicDivps,
+    MnemonicDivsd,
+    MnemonicDivss,
+    MnemonicDppd,
+    MnemonicDpps,
+    MnemonicEmms,
+    MnemonicEncls,
+    MnemonicEnclu,
+    MnemonicEndbr32,
+    MnemonicEndbr64,
+    MnemonicEnter,
+    MnemonicExtractps,
+    MnemonicF2xm1,
+    MnemonicFabs,
+    MnemonicFadd,
+    MnemonicFaddp,
+    MnemonicFbld,
+    MnemonicFbstp,
+    MnemonicFchs,
+    MnemonicFcmovb,
+    MnemonicFcmovbe,
+    MnemonicFcmove,
+    MnemonicFcmovnb,
+    MnemonicFcmovnbe,
+    MnemonicFcmovne,
+    MnemonicFcmovnu,
+    MnemonicFcmovu,
+    MnemonicFcom,
+    MnemonicFcomi,
+    MnemonicFcomip,
+    MnemonicFcomp,
+    MnemonicFcompp,
+    MnemonicFcos,
+    MnemonicFdecstp,
+    MnemonicFdiv,
+    MnemonicFdivp,
+    MnemonicFdivr,
+    MnemonicFdivrp,
+    MnemonicFemms,
+    MnemonicFfree,
+    MnemonicFfreep,
+    MnemonicFiadd,
+    MnemonicFicom,
+    MnemonicFicomp,
+    MnemonicFidiv,
+    MnemonicFidivr,
+    MnemonicFild,
+    MnemonicFimul,
+    MnemonicFincstp,
+    MnemonicFist,
+    MnemonicFistp,
+    MnemonicFisttp,
+    MnemonicFisub,
+    MnemonicFisubr,
+    MnemonicFld,
+    MnemonicFld1,
+    MnemonicFldcw,
+    MnemonicFldenv,
+    MnemonicFldl2e,
+    MnemonicFldl2t,
+    MnemonicFldlg2,
+    MnemonicFldln2,
+    MnemonicFldpi,
+    MnemonicFldz,
+    MnemonicFmul,
+    MnemonicFmulp,
+    MnemonicFnclex,
+    MnemonicFninit,
+    MnemonicFnop,
+    MnemonicFnsave,
+    MnemonicFnstcw,
+    MnemonicFnstenv,
+    MnemonicFnstsw,
+    MnemonicFpatan,
+    MnemonicFprem,
+    MnemonicFprem1,
+    MnemonicFptan,
+    MnemonicFrndint,
+    MnemonicFrstor,
+    MnemonicFscale,
+    MnemonicFsin,
+    MnemonicFsincos,
+    MnemonicFsqrt,
+    MnemonicFst,
+    MnemonicFstp,
+    MnemonicFsub,
+    MnemonicFsubp,
+    MnemonicFsubr,
+    MnemonicFsubrp,
+    MnemonicFtst,
+    MnemonicFucom,
+    MnemonicFucomi,
+    MnemonicFucomip,
+    MnemonicFucomp,
+    MnemonicFucompp,
+    MnemonicFxam,
+    MnemonicFxch,
+    MnemonicFxrstor,
+    MnemonicFxsave,
+    MnemonicFxtract,
+    MnemonicFyl2x,
+    MnemonicFyl2xp1,
+    MnemonicGetsec,
+    MnemonicHaddpd,
+    MnemonicHaddps,
+    MnemonicHlt,
+    MnemonicHsubpd,
+    MnemonicHsubps,
+    MnemonicIdiv,
+    MnemonicImul,
+    MnemonicIn,
+    MnemonicInc,
+    MnemonicIns,
+    MnemonicInsertps,
+    MnemonicInt,
+    MnemonicInt1,
+    MnemonicInto,
+    MnemonicInvd,
+    MnemonicInvlpg,
+    MnemonicInvlpga,
+    MnemonicIret,
+    MnemonicIretd,
+    MnemonicIretq,
+    MnemonicJa,
+    MnemonicJae,
+    MnemonicJb,
+    MnemonicJbe,
+    MnemonicJcxz,
+    MnemonicJe,
+    MnemonicJecxz,
+    MnemonicJg,
+    MnemonicJge,
+    MnemonicJl,
+    MnemonicJle,
+    MnemonicJmp,
+    MnemonicJne,
+    MnemonicJno,
+    MnemonicJnp,
+    MnemonicJns,
+    MnemonicJo,
+    MnemonicJp,
+    MnemonicJrcxz,
+    MnemonicJs,
+    MnemonicKaddb,
+    MnemonicKaddd,
+    MnemonicKaddq,
+    MnemonicKaddw,
+    MnemonicKandb,
+    MnemonicKandd,
+    MnemonicKandnb,
+    MnemonicKandnd,
+    MnemonicKandnq,
+    MnemonicKandnw,
+    MnemonicKandq,
+    MnemonicKandw,
+    MnemonicKmovb,
+    MnemonicKmovd,
+    MnemonicKmovq,
+    MnemonicKmovw,
+    MnemonicKnotb,
+    MnemonicKnotd,
+    MnemonicKnotq,
+    MnemonicKnotw,
+    MnemonicKorb,
+    MnemonicKord,
+    MnemonicKorq,
+    MnemonicKortestb,
+    MnemonicKortestd,
+    MnemonicKortestq,
+    MnemonicKortestw,
+    MnemonicKorw,
+    MnemonicKtestb,
+    MnemonicKtestd,
+    MnemonicKtestq,
+    MnemonicKtestw,
+    MnemonicKunpckbw,
+    MnemonicKunpckdq,
+    MnemonicKunpckwd,
+    MnemonicKxnorb,
+    MnemonicKxnord,
+    MnemonicKxnorq,
+    MnemonicKxnorw,
+    MnemonicKxorb,
+    MnemonicKxord,
+    MnemonicKxorq,
+    MnemonicKxorw,
+    MnemonicLahf,
+    MnemonicLar,
+    MnemonicLddqu,
+    MnemonicLdmxcsr,
+    MnemonicLds,
+    MnemonicLea,
+    MnemonicLeave,
+    MnemonicLes,
+    MnemonicLfence,
+    MnemonicLfs,
+    MnemonicLgdt,
+    MnemonicLgs,
+    MnemonicLidt,
+    MnemonicLldt,
+    MnemonicLmsw,
+    MnemonicLods,
+    MnemonicLoop,
+    MnemonicLoope,
+    MnemonicLoopne,
+    MnemonicLsl,
+    MnemonicLss,
+    MnemonicLtr,
+    MnemonicLzcnt,
+    MnemonicMaskmovdqu,
+    MnemonicMaskmovq,
+    MnemonicMaxpd,
+    MnemonicMaxps,
+    MnemonicMaxsd,
+    MnemonicMaxss,
+    MnemonicMfence,
+    MnemonicMinpd,
+    MnemonicMinps,
+    MnemonicMinsd,
+    MnemonicMinss,
+    MnemonicMonitor,
+    MnemonicMonitorx,
+    MnemonicMov,
+    MnemonicMovapd,
+    MnemonicMovaps,
+    MnemonicMovbe,
+    MnemonicMovd,
+    MnemonicMovddup,
+    MnemonicMovdqa,
+    MnemonicMovdqu,
+    MnemonicMovhlps,
+    MnemonicMovhpd,
+    MnemonicMovhps,
+    MnemonicMovlhps,
+    MnemonicMovlpd,
+    MnemonicMovlps,
+    MnemonicMovmskpd,
+    MnemonicMovmskps,
+    MnemonicMovntdq,
+    MnemonicMovntdqa,
+    MnemonicMovnti,
+    MnemonicMovntpd,
+    MnemonicMovntps,
+    MnemonicMovntq,
+    MnemonicMovq,
+    MnemonicMovs,
+    MnemonicMovsd,
+    MnemonicMovshdup,
+    MnemonicMovsldup,
+    MnemonicMovss,
+    MnemonicMovsx,
+    MnemonicMovsxd,
+    MnemonicMovupd,
+    MnemonicMovups,
+    MnemonicMovzx,
+    MnemonicMpsadbw,
+    MnemonicMul,
+    MnemonicMulpd,
+    MnemonicMulps,
+    MnemonicMulsd,
+    MnemonicMulss,
+    MnemonicMulx,
+    MnemonicMwait,
+    MnemonicMwaitx,
+    MnemonicNeg,
+    MnemonicNop,
+    MnemonicNot,
+    MnemonicOr,
+    MnemonicOrpd,
+    MnemonicOrps,
+    MnemonicOut,
+    MnemonicOuts,
+    MnemonicPabsb,
+    MnemonicPabsd,
+    MnemonicPabsw,
+    MnemonicPackssdw,
+    MnemonicPacksswb,
+    MnemonicPackusdw,
+    MnemonicPackuswb,
+    MnemonicPaddb,
+    MnemonicPaddd,
+    MnemonicPaddq,
+    MnemonicPaddsb,
+    MnemonicPaddsw,
+    MnemonicPaddusb,
+    MnemonicPaddusw,
+    MnemonicPaddw,
+    MnemonicPalignr,
+    MnemonicPand,
+    MnemonicPandn,
+    MnemonicPause,
+    MnemonicPavgb,
+    MnemonicPavgw,
+    MnemonicPblendvb,
+    MnemonicPblendw,
+    MnemonicPclmulqdq,
+    MnemonicPcmpeqb,
+    MnemonicPcmpeqd,
+    MnemonicPcmpeqq,
+    MnemonicPcmpeqw,
+    MnemonicPcmpestri,
+    MnemonicPcmpestrm,
+    MnemonicPcmpgtb,
+    MnemonicPcmpgtd,
+    MnemonicPcmpgtq,
+    MnemonicPcmpgtw,
+    MnemonicPcmpistri,
+    MnemonicPcmpistrm,
+    MnemonicPdep,
+    MnemonicPext,
+    MnemonicPextrb,
+    MnemonicPextrd,
+    MnemonicPextrw,
+    MnemonicPhaddd,
+    MnemonicPhaddsw,
+    MnemonicPhaddw,
+    MnemonicPhminposuw,
+    MnemonicPhsubd,
+    MnemonicPhsubsw,
+    MnemonicPhsubw,
+    MnemonicPinsrb,
+    MnemonicPinsrd,
+    MnemonicPinsrw,
+    MnemonicPmaddubsw,
+    MnemonicPmaddwd,
+    MnemonicPmaxsb,
+    MnemonicPmaxsd,
+    MnemonicPmaxsw,
+    MnemonicPmaxub,
+    MnemonicPmaxud,
+    MnemonicPmaxuw,
+    MnemonicPminsb,
+    MnemonicPminsd,
+    MnemonicPminsw,
+    MnemonicPminub,
+    MnemonicPminud,
+    MnemonicPminuw,
+    MnemonicPmovmskb,
+    MnemonicPmovsxbd,
+    MnemonicPmovsxbq,
+    MnemonicPmovsxbw,
+    MnemonicPmovsxdq,
+    MnemonicPmovsxwd,
+    MnemonicPmovsxwq,
+    MnemonicPmovzxbd,
+    MnemonicPmovzxbq,
+    MnemonicPmovzxbw,
+    MnemonicPmovzxdq,
+    MnemonicPmovzxwd,
+    MnemonicPmovzxwq,
+    MnemonicPmuldq,
+    MnemonicPmulhrsw,
+    MnemonicPmulhuw,
+    MnemonicPmulhw,
+    MnemonicPmulld,
+    MnemonicPmullw,
+    MnemonicPmuludq,
+    MnemonicPop,
+    MnemonicPopa,
+    MnemonicPopad,
+    MnemonicPopcnt,
+    MnemonicPopf,
+    MnemonicPopfd,
+    MnemonicPopfq,
+    MnemonicPor,
+    MnemonicPrefetch,
+    MnemonicPrefetchnta,
+    MnemonicPrefetcht0,
+    MnemonicPrefetcht1,
+    MnemonicPrefetcht2,
+    MnemonicPrefetchw,
+    MnemonicPrefetchwt1,
+    MnemonicPsadbw,
+    MnemonicPshufb,
+    MnemonicPshufd,
+    MnemonicPshufhw,
+    MnemonicPshuflw,
+    MnemonicPshufw,
+    MnemonicPsignb,
+    MnemonicPsignd,
+    MnemonicPsignw,
+    MnemonicPslld,
+    MnemonicPslldq,
+    MnemonicPsllq,
+    MnemonicPsllw,
+    MnemonicPsrad,
+    MnemonicPsraw,
+    MnemonicPsrld,
+    MnemonicPsrldq,
+    MnemonicPsrlq,
+    MnemonicPsrlw,
+    MnemonicPsubb,
+    MnemonicPsubd,
+    MnemonicPsubq,
+    MnemonicPsubsb,
+    MnemonicPsubsw,
+    MnemonicPsubusb,
+    MnemonicPsubusw,
+    MnemonicPsubw,
+    MnemonicPtest,
+    MnemonicPunpckhbw,
+    MnemonicPunpckhdq,
+    MnemonicPunpckhqdq,
+    MnemonicPunpckhwd,
+    MnemonicPunpcklbw,
+    MnemonicPunpckldq,
+    MnemonicPunpcklqdq,
+    MnemonicPunpcklwd,
+    MnemonicPush,
+    MnemonicPusha,
+    MnemonicPushad,
+    MnemonicPushf,
+    MnemonicPushfd,
+    MnemonicPushfq,
+    MnemonicPxor,
+    MnemonicRcl,
+    MnemonicRcpps,
+    MnemonicRcpss,
+    MnemonicRcr,
+    MnemonicRdfsbase,
+    MnemonicRdgsbase,
+    MnemonicRdmsr,
+    MnemonicRdpid,
+    MnemonicRdpkru,
+    MnemonicRdpmc,
+    MnemonicRdpru,
+    MnemonicRdrand,
+    MnemonicRdseed,
+    MnemonicRdtsc,
+    MnemonicRdtscp,
+    MnemonicRet,
+    MnemonicRetf,
+    MnemonicRol,
+    MnemonicRor,
+    MnemonicRorx,
+    MnemonicRoundpd,
+    MnemonicRoundps,
+    MnemonicRoundsd,
+    MnemonicRoundss,
+    MnemonicRsm,
+    MnemonicRsqrtps,
+    MnemonicRsqrtss,
+    MnemonicSahf,
+    MnemonicSal,
+    MnemonicSar,
+    MnemonicSarx,
+    MnemonicSbb,
+    MnemonicScas,
+    MnemonicSeta,
+    MnemonicSetae,
+    MnemonicSetb,
+    MnemonicSetbe,
+    MnemonicSete,
+    MnemonicSetg,
+    MnemonicSetge,
+    MnemonicSetl,
+    MnemonicSetle,
+    MnemonicSetne,
+    MnemonicSetno,
+    MnemonicSetnp,
+    MnemonicSetns,
+    MnemonicSeto,
+    MnemonicSetp,
+    MnemonicSets,
+    MnemonicSfence,
+    MnemonicSgdt,
+    MnemonicSha1msg1,
+    MnemonicSha1msg2,
+    MnemonicSha1nexte,
+    MnemonicSha1rnds4,
+    MnemonicSha256msg1,
+    MnemonicSha256msg2,
+    MnemonicSha256rnds2,
+    MnemonicShl,
+    MnemonicShld,
+    MnemonicShlx,
+    MnemonicShr,
+    MnemonicShrd,
+    MnemonicShrx,
+    MnemonicShufpd,
+    MnemonicShufps,
+    MnemonicSidt,
+    MnemonicSkinit,
+    MnemonicSldt,
+    MnemonicSmsw,
+    MnemonicSqrtpd,
+    MnemonicSqrtps,
+    MnemonicSqrtsd,
+    MnemonicSqrtss,
+    MnemonicStac,
+    MnemonicStc,
+    MnemonicStd,
+    MnemonicStgi,
+    MnemonicSti,
+    MnemonicStmxcsr,
+    MnemonicStos,
+    MnemonicStr,
+    MnemonicSub,
+    MnemonicSubpd,
+    MnemonicSubps,
+    MnemonicSubsd,
+    MnemonicSubss,
+    MnemonicSwapgs,
+    MnemonicSyscall,
+    MnemonicSysenter,
+    MnemonicSysexit,
+    MnemonicSysret,
+    MnemonicTest,
+    MnemonicTzcnt,
+    MnemonicUcomisd,
+    MnemonicUcomiss,
+    MnemonicUd0,
+    MnemonicUd1,
+    MnemonicUd2,
+    MnemonicUnpckhpd,
+    MnemonicUnpckhps,
+    MnemonicUnpcklpd,
+    MnemonicUnpcklps,
+    MnemonicVblendvpd,
+    MnemonicVblendvps,
+    MnemonicVbroadcastf128,
+    MnemonicVbroadcasti128,
+    MnemonicVbroadcastsd,
+    MnemonicVbroadcastss,
+    MnemonicVcvtps2ph,
+    MnemonicVerr,
+    MnemonicVerw,
+    MnemonicVextractf128,
+    MnemonicVextracti128,
+    MnemonicVfmadd132pd,
+    MnemonicVfmadd132ps,
+    MnemonicVfmadd132sd,
+    MnemonicVfmadd132ss,
+    MnemonicVfmadd213pd,
+    MnemonicVfmadd213ps,
+    MnemonicVfmadd213sd,
+    MnemonicVfmadd213ss,
+    MnemonicVfmadd231pd,
+    MnemonicVfmadd231ps,
+    MnemonicVfmadd231sd,
+    MnemonicVfmadd231ss,
+    MnemonicVfmaddsub132pd,
+    MnemonicVfmaddsub132ps,
+    MnemonicVfmaddsub213pd,
+    MnemonicVfmaddsub213ps,
+    MnemonicVfmaddsub231pd,
+    MnemonicVfmaddsub231ps,
+    MnemonicVfmsub132pd,
+    MnemonicVfmsub132ps,
+    MnemonicVfmsub132sd,
+    MnemonicVfmsub132ss,
+    MnemonicVfmsub213pd,
+    MnemonicVfmsub213ps,
+    MnemonicVfmsub213sd,
+    MnemonicVfmsub213ss,
+    MnemonicVfmsub231pd,
+    MnemonicVfmsub231ps,
+    MnemonicVfmsub231sd,
+    MnemonicVfmsub231ss,
+    MnemonicVfmsubadd132pd,
+    MnemonicVfmsubadd132ps,
+    MnemonicVfmsubadd213pd,
+    MnemonicVfmsubadd213ps,
+    MnemonicVfmsubadd231pd,
+    MnemonicVfmsubadd231ps,
+    MnemonicVfnmadd132pd,
+    MnemonicVfnmadd132ps,
+    MnemonicVfnmadd132sd,
+    MnemonicVfnmadd132ss,
+    MnemonicVfnmadd213pd,
+    MnemonicVfnmadd213ps,
+    MnemonicVfnmadd213sd,
+    MnemonicVfnmadd213ss,
+    MnemonicVfnmadd231pd,
+    MnemonicVfnmadd231ps,
+    MnemonicVfnmadd231sd,
+    MnemonicVfnmadd231ss,
+    MnemonicVfnmsub132pd,
+    MnemonicVfnmsub132ps,
+    MnemonicVfnmsub132sd,
+    MnemonicVfnmsub132ss,
+    MnemonicVfnmsub213pd,
+    MnemonicVfnmsub213ps,
+    MnemonicVfnmsub213sd,
+    MnemonicVfnmsub213ss,
+    MnemonicVfnmsub231pd,
+    MnemonicVfnmsub231ps,
+    MnemonicVfnmsub231sd,
+    MnemonicVfnmsub231ss,
+    MnemonicVinsertf128,
+    MnemonicVinserti128,
+    MnemonicVmaskmovpd,
+    MnemonicVmaskmovps,
+    MnemonicVmcall,
+    MnemonicVmfunc,
+    MnemonicVmlaunch,
+    MnemonicVmload,
+    MnemonicVmmcall,
+    MnemonicVmovdqa32,
+    MnemonicVmovdqa64,
+    MnemonicVmovdqu16,
+    MnemonicVmovdqu32,
+    MnemonicVmovdqu64,
+    MnemonicVmovdqu8,
+    MnemonicVmptrld,
+    MnemonicVmptrst,
+    MnemonicVmread,
+    MnemonicVmresume,
+    MnemonicVmrun,
+    MnemonicVmsave,
+    MnemonicVmwrite,
+    MnemonicVmxoff,
+    MnemonicVpandd,
+    MnemonicVpandnd,
+    MnemonicVpandnq,
+    MnemonicVpandq,
+    MnemonicVpblendd,
+    MnemonicVpblendvb,
+    MnemonicVpbroadcastb,
+    MnemonicVpbroadcastd,
+    MnemonicVpbroadcastq,
+    MnemonicVpbroadcastw,
+    MnemonicVpcmpb,
+    MnemonicVpcmpd,
+    MnemonicVpcmpq,
+    MnemonicVpcmpub,
+    MnemonicVpcmpud,
+    MnemonicVpcmpuq,
+    MnemonicVpcmpuw,
+    MnemonicVpcmpw,
+    MnemonicVperm2f128,
+    MnemonicVperm2i128,
+    MnemonicVpermd,
+    MnemonicVpermilpd,
+    MnemonicVpermilps,
+    MnemonicVpermpd,
+    MnemonicVpermq,
+    MnemonicVpmaskmovd,
+    MnemonicVpmaskmovq,
+    MnemonicVpord,
+    MnemonicVporq,
+    MnemonicVpsllvd,
+    MnemonicVpsllvq,
+    MnemonicVpsravd,
+    MnemonicVpsrlvd,
+    MnemonicVpsrlvq,
+    MnemonicVpternlogd,
+    MnemonicVpternlogq,
+    MnemonicVptestmb,
+    MnemonicVptestmd,
+    MnemonicVptestmq,
+    MnemonicVptestmw,
+    MnemonicVptestnmb,
+    MnemonicVptestnmd,
+    MnemonicVptestnmq,
+    MnemonicVptestnmw,
+    MnemonicVpxord,
+    MnemonicVpxorq,
+    MnemonicVzeroall,
+    MnemonicVzeroupper,
+    MnemonicWait,
+    MnemonicWbinvd,
+    MnemonicWrfsbase,
+    MnemonicWrgsbase,
+    MnemonicWrmsr,
+    MnemonicWrpkru,
+    MnemonicXabort,
+    MnemonicXadd,
+    MnemonicXbegin,
+    MnemonicXchg,
+    MnemonicXend,
+    MnemonicXgetbv,
+    MnemonicXlat,
+    MnemonicXor,
+    MnemonicXorpd,
+    MnemonicXorps,
+    MnemonicXrstor,
+    MnemonicXrstors,
+    MnemonicXsave,
+    MnemonicXsavec,
+    MnemonicXsaveopt,
+    MnemonicXsaves,
+    MnemonicXsetbv,
+    MnemonicXtest,
+    MnemonicMax
+};
+
+enum InstructionPrefix {
+    PrefixLock          = 0x0001,
+    PrefixRep           = 0x0002,   // F3 if it is not a part of the opcode
+    PrefixRepne         = 0x0004,   // F2 if it is not a part of the opcode
+    PrefixOperandSize   = 0x0008,
+    PrefixAddressSize   = 0x0010,
+    PrefixSegment       = 0x0020,
+    PrefixRex           = 0x0040,
+    PrefixVex           = 0x0080,
+    PrefixEvex          = 0x0100,
+    PrefixMaskZeroing   = 0x0200    // EVEX.z
+};
+
+enum InstructionFlow {
+    FlowNone,
+    FlowCall,
+    FlowJump,
+    FlowBranch,         // conditional jump, loop
+    FlowReturn,
+    FlowInterrupt,      // int, syscall
+    FlowStop            // hlt, ud2
+};
+
+enum InstructionOperandKind {
+    OperandNone,
+    OperandRegister,
+    OperandMemory,
+    OperandImmediate,
+    OperandBranch,      // Instruction::target
+    OperandFarPointer   // selector:offset in Instruction::immediate2:immediate
+};
+
+enum InstructionRegisterClass {
+    RegClassNone,
+    RegClassGp8,        // al .. r15b, ah .. bh are 16 .. 19
+    RegClassGp16,
+    RegClassGp32,
+    RegClassGp64,
+    RegClassSegment,    // es, cs, ss, ds, fs, gs
+    RegClassIp,
+    RegClassMmx,
+    RegClassXmm,
+    RegClassYmm,
+    RegClassZmm,
+    RegClassSt,
+    RegClassControl,
+    RegClassDebug,
+    RegClassMask
+};
+
+struct InstructionRegister {
+    unsigned char  regClass;
+    unsigned char  number;
+};
+
+struct InstructionOperand {
+    unsigned char  kind;
+    unsigned char  size;            // in bytes, 0 if the memory operand has no size ( lea )
+    InstructionRegister  reg;       // OperandRegister
+    InstructionRegister  base;      // OperandMemory: RegClassIp for RIP relative
+    InstructionRegister  index;
+    unsigned char  scale;
+    unsigned char  segment;         // segment register number + 1, 0 - default segment
+};
+
+struct Instruction {
+    MEMOFFSET_64  offset;
+    unsigned char  length;
+    unsigned char  cpuMode;         // CPU_I386 or CPU_AMD64
+    unsigned short  mnemonic;       // InstructionMnemonic
+    unsigned short  prefixes;       // InstructionPrefix
+    unsigned char  flow;            // InstructionFlow
+    unsigned char  rex;
+    unsigned char  operandSize;
+    unsigned char  addressSize;
+    unsigned char  opmask;          // EVEX.aaa
+    unsigned char  operandCount;
+    InstructionOperand  operands[4];
+    long long  immediate;
+    long long  immediate2;          // the second immediate of enter, the selector of a far pointer
+    long long  displacement;
+    MEMOFFSET_64  target;           // branch target
+    MEMOFFSET_64  ea;               // RIP relative or absolute memory operand address, 0 if not known
+    unsigned char  bytes[15];
+};
+
+// Decodes one instruction from the buffer, the offset is the address of the
+// buffer. CPU_I386 and CPU_AMD64 modes are supported. Returns false if the
+// bytes are not a valid instruction: the mnemonic is MnemonicInvalid and the
+// length is the best guess ( at least 1 ).
+bool decodeInstruction( const void* buffer, size_t length, MEMOFFSET_64 offset, CPUType cpuMode, Instruction& instruction );
+
+// Reads the instruction from the target memory, the mode is the current CPU mode
+Instruction decodeInstruction( MEMOFFSET_64 offset );
+
+// The text in the Disasm format: "address bytes mnemonic operands". The
+// addresses are not replaced by symbols.
+std::wstring formatInstruction( const Instruction& instruction );
+
+std::wstring getMnemonicName( unsigned short mnemonic );
+std::wstring getInstructionRegisterName( const InstructionRegister& reg );
+
+///////////////////////////////////////////////////////////////////////////////
+
+typedef std::vector<Instruction>  InstructionList;
+typedef boost::shared_ptr<const InstructionList>  InstructionListPtr;
+
+// Linear sweep over [begin, end): the range is read at once and decoded in the
+// current CPU mode. Bytes which are not a valid instruction give a
+// MnemonicInvalid entry, a page which can not be read gives no entries. The
+// last instruction may cross the end. A range inside a module is cached per
+// process until the module is unloaded or the target runs.
+InstructionListPtr disassembleRange( MEMOFFSET_64 begin, MEMOFFSET_64 end );
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "kdlib/variant.h"
+#include "kdlib/codeflow.h"
 #include "kdlib/cpucontext.h"
 #include "kdlib/dbgengine.h"
 #include "kdlib/dbgcallbacks.h"
@@ -8,6 +9,7 @@
 #include "kdlib/disasm.h"
 #include "kdlib/exceptions.h"
 #include "kdlib/eventhandler.h"
+#include "kdlib/instruction.h"
 #include "kdlib/memaccess.h"
 #include "kdlib/module.h"
 #include "kdlib/process.h"
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "kdlib/dbgtypedef.h"
+#include "kdlib/symengine.h"
+
+namespace kdlib {
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct SourceLineInfo {
+    std::wstring  fileName;     // empty if there is no line for the offset
+    unsigned long  lineNo;
+    unsigned long  columnNo;
+    MEMOFFSET_64  offset;       // start of the line code
+    MEMOFFSET_32  length;
+};
+
+typedef std::vector<SourceLineInfo>  SourceLineList;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Line number table of a symbol file read once and indexed both ways: lines
+// sorted by address for the binary search and lines of each source file
+// sorted by the line number. The table is immutable and can be shared
+// between threads.
+
+class SourceLineTable;
+typedef boost::shared_ptr<SourceLineTable>  SourceLineTablePtr;
+
+class SourceLineTable
+{
+public:
+
+    virtual ~SourceLineTable() {}
+
+    // throws SymbolException if no line contains the offset
+    virtual SourceLineInfo findLine( MEMOFFSET_64 offset ) = 0;
+
+    // one line for each offset, an offset without a line gets an empty fileName
+    virtual SourceLineList findLines( const std::vector<MEMOFFSET_64> &offsets ) = 0;
+
+    // the code ranges of the line sorted by the offset. The file name is a full
+    // path or its trailing part, case insensitive. If the line has no code the
+    // ranges of the next line with code are returned.
+    virtual SourceLineList findLineOffsets( const std::wstring &fileName, unsigned long lineNo ) = 0;
+
+    virtual std::vector<std::wstring> getSourceFiles() = 0;
+
+    virtual size_t getLineCount() = 0;
+};
+
+// throws SymbolException if the symbol file has no line numbers
+SourceLineTablePtr getSourceLineTable( const SymbolSessionPtr &session, MEMOFFSET_64 loadBase );
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
@@ -9,6 +9,7 @@
 #include "kdlib/dbgtypedef.h"
 #include "kdlib/dbgengine.h"
 #include "kdlib/symengine.h"
+#include "kdlib/linetable.h"
 #include "kdlib/typeinfo.h"
 #include "kdlib/variant.h"
 #include "kdlib/typedvar.h"
@@ -25,6 +26,9 @@ ModulePtr loadModule( MEMOFFSET_64 offset );
 
 void splitSymName( const std::wstring &fullName, std::wstring &moduleName, std::wstring &symbolName );
 
+// source lines of the offsets in any module, an empty fileName for an offset without a line
+SourceLineList getSourceLines( const std::vector<MEMOFFSET_64> &offsets );
+
 typedef std::pair< std::wstring, MEMOFFSET_64 > SymbolOffset;
 typedef std::list< SymbolOffset > SymbolOffsetList;
 typedef std::list< std::wstring > TypeNameList;
@@ -110,6 +114,10 @@ public:
 
     virtual void getSourceLine( MEMOFFSET_64 offset, std::wstring &fileName, unsigned long &lineno, long &displacement ) = 0;
 
+    virtual SourceLineList getSourceLines( const std::vector<MEMOFFSET_64> &offsets ) = 0;
+
+    virtual SourceLineList getSourceLineOffsets( const std::wstring &fileName, unsigned long lineNo ) = 0;
+
     virtual std::string getVersionInfo( const std::string &value ) = 0;
 
     virtual void getFileVersion(unsigned long& majorVersion, unsigned long& minorVerion, unsigned long& revision, unsigned long& build) = 0;
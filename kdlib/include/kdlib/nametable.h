@@ -0,0 +1,173 @@
+#pragma once
+
+#include <string>
+
+#include <boost/utility/string_view.hpp>
+#include <boost/atomic.hpp>
+
+#include "kdlib/dbgtypedef.h"
+
+namespace kdlib {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Session-wide table of interned symbol and type names.
+// internName and a successful findNameId take a reference to the name,
+// releaseName drops it: the name is removed when its last reference is
+// released and its id is reused for another name. An id and its string are
+// valid while a reference is held. Id 0 is reserved for the empty name, it is
+// never released.
+
+const NAME_ID  EmptyNameId = 0;
+
+NAME_ID internName( const std::wstring &name );
+
+// false if the name is not interned, the table does not grow
+bool findNameId( const std::wstring &name, NAME_ID &nameId );
+
+void addNameRef( NAME_ID nameId );
+
+void releaseName( NAME_ID nameId );
+
+const std::wstring& getInternedName( NAME_ID nameId );
+
+boost::wstring_view getInternedNameView( NAME_ID nameId );
+
+struct NameTableStats {
+    size_t  nameCount;
+    size_t  charCount;
+    size_t  memoryUsage;
+};
+
+NameTableStats getNameTableStats();
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Holds a reference to an interned name
+
+class InternedName {
+
+public:
+
+    InternedName() :
+        m_nameId( EmptyNameId )
+        {}
+
+    explicit InternedName( const std::wstring &name ) :
+        m_nameId( internName(name) )
+        {}
+
+    InternedName( const InternedName &name ) :
+        m_nameId( name.m_nameId )
+        {
+            addNameRef( m_nameId );
+        }
+
+    ~InternedName() {
+        releaseName( m_nameId );
+    }
+
+    InternedName& operator=( const InternedName &name ) {
+        addNameRef( name.m_nameId );
+        releaseName( m_nameId );
+        m_nameId = name.m_nameId;
+        return *this;
+    }
+
+    // false if the name is not interned, the table does not grow
+    static bool find( const std::wstring &name, InternedName &internedName ) {
+        NAME_ID  nameId;
+        if ( !findNameId( name, nameId ) )
+            return false;
+        releaseName( internedName.m_nameId );
+        internedName.m_nameId = nameId;
+        return true;
+    }
+
+    NAME_ID getId() const {
+        return m_nameId;
+    }
+
+    const std::wstring& str() const {
+        return getInternedName( m_nameId );
+    }
+
+    boost::wstring_view view() const {
+        return getInternedNameView( m_nameId );
+    }
+
+    bool empty() const {
+        return m_nameId == EmptyNameId;
+    }
+
+    bool operator==( const InternedName &name ) const {
+        return m_nameId == name.m_nameId;
+    }
+
+    bool operator!=( const InternedName &name ) const {
+        return m_nameId != name.m_nameId;
+    }
+
+    bool operator<( const InternedName &name ) const {
+        return m_nameId < name.m_nameId;
+    }
+
+private:
+
+    NAME_ID  m_nameId;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Interns a name on its first request and holds it while the owner lives:
+// for the symbols and the types which read their name only when it is asked
+
+class LazyInternedName {
+
+public:
+
+    LazyInternedName() :
+        m_nameId( NotInterned )
+        {}
+
+    explicit LazyInternedName( const std::wstring &name ) :
+        m_nameId( internName(name) )
+        {}
+
+    ~LazyInternedName() {
+        NAME_ID  nameId = m_nameId;
+        if ( nameId != NotInterned )
+            releaseName( nameId );
+    }
+
+    template<typename GetName>
+    NAME_ID get( GetName getName ) {
+
+        NAME_ID  nameId = m_nameId;
+        if ( nameId != NotInterned )
+            return nameId;
+
+        nameId = internName( getName() );
+
+        NAME_ID  expected = NotInterned;
+        if ( m_nameId.compare_exchange_strong( expected, nameId ) )
+            return nameId;
+
+        // another thread interned the name first
+        releaseName( nameId );
+        return expected;
+    }
+
+private:
+
+    LazyInternedName( const LazyInternedName& );
+    LazyInternedName& operator=( const LazyInternedName& );
+
+    static const NAME_ID  NotInterned = ~NAME_ID(0);
+
+    boost::atomic<NAME_ID>  m_nameId;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
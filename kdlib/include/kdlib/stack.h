@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include <boost/shared_ptr.hpp>
 
 
@@ -78,6 +80,86 @@ void setCurrentStackFrame(const StackFramePtr& stackFrame);
 void setCurrentStackFrameByIndex(unsigned long frameIndex);
 void resetCurrentStackFrame();
 
+// Unwinds the stack by the unwind data of the modules without the debug engine
+// stack walker. The context is the current thread context by default, AMD64
+// and ARM64 are supported. Inline frames are not produced.
+StackPtr unwindStack(const CPUContextPtr& cpuContext = CPUContextPtr());
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct AllStacksOptions {
+
+    AllStacksOptions() :
+        threadCount(0),
+        allProcesses(false),
+        maxFrames(1024)
+        {}
+
+    unsigned long  threadCount;     // 0 - one worker per CPU
+    bool  allProcesses;             // all the processes of the current system
+    unsigned long  maxFrames;       // the engine walk is limited to 1024 frames
+};
+
+struct ThreadStack {
+    PROCESS_DEBUG_ID  processId;
+    THREAD_DEBUG_ID  threadId;      // -1 for a kernel thread not running on a processor
+    THREAD_ID  threadSystemId;
+    MEMOFFSET_64  processOffset;    // EPROCESS and ETHREAD of a kernel thread, else 0
+    MEMOFFSET_64  threadOffset;
+    StackPtr  stack;
+    unsigned long long  signature;
+    unsigned long  bucket;          // index in AllStacks::buckets
+};
+
+// Threads with the same frames
+
+struct StackBucket {
+    unsigned long long  signature;
+    std::vector<unsigned long>  threads;    // indices in AllStacks::threads
+};
+
+struct AllStacks {
+    std::vector<ThreadStack>  threads;
+    std::vector<StackBucket>  buckets;      // the largest bucket first
+};
+
+// The hash of the frame instruction offsets: the same code path gets the
+// same signature whatever the stack addresses are
+unsigned long long getStackSignature(const StackPtr& stack);
+
+// The stacks of all the threads of the current process or of all the
+// processes. AMD64 stacks are unwound by the unwind data of the modules on a
+// worker pool, other ones by the debug engine stack walker. The current
+// thread and process are restored. allProcesses takes the processes of the
+// debug engine. On a kernel target it walks the kernel process list from
+// PsActiveProcessHead and the thread list of each EPROCESS instead, each
+// thread is read with the implicit process and thread switched to it.
+AllStacks getAllStacks(const AllStacksOptions& options = AllStacksOptions());
+
+///////////////////////////////////////////////////////////////////////////////
+
+// A stack value looking like a return address: it points into an executable
+// section of a module just after a call instruction
+
+struct ScannedFrame {
+    MEMOFFSET_64  slot;             // the stack address of the value
+    MEMOFFSET_64  returnAddress;
+    MEMOFFSET_64  callSite;         // the call instruction
+    MEMOFFSET_64  callTarget;       // 0 if the call is indirect
+    MEMOFFSET_64  moduleBase;
+    MEMOFFSET_64  functionBegin;    // by the unwind data of the module, 0 if unknown
+    unsigned long  score;           // the higher the more likely the frame is real
+    std::wstring  moduleName;
+    std::wstring  symbol;           // empty if the module has no symbols
+    MEMDISPLACEMENT  displacement;  // from the symbol or from the module base
+};
+
+// Scans the stack of the thread for return addresses when the stack can not
+// be unwound. The stack region is taken from the KTHREAD or the TEB and read
+// at once: from the stack pointer or from the stack limit if the stack pointer
+// is out of the region. The frames go from the top of the stack.
+std::vector<ScannedFrame> scanStackForReturnAddresses(THREAD_DEBUG_ID threadId = CURRENT_THREAD_ID, unsigned long depth = 256);
+
 ///////////////////////////////////////////////////////////////////////////////
 
 } // kdlib namespace end
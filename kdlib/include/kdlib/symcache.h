@@ -0,0 +1,44 @@
+#pragma once
+
+#include "kdlib/symengine.h"
+
+namespace kdlib {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Caching decorator for any symbol backend. Immutable symbol properties are
+// memoized by each wrapped symbol, child lists and findByRva results are kept
+// in a cache shared by all symbols of the session, bounded by a memory budget
+// and evicted in LRU order. All the wrappers are thread-safe.
+//
+// Each cached symbol is charged the size of its wrapper plus backendSymbolSize:
+// the backend object is opaque to the cache, so its size is given by the caller
+// (the default is about a DIA symbol with its COM wrapper).
+
+const size_t  DefaultSymbolCacheBudget = 16 * 1024 * 1024;
+
+const size_t  DefaultBackendSymbolSize = 128;
+
+struct SymbolCacheStats {
+    size_t  entryCount;
+    size_t  memoryUsage;
+    size_t  memoryBudget;
+    size_t  hitCount;
+    size_t  missCount;
+    size_t  evictionCount;
+};
+
+SymbolSessionPtr getCachingSymbolSession( const SymbolSessionPtr &session, size_t memoryBudget = DefaultSymbolCacheBudget, size_t backendSymbolSize = DefaultBackendSymbolSize );
+
+SymbolPtr getCachingSymbol( const SymbolPtr &symbol, size_t memoryBudget = DefaultSymbolCacheBudget, size_t backendSymbolSize = DefaultBackendSymbolSize );
+
+// throw DbgException if the session or the symbol is not a caching one
+SymbolCacheStats getSymbolCacheStats( const SymbolSessionPtr &session );
+
+SymbolCacheStats getSymbolCacheStats( const SymbolPtr &symbol );
+
+void clearSymbolCache( const SymbolSessionPtr &session );
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
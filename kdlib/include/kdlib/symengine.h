@@ -3,11 +3,13 @@
 //#include "variant.h"
 
 #include <list>
+#include <vector>
 
 #include <boost/smart_ptr/shared_ptr.hpp>
 
 #include "kdlib/dbgtypedef.h"
 #include "kdlib/variant.h"
+#include "kdlib/nametable.h"
 
 namespace kdlib {
 
@@ -214,10 +216,22 @@ public:
     virtual SymbolPtrList findInlineFramesByVA(MEMOFFSET_64) = 0;
     virtual void getInlineSourceLine(MEMOFFSET_64, std::wstring &fileName, unsigned long &lineNo) = 0;
     virtual SymbolPtr getLexicalParent() = 0;
+
+    virtual NAME_ID getNameId() = 0;  // the id of getName(), it is interned while the symbol lives
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 
+struct SymbolLine {
+    MEMOFFSET_32  rva;
+    unsigned long  length;
+    unsigned long  fileId;      // index in the file name list
+    unsigned long  lineNo;
+    unsigned long  columnNo;    // 0 if unknown
+};
+
+typedef std::vector<SymbolLine>  SymbolLineList;
+
 class SymbolSession {
 
 public:
@@ -228,6 +242,10 @@ public:
 
     virtual void getSourceLine( MEMOFFSET_64 offset, std::wstring &fileName, unsigned long &lineNo, long &displacement ) = 0;
 
+    // the whole line number table in the symbol file order,
+    // throws ImplementException by default
+    virtual void getLineTable( SymbolLineList &lines, std::vector<std::wstring> &fileNames );
+
     virtual std::wstring getSymbolFileName() = 0;
 };
 
@@ -247,6 +265,10 @@ void setSymSrvDir(const std::wstring &symSrvDirectory);
 
 SymbolSessionPtr loadSymbolFromExports(MEMOFFSET_64 loadBase); 
 
+// the image file is used if it is the build of the module loaded at loadBase,
+// otherwise the exports are read from the memory
+SymbolSessionPtr loadSymbolFromExports(const std::wstring &imagePath, MEMOFFSET_64 loadBase);
+
 SymbolSessionPtr loadNoSymbolSession();
 
 ///////////////////////////////////////////////////////////////////////////////
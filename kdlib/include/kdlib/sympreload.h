@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/future.hpp>
+
+#include "kdlib/dbgtypedef.h"
+#include "kdlib/symengine.h"
+
+namespace kdlib {
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct SymbolPreloadPolicy {
+
+    SymbolPreloadPolicy() :
+        threadCount( 0 ),
+        moduleMask( L"*" ),
+        stackModulesFirst( true ),
+        onModuleLoad( false )
+        {}
+
+    unsigned long  threadCount;     // 0 - one worker per CPU
+    std::wstring  moduleMask;       // module names, case insensitive glob mask
+    bool  stackModulesFirst;        // modules with code on the thread stacks go first
+    bool  onModuleLoad;             // queue modules loaded later too, watches the module events
+};
+
+struct SymbolPreloadProgress {
+    size_t  total;
+    size_t  completed;
+    size_t  failed;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Symbol sessions of the current process modules loaded by a worker pool.
+// A module waits for its in-flight load on the first symbol access instead of
+// loading the symbols again. Loaded sessions not yet taken by their modules
+// are dropped with this object, as well as the modules still in the queue.
+
+class SymbolPreload;
+typedef boost::shared_ptr<SymbolPreload>  SymbolPreloadPtr;
+
+class SymbolPreload
+{
+public:
+
+    virtual ~SymbolPreload() {}
+
+    virtual SymbolPreloadProgress getProgress() = 0;
+
+    virtual bool isCompleted() = 0;
+
+    virtual void wait() = 0;
+
+    virtual void cancel() = 0;
+
+    // throws DbgException if the module is not preloaded
+    virtual boost::shared_future<SymbolSessionPtr> getModuleSymbols( MEMOFFSET_64 moduleBase ) = 0;
+};
+
+SymbolPreloadPtr preloadSymbols( const SymbolPreloadPolicy &policy = SymbolPreloadPolicy() );
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
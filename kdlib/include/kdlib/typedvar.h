@@ -427,4 +427,45 @@ TypedValue evalExpr(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// An expression parsed once for many evaluations. Literals and type casts are
+// resolved by the compilation, names are looked up in the scope of each
+// evaluation. A compiled expression can be evaluated by several threads.
+//
+// A compiled expression is also a predicate over an array or a list laid out
+// as loadTypedVarArray and loadTypedVarList get them: the fields of the
+// element are names of the scope, other names are looked up in the given
+// scope. Comparisons of the fields with constants joined by &&, || and ! are
+// evaluated over the raw memory of the elements without the typed variables.
+
+class CompiledExpr;
+typedef boost::shared_ptr<CompiledExpr>  CompiledExprPtr;
+
+class CompiledExpr : private boost::noncopyable
+{
+public:
+
+    virtual ~CompiledExpr() {}
+
+    virtual TypedValue evaluate(const ScopePtr& scope = getDefaultScope()) = 0;
+
+    // the indices of the matching elements
+    virtual std::vector<size_t> filterArray(MEMOFFSET_64 addr, const TypeInfoPtr& typeInfo, size_t count,
+        const ScopePtr& scope = getDefaultScope()) = 0;
+
+    // the addresses of the matching elements
+    virtual std::vector<MEMOFFSET_64> filterList(MEMOFFSET_64 addr, const TypeInfoPtr& typeInfo, const std::wstring& fieldName,
+        const ScopePtr& scope = getDefaultScope()) = 0;
+};
+
+// throws TypeException on a syntax error
+CompiledExprPtr compileExpr(
+    const std::wstring& expr,
+    const TypeInfoProviderPtr& typeInfoProvider = getDefaultTypeInfoProvider());
+
+CompiledExprPtr compileExpr(
+    const std::string& expr,
+    const TypeInfoProviderPtr& typeInfoProvider = getDefaultTypeInfoProvider());
+
+///////////////////////////////////////////////////////////////////////////////
+
 } // end kdlib namespace
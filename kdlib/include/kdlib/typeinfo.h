@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <boost/utility.hpp>
 #include <boost/shared_ptr.hpp>
@@ -27,6 +28,7 @@ TypeInfoPtr defineStruct( const std::wstring &structName, size_t align = 0 );
 TypeInfoPtr defineUnion( const std::wstring& unionName, size_t align = 0 );
 TypeInfoPtr defineFunction( const TypeInfoPtr& returnType, CallingConventionType callconv = CallConv_NearC);
 
+// the declarations of a source are indexed once and kept with its parsed AST
 TypeInfoPtr compileType( const std::wstring &sourceCode, const std::wstring& typeName , const std::wstring  &options=L"");
 
 size_t getSymbolSize( const std::wstring &name );
@@ -56,6 +58,7 @@ public:
     virtual std::wstring str() = 0;
 
     virtual std::wstring getName() = 0;
+    virtual NAME_ID getNameId() = 0;  // the id of getName(), it is interned while the type lives
     virtual std::wstring getScopeName() = 0;
     virtual std::pair<std::wstring, std::wstring> splitName() = 0;
 
@@ -183,6 +186,15 @@ public:
     virtual TypeInfoPtr getTypeByName(const std::wstring& name) = 0;
     virtual TypeInfoEnumeratorPtr getTypeEnumerator(const std::wstring& mask = L"") = 0;
     virtual std::wstring makeTypeName(const std::wstring& typeName, const std::wstring& qualified, bool const) = 0;
+
+    // Adds the declarations of the source to a provider built from a source.
+    // The provider source is precompiled once, an append parses only the
+    // appended declarations. The types returned before stay valid.
+    virtual void appendSource(const std::wstring& source);
+
+    // Changes when the provider types change ( an append replaces a forward
+    // declaration ): the types evaluated for another generation are dropped.
+    virtual unsigned long getGeneration();
 };
 
 class TypeInfoEnumerator {
@@ -211,12 +223,48 @@ public:
 
 TypeInfoProviderPtr  getTypeInfoProviderFromSource( const std::wstring&  source, const std::wstring&  opts = L"" );
 TypeInfoProviderPtr  getTypeInfoProviderFromSource(const std::string&  source, const std::string&  opts = "");
+
+// the result of parsing one source of a merged provider
+struct SourceParseResult {
+    bool  parsed;
+    std::wstring  error;
+    unsigned long  parseTime;   // milliseconds
+};
+
+typedef std::vector<SourceParseResult>  SourceParseResultList;
+
+// The sources are parsed by a pool of threads (0 - one per processor) and
+// merged into one provider. A type declared by several sources is taken from
+// the first source defining it, a forward declaration is used only if no
+// source defines the type. A source failed to parse is skipped, the results
+// get its error.
+TypeInfoProviderPtr  getTypeInfoProviderFromSources( const std::vector<std::wstring>&  sources, const std::wstring&  opts = L"",
+    size_t  threadCount = 0, SourceParseResultList*  results = 0 );
+TypeInfoProviderPtr  getTypeInfoProviderFromSources( const std::vector<std::string>&  sources, const std::string&  opts = "",
+    size_t  threadCount = 0, SourceParseResultList*  results = 0 );
 TypeInfoProviderPtr  getTypeInfoProviderFromPdb( const std::wstring&  pdbFile, MEMOFFSET_64  loadBase = 0 );
 TypeInfoProviderPtr  getDefaultTypeInfoProvider();
 
 SymbolProviderPtr  getSymbolProviderFromSource(const std::wstring& source, const std::wstring&  opts = L"");
 SymbolProviderPtr  getSymbolProviderFromSource(const std::string& source, const std::string&  opts = "");
 
+// The providers built from the same source and options share one parsed AST
+// kept in a process wide LRU cache. With a cache directory the parsed ASTs
+// are saved there and later processes load them instead of parsing.
+void setClangASTCacheSize( size_t maxEntries );
+void setClangASTCacheDirectory( const std::wstring& directory );
+void clearClangASTCache();
+
+// parseCount and loadCount: the sources parsed and the AST files loaded for the cache
+struct ClangASTCacheStats {
+    size_t  entryCount;
+    size_t  hitCount;
+    size_t  parseCount;
+    size_t  loadCount;
+};
+
+ClangASTCacheStats getClangASTCacheStats();
+
 ///////////////////////////////////////////////////////////////////////////////
 
 TypeInfoPtr makeCharConst(char val);
@@ -236,6 +284,8 @@ TypeInfoPtr makeBoolConst(bool val);
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// the evaluated types are kept while the provider lives, the types of the
+// default provider are looked up in the current target each time
 TypeInfoPtr evalType(const std::wstring& expr, const TypeInfoProviderPtr typeInfoProvider = getDefaultTypeInfoProvider());
 TypeInfoPtr evalType(const std::string& expr, const TypeInfoProviderPtr typeInfoProvider = getDefaultTypeInfoProvider());
 
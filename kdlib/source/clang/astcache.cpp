@@ -0,0 +1,690 @@
+#include "stdafx.h"
+
+#pragma warning( disable : 4141 4244 4291 4624 4800 4996 4267)
+
+#include <list>
+#include <vector>
+#include <unordered_map>
+
+#include <boost/thread/mutex.hpp>
+
+#include "boost/tokenizer.hpp"
+
+#include "clang/Basic/Version.h"
+#include "clang/Frontend/ASTUnit.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/PrecompiledPreamble.h"
+#include "clang/Lex/PreprocessorOptions.h"
+#include "clang/Tooling/Tooling.h"
+
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "kdlib/typeinfo.h"
+#include "kdlib/exceptions.h"
+
+#include "strconvert.h"
+#include "astcache.h"
+
+using namespace clang;
+using namespace clang::tooling;
+
+namespace kdlib {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+
+const size_t  DefaultASTCacheSize = 4;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// an AST loaded from a file keeps a reference to the PCH reader
+std::shared_ptr<PCHContainerOperations>  getPCHContainerOperations()
+{
+    static std::shared_ptr<PCHContainerOperations>  pchOperations = std::make_shared<PCHContainerOperations>();
+    return pchOperations;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the source is always parsed as this file, so the quoted includes are looked
+// up the same way with the cache directory set or not
+const char  MainFileName[] = "input.cc";
+
+///////////////////////////////////////////////////////////////////////////////
+
+class ASTBuilderAction : public clang::tooling::ToolAction
+{
+    const std::string  &MainSource;
+    std::vector<std::unique_ptr<ASTUnit>> &ASTs;
+
+public:
+    ASTBuilderAction(const std::string& MainSource, std::vector<std::unique_ptr<ASTUnit>> &ASTs) :
+        MainSource(MainSource), ASTs(ASTs) {}
+
+    bool runInvocation(std::shared_ptr<CompilerInvocation> Invocation,
+        FileManager *Files,
+        std::shared_ptr<PCHContainerOperations> PCHContainerOps,
+        DiagnosticConsumer *DiagConsumer) override {
+        // the main file is remapped to a buffer owned by the AST: a saved AST
+        // records it as overridden and does not look for it on the disk
+        Invocation->getPreprocessorOpts().addRemappedFile(MainFileName,
+            llvm::MemoryBuffer::getMemBufferCopy(MainSource, MainFileName).release());
+
+        std::unique_ptr<ASTUnit> AST = ASTUnit::LoadFromCompilerInvocation(
+            Invocation, std::move(PCHContainerOps),
+            CompilerInstance::createDiagnostics(&Invocation->getDiagnosticOpts(),
+                DiagConsumer,
+                /*ShouldOwnClient=*/false),
+            Files);
+
+        if (!AST)
+            return false;
+
+        ASTs.push_back(std::move(AST));
+        return true;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the memory files are seen over the real file system, the buffers are copies:
+// the AST outlives the source strings
+typedef std::vector<std::pair<std::string, llvm::StringRef> >  MemoryFileList;
+
+IntrusiveRefCntPtr<vfs::FileSystem> createFileSystem(const MemoryFileList& memoryFiles)
+{
+    llvm::IntrusiveRefCntPtr<vfs::OverlayFileSystem> OverlayFileSystem(
+        new vfs::OverlayFileSystem(vfs::getRealFileSystem()));
+    llvm::IntrusiveRefCntPtr<vfs::InMemoryFileSystem> InMemoryFileSystem(
+        new vfs::InMemoryFileSystem);
+    OverlayFileSystem->pushOverlay(InMemoryFileSystem);
+
+    for (auto it = memoryFiles.begin(); it != memoryFiles.end(); ++it)
+        InMemoryFileSystem->addFile(it->first, 0, llvm::MemoryBuffer::getMemBufferCopy(it->second, it->first));
+
+    return OverlayFileSystem;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void runTool(ToolAction& action, const std::string& compileOptions, const std::string& fileName,
+    IntrusiveRefCntPtr<vfs::FileSystem> fileSystem)
+{
+    llvm::IntrusiveRefCntPtr<FileManager> Files(
+        new FileManager(FileSystemOptions(), fileSystem));
+
+    std::vector< std::string > args;
+
+    args.push_back("clang-tool");
+    args.push_back("-fsyntax-only");
+
+    typedef boost::tokenizer< boost::escaped_list_separator<char> > Tokenizer;
+    boost::escaped_list_separator<char> Separator('\\', ' ', '\"');
+
+    Tokenizer tok(compileOptions, Separator);
+
+    std::copy(tok.begin(), tok.end(), std::inserter(args, args.end()));
+
+    args.push_back(fileName);
+
+    ToolInvocation toolInvocation(
+        args,
+        &action,
+        Files.get(),
+        getPCHContainerOperations()
+    );
+
+#ifndef _DEBUG
+
+    IgnoringDiagConsumer   diagnosticConsumer;
+
+    toolInvocation.setDiagnosticConsumer(&diagnosticConsumer);
+
+#endif
+
+    toolInvocation.run();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::unique_ptr<ASTUnit> parseSource(const std::string& sourceCode, const std::string& compileOptions)
+{
+    std::vector<std::unique_ptr<ASTUnit>> ASTs;
+    ASTBuilderAction Action(sourceCode, ASTs);
+
+    // the driver checks the input file exists
+    MemoryFileList  memoryFiles;
+    memoryFiles.push_back(std::make_pair(std::string(MainFileName), llvm::StringRef(sourceCode)));
+
+    runTool(Action, compileOptions, MainFileName, createFileSystem(memoryFiles));
+
+    if (ASTs.empty())
+        throw TypeException(L"failed to parse the source code");
+
+    return std::move(ASTs[0]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The main file of a precompiled source only includes it, so the preamble of
+// the main file covers all the source declarations. The declarations appended
+// after the include line are parsed over the precompiled preamble.
+
+const char  PreambleHeaderName[] = "kdlib_preamble.h";
+
+std::string getPreambleMainSource(const std::string& appendedSource)
+{
+    return std::string("#include \"") + PreambleHeaderName + "\"\n" + appendedSource;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#if CLANG_VERSION_MAJOR < 7
+
+// the callbacks have no default implementation before clang 7
+class PreambleBuilderCallbacks : public PreambleCallbacks
+{
+public:
+    void AfterExecute(CompilerInstance &) override {}
+    void AfterPCHEmitted(ASTWriter &) override {}
+    void HandleTopLevelDecl(DeclGroupRef) override {}
+    void HandleMacroDefined(const Token &, const MacroDirective *) override {}
+};
+
+#else
+
+typedef PreambleCallbacks  PreambleBuilderCallbacks;
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+class PreambleBuilderAction : public clang::tooling::ToolAction
+{
+    IntrusiveRefCntPtr<vfs::FileSystem>  FileSystem;
+    const std::string  &MainSource;
+    std::unique_ptr<PrecompiledPreamble>  &Preamble;
+
+public:
+    PreambleBuilderAction(IntrusiveRefCntPtr<vfs::FileSystem> FileSystem, const std::string& MainSource,
+        std::unique_ptr<PrecompiledPreamble>& Preamble) :
+        FileSystem(FileSystem), MainSource(MainSource), Preamble(Preamble) {}
+
+    bool runInvocation(std::shared_ptr<CompilerInvocation> Invocation,
+        FileManager *Files,
+        std::shared_ptr<PCHContainerOperations> PCHContainerOps,
+        DiagnosticConsumer *DiagConsumer) override {
+        std::unique_ptr<llvm::MemoryBuffer> MainBuffer =
+            llvm::MemoryBuffer::getMemBuffer(MainSource, MainFileName);
+
+        IntrusiveRefCntPtr<DiagnosticsEngine> Diags = CompilerInstance::createDiagnostics(
+            &Invocation->getDiagnosticOpts(), DiagConsumer, /*ShouldOwnClient=*/false);
+
+        PreambleBounds Bounds = ComputePreambleBounds(*Invocation->getLangOpts(), MainBuffer.get(), 0);
+
+        PreambleBuilderCallbacks Callbacks;
+
+        llvm::ErrorOr<PrecompiledPreamble> Built = PrecompiledPreamble::Build(
+            *Invocation, MainBuffer.get(), Bounds, *Diags, FileSystem,
+            std::move(PCHContainerOps), /*StoreInMemory=*/true, Callbacks);
+
+        if (!Built)
+            return false;
+
+        Preamble.reset(new PrecompiledPreamble(std::move(*Built)));
+        return true;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class PreambleASTBuilderAction : public clang::tooling::ToolAction
+{
+    const PrecompiledPreamble  &Preamble;
+    IntrusiveRefCntPtr<vfs::FileSystem>  FileSystem;
+    const std::string  &MainSource;
+    std::vector<std::unique_ptr<ASTUnit>>  &ASTs;
+
+public:
+    PreambleASTBuilderAction(const PrecompiledPreamble& Preamble, IntrusiveRefCntPtr<vfs::FileSystem> FileSystem,
+        const std::string& MainSource, std::vector<std::unique_ptr<ASTUnit>>& ASTs) :
+        Preamble(Preamble), FileSystem(FileSystem), MainSource(MainSource), ASTs(ASTs) {}
+
+    bool runInvocation(std::shared_ptr<CompilerInvocation> Invocation,
+        FileManager *Files,
+        std::shared_ptr<PCHContainerOperations> PCHContainerOps,
+        DiagnosticConsumer *DiagConsumer) override {
+        // the main file is remapped to the buffer owned by the AST, the file
+        // system gets the precompiled preamble kept in the memory
+        IntrusiveRefCntPtr<vfs::FileSystem> PreambleFileSystem = FileSystem;
+        Preamble.AddImplicitPreamble(*Invocation, PreambleFileSystem,
+            llvm::MemoryBuffer::getMemBufferCopy(MainSource, MainFileName).release());
+
+        IntrusiveRefCntPtr<FileManager> PreambleFiles(
+            new FileManager(Files->getFileSystemOpts(), PreambleFileSystem));
+
+        std::unique_ptr<ASTUnit> AST = ASTUnit::LoadFromCompilerInvocation(
+            Invocation, std::move(PCHContainerOps),
+            CompilerInstance::createDiagnostics(&Invocation->getDiagnosticOpts(),
+                DiagConsumer,
+                /*ShouldOwnClient=*/false),
+            PreambleFiles.get());
+
+        if (!AST)
+            return false;
+
+        ASTs.push_back(std::move(AST));
+        return true;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::unique_ptr<ASTUnit> loadASTFile(const std::string& astFileName)
+{
+    IntrusiveRefCntPtr<DiagnosticsEngine>  diags = CompilerInstance::createDiagnostics(
+        new DiagnosticOptions(), new IgnoringDiagConsumer(), /*ShouldOwnClient=*/true);
+
+    // the source is parsed with the errors ignored, so is the AST file
+#if CLANG_VERSION_MAJOR >= 7
+    return ASTUnit::LoadFromASTFile(astFileName, getPCHContainerOperations()->getRawReader(), ASTUnit::LoadEverything,
+        diags, FileSystemOptions(), /*UseDebugInfo=*/false, /*OnlyLocalDecls=*/false, llvm::None,
+        /*CaptureDiagnostics=*/false, /*AllowPCHWithCompilerErrors=*/true);
+#else
+    return ASTUnit::LoadFromASTFile(astFileName, getPCHContainerOperations()->getRawReader(),
+        diags, FileSystemOptions(), /*UseDebugInfo=*/false, /*OnlyLocalDecls=*/false, llvm::None,
+        /*CaptureDiagnostics=*/false, /*AllowPCHWithCompilerErrors=*/true);
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::string getCacheKey(const std::string& sourceCode, const std::string& compileOptions)
+{
+    llvm::SHA1  sha1;
+
+    sha1.update(sourceCode);
+    sha1.update(llvm::StringRef("", 1));
+    sha1.update(compileOptions);
+    sha1.update(llvm::StringRef("", 1));
+    sha1.update(llvm::sys::getDefaultTargetTriple());
+    sha1.update(llvm::StringRef("", 1));
+    sha1.update(CLANG_VERSION_STRING);
+
+    return llvm::toHex(sha1.final());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // end nameless namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the source precompiled in the memory, the declarations appended to it are
+// parsed by a new AST each time
+
+class ClangASTPreamble
+{
+public:
+
+    ClangASTPreamble(const std::string& sourceCode, const std::string& compileOptions) :
+        m_sourceCode(sourceCode),
+        m_compileOptions(compileOptions)
+    {
+        const std::string  mainSource = getPreambleMainSource(std::string());
+
+        IntrusiveRefCntPtr<vfs::FileSystem>  fileSystem = createPreambleFileSystem(mainSource);
+
+        PreambleBuilderAction  action(fileSystem, mainSource, m_preamble);
+
+        runTool(action, m_compileOptions, MainFileName, fileSystem);
+
+        if (!m_preamble)
+            throw TypeException(L"failed to precompile the source code");
+    }
+
+    std::unique_ptr<ASTUnit> parse(const std::string& appendedSource) const
+    {
+        const std::string  mainSource = getPreambleMainSource(appendedSource);
+
+        IntrusiveRefCntPtr<vfs::FileSystem>  fileSystem = createPreambleFileSystem(mainSource);
+
+        std::vector<std::unique_ptr<ASTUnit>>  ASTs;
+
+        PreambleASTBuilderAction  action(*m_preamble, fileSystem, mainSource, ASTs);
+
+        runTool(action, m_compileOptions, MainFileName, fileSystem);
+
+        if (ASTs.empty())
+            throw TypeException(L"failed to parse the source code");
+
+        return std::move(ASTs[0]);
+    }
+
+private:
+
+    IntrusiveRefCntPtr<vfs::FileSystem> createPreambleFileSystem(const std::string& mainSource) const
+    {
+        MemoryFileList  memoryFiles;
+        memoryFiles.push_back(std::make_pair(std::string(PreambleHeaderName), llvm::StringRef(m_sourceCode)));
+        memoryFiles.push_back(std::make_pair(std::string(MainFileName), llvm::StringRef(mainSource)));
+
+        return createFileSystem(memoryFiles);
+    }
+
+    std::string  m_sourceCode;
+    std::string  m_compileOptions;
+
+    // the ASTs read the precompiled declarations from the memory
+    std::unique_ptr<PrecompiledPreamble>  m_preamble;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+class ClangASTCache
+{
+public:
+
+    static ClangASTCache& get() {
+        static ClangASTCache  cache;
+        return cache;
+    }
+
+    ClangASTCache() :
+        m_maxEntries(DefaultASTCacheSize),
+        m_hitCount(0),
+        m_parseCount(0),
+        m_loadCount(0)
+        {}
+
+    ClangASTSessionPtr getSession(const std::string& sourceCode, const std::string& compileOptions)
+    {
+        const std::string  key = getCacheKey(sourceCode, compileOptions);
+
+        std::string  directory;
+
+        {
+            boost::mutex::scoped_lock  lock(m_lock);
+
+            IndexMap::iterator  it = m_index.find(key);
+            if (it != m_index.end())
+            {
+                ++m_hitCount;
+                m_entries.splice(m_entries.begin(), m_entries, it->second);
+                return it->second->session;
+            }
+
+            directory = m_directory;
+        }
+
+        // parse out of the lock: another source can be taken from the cache meanwhile
+        bool  loaded = false;
+
+        std::unique_ptr<ASTUnit>  ast = directory.empty() ?
+            parseSource(sourceCode, compileOptions) :
+            loadOrParse(directory, key, sourceCode, compileOptions, loaded);
+
+        ClangASTSessionPtr  session = ClangASTSession::getASTSession(ast);
+
+        EntryList  evicted;
+
+        boost::mutex::scoped_lock  lock(m_lock);
+
+        if (loaded)
+            ++m_loadCount;
+        else
+            ++m_parseCount;
+
+        IndexMap::iterator  it = m_index.find(key);
+        if (it != m_index.end())
+        {
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            return it->second->session;
+        }
+
+        if (m_maxEntries == 0)
+            return session;
+
+        CacheEntry  entry = { key, session, TypeInfoProviderPtr(), ClangASTPreamblePtr() };
+
+        m_entries.push_front(entry);
+        m_index[key] = m_entries.begin();
+
+        evict(m_maxEntries, evicted);
+
+        return session;
+    }
+
+    TypeInfoProviderPtr getTypeProvider(const std::string& sourceCode, const std::string& compileOptions)
+    {
+        const std::string  key = getCacheKey(sourceCode, compileOptions);
+
+        {
+            boost::mutex::scoped_lock  lock(m_lock);
+
+            IndexMap::iterator  it = m_index.find(key);
+            if (it != m_index.end() && it->second->provider)
+            {
+                m_entries.splice(m_entries.begin(), m_entries, it->second);
+                return it->second->provider;
+            }
+        }
+
+        // the provider takes the session from the cache and indexes the declarations out of the lock
+        TypeInfoProviderPtr  provider(new TypeInfoProviderClang(sourceCode, compileOptions));
+
+        boost::mutex::scoped_lock  lock(m_lock);
+
+        // the session can be evicted meanwhile: the provider is not kept then
+        IndexMap::iterator  it = m_index.find(key);
+        if (it == m_index.end())
+            return provider;
+
+        if (!it->second->provider)
+            it->second->provider = provider;
+
+        return it->second->provider;
+    }
+
+    ClangASTPreamblePtr getPreamble(const std::string& sourceCode, const std::string& compileOptions)
+    {
+        const std::string  key = getCacheKey(sourceCode, compileOptions);
+
+        {
+            boost::mutex::scoped_lock  lock(m_lock);
+
+            IndexMap::iterator  it = m_index.find(key);
+            if (it != m_index.end() && it->second->preamble)
+            {
+                m_entries.splice(m_entries.begin(), m_entries, it->second);
+                return it->second->preamble;
+            }
+        }
+
+        // precompile out of the lock, the preamble is kept only with a cached session
+        ClangASTPreamblePtr  preamble(new ClangASTPreamble(sourceCode, compileOptions));
+
+        boost::mutex::scoped_lock  lock(m_lock);
+
+        IndexMap::iterator  it = m_index.find(key);
+        if (it == m_index.end())
+            return preamble;
+
+        if (!it->second->preamble)
+            it->second->preamble = preamble;
+
+        return it->second->preamble;
+    }
+
+    void setMaxEntries(size_t maxEntries)
+    {
+        EntryList  evicted;
+
+        boost::mutex::scoped_lock  lock(m_lock);
+
+        m_maxEntries = maxEntries;
+        evict(m_maxEntries, evicted);
+    }
+
+    void setDirectory(const std::string& directory)
+    {
+        boost::mutex::scoped_lock  lock(m_lock);
+        m_directory = directory;
+    }
+
+    void clear()
+    {
+        EntryList  evicted;
+
+        boost::mutex::scoped_lock  lock(m_lock);
+        evict(0, evicted);
+    }
+
+    ClangASTCacheStats getStats()
+    {
+        boost::mutex::scoped_lock  lock(m_lock);
+
+        ClangASTCacheStats  stats = { m_entries.size(), m_hitCount, m_parseCount, m_loadCount };
+        return stats;
+    }
+
+private:
+
+    // the provider of compileType and the preamble are created on the first request
+    struct CacheEntry {
+        std::string  key;
+        ClangASTSessionPtr  session;
+        TypeInfoProviderPtr  provider;
+        ClangASTPreamblePtr  preamble;
+    };
+
+    typedef std::list<CacheEntry>  EntryList;
+    typedef std::unordered_map<std::string, EntryList::iterator>  IndexMap;
+
+    // the evicted sessions are released by the caller out of the lock
+    void evict(size_t maxEntries, EntryList& evicted)
+    {
+        while (m_entries.size() > maxEntries)
+        {
+            m_index.erase(m_entries.back().key);
+            evicted.splice(evicted.begin(), m_entries, --m_entries.end());
+        }
+    }
+
+    std::unique_ptr<ASTUnit> loadOrParse(const std::string& directory, const std::string& key,
+        const std::string& sourceCode, const std::string& compileOptions, bool& loaded)
+    {
+        llvm::SmallString<256>  astFileName(directory);
+        llvm::sys::path::append(astFileName, key + ".ast");
+
+        // the source text is hashed into the key, the AST file checks the
+        // included headers are not changed
+        if (llvm::sys::fs::exists(astFileName))
+        {
+            std::unique_ptr<ASTUnit>  ast = loadASTFile(astFileName.str());
+            if (ast)
+            {
+                loaded = true;
+                return ast;
+            }
+        }
+
+        std::unique_ptr<ASTUnit>  ast = parseSource(sourceCode, compileOptions);
+
+        // the AST is written to a temporary file and renamed, a failed save
+        // only costs the parsing next time
+        ast->Save(astFileName);
+
+        return ast;
+    }
+
+    boost::mutex  m_lock;
+
+    EntryList  m_entries;
+    IndexMap  m_index;
+    size_t  m_maxEntries;
+    std::string  m_directory;
+
+    size_t  m_hitCount;
+    size_t  m_parseCount;
+    size_t  m_loadCount;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // end nameless namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+ClangASTSessionPtr getClangASTSession( const std::string& sourceCode, const std::string& compileOptions )
+{
+    return ClangASTCache::get().getSession(sourceCode, compileOptions);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TypeInfoProviderPtr getClangTypeProvider( const std::string& sourceCode, const std::string& compileOptions )
+{
+    return ClangASTCache::get().getTypeProvider(sourceCode, compileOptions);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ClangASTPreamblePtr getClangASTPreamble( const std::string& sourceCode, const std::string& compileOptions )
+{
+    return ClangASTCache::get().getPreamble(sourceCode, compileOptions);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ClangASTSessionPtr getClangASTSession( const ClangASTPreamblePtr& preamble, const std::string& appendedSource )
+{
+    std::unique_ptr<ASTUnit>  ast = preamble->parse(appendedSource);
+
+    return ClangASTSession::getASTSession(ast, preamble);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void setClangASTCacheSize( size_t maxEntries )
+{
+    ClangASTCache::get().setMaxEntries(maxEntries);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void setClangASTCacheDirectory( const std::wstring& directory )
+{
+    std::string  dir = wstrToStr(directory);
+
+    if (!dir.empty() && llvm::sys::fs::create_directories(dir))
+        throw DbgWideException(L"failed to create the AST cache directory: " + directory);
+
+    ClangASTCache::get().setDirectory(dir);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void clearClangASTCache()
+{
+    ClangASTCache::get().clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ClangASTCacheStats getClangASTCacheStats()
+{
+    return ClangASTCache::get().getStats();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
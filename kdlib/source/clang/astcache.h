@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+
+#include "clang.h"
+
+namespace kdlib {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Parsed sources shared by all the clang providers: the key is a hash of the
+// source text, the compile options, the target triple and the clang version.
+// Least recently used sessions are evicted, a session lives on while any
+// provider holds it. With a cache directory set a parsed AST is saved to the
+// disk and loaded by a later process instead of parsing the source again.
+
+ClangASTSessionPtr getClangASTSession( const std::string& sourceCode, const std::string& compileOptions );
+
+// The provider compileType gets the types from. It is kept with the cached
+// session, so the declarations of a source are indexed once for all the type
+// names asked and a type is built once.
+
+TypeInfoProviderPtr getClangTypeProvider( const std::string& sourceCode, const std::string& compileOptions );
+
+// The source precompiled once for the declarations appended to it: a session
+// of the appended declarations parses only them and reads the precompiled ones
+// lazily. The preamble is kept with the cached session of the source.
+
+ClangASTPreamblePtr getClangASTPreamble( const std::string& sourceCode, const std::string& compileOptions );
+
+ClangASTSessionPtr getClangASTSession( const ClangASTPreamblePtr& preamble, const std::string& appendedSource );
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
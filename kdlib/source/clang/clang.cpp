@@ -2,7 +2,12 @@
 
 #pragma warning( disable : 4141 4244 4291 4624 4800 4996 4267)
 
+#include <algorithm>
+#include <chrono>
+
 #include "boost/tokenizer.hpp"
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
 
 #include "clang/AST/ASTConsumer.h"
 #include "clang/AST/RecursiveASTVisitor.h"
@@ -20,6 +25,7 @@
 
 #include "strconvert.h"
 #include "clang.h"
+#include "astcache.h"
 #include "fnmatch.h"
 
 using namespace clang;
@@ -108,6 +114,8 @@ TypeInfoPtr getTypeForClangBuiltinType(const clang::BuiltinType* builtinType)
 
 TypeInfoPtr getTypeForClangType( ClangASTSessionPtr&  astSession, const clang::QualType& qualType )
 {
+    ClangASTSession::Lock  lock(astSession->getLock());
+
     if ( qualType->isBuiltinType() )
     {
         const BuiltinType*  builtin = qualType->getAs<BuiltinType>();
@@ -206,6 +214,8 @@ TypeFieldPtr TypeFieldClangField::getStaticField(ClangASTSessionPtr& astSession,
 
 TypeInfoPtr TypeFieldClangField::getTypeInfo()
 {
+    ClangASTSession::Lock  lock(m_astSession->getLock());
+
     const clang::QualType qualType = m_fieldDecl->getType().getLocalUnqualifiedType().getCanonicalType();
 
     if ( qualType->isRecordType() )
@@ -260,6 +270,8 @@ TypeInfoClangStruct::TypeInfoClangStruct(const std::wstring & name, ClangASTSess
 
 void TypeInfoClangStruct::getFields()
 {
+    ClangASTSession::Lock  lock(m_astSession->getLock());
+
     getRecursiveFields( m_decl, 0 );
 }
 
@@ -348,6 +360,8 @@ void TypeInfoClangStruct::getFieldFromBaseClasses(clang::RecordDecl* recordDecl,
 
 size_t TypeInfoClangStruct::getSize()
 {
+    ClangASTSession::Lock  lock(m_astSession->getLock());
+
     const ASTRecordLayout  &typeLayout = m_decl->getASTContext().getASTRecordLayout(m_decl);
     return typeLayout.getSize().getQuantity();
 }
@@ -356,6 +370,8 @@ size_t TypeInfoClangStruct::getSize()
 
 size_t TypeInfoClangStruct::getBaseClassesCount()
 {
+    ClangASTSession::Lock  lock(m_astSession->getLock());
+
     const CXXRecordDecl  *classDecl = llvm::dyn_cast<clang::CXXRecordDecl>(m_decl);
 
     if (!classDecl)
@@ -368,6 +384,8 @@ size_t TypeInfoClangStruct::getBaseClassesCount()
 
 TypeInfoPtr TypeInfoClangStruct::getBaseClass(const std::wstring& className)
 {
+    ClangASTSession::Lock  lock(m_astSession->getLock());
+
     const CXXRecordDecl  *classDecl = llvm::dyn_cast<clang::CXXRecordDecl>(m_decl);
 
     if (!classDecl)
@@ -388,6 +406,8 @@ TypeInfoPtr TypeInfoClangStruct::getBaseClass(const std::wstring& className)
 
 TypeInfoPtr TypeInfoClangStruct::getBaseClass(size_t index)
 {
+    ClangASTSession::Lock  lock(m_astSession->getLock());
+
     const CXXRecordDecl  *classDecl = llvm::dyn_cast<clang::CXXRecordDecl>(m_decl);
 
     if (!classDecl)
@@ -403,6 +423,8 @@ TypeInfoPtr TypeInfoClangStruct::getBaseClass(size_t index)
 
 MEMOFFSET_REL TypeInfoClangStruct::getBaseClassOffset(const std::wstring &className)
 {
+    ClangASTSession::Lock  lock(m_astSession->getLock());
+
     const CXXRecordDecl  *classDecl = llvm::dyn_cast<clang::CXXRecordDecl>(m_decl);
 
     if (!classDecl)
@@ -427,6 +449,8 @@ MEMOFFSET_REL TypeInfoClangStruct::getBaseClassOffset(const std::wstring &classN
 
 MEMOFFSET_REL TypeInfoClangStruct::getBaseClassOffset(size_t index)
 {
+    ClangASTSession::Lock  lock(m_astSession->getLock());
+
     const CXXRecordDecl  *classDecl = llvm::dyn_cast<clang::CXXRecordDecl>(m_decl);
 
     if (!classDecl)
@@ -484,6 +508,7 @@ TypeInfoPtr TypeInfoClangRef::deref()
 
 TypeInfoClangFuncPrototype::TypeInfoClangFuncPrototype(ClangASTSessionPtr& session, const FunctionProtoType* funcProto)
 {
+    ClangASTSession::Lock  lock(session->getLock());
 
     m_returnType = getTypeForClangType(session, funcProto->getReturnType());
 
@@ -520,6 +545,8 @@ TypeInfoClangFuncPrototype::TypeInfoClangFuncPrototype(ClangASTSessionPtr& sessi
 TypeInfoClangFunc::TypeInfoClangFunc(ClangASTSessionPtr& session, clang::FunctionDecl*  funcDecl) :
     TypeInfoClangFuncPrototype(session, funcDecl->getFunctionType()->getAs< FunctionProtoType>() )
 {
+    ClangASTSession::Lock  lock(session->getLock());
+
     CXXRecordDecl  *parentClassDecl = llvm::dyn_cast<CXXRecordDecl>(funcDecl->getDeclContext());
     if (parentClassDecl)
     {
@@ -561,6 +588,8 @@ NumVariant TypeFieldClangEnumField::getValue() const
 
 void TypeInfoClangEnum::getFields()
 {
+    ClangASTSession::Lock  lock(m_astSession->getLock());
+
     for ( clang::EnumDecl::enumerator_iterator  enumIt = m_decl->enumerator_begin(); enumIt != m_decl->enumerator_end(); ++enumIt )
     {
         std::string   fieldName = enumIt->getNameAsString();
@@ -576,55 +605,44 @@ class DeclNextVisitor : public RecursiveASTVisitor<DeclNextVisitor>
 
 public:
 
-    DeclNextVisitor(ClangASTSessionPtr& astSession, std::map<std::string, TypeInfoPtr>* typeMap) :
-        m_session(astSession),
-        m_typeMap(typeMap)
+    DeclNextVisitor(TypeInfoProviderClang::TypeDeclIndex* typeIndex, size_t session) :
+        m_typeIndex(typeIndex),
+        m_session(session)
     {}
 
     bool VisitCXXRecordDecl(CXXRecordDecl *Declaration)
     {
-        try {
-
-            CXXRecordDecl *   definition = Declaration->getDefinition();
+        CXXRecordDecl *   definition = Declaration->getDefinition();
 
-            if (definition)
-            {
-                if (definition->isInvalidDecl())
-                    return true;
+        if (definition)
+        {
+            if (definition->isInvalidDecl())
+                return true;
 
-                auto  templateDecl = definition->getDescribedClassTemplate();
+            auto  templateDecl = definition->getDescribedClassTemplate();
 
-                if (templateDecl)
+            if (templateDecl)
+            {
+                for (auto specIt = templateDecl->spec_begin(); specIt != templateDecl->spec_end(); specIt++)
                 {
-                    for (auto specIt = templateDecl->spec_begin(); specIt != templateDecl->spec_end(); specIt++)
-                    {
-                        LangOptions  lo;
-                        PrintingPolicy pp(lo);
-                        pp.SuppressTagKeyword = true;
-                        pp.MSVCFormatting = true;
+                    LangOptions  lo;
+                    PrintingPolicy pp(lo);
+                    pp.SuppressTagKeyword = true;
+                    pp.MSVCFormatting = true;
 
-                        const std::string  &name = (*specIt)->getTypeForDecl()->getCanonicalTypeInternal().getAsString(pp);
+                    const std::string  &name = (*specIt)->getTypeForDecl()->getCanonicalTypeInternal().getAsString(pp);
 
-                        auto  rr = llvm::dyn_cast<CXXRecordDecl>(*specIt);
-
-                        auto typeInfo = TypeInfoPtr(new TypeInfoClangStruct(strToWStr(name), m_session, rr));
-                        (*m_typeMap)[name] = typeInfo;
-                    }
-                }
-                else
-                {
-                    const std::string  &name = Declaration->getQualifiedNameAsString();
-                    (*m_typeMap)[name] = TypeInfoPtr(new TypeInfoClangStruct(strToWStr(name), m_session, definition));
+                    addDecl(name, TypeInfoProviderClang::TypeDeclStruct, *specIt);
                 }
             }
             else
             {
-                const std::string  &name = Declaration->getQualifiedNameAsString();
-                (*m_typeMap)[name] = TypeInfoPtr(new TypeInfoClangStructNoDef(strToWStr(name), m_session, Declaration));
+                addDecl(Declaration->getQualifiedNameAsString(), TypeInfoProviderClang::TypeDeclStruct, definition);
             }
         }
-        catch (TypeException&)
+        else
         {
+            addDecl(Declaration->getQualifiedNameAsString(), TypeInfoProviderClang::TypeDeclStructNoDef, Declaration);
         }
 
         return true;
@@ -632,22 +650,10 @@ public:
 
     bool VisitTypedefDecl(TypedefDecl  *Declaration)
     {
+        if (Declaration->isInvalidDecl())
+            return true;
 
-        try {
-
-            if (Declaration->isInvalidDecl())
-                return true;
-
-            const std::string&  name = Declaration->getQualifiedNameAsString();
-
-            QualType  decl = Declaration->getUnderlyingType().getCanonicalType();
-
-            (*m_typeMap)[name] = getTypeForClangType(m_session, decl);
-
-        }
-        catch (TypeException&)
-        {
-        }
+        addDecl(Declaration->getQualifiedNameAsString(), TypeInfoProviderClang::TypeDeclTypedef, Declaration);
 
         return true;
     }
@@ -655,61 +661,49 @@ public:
 
     bool VisitFunctionDecl(FunctionDecl *Declaration)
     {
-        try {
-
-            if (Declaration->isInvalidDecl())
-                return true;
-
-            if (Declaration->getTemplatedKind() == FunctionDecl::TemplatedKind::TK_FunctionTemplate)
-                return true;
-
-            if (CXXRecordDecl  *parentClassDecl = llvm::dyn_cast<CXXRecordDecl>(Declaration->getDeclContext()))
-            {
-                if (parentClassDecl->getDescribedClassTemplate())
-                    return true;
-            }
-
-            std::string  name = getFunctionNameFromDecl(Declaration);
-
-            TypeInfoPtr  typeInfo = TypeInfoPtr(new TypeInfoClangFunc(m_session, Declaration));
+        if (Declaration->isInvalidDecl())
+            return true;
 
-            (*m_typeMap)[name] = typeInfo;
+        if (Declaration->getTemplatedKind() == FunctionDecl::TemplatedKind::TK_FunctionTemplate)
+            return true;
 
-        }
-        catch (TypeException&)
+        if (CXXRecordDecl  *parentClassDecl = llvm::dyn_cast<CXXRecordDecl>(Declaration->getDeclContext()))
         {
+            if (parentClassDecl->getDescribedClassTemplate())
+                return true;
         }
 
+        addDecl(getFunctionNameFromDecl(Declaration), TypeInfoProviderClang::TypeDeclFunction, Declaration);
+
         return true;
     }
 
     bool VisitEnumDecl(EnumDecl *Declaration)
     {
-        try {
-            if (Declaration->isInvalidDecl())
-                return true;
-
-            std::string  name = Declaration->getQualifiedNameAsString();
-
-            TypeInfoPtr  typeInfo = TypeInfoPtr(new TypeInfoClangEnum(m_session, Declaration));
-
-
-            (*m_typeMap)[name] = typeInfo;
+        if (Declaration->isInvalidDecl())
+            return true;
 
-        }
-        catch (TypeException&)
-        {
-        }
+        addDecl(Declaration->getQualifiedNameAsString(), TypeInfoProviderClang::TypeDeclEnum, Declaration);
 
         return true;
     }
 
 private:
 
+    // a later declaration of the same name replaces the previous one
+    void addDecl(const std::string& name, TypeInfoProviderClang::TypeDeclKind kind, clang::Decl* decl)
+    {
+        TypeInfoProviderClang::TypeDecl  &typeDecl = (*m_typeIndex)[name];
 
-    ClangASTSessionPtr  m_session;
+        typeDecl.kind = kind;
+        typeDecl.decl = decl;
+        typeDecl.session = m_session;
+        typeDecl.invalid = false;
+    }
 
-    std::map<std::string, TypeInfoPtr>  *m_typeMap;
+    TypeInfoProviderClang::TypeDeclIndex  *m_typeIndex;
+
+    size_t  m_session;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -754,6 +748,8 @@ private:
 
 size_t ClangASTSession::getPtrSize()
 {
+    Lock  lock(m_lock);
+
     const Type*  sizeType = getASTContext().getSizeType()->getTypePtr();
     return static_cast<const clang::BuiltinType*>(sizeType)->getKind() ==  clang::BuiltinType::Kind::ULongLong  ? 8 : 4;
 }
@@ -762,101 +758,182 @@ size_t ClangASTSession::getPtrSize()
 
 TypeInfoPtr compileType( const std::wstring& sourceCode, const std::wstring& typeName, const std::wstring& options)
 {
-    return getTypeInfoProviderFromSource(sourceCode, options)->getTypeByName(typeName);
+    return getClangTypeProvider(wstrToStr(sourceCode), wstrToStr(options))->getTypeByName(typeName);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-class ASTBuilderAction : public clang::tooling::ToolAction
+TypeInfoProviderClang::TypeInfoProviderClang( const std::string& sourceCode, const std::string& compileOptions) :
+    m_sourceCode(sourceCode),
+    m_compileOptions(compileOptions),
+    m_generation(0)
 {
-    std::vector<std::unique_ptr<ASTUnit>> &ASTs;
+    m_astSessions.push_back( getClangASTSession(sourceCode, compileOptions) );
 
-public:
-    ASTBuilderAction(std::vector<std::unique_ptr<ASTUnit>> &ASTs) : ASTs(ASTs) {}
-
-    bool runInvocation(std::shared_ptr<CompilerInvocation> Invocation,
-        FileManager *Files,
-        std::shared_ptr<PCHContainerOperations> PCHContainerOps,
-        DiagnosticConsumer *DiagConsumer) override {
-        std::unique_ptr<ASTUnit> AST = ASTUnit::LoadFromCompilerInvocation(
-            Invocation, std::move(PCHContainerOps),
-            CompilerInstance::createDiagnostics(&Invocation->getDiagnosticOpts(),
-                DiagConsumer,
-                /*ShouldOwnClient=*/false),
-            Files);
-
-        if (!AST)
-            return false;
-
-        ASTs.push_back(std::move(AST));
-        return true;
+    DeclNextVisitor   visitor(&m_typeIndex, 0);
+
+    {
+        // another provider of the same source can build its types meanwhile
+        ClangASTSession::Lock  lock(m_astSessions[0]->getLock());
+
+        visitor.TraverseDecl( m_astSessions[0]->getASTContext().getTranslationUnitDecl() );
     }
-};
 
-TypeInfoProviderClang::TypeInfoProviderClang( const std::string& sourceCode, const std::string& compileOptions)
+    for ( auto it = m_typeIndex.begin(); it != m_typeIndex.end(); ++it )
+        m_typeList.push_back( &*it );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The previous appends are parsed again by each append: the new declarations
+// can use them. When they reach this size they are precompiled together with
+// the source, so an append parses at most this size besides its own source.
+// A precompile reads the source and all the appends again, but it happens once
+// per this size of the appended source.
+
+static const size_t  MaxAppendedSource = 0x10000;
+
+void TypeInfoProviderClang::appendSource(const std::wstring& source)
 {
-    std::vector<std::unique_ptr<ASTUnit>> ASTs;
-    ASTBuilderAction Action(ASTs);
-    llvm::IntrusiveRefCntPtr<vfs::OverlayFileSystem> OverlayFileSystem(
-        new vfs::OverlayFileSystem(vfs::getRealFileSystem()));
-    llvm::IntrusiveRefCntPtr<vfs::InMemoryFileSystem> InMemoryFileSystem(
-        new vfs::InMemoryFileSystem);
-    OverlayFileSystem->pushOverlay(InMemoryFileSystem);
-    llvm::IntrusiveRefCntPtr<FileManager> Files(
-        new FileManager(FileSystemOptions(), OverlayFileSystem));
+    boost::mutex::scoped_lock  appendLock(m_appendLock);
 
-    std::vector< std::string > args;
+    // the source is precompiled on the first append
+    if ( !m_preamble )
+        m_preamble = getClangASTPreamble(m_sourceCode, m_compileOptions);
 
-    args.push_back("clang-tool");
-    args.push_back("-fsyntax-only");
+    ClangASTPreamblePtr  preamble = m_preamble;
+    std::string  precompiledSource;
+    std::string  appendedSource;
 
-    typedef boost::tokenizer< boost::escaped_list_separator<char> > Tokenizer;
-    boost::escaped_list_separator<char> Separator('\\', ' ', '\"');
+    const bool  precompile = m_appendedSource.size() >= MaxAppendedSource;
 
-    Tokenizer tok(compileOptions, Separator);
+    if ( precompile )
+    {
+        precompiledSource = m_precompiledSource + m_appendedSource;
+        preamble = getClangASTPreamble(m_sourceCode + '\n' + precompiledSource, m_compileOptions);
+    }
+    else
+    {
+        appendedSource = m_appendedSource;
+    }
 
-    std::copy(tok.begin(), tok.end(), std::inserter(args, args.end()));
+    appendedSource += wstrToStr(source) + '\n';
 
-    args.push_back("input.cc");
+    ClangASTSessionPtr  astSession = getClangASTSession(preamble, appendedSource);
 
-    ToolInvocation toolInvocation(
-        args,
-        &Action, 
-        Files.get(), 
-        std::move(std::make_shared< PCHContainerOperations >())
-    );
+    TypeDeclIndex  typeIndex;
 
-    InMemoryFileSystem->addFile("input.cc", 0, llvm::MemoryBuffer::getMemBuffer(sourceCode.c_str()));
+    DeclNextVisitor   visitor(&typeIndex, m_astSessions.size());
 
-#ifndef _DEBUG
+    // the precompiled declarations are not loaded: only the appended ones are visited
+    TranslationUnitDecl  *translationUnit = astSession->getASTContext().getTranslationUnitDecl();
 
-    IgnoringDiagConsumer   diagnosticConsumer;
+    for ( auto it = translationUnit->noload_decls_begin(); it != translationUnit->noload_decls_end(); ++it )
+        visitor.TraverseDecl(*it);
 
-    toolInvocation.setDiagnosticConsumer(&diagnosticConsumer);
+    boost::mutex::scoped_lock  lock(m_lock);
 
-#endif
+    m_astSessions.push_back(astSession);
 
-    toolInvocation.run();
+    // the names indexed before keep their types, only a definition replaces a forward declaration
+    for ( auto it = typeIndex.begin(); it != typeIndex.end(); ++it )
+    {
+        auto  inserted = m_typeIndex.insert(*it);
 
-    std::unique_ptr<ASTUnit>  ast = std::move(ASTs[0]);
+        if ( inserted.second )
+        {
+            m_typeList.push_back( &*inserted.first );
+            continue;
+        }
+
+        TypeDecl  &typeDecl = inserted.first->second;
+
+        if ( typeDecl.kind == TypeDeclStructNoDef && it->second.kind != TypeDeclStructNoDef )
+            typeDecl = it->second;
+    }
 
-    m_astSession = ClangASTSession::getASTSession(ast);
+    if ( precompile )
+    {
+        m_preamble = preamble;
+        m_precompiledSource.swap(precompiledSource);
+    }
 
-    DeclNextVisitor   visitor(m_astSession, &m_typeCache);
+    m_appendedSource.swap(appendedSource);
 
-    visitor.TraverseDecl( m_astSession->getASTContext().getTranslationUnitDecl() );
+    ++m_generation;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 TypeInfoPtr TypeInfoProviderClang::getTypeByName(const std::wstring& name)
 {
-    auto  foundType = m_typeCache.find( wstrToStr(name) );
+    TypeDeclKind  kind;
 
-    if ( foundType == m_typeCache.end() )
+    TypeInfoPtr  typeInfo = findType(wstrToStr(name), kind);
+    if ( !typeInfo )
         throw TypeException(name, L"Failed to get type");
 
-    return foundType->second;
+    return typeInfo;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TypeInfoPtr TypeInfoProviderClang::findType(const std::string& name, TypeDeclKind& kind)
+{
+    boost::mutex::scoped_lock  lock(m_lock);
+
+    auto  foundType = m_typeIndex.find(name);
+
+    if ( foundType == m_typeIndex.end() )
+        return TypeInfoPtr();
+
+    kind = foundType->second.kind;
+
+    return materializeType(name, foundType->second);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TypeInfoPtr TypeInfoProviderClang::materializeType(const std::string& name, TypeDecl& typeDecl)
+{
+    if (typeDecl.typeInfo || typeDecl.invalid)
+        return typeDecl.typeInfo;
+
+    ClangASTSessionPtr  &astSession = m_astSessions[typeDecl.session];
+
+    ClangASTSession::Lock  sessionLock(astSession->getLock());
+
+    try {
+
+        switch (typeDecl.kind)
+        {
+        case TypeDeclStruct:
+            typeDecl.typeInfo = TypeInfoPtr(new TypeInfoClangStruct(strToWStr(name), astSession, llvm::cast<RecordDecl>(typeDecl.decl)));
+            break;
+
+        case TypeDeclStructNoDef:
+            typeDecl.typeInfo = TypeInfoPtr(new TypeInfoClangStructNoDef(strToWStr(name), astSession, llvm::cast<RecordDecl>(typeDecl.decl)));
+            break;
+
+        case TypeDeclTypedef:
+            typeDecl.typeInfo = getTypeForClangType(astSession, llvm::cast<TypedefDecl>(typeDecl.decl)->getUnderlyingType().getCanonicalType());
+            break;
+
+        case TypeDeclFunction:
+            typeDecl.typeInfo = TypeInfoPtr(new TypeInfoClangFunc(astSession, llvm::cast<FunctionDecl>(typeDecl.decl)));
+            break;
+
+        case TypeDeclEnum:
+            typeDecl.typeInfo = TypeInfoPtr(new TypeInfoClangEnum(astSession, llvm::cast<EnumDecl>(typeDecl.decl)));
+            break;
+        }
+    }
+    catch (TypeException&)
+    {
+        typeDecl.invalid = true;
+    }
+
+    return typeDecl.typeInfo;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -868,7 +945,7 @@ TypeInfoEnumeratorPtr TypeInfoProviderClang::getTypeEnumerator(const std::wstrin
 
 ///////////////////////////////////////////////////////////////////////////////
 
-std::wstring TypeInfoProviderClang::makeTypeName(const std::wstring& typeName, const std::wstring& typeQualifier, bool isConst)
+static std::wstring makeClangTypeName(const std::wstring& typeName, const std::wstring& typeQualifier, bool isConst)
 {
     std::wstringstream  wstr;
 
@@ -885,16 +962,34 @@ std::wstring TypeInfoProviderClang::makeTypeName(const std::wstring& typeName, c
 
 ///////////////////////////////////////////////////////////////////////////////
 
-TypeInfoProviderClangEnum::TypeInfoProviderClangEnum(const std::wstring& mask, const boost::shared_ptr<TypeInfoProviderClang>& clangProvider )
+std::wstring TypeInfoProviderClang::makeTypeName(const std::wstring& typeName, const std::wstring& typeQualifier, bool isConst)
 {
-    m_index = 0;
+    return makeClangTypeName(typeName, typeQualifier, isConst);
+}
+
+///////////////////////////////////////////////////////////////////////////////
 
+TypeInfoProviderClangEnum::TypeInfoProviderClangEnum(const std::wstring& mask, const boost::shared_ptr<TypeInfoProviderClang>& clangProvider ) :
+    m_typeProvider(clangProvider),
+    m_current(0)
+{
     std::string  ansimask = wstrToStr(mask);
+    GlobMatcherA  matcher(ansimask);
+
+    {
+        boost::mutex::scoped_lock  lock(m_typeProvider->m_lock);
+
+        for ( auto it = m_typeProvider->m_typeList.begin(); it != m_typeProvider->m_typeList.end(); ++it )
+        {
+            if ( ansimask.empty() || matcher.match((*it)->first) )
+                m_typeList.push_back(*it);
+        }
+    }
 
-    std::for_each( clangProvider->m_typeCache.begin(), clangProvider->m_typeCache.end(),
-        [&]( const std::pair<std::string, TypeInfoPtr> &it ) {
-            if (ansimask.empty() || fnmatch(ansimask, it.first) )
-                m_typeList.push_back(it.second);
+    // the index elements are not moved by an append, so the pointers stay valid
+    std::sort( m_typeList.begin(), m_typeList.end(),
+        []( const TypeInfoProviderClang::TypeDeclIndex::value_type* left, const TypeInfoProviderClang::TypeDeclIndex::value_type* right ) {
+            return left->first < right->first;
         }
     );
 }
@@ -903,8 +998,17 @@ TypeInfoProviderClangEnum::TypeInfoProviderClangEnum(const std::wstring& mask, c
 
 TypeInfoPtr TypeInfoProviderClangEnum::Next()
 {
-    if ( m_index < m_typeList.size() )
-        return m_typeList[m_index++];
+    boost::mutex::scoped_lock  lock(m_typeProvider->m_lock);
+
+    while ( m_current < m_typeList.size() )
+    {
+        auto  it = m_typeList[m_current++];
+
+        TypeInfoPtr  typeInfo = m_typeProvider->materializeType(it->first, it->second);
+        if ( typeInfo )
+            return typeInfo;
+    }
+
     return TypeInfoPtr();
 }
 
@@ -924,57 +1028,262 @@ TypeInfoProviderPtr  getTypeInfoProviderFromSource(const std::string&  source, c
 
 ///////////////////////////////////////////////////////////////////////////////
 
-SymbolProviderClang::SymbolProviderClang(const std::string&  sourceCode, const std::string&  compileOptions)
+TypeInfoPtr TypeInfoProviderClangMerged::getTypeByName(const std::wstring& name)
 {
-    std::vector<std::unique_ptr<ASTUnit>> ASTs;
-    ASTBuilderAction Action(ASTs);
-    llvm::IntrusiveRefCntPtr<vfs::OverlayFileSystem> OverlayFileSystem(
-        new vfs::OverlayFileSystem(vfs::getRealFileSystem()));
-    llvm::IntrusiveRefCntPtr<vfs::InMemoryFileSystem> InMemoryFileSystem(
-        new vfs::InMemoryFileSystem);
-    OverlayFileSystem->pushOverlay(InMemoryFileSystem);
-    llvm::IntrusiveRefCntPtr<FileManager> Files(
-        new FileManager(FileSystemOptions(), OverlayFileSystem));
+    TypeInfoPtr  typeInfo = findType(wstrToStr(name));
+    if ( !typeInfo )
+        throw TypeException(name, L"Failed to get type");
 
-    std::vector< std::string > args;
+    return typeInfo;
+}
 
-    args.push_back("clang-tool");
-    args.push_back("-fsyntax-only");
+///////////////////////////////////////////////////////////////////////////////
 
-    typedef boost::tokenizer< boost::escaped_list_separator<char> > Tokenizer;
-    boost::escaped_list_separator<char> Separator('\\', ' ', '\"');
+unsigned long TypeInfoProviderClangMerged::getGeneration()
+{
+    unsigned long  generation = 0;
 
-    Tokenizer tok(compileOptions, Separator);
+    for ( auto it = m_providers.begin(); it != m_providers.end(); ++it )
+        generation += (*it)->getGeneration();
 
-    std::copy(tok.begin(), tok.end(), std::inserter(args, args.end()));
+    return generation;
+}
 
-    args.push_back("input.cc");
+///////////////////////////////////////////////////////////////////////////////
 
-    ToolInvocation toolInvocation(
-        args,
-        &Action,
-        Files.get(),
-        std::move(std::make_shared< PCHContainerOperations >())
-    );
+TypeInfoPtr TypeInfoProviderClangMerged::findType(const std::string& name)
+{
+    TypeInfoPtr  declaration;
+
+    for ( auto it = m_providers.begin(); it != m_providers.end(); ++it )
+    {
+        TypeInfoProviderClang::TypeDeclKind  kind;
+
+        TypeInfoPtr  typeInfo = (*it)->findType(name, kind);
+        if ( !typeInfo )
+            continue;
+
+        if ( kind != TypeInfoProviderClang::TypeDeclStructNoDef )
+            return typeInfo;
+
+        if ( !declaration )
+            declaration = typeInfo;
+    }
+
+    return declaration;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TypeInfoEnumeratorPtr TypeInfoProviderClangMerged::getTypeEnumerator(const std::wstring& mask)
+{
+    return TypeInfoEnumeratorPtr( new TypeInfoProviderClangMergedEnum(mask, shared_from_this()) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::wstring TypeInfoProviderClangMerged::makeTypeName(const std::wstring& typeName, const std::wstring& typeQualifier, bool isConst)
+{
+    return makeClangTypeName(typeName, typeQualifier, isConst);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TypeInfoProviderClangMergedEnum::TypeInfoProviderClangMergedEnum(const std::wstring& mask, const boost::shared_ptr<TypeInfoProviderClangMerged>& mergedProvider) :
+    m_typeProvider(mergedProvider),
+    m_current(0)
+{
+    std::string  ansimask = wstrToStr(mask);
+    GlobMatcherA  matcher(ansimask);
+
+    const std::vector<TypeInfoProviderClangPtr>&  providers = m_typeProvider->m_providers;
+
+    // the merged sources are not appended, so the lists are not changed
+    for ( auto provider = providers.begin(); provider != providers.end(); ++provider )
+    {
+        const TypeInfoProviderClang::TypeDeclList&  typeList = (*provider)->m_typeList;
+
+        for ( auto it = typeList.begin(); it != typeList.end(); ++it )
+        {
+            if ( ansimask.empty() || matcher.match((*it)->first) )
+                m_names.push_back((*it)->first);
+        }
+    }
+
+    std::sort( m_names.begin(), m_names.end() );
+    m_names.erase( std::unique(m_names.begin(), m_names.end()), m_names.end() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TypeInfoPtr TypeInfoProviderClangMergedEnum::Next()
+{
+    while ( m_current < m_names.size() )
+    {
+        TypeInfoPtr  typeInfo = m_typeProvider->findType(m_names[m_current++]);
+        if ( typeInfo )
+            return typeInfo;
+    }
+
+    return TypeInfoPtr();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// The workers take the sources by turn. Each source has its own slots for the
+// provider and the result, so only the next source index is locked.
+
+class ClangSourceParser
+{
+public:
+
+    ClangSourceParser(const std::vector<std::string>& sources, const std::string& options) :
+        m_sources(sources),
+        m_options(options),
+        m_providers(sources.size()),
+        m_results(sources.size()),
+        m_next(0)
+    {}
 
-    InMemoryFileSystem->addFile("input.cc", 0, llvm::MemoryBuffer::getMemBuffer(sourceCode.c_str()));
+    void run(size_t threadCount)
+    {
+        if ( threadCount == 0 )
+            threadCount = std::max( boost::thread::hardware_concurrency(), 1U );
 
-#ifndef _DEBUG
+        threadCount = std::min( threadCount, m_sources.size() );
 
-    IgnoringDiagConsumer   diagnosticConsumer;
+        if ( threadCount <= 1 )
+        {
+            worker();
+            return;
+        }
 
-    toolInvocation.setDiagnosticConsumer(&diagnosticConsumer);
+        boost::thread_group  workers;
 
-#endif
+        for ( size_t i = 0; i < threadCount; ++i )
+            workers.create_thread( boost::bind( &ClangSourceParser::worker, this ) );
 
-    toolInvocation.run();
+        workers.join_all();
+    }
 
-    std::unique_ptr<ASTUnit>  ast = std::move(ASTs[0]);
+    // the parsed sources in the source order
+    std::vector<TypeInfoProviderClangPtr> getProviders() const
+    {
+        std::vector<TypeInfoProviderClangPtr>  providers;
 
-    m_astSession = ClangASTSession::getASTSession(ast);
+        for ( auto it = m_providers.begin(); it != m_providers.end(); ++it )
+        {
+            if ( *it )
+                providers.push_back(*it);
+        }
+
+        return providers;
+    }
+
+    const SourceParseResultList& getResults() const
+    {
+        return m_results;
+    }
+
+private:
+
+    void worker()
+    {
+        while ( true )
+        {
+            size_t  index;
+
+            {
+                boost::mutex::scoped_lock  lock(m_lock);
+
+                if ( m_next == m_sources.size() )
+                    return;
+
+                index = m_next++;
+            }
+
+            parse(index);
+        }
+    }
+
+    void parse(size_t index)
+    {
+        SourceParseResult&  result = m_results[index];
+
+        result.parsed = false;
+
+        auto  startTime = std::chrono::steady_clock::now();
+
+        try {
+
+            m_providers[index] = TypeInfoProviderClangPtr( new TypeInfoProviderClang(m_sources[index], m_options) );
+            result.parsed = true;
+
+        } catch (std::exception& e)
+        {
+            result.error = strToWStr(e.what());
+        } catch (...)
+        {
+            result.error = L"unknown error";
+        }
+
+        auto  parseTime = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - startTime );
+
+        result.parseTime = static_cast<unsigned long>( parseTime.count() );
+    }
+
+    const std::vector<std::string>&  m_sources;
+    std::string  m_options;
+
+    std::vector<TypeInfoProviderClangPtr>  m_providers;
+    SourceParseResultList  m_results;
+
+    boost::mutex  m_lock;
+    size_t  m_next;
+};
+
+} // anonymous namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+TypeInfoProviderPtr  getTypeInfoProviderFromSources( const std::vector<std::string>&  sources, const std::string&  opts,
+    size_t  threadCount, SourceParseResultList*  results )
+{
+    ClangSourceParser  parser(sources, opts);
+
+    parser.run(threadCount);
+
+    if ( results )
+        *results = parser.getResults();
+
+    return TypeInfoProviderPtr( new TypeInfoProviderClangMerged( parser.getProviders() ) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TypeInfoProviderPtr  getTypeInfoProviderFromSources( const std::vector<std::wstring>&  sources, const std::wstring&  opts,
+    size_t  threadCount, SourceParseResultList*  results )
+{
+    std::vector<std::string>  sourceList;
+
+    for ( auto it = sources.begin(); it != sources.end(); ++it )
+        sourceList.push_back( wstrToStr(*it) );
+
+    return getTypeInfoProviderFromSources(sourceList, wstrToStr(opts), threadCount, results);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SymbolProviderClang::SymbolProviderClang(const std::string&  sourceCode, const std::string&  compileOptions)
+{
+    m_astSession = getClangASTSession(sourceCode, compileOptions);
 
     FuncVisitor   visitor(m_astSession, m_symbols);
 
+    ClangASTSession::Lock  lock(m_astSession->getLock());
+
     visitor.TraverseDecl(m_astSession->getASTContext().getTranslationUnitDecl());
 }
 
@@ -994,7 +1303,7 @@ bool SymbolEnumeratorClang::Next()
     while (m_index + 1 < symbols.size() )
     {
         const auto& sym = symbols[++m_index];
-        if (m_mask.empty() || fnmatch(m_mask, sym.first))
+        if (m_mask.empty() || m_matcher.match(sym.first))
         {
             return true;
         }
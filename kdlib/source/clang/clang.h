@@ -1,12 +1,19 @@
 #pragma once
 
+#include <unordered_map>
+#include <vector>
+
+#include <boost/atomic.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/recursive_mutex.hpp>
 
 #include <clang/Frontend/ASTUnit.h>
 #include <clang/AST/Type.h>
 
 
 #include "typeinfoimp.h"
+#include "fnmatch.h"
 
 
 namespace kdlib {
@@ -15,15 +22,25 @@ namespace kdlib {
 class ClangASTSession;
 typedef boost::shared_ptr<ClangASTSession>  ClangASTSessionPtr;
 
+class ClangASTPreamble;
+typedef boost::shared_ptr<ClangASTPreamble>  ClangASTPreamblePtr;
+
 class TypeInfoProviderClang;
 
 
+// A session is shared by all the providers of the same source through the AST
+// cache. The AST is not thread safe, even a read can load declarations or
+// compute a record layout, so each access to it is made under the session
+// lock. The lock is recursive: a type builds the types of its members.
+
 class ClangASTSession : public boost::enable_shared_from_this<ClangASTSession>
 {
 public:
 
-    static ClangASTSessionPtr getASTSession(std::unique_ptr<clang::ASTUnit>&  astUnit) {
-        return ClangASTSessionPtr( new ClangASTSession(astUnit) );
+    typedef boost::recursive_mutex::scoped_lock  Lock;
+
+    static ClangASTSessionPtr getASTSession(std::unique_ptr<clang::ASTUnit>&  astUnit, const ClangASTPreamblePtr& preamble = ClangASTPreamblePtr()) {
+        return ClangASTSessionPtr( new ClangASTSession(astUnit, preamble) );
     }
 
     //TypeInfoPtr getTypeInfo(const std::wstring& name);
@@ -34,16 +51,25 @@ public:
 
     size_t getPtrSize() ;
 
+    boost::recursive_mutex& getLock() {
+        return m_lock;
+    }
+
 
 private:
 
-    ClangASTSession(std::unique_ptr<clang::ASTUnit>& astUnit) 
+    ClangASTSession(std::unique_ptr<clang::ASTUnit>& astUnit, const ClangASTPreamblePtr& preamble) :
+        m_preamble(preamble)
     {
         astUnit.swap(m_astUnit);
     }
 
+    // the AST reads the precompiled declarations from the preamble, it is released after the AST
+    ClangASTPreamblePtr  m_preamble;
+
     std::unique_ptr<clang::ASTUnit>  m_astUnit;
 
+    boost::recursive_mutex  m_lock;
 };
 
 
@@ -360,6 +386,91 @@ protected:
 
 
 
+class TypeInfoProviderClangEnum;
+class TypeInfoProviderClangMergedEnum;
+
+class TypeInfoProviderClang : public TypeInfoProvider, public boost::enable_shared_from_this<TypeInfoProviderClang>
+{
+
+    friend TypeInfoProviderClangEnum;
+    friend TypeInfoProviderClangMergedEnum;
+
+public:
+
+    TypeInfoProviderClang( const std::string&  sourceCode, const std::string&  compileOptions);
+
+    enum TypeDeclKind {
+        TypeDeclStruct,
+        TypeDeclStructNoDef,
+        TypeDeclTypedef,
+        TypeDeclFunction,
+        TypeDeclEnum
+    };
+
+    // the type object is built on the first request, the session is an index in the provider sessions
+    struct TypeDecl {
+        TypeDeclKind  kind;
+        clang::Decl*  decl;
+        size_t  session;
+        TypeInfoPtr  typeInfo;
+        bool  invalid;
+    };
+
+    typedef std::unordered_map<std::string, TypeDecl>  TypeDeclIndex;
+
+    // the index elements in the order they are added: an element is not moved by a rehash
+    typedef std::vector<TypeDeclIndex::value_type*>  TypeDeclList;
+
+    // returns NULL if the source does not declare the type or it can not be built
+    TypeInfoPtr findType(const std::string& name, TypeDeclKind& kind);
+
+    unsigned long getGeneration() override {
+        return m_generation;
+    }
+
+private:
+
+    TypeInfoPtr getTypeByName(const std::wstring& name) override;
+
+    TypeInfoEnumeratorPtr getTypeEnumerator(const std::wstring& mask) override;
+
+    std::wstring makeTypeName(const std::wstring& typeName, const std::wstring& typeQualifier, bool isConst) override;
+
+    void appendSource(const std::wstring& source) override;
+
+    // must be called with the lock held, returns NULL if the type can not be built
+    TypeInfoPtr materializeType(const std::string& name, TypeDecl& typeDecl);
+
+private:
+
+    std::string  m_sourceCode;
+    std::string  m_compileOptions;
+
+    // the source session, then a session for each append: the previous
+    // sessions are kept for the types built from them
+    std::vector<ClangASTSessionPtr>  m_astSessions;
+
+    boost::mutex  m_lock;
+
+    TypeDeclIndex  m_typeIndex;
+    TypeDeclList  m_typeList;
+
+    // the appends are serialized, the index is extended under the lock. The
+    // preamble is the source and the precompiled appends, an append parses
+    // the appended source after them again with its own declarations
+    boost::mutex  m_appendLock;
+    ClangASTPreamblePtr  m_preamble;
+    std::string  m_precompiledSource;
+    std::string  m_appendedSource;
+
+    // incremented by each append
+    boost::atomic<unsigned long>  m_generation;
+};
+
+
+// The types declared when the enumerator is created, sorted by name. Only the
+// names are copied, a type is built when the enumerator reaches it.
+
 class TypeInfoProviderClangEnum  : public TypeInfoEnumerator {
 
 public:
@@ -371,20 +482,31 @@ public:
 
 private:
 
-    size_t   m_index;
+    boost::shared_ptr<TypeInfoProviderClang>  m_typeProvider;
+
+    TypeInfoProviderClang::TypeDeclList  m_typeList;
 
-    std::vector<TypeInfoPtr>  m_typeList;
+    size_t  m_current;
 };
 
 
-class TypeInfoProviderClang : public TypeInfoProvider, public boost::enable_shared_from_this<TypeInfoProviderClang>
+typedef boost::shared_ptr<TypeInfoProviderClang>  TypeInfoProviderClangPtr;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The providers of several sources merged into one. The sources are looked up
+// in their order, only the source giving the type builds it.
+
+class TypeInfoProviderClangMerged : public TypeInfoProvider, public boost::enable_shared_from_this<TypeInfoProviderClangMerged>
 {
 
-    friend TypeInfoProviderClangEnum;
+    friend TypeInfoProviderClangMergedEnum;
 
 public:
 
-    TypeInfoProviderClang( const std::string&  sourceCode, const std::string&  compileOptions);
+    explicit TypeInfoProviderClangMerged(const std::vector<TypeInfoProviderClangPtr>& providers) :
+        m_providers(providers)
+    {}
 
 private:
 
@@ -394,13 +516,39 @@ private:
 
     std::wstring makeTypeName(const std::wstring& typeName, const std::wstring& typeQualifier, bool isConst) override;
 
+    // the sum of the source generations
+    unsigned long getGeneration() override;
+
+    // the first definition, else the first forward declaration
+    TypeInfoPtr findType(const std::string& name);
+
 private:
 
-    ClangASTSessionPtr  m_astSession;
+    std::vector<TypeInfoProviderClangPtr>  m_providers;
+};
+
+
+// The names of all the sources sorted, a name declared by several sources is
+// returned once.
+
+class TypeInfoProviderClangMergedEnum : public TypeInfoEnumerator {
+
+public:
 
-    std::map< std::string, TypeInfoPtr>  m_typeCache;
+    virtual TypeInfoPtr Next();
+
+    TypeInfoProviderClangMergedEnum(const std::wstring& mask, const boost::shared_ptr<TypeInfoProviderClangMerged>& mergedProvider);
+
+private:
+
+    boost::shared_ptr<TypeInfoProviderClangMerged>  m_typeProvider;
+
+    std::vector<std::string>  m_names;
+
+    size_t  m_current;
 };
 
+///////////////////////////////////////////////////////////////////////////////
 
 class SymbolEnumeratorClang;
 
@@ -433,7 +581,8 @@ public:
     SymbolEnumeratorClang(const std::string& mask, const boost::shared_ptr<SymbolProviderClang>& clangProvider) :
         m_symbolProvider(clangProvider),
         m_index(-1),
-        m_mask(mask)
+        m_mask(mask),
+        m_matcher(mask)
     {}
 
 private:
@@ -449,6 +598,8 @@ private:
 
     std::string  m_mask;
 
+    GlobMatcherA  m_matcher;
+
     boost::shared_ptr<SymbolProviderClang> m_symbolProvider;
 };
 
@@ -2,23 +2,18 @@
 
 #include <memory>
 #include <regex>
+#include <unordered_map>
 
-#include "clang/Basic/MemoryBufferCache.h"
-#include "clang/Basic/TargetOptions.h"
-#include "clang/Basic/TargetInfo.h"
-
-#include "clang/Lex/Preprocessor.h"
-#include "clang/Lex/PreprocessorOptions.h"
-#include "clang/Lex/HeaderSearch.h"
-#include "clang/Lex/HeaderSearchOptions.h"
-
-#include "clang/Frontend/CompilerInstance.h"
-#include "clang/Frontend/TextDiagnosticPrinter.h"
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/weak_ptr.hpp>
 
 #include "kdlib/typedvar.h"
 #include "kdlib/exceptions.h"
 
 #include "evalexpr.h"
+#include "exprlexer.h"
+#include "exprvm.h"
+#include "exprfilter.h"
 #include "strconvert.h"
 #include "exprparser.h"
 
@@ -45,78 +40,96 @@ TypedValue evalExpr(const std::wstring& expr, const ScopePtr& scope, const TypeI
 
 TypedValue evalExpr(const std::string& expr, const ScopePtr& scope, const TypeInfoProviderPtr& typeInfoProvider)
 {
-    auto  preprocessorOptions = std::make_shared<clang::PreprocessorOptions>();
-
-    llvm::IntrusiveRefCntPtr<clang::DiagnosticIDs> diagnosticIDs(new clang::DiagnosticIDs());
+    return compileExpr(expr, typeInfoProvider)->evaluate(scope);
+}
 
-    auto diagnosticOptions = new clang::DiagnosticOptions();
+///////////////////////////////////////////////////////////////////////////////
 
-    //auto textDiagnosticPrinter = new clang::TextDiagnosticPrinter(llvm::outs(), diagnosticOptions);
+class CompiledExprImpl : public CompiledExpr
+{
+public:
 
-    auto diagnosticConsumer = new clang::IgnoringDiagConsumer();
+    explicit CompiledExprImpl(ExprNodePtr&& root) :
+        m_root(std::move(root))
+    {
+        m_root->compile(m_program);
+    }
 
-    clang::DiagnosticsEngine  diagnosticEngine(diagnosticIDs, diagnosticOptions, diagnosticConsumer);
+    TypedValue evaluate(const ScopePtr& scope) override
+    {
+        return m_program.run(scope);
+    }
 
-    clang::LangOptions  langOptions;
+    std::vector<size_t> filterArray(MEMOFFSET_64 addr, const TypeInfoPtr& typeInfo, size_t count, const ScopePtr& scope) override
+    {
+        return kdlib::filterArray(m_program, getFilter(typeInfo), addr, typeInfo, count, scope);
+    }
 
-    llvm::IntrusiveRefCntPtr<clang::vfs::InMemoryFileSystem>  memoryFileSystem(new clang::vfs::InMemoryFileSystem());
+    std::vector<MEMOFFSET_64> filterList(MEMOFFSET_64 addr, const TypeInfoPtr& typeInfo, const std::wstring& fieldName, const ScopePtr& scope) override
+    {
+        return kdlib::filterList(m_program, getFilter(typeInfo), addr, typeInfo, fieldName, scope);
+    }
 
-    memoryFileSystem->addFile("<input>", 0, llvm::MemoryBuffer::getMemBuffer(expr));
+private:
 
-    clang::FileSystemOptions  fileSystemOptions;
-    clang::FileManager  fileManager(fileSystemOptions, memoryFileSystem);
-    clang::SourceManager  sourceManager(diagnosticEngine, fileManager);
+    // the filter is built for the last element type
+    ExprFilterPtr getFilter(const TypeInfoPtr& typeInfo)
+    {
+        if (!typeInfo)
+            return ExprFilterPtr();
 
-    const clang::FileEntry *pFile = fileManager.getFile("<input>");
-    clang::FileID  fileID = sourceManager.getOrCreateFileID(pFile, clang::SrcMgr::C_User);
-    sourceManager.setMainFileID(fileID);
+        {
+            boost::mutex::scoped_lock  lock(m_filterLock);
 
-    clang::MemoryBufferCache  memoryBufferCache;
+            if (m_filterType == typeInfo)
+                return m_filter;
+        }
 
-    auto headerSearchOptions = std::make_shared<clang::HeaderSearchOptions>();
-    auto targetOptions = std::make_shared<clang::TargetOptions>();
-    targetOptions->Triple = llvm::sys::getDefaultTargetTriple();
-    clang::TargetInfo*  targetInfo = clang::TargetInfo::CreateTargetInfo(diagnosticEngine, targetOptions);
-    clang::HeaderSearch  headerSearch(headerSearchOptions, sourceManager, diagnosticEngine, langOptions, targetInfo);
+        ExprFilterPtr  filter;
 
-    clang::CompilerInstance  compilerInstance;
+        try {
+            ExprFilterBuilder  builder(typeInfo);
+            if (m_root->compileFilter(builder))
+                filter = builder.getFilter();
+        }
+        catch (DbgException&)
+        {
+        }
 
-    clang::Preprocessor   preprocessor(
-        preprocessorOptions,
-        diagnosticEngine,
-        langOptions,
-        sourceManager,
-        memoryBufferCache,
-        headerSearch,
-        compilerInstance
-    );
-    preprocessor.Initialize(*targetInfo);
+        boost::mutex::scoped_lock  lock(m_filterLock);
 
-    preprocessor.EnterMainSourceFile();
-    diagnosticConsumer->BeginSourceFile(langOptions, &preprocessor);
+        m_filterType = typeInfo;
+        m_filter = filter;
 
-    clang::Token token;
+        return filter;
+    }
 
-    std::list<clang::Token>  tokens;
+    ExprNodePtr  m_root;
+    ExprProgram  m_program;
 
-    do {
+    boost::mutex  m_filterLock;
+    TypeInfoPtr  m_filterType;
+    ExprFilterPtr  m_filter;
+};
 
-        preprocessor.Lex(token);
+///////////////////////////////////////////////////////////////////////////////
 
-        if (diagnosticEngine.hasErrorOccurred())
-        {
-            NOT_IMPLEMENTED();
-        }
+CompiledExprPtr compileExpr(const std::wstring& expr, const TypeInfoProviderPtr& typeInfoProvider)
+{
+    return compileExpr(wstrToStr(expr), typeInfoProvider);
+}
 
-        tokens.push_back(token);
+///////////////////////////////////////////////////////////////////////////////
 
-    } while (!token.is(clang::tok::eof));
+CompiledExprPtr compileExpr(const std::string& expr, const TypeInfoProviderPtr& typeInfoProvider)
+{
+    std::list<clang::Token>  tokens;
 
-    diagnosticConsumer->EndSourceFile();
+    lexExpr(expr, tokens);
 
-    ExprEval  exprEval(scope, typeInfoProvider, &tokens);
+    ExprNodePtr  root = ExprCompiler(typeInfoProvider, &tokens).getResult();
 
-    return exprEval.getResult();
+    return CompiledExprPtr(new CompiledExprImpl(std::move(root)));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -128,89 +141,289 @@ TypeInfoPtr evalType(const std::wstring& expr, const TypeInfoProviderPtr typeInf
 
 ///////////////////////////////////////////////////////////////////////////////
 
-TypeInfoPtr evalType(const std::string& expr, const TypeInfoProviderPtr typeInfoProvider)
+// The types evaluated for each provider. A provider is identified by the
+// address, the weak pointer tells a destroyed provider from a new one at the
+// same address. A destroyed provider is dropped when it is found or when a
+// new provider is added. The types of another provider generation are not
+// used: an appended source can define a type declared before. Failed
+// evaluations are not kept. The default provider is not cached: its types
+// depend on the current target and are cached by the process type cache.
+
+class TypeEvalCache
 {
-    auto  preprocessorOptions = std::make_shared<clang::PreprocessorOptions>();
+public:
 
-    llvm::IntrusiveRefCntPtr<clang::DiagnosticIDs> diagnosticIDs(new clang::DiagnosticIDs());
+    static TypeEvalCache& get() {
+        static TypeEvalCache  cache;
+        return cache;
+    }
 
-    auto diagnosticOptions = new clang::DiagnosticOptions();
+    bool find(const TypeInfoProviderPtr& typeInfoProvider, unsigned long generation, const std::string& expr, TypeInfoPtr& typeInfo)
+    {
+        {
+            boost::shared_lock<boost::shared_mutex>  readLock(m_lock);
 
-    //auto textDiagnosticPrinter = new clang::TextDiagnosticPrinter(llvm::outs(), diagnosticOptions);
+            ProviderMap::const_iterator  providerIt = m_providers.find(typeInfoProvider.get());
+            if (providerIt == m_providers.end())
+                return false;
 
-    auto diagnosticConsumer = new clang::IgnoringDiagConsumer();
+            if (!providerIt->second.provider.expired())
+            {
+                if (providerIt->second.generation != generation)
+                    return false;
 
-    clang::DiagnosticsEngine  diagnosticEngine(diagnosticIDs, diagnosticOptions, diagnosticConsumer);
+                TypeMap::const_iterator  typeIt = providerIt->second.types.find(expr);
+                if (typeIt == providerIt->second.types.end())
+                    return false;
 
-    clang::LangOptions  langOptions;
+                typeInfo = typeIt->second;
+                return true;
+            }
+        }
 
-    llvm::IntrusiveRefCntPtr<clang::vfs::InMemoryFileSystem>  memoryFileSystem(new clang::vfs::InMemoryFileSystem());
-    memoryFileSystem->addFile("<input>", 0, llvm::MemoryBuffer::getMemBuffer(expr.c_str()));
+        // a new provider at the address of a destroyed one: the types are
+        // released out of the lock
+        TypeMap  expired;
 
-    clang::FileSystemOptions  fileSystemOptions;
-    clang::FileManager  fileManager(fileSystemOptions, memoryFileSystem);
-    clang::SourceManager  sourceManager(diagnosticEngine, fileManager);
+        boost::unique_lock<boost::shared_mutex>  writeLock(m_lock);
 
-    const clang::FileEntry *pFile = fileManager.getFile("<input>");
-    clang::FileID  fileID = sourceManager.getOrCreateFileID(pFile, clang::SrcMgr::C_User);
-    sourceManager.setMainFileID(fileID);
+        ProviderMap::iterator  providerIt = m_providers.find(typeInfoProvider.get());
+        if (providerIt != m_providers.end() && providerIt->second.provider.expired())
+        {
+            expired.swap(providerIt->second.types);
+            m_providers.erase(providerIt);
+        }
 
-    clang::MemoryBufferCache  memoryBufferCache;
+        return false;
+    }
 
-    auto headerSearchOptions = std::make_shared<clang::HeaderSearchOptions>();
-    auto targetOptions = std::make_shared<clang::TargetOptions>();
-    targetOptions->Triple = llvm::sys::getDefaultTargetTriple();
-    clang::TargetInfo*  targetInfo = clang::TargetInfo::CreateTargetInfo(diagnosticEngine, targetOptions);
-    clang::HeaderSearch  headerSearch(headerSearchOptions, sourceManager, diagnosticEngine, langOptions, targetInfo);
+    void insert(const TypeInfoProviderPtr& typeInfoProvider, unsigned long generation, const std::string& expr, const TypeInfoPtr& typeInfo)
+    {
+        // the types of the destroyed providers are released out of the lock
+        std::vector<TypeMap>  expired;
 
-    clang::CompilerInstance  compilerInstance;
+        boost::unique_lock<boost::shared_mutex>  writeLock(m_lock);
 
-    clang::Preprocessor   preprocessor(
-        preprocessorOptions,
-        diagnosticEngine,
-        langOptions,
-        sourceManager,
-        memoryBufferCache,
-        headerSearch,
-        compilerInstance
-    );
-    preprocessor.Initialize(*targetInfo);
+        ProviderMap::iterator  providerIt = m_providers.find(typeInfoProvider.get());
 
-    preprocessor.EnterMainSourceFile();
-    diagnosticConsumer->BeginSourceFile(langOptions, &preprocessor);
+        if (providerIt == m_providers.end())
+        {
+            removeExpired(expired);
+            providerIt = m_providers.insert(std::make_pair(typeInfoProvider.get(), ProviderTypes())).first;
+        }
 
-    clang::Token token;
+        ProviderTypes  &providerTypes = providerIt->second;
 
-    std::list<clang::Token>  tokens;
+        if (providerTypes.provider.expired())
+        {
+            expired.push_back(TypeMap());
+            expired.back().swap(providerTypes.types);
+            providerTypes.provider = typeInfoProvider;
+            providerTypes.generation = generation;
+        }
 
-    do {
+        if (providerTypes.generation != generation)
+        {
+            // the type was evaluated before an append
+            if (static_cast<long>(generation - providerTypes.generation) < 0)
+                return;
+
+            expired.push_back(TypeMap());
+            expired.back().swap(providerTypes.types);
+            providerTypes.generation = generation;
+        }
+
+        if (providerTypes.types.size() >= MaxTypesPerProvider)
+            providerTypes.types.clear();
+
+        providerTypes.types[expr] = typeInfo;
+    }
+
+private:
+
+    static const size_t  MaxTypesPerProvider = 0x1000;
+
+    typedef std::unordered_map<std::string, TypeInfoPtr>  TypeMap;
 
-        preprocessor.Lex(token);
+    struct ProviderTypes {
 
-        if (diagnosticEngine.hasErrorOccurred())
+        ProviderTypes() :
+            generation(0)
+            {}
+
+        boost::weak_ptr<TypeInfoProvider>  provider;
+        unsigned long  generation;
+        TypeMap  types;
+    };
+
+    typedef std::unordered_map<TypeInfoProvider*, ProviderTypes>  ProviderMap;
+
+    // under the write lock
+    void removeExpired(std::vector<TypeMap>& expired)
+    {
+        for (ProviderMap::iterator it = m_providers.begin(); it != m_providers.end(); )
         {
-            NOT_IMPLEMENTED();
+            if (it->second.provider.expired())
+            {
+                expired.push_back(TypeMap());
+                expired.back().swap(it->second.types);
+                it = m_providers.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
         }
+    }
 
-        tokens.push_back(token);
+    boost::shared_mutex  m_lock;
+    ProviderMap  m_providers;
+};
 
-    } while (!token.is(clang::tok::eof));
+///////////////////////////////////////////////////////////////////////////////
+
+TypeInfoPtr evalType(const std::string& expr, const TypeInfoProviderPtr typeInfoProvider)
+{
+    bool  cached = typeInfoProvider != getDefaultTypeInfoProvider();
+
+    unsigned long  generation = cached ? typeInfoProvider->getGeneration() : 0;
+
+    TypeInfoPtr  typeInfo;
+
+    if (cached && TypeEvalCache::get().find(typeInfoProvider, generation, expr, typeInfo))
+        return typeInfo;
+
+    std::list<clang::Token>  tokens;
 
-    diagnosticConsumer->EndSourceFile();
+    lexExpr(expr, tokens);
 
     TypeEval  exprEval(ScopePtr(new ScopeList()), typeInfoProvider, &tokens);
 
-    return exprEval.getResult();
+    typeInfo = exprEval.getResult();
+
+    if (cached)
+        TypeEvalCache::get().insert(typeInfoProvider, generation, expr, typeInfo);
+
+    return typeInfo;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-ExprEval::ExprEval(const ScopePtr& scope,
+TypedValue IdentifierExprNode::getResult(const ScopePtr& scope)
+{
+    TypedValue   result;
+    if (scope->find(m_wname, result))
+        return result;
+
+    TypeInfoPtr  typeInfo;
+
+    {
+        boost::mutex::scoped_lock  lock(m_lock);
+        typeInfo = m_typeInfo;
+    }
+
+    try {
+
+        // a failed lookup is repeated: the default provider gets the types of new modules
+        if (!typeInfo)
+        {
+            typeInfo = evalType(m_name, m_typeInfoProvider);
+
+            boost::mutex::scoped_lock  lock(m_lock);
+            m_typeInfo = typeInfo;
+        }
+
+        return typeInfo->getValue();
+    }
+    catch (DbgException&)
+    {
+    }
+
+    throw  ExprException(L"error syntax");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TypedValue TernaryExprNode::getResult(const ScopePtr& scope)
+{
+    TypedValue  condition = m_condition->getResult(scope);
+    TypedValue  val1 = m_operand1->getResult(scope);
+    TypedValue  val2 = m_operand2->getResult(scope);
+
+    return TrenaryOperation(val1, val2).getResult(condition);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void TernaryExprNode::compile(ExprProgram& program)
+{
+    // only the selected operand is evaluated
+    m_condition->compile(program);
+
+    size_t  elseJump = program.emitJump(ExprOpJumpIfNot);
+
+    m_operand1->compile(program);
+
+    size_t  endJump = program.emitJump(ExprOpJump);
+
+    program.setJumpTarget(elseJump);
+
+    m_operand2->compile(program);
+
+    program.setJumpTarget(endJump);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void BinExprNode::compile(ExprProgram& program)
+{
+    ExprOpcode  opcode = m_operation->getOpcode();
+
+    m_operand1->compile(program);
+
+    // && and || skip the second operand
+    if (opcode == ExprOpAndJump || opcode == ExprOpOrJump)
+    {
+        size_t  endJump = program.emitJump(opcode);
+
+        m_operand2->compile(program);
+
+        program.emitToBool();
+        program.setJumpTarget(endJump);
+        return;
+    }
+
+    m_operand2->compile(program);
+
+    program.emitBinary(m_operation.get());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TypedValue SizeofExprNode::getResult(const ScopePtr& scope)
+{
+    if (m_expr)
+    {
+        try {
+            return m_expr->getResult(scope).getType()->getSize();
+        }
+        catch (DbgException&)
+        {
+            if (!m_typeInfo)
+                throw;
+        }
+    }
+
+    return m_typeInfo->getSize();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ExprCompiler::ExprCompiler(
     const TypeInfoProviderPtr& typeInfoProvider,
     std::list<clang::Token>* tokens,
     clang::tok::TokenKind  endToken)
 {
-    m_scope = scope;
     m_typeInfoProvider = typeInfoProvider;
     m_tokens = tokens;
     m_endToken = endToken;
@@ -218,50 +431,41 @@ ExprEval::ExprEval(const ScopePtr& scope,
 
 ///////////////////////////////////////////////////////////////////////////////
 
-TypedValue  ExprEval::getResult()
+ExprNodePtr  ExprCompiler::getResult()
 {
-    std::list<TypedValue>  operands;
-    std::list<BinOperation*> operations;
+    std::list<ExprNodePtr>  operands;
+    std::list<std::unique_ptr<BinOperation> > operations;
 
-    std::unique_ptr<UnaryOperation>  ternaryOp;
+    ExprNodePtr  ternaryOperand1;
+    ExprNodePtr  ternaryOperand2;
 
     while ( true )
     {
         UnaryOperation*  preOp = 0;
-        std::list<UnaryOperation*>  preOperations;
+        std::list<std::unique_ptr<UnaryOperation> >  preOperations;
         while (0 != (preOp = getPreUnaryOperation()))
         {
-            preOperations.push_front(preOp);
+            preOperations.emplace_front(preOp);
         }
 
-        auto  val = getOperand();
-
-        UnaryOperation*  postOp = 0;
-        std::list<UnaryOperation*>  postOperations;
-        while (0 != (postOp = getPostUnaryOperation()))
-        {
-            postOperations.push_back(postOp);
-        }
+        auto  operand = getOperand();
 
-        for (auto op : postOperations)
+        while (getPostUnaryOperation(operand))
         {
-            val = op->getResult(val);
-            delete op;
         }
 
-        for (auto op : preOperations)
+        for (auto& op : preOperations)
         {
-            val = op->getResult(val);
-            delete op;
+            operand = ExprNodePtr(new UnaryExprNode(op.release(), std::move(operand)));
         }
 
-        operands.push_back(val);
+        operands.push_back(std::move(operand));
 
         auto token = m_tokens->front();
 
         if (token.is(clang::tok::question))
         {
-            ternaryOp.reset(getTernaryOperation());
+            getTernaryOperation(ternaryOperand1, ternaryOperand2);
             break;
         }
 
@@ -271,13 +475,13 @@ TypedValue  ExprEval::getResult()
             break;
         }
 
-        operations.push_back(getOperation());
+        operations.emplace_back(getOperation());
     }
 
     while (!operations.empty())
     {
         auto  op = std::max_element(operations.begin(), operations.end(),
-            [](const BinOperation* op1, const BinOperation* op2)
+            [](const std::unique_ptr<BinOperation>& op1, const std::unique_ptr<BinOperation>& op2)
             {
                 return op1->getPriority() > op2->getPriority();
             });
@@ -285,27 +489,23 @@ TypedValue  ExprEval::getResult()
         auto op1 = operands.begin();
         std::advance(op1, std::distance(operations.begin(), op));
 
-        auto op2 = operands.begin();
-        std::advance(op2, std::distance(operations.begin(), op) + 1);
+        auto op2 = std::next(op1);
 
-        auto res = (*op)->getResult(*op1, *op2);
+        *op1 = ExprNodePtr(new BinExprNode(op->release(), std::move(*op1), std::move(*op2)));
 
-        delete *op;
         operations.erase(op);
-
-        *op1 = res;
         operands.erase(op2);
     }
 
-    if (ternaryOp)
-        return ternaryOp->getResult(operands.front());
+    if (ternaryOperand1)
+        return ExprNodePtr(new TernaryExprNode(std::move(operands.front()), std::move(ternaryOperand1), std::move(ternaryOperand2)));
 
-    return operands.front();
+    return std::move(operands.front());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-TypedValue ExprEval::getOperand()
+ExprNodePtr ExprCompiler::getOperand()
 {
     if (m_tokens->empty())
         throw ExprException(L"error syntax");
@@ -321,17 +521,17 @@ TypedValue ExprEval::getOperand()
 
     if (token.is(clang::tok::numeric_constant))
     {
-        return getNumericConst(token);
+        return ExprNodePtr(new ConstExprNode(getNumericConst(token)));
     }
 
     if (token.isOneOf(clang::tok::char_constant, clang::tok::wide_char_constant))
     {
-        return getCharConst(token);
+        return ExprNodePtr(new ConstExprNode(getCharConst(token)));
     }
 
     if (token.is(clang::tok::l_paren))
     {
-        return ExprEval(m_scope, m_typeInfoProvider, m_tokens, clang::tok::r_paren).getResult();
+        return ExprCompiler(m_typeInfoProvider, m_tokens, clang::tok::r_paren).getResult();
     }
 
     if (token.is(clang::tok::kw_sizeof))
@@ -344,7 +544,7 @@ TypedValue ExprEval::getOperand()
 
 ///////////////////////////////////////////////////////////////////////////////
 
-BinOperation* ExprEval::getOperation()
+BinOperation* ExprCompiler::getOperation()
 {
     if (m_tokens->empty())
         throw ExprException(L"error syntax");
@@ -415,7 +615,7 @@ BinOperation* ExprEval::getOperation()
 
 ///////////////////////////////////////////////////////////////////////////////
 
-UnaryOperation* ExprEval::getPreUnaryOperation()
+UnaryOperation* ExprCompiler::getPreUnaryOperation()
 {
     if (m_tokens->empty())
         throw ExprException(L"error syntax");
@@ -463,33 +663,40 @@ UnaryOperation* ExprEval::getPreUnaryOperation()
 
 ///////////////////////////////////////////////////////////////////////////////
 
-UnaryOperation* ExprEval::getPostUnaryOperation()
+bool ExprCompiler::getPostUnaryOperation(ExprNodePtr& operand)
 {
     assert(!m_tokens->empty());
 
     auto  token = m_tokens->front();
 
     if (token.isOneOf(m_endToken, clang::tok::question))
-        return nullptr;
+        return false;
 
     if (isBinOperation(token))
-        return nullptr;
+        return false;
 
     if (token.is(clang::tok::l_square))
-        return getArrayOperation();
+    {
+        operand = getArrayOperation(operand);
+        return true;
+    }
 
-    if (token.is(clang::tok::period))
-        return getAttributeOperation();
+    UnaryOperation*  postOp = 0;
 
-    if (token.is(clang::tok::arrow))
-        return getAttributeOperationPtr();
+    if (token.is(clang::tok::period))
+        postOp = getAttributeOperation();
+    else if (token.is(clang::tok::arrow))
+        postOp = getAttributeOperationPtr();
+    else
+        throw ExprException(L"error syntax");
 
-    throw ExprException(L"error syntax");
+    operand = ExprNodePtr(new UnaryExprNode(postOp, std::move(operand)));
+    return true;
 }
 
 /////////////////////////////////////////////////////////////////////////////////
 
-UnaryOperation* ExprEval::getArrayOperation()
+ExprNodePtr ExprCompiler::getArrayOperation(ExprNodePtr& operand)
 {
     auto  token = m_tokens->front();
 
@@ -498,14 +705,14 @@ UnaryOperation* ExprEval::getArrayOperation()
 
     m_tokens->pop_front();
 
-    auto indexVal = ExprEval(m_scope, m_typeInfoProvider, m_tokens, clang::tok::r_square).getResult();
+    auto index = ExprCompiler(m_typeInfoProvider, m_tokens, clang::tok::r_square).getResult();
 
-    return new ArrayValueOperation(indexVal);
+    return ExprNodePtr(new ArrayExprNode(std::move(operand), std::move(index)));
 }
 
 /////////////////////////////////////////////////////////////////////////////////
 
-UnaryOperation* ExprEval::getAttributeOperation()
+UnaryOperation* ExprCompiler::getAttributeOperation()
 {
     auto  token = m_tokens->front();
 
@@ -531,7 +738,7 @@ UnaryOperation* ExprEval::getAttributeOperation()
 
 /////////////////////////////////////////////////////////////////////////////////
 
-UnaryOperation* ExprEval::getAttributeOperationPtr()
+UnaryOperation* ExprCompiler::getAttributeOperationPtr()
 {
     auto  token = m_tokens->front();
 
@@ -557,7 +764,7 @@ UnaryOperation* ExprEval::getAttributeOperationPtr()
 
 /////////////////////////////////////////////////////////////////////////////////
 
-UnaryOperation* ExprEval::getSizeofOperation()
+UnaryOperation* ExprCompiler::getSizeofOperation()
 {
     auto token = m_tokens->front();
 
@@ -577,7 +784,7 @@ UnaryOperation* ExprEval::getSizeofOperation()
 
 ///////////////////////////////////////////////////////////////////////////////
 
-UnaryOperation* ExprEval::getTypeCastOperation()
+UnaryOperation* ExprCompiler::getTypeCastOperation()
 {
     auto token = m_tokens->front();
 
@@ -590,7 +797,7 @@ UnaryOperation* ExprEval::getTypeCastOperation()
 
         exprCopy.pop_front();
 
-        TypeInfoPtr  typeCast = TypeEval(m_scope, m_typeInfoProvider, &exprCopy, clang::tok::r_paren).getResult();
+        TypeInfoPtr  typeCast = TypeEval(ScopePtr(new ScopeList()), m_typeInfoProvider, &exprCopy, clang::tok::r_paren).getResult();
 
         *m_tokens = exprCopy;
 
@@ -606,7 +813,7 @@ UnaryOperation* ExprEval::getTypeCastOperation()
 
 ///////////////////////////////////////////////////////////////////////////////
 
-UnaryOperation* ExprEval::getTernaryOperation()
+void ExprCompiler::getTernaryOperation(ExprNodePtr& operand1, ExprNodePtr& operand2)
 {
     auto token = m_tokens->front();
 
@@ -615,16 +822,14 @@ UnaryOperation* ExprEval::getTernaryOperation()
 
     m_tokens->pop_front();
 
-    TypedValue  val1 = ExprEval(m_scope, m_typeInfoProvider, m_tokens, clang::tok::colon).getResult();
-
-    TypedValue  val2 = ExprEval(m_scope, m_typeInfoProvider, m_tokens, m_endToken).getResult();
+    operand1 = ExprCompiler(m_typeInfoProvider, m_tokens, clang::tok::colon).getResult();
 
-    return new TrenaryOperation(val1, val2);
+    operand2 = ExprCompiler(m_typeInfoProvider, m_tokens, m_endToken).getResult();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-size_t ExprEval::getSizeof()
+ExprNodePtr ExprCompiler::getSizeof()
 {
     auto token = m_tokens->front();
 
@@ -636,25 +841,39 @@ size_t ExprEval::getSizeof()
     if (m_tokens->front().is(m_endToken))
         throw ExprException(L"error syntax");
 
+    // a name can be a variable in one scope and a type in another one, so the
+    // type is kept for a failed evaluation
+    ExprNodePtr  expr;
+    std::list<clang::Token>   exprCopy(m_tokens->begin(), m_tokens->end());
+
     try {
-        std::list<clang::Token>   exprCopy(m_tokens->begin(), m_tokens->end());
-        TypedValue  exprResult = ExprEval(m_scope, m_typeInfoProvider, &exprCopy, clang::tok::r_paren).getResult();
-        *m_tokens = exprCopy;
-        return exprResult.getType()->getSize();
+        expr = ExprCompiler(m_typeInfoProvider, &exprCopy, clang::tok::r_paren).getResult();
+    }
+    catch (DbgException&)
+    {  }
+
+    TypeInfoPtr  typeInfo;
+    std::list<clang::Token>   typeCopy(m_tokens->begin(), m_tokens->end());
+
+    try {
+        typeInfo = TypeEval(ScopePtr(new ScopeList()), m_typeInfoProvider, &typeCopy, clang::tok::r_paren).getResult();
     }
     catch (DbgException&)
     {  }
 
-    TypeInfoPtr  typeInfo = TypeEval(m_scope, m_typeInfoProvider, m_tokens, clang::tok::r_paren).getResult();
-    if ( !typeInfo )
+    if (expr)
+        m_tokens->swap(exprCopy);
+    else if (typeInfo)
+        m_tokens->swap(typeCopy);
+    else
         throw ExprException(L"error syntax");
 
-    return typeInfo->getSize();
+    return ExprNodePtr(new SizeofExprNode(std::move(expr), typeInfo));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-TypedValue ExprEval::getIdentifierValue()
+ExprNodePtr ExprCompiler::getIdentifierValue()
 {
     std::string  fullName;
 
@@ -685,28 +904,15 @@ TypedValue ExprEval::getIdentifierValue()
 
 
     if (fullName == "true")
-        return TypedValue(true);
+        return ExprNodePtr(new ConstExprNode(TypedValue(true)));
 
     if (fullName == "false")
-        return TypedValue(false);
+        return ExprNodePtr(new ConstExprNode(TypedValue(false)));
 
     if (fullName == "nullptr")
-        return TypedValue(nullptr);
-
-    TypedValue   result;
-    std::wstring  wname = strToWStr(fullName);
-    if (m_scope->find(wname, result))
-        return result;
-
-    try {
-        return evalType(fullName, m_typeInfoProvider)->getValue();
-    }
-    catch (DbgException&)
-    {
-    }
-
-    throw  ExprException(L"error syntax");
+        return ExprNodePtr(new ConstExprNode(TypedValue(nullptr)));
 
+    return ExprNodePtr(new IdentifierExprNode(fullName, m_typeInfoProvider));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
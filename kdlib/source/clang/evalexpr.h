@@ -1,5 +1,9 @@
 #pragma once
 
+#include <memory>
+
+#include <boost/thread/mutex.hpp>
+
 #include "clang/Lex/Token.h"
 
 #include "kdlib/typedvar.h"
@@ -8,6 +12,8 @@
 #include "strconvert.h"
 #include "typeparser.h"
 #include "exprparser.h"
+#include "exprvm.h"
+#include "exprfilter.h"
 
 namespace kdlib {
 
@@ -16,8 +22,10 @@ class BinOperation {
 public:
     BinOperation() {}
     BinOperation(BinOperation&) = delete;
+    virtual ~BinOperation() {}
     virtual TypedValue getResult(const TypedValue& val1, const TypedValue& val2) = 0;
     virtual int getPriority() const = 0;
+    virtual ExprOpcode getOpcode() const { return ExprOpBinary; }
 };
 
 class UnaryOperation {
@@ -25,7 +33,9 @@ public:
     UnaryOperation()
     {}
     UnaryOperation(UnaryOperation&) = delete;
+    virtual ~UnaryOperation() {}
     virtual TypedValue getResult(const TypedValue& val) = 0;
+    virtual ExprOpcode getOpcode() const { return ExprOpUnary; }
 };
  
 
@@ -40,6 +50,11 @@ class UnMinusOperation : public UnaryOperation
 {
 public:
     TypedValue getResult(const TypedValue& val) override;
+
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpNeg;
+    }
 };
 
 class UnPlusOperation : public UnaryOperation
@@ -49,6 +64,11 @@ public:
     {
         return val;
     }
+
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpPlus;
+    }
 };
 
 class DerefOperation : public UnaryOperation
@@ -59,6 +79,11 @@ public:
         TypedValue  v = val;
         return v.deref();
     }
+
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpDeref;
+    }
 };
 
 
@@ -75,12 +100,22 @@ class BitwiseNotOperation : public UnaryOperation
 {
 public:
     TypedValue getResult(const TypedValue& val) override;
+
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpBitNot;
+    }
 };
 
 class BooleanNotOperation : public UnaryOperation
 {
 public:
     TypedValue getResult(const TypedValue& val) override;
+
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpBoolNot;
+    }
 };
 
 class PreIncrementOperation : public UnaryOperation
@@ -100,8 +135,6 @@ public:
         m_index(value)
     {}
 
-private:
-
     TypedValue getResult(const TypedValue& val) override
     {
         TypedValue  v = val;
@@ -119,6 +152,16 @@ public:
         m_attributeName(attrName)
     {}
 
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpField;
+    }
+
+    std::wstring getAttributeName() const
+    {
+        return strToWStr(m_attributeName);
+    }
+
 protected:
 
     TypedValue getResult(const TypedValue& val) override
@@ -223,6 +266,11 @@ class AddExprOperation : public BinOperation
     {
         return BinOpearationPriority::Add;
     }
+
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpAdd;
+    }
 };
 
 
@@ -235,6 +283,11 @@ class SubExprOperation : public BinOperation
     {
         return BinOpearationPriority::Sub;
     }
+
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpSub;
+    }
 };
 
 class MultExprOperation : public BinOperation {
@@ -245,6 +298,11 @@ class MultExprOperation : public BinOperation {
     {
         return BinOpearationPriority::Mul;
     }
+
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpMul;
+    }
 };
 
 class DivExprOperation : public BinOperation {
@@ -255,6 +313,11 @@ class DivExprOperation : public BinOperation {
     {
         return BinOpearationPriority::Div;
     }
+
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpDiv;
+    }
 };
 
 class ModExprOperation : public BinOperation {
@@ -265,6 +328,11 @@ class ModExprOperation : public BinOperation {
     {
         return BinOpearationPriority::Mod;
     }
+
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpMod;
+    }
 };
 
 class EqualOperation : public BinOperation {
@@ -278,6 +346,11 @@ class EqualOperation : public BinOperation {
     {
         return BinOpearationPriority::Equal;
     }
+
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpEq;
+    }
 };
 
 class NotEqualOperation : public BinOperation {
@@ -291,6 +364,11 @@ class NotEqualOperation : public BinOperation {
     {
         return BinOpearationPriority::NotEqual;
     }
+
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpNe;
+    }
 };
 
 class LessOperation : public BinOperation {
@@ -304,6 +382,11 @@ class LessOperation : public BinOperation {
     {
         return BinOpearationPriority::NotEqual;
     }
+
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpLt;
+    }
 };
 
 class LessEqualOperation : public BinOperation {
@@ -317,6 +400,11 @@ class LessEqualOperation : public BinOperation {
     {
         return BinOpearationPriority::LessEqual;
     }
+
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpLe;
+    }
 };
 
 class GreaterOperation : public BinOperation {
@@ -330,6 +418,11 @@ class GreaterOperation : public BinOperation {
     {
         return BinOpearationPriority::Greater;
     }
+
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpGt;
+    }
 };
 
 class GreaterEqualOperation : public BinOperation {
@@ -343,6 +436,11 @@ class GreaterEqualOperation : public BinOperation {
     {
         return BinOpearationPriority::GreaterEqual;
     }
+
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpGe;
+    }
 };
 
 class LeftShiftOperation : public BinOperation {
@@ -353,6 +451,11 @@ class LeftShiftOperation : public BinOperation {
     {
         return BinOpearationPriority::LeftShift;
     }
+
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpShl;
+    }
 };
 
 class RightShiftOperation : public BinOperation {
@@ -363,6 +466,11 @@ class RightShiftOperation : public BinOperation {
     {
         return BinOpearationPriority::RightShift;
     }
+
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpShr;
+    }
 };
 
 class BitwiseAndOperation: public BinOperation {
@@ -374,6 +482,11 @@ class BitwiseAndOperation: public BinOperation {
         return BinOpearationPriority::BitwiseAnd;
     }
 
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpBitAnd;
+    }
+
 };
 
 class BitwiseOrOperation : public BinOperation {
@@ -385,6 +498,11 @@ class BitwiseOrOperation : public BinOperation {
         return BinOpearationPriority::BitwiseOr;
     }
 
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpBitOr;
+    }
+
 };
 
 class BitwiseXorOperation : public BinOperation {
@@ -396,6 +514,11 @@ class BitwiseXorOperation : public BinOperation {
         return BinOpearationPriority::BitwiseXor;
     }
 
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpBitXor;
+    }
+
 };
 
 
@@ -411,6 +534,11 @@ class BoolOrOperation : public BinOperation {
         return BinOpearationPriority::BooleanOr;
     }
 
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpOrJump;
+    }
+
 };
 
 class BoolAndOperation : public BinOperation {
@@ -424,48 +552,258 @@ class BoolAndOperation : public BinOperation {
     {
         return BinOpearationPriority::BooleanAnd;
     }
+
+    ExprOpcode getOpcode() const override
+    {
+        return ExprOpAndJump;
+    }
 };
 
 
 ///////////////////////////////////////////////////////////////////////////////
 
-class ExprEval {
+// A node of a compiled expression. The nodes are not changed by the
+// evaluation, so one compiled expression can be evaluated by several threads.
+// A node is lowered to the bytecode by compile, a node without the bytecode
+// is evaluated by getResult from the program. A predicate over the elements of
+// a collection is lowered to a filter by compileFilter if it is simple enough.
 
+class ExprNode {
 public:
+    virtual ~ExprNode() {}
+    virtual TypedValue getResult(const ScopePtr& scope) = 0;
 
-    ExprEval(
-        const ScopePtr& scope,
+    virtual void compile(ExprProgram& program)
+    {
+        program.emitEval(this);
+    }
+
+    virtual bool compileFilter(ExprFilterBuilder& filter)
+    {
+        return false;
+    }
+};
+
+typedef std::unique_ptr<ExprNode>  ExprNodePtr;
+
+class ConstExprNode : public ExprNode
+{
+public:
+
+    explicit ConstExprNode(const TypedValue& value) :
+        m_value(value)
+    {}
+
+    TypedValue getResult(const ScopePtr& scope) override
+    {
+        return m_value;
+    }
+
+    void compile(ExprProgram& program) override
+    {
+        program.emitConst(m_value);
+    }
+
+    bool compileFilter(ExprFilterBuilder& filter) override
+    {
+        return filter.pushConst(m_value);
+    }
+
+private:
+
+    TypedValue  m_value;
+};
+
+class IdentifierExprNode : public ExprNode
+{
+public:
+
+    IdentifierExprNode(const std::string& name, const TypeInfoProviderPtr& typeInfoProvider) :
+        m_name(name),
+        m_wname(strToWStr(name)),
+        m_typeInfoProvider(typeInfoProvider)
+    {}
+
+    TypedValue getResult(const ScopePtr& scope) override;
+
+    bool compileFilter(ExprFilterBuilder& filter) override
+    {
+        return filter.pushField(m_wname);
+    }
+
+private:
+
+    std::string  m_name;
+    std::wstring  m_wname;
+    TypeInfoProviderPtr  m_typeInfoProvider;
+
+    // the type is looked up once, the value is read by each evaluation
+    boost::mutex  m_lock;
+    TypeInfoPtr  m_typeInfo;
+};
+
+class UnaryExprNode : public ExprNode
+{
+public:
+
+    UnaryExprNode(UnaryOperation* operation, ExprNodePtr&& operand) :
+        m_operation(operation),
+        m_operand(std::move(operand))
+    {}
+
+    TypedValue getResult(const ScopePtr& scope) override
+    {
+        return m_operation->getResult(m_operand->getResult(scope));
+    }
+
+    void compile(ExprProgram& program) override
+    {
+        m_operand->compile(program);
+        program.emitUnary(m_operation.get());
+    }
+
+    bool compileFilter(ExprFilterBuilder& filter) override
+    {
+        return m_operand->compileFilter(filter) && filter.applyUnary(m_operation->getOpcode());
+    }
+
+private:
+
+    std::unique_ptr<UnaryOperation>  m_operation;
+    ExprNodePtr  m_operand;
+};
+
+class BinExprNode : public ExprNode
+{
+public:
+
+    BinExprNode(BinOperation* operation, ExprNodePtr&& operand1, ExprNodePtr&& operand2) :
+        m_operation(operation),
+        m_operand1(std::move(operand1)),
+        m_operand2(std::move(operand2))
+    {}
+
+    TypedValue getResult(const ScopePtr& scope) override
+    {
+        TypedValue  val1 = m_operand1->getResult(scope);
+        return m_operation->getResult(val1, m_operand2->getResult(scope));
+    }
+
+    void compile(ExprProgram& program) override;
+
+    bool compileFilter(ExprFilterBuilder& filter) override
+    {
+        return m_operand1->compileFilter(filter) && m_operand2->compileFilter(filter) && filter.applyBinary(m_operation->getOpcode());
+    }
+
+private:
+
+    std::unique_ptr<BinOperation>  m_operation;
+    ExprNodePtr  m_operand1;
+    ExprNodePtr  m_operand2;
+};
+
+class ArrayExprNode : public ExprNode
+{
+public:
+
+    ArrayExprNode(ExprNodePtr&& operand, ExprNodePtr&& index) :
+        m_operand(std::move(operand)),
+        m_index(std::move(index))
+    {}
+
+    TypedValue getResult(const ScopePtr& scope) override
+    {
+        TypedValue  val = m_operand->getResult(scope);
+        return ArrayValueOperation(m_index->getResult(scope)).getResult(val);
+    }
+
+    void compile(ExprProgram& program) override
+    {
+        m_operand->compile(program);
+        m_index->compile(program);
+        program.emitIndex();
+    }
+
+private:
+
+    ExprNodePtr  m_operand;
+    ExprNodePtr  m_index;
+};
+
+class TernaryExprNode : public ExprNode
+{
+public:
+
+    TernaryExprNode(ExprNodePtr&& condition, ExprNodePtr&& operand1, ExprNodePtr&& operand2) :
+        m_condition(std::move(condition)),
+        m_operand1(std::move(operand1)),
+        m_operand2(std::move(operand2))
+    {}
+
+    TypedValue getResult(const ScopePtr& scope) override;
+
+    void compile(ExprProgram& program) override;
+
+private:
+
+    ExprNodePtr  m_condition;
+    ExprNodePtr  m_operand1;
+    ExprNodePtr  m_operand2;
+};
+
+class SizeofExprNode : public ExprNode
+{
+public:
+
+    // the expression or the type can be null, not both
+    SizeofExprNode(ExprNodePtr&& expr, const TypeInfoPtr& typeInfo) :
+        m_expr(std::move(expr)),
+        m_typeInfo(typeInfo)
+    {}
+
+    TypedValue getResult(const ScopePtr& scope) override;
+
+private:
+
+    ExprNodePtr  m_expr;
+    TypeInfoPtr  m_typeInfo;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class ExprCompiler {
+
+public:
+
+    ExprCompiler(
         const TypeInfoProviderPtr& typeInfoProvider,
         std::list<clang::Token>* tokens,
         clang::tok::TokenKind  endToken = clang::tok::eof
         );
 
-    TypedValue  getResult();
+    ExprNodePtr  getResult();
 
 private:
 
-    ScopePtr   m_scope;
     TypeInfoProviderPtr  m_typeInfoProvider;
     std::list<clang::Token>*  m_tokens;
     clang::tok::TokenKind  m_endToken;
 
-    TypedValue getOperand();
+    ExprNodePtr getOperand();
     BinOperation *getOperation();
     UnaryOperation* getPreUnaryOperation();
-    UnaryOperation* getPostUnaryOperation();
-    UnaryOperation* getArrayOperation();
+    bool getPostUnaryOperation(ExprNodePtr& operand);
+    ExprNodePtr getArrayOperation(ExprNodePtr& operand);
     UnaryOperation* getAttributeOperation();
     UnaryOperation* getAttributeOperationPtr();
     UnaryOperation* getSizeofOperation();
     UnaryOperation* getTypeCastOperation();
-    UnaryOperation* getTernaryOperation();
-
-    size_t getSizeof();
+    void getTernaryOperation(ExprNodePtr& operand1, ExprNodePtr& operand2);
 
-    TypedValue getIdentifierValue();
+    ExprNodePtr getSizeof();
 
-    TypeInfoPtr getTypeDeclaration();
-    TypeInfoPtr getBasedTypeDeclaration();
+    ExprNodePtr getIdentifierValue();
  };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,841 @@
+#include "stdafx.h"
+
+#pragma warning( disable : 4141 4244 4291 4624 4800 4996 4267)
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+#include "kdlib/typedvar.h"
+#include "kdlib/memaccess.h"
+#include "kdlib/exceptions.h"
+
+#include "evalexpr.h"
+#include "exprfilter.h"
+
+namespace kdlib {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t getLoadSize(ExprLoadKind load)
+{
+    switch (load)
+    {
+    case ExprLoadSignByte:
+    case ExprLoadByte:
+    case ExprLoadBool:
+        return 1;
+
+    case ExprLoadSignWord:
+    case ExprLoadWord:
+        return 2;
+
+    case ExprLoadSignDWord:
+    case ExprLoadDWord:
+    case ExprLoadFloat:
+        return 4;
+
+    case ExprLoadSignQWord:
+    case ExprLoadQWord:
+    case ExprLoadDouble:
+        return 8;
+    }
+
+    throw ExprException(L"error syntax");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// a zero of the type the field value gets by loadValue
+NumVariant getZero(ExprLoadKind load)
+{
+    switch (load)
+    {
+    case ExprLoadSignByte:
+        return NumVariant(static_cast<char>(0));
+
+    case ExprLoadByte:
+        return NumVariant(static_cast<unsigned char>(0));
+
+    case ExprLoadSignWord:
+        return NumVariant(static_cast<short>(0));
+
+    case ExprLoadWord:
+        return NumVariant(static_cast<unsigned short>(0));
+
+    case ExprLoadSignDWord:
+        return NumVariant(static_cast<long>(0));
+
+    case ExprLoadDWord:
+        return NumVariant(static_cast<unsigned long>(0));
+
+    case ExprLoadSignQWord:
+        return NumVariant(static_cast<long long>(0));
+
+    case ExprLoadQWord:
+        return NumVariant(static_cast<unsigned long long>(0));
+
+    case ExprLoadFloat:
+        return NumVariant(0.0f);
+
+    case ExprLoadDouble:
+        return NumVariant(0.0);
+
+    case ExprLoadBool:
+        return NumVariant(0);
+    }
+
+    throw ExprException(L"error syntax");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the bit count and the sign of the field values, a bool field is 0 or 1
+void getFieldRange(ExprLoadKind load, size_t& bits, bool& isSigned)
+{
+    isSigned = load == ExprLoadSignByte || load == ExprLoadSignWord || load == ExprLoadSignDWord || load == ExprLoadSignQWord;
+    bits = load == ExprLoadBool ? 1 : getLoadSize(load) * 8;
+}
+
+size_t getIntegerBits(const NumVariant& value)
+{
+    if (value.isChar() || value.isUChar())
+        return 8;
+
+    if (value.isShort() || value.isUShort())
+        return 16;
+
+    if (value.isLong() || value.isULong())
+        return sizeof(long) * 8;
+
+    if (value.isInt() || value.isUInt())
+        return sizeof(int) * 8;
+
+    return 64;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ExprOpcode getSwappedCompare(ExprOpcode compare)
+{
+    switch (compare)
+    {
+    case ExprOpLt:
+        return ExprOpGt;
+
+    case ExprOpLe:
+        return ExprOpGe;
+
+    case ExprOpGt:
+        return ExprOpLt;
+
+    case ExprOpGe:
+        return ExprOpLe;
+    }
+
+    return compare;
+}
+
+bool isCompare(ExprOpcode opcode)
+{
+    return opcode >= ExprOpEq && opcode <= ExprOpGe;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template<typename FieldT, typename ColumnT>
+void gatherColumn(const unsigned char* fields, size_t stride, size_t count, ColumnT* column)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        FieldT  value;
+        std::memcpy(&value, fields + i * stride, sizeof(value));
+        column[i] = static_cast<ColumnT>(value);
+    }
+}
+
+template<typename ColumnT>
+void gatherColumn(ExprLoadKind load, const unsigned char* fields, size_t stride, size_t count, ColumnT* column)
+{
+    switch (load)
+    {
+    case ExprLoadSignByte:
+        gatherColumn<char>(fields, stride, count, column);
+        break;
+
+    case ExprLoadByte:
+        gatherColumn<unsigned char>(fields, stride, count, column);
+        break;
+
+    case ExprLoadBool:
+        gatherColumn<unsigned char>(fields, stride, count, column);
+        for (size_t i = 0; i < count; ++i)
+            column[i] = column[i] != 0 ? 1 : 0;
+        break;
+
+    case ExprLoadSignWord:
+        gatherColumn<short>(fields, stride, count, column);
+        break;
+
+    case ExprLoadWord:
+        gatherColumn<unsigned short>(fields, stride, count, column);
+        break;
+
+    case ExprLoadSignDWord:
+        gatherColumn<long>(fields, stride, count, column);
+        break;
+
+    case ExprLoadDWord:
+        gatherColumn<unsigned long>(fields, stride, count, column);
+        break;
+
+    case ExprLoadSignQWord:
+        gatherColumn<long long>(fields, stride, count, column);
+        break;
+
+    case ExprLoadQWord:
+        gatherColumn<unsigned long long>(fields, stride, count, column);
+        break;
+
+    case ExprLoadFloat:
+        gatherColumn<float>(fields, stride, count, column);
+        break;
+
+    case ExprLoadDouble:
+        gatherColumn<double>(fields, stride, count, column);
+        break;
+
+    default:
+        throw ExprException(L"error syntax");
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the loops have no branches and no calls: the compiler vectorizes them
+
+template<typename T, typename CompareT>
+void compareColumn(const T* column, size_t count, T value, unsigned char* mask)
+{
+    CompareT  compare;
+
+    for (size_t i = 0; i < count; ++i)
+        mask[i] = compare(column[i], value) ? 1 : 0;
+}
+
+template<typename T>
+void compareColumn(ExprOpcode compare, const T* column, size_t count, T value, unsigned char* mask)
+{
+    switch (compare)
+    {
+    case ExprOpEq:
+        compareColumn<T, std::equal_to<T> >(column, count, value, mask);
+        break;
+
+    case ExprOpNe:
+        compareColumn<T, std::not_equal_to<T> >(column, count, value, mask);
+        break;
+
+    case ExprOpLt:
+        compareColumn<T, std::less<T> >(column, count, value, mask);
+        break;
+
+    case ExprOpLe:
+        compareColumn<T, std::less_equal<T> >(column, count, value, mask);
+        break;
+
+    case ExprOpGt:
+        compareColumn<T, std::greater<T> >(column, count, value, mask);
+        break;
+
+    case ExprOpGe:
+        compareColumn<T, std::greater_equal<T> >(column, count, value, mask);
+        break;
+
+    default:
+        throw ExprException(L"error syntax");
+    }
+}
+
+template<typename T>
+void evaluateColumn(const ExprFilterTerm& term, const unsigned char* fields, size_t stride, size_t count, T value, unsigned char* mask)
+{
+    std::vector<T>  column(count);
+
+    gatherColumn(term.load, fields, stride, count, &column[0]);
+    compareColumn(term.compare, &column[0], count, value, mask);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const size_t  FilterBatchSize = 1024;
+const size_t  FilterBatchBytes = 0x10000;
+
+size_t getBatchSize(size_t span)
+{
+    return std::max<size_t>(1, std::min(FilterBatchSize, FilterBatchBytes / std::max<size_t>(span, 1)));
+}
+
+bool evaluateElement(ExprProgram& program, const ExprElementScopePtr& scope, MEMOFFSET_64 address)
+{
+    scope->setElement(address);
+    return program.run(scope).getValue() != NumVariant(0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // end nameless namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ExprElementScope::setElement(MEMOFFSET_64 address)
+{
+    m_element = loadTypedVar(m_typeInfo, address);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TypedValue ExprElementScope::get(const std::wstring& varName) const
+{
+    TypedValue  value;
+    if (!find(varName, value))
+        throw DbgException("scope doesn't contain varibale");
+    return value;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool ExprElementScope::find(const std::wstring& varName, TypedValue& value) const
+{
+    if (isField(varName))
+    {
+        value = m_element->getElement(varName);
+        return true;
+    }
+
+    return m_scope->find(varName, value);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool ExprElementScope::isField(const std::wstring& name) const
+{
+    std::map<std::wstring, bool>::const_iterator  it = m_fields.find(name);
+    if (it != m_fields.end())
+        return it->second;
+
+    bool  found = false;
+
+    if (m_typeInfo->isUserDefined())
+    {
+        try {
+            m_typeInfo->getElement(name);
+            found = true;
+        }
+        catch (DbgException&)
+        {
+        }
+    }
+
+    m_fields.insert(std::make_pair(name, found));
+
+    return found;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ExprFilter::ExprFilter(const std::vector<ExprFilterTerm>& terms, const std::vector<ExprFilterInstruction>& code) :
+    m_terms(terms),
+    m_code(code),
+    m_begin(0),
+    m_end(0)
+{
+    for (size_t i = 0; i < m_terms.size(); ++i)
+    {
+        MEMOFFSET_32  end = m_terms[i].offset + static_cast<MEMOFFSET_32>(getLoadSize(m_terms[i].load));
+
+        m_begin = i == 0 ? m_terms[i].offset : std::min(m_begin, m_terms[i].offset);
+        m_end = std::max(m_end, end);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ExprFilter::evaluate(const unsigned char* rows, size_t stride, size_t count, MEMOFFSET_32 begin, std::vector<unsigned char>& mask) const
+{
+    mask.assign(count, 0);
+
+    if (count == 0)
+        return;
+
+    std::vector< std::vector<unsigned char> >  masks;
+
+    for (size_t i = 0; i < m_code.size(); ++i)
+    {
+        const ExprFilterInstruction  &instruction = m_code[i];
+
+        if (instruction.opcode == ExprFilterCompare)
+        {
+            masks.push_back(std::vector<unsigned char>(count));
+            evaluateTerm(m_terms[instruction.term], rows, stride, count, begin, &masks.back()[0]);
+            continue;
+        }
+
+        std::vector<unsigned char>  &top = instruction.opcode == ExprFilterNot ? masks.back() : masks[masks.size() - 2];
+
+        switch (instruction.opcode)
+        {
+        case ExprFilterAnd:
+            for (size_t j = 0; j < count; ++j)
+                top[j] &= masks.back()[j];
+            masks.pop_back();
+            break;
+
+        case ExprFilterOr:
+            for (size_t j = 0; j < count; ++j)
+                top[j] |= masks.back()[j];
+            masks.pop_back();
+            break;
+
+        case ExprFilterNot:
+            for (size_t j = 0; j < count; ++j)
+                top[j] ^= 1;
+            break;
+        }
+    }
+
+    mask.swap(masks.back());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ExprFilter::evaluateTerm(const ExprFilterTerm& term, const unsigned char* rows, size_t stride, size_t count, MEMOFFSET_32 begin, unsigned char* mask) const
+{
+    const unsigned char  *fields = rows + (term.offset - begin);
+
+    switch (term.domain)
+    {
+    case ExprFilterSigned:
+        evaluateColumn(term, fields, stride, count, term.signedValue, mask);
+        break;
+
+    case ExprFilterUnsigned:
+        evaluateColumn(term, fields, stride, count, term.unsignedValue, mask);
+        break;
+
+    case ExprFilterDouble:
+        evaluateColumn(term, fields, stride, count, term.doubleValue, mask);
+        break;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool ExprFilterBuilder::pushConst(const TypedValue& value)
+{
+    TypeInfoPtr  typeInfo = value.getType();
+
+    if (!typeInfo->isBase())
+        return false;
+
+    Item  item = { ItemConst, value.getValue(), 0, ExprLoadNone };
+    m_stack.push_back(item);
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool ExprFilterBuilder::pushField(const std::wstring& name)
+{
+    if (!m_typeInfo->isUserDefined())
+        return false;
+
+    TypeInfoPtr  fieldType;
+
+    try {
+        fieldType = m_typeInfo->getElement(name);
+    }
+    catch (DbgException&)
+    {
+        return false;
+    }
+
+    // the static, constant, virtual base and bit fields are not at a fixed offset
+    if (m_typeInfo->isStaticMember(name) || m_typeInfo->isVirtualMember(name) || fieldType->isConstant() || fieldType->isBitField())
+        return false;
+
+    ExprLoadKind  load = getLoadKind(fieldType);
+
+    if (load == ExprLoadNone || load == ExprLoadPtr32 || load == ExprLoadPtr64)
+        return false;
+
+    Item  item = { ItemField, NumVariant(), static_cast<MEMOFFSET_32>(m_typeInfo->getElementOffset(name)), load };
+    m_stack.push_back(item);
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool ExprFilterBuilder::applyUnary(ExprOpcode opcode)
+{
+    if (m_stack.empty())
+        return false;
+
+    Item  &item = m_stack.back();
+
+    const ExprFilterInstruction  notInstruction = { ExprFilterNot, 0 };
+
+    switch (opcode)
+    {
+    case ExprOpPlus:
+        return item.kind != ItemPredicate;
+
+    case ExprOpNeg:
+        if (item.kind != ItemConst)
+            return false;
+        item.value = -item.value;
+        return true;
+
+    case ExprOpBitNot:
+        if (item.kind != ItemConst || !item.value.isInteger())
+            return false;
+        item.value = ~item.value;
+        return true;
+
+    case ExprOpBoolNot:
+        if (!toPredicate(item))
+            return false;
+        item.code.push_back(notInstruction);
+        return true;
+    }
+
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool ExprFilterBuilder::applyBinary(ExprOpcode opcode)
+{
+    if (m_stack.size() < 2)
+        return false;
+
+    Item  operand2 = m_stack.back();
+    m_stack.pop_back();
+
+    Item  &operand1 = m_stack.back();
+
+    if (opcode == ExprOpAndJump || opcode == ExprOpOrJump)
+    {
+        if (!toPredicate(operand1) || !toPredicate(operand2))
+            return false;
+
+        operand1.code.insert(operand1.code.end(), operand2.code.begin(), operand2.code.end());
+
+        ExprFilterInstruction  instruction = { opcode == ExprOpAndJump ? ExprFilterAnd : ExprFilterOr, 0 };
+        operand1.code.push_back(instruction);
+
+        return true;
+    }
+
+    if (isCompare(opcode))
+    {
+        if (operand1.kind == ItemField && operand2.kind == ItemConst)
+            return addTerm(operand1, opcode, operand2.value, operand1);
+
+        if (operand1.kind == ItemConst && operand2.kind == ItemField)
+            return addTerm(operand2, getSwappedCompare(opcode), operand1.value, operand1);
+
+        return false;
+    }
+
+    // a constant subexpression is folded
+    if (operand1.kind != ItemConst || operand2.kind != ItemConst)
+        return false;
+
+    const NumVariant  &val1 = operand1.value;
+    const NumVariant  &val2 = operand2.value;
+
+    bool  isInteger = val1.isInteger() && val2.isInteger();
+
+    switch (opcode)
+    {
+    case ExprOpAdd:
+        operand1.value = val1 + val2;
+        return true;
+
+    case ExprOpSub:
+        operand1.value = val1 - val2;
+        return true;
+
+    case ExprOpMul:
+        operand1.value = val1 * val2;
+        return true;
+
+    case ExprOpDiv:
+        if (val2 == NumVariant(0))
+            return false;
+        operand1.value = val1 / val2;
+        return true;
+
+    case ExprOpMod:
+        if (!isInteger || val2 == NumVariant(0))
+            return false;
+        operand1.value = val1 % val2;
+        return true;
+
+    case ExprOpShl:
+        if (!isInteger)
+            return false;
+        operand1.value = val1 << val2;
+        return true;
+
+    case ExprOpShr:
+        if (!isInteger)
+            return false;
+        operand1.value = val1 >> val2;
+        return true;
+
+    case ExprOpBitAnd:
+        if (!isInteger)
+            return false;
+        operand1.value = val1 & val2;
+        return true;
+
+    case ExprOpBitOr:
+        if (!isInteger)
+            return false;
+        operand1.value = val1 | val2;
+        return true;
+
+    case ExprOpBitXor:
+        if (!isInteger)
+            return false;
+        operand1.value = val1 ^ val2;
+        return true;
+    }
+
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ExprFilterPtr ExprFilterBuilder::getFilter()
+{
+    if (m_stack.size() != 1 || !toPredicate(m_stack.back()))
+        return ExprFilterPtr();
+
+    return ExprFilterPtr(new ExprFilter(m_terms, m_stack.back().code));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool ExprFilterBuilder::addTerm(const Item& field, ExprOpcode compare, const NumVariant& value, Item& result)
+{
+    // the comparison type as NumVariant gets it for the field and the constant
+    NumVariant  converted = getZero(field.load) + value;
+
+    ExprFilterTerm  term = { field.offset, field.load, compare, ExprFilterSigned, 0, 0, 0.0 };
+
+    if (converted.isFloat())
+        return false;
+
+    if (converted.isDouble())
+    {
+        term.domain = ExprFilterDouble;
+        term.doubleValue = converted.asDouble();
+    }
+    else
+    {
+        size_t  fieldBits;
+        bool  fieldSigned;
+        getFieldRange(field.load, fieldBits, fieldSigned);
+
+        size_t  bits = getIntegerBits(converted);
+
+        // the field value must not be changed by the conversion to the comparison type
+        bool  preserved = converted.isSigned() ?
+            (fieldSigned ? bits >= fieldBits : bits > fieldBits) :
+            (!fieldSigned && bits >= fieldBits);
+
+        if (!preserved)
+            return false;
+
+        if (converted.isULongLong())
+        {
+            term.domain = ExprFilterUnsigned;
+            term.unsignedValue = converted.asULongLong();
+        }
+        else
+        {
+            term.signedValue = converted.asLongLong();
+        }
+    }
+
+    m_terms.push_back(term);
+
+    ExprFilterInstruction  instruction = { ExprFilterCompare, m_terms.size() - 1 };
+
+    result.kind = ItemPredicate;
+    result.code.assign(1, instruction);
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool ExprFilterBuilder::toPredicate(Item& item)
+{
+    if (item.kind == ItemPredicate)
+        return true;
+
+    if (item.kind != ItemField)
+        return false;
+
+    // a field alone is compared with zero
+    return addTerm(item, ExprOpNe, NumVariant(0), item);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::vector<MEMOFFSET_64> getListEntries(MEMOFFSET_64 offset, const TypeInfoPtr& typeInfo, const std::wstring& fieldName)
+{
+    offset = addr64(offset);
+
+    std::vector<MEMOFFSET_64>  entries;
+
+    MEMOFFSET_64  entryAddress = 0;
+    TypeInfoPtr  fieldTypeInfo = typeInfo->getElement(fieldName);
+    MEMOFFSET_REL  fieldOffset = typeInfo->getElementOffset(fieldName);
+    size_t  psize = fieldTypeInfo->getPtrSize();
+
+    if (fieldTypeInfo->getName() == (typeInfo->getName() + L"*"))
+    {
+        for (entryAddress = ptrPtr(offset, psize); addr64(entryAddress) != offset && entryAddress != NULL; entryAddress = ptrPtr(entryAddress + fieldOffset, psize))
+            entries.push_back(addr64(entryAddress));
+    }
+    else
+    {
+        for (entryAddress = ptrPtr(offset, psize); addr64(entryAddress) != offset && entryAddress != NULL; entryAddress = ptrPtr(entryAddress, psize))
+            entries.push_back(addr64(entryAddress) - fieldOffset);
+    }
+
+    return entries;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::vector<size_t> filterArray(ExprProgram& program, const ExprFilterPtr& filter,
+    MEMOFFSET_64 offset, const TypeInfoPtr& typeInfo, size_t count, const ScopePtr& scope)
+{
+    if (!typeInfo)
+        throw DbgException("type info is null");
+
+    offset = addr64(offset);
+
+    ExprElementScopePtr  elementScope(new ExprElementScope(typeInfo, scope));
+
+    const size_t  elementSize = typeInfo->getSize();
+    const size_t  batchSize = getBatchSize(elementSize);
+
+    std::vector<size_t>  result;
+    std::vector<unsigned char>  buffer;
+    std::vector<unsigned char>  mask;
+
+    for (size_t first = 0; first < count; first += batchSize)
+    {
+        const size_t  batch = std::min(batchSize, count - first);
+        const MEMOFFSET_64  batchOffset = offset + first * elementSize;
+
+        bool  filtered = false;
+
+        // only the bytes from the first read field to the last one
+        if (filter && elementSize != 0)
+        {
+            buffer.resize((batch - 1) * elementSize + filter->getEnd() - filter->getBegin());
+
+            if (readMemoryUnsafe(batchOffset + filter->getBegin(), &buffer[0], buffer.size()))
+            {
+                filter->evaluate(&buffer[0], elementSize, batch, filter->getBegin(), mask);
+                filtered = true;
+            }
+        }
+
+        // an unreadable batch throws as the element does
+        if (!filtered)
+        {
+            mask.resize(batch);
+            for (size_t i = 0; i < batch; ++i)
+                mask[i] = evaluateElement(program, elementScope, batchOffset + i * elementSize) ? 1 : 0;
+        }
+
+        for (size_t i = 0; i < batch; ++i)
+        {
+            if (mask[i])
+                result.push_back(first + i);
+        }
+    }
+
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::vector<MEMOFFSET_64> filterList(ExprProgram& program, const ExprFilterPtr& filter,
+    MEMOFFSET_64 offset, const TypeInfoPtr& typeInfo, const std::wstring& fieldName, const ScopePtr& scope)
+{
+    if (!typeInfo)
+        throw DbgException("type info is null");
+
+    const std::vector<MEMOFFSET_64>  entries = getListEntries(offset, typeInfo, fieldName);
+
+    ExprElementScopePtr  elementScope(new ExprElementScope(typeInfo, scope));
+
+    const size_t  span = filter ? filter->getEnd() - filter->getBegin() : 0;
+    const size_t  batchSize = filter ? getBatchSize(span) : FilterBatchSize;
+
+    std::vector<MEMOFFSET_64>  result;
+    std::vector<unsigned char>  buffer;
+    std::vector<unsigned char>  unread;
+    std::vector<unsigned char>  mask;
+
+    for (size_t first = 0; first < entries.size(); first += batchSize)
+    {
+        const size_t  batch = std::min(batchSize, entries.size() - first);
+
+        unread.assign(batch, 1);
+
+        // the elements are not adjacent: each row gets only the read fields of the element
+        if (filter)
+        {
+            buffer.assign(batch * span, 0);
+
+            for (size_t i = 0; i < batch; ++i)
+                unread[i] = readMemoryUnsafe(entries[first + i] + filter->getBegin(), &buffer[i * span], span) ? 0 : 1;
+
+            filter->evaluate(&buffer[0], span, batch, filter->getBegin(), mask);
+        }
+        else
+        {
+            mask.resize(batch);
+        }
+
+        for (size_t i = 0; i < batch; ++i)
+        {
+            if (unread[i])
+                mask[i] = evaluateElement(program, elementScope, entries[first + i]) ? 1 : 0;
+
+            if (mask[i])
+                result.push_back(entries[first + i]);
+        }
+    }
+
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
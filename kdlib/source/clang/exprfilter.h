@@ -0,0 +1,182 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "kdlib/typedvar.h"
+
+#include "exprvm.h"
+
+namespace kdlib {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The names of a predicate evaluated over a collection: the fields of the
+// current element, then the names of the outer scope
+
+class ExprElementScope : public Scope
+{
+public:
+
+    ExprElementScope(const TypeInfoPtr& typeInfo, const ScopePtr& scope) :
+        m_typeInfo(typeInfo),
+        m_scope(scope)
+    {}
+
+    void setElement(MEMOFFSET_64 address);
+
+    TypedValue get(const std::wstring& varName) const override;
+
+    bool find(const std::wstring& varName, TypedValue& value) const override;
+
+private:
+
+    bool isField(const std::wstring& name) const;
+
+    TypeInfoPtr  m_typeInfo;
+    ScopePtr  m_scope;
+    TypedVarPtr  m_element;
+
+    mutable std::map<std::wstring, bool>  m_fields;
+};
+
+typedef boost::shared_ptr<ExprElementScope>  ExprElementScopePtr;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// A predicate made of comparisons of the element fields with constants joined
+// by &&, || and !. It is evaluated over the raw memory of a batch of elements:
+// each field is gathered into a column and compared by a branchless loop.
+
+enum ExprFilterDomain
+{
+    ExprFilterSigned,       // the field and the constant are compared as long long
+    ExprFilterUnsigned,     // as unsigned long long
+    ExprFilterDouble        // as double
+};
+
+struct ExprFilterTerm {
+    MEMOFFSET_32  offset;   // the field offset in the element
+    ExprLoadKind  load;
+    ExprOpcode  compare;    // ExprOpEq ... ExprOpGe, the field is on the left
+    ExprFilterDomain  domain;
+    long long  signedValue;
+    unsigned long long  unsignedValue;
+    double  doubleValue;
+};
+
+enum ExprFilterOpcode
+{
+    ExprFilterCompare,      // push the mask of the term
+    ExprFilterAnd,          // pop the second mask, combine with the top
+    ExprFilterOr,
+    ExprFilterNot           // invert the top mask
+};
+
+struct ExprFilterInstruction {
+    ExprFilterOpcode  opcode;
+    size_t  term;
+};
+
+class ExprFilter
+{
+public:
+
+    ExprFilter(const std::vector<ExprFilterTerm>& terms, const std::vector<ExprFilterInstruction>& code);
+
+    // the element bytes the predicate reads
+    MEMOFFSET_32 getBegin() const {
+        return m_begin;
+    }
+
+    MEMOFFSET_32 getEnd() const {
+        return m_end;
+    }
+
+    // the rows start at the element offset "begin", the mask gets 1 for a matching row
+    void evaluate(const unsigned char* rows, size_t stride, size_t count, MEMOFFSET_32 begin, std::vector<unsigned char>& mask) const;
+
+private:
+
+    void evaluateTerm(const ExprFilterTerm& term, const unsigned char* rows, size_t stride, size_t count, MEMOFFSET_32 begin, unsigned char* mask) const;
+
+    std::vector<ExprFilterTerm>  m_terms;
+    std::vector<ExprFilterInstruction>  m_code;
+
+    MEMOFFSET_32  m_begin;
+    MEMOFFSET_32  m_end;
+};
+
+typedef boost::shared_ptr<ExprFilter>  ExprFilterPtr;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Lowers the nodes of a predicate to a filter for the element type. A node
+// pushes its value, an operation pops the operands and pushes the result.
+// Any step returns false if the predicate is not a simple comparison, then
+// the predicate is evaluated element by element.
+
+class ExprFilterBuilder
+{
+public:
+
+    explicit ExprFilterBuilder(const TypeInfoPtr& typeInfo) :
+        m_typeInfo(typeInfo)
+    {}
+
+    bool pushConst(const TypedValue& value);
+    bool pushField(const std::wstring& name);
+
+    bool applyUnary(ExprOpcode opcode);
+    bool applyBinary(ExprOpcode opcode);
+
+    // null if the top is not a predicate
+    ExprFilterPtr getFilter();
+
+private:
+
+    enum ItemKind {
+        ItemConst,
+        ItemField,
+        ItemPredicate
+    };
+
+    struct Item {
+        ItemKind  kind;
+        NumVariant  value;
+        MEMOFFSET_32  offset;
+        ExprLoadKind  load;
+        std::vector<ExprFilterInstruction>  code;
+    };
+
+    // the result can be the field item
+    bool addTerm(const Item& field, ExprOpcode compare, const NumVariant& value, Item& result);
+
+    bool toPredicate(Item& item);
+
+    TypeInfoPtr  m_typeInfo;
+
+    std::vector<Item>  m_stack;
+    std::vector<ExprFilterTerm>  m_terms;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the element addresses of a list as loadTypedVarList walks it
+std::vector<MEMOFFSET_64> getListEntries(MEMOFFSET_64 offset, const TypeInfoPtr& typeInfo, const std::wstring& fieldName);
+
+// The elements are read by batches and evaluated by the filter. Without the
+// filter or if a batch is not readable the program is run for each element.
+
+std::vector<size_t> filterArray(ExprProgram& program, const ExprFilterPtr& filter,
+    MEMOFFSET_64 offset, const TypeInfoPtr& typeInfo, size_t count, const ScopePtr& scope);
+
+std::vector<MEMOFFSET_64> filterList(ExprProgram& program, const ExprFilterPtr& filter,
+    MEMOFFSET_64 offset, const TypeInfoPtr& typeInfo, const std::wstring& fieldName, const ScopePtr& scope);
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
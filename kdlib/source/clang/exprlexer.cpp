@@ -0,0 +1,554 @@
+#include "stdafx.h"
+
+#pragma warning( disable : 4141 4244 4291 4624 4800 4996 4267)
+
+#include <boost/thread/tss.hpp>
+
+#include "clang/Basic/IdentifierTable.h"
+#include "clang/Basic/LangOptions.h"
+#include "clang/Basic/MemoryBufferCache.h"
+#include "clang/Basic/TargetOptions.h"
+#include "clang/Basic/TargetInfo.h"
+#include "clang/Basic/TokenKinds.h"
+
+#include "clang/Lex/Lexer.h"
+#include "clang/Lex/Preprocessor.h"
+#include "clang/Lex/PreprocessorOptions.h"
+#include "clang/Lex/HeaderSearch.h"
+#include "clang/Lex/HeaderSearchOptions.h"
+
+#include "clang/Frontend/CompilerInstance.h"
+
+#include "kdlib/typedvar.h"
+
+#include "evalexpr.h"
+#include "exprlexer.h"
+#include "exprtokens.h"
+
+namespace kdlib {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+inline bool isIdentifierHead(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+inline bool isIdentifierBody(char c)
+{
+    return isIdentifierHead(c) || isDigit(c);
+}
+
+// the characters clang can take as a part of an identifier or a number: a
+// dollar sign, an universal character name or an UTF-8 sequence
+inline bool isExtendedChar(char c)
+{
+    return c == '$' || c == '\\' || static_cast<unsigned char>(c) >= 0x80;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The expressions have no macros and no includes: a raw lexer over the text
+// with the identifier table looking up the keywords gives the same tokens
+// as the preprocessor did.
+//
+// The built-in lexer knows identifiers, numbers, character constants and
+// punctuators. Whatever it does not know (strings, comments, extended
+// characters, ...) is left to the clang lexer for the whole expression.
+
+class ExprLexerContext
+{
+public:
+
+    ExprLexerContext() :
+        m_identifiers(m_langOptions)
+        {}
+
+    bool lexBuiltin(const std::string& expr, std::list<clang::Token>& tokens);
+
+    void lexClang(const std::string& expr, std::list<clang::Token>& tokens);
+
+private:
+
+    bool lexNumber(const char* &ptr, const char* end, clang::Token& token);
+
+    bool lexCharConstant(const char* &ptr, const char* end, clang::Token& token);
+
+    bool lexPunctuator(const char* &ptr, const char* end, bool lineStart, clang::Token& token);
+
+    void setIdentifier(const char* start, size_t length, clang::Token& token)
+    {
+        clang::IdentifierInfo  &identifierInfo = m_identifiers.get(llvm::StringRef(start, length));
+
+        token.setIdentifierInfo(&identifierInfo);
+        token.setKind(identifierInfo.getTokenID());
+        token.setLength(static_cast<unsigned>(length));
+    }
+
+    clang::LangOptions  m_langOptions;
+
+    clang::IdentifierTable  m_identifiers;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool ExprLexerContext::lexBuiltin(const std::string& expr, std::list<clang::Token>& tokens)
+{
+    const char  *ptr = expr.c_str();
+    const char  *end = ptr + expr.size();
+
+    while (true)
+    {
+        while (ptr < end && isSpace(*ptr))
+            ++ptr;
+
+        clang::Token  token;
+        token.startToken();
+
+        if (ptr == end)
+        {
+            token.setKind(clang::tok::eof);
+            token.setLength(0);
+            tokens.push_back(token);
+            return true;
+        }
+
+        const char  *start = ptr;
+
+        if (*ptr == 'L' && end - ptr > 1 && ptr[1] == '\'')
+        {
+            if (!lexCharConstant(++ptr, end, token))
+                return false;
+
+            token.setKind(clang::tok::wide_char_constant);
+            token.setLiteralData(start);
+        }
+        else if (isIdentifierHead(*ptr))
+        {
+            while (ptr < end && isIdentifierBody(*ptr))
+                ++ptr;
+
+            if (ptr < end && isExtendedChar(*ptr))
+                return false;
+
+            setIdentifier(start, ptr - start, token);
+        }
+        else if (isDigit(*ptr) || (*ptr == '.' && end - ptr > 1 && isDigit(ptr[1])))
+        {
+            if (!lexNumber(ptr, end, token))
+                return false;
+        }
+        else if (*ptr == '\'')
+        {
+            if (!lexCharConstant(ptr, end, token))
+                return false;
+
+            token.setKind(clang::tok::char_constant);
+            token.setLiteralData(start);
+        }
+        else
+        {
+            bool  lineStart = start == expr.c_str() || start[-1] == '\n' || start[-1] == '\r';
+
+            if (!lexPunctuator(ptr, end, lineStart, token))
+                return false;
+        }
+
+        token.setLength(static_cast<unsigned>(ptr - start));
+
+        tokens.push_back(token);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool ExprLexerContext::lexNumber(const char* &ptr, const char* end, clang::Token& token)
+{
+    const char  *start = ptr;
+
+    for (++ptr; ptr < end; ++ptr)
+    {
+        if (isIdentifierBody(*ptr) || *ptr == '.')
+            continue;
+
+        if ((*ptr == '+' || *ptr == '-') && (ptr[-1] == 'e' || ptr[-1] == 'E'))
+            continue;
+
+        // clang takes a hexadecimal float only if it looks like one
+        if ((*ptr == '+' || *ptr == '-') && (ptr[-1] == 'p' || ptr[-1] == 'P'))
+            return false;
+
+        if (isExtendedChar(*ptr))
+            return false;
+
+        break;
+    }
+
+    token.setKind(clang::tok::numeric_constant);
+    token.setLiteralData(start);
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool ExprLexerContext::lexCharConstant(const char* &ptr, const char* end, clang::Token& token)
+{
+    const char  *start = ptr++;
+
+    for (; ptr < end; ++ptr)
+    {
+        if (*ptr == '\n' || *ptr == '\r' || *ptr == '\0')
+            return false;
+
+        if (*ptr == '\\')
+        {
+            if (++ptr == end)
+                return false;
+            continue;
+        }
+
+        if (*ptr == '\'')
+            break;
+    }
+
+    // an unterminated or an empty constant is an error for clang
+    if (ptr == end || ptr - start == 1)
+        return false;
+
+    ++ptr;
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool ExprLexerContext::lexPunctuator(const char* &ptr, const char* end, bool lineStart, clang::Token& token)
+{
+    const char  c = *ptr++;
+    const char  next = ptr < end ? *ptr : '\0';
+    const char  afterNext = end - ptr > 1 ? ptr[1] : '\0';
+
+    clang::tok::TokenKind  kind = clang::tok::unknown;
+
+    switch (c)
+    {
+    case '(': kind = clang::tok::l_paren; break;
+    case ')': kind = clang::tok::r_paren; break;
+    case '[': kind = clang::tok::l_square; break;
+    case ']': kind = clang::tok::r_square; break;
+    case '{': kind = clang::tok::l_brace; break;
+    case '}': kind = clang::tok::r_brace; break;
+    case '~': kind = clang::tok::tilde; break;
+    case '?': kind = clang::tok::question; break;
+    case ':': kind = clang::tok::colon; break;
+    case ';': kind = clang::tok::semi; break;
+    case ',': kind = clang::tok::comma; break;
+
+    case '.':
+        if (next == '.' && afterNext == '.')
+        {
+            ptr += 2;
+            kind = clang::tok::ellipsis;
+        }
+        else
+        {
+            kind = clang::tok::period;
+        }
+        break;
+
+    case '+':
+        if (next == '+') { ++ptr; kind = clang::tok::plusplus; }
+        else if (next == '=') { ++ptr; kind = clang::tok::plusequal; }
+        else kind = clang::tok::plus;
+        break;
+
+    case '-':
+        if (next == '-') { ++ptr; kind = clang::tok::minusminus; }
+        else if (next == '>') { ++ptr; kind = clang::tok::arrow; }
+        else if (next == '=') { ++ptr; kind = clang::tok::minusequal; }
+        else kind = clang::tok::minus;
+        break;
+
+    case '*':
+        if (next == '=') { ++ptr; kind = clang::tok::starequal; }
+        else kind = clang::tok::star;
+        break;
+
+    case '/':
+        // comments are left to clang
+        if (next == '/' || next == '*')
+            return false;
+        if (next == '=') { ++ptr; kind = clang::tok::slashequal; }
+        else kind = clang::tok::slash;
+        break;
+
+    case '%':
+        if (next == '=') { ++ptr; kind = clang::tok::percentequal; }
+        else kind = clang::tok::percent;
+        break;
+
+    case '&':
+        if (next == '&') { ++ptr; kind = clang::tok::ampamp; }
+        else if (next == '=') { ++ptr; kind = clang::tok::ampequal; }
+        else kind = clang::tok::amp;
+        break;
+
+    case '|':
+        if (next == '|') { ++ptr; kind = clang::tok::pipepipe; }
+        else if (next == '=') { ++ptr; kind = clang::tok::pipeequal; }
+        else kind = clang::tok::pipe;
+        break;
+
+    case '^':
+        if (next == '=') { ++ptr; kind = clang::tok::caretequal; }
+        else kind = clang::tok::caret;
+        break;
+
+    case '!':
+        if (next == '=') { ++ptr; kind = clang::tok::exclaimequal; }
+        else kind = clang::tok::exclaim;
+        break;
+
+    case '=':
+        if (next == '=') { ++ptr; kind = clang::tok::equalequal; }
+        else kind = clang::tok::equal;
+        break;
+
+    case '<':
+        // a run of them at a line start can be a conflict marker for clang
+        if (lineStart && next == '<' && afterNext == '<')
+            return false;
+        if (next == '<' && afterNext == '=') { ptr += 2; kind = clang::tok::lesslessequal; }
+        else if (next == '<') { ++ptr; kind = clang::tok::lessless; }
+        else if (next == '=') { ++ptr; kind = clang::tok::lessequal; }
+        else kind = clang::tok::less;
+        break;
+
+    case '>':
+        if (lineStart && next == '>' && afterNext == '>')
+            return false;
+        if (next == '>' && afterNext == '=') { ptr += 2; kind = clang::tok::greatergreaterequal; }
+        else if (next == '>') { ++ptr; kind = clang::tok::greatergreater; }
+        else if (next == '=') { ++ptr; kind = clang::tok::greaterequal; }
+        else kind = clang::tok::greater;
+        break;
+
+    default:
+        return false;
+    }
+
+    token.setKind(kind);
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ExprLexerContext::lexClang(const std::string& expr, std::list<clang::Token>& tokens)
+{
+    const char  *bufferStart = expr.c_str();
+
+    clang::Lexer  lexer(clang::SourceLocation(), m_langOptions, bufferStart, bufferStart, bufferStart + expr.size());
+
+    clang::Token  token;
+
+    do {
+
+        lexer.LexFromRawLexer(token);
+
+        if (token.is(clang::tok::raw_identifier))
+        {
+            if (token.needsCleaning())
+                throw ExprException(L"error syntax");
+
+            clang::IdentifierInfo  &identifierInfo = m_identifiers.get(token.getRawIdentifier());
+
+            token.setIdentifierInfo(&identifierInfo);
+            token.setKind(identifierInfo.getTokenID());
+        }
+
+        tokens.push_back(token);
+
+    } while (!token.is(clang::tok::eof));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+boost::thread_specific_ptr<ExprLexerContext>  lexerContext;
+
+ExprLexerContext& getLexerContext()
+{
+    if (!lexerContext.get())
+        lexerContext.reset(new ExprLexerContext());
+
+    return *lexerContext;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::string getTokenText(const clang::Token& token)
+{
+    if (token.is(clang::tok::eof))
+        return std::string();
+
+    if (token.getIdentifierInfo())
+        return token.getIdentifierInfo()->getName();
+
+    if (token.isLiteral())
+        return std::string(token.getLiteralData(), token.getLength());
+
+    const char  *spelling = clang::tok::getPunctuatorSpelling(token.getKind());
+
+    return spelling ? spelling : std::string();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Lexes the expression as evalExpr did before the lexers above: by the
+// preprocessor over an in-memory file. The tokens refer to the preprocessor
+// data, so they are converted here
+
+ExprTokenList getPreprocessorTokens(const std::string& expr)
+{
+    auto  preprocessorOptions = std::make_shared<clang::PreprocessorOptions>();
+
+    llvm::IntrusiveRefCntPtr<clang::DiagnosticIDs> diagnosticIDs(new clang::DiagnosticIDs());
+
+    auto diagnosticOptions = new clang::DiagnosticOptions();
+
+    auto diagnosticConsumer = new clang::IgnoringDiagConsumer();
+
+    clang::DiagnosticsEngine  diagnosticEngine(diagnosticIDs, diagnosticOptions, diagnosticConsumer);
+
+    clang::LangOptions  langOptions;
+
+    llvm::IntrusiveRefCntPtr<clang::vfs::InMemoryFileSystem>  memoryFileSystem(new clang::vfs::InMemoryFileSystem());
+
+    memoryFileSystem->addFile("<input>", 0, llvm::MemoryBuffer::getMemBuffer(expr));
+
+    clang::FileSystemOptions  fileSystemOptions;
+    clang::FileManager  fileManager(fileSystemOptions, memoryFileSystem);
+    clang::SourceManager  sourceManager(diagnosticEngine, fileManager);
+
+    const clang::FileEntry *pFile = fileManager.getFile("<input>");
+    clang::FileID  fileID = sourceManager.getOrCreateFileID(pFile, clang::SrcMgr::C_User);
+    sourceManager.setMainFileID(fileID);
+
+    clang::MemoryBufferCache  memoryBufferCache;
+
+    auto headerSearchOptions = std::make_shared<clang::HeaderSearchOptions>();
+    auto targetOptions = std::make_shared<clang::TargetOptions>();
+    targetOptions->Triple = llvm::sys::getDefaultTargetTriple();
+    clang::TargetInfo*  targetInfo = clang::TargetInfo::CreateTargetInfo(diagnosticEngine, targetOptions);
+    clang::HeaderSearch  headerSearch(headerSearchOptions, sourceManager, diagnosticEngine, langOptions, targetInfo);
+
+    clang::CompilerInstance  compilerInstance;
+
+    clang::Preprocessor   preprocessor(
+        preprocessorOptions,
+        diagnosticEngine,
+        langOptions,
+        sourceManager,
+        memoryBufferCache,
+        headerSearch,
+        compilerInstance
+    );
+    preprocessor.Initialize(*targetInfo);
+
+    preprocessor.EnterMainSourceFile();
+    diagnosticConsumer->BeginSourceFile(langOptions, &preprocessor);
+
+    clang::Token token;
+
+    ExprTokenList  tokenList;
+
+    do {
+
+        preprocessor.Lex(token);
+
+        if (diagnosticEngine.hasErrorOccurred())
+        {
+            NOT_IMPLEMENTED();
+        }
+
+        tokenList.push_back(std::make_pair(std::string(clang::tok::getTokenName(token.getKind())), getTokenText(token)));
+
+    } while (!token.is(clang::tok::eof));
+
+    diagnosticConsumer->EndSourceFile();
+
+    return tokenList;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // end nameless namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+void lexExpr( const std::string& expr, std::list<clang::Token>& tokens )
+{
+    ExprLexerContext  &lexerContext = getLexerContext();
+
+    if (lexerContext.lexBuiltin(expr, tokens))
+        return;
+
+    tokens.clear();
+
+    lexerContext.lexClang(expr, tokens);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ExprTokenList getExprTokens( const std::string& expr, ExprLexerKind lexerKind )
+{
+    ExprLexerContext  &lexerContext = getLexerContext();
+
+    std::list<clang::Token>  tokens;
+
+    switch (lexerKind)
+    {
+    case ExprLexerDefault:
+        lexExpr(expr, tokens);
+        break;
+
+    case ExprLexerBuiltin:
+        if (!lexerContext.lexBuiltin(expr, tokens))
+            throw TypeException(L"the built-in lexer does not support the expression");
+        break;
+
+    case ExprLexerClang:
+        lexerContext.lexClang(expr, tokens);
+        break;
+
+    case ExprLexerPreprocessor:
+        return getPreprocessorTokens(expr);
+
+    default:
+        throw TypeException(L"unknown expression lexer");
+    }
+
+    ExprTokenList  tokenList;
+
+    for (auto& token : tokens)
+        tokenList.push_back(std::make_pair(std::string(clang::tok::getTokenName(token.getKind())), getTokenText(token)));
+
+    return tokenList;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
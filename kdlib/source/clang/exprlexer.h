@@ -0,0 +1,23 @@
+#pragma once
+
+#include <list>
+#include <string>
+
+#include "clang/Lex/Token.h"
+
+namespace kdlib {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Splits an expression into tokens ended by the eof token. A built-in lexer
+// handles the usual expressions, the clang lexer is the fallback for the rest.
+// Each thread keeps its own lexer context, so no preprocessor is built for a
+// call. Identifier tokens refer to the identifier table of the calling thread
+// and literal tokens refer to the expression text: the tokens must be used by
+// the same thread while the text is alive.
+
+void lexExpr( const std::string& expr, std::list<clang::Token>& tokens );
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
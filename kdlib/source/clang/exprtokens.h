@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace kdlib {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The tokens of an expression as the evaluator gets them: the clang token kind
+// name and the token text, ended by the "eof" token. Used by the tests to
+// check the lexers against each other and against the clang preprocessor the
+// evaluator used before them.
+
+enum ExprLexerKind {
+    ExprLexerDefault,       // the built-in lexer, clang for the unsupported expressions
+    ExprLexerBuiltin,       // throws TypeException for the unsupported expressions
+    ExprLexerClang,
+    ExprLexerPreprocessor   // the reference: throws on a lexer error
+};
+
+typedef std::vector< std::pair<std::string, std::string> >  ExprTokenList;
+
+ExprTokenList getExprTokens(const std::string& expr, ExprLexerKind lexerKind = ExprLexerDefault);
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
@@ -0,0 +1,699 @@
+#include "stdafx.h"
+
+#pragma warning( disable : 4141 4244 4291 4624 4800 4996 4267)
+
+#include "kdlib/typedvar.h"
+#include "kdlib/memaccess.h"
+#include "kdlib/exceptions.h"
+
+#include "evalexpr.h"
+#include "exprvm.h"
+
+namespace kdlib {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the same reading as TypedVarBase::getValue and TypedVarPointer::getValue do
+
+ExprLoadKind getLoadKind(const TypeInfoPtr& typeInfo)
+{
+    if (typeInfo->isBitField())
+        return ExprLoadNone;
+
+    if (typeInfo->isPointer())
+        return typeInfo->getSize() == 4 ? ExprLoadPtr32 : ExprLoadPtr64;
+
+    if (!typeInfo->isBase())
+        return ExprLoadNone;
+
+    const std::wstring  name = typeInfo->getName();
+
+    if (name == L"Char" || name == L"Int1B")
+        return ExprLoadSignByte;
+
+    if (name == L"UInt1B")
+        return ExprLoadByte;
+
+    if (name == L"WChar" || name == L"Int2B")
+        return ExprLoadSignWord;
+
+    if (name == L"UInt2B")
+        return ExprLoadWord;
+
+    if (name == L"Long" || name == L"Int4B")
+        return ExprLoadSignDWord;
+
+    if (name == L"ULong" || name == L"UInt4B" || name == L"Hresult")
+        return ExprLoadDWord;
+
+    if (name == L"Int8B")
+        return ExprLoadSignQWord;
+
+    if (name == L"UInt8B")
+        return ExprLoadQWord;
+
+    if (name == L"Float")
+        return ExprLoadFloat;
+
+    if (name == L"Double")
+        return ExprLoadDouble;
+
+    if (name == L"Bool")
+        return ExprLoadBool;
+
+    return ExprLoadNone;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+
+NumVariant loadValue(MEMOFFSET_64 address, ExprLoadKind load)
+{
+    switch (load)
+    {
+    case ExprLoadSignByte:
+        return NumVariant(ptrSignByte(address));
+
+    case ExprLoadByte:
+        return NumVariant(ptrByte(address));
+
+    case ExprLoadSignWord:
+        return NumVariant(ptrSignWord(address));
+
+    case ExprLoadWord:
+        return NumVariant(ptrWord(address));
+
+    case ExprLoadSignDWord:
+        return NumVariant(ptrSignDWord(address));
+
+    case ExprLoadDWord:
+        return NumVariant(ptrDWord(address));
+
+    case ExprLoadSignQWord:
+        return NumVariant(ptrSignQWord(address));
+
+    case ExprLoadQWord:
+        return NumVariant(ptrQWord(address));
+
+    case ExprLoadFloat:
+        return NumVariant(ptrSingleFloat(address));
+
+    case ExprLoadDouble:
+        return NumVariant(ptrDoubleFloat(address));
+
+    case ExprLoadBool:
+        return NumVariant(0 != ptrByte(address));
+
+    case ExprLoadPtr32:
+        return NumVariant(addr64(ptrDWord(address)));
+
+    case ExprLoadPtr64:
+        return NumVariant(addr64(ptrQWord(address)));
+    }
+
+    throw ExprException(L"error syntax");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void setNum(ExprValue& value, const NumVariant& num)
+{
+    value.kind = ExprValueNum;
+    value.num = num;
+    value.type.reset();
+    value.var.reset();
+}
+
+void setBool(ExprValue& value, bool result)
+{
+    value.kind = ExprValueBool;
+    value.num = NumVariant(result ? 1 : 0);
+    value.type.reset();
+    value.var.reset();
+}
+
+void setMemory(ExprValue& value, MEMOFFSET_64 address, const TypeInfoPtr& typeInfo, ExprLoadKind load)
+{
+    value.kind = ExprValueMemory;
+    value.address = address;
+    value.load = load;
+    value.type = typeInfo;
+    value.var.reset();
+}
+
+void setVar(ExprValue& value, const TypedVarPtr& var)
+{
+    value.kind = ExprValueVar;
+    value.type.reset();
+    value.var = var;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TypedValue box(const ExprValue& value)
+{
+    switch (value.kind)
+    {
+    case ExprValueNum:
+        return value.var ? TypedValue(value.var) : TypedValue(value.num);
+
+    case ExprValueBool:
+        return TypedValue(value.num.asInt() != 0);
+
+    case ExprValueMemory:
+        return loadTypedVar(value.type, value.address);
+    }
+
+    return value.var;
+}
+
+// base type values only: pointers, arrays and UDTs go to the operations
+bool isNumeric(const ExprValue& value)
+{
+    switch (value.kind)
+    {
+    case ExprValueNum:
+    case ExprValueBool:
+        return true;
+
+    case ExprValueMemory:
+        return value.load != ExprLoadNone && value.load != ExprLoadPtr32 && value.load != ExprLoadPtr64;
+    }
+
+    return value.var->getType()->isBase();
+}
+
+// throws as TypedValue::getValue does for a value without a scalar
+NumVariant getNum(const ExprValue& value)
+{
+    switch (value.kind)
+    {
+    case ExprValueNum:
+    case ExprValueBool:
+        return value.num;
+
+    case ExprValueMemory:
+        if (value.load != ExprLoadNone)
+            return loadValue(value.address, value.load);
+        return box(value).getValue();
+    }
+
+    return value.var->getValue();
+}
+
+// the address of the accessed object: the value or the pointed memory
+bool getObjectAddress(const ExprValue& value, bool viaPointer, MEMOFFSET_64& address)
+{
+    if (viaPointer)
+    {
+        address = getNum(value).asULongLong();
+        return true;
+    }
+
+    if (value.kind == ExprValueMemory)
+    {
+        address = value.address;
+        return true;
+    }
+
+    if (value.var->getStorage() == MemoryVar)
+    {
+        address = value.var->getAddress();
+        return true;
+    }
+
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+NumVariant getArithmeticResult(ExprOpcode opcode, const NumVariant& val1, const NumVariant& val2)
+{
+    switch (opcode)
+    {
+    case ExprOpAdd:
+        return val1 + val2;
+
+    case ExprOpSub:
+        return val1 - val2;
+
+    case ExprOpMul:
+        return val1 * val2;
+
+    case ExprOpDiv:
+        if (val2 == 0)
+            throw DbgException("expression division error");
+        return val1 / val2;
+
+    case ExprOpMod:
+        return val1 % val2;
+
+    case ExprOpShl:
+        return val1 << val2;
+
+    case ExprOpShr:
+        return val1 >> val2;
+
+    case ExprOpBitAnd:
+        return val1 & val2;
+
+    case ExprOpBitOr:
+        return val1 | val2;
+
+    case ExprOpBitXor:
+        return val1 ^ val2;
+    }
+
+    throw ExprException(L"error syntax");
+}
+
+bool getCompareResult(ExprOpcode opcode, const NumVariant& val1, const NumVariant& val2)
+{
+    switch (opcode)
+    {
+    case ExprOpEq:
+        return val1 == val2;
+
+    case ExprOpNe:
+        return val1 != val2;
+
+    case ExprOpLt:
+        return val1 < val2;
+
+    case ExprOpLe:
+        return val1 <= val2;
+
+    case ExprOpGt:
+        return val1 > val2;
+
+    case ExprOpGe:
+        return val1 >= val2;
+    }
+
+    throw ExprException(L"error syntax");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ExprAccessInfo getFieldInfo(const TypeInfoPtr& key, const std::wstring& fieldName)
+{
+    ExprAccessInfo  info = { false, false, 0, TypeInfoPtr(), ExprLoadNone };
+
+    TypeInfoPtr  udtType = key;
+
+    // a field of a pointer is a field of the pointed UDT
+    if (key->isPointer())
+    {
+        udtType = key->deref();
+        info.viaPointer = true;
+    }
+
+    if (!udtType->isUserDefined())
+        return info;
+
+    TypeInfoPtr  fieldType = udtType->getElement(fieldName);
+
+    // the static, constant, virtual base and bit fields are read by the variable
+    if (udtType->isStaticMember(fieldName) || udtType->isVirtualMember(fieldName) || fieldType->isConstant() || fieldType->isBitField())
+        return info;
+
+    info.direct = true;
+    info.offset = udtType->getElementOffset(fieldName);
+    info.type = fieldType;
+    info.load = getLoadKind(fieldType);
+
+    return info;
+}
+
+ExprAccessInfo getDerefInfo(const TypeInfoPtr& key)
+{
+    ExprAccessInfo  info = { false, true, 0, TypeInfoPtr(), ExprLoadNone };
+
+    if (!key->isPointer())
+        return info;
+
+    info.direct = true;
+    info.type = key->deref();
+    info.load = getLoadKind(info.type);
+
+    return info;
+}
+
+ExprAccessInfo getIndexInfo(const TypeInfoPtr& key)
+{
+    ExprAccessInfo  info = { false, false, 0, TypeInfoPtr(), ExprLoadNone };
+
+    if (key->isPointer())
+    {
+        info.viaPointer = true;
+        info.type = key->deref();
+    }
+    else if (key->isArray())
+    {
+        info.type = key->getElement(0);
+    }
+    else
+    {
+        return info;
+    }
+
+    info.direct = true;
+    info.offset = info.type->getSize();
+    info.load = getLoadKind(info.type);
+
+    return info;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // end nameless namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+TypedValue ExprProgram::run(const ScopePtr& scope)
+{
+    std::vector<ExprValue>  stack(m_maxDepth);
+    size_t  sp = 0;
+
+    for (size_t ip = 0; ip < m_code.size(); )
+    {
+        const ExprInstruction&  instruction = m_code[ip++];
+
+        switch (instruction.opcode)
+        {
+        case ExprOpConst:
+            stack[sp++] = m_consts[instruction.arg];
+            break;
+
+        case ExprOpEval:
+            setVar(stack[sp], m_nodes[instruction.arg]->getResult(scope).get());
+            sp++;
+            break;
+
+        case ExprOpField:
+        case ExprOpDeref:
+            accessElement(m_accesses[instruction.arg], stack[sp - 1]);
+            break;
+
+        case ExprOpIndex:
+            --sp;
+            accessElement(m_accesses[instruction.arg], stack[sp - 1], getNum(stack[sp]).asLongLong());
+            break;
+
+        case ExprOpAdd:
+        case ExprOpSub:
+        case ExprOpMul:
+        case ExprOpDiv:
+        case ExprOpMod:
+        case ExprOpShl:
+        case ExprOpShr:
+        case ExprOpBitAnd:
+        case ExprOpBitOr:
+        case ExprOpBitXor:
+            --sp;
+            if (isNumeric(stack[sp - 1]) && isNumeric(stack[sp]))
+                setNum(stack[sp - 1], getArithmeticResult(instruction.opcode, getNum(stack[sp - 1]), getNum(stack[sp])));
+            else
+                setVar(stack[sp - 1], m_binOperations[instruction.arg]->getResult(box(stack[sp - 1]), box(stack[sp])).get());
+            break;
+
+        case ExprOpEq:
+        case ExprOpNe:
+        case ExprOpLt:
+        case ExprOpLe:
+        case ExprOpGt:
+        case ExprOpGe:
+            --sp;
+            setBool(stack[sp - 1], getCompareResult(instruction.opcode, getNum(stack[sp - 1]), getNum(stack[sp])));
+            break;
+
+        case ExprOpNeg:
+        case ExprOpBitNot:
+        case ExprOpBoolNot:
+            if (!isNumeric(stack[sp - 1]))
+                setVar(stack[sp - 1], m_unaryOperations[instruction.arg]->getResult(box(stack[sp - 1])).get());
+            else if (instruction.opcode == ExprOpNeg)
+                setNum(stack[sp - 1], -getNum(stack[sp - 1]));
+            else if (instruction.opcode == ExprOpBitNot)
+                setNum(stack[sp - 1], ~getNum(stack[sp - 1]));
+            else
+                setBool(stack[sp - 1], !getNum(stack[sp - 1]));
+            break;
+
+        case ExprOpToBool:
+            setBool(stack[sp - 1], getNum(stack[sp - 1]) != NumVariant(0));
+            break;
+
+        case ExprOpAndJump:
+            if (getNum(stack[sp - 1]) == NumVariant(0))
+            {
+                setBool(stack[sp - 1], false);
+                ip = instruction.arg;
+            }
+            else
+            {
+                --sp;
+            }
+            break;
+
+        case ExprOpOrJump:
+            if (getNum(stack[sp - 1]) != NumVariant(0))
+            {
+                setBool(stack[sp - 1], true);
+                ip = instruction.arg;
+            }
+            else
+            {
+                --sp;
+            }
+            break;
+
+        case ExprOpJumpIfNot:
+            --sp;
+            if (!static_cast<bool>(getNum(stack[sp])))
+                ip = instruction.arg;
+            break;
+
+        case ExprOpJump:
+            ip = instruction.arg;
+            break;
+
+        case ExprOpUnary:
+            setVar(stack[sp - 1], m_unaryOperations[instruction.arg]->getResult(box(stack[sp - 1])).get());
+            break;
+
+        case ExprOpBinary:
+            --sp;
+            setVar(stack[sp - 1], m_binOperations[instruction.arg]->getResult(box(stack[sp - 1]), box(stack[sp])).get());
+            break;
+
+        default:
+            throw ExprException(L"error syntax");
+        }
+    }
+
+    if (sp != 1)
+        throw ExprException(L"error syntax");
+
+    return box(stack[0]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ExprProgram::accessElement(ExprAccess& access, ExprValue& value, long long index)
+{
+    if (value.kind == ExprValueMemory || value.kind == ExprValueVar)
+    {
+        ExprAccessInfo  info = getAccessInfo(access, value.kind == ExprValueMemory ? value.type : value.var->getType());
+
+        MEMOFFSET_64  address;
+
+        if (info.direct && getObjectAddress(value, info.viaPointer, address))
+        {
+            // a negative index goes back from the pointer
+            address += access.kind == ExprAccessIndex ? static_cast<MEMOFFSET_64>(static_cast<long long>(info.offset) * index) : info.offset;
+            setMemory(value, address, info.type, info.load);
+            return;
+        }
+    }
+
+    if (access.kind == ExprAccessIndex)
+        setVar(value, ArrayValueOperation(NumVariant(index)).getResult(box(value)).get());
+    else
+        setVar(value, access.operation->getResult(box(value)).get());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ExprAccessInfo ExprProgram::getAccessInfo(ExprAccess& access, const TypeInfoPtr& key)
+{
+    {
+        boost::mutex::scoped_lock  lock(access.lock);
+
+        if (access.key == key)
+            return access.info;
+    }
+
+    ExprAccessInfo  info;
+
+    switch (access.kind)
+    {
+    case ExprAccessField:
+        info = getFieldInfo(key, access.fieldName);
+        break;
+
+    case ExprAccessDeref:
+        info = getDerefInfo(key);
+        break;
+
+    default:
+        info = getIndexInfo(key);
+        break;
+    }
+
+    boost::mutex::scoped_lock  lock(access.lock);
+
+    access.key = key;
+    access.info = info;
+
+    return info;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ExprProgram::emit(ExprOpcode opcode, size_t arg, int depth)
+{
+    ExprInstruction  instruction = { opcode, static_cast<unsigned long>(arg) };
+    m_code.push_back(instruction);
+
+    m_depth += depth;
+    if (m_depth > m_maxDepth)
+        m_maxDepth = m_depth;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ExprProgram::emitConst(const TypedValue& value)
+{
+    ExprValue  constValue;
+
+    TypeInfoPtr  typeInfo = value.getType();
+
+    if (typeInfo->isBase() && !typeInfo->isBitField())
+    {
+        setNum(constValue, value.getValue());
+        constValue.var = TypedValue(value).get();
+    }
+    else
+    {
+        setVar(constValue, TypedValue(value).get());
+    }
+
+    m_consts.push_back(constValue);
+
+    emit(ExprOpConst, m_consts.size() - 1, 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ExprProgram::emitEval(ExprNode* node)
+{
+    m_nodes.push_back(node);
+
+    emit(ExprOpEval, m_nodes.size() - 1, 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ExprProgram::emitUnary(UnaryOperation* operation)
+{
+    ExprOpcode  opcode = operation->getOpcode();
+
+    switch (opcode)
+    {
+    case ExprOpPlus:
+        return;
+
+    case ExprOpField:
+        emit(opcode, addAccess(ExprAccessField, operation, static_cast<AttributeOperation*>(operation)->getAttributeName()), 0);
+        return;
+
+    case ExprOpDeref:
+        emit(opcode, addAccess(ExprAccessDeref, operation, std::wstring()), 0);
+        return;
+
+    case ExprOpNeg:
+    case ExprOpBitNot:
+    case ExprOpBoolNot:
+        break;
+
+    default:
+        opcode = ExprOpUnary;
+        break;
+    }
+
+    m_unaryOperations.push_back(operation);
+
+    emit(opcode, m_unaryOperations.size() - 1, 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ExprProgram::emitBinary(BinOperation* operation)
+{
+    m_binOperations.push_back(operation);
+
+    emit(operation->getOpcode(), m_binOperations.size() - 1, -1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ExprProgram::emitIndex()
+{
+    emit(ExprOpIndex, addAccess(ExprAccessIndex, nullptr, std::wstring()), -1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ExprProgram::emitToBool()
+{
+    emit(ExprOpToBool, 0, 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t ExprProgram::emitJump(ExprOpcode opcode)
+{
+    // the code after a jump starts without the value: it is popped or left for the target
+    emit(opcode, 0, -1);
+
+    return m_code.size() - 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ExprProgram::setJumpTarget(size_t jump)
+{
+    m_code[jump].arg = static_cast<unsigned long>(m_code.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t ExprProgram::addAccess(ExprAccessKind kind, UnaryOperation* operation, const std::wstring& fieldName)
+{
+    m_accesses.emplace_back();
+
+    ExprAccess&  access = m_accesses.back();
+    access.kind = kind;
+    access.operation = operation;
+    access.fieldName = fieldName;
+
+    return m_accesses.size() - 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "kdlib/typedvar.h"
+
+namespace kdlib {
+
+class ExprNode;
+class UnaryOperation;
+class BinOperation;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The instruction argument is an index in one of the program tables or a jump target
+
+enum ExprOpcode
+{
+    ExprOpConst,            // push the constant
+    ExprOpEval,             // push the result of the node evaluated by the tree walker
+
+    ExprOpField,            // replace the top with its field
+    ExprOpDeref,            // replace the top with the pointed value
+    ExprOpIndex,            // pop the index, replace the top with its element
+
+    ExprOpAdd,              // pop the second operand, replace the top with the result
+    ExprOpSub,
+    ExprOpMul,
+    ExprOpDiv,
+    ExprOpMod,
+    ExprOpShl,
+    ExprOpShr,
+    ExprOpBitAnd,
+    ExprOpBitOr,
+    ExprOpBitXor,
+    ExprOpEq,
+    ExprOpNe,
+    ExprOpLt,
+    ExprOpLe,
+    ExprOpGt,
+    ExprOpGe,
+
+    ExprOpNeg,              // replace the top with the result
+    ExprOpBitNot,
+    ExprOpBoolNot,
+    ExprOpPlus,             // no instruction is emitted
+
+    ExprOpToBool,           // replace the top with a bool
+    ExprOpAndJump,          // if the top is false replace it with false and jump, else pop it
+    ExprOpOrJump,           // if the top is true replace it with true and jump, else pop it
+    ExprOpJumpIfNot,        // pop the condition, jump if it is false
+    ExprOpJump,
+
+    ExprOpUnary,            // the operation on the boxed value
+    ExprOpBinary
+};
+
+struct ExprInstruction {
+    ExprOpcode  opcode;
+    unsigned long  arg;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// How a value of the type is read from the memory without a typed variable
+
+enum ExprLoadKind
+{
+    ExprLoadNone,           // not a scalar: the value is boxed
+    ExprLoadSignByte,
+    ExprLoadByte,
+    ExprLoadSignWord,
+    ExprLoadWord,
+    ExprLoadSignDWord,
+    ExprLoadDWord,
+    ExprLoadSignQWord,
+    ExprLoadQWord,
+    ExprLoadFloat,
+    ExprLoadDouble,
+    ExprLoadBool,
+    ExprLoadPtr32,
+    ExprLoadPtr64
+};
+
+ExprLoadKind getLoadKind(const TypeInfoPtr& typeInfo);
+
+enum ExprValueKind
+{
+    ExprValueNum,           // an unboxed base type value, the var keeps the boxed constant if any
+    ExprValueBool,          // a result of a logical operation
+    ExprValueMemory,        // a variable not loaded yet: the type and the address
+    ExprValueVar            // a boxed value
+};
+
+struct ExprValue {
+    ExprValueKind  kind;
+    ExprLoadKind  load;
+    NumVariant  num;
+    MEMOFFSET_64  address;
+    TypeInfoPtr  type;
+    TypedVarPtr  var;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// A field, a dereference or an element access remembers the layout of the last
+// accessed type: the next evaluation only compares the type
+
+enum ExprAccessKind
+{
+    ExprAccessField,
+    ExprAccessDeref,
+    ExprAccessIndex
+};
+
+struct ExprAccessInfo {
+    bool  direct;           // the result is computed from the address
+    bool  viaPointer;       // the address is the pointer value
+    MEMOFFSET_64  offset;   // the field offset or the element size
+    TypeInfoPtr  type;
+    ExprLoadKind  load;
+};
+
+struct ExprAccess {
+    ExprAccessKind  kind;
+    std::wstring  fieldName;
+    UnaryOperation*  operation;     // the fallback, null for the index
+
+    boost::mutex  lock;
+    TypeInfoPtr  key;
+    ExprAccessInfo  info;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// A compiled expression lowered to the bytecode for a stack machine. The base
+// type values are kept unboxed as NumVariant and the fields are addressed by
+// the offset, a TypedVar is created only for an operation on a pointer or a
+// UDT and for the result. The program refers to the nodes and the operations
+// of the tree, it must not outlive it.
+
+class ExprProgram : private boost::noncopyable
+{
+public:
+
+    ExprProgram() :
+        m_depth(0),
+        m_maxDepth(0)
+    {}
+
+    TypedValue run(const ScopePtr& scope);
+
+    void emitConst(const TypedValue& value);
+    void emitEval(ExprNode* node);
+    void emitUnary(UnaryOperation* operation);
+    void emitBinary(BinOperation* operation);
+    void emitIndex();
+    void emitToBool();
+
+    // returns the jump to be patched by setJumpTarget
+    size_t emitJump(ExprOpcode opcode);
+    void setJumpTarget(size_t jump);
+
+private:
+
+    void emit(ExprOpcode opcode, size_t arg, int depth);
+
+    size_t addAccess(ExprAccessKind kind, UnaryOperation* operation, const std::wstring& fieldName);
+
+    ExprAccessInfo getAccessInfo(ExprAccess& access, const TypeInfoPtr& key);
+
+    void accessElement(ExprAccess& access, ExprValue& value, long long index = 0);
+
+    std::vector<ExprInstruction>  m_code;
+
+    std::vector<ExprValue>  m_consts;
+    std::vector<ExprNode*>  m_nodes;
+    std::vector<UnaryOperation*>  m_unaryOperations;
+    std::vector<BinOperation*>  m_binOperations;
+    std::deque<ExprAccess>  m_accesses;
+
+    size_t  m_depth;
+    size_t  m_maxDepth;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+
+#include "kdlib/dbgtypedef.h"
+#include "kdlib/instruction.h"
+
+namespace kdlib {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// throws DbgException if the mode is not x86 or AMD64
+void checkDecoderMode( CPUType cpuMode );
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The code of a range read with one read if all its pages are readable, a
+// page which can not be read is skipped. The bytes after the end are read
+// too: the last instruction may cross it. Once read, the buffer is decoded
+// without the debug engine, so it can be shared by any threads.
+
+class CodeBuffer
+{
+public:
+
+    CodeBuffer( MEMOFFSET_64 begin, MEMOFFSET_64 end );
+
+    // the code already read, the range is [begin, begin + length)
+    CodeBuffer( const void* buffer, size_t length, MEMOFFSET_64 begin );
+
+    MEMOFFSET_64 getBegin() const {
+        return m_begin;
+    }
+
+    MEMOFFSET_64 getEnd() const {
+        return m_end;
+    }
+
+    // false if the bytes at the offset can not be read or are not a valid
+    // instruction
+    bool decode( MEMOFFSET_64 offset, CPUType cpuMode, Instruction &instruction ) const;
+
+    // linear sweep over [begin, end) of the range
+    void disassemble( MEMOFFSET_64 begin, MEMOFFSET_64 end, CPUType cpuMode, InstructionList &instructions ) const;
+
+private:
+
+    typedef std::pair<size_t, size_t>  ReadPart;
+
+    // the part containing the buffer position, null if it was not read
+    const ReadPart* findPart( size_t pos ) const;
+
+    MEMOFFSET_64  m_begin;
+    MEMOFFSET_64  m_end;
+    std::vector<unsigned char>  m_buffer;
+    std::vector<ReadPart>  m_parts;     // [first, second) of the buffer, by position
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
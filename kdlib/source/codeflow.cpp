@@ -0,0 +1,921 @@
+#include "stdafx.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include <boost/bind.hpp>
+#include <boost/atomic.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "kdlib/codeflow.h"
+#include "kdlib/dbgengine.h"
+#include "kdlib/exceptions.h"
+#include "kdlib/memaccess.h"
+#include "kdlib/module.h"
+
+#include "codebuffer.h"
+#include "peimage.h"
+#include "processmon.h"
+#include "unwind.h"
+#include "xrefindex.h"
+
+namespace kdlib {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+
+enum CodeByteState
+{
+    ByteUnknown,
+    ByteInstruction,        // the first byte of an instruction
+    ByteInside,
+    BytePadding
+};
+
+bool isInt3( const Instruction &instruction )
+{
+    return instruction.mnemonic == MnemonicInt && instruction.bytes[0] == 0xCC;
+}
+
+// int 29h is __fastfail: it does not return
+bool isFastFail( const Instruction &instruction )
+{
+    return instruction.mnemonic == MnemonicInt && instruction.bytes[0] == 0xCD && instruction.immediate == 0x29;
+}
+
+bool isPadding( const Instruction &instruction )
+{
+    return instruction.mnemonic == MnemonicNop || isInt3( instruction );
+}
+
+bool isFallThrough( const Instruction &instruction )
+{
+    switch ( instruction.flow )
+    {
+    case FlowJump:
+    case FlowReturn:
+    case FlowStop:
+        return false;
+
+    case FlowInterrupt:
+        return !isInt3( instruction ) && !isFastFail( instruction );
+    }
+
+    return true;
+}
+
+bool isBlockEnd( const Instruction &instruction )
+{
+    return instruction.flow == FlowBranch || !isFallThrough( instruction );
+}
+
+// the target of a direct call, jump or branch, 0 for an indirect one
+MEMOFFSET_64 getBranchTarget( const Instruction &instruction )
+{
+    if ( instruction.flow != FlowCall && instruction.flow != FlowJump && instruction.flow != FlowBranch )
+        return 0;
+
+    if ( instruction.operandCount == 0 || instruction.operands[0].kind != OperandBranch )
+        return 0;
+
+    return instruction.target;
+}
+
+bool instructionLess( const Instruction &instruction1, const Instruction &instruction2 )
+{
+    return instruction1.offset < instruction2.offset;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Follows the code of the range from the entry by the direct jumps and
+// branches, then from the beginnings of the parts not reached. The code
+// overlapping the decoded one is not followed. The instructions go to the
+// sink in the order they are reached, the leaders are the jump targets.
+
+class FunctionDecoder
+{
+public:
+
+    FunctionDecoder( const CodeBuffer &code, MEMOFFSET_64 begin, MEMOFFSET_64 end, CPUType cpuMode ) :
+        m_code( code ),
+        m_begin( begin ),
+        m_end( end ),
+        m_cpuMode( cpuMode ),
+        m_state( static_cast<size_t>( end - begin ), ByteUnknown ),
+        m_leaders( static_cast<size_t>( end - begin ), false )
+    {}
+
+    template<typename InstructionSink>
+    void decode( InstructionSink &sink )
+    {
+        if ( m_begin >= m_end )
+            return;
+
+        m_leaders[0] = true;
+        m_entries.push_back( m_begin );
+
+        size_t  gap = 0;
+
+        for (;;)
+        {
+            while ( !m_entries.empty() )
+            {
+                MEMOFFSET_64  entry = m_entries.back();
+                m_entries.pop_back();
+
+                for ( MEMOFFSET_64 offset = entry; inRange( offset ); )
+                {
+                    Instruction  instruction;
+
+                    if ( !followCode( offset, instruction ) )
+                        break;
+
+                    sink( instruction );
+
+                    if ( !isFallThrough( instruction ) )
+                        break;
+
+                    offset += instruction.length;
+                }
+            }
+
+            // the next part not reached, the alignment padding is skipped
+            while ( gap < m_state.size() && m_state[gap] != ByteUnknown )
+                ++gap;
+
+            if ( gap == m_state.size() )
+                break;
+
+            // the part taken before was not followed: its first instruction
+            // overlaps the decoded code, so the byte is data
+            if ( m_leaders[gap] )
+            {
+                m_leaders[gap] = false;
+                markPadding( gap, 1 );
+                continue;
+            }
+
+            Instruction  instruction;
+
+            if ( !m_code.decode( m_begin + gap, m_cpuMode, instruction ) )
+                markPadding( gap, 1 );
+            else if ( isPadding( instruction ) )
+                markPadding( gap, instruction.length );
+            else
+            {
+                m_leaders[gap] = true;
+                m_entries.push_back( m_begin + gap );
+            }
+        }
+    }
+
+    bool isLeader( MEMOFFSET_64 offset ) const {
+        return offset >= m_begin && offset < m_end && m_leaders[static_cast<size_t>( offset - m_begin )];
+    }
+
+private:
+
+    // decodes the instruction at the offset if it was not decoded yet
+    bool followCode( MEMOFFSET_64 offset, Instruction &instruction );
+
+    bool markInstruction( size_t pos, size_t length );
+
+    void markPadding( size_t pos, size_t length );
+
+    bool inRange( MEMOFFSET_64 offset ) const {
+        return offset >= m_begin && offset < m_end;
+    }
+
+    const CodeBuffer  &m_code;
+    MEMOFFSET_64  m_begin;
+    MEMOFFSET_64  m_end;
+    CPUType  m_cpuMode;
+    std::vector<unsigned char>  m_state;
+    std::vector<bool>  m_leaders;
+    std::vector<MEMOFFSET_64>  m_entries;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool FunctionDecoder::followCode( MEMOFFSET_64 offset, Instruction &instruction )
+{
+    size_t  pos = static_cast<size_t>( offset - m_begin );
+
+    if ( m_state[pos] == ByteInstruction )
+    {
+        // a join with the code decoded before
+        m_leaders[pos] = true;
+        return false;
+    }
+
+    // a jump to the code taken as the padding
+    if ( m_state[pos] != ByteUnknown && m_state[pos] != BytePadding )
+        return false;
+
+    if ( !m_code.decode( offset, m_cpuMode, instruction ) )
+        return false;
+
+    if ( !markInstruction( pos, instruction.length ) )
+        return false;
+
+    MEMOFFSET_64  target = getBranchTarget( instruction );
+
+    if ( instruction.flow != FlowCall && inRange( target ) )
+    {
+        m_leaders[static_cast<size_t>( target - m_begin )] = true;
+        m_entries.push_back( target );
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool FunctionDecoder::markInstruction( size_t pos, size_t length )
+{
+    size_t  end = std::min( pos + length, m_state.size() );
+
+    for ( size_t i = pos; i < end; ++i )
+    {
+        if ( m_state[i] != ByteUnknown && m_state[i] != BytePadding )
+            return false;
+    }
+
+    m_state[pos] = ByteInstruction;
+
+    for ( size_t i = pos + 1; i < end; ++i )
+        m_state[i] = ByteInside;
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FunctionDecoder::markPadding( size_t pos, size_t length )
+{
+    size_t  end = std::min( pos + length, m_state.size() );
+
+    for ( size_t i = pos; i < end; ++i )
+    {
+        if ( m_state[i] == ByteUnknown )
+            m_state[i] = BytePadding;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct InstructionCollector
+{
+    explicit InstructionCollector( InstructionList &instructions ) :
+        m_instructions( instructions )
+        {}
+
+    void operator()( const Instruction &instruction ) {
+        m_instructions.push_back( instruction );
+    }
+
+    InstructionList  &m_instructions;
+};
+
+void buildBlocks( const FunctionDecoder &decoder, FunctionGraph &graph )
+{
+    const InstructionList  &instructions = graph.instructions;
+
+    for ( size_t i = 0; i < instructions.size(); ++i )
+    {
+        const Instruction  &instruction = instructions[i];
+
+        bool  newBlock = i == 0 || decoder.isLeader( instruction.offset );
+
+        if ( !newBlock )
+        {
+            const Instruction  &prev = instructions[i - 1];
+            newBlock = isBlockEnd( prev ) || prev.offset + prev.length != instruction.offset;
+        }
+
+        if ( newBlock )
+        {
+            BasicBlock  block = { instruction.offset, instruction.offset, i, 0 };
+            graph.blocks.push_back( block );
+        }
+
+        BasicBlock  &block = graph.blocks.back();
+        block.end = instruction.offset + instruction.length;
+        block.instructionCount += 1;
+    }
+
+    for ( size_t i = 0; i < graph.blocks.size(); ++i )
+    {
+        const BasicBlock  &block = graph.blocks[i];
+        const Instruction  &last = instructions[block.firstInstruction + block.instructionCount - 1];
+
+        MEMOFFSET_64  target = getBranchTarget( last );
+
+        if ( target != 0 && ( last.flow == FlowJump || last.flow == FlowBranch ) )
+        {
+            size_t  to = findBasicBlock( graph, target );
+
+            if ( to != NoBasicBlock && graph.blocks[to].begin == target )
+            {
+                FlowEdge  edge = { i, to, last.flow == FlowJump ? EdgeJump : EdgeBranch };
+                graph.edges.push_back( edge );
+            }
+        }
+
+        if ( isFallThrough( last ) && i + 1 < graph.blocks.size() && graph.blocks[i + 1].begin == block.end )
+        {
+            FlowEdge  edge = { i, i + 1, EdgeFallThrough };
+            graph.edges.push_back( edge );
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The function of the offset by its symbol or by the unwind data
+
+bool getFunctionRange( MEMOFFSET_64 offset, MEMOFFSET_64 &begin, MEMOFFSET_64 &end )
+{
+    try
+    {
+        ModulePtr  module = loadModule( offset );
+
+        MEMDISPLACEMENT  displacement = 0;
+        SymbolPtr  function = module->getSymbolByVa( offset, SymTagFunction, &displacement );
+
+        begin = function->getVa();
+        end = begin + function->getSize();
+
+        if ( begin <= offset && offset < end )
+            return true;
+    }
+    catch( const DbgException& )
+    {
+    }
+
+    DbgUnwindTarget  target;
+
+    UnwindFunctionTablePtr  table = target.getFunctionTable( offset );
+    if ( !table )
+        return false;
+
+    const UnwindFunction  *function = table->find( static_cast<boost::uint32_t>( offset - table->getImageBase() ) );
+    if ( !function )
+        return false;
+
+    begin = table->getImageBase() + function->begin;
+    end = table->getImageBase() + function->end;
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct XrefJob
+{
+    size_t  buffer;
+    MEMOFFSET_64  begin;
+    MEMOFFSET_64  end;
+};
+
+// The references of the instructions into the module
+
+struct XrefCollector
+{
+    XrefCollector( MEMOFFSET_64 moduleBase, MEMOFFSET_64 moduleSize, std::vector<XrefEntry> &entries ) :
+        m_moduleBase( moduleBase ),
+        m_moduleSize( moduleSize ),
+        m_entries( entries )
+        {}
+
+    void operator()( const Instruction &instruction )
+    {
+        boost::uint32_t  from = static_cast<boost::uint32_t>( instruction.offset - m_moduleBase );
+
+        MEMOFFSET_64  target = getBranchTarget( instruction );
+
+        if ( target - m_moduleBase < m_moduleSize )
+        {
+            CrossReferenceKind  kind = instruction.flow == FlowCall ? XrefCall : instruction.flow == FlowJump ? XrefJump : XrefBranch;
+
+            XrefEntry  entry = { from, static_cast<boost::uint32_t>( target - m_moduleBase ), static_cast<boost::uint32_t>( kind ) };
+            m_entries.push_back( entry );
+        }
+
+        if ( instruction.ea - m_moduleBase < m_moduleSize )
+        {
+            XrefEntry  entry = { from, static_cast<boost::uint32_t>( instruction.ea - m_moduleBase ), static_cast<boost::uint32_t>( XrefData ) };
+            m_entries.push_back( entry );
+        }
+    }
+
+    MEMOFFSET_64  m_moduleBase;
+    MEMOFFSET_64  m_moduleSize;
+    std::vector<XrefEntry>  &m_entries;
+};
+
+void xrefWorker(
+    const std::vector< boost::shared_ptr<CodeBuffer> > &buffers,
+    const std::vector<XrefJob> &jobs,
+    CPUType cpuMode,
+    MEMOFFSET_64 moduleBase,
+    MEMOFFSET_64 moduleSize,
+    boost::atomic<size_t> &nextJob,
+    std::vector<XrefEntry> &entries )
+{
+    XrefCollector  collector( moduleBase, moduleSize, entries );
+
+    for ( size_t i = nextJob++; i < jobs.size(); i = nextJob++ )
+    {
+        FunctionDecoder  decoder( *buffers[jobs[i].buffer], jobs[i].begin, jobs[i].end, cpuMode );
+        decoder.decode( collector );
+    }
+}
+
+// A job per function of the unwind data or per executable section. The code
+// of each executable section is read with one read.
+
+void getXrefJobs( MEMOFFSET_64 moduleBase, MEMOFFSET_64 moduleSize, std::vector< boost::shared_ptr<CodeBuffer> > &buffers, std::vector<XrefJob> &jobs )
+{
+    std::vector<PeSection>  sections;
+
+    try
+    {
+        readPeSections( *getPeMemoryReader( moduleBase ), sections );
+    }
+    catch( const DbgException& )
+    {
+        sections.clear();
+    }
+
+    std::vector< std::pair<MEMOFFSET_64, MEMOFFSET_64> >  ranges;
+
+    for ( size_t i = 0; i < sections.size(); ++i )
+    {
+        if ( ( sections[i].characteristics & PeSectionExecute ) != 0 )
+            ranges.push_back( std::make_pair( moduleBase + sections[i].rva, moduleBase + sections[i].rva + sections[i].virtualSize ) );
+    }
+
+    // the headers are paged out: the image is taken as code as a whole
+    if ( ranges.empty() )
+        ranges.push_back( std::make_pair( moduleBase, moduleBase + moduleSize ) );
+
+    std::sort( ranges.begin(), ranges.end() );
+
+    for ( size_t i = 0; i < ranges.size(); ++i )
+        buffers.push_back( boost::shared_ptr<CodeBuffer>( new CodeBuffer( ranges[i].first, ranges[i].second ) ) );
+
+    DbgUnwindTarget  target;
+    UnwindFunctionTablePtr  table = target.getFunctionTable( moduleBase );
+
+    if ( !table || table->getCount() == 0 )
+    {
+        for ( size_t i = 0; i < ranges.size(); ++i )
+        {
+            XrefJob  job = { i, ranges[i].first, ranges[i].second };
+            jobs.push_back( job );
+        }
+
+        return;
+    }
+
+    const std::vector<UnwindFunction>  &functions = table->getFunctions();
+
+    size_t  range = 0;
+
+    for ( size_t i = 0; i < functions.size(); ++i )
+    {
+        MEMOFFSET_64  begin = moduleBase + functions[i].begin;
+        MEMOFFSET_64  end = moduleBase + functions[i].end;
+
+        while ( range < ranges.size() && ranges[range].second <= begin )
+            ++range;
+
+        if ( range == ranges.size() )
+            break;
+
+        if ( begin < ranges[range].first )
+            continue;
+
+        XrefJob  job = { range, begin, std::min( end, ranges[range].second ) };
+        jobs.push_back( job );
+    }
+}
+
+XrefIndexPtr buildXrefIndex( MEMOFFSET_64 moduleBase, CPUType cpuMode, unsigned long threadCount )
+{
+    MEMOFFSET_64  moduleSize = getModuleSize( moduleBase );
+
+    std::vector< boost::shared_ptr<CodeBuffer> >  buffers;
+    std::vector<XrefJob>  jobs;
+
+    getXrefJobs( moduleBase, moduleSize, buffers, jobs );
+
+    if ( threadCount == 0 )
+        threadCount = std::max( boost::thread::hardware_concurrency(), 1U );
+
+    if ( threadCount > jobs.size() )
+        threadCount = static_cast<unsigned long>( std::max<size_t>( jobs.size(), 1 ) );
+
+    std::vector< std::vector<XrefEntry> >  results( threadCount );
+    boost::atomic<size_t>  nextJob( 0 );
+    boost::thread_group  workers;
+
+    try
+    {
+        for ( unsigned long i = 0; i < threadCount; ++i )
+        {
+            workers.create_thread( boost::bind( &xrefWorker, boost::cref(buffers), boost::cref(jobs), cpuMode, moduleBase, moduleSize,
+                boost::ref(nextJob), boost::ref(results[i]) ) );
+        }
+    }
+    catch( const boost::thread_resource_error& )
+    {
+        // the jobs left are done here
+    }
+
+    std::vector<XrefEntry>  entries;
+
+    xrefWorker( buffers, jobs, cpuMode, moduleBase, moduleSize, nextJob, entries );
+
+    workers.join_all();
+
+    for ( size_t i = 0; i < results.size(); ++i )
+        entries.insert( entries.end(), results[i].begin(), results[i].end() );
+
+    return XrefIndexPtr( new XrefIndex( moduleBase, entries ) );
+}
+
+std::wstring getXrefFileName( const std::wstring &directory, MEMOFFSET_64 moduleBase, unsigned long timeStamp, unsigned long checkSum )
+{
+    std::wstringstream  sstr;
+
+    sstr << directory;
+
+    if ( !directory.empty() && *directory.rbegin() != L'\\' && *directory.rbegin() != L'/' )
+        sstr << L'\\';
+
+    sstr << getModuleName( moduleBase ) << L'_' << std::hex << timeStamp << L'_' << checkSum << L".xref";
+
+    return sstr.str();
+}
+
+XrefIndexPtr getXrefIndex( MEMOFFSET_64 offset, const CrossReferenceOptions &options )
+{
+    MEMOFFSET_64  moduleBase = findModuleBase( addr64( offset ) );
+
+    XrefIndexPtr  index = ProcessMonitor::getXrefIndex( moduleBase );
+    if ( index )
+        return index;
+
+    CPUType  cpuMode = getCPUMode();
+    checkDecoderMode( cpuMode );
+
+    std::wstring  fileName;
+    unsigned long  timeStamp = 0;
+    unsigned long  checkSum = 0;
+
+    if ( !options.cacheDirectory.empty() )
+    {
+        timeStamp = getModuleTimeStamp( moduleBase );
+        checkSum = getModuleCheckSum( moduleBase );
+        fileName = getXrefFileName( options.cacheDirectory, moduleBase, timeStamp, checkSum );
+
+        index = loadXrefIndex( fileName, moduleBase, cpuMode, timeStamp, checkSum );
+    }
+
+    if ( !index )
+    {
+        index = buildXrefIndex( moduleBase, cpuMode, options.threadCount );
+
+        if ( !fileName.empty() )
+            saveXrefIndex( fileName, *index, cpuMode, timeStamp, checkSum );
+    }
+
+    ProcessMonitor::insertXrefIndex( index );
+
+    return index;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool entryTargetLess( const XrefEntry &entry1, const XrefEntry &entry2 )
+{
+    return entry1.to != entry2.to ? entry1.to < entry2.to : entry1.from < entry2.from;
+}
+
+struct EntryTargetLess
+{
+    bool operator()( const XrefEntry &entry, boost::uint32_t rva ) const {
+        return entry.to < rva;
+    }
+
+    bool operator()( boost::uint32_t rva, const XrefEntry &entry ) const {
+        return rva < entry.to;
+    }
+};
+
+struct EntrySourceLess
+{
+    explicit EntrySourceLess( const std::vector<XrefEntry> &entries ) :
+        m_entries( entries )
+        {}
+
+    bool operator()( boost::uint32_t index1, boost::uint32_t index2 ) const {
+        const XrefEntry  &entry1 = m_entries[index1];
+        const XrefEntry  &entry2 = m_entries[index2];
+        return entry1.from != entry2.from ? entry1.from < entry2.from : entry1.to < entry2.to;
+    }
+
+    const std::vector<XrefEntry>  &m_entries;
+};
+
+// the source RVA searched in the indices
+
+struct SourceRva
+{
+    boost::uint32_t  rva;
+};
+
+struct EntrySourceRvaLess
+{
+    explicit EntrySourceRvaLess( const std::vector<XrefEntry> &entries ) :
+        m_entries( entries )
+        {}
+
+    bool operator()( boost::uint32_t index, SourceRva source ) const {
+        return m_entries[index].from < source.rva;
+    }
+
+    bool operator()( SourceRva source, boost::uint32_t index ) const {
+        return source.rva < m_entries[index].from;
+    }
+
+    const std::vector<XrefEntry>  &m_entries;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+const char  XrefFileSignature[4] = { 'K', 'X', 'R', 'F' };
+const boost::uint32_t  XrefFileVersion = 2;
+
+struct XrefFileHeader
+{
+    char  signature[4];
+    boost::uint32_t  version;
+    boost::uint32_t  timeStamp;
+    boost::uint32_t  checkSum;
+    boost::uint32_t  cpuMode;       // a WOW64 module is decoded as x86 or AMD64
+    boost::uint32_t  count;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+FunctionGraphPtr buildFunctionGraph( const CodeBuffer &code, CPUType cpuMode )
+{
+    MEMOFFSET_64  begin = code.getBegin();
+    MEMOFFSET_64  end = code.getEnd();
+
+    boost::shared_ptr<FunctionGraph>  graph( new FunctionGraph() );
+    graph->begin = begin;
+    graph->end = end;
+
+    FunctionDecoder  decoder( code, begin, end, cpuMode );
+
+    InstructionCollector  collector( graph->instructions );
+    decoder.decode( collector );
+
+    std::sort( graph->instructions.begin(), graph->instructions.end(), instructionLess );
+
+    buildBlocks( decoder, *graph );
+
+    return graph;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // end nameless namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+FunctionGraphPtr getFunctionGraph( MEMOFFSET_64 offset )
+{
+    offset = addr64( offset );
+
+    checkDecoderMode( getCPUMode() );
+
+    MEMOFFSET_64  begin = 0;
+    MEMOFFSET_64  end = 0;
+
+    if ( !getFunctionRange( offset, begin, end ) )
+        throw DbgException("no function at the address");
+
+    return getFunctionGraph( begin, end );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+FunctionGraphPtr getFunctionGraph( MEMOFFSET_64 begin, MEMOFFSET_64 end )
+{
+    begin = addr64( begin );
+    end = addr64( end );
+
+    if ( end <= begin )
+        throw DbgException("invalid address range");
+
+    CPUType  cpuMode = getCPUMode();
+    checkDecoderMode( cpuMode );
+
+    return buildFunctionGraph( CodeBuffer( begin, end ), cpuMode );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+FunctionGraphPtr getFunctionGraph( const void* buffer, size_t length, MEMOFFSET_64 begin, CPUType cpuMode )
+{
+    if ( length == 0 )
+        throw DbgException("invalid address range");
+
+    checkDecoderMode( cpuMode );
+
+    return buildFunctionGraph( CodeBuffer( buffer, length, begin ), cpuMode );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t findBasicBlock( const FunctionGraph &graph, MEMOFFSET_64 offset )
+{
+    size_t  low = 0;
+    size_t  high = graph.blocks.size();
+
+    while ( low < high )
+    {
+        size_t  middle = low + ( high - low ) / 2;
+
+        if ( graph.blocks[middle].begin <= offset )
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    if ( low == 0 || offset >= graph.blocks[low - 1].end )
+        return NoBasicBlock;
+
+    return low - 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void buildCrossReferences( MEMOFFSET_64 moduleBase, const CrossReferenceOptions& options )
+{
+    getXrefIndex( moduleBase, options );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+CrossReferenceList getReferencesTo( MEMOFFSET_64 offset )
+{
+    offset = addr64( offset );
+
+    CrossReferenceList  references;
+    getXrefIndex( offset, CrossReferenceOptions() )->findTo( offset, references );
+
+    return references;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+CrossReferenceList getReferencesFrom( MEMOFFSET_64 offset )
+{
+    offset = addr64( offset );
+
+    CrossReferenceList  references;
+    getXrefIndex( offset, CrossReferenceOptions() )->findFrom( offset, references );
+
+    return references;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+XrefIndex::XrefIndex( MEMOFFSET_64 moduleBase, std::vector<XrefEntry> &entries ) :
+    m_moduleBase( moduleBase )
+{
+    m_byTarget.swap( entries );
+
+    std::sort( m_byTarget.begin(), m_byTarget.end(), entryTargetLess );
+
+    m_bySource.resize( m_byTarget.size() );
+
+    for ( size_t i = 0; i < m_bySource.size(); ++i )
+        m_bySource[i] = static_cast<boost::uint32_t>( i );
+
+    std::sort( m_bySource.begin(), m_bySource.end(), EntrySourceLess( m_byTarget ) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void XrefIndex::findTo( MEMOFFSET_64 offset, CrossReferenceList &references ) const
+{
+    if ( offset < m_moduleBase || offset - m_moduleBase > 0xFFFFFFFF )
+        return;
+
+    boost::uint32_t  rva = static_cast<boost::uint32_t>( offset - m_moduleBase );
+
+    std::pair< std::vector<XrefEntry>::const_iterator, std::vector<XrefEntry>::const_iterator >  range =
+        std::equal_range( m_byTarget.begin(), m_byTarget.end(), rva, EntryTargetLess() );
+
+    for ( std::vector<XrefEntry>::const_iterator it = range.first; it != range.second; ++it )
+        references.push_back( makeReference( *it ) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void XrefIndex::findFrom( MEMOFFSET_64 offset, CrossReferenceList &references ) const
+{
+    if ( offset < m_moduleBase || offset - m_moduleBase > 0xFFFFFFFF )
+        return;
+
+    SourceRva  source = { static_cast<boost::uint32_t>( offset - m_moduleBase ) };
+
+    std::pair< std::vector<boost::uint32_t>::const_iterator, std::vector<boost::uint32_t>::const_iterator >  range =
+        std::equal_range( m_bySource.begin(), m_bySource.end(), source, EntrySourceRvaLess( m_byTarget ) );
+
+    for ( std::vector<boost::uint32_t>::const_iterator it = range.first; it != range.second; ++it )
+        references.push_back( makeReference( m_byTarget[*it] ) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+CrossReference XrefIndex::makeReference( const XrefEntry &entry ) const
+{
+    CrossReference  reference = { m_moduleBase + entry.from, m_moduleBase + entry.to, static_cast<CrossReferenceKind>( entry.kind ) };
+    return reference;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+XrefIndexPtr loadXrefIndex( const std::wstring &fileName, MEMOFFSET_64 moduleBase, CPUType cpuMode, unsigned long timeStamp, unsigned long checkSum )
+{
+    std::ifstream  file( fileName.c_str(), std::ios::binary | std::ios::ate );
+    if ( !file )
+        return XrefIndexPtr();
+
+    std::streamoff  fileSize = file.tellg();
+    file.seekg( 0 );
+
+    XrefFileHeader  header = {};
+
+    if ( !file.read( reinterpret_cast<char*>( &header ), sizeof(header) ) )
+        return XrefIndexPtr();
+
+    if ( !std::equal( XrefFileSignature, XrefFileSignature + sizeof(XrefFileSignature), header.signature ) ||
+        header.version != XrefFileVersion ||
+        header.timeStamp != timeStamp ||
+        header.checkSum != checkSum ||
+        header.cpuMode != static_cast<boost::uint32_t>( cpuMode ) )
+    {
+        return XrefIndexPtr();
+    }
+
+    // a damaged file must not make a huge allocation
+    if ( fileSize < 0 || static_cast<boost::uint64_t>( fileSize ) != sizeof(header) + static_cast<boost::uint64_t>( header.count ) * sizeof(XrefEntry) )
+        return XrefIndexPtr();
+
+    std::vector<XrefEntry>  entries( header.count );
+
+    if ( header.count > 0 && !file.read( reinterpret_cast<char*>( &entries[0] ), entries.size() * sizeof(XrefEntry) ) )
+        return XrefIndexPtr();
+
+    return XrefIndexPtr( new XrefIndex( moduleBase, entries ) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void saveXrefIndex( const std::wstring &fileName, const XrefIndex &index, CPUType cpuMode, unsigned long timeStamp, unsigned long checkSum )
+{
+    std::ofstream  file( fileName.c_str(), std::ios::binary | std::ios::trunc );
+    if ( !file )
+        return;
+
+    const std::vector<XrefEntry>  &entries = index.getEntries();
+
+    XrefFileHeader  header = {};
+    std::copy( XrefFileSignature, XrefFileSignature + sizeof(XrefFileSignature), header.signature );
+    header.version = XrefFileVersion;
+    header.timeStamp = timeStamp;
+    header.checkSum = checkSum;
+    header.cpuMode = static_cast<boost::uint32_t>( cpuMode );
+    header.count = static_cast<boost::uint32_t>( entries.size() );
+
+    file.write( reinterpret_cast<const char*>( &header ), sizeof(header) );
+
+    if ( !entries.empty() )
+        file.write( reinterpret_cast<const char*>( &entries[0] ), entries.size() * sizeof(XrefEntry) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
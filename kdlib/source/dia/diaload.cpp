@@ -16,6 +16,9 @@
 #include "dia/diawrapper.h"
 #include "win/utils.h"
 
+#include "peimage.h"
+#include "sympreloadimpl.h"
+
 #include "diacallback.h"
 
 #include <initguid.h>
@@ -177,14 +180,16 @@ public:
 // Access to executable file over RVA-callback
 class ReadExeAtRVACallback : public IDiaReadExeAtRVACallback {
     ULONGLONG m_loadBase;
+    PeImageReaderPtr m_imageReader;
     int m_nRefCount;
     CComPtr< IDiaLoadCallback2 > m_diaLoadCallback2;
 
 public:
     ReadExeAtRVACallback(
         __in ULONGLONG loadBase,
+        __in_opt const PeImageReaderPtr &imageReader,
         __out std::wstring &openedSymbolFile
-    )   : m_loadBase(loadBase), m_nRefCount(1)
+    )   : m_loadBase(loadBase), m_imageReader(imageReader), m_nRefCount(1)
         , m_diaLoadCallback2( new DiaLoadCallback2(&openedSymbolFile) ) 
     {
     }
@@ -221,6 +226,20 @@ public:
         /* [size_is][out] */ BYTE *pbData
     ) override 
     {
+            if ( m_imageReader )
+            {
+                try
+                {
+                    m_imageReader->read(relativeVirtualAddress, pbData, cbData);
+                    *pcbData = cbData;
+                    return S_OK;
+                }
+                catch (const DbgException&)
+                {
+                    return E_FAIL;
+                }
+            }
+
             if ( readMemoryUnsafe(
                 m_loadBase + relativeVirtualAddress,
                 pbData,
@@ -276,19 +295,21 @@ struct DataForExeByRva : IDataProvider {
     DataForExeByRva(
         __in ULONGLONG loadBase,
         __in const std::wstring &executable,
-        __in const std::wstring &symbolSearchPath
-    )   : m_loadBase(loadBase)
+        __in const std::wstring &symbolSearchPath,
+        __in_opt const PeImageReaderPtr &imageReader = PeImageReaderPtr()
+    )   : m_loadBase(loadBase), m_imageReader(imageReader)
     {
         m_executable = executable;
 
-        if (symbolSearchPath.empty())
+        // the engine is not asked from a preload worker thread
+        if (symbolSearchPath.empty() && !imageReader)
             m_symbolSearchPath = getSymbolPath();
         else
             m_symbolSearchPath = symbolSearchPath;
     }
 
     virtual HRESULT load(__inout IDiaDataSource &dataSource) override {
-        CComPtr< IUnknown > readExeAtRVACallback(new ReadExeAtRVACallback(m_loadBase, m_openedSymbolFile) );
+        CComPtr< IUnknown > readExeAtRVACallback(new ReadExeAtRVACallback(m_loadBase, m_imageReader, m_openedSymbolFile) );
         SymSrvLoadHelper symSrvLoadHelper;
         return 
             dataSource.loadDataForExe(
@@ -299,6 +320,7 @@ struct DataForExeByRva : IDataProvider {
 
 protected:
     ULONGLONG m_loadBase;
+    PeImageReaderPtr m_imageReader;
 
     std::wstring m_executable;
     std::wstring m_symbolSearchPath;
@@ -329,6 +351,37 @@ SymbolSessionPtr loadSymbolFile(
 
 //////////////////////////////////////////////////////////////////////////////////
 
+SymbolSessionPtr loadSymbolFile(
+    __in ULONGLONG loadBase,
+    __in const std::wstring &executable,
+    __in const std::wstring &symbolSearchPath,
+    __in const PeImageReaderPtr &imageReader
+)
+{
+    // a preload worker thread: the loader does not touch the debug engine,
+    // COM is initialized by the SymbolLoaderThread of the worker
+    DataForExeByRva dataForExeByRva(loadBase, executable, symbolSearchPath, imageReader);
+
+    return createSession(dataForExeByRva, loadBase, dataForExeByRva.m_openedSymbolFile);
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+
+SymbolLoaderThread::SymbolLoaderThread()
+{
+    // the DIA sessions created by the thread are used after its loads, COM
+    // is kept until the thread ends
+    m_initialized = SUCCEEDED(CoInitializeEx(NULL, COINIT_MULTITHREADED));
+}
+
+SymbolLoaderThread::~SymbolLoaderThread()
+{
+    if (m_initialized)
+        CoUninitialize();
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+
 void setSymSrvDir(const std::wstring &symSrvDir)
 {
     SymSrvLoadHelper::g_symSrvDir = symSrvDir;
@@ -415,6 +468,11 @@ public:
         NOT_IMPLEMENTED();
     }
 
+    virtual NAME_ID getNameId()
+    {
+        NOT_IMPLEMENTED();
+    }
+
     virtual std::wstring getScopeName()
     {
       NOT_IMPLEMENTED();
@@ -569,6 +627,10 @@ public:
         throw SymbolException(L"Source file not found");
     }
 
+    virtual void getLineTable(SymbolLineList &lines, std::vector<std::wstring> &fileNames) {
+        throw SymbolException(L"Source file not found");
+    }
+
     virtual std::wstring getSymbolFileName() {
         return L"no symbols";
     }
@@ -3,6 +3,8 @@
 
 #include <comutil.h>
 
+#include <map>
+
 #include <dbghelp.h>
 #pragma comment(lib, "dbghelp.lib")
 
@@ -184,6 +186,13 @@ DiaSymbol::DiaSymbol(const DiaSymbolPtr &_symbol, const std::wstring &_scope, Ma
 {
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+DiaSymbol::DiaSymbol(const DiaSymbolPtr &_symbol, const InternedName &_scope, MachineTypes machineType)
+    : m_symbol(_symbol), m_scope(_scope), m_machineType(machineType)
+{
+}
+
 //////////////////////////////////////////////////////////////////////////////////
 
 SymbolPtr DiaSymbol::fromGlobalScope( IDiaSymbol *_symbol, const std::wstring& _scope )
@@ -228,12 +237,22 @@ SymbolPtrList  DiaSymbol::findChildren(
     ULONG celt;
     while ( SUCCEEDED(symbols->Next(1, &child, &celt)) && (celt == 1) )
     {
-        SymbolPtr symbol( new DiaSymbol(child, m_scope, m_machineType) );
+        DiaSymbol  *diaSymbol = new DiaSymbol(child, m_scope, m_machineType);
+        SymbolPtr symbol( diaSymbol );
         child = NULL;
 
-        if ( name.empty() || 
-             ::SymMatchStringW(symbol->getName().c_str(), name.c_str(), caseSensitive) )
+        if ( name.empty() )
+        {
+            childList.push_back( symbol );
+            continue;
+        }
+
+        // the name is read for the match, the symbol keeps its id
+        const std::wstring  childName = diaSymbol->getName();
+
+        if ( ::SymMatchStringW(childName.c_str(), name.c_str(), caseSensitive) )
         {
+            diaSymbol->m_nameId.get( [&childName]() { return childName; } );
             childList.push_back( symbol );
         }
     }
@@ -511,6 +530,13 @@ ULONG DiaSymbol::getLocType()
 static const  boost::wregex  stdcallMatch(L"^_(\\w+)(@\\d+)?$");
 static const  boost::wregex  fastcallMatch(L"^@(\\w+)(@\\d+)?$");
 
+NAME_ID DiaSymbol::getNameId()
+{
+    return m_nameId.get( [this]() { return getName(); } );
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+
 std::wstring DiaSymbol::getName()
 {
     HRESULT hres;
@@ -561,7 +587,7 @@ std::wstring DiaSymbol::getName()
 
 std::wstring DiaSymbol::getScopeName()
 {
-  return m_scope;
+  return m_scope.str();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -923,6 +949,90 @@ void DiaSession::getSourceLine( ULONG64 offset, std::wstring &fileName, ULONG &l
     displacement = (LONG)( (LONGLONG)offset - (LONGLONG)va );
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+void DiaSession::getLineTable( SymbolLineList &lines, std::vector<std::wstring> &fileNames )
+{
+    // the line numbers table holds all the lines of the symbol file, no
+    // need to search them compiland by compiland
+    CComPtr< IDiaEnumTables >  tables;
+    HRESULT hres = m_session->getEnumTables( &tables );
+    if (S_OK != hres)
+        throw DiaException(L"Call IDiaSession::getEnumTables", hres);
+
+    DiaEnumLineNumbersPtr  lineNumbers;
+
+    while ( !lineNumbers )
+    {
+        CComPtr< IDiaTable >  table;
+        ULONG  fetched = 0;
+
+        hres = tables->Next( 1, &table, &fetched );
+        if (S_OK != hres || fetched != 1)
+            throw DiaException(L"the symbol file has no line numbers table");
+
+        table->QueryInterface( __uuidof(IDiaEnumLineNumbers), (void**)&lineNumbers );
+    }
+
+    LONG  count = 0;
+    if ( S_OK == lineNumbers->get_Count( &count ) && count > 0 )
+        lines.reserve( count );
+
+    std::map<DWORD, unsigned long>  fileIds;
+
+    const ULONG  batchSize = 256;
+    IDiaLineNumber  *batch[batchSize];
+    ULONG  fetched = 0;
+
+    do {
+
+        fetched = 0;
+        hres = lineNumbers->Next( batchSize, batch, &fetched );
+        if ( FAILED(hres) )
+            throw DiaException(L"Call IDiaEnumLineNumbers::Next", hres);
+
+        for ( ULONG i = 0; i < fetched; ++i )
+        {
+            DiaLineNumberPtr  lineNumber;
+            lineNumber.Attach( batch[i] );
+
+            SymbolLine  line = {};
+            DWORD  fileId = 0;
+
+            if ( S_OK != lineNumber->get_relativeVirtualAddress( &line.rva ) ||
+                 S_OK != lineNumber->get_length( &line.length ) ||
+                 S_OK != lineNumber->get_lineNumber( &line.lineNo ) ||
+                 S_OK != lineNumber->get_sourceFileId( &fileId ) )
+                    continue;
+
+            // compiler generated code has the hidden line number 0xFEEFEE
+            if ( line.lineNo == 0 || line.lineNo >= 0xF00000 )
+                continue;
+
+            if ( S_OK != lineNumber->get_columnNumber( &line.columnNo ) )
+                line.columnNo = 0;
+
+            std::map<DWORD, unsigned long>::iterator  it = fileIds.find( fileId );
+            if ( it == fileIds.end() )
+            {
+                DiaSourceFilePtr  sourceFile;
+                autoBstr  fileNameBstr;
+
+                if ( S_OK != lineNumber->get_sourceFile( &sourceFile ) ||
+                     S_OK != sourceFile->get_fileName( &fileNameBstr ) )
+                        continue;
+
+                it = fileIds.insert( std::make_pair( fileId, static_cast<unsigned long>( fileNames.size() ) ) ).first;
+                fileNames.push_back( std::wstring( _bstr_t(fileNameBstr, false) ) );
+            }
+
+            line.fileId = it->second;
+            lines.push_back( line );
+        }
+
+    } while ( hres == S_OK && fetched == batchSize );
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////
 
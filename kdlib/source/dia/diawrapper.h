@@ -57,6 +57,8 @@ class DiaSymbol : public Symbol {
 public:
     DiaSymbol(const  DiaSymbolPtr &_symbol, const std::wstring &_scope, MachineTypes machineType );
 
+    DiaSymbol(const  DiaSymbolPtr &_symbol, const InternedName &_scope, MachineTypes machineType );
+
     static SymbolPtr fromGlobalScope( IDiaSymbol *_symbol, const std::wstring &_scope );
 
     SymbolPtr getChildByName(const std::wstring &_name ) override;
@@ -76,6 +78,8 @@ public:
     std::wstring getName() override;
     std::wstring getScopeName() override;
 
+    NAME_ID getNameId() override;
+
     SymbolPtr getType() override;
 
     SymbolPtr getIndexType() override;
@@ -192,9 +196,11 @@ protected:
     }
 
     DiaSymbolPtr m_symbol;
-    std::wstring m_scope;
+    InternedName m_scope;               // shared by the symbols of the session
 
     MachineTypes m_machineType;
+
+    LazyInternedName m_nameId;
 };
 
 ////////////////////////////////////////////////////////////////////////////
@@ -218,6 +224,8 @@ public:
 
     virtual void getSourceLine( ULONG64 offset, std::wstring &fileName, ULONG &lineNo, LONG &displacement );
 
+    virtual void getLineTable( SymbolLineList &lines, std::vector<std::wstring> &fileNames );
+
     virtual std::wstring getSymbolFileName() {
         return m_symbolFileName;
     }
@@ -4,58 +4,26 @@
 #include <comutil.h>
 #include <DbgHelp.h>
 
+#include <sstream>
+
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/member.hpp>
 #include <boost/multi_index/ordered_index.hpp>
 #include <boost/multi_index/tag.hpp>
 
-#include <boost/algorithm/string/replace.hpp>
-#include <boost/regex.hpp>
-
 #include "kdlib/symengine.h"
 #include "kdlib/exceptions.h"
 #include "kdlib/memaccess.h"
+#include "kdlib/dbgengine.h"
+
+#include "fnmatch.h"
+#include "peimage.h"
 
 namespace bmi = boost::multi_index;
 
 ///////////////////////////////////////////////////////////////////////////////
 
-namespace {
-
-    
-    void escapeRegex(std::wstring &regex)
-    {
-        boost::replace_all(regex, L"\\", L"\\\\");
-        boost::replace_all(regex, L"^", L"\\^");
-        boost::replace_all(regex, L".", L"\\.");
-        boost::replace_all(regex, L"$", L"\\$");
-        boost::replace_all(regex, L"|", L"\\|");
-        boost::replace_all(regex, L"(", L"\\(");
-        boost::replace_all(regex, L")", L"\\)");
-        boost::replace_all(regex, L"[", L"\\[");
-        boost::replace_all(regex, L"]", L"\\]");
-        boost::replace_all(regex, L"*", L"\\*");
-        boost::replace_all(regex, L"+", L"\\+");
-        boost::replace_all(regex, L"?", L"\\?");
-        boost::replace_all(regex, L"/", L"\\/");
-    }
-
-    bool fnmatch(const std::wstring&  str, const std::wstring& match)
-    {
-        std::wstring  reStr = match;
-        escapeRegex(reStr);
-
-        boost::replace_all(reStr, L"\\?", L".");
-        boost::replace_all(reStr, L"\\*", L".*");
-
-        boost::wregex pattern(reStr, boost::regex::normal);
-
-        return boost::regex_match(str, pattern);
-    }
-}
-
-
 namespace kdlib {
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -138,6 +106,11 @@ class ExportSymbolBase : public Symbol
         NOT_IMPLEMENTED();
     }
 
+    virtual NAME_ID getNameId()
+    {
+        NOT_IMPLEMENTED();
+    }
+
     virtual std::wstring getScopeName()
     {
       NOT_IMPLEMENTED();
@@ -292,7 +265,12 @@ private:
 
     virtual std::wstring getName()
     {
-        return m_name;
+        return m_name.str();
+    }
+
+    virtual NAME_ID getNameId()
+    {
+        return m_name.getId();
     }
 
     virtual ULONG getRva()
@@ -311,7 +289,7 @@ private:
     }
 
 
-    std::wstring  m_name;
+    InternedName  m_name;
     ULONG  m_rva;
     ULONGLONG  m_moduleBase;
     MachineTypes m_machineType;
@@ -382,18 +360,11 @@ public:
         return m_storage.size();
     }
 
-    bool findByIndex(const size_t index, FunctionName& name, FunctionAddress& funcAddress) const
+    template<typename Visitor>
+    void forEach(Visitor visitor) const
     {
-        if (index >= size())
-            return false;
-
-        NameIndex::const_iterator it = GetNameIndex().begin();
-        std::advance(it, index);
-
-        name = (*it).Name;
-        funcAddress = (*it).Address;
-
-        return true;
+        for (NameIndex::const_iterator it = GetNameIndex().begin(); it != GetNameIndex().end(); ++it)
+            visitor((*it).Name, (*it).Address);
     }
 
 private:
@@ -462,9 +433,9 @@ class ExportSymbolDir : public ExportSymbolBase
 {
 public:
 
-    static ExportSymbolDirPtr getExportSymbolDir( ULONGLONG moduleBase )
+    static ExportSymbolDirPtr getExportSymbolDir( PeImageReader &reader, ULONGLONG moduleBase )
     {
-        return ExportSymbolDirPtr( new ExportSymbolDir(moduleBase) );
+        return ExportSymbolDirPtr( new ExportSymbolDir(reader, moduleBase) );
     }
 
     SymbolPtr findByRva( ULONG rva, ULONG symTag, LONG* displacement )
@@ -511,15 +482,16 @@ public:
 
         if (symTag == SymTagPublicSymbol)
         {
-            for (size_t i = 0; i < m_exportMap.size(); ++i)
-            {
-                std::wstring funcName;
-                ULONG address;
-                m_exportMap.findByIndex(i, funcName, address);
+            // '[' is literal in the export masks
+            GlobMatcher  matcher(mask, caseSensitive, false);
 
-                if (mask.empty() || mask == L"*" || fnmatch(funcName, mask) )
-                    symLst.push_back(SymbolPtr(new ExportSymbol(funcName, address, m_moduleBase, getMachineType())));
-            }
+            MachineTypes  machineType = getMachineType();
+
+            m_exportMap.forEach( [&](const std::wstring &funcName, ULONG address)
+            {
+                if (mask.empty() || matcher.match(funcName) )
+                    symLst.push_back(SymbolPtr(new ExportSymbol(funcName, address, m_moduleBase, machineType)));
+            } );
         }
 
         return symLst;
@@ -527,66 +499,55 @@ public:
 
 private:
 
-    ExportSymbolDir( ULONGLONG moduleBase )
+    ExportSymbolDir( PeImageReader &reader, ULONGLONG moduleBase )
     {
-        ULONG64  ntHeaderOffset = moduleBase + ptrDWord( moduleBase + 0x3c );
-
-        IMAGE_NT_HEADERS  ntHeaders;
-        readMemory( ntHeaderOffset, &ntHeaders, sizeof(ntHeaders) );
+        PeExportDirectory  exportDir;
+        readPeExports( reader, exportDir );
 
-        m_machineType = ntHeaders.FileHeader.Machine;
+        m_machineType = exportDir.machine;
 
         m_moduleBase = moduleBase;
 
-        if ( m_machineType == IMAGE_FILE_MACHINE_I386 ||
-             m_machineType == IMAGE_FILE_MACHINE_ARMNT )
+        if ( m_machineType != IMAGE_FILE_MACHINE_I386 &&
+             m_machineType != IMAGE_FILE_MACHINE_ARMNT &&
+             m_machineType != IMAGE_FILE_MACHINE_AMD64 &&
+             m_machineType != IMAGE_FILE_MACHINE_ARM64 )
         {
-            GetExport<IMAGE_NT_HEADERS32>( moduleBase );
-            return;
+            throw SymbolException( L"Unkonw machine type");
         }
-        
-        if ( m_machineType == IMAGE_FILE_MACHINE_AMD64 ||
-             m_machineType == IMAGE_FILE_MACHINE_ARM64 )
-        {
-            GetExport<IMAGE_NT_HEADERS64>( moduleBase );
-            return;
-        }
-
-        throw SymbolException( L"Unkonw machine type");
-    }
-
-    template<typename NTHEADERT>
-    void  GetExport( ULONG64 moduleBase )
-    {
-        ULONG64  ntHeaderOffset = moduleBase + ptrDWord( moduleBase + 0x3c );
-
-        NTHEADERT  ntHeader;
-        readMemory( ntHeaderOffset, &ntHeader, sizeof(ntHeader) );
-    
-        if ( ntHeader.OptionalHeader.DataDirectory[0].Size == 0 )
-            return;
 
-        ULONG64  exportDirOffset = moduleBase + ntHeader.OptionalHeader.DataDirectory[0].VirtualAddress;
+        std::vector<char> undecorBuffer(1000);
 
-        ULONG  namesCount = (ULONG) ptrDWord( exportDirOffset + 0x18 );
-        ULONG64  funcRvaOffset = moduleBase + ptrDWord( exportDirOffset + 0x1C );
-        ULONG64  namesOffset = moduleBase + ptrDWord( exportDirOffset + 0x20 ); 
-        ULONG64  ordinalsOffset = moduleBase + ptrDWord( exportDirOffset + 0x24 );
-
-        for ( ULONG i = 0; i < namesCount; ++i ) 
+        for ( std::vector<PeExport>::const_iterator it = exportDir.exports.begin(); it != exportDir.exports.end(); ++it )
         {
-            std::string  exportName = loadCStr( moduleBase + ptrDWord( namesOffset + 4 * i ) );
-            USHORT  exportOrdinal = (USHORT)ptrWord( ordinalsOffset + 2 * i );
-            ULONG rva = (ULONG)ptrDWord( funcRvaOffset + 4 * exportOrdinal );
+            // the RVA of a forwarded export is its forwarder string in the
+            // export directory, not code of this module
+            if ( !it->forwarder.empty() )
+                continue;
 
-            std::vector<char> undecorBuffer(1000);
-            DWORD  undecorLength = UnDecorateSymbolName(exportName.c_str(), &undecorBuffer[0], (DWORD)undecorBuffer.size(), UNDNAME_NAME_ONLY);
-            if (undecorLength > 0)
-                exportName = std::string(&undecorBuffer[0], undecorLength);
+            std::wstring  exportName;
 
-            std::wstring wideExportNamr = _bstr_t( exportName.c_str() );
+            if ( it->name.empty() )
+            {
+                std::wstringstream  sstr;
+                sstr << L"Ordinal" << it->ordinal;
+                exportName = sstr.str();
+            }
+            else if ( it->name[0] == '?' )
+            {
+                // only C++ names are decorated
+                DWORD  undecorLength = UnDecorateSymbolName(it->name.c_str(), &undecorBuffer[0], (DWORD)undecorBuffer.size(), UNDNAME_NAME_ONLY);
+                if (undecorLength > 0)
+                    exportName = _bstr_t( std::string(&undecorBuffer[0], undecorLength).c_str() );
+                else
+                    exportName = _bstr_t( it->name.c_str() );
+            }
+            else
+            {
+                exportName = _bstr_t( it->name.c_str() );
+            }
 
-            m_exportMap.add( wideExportNamr, rva );
+            m_exportMap.add( exportName, it->rva );
         }
     }
 
@@ -603,10 +564,10 @@ class ExportSession : public SymbolSession
 {
 public:
 
-    ExportSession( ULONGLONG moduleBase ) :
+    ExportSession( PeImageReader &reader, ULONGLONG moduleBase ) :
       m_moduleBase( moduleBase )
       {
-          m_exportDir = ExportSymbolDir::getExportSymbolDir(moduleBase);
+          m_exportDir = ExportSymbolDir::getExportSymbolDir(reader, moduleBase);
       }
 
     virtual SymbolPtr getSymbolScope() {
@@ -622,6 +583,11 @@ public:
         throw SymbolException( L"there is no source file" );
     }
 
+    virtual void getLineTable( SymbolLineList &lines, std::vector<std::wstring> &fileNames )
+    {
+        throw SymbolException( L"there is no source file" );
+    }
+
     virtual std::wstring getSymbolFileName() {
         return std::wstring(L"export symbols");
     }
@@ -637,7 +603,48 @@ private:
 
 SymbolSessionPtr loadSymbolFromExports(ULONGLONG loadBase)
 {
-    return SymbolSessionPtr( new ExportSession( loadBase ) );
+    PeImageReaderPtr  reader = getPeMemoryReader(loadBase);
+    return SymbolSessionPtr( new ExportSession( *reader, loadBase ) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// The headers of the loaded module can be paged out: the module list keeps
+// their TimeDateStamp and SizeOfImage
+
+bool isLoadedImage( PeImageReader &fileReader, ULONGLONG loadBase )
+{
+    PeImageId  fileId;
+    readPeImageId( fileReader, fileId );
+
+    PeImageId  loadedId;
+
+    try
+    {
+        readPeImageId( *getPeMemoryReader(loadBase), loadedId );
+    }
+    catch ( const DbgException& )
+    {
+        loadedId.timeDateStamp = getModuleTimeStamp(loadBase);
+        loadedId.imageSize = getModuleSize(loadBase);
+    }
+
+    return fileId == loadedId;
+}
+
+}
+
+SymbolSessionPtr loadSymbolFromExports(const std::wstring &imagePath, ULONGLONG loadBase)
+{
+    PeImageReaderPtr  reader = getPeFileReader(imagePath);
+
+    // another build of the image on the disk has other export RVAs
+    if ( !isLoadedImage( *reader, loadBase ) )
+        return loadSymbolFromExports(loadBase);
+
+    return SymbolSessionPtr( new ExportSession( *reader, loadBase ) );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
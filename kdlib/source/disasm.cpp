@@ -1,13 +1,19 @@
 #include "stdafx.h"
 
+#include <algorithm>
+
 #include <boost/regex.hpp>
 
 #include "kdlib/disasm.h"
 #include "kdlib/disasmengine.h"
 #include "kdlib/dbgengine.h"
 #include "kdlib/exceptions.h"
+#include "kdlib/instruction.h"
 #include "kdlib/memaccess.h"
 
+#include "codebuffer.h"
+#include "processmon.h"
+
 /////////////////////////////////////////////////////////////////////////////////
 
 namespace {
@@ -87,4 +93,194 @@ std::vector<unsigned char> Disasm::opcode() const
 
 /////////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+const size_t  MaxInstructionLength = 15;
+
+const MEMOFFSET_64  PageSize = 0x1000;
+
+InstructionListPtr decodeRange( MEMOFFSET_64 begin, MEMOFFSET_64 end, CPUType cpuMode )
+{
+    CodeBuffer  code( begin, end );
+
+    boost::shared_ptr<InstructionList>  instructions( new InstructionList() );
+
+    code.disassemble( begin, end, cpuMode, *instructions );
+
+    return instructions;
+}
+
+} // end nameless namespace
+
+/////////////////////////////////////////////////////////////////////////////////
+
+void checkDecoderMode( CPUType cpuMode )
+{
+    if ( cpuMode != CPU_I386 && cpuMode != CPU_AMD64 )
+        throw DbgException("the instruction decoder supports only x86 and AMD64");
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+CodeBuffer::CodeBuffer( MEMOFFSET_64 begin, MEMOFFSET_64 end ) :
+    m_begin( begin ),
+    m_end( end ),
+    m_buffer( static_cast<size_t>( end - begin ) + MaxInstructionLength - 1 )
+{
+    size_t  pos = 0;
+
+    while ( pos < m_buffer.size() )
+    {
+        unsigned long  readed = 0;
+
+        readMemoryUnsafe( m_begin + pos, &m_buffer[pos], m_buffer.size() - pos, false, &readed );
+
+        if ( readed > 0 )
+            m_parts.push_back( std::make_pair(pos, pos + readed) );
+
+        pos += readed;
+
+        if ( pos < m_buffer.size() )
+        {
+            MEMOFFSET_64  nextPage = ( m_begin + pos + PageSize ) & ~( PageSize - 1 );
+            pos = static_cast<size_t>( std::min<MEMOFFSET_64>( nextPage - m_begin, m_buffer.size() ) );
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+CodeBuffer::CodeBuffer( const void* buffer, size_t length, MEMOFFSET_64 begin ) :
+    m_begin( begin ),
+    m_end( begin + length ),
+    m_buffer( static_cast<const unsigned char*>( buffer ), static_cast<const unsigned char*>( buffer ) + length )
+{
+    m_parts.push_back( std::make_pair(size_t(0), length) );
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+const CodeBuffer::ReadPart* CodeBuffer::findPart( size_t pos ) const
+{
+    std::vector<ReadPart>::const_iterator  it = std::upper_bound( m_parts.begin(), m_parts.end(), std::make_pair(pos, ~size_t(0)) );
+
+    if ( it == m_parts.begin() )
+        return 0;
+
+    --it;
+
+    return pos < it->second ? &*it : 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool CodeBuffer::decode( MEMOFFSET_64 offset, CPUType cpuMode, Instruction &instruction ) const
+{
+    if ( offset < m_begin || offset >= m_end )
+        return false;
+
+    size_t  pos = static_cast<size_t>( offset - m_begin );
+
+    const ReadPart  *part = findPart( pos );
+    if ( !part )
+        return false;
+
+    return decodeInstruction( &m_buffer[pos], part->second - pos, offset, cpuMode, instruction );
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+void CodeBuffer::disassemble( MEMOFFSET_64 begin, MEMOFFSET_64 end, CPUType cpuMode, InstructionList &instructions ) const
+{
+    size_t  pos = static_cast<size_t>( std::max( begin, m_begin ) - m_begin );
+    size_t  size = static_cast<size_t>( std::min( end, m_end ) - m_begin );
+
+    // about 4 bytes per instruction in a compiled code
+    instructions.reserve( instructions.size() + ( size - std::min( pos, size ) ) / 4 + 1 );
+
+    for ( size_t i = 0; i < m_parts.size(); ++i )
+    {
+        pos = std::max( pos, m_parts[i].first );
+
+        while ( pos < m_parts[i].second && pos < size )
+        {
+            instructions.push_back( Instruction() );
+
+            Instruction  &instruction = instructions.back();
+
+            decodeInstruction( &m_buffer[pos], m_parts[i].second - pos, m_begin + pos, cpuMode, instruction );
+
+            pos += instruction.length;
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+Instruction decodeInstruction( MEMOFFSET_64 offset )
+{
+    offset = addr64(offset);
+
+    CPUType  cpuMode = getCPUMode();
+    checkDecoderMode( cpuMode );
+
+    unsigned char  buffer[MaxInstructionLength];
+    unsigned long  readed = 0;
+
+    // the instruction may end before a not readable page
+    readMemoryUnsafe( offset, buffer, sizeof(buffer), false, &readed );
+
+    if ( readed == 0 )
+        throw MemoryException( offset );
+
+    Instruction  instruction;
+    decodeInstruction( buffer, readed, offset, cpuMode, instruction );
+
+    return instruction;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+InstructionListPtr disassembleRange( MEMOFFSET_64 begin, MEMOFFSET_64 end )
+{
+    begin = addr64(begin);
+    end = addr64(end);
+
+    if ( end <= begin )
+        throw DbgException("invalid address range");
+
+    CPUType  cpuMode = getCPUMode();
+    checkDecoderMode( cpuMode );
+
+    MEMOFFSET_64  moduleBase = 0;
+
+    try
+    {
+        moduleBase = findModuleBase( begin );
+
+        if ( end > moduleBase + getModuleSize( moduleBase ) )
+            moduleBase = 0;
+    }
+    catch ( const DbgException& )
+    {
+        moduleBase = 0;
+    }
+
+    // a code out of the modules is not cached: it can be freed at any time
+    if ( moduleBase == 0 )
+        return decodeRange( begin, end, cpuMode );
+
+    InstructionListPtr  instructions = ProcessMonitor::getInstructions( moduleBase, begin, end, cpuMode );
+    if ( instructions )
+        return instructions;
+
+    instructions = decodeRange( begin, end, cpuMode );
+
+    ProcessMonitor::insertInstructions( moduleBase, begin, end, cpuMode, instructions );
+
+    return instructions;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
 }; // end kdlib namespace
\ No newline at end of file
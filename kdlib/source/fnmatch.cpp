@@ -1,43 +1,378 @@
 #include "stdafx.h"
 
-#include <boost/regex.hpp>
+#include <cctype>
+#include <cwctype>
+#include <algorithm>
 
+#include "fnmatch.h"
 
 /////////////////////////////////////////////////////////////////////////////////
 
 namespace kdlib {
 
+namespace {
 
-const boost::regex  r1("\\?");
-const boost::regex  r2("\\*");
-const boost::regex  r3("\\.");
+inline char foldChar( char ch )
+{
+    return static_cast<char>( std::tolower( static_cast<unsigned char>(ch) ) );
+}
 
-bool fnmatch( const std::string& pattern, const std::string& str)
+inline wchar_t foldChar( wchar_t ch )
 {
-    std::string mask = pattern;
-    mask = boost::regex_replace(mask, r1, ".");
-    mask = boost::regex_replace(mask, r2, ".*");
-    mask = boost::regex_replace(mask, r3, "\\.");
+    return static_cast<wchar_t>( std::towlower( ch ) );
+}
 
-    boost::smatch  matchResult;
-    boost::regex  regEx(mask);
-    return boost::regex_match(str, matchResult, regEx);
 }
 
-const boost::wregex  wr1(L"\\?");
-const boost::wregex  wr2(L"\\*");
-const boost::wregex  wr3(L"\\.");
+/////////////////////////////////////////////////////////////////////////////////
 
-bool fnmatch( const std::wstring& pattern, const std::wstring& str)
+template<typename CharT>
+BasicGlobMatcher<CharT>::BasicGlobMatcher( const StringT& pattern, bool caseSensitive, bool setClasses ) :
+    m_pattern( pattern ),
+    m_caseSensitive( caseSensitive ),
+    m_setClasses( setClasses ),
+    m_kind( MatchGeneric ),
+    m_headCount( 0 ),
+    m_tailCount( 0 )
+{
+    compile();
+    selectMatchKind();
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+template<typename CharT>
+void BasicGlobMatcher<CharT>::compile()
+{
+    for ( size_t pos = 0; pos < m_pattern.size(); )
+    {
+        Token  token = {};
+
+        switch( m_pattern[pos] )
+        {
+        case CharT('*'):
+            // "**" is the same as "*"
+            if ( m_tokens.empty() || m_tokens.back().type != TokenStar )
+            {
+                token.type = TokenStar;
+                m_tokens.push_back(token);
+            }
+            ++pos;
+            continue;
+
+        case CharT('?'):
+            token.type = TokenAny;
+            m_tokens.push_back(token);
+            ++pos;
+            continue;
+
+        case CharT('['):
+            if ( m_setClasses )
+            {
+                size_t  next = parseSet(pos);
+                if ( next != pos )
+                {
+                    pos = next;
+                    continue;
+                }
+            }
+            // no set classes or not closed set: take '[' as a literal char
+            break;
+        }
+
+        token.type = TokenChar;
+        token.ch = m_caseSensitive ? m_pattern[pos] : fold( m_pattern[pos] );
+        m_tokens.push_back(token);
+        ++pos;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+template<typename CharT>
+size_t BasicGlobMatcher<CharT>::parseSet( size_t pos )
 {
-    std::wstring mask = pattern;
-    mask = boost::regex_replace(mask, wr1, L".");
-    mask = boost::regex_replace(mask, wr2, L".*");
-    mask = boost::regex_replace(mask, wr3, L"\\.");
+    size_t  cur = pos + 1;
+
+    Token  token = {};
+    token.type = TokenSet;
+
+    if ( cur < m_pattern.size() && ( m_pattern[cur] == CharT('!') || m_pattern[cur] == CharT('^') ) )
+    {
+        token.negate = true;
+        ++cur;
+    }
+
+    token.setBegin = m_ranges.size();
+
+    bool  first = true;
+
+    for ( ; cur < m_pattern.size(); ++cur, first = false )
+    {
+        CharT  ch = m_pattern[cur];
+
+        if ( ch == CharT(']') && !first )
+        {
+            token.setEnd = m_ranges.size();
+            m_tokens.push_back(token);
+            return cur + 1;
+        }
+
+        CharT  last = ch;
+
+        if ( cur + 2 < m_pattern.size() && m_pattern[cur + 1] == CharT('-') && m_pattern[cur + 2] != CharT(']') )
+        {
+            last = m_pattern[cur + 2];
+            cur += 2;
+        }
+
+        if ( !m_caseSensitive )
+        {
+            ch = fold(ch);
+            last = fold(last);
+        }
+
+        m_ranges.push_back( CharRange( std::min(ch, last), std::max(ch, last) ) );
+    }
+
+    m_ranges.resize( token.setBegin );
+    return pos;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+template<typename CharT>
+void BasicGlobMatcher<CharT>::selectMatchKind()
+{
+    size_t  starCount = 0;
+    bool  onlyChars = true;
+
+    for ( size_t i = 0; i < m_tokens.size(); ++i )
+    {
+        if ( m_tokens[i].type == TokenStar )
+            ++starCount;
+        else if ( m_tokens[i].type != TokenChar )
+            onlyChars = false;
+    }
+
+    while ( m_headCount < m_tokens.size() && m_tokens[m_headCount].type != TokenStar )
+        ++m_headCount;
+
+    if ( starCount == 0 )
+    {
+        m_tailCount = 0;
+
+        if ( onlyChars )
+        {
+            m_kind = MatchExact;
+            for ( size_t i = 0; i < m_tokens.size(); ++i )
+                m_literal.push_back( m_tokens[i].ch );
+        }
+
+        return;
+    }
+
+    while ( m_tailCount < m_tokens.size() && m_tokens[m_tokens.size() - m_tailCount - 1].type != TokenStar )
+        ++m_tailCount;
+
+    if ( !onlyChars )
+        return;
+
+    if ( m_tokens.size() == 1 )
+    {
+        m_kind = MatchAll;
+        return;
+    }
+
+    if ( starCount == 1 && m_tailCount == 0 )
+    {
+        m_kind = MatchPrefix;
+        for ( size_t i = 0; i < m_headCount; ++i )
+            m_literal.push_back( m_tokens[i].ch );
+        return;
+    }
+
+    if ( starCount == 1 && m_headCount == 0 )
+    {
+        m_kind = MatchSuffix;
+        for ( size_t i = 1; i < m_tokens.size(); ++i )
+            m_literal.push_back( m_tokens[i].ch );
+        return;
+    }
+
+    if ( starCount == 2 && m_headCount == 0 && m_tailCount == 0 )
+    {
+        m_kind = MatchContains;
+        for ( size_t i = 1; i < m_tokens.size() - 1; ++i )
+            m_literal.push_back( m_tokens[i].ch );
+        return;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+template<typename CharT>
+CharT BasicGlobMatcher<CharT>::fold( CharT ch ) const
+{
+    return foldChar(ch);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
 
-    boost::wsmatch  matchResult;
-    boost::wregex  regEx(mask);
-    return boost::regex_match(str, matchResult, regEx);
+template<typename CharT>
+bool BasicGlobMatcher<CharT>::equalLiteral( const CharT* str ) const
+{
+    if ( m_caseSensitive )
+        return std::equal( m_literal.begin(), m_literal.end(), str );
+
+    for ( size_t i = 0; i < m_literal.size(); ++i )
+    {
+        if ( fold(str[i]) != m_literal[i] )
+            return false;
+    }
+
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+template<typename CharT>
+bool BasicGlobMatcher<CharT>::matchToken( const Token& token, CharT ch ) const
+{
+    if ( token.type == TokenAny )
+        return true;
+
+    if ( !m_caseSensitive )
+        ch = fold(ch);
+
+    if ( token.type == TokenChar )
+        return token.ch == ch;
+
+    bool  inSet = false;
+    for ( size_t i = token.setBegin; i < token.setEnd && !inSet; ++i )
+        inSet = m_ranges[i].first <= ch && ch <= m_ranges[i].second;
+
+    return inSet != token.negate;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+template<typename CharT>
+bool BasicGlobMatcher<CharT>::matchTokens( size_t tokenBegin, size_t tokenEnd, const CharT* str, size_t length ) const
+{
+    const size_t  npos = static_cast<size_t>(-1);
+
+    size_t  tokenPos = tokenBegin;
+    size_t  strPos = 0;
+    size_t  starToken = npos;
+    size_t  starStr = 0;
+
+    while ( strPos < length )
+    {
+        if ( tokenPos < tokenEnd && m_tokens[tokenPos].type == TokenStar )
+        {
+            starToken = tokenPos++;
+            starStr = strPos;
+            continue;
+        }
+
+        if ( tokenPos < tokenEnd && matchToken( m_tokens[tokenPos], str[strPos] ) )
+        {
+            ++tokenPos;
+            ++strPos;
+            continue;
+        }
+
+        if ( starToken == npos )
+            return false;
+
+        // let the last star eat one more char and retry
+        tokenPos = starToken + 1;
+        strPos = ++starStr;
+    }
+
+    while ( tokenPos < tokenEnd && m_tokens[tokenPos].type == TokenStar )
+        ++tokenPos;
+
+    return tokenPos == tokenEnd;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+template<typename CharT>
+bool BasicGlobMatcher<CharT>::match( const CharT* str, size_t length ) const
+{
+    switch ( m_kind )
+    {
+    case MatchAll:
+        return true;
+
+    case MatchExact:
+        return length == m_literal.size() && equalLiteral(str);
+
+    case MatchPrefix:
+        return length >= m_literal.size() && equalLiteral(str);
+
+    case MatchSuffix:
+        return length >= m_literal.size() && equalLiteral(str + length - m_literal.size());
+
+    case MatchContains:
+        if ( m_literal.size() > length )
+            return false;
+
+        for ( size_t i = 0; i + m_literal.size() <= length; ++i )
+        {
+            if ( equalLiteral(str + i) )
+                return true;
+        }
+        return false;
+
+    case MatchGeneric:
+        break;
+    }
+
+    if ( m_tailCount == 0 && m_headCount == m_tokens.size() )
+    {
+        // no stars: one token per char
+        if ( length != m_tokens.size() )
+            return false;
+
+        return matchTokens( 0, m_tokens.size(), str, length );
+    }
+
+    if ( length < m_headCount + m_tailCount )
+        return false;
+
+    for ( size_t i = 0; i < m_headCount; ++i )
+    {
+        if ( !matchToken( m_tokens[i], str[i] ) )
+            return false;
+    }
+
+    for ( size_t i = 0; i < m_tailCount; ++i )
+    {
+        if ( !matchToken( m_tokens[m_tokens.size() - m_tailCount + i], str[length - m_tailCount + i] ) )
+            return false;
+    }
+
+    return matchTokens( m_headCount, m_tokens.size() - m_tailCount, str + m_headCount, length - m_headCount - m_tailCount );
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+template class BasicGlobMatcher<char>;
+template class BasicGlobMatcher<wchar_t>;
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool fnmatch( const std::string& pattern, const std::string& str)
+{
+    return GlobMatcherA(pattern).match(str);
+}
+
+bool fnmatch( const std::wstring& pattern, const std::wstring& str)
+{
+    return GlobMatcher(pattern).match(str);
 }
 
 }
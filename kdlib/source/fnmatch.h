@@ -1,11 +1,102 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 namespace kdlib {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Glob mask ( '*', '?', '[set]' ) compiled once and matched against many names.
+// Plain literal, "lit*", "*lit" and "*lit*" masks are matched without
+// running the backtracking matcher at all.
+// With setClasses == false '[' and ']' are literal chars: export names like
+// "operator[]" are matched so, as the old regex based export mask did.
+
+template<typename CharT>
+class BasicGlobMatcher {
+
+public:
+
+    typedef std::basic_string<CharT>  StringT;
+
+    explicit BasicGlobMatcher( const StringT& pattern, bool caseSensitive = true, bool setClasses = true );
+
+    bool match( const StringT& str ) const {
+        return match( str.data(), str.size() );
+    }
+
+    bool match( const CharT* str, size_t length ) const;
+
+    const StringT& getPattern() const {
+        return m_pattern;
+    }
+
+    bool isCaseSensitive() const {
+        return m_caseSensitive;
+    }
+
+private:
+
+    enum TokenType {
+        TokenChar,
+        TokenAny,
+        TokenSet,
+        TokenStar
+    };
+
+    enum MatchKind {
+        MatchGeneric,
+        MatchExact,
+        MatchAll,
+        MatchPrefix,
+        MatchSuffix,
+        MatchContains
+    };
+
+    struct Token {
+        TokenType  type;
+        CharT  ch;
+        size_t  setBegin;
+        size_t  setEnd;
+        bool  negate;
+    };
+
+    typedef std::pair<CharT, CharT>  CharRange;
+
+    void compile();
+
+    size_t parseSet( size_t pos );
+
+    void selectMatchKind();
+
+    bool matchToken( const Token& token, CharT ch ) const;
+
+    bool matchTokens( size_t tokenBegin, size_t tokenEnd, const CharT* str, size_t length ) const;
+
+    bool equalLiteral( const CharT* str ) const;
+
+    CharT fold( CharT ch ) const;
+
+    StringT  m_pattern;
+    bool  m_caseSensitive;
+    bool  m_setClasses;
+
+    std::vector<Token>  m_tokens;
+    std::vector<CharRange>  m_ranges;
+
+    MatchKind  m_kind;
+    StringT  m_literal;
+
+    size_t  m_headCount;
+    size_t  m_tailCount;
+};
+
+typedef BasicGlobMatcher<char>  GlobMatcherA;
+typedef BasicGlobMatcher<wchar_t>  GlobMatcher;
+
+///////////////////////////////////////////////////////////////////////////////
+
 bool fnmatch( const std::string& pattern, const std::string& str);
 
 bool fnmatch( const std::wstring& pattern, const std::wstring& str);
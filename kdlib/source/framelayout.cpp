@@ -0,0 +1,238 @@
+#include "stdafx.h"
+
+#include "kdlib/exceptions.h"
+
+#include "framelayout.h"
+
+namespace kdlib {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::pair<MEMOFFSET_64, MEMOFFSET_64> getFuncDebugRange(const SymbolPtr& sym)
+{
+    try
+    {
+        SymbolPtrList  lstFuncDebugStart = sym->findChildren(SymTagFuncDebugStart);
+        if ( lstFuncDebugStart.empty() )
+            return std::make_pair(0, 0);
+
+        SymbolPtrList  lstFuncDebugEnd = sym->findChildren(SymTagFuncDebugEnd);
+        if ( lstFuncDebugEnd.empty() )
+            return std::make_pair(0, 0);
+
+        return std::make_pair( (*lstFuncDebugStart.begin())->getVa(), (*lstFuncDebugEnd.begin())->getVa());
+    }
+    catch (const SymbolException&)
+    {
+    }
+
+    return std::make_pair(0, 0);
+}
+
+bool inDebugRange( const std::pair<MEMOFFSET_64, MEMOFFSET_64>& range, MEMOFFSET_64 offset)
+{
+    return range.first <= offset && range.second >= offset;
+}
+
+FrameVariable makeFrameVariable(const SymbolPtr& sym, unsigned long dataKind)
+{
+    FrameVariable  var = {};
+
+    var.symbol = sym;
+    var.nameId = sym->getNameId();
+    var.dataKind = dataKind;
+    var.locType = sym->getLocType();
+
+    switch (var.locType)
+    {
+    case LocIsEnregistered:
+        var.registerId = sym->getRegisterId();
+        break;
+
+    case LocIsRegRel:
+        var.regRelativeId = sym->getRegRelativeId();
+        var.offset = sym->getOffset();
+        break;
+
+    case LocIsStatic:
+        var.va = sym->getVa();
+        break;
+    }
+
+    return var;
+}
+
+bool isNamed(const SymbolPtr& sym)
+{
+    return !sym->getName().empty();
+}
+
+FrameVariablesPtr makeFrameVariables(FrameVariableList& variables)
+{
+    return FrameVariablesPtr(new FrameVariables(variables));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // end nameless namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+FrameVariables::FrameVariables( FrameVariableList &variables )
+{
+    m_variables.swap(variables);
+
+    for (size_t i = 0; i < m_variables.size(); ++i)
+        m_nameIndex.insert(std::make_pair(m_variables[i].nameId, i));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const FrameVariable& FrameVariables::get( size_t index ) const
+{
+    if (index >= m_variables.size())
+        throw IndexException(static_cast<unsigned long>(index));
+
+    return m_variables[index];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const FrameVariable* FrameVariables::find( NAME_ID nameId ) const
+{
+    std::unordered_map<NAME_ID, size_t>::const_iterator  it = m_nameIndex.find(nameId);
+
+    return it != m_nameIndex.end() ? &m_variables[it->second] : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+FrameLayout::FrameLayout( MEMOFFSET_64 moduleBase, const SymbolPtr &function ) :
+    m_moduleBase(moduleBase),
+    m_functionRva(function->getRva()),
+    m_function(function),
+    m_debugRange(getFuncDebugRange(function))
+{
+    try
+    {
+        readBlocks(function, NoParentBlock);
+    }
+    catch (const SymbolException&)
+    {
+        // the variables of the function itself are still visible
+        m_blocks.clear();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FrameLayout::readBlocks( const SymbolPtr &symbol, size_t parent )
+{
+    SymbolPtrList  scopeList = symbol->findChildren(SymTagBlock);
+
+    for (SymbolPtrList::iterator itScope = scopeList.begin(); itScope != scopeList.end(); ++itScope)
+    {
+        FrameBlock  block;
+
+        MEMOFFSET_64  blockBegin = (*itScope)->getVa();
+        block.range = std::make_pair(blockBegin, blockBegin + (*itScope)->getSize());
+        block.parent = parent;
+
+        SymbolPtrList  symList = (*itScope)->findChildren(SymTagData);
+
+        for (SymbolPtrList::iterator it = symList.begin(); it != symList.end(); ++it)
+        {
+            unsigned long  dataKind = (*it)->getDataKind();
+
+            if (dataKind == DataIsLocal)
+                block.locals.push_back(makeFrameVariable(*it, dataKind));
+            else if (dataKind == DataIsStaticLocal && isNamed(*it))
+                block.statics.push_back(makeFrameVariable(*it, dataKind));
+        }
+
+        m_blocks.push_back(block);
+
+        readBlocks(*itScope, m_blocks.size() - 1);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+FrameScopePtr FrameLayout::getScope( MEMOFFSET_64 offset )
+{
+    {
+        boost::mutex::scoped_lock  lock(m_scopeLock);
+
+        std::map<MEMOFFSET_64, FrameScopePtr>::const_iterator  it = m_scopes.find(offset);
+        if (it != m_scopes.end())
+            return it->second;
+    }
+
+    FrameScopePtr  scope = selectScope(offset);
+
+    boost::mutex::scoped_lock  lock(m_scopeLock);
+    m_scopes.insert(std::make_pair(offset, scope));
+
+    return scope;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+FrameScopePtr FrameLayout::selectScope( MEMOFFSET_64 offset )
+{
+    FrameVariableList  params;
+    FrameVariableList  locals;
+    FrameVariableList  statics;
+
+    bool  inBody = inDebugRange(m_debugRange, offset);
+
+    // the variables of the function itself are asked by the offset: DIA tells
+    // the ones alive there
+    SymbolPtrList  symList = m_function->findChildrenByRVA(SymTagData, static_cast<MEMOFFSET_32>(offset - m_moduleBase));
+
+    for (SymbolPtrList::iterator it = symList.begin(); it != symList.end(); ++it)
+    {
+        unsigned long  dataKind = (*it)->getDataKind();
+
+        if (dataKind == DataIsParam || dataKind == DataIsObjectPtr)
+            params.push_back(makeFrameVariable(*it, dataKind));
+        else if (inBody && dataKind == DataIsLocal)
+            locals.push_back(makeFrameVariable(*it, dataKind));
+        else if (inBody && dataKind == DataIsStaticLocal && isNamed(*it))
+            statics.push_back(makeFrameVariable(*it, dataKind));
+    }
+
+    if (inBody)
+    {
+        std::vector<bool>  selected(m_blocks.size(), false);
+
+        for (size_t i = 0; i < m_blocks.size(); ++i)
+        {
+            const FrameBlock  &block = m_blocks[i];
+
+            if (block.parent != NoParentBlock && !selected[block.parent])
+                continue;
+
+            if (!inDebugRange(block.range, offset))
+                continue;
+
+            selected[i] = true;
+
+            locals.insert(locals.end(), block.locals.begin(), block.locals.end());
+            statics.insert(statics.end(), block.statics.begin(), block.statics.end());
+        }
+    }
+
+    boost::shared_ptr<FrameScope>  scope(new FrameScope());
+    scope->params = makeFrameVariables(params);
+    scope->locals = makeFrameVariables(locals);
+    scope->statics = makeFrameVariables(statics);
+
+    return scope;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include <unordered_map>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "kdlib/dbgtypedef.h"
+#include "kdlib/symengine.h"
+
+namespace kdlib {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// A variable of a function with its location read out of the symbol
+
+struct FrameVariable
+{
+    SymbolPtr  symbol;              // loads the type
+    NAME_ID  nameId;                // interned while the symbol is held
+    unsigned long  dataKind;
+    unsigned long  locType;
+    unsigned long  registerId;      // LocIsEnregistered
+    unsigned long  regRelativeId;   // LocIsRegRel
+    MEMOFFSET_REL  offset;          // LocIsRegRel
+    MEMOFFSET_64  va;               // LocIsStatic
+};
+
+typedef std::vector<FrameVariable>  FrameVariableList;
+
+// The variables of one kind visible at an instruction offset, indexed by name.
+// A name shadowed in an inner block is found by its first variable.
+
+class FrameVariables
+{
+public:
+
+    FrameVariables( FrameVariableList &variables );
+
+    size_t getCount() const {
+        return m_variables.size();
+    }
+
+    // throws IndexException
+    const FrameVariable& get( size_t index ) const;
+
+    // null if there is no variable with the name
+    const FrameVariable* find( NAME_ID nameId ) const;
+
+private:
+
+    FrameVariableList  m_variables;
+    std::unordered_map<NAME_ID, size_t>  m_nameIndex;
+};
+
+typedef boost::shared_ptr<const FrameVariables>  FrameVariablesPtr;
+
+struct FrameScope
+{
+    FrameVariablesPtr  params;
+    FrameVariablesPtr  locals;
+    FrameVariablesPtr  statics;
+};
+
+typedef boost::shared_ptr<const FrameScope>  FrameScopePtr;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The variables of a function by its lexical blocks. The blocks are read once
+// per function, the scope of an instruction offset is selected once per
+// offset: the frames of the same function share its layout.
+
+class FrameLayout
+{
+public:
+
+    FrameLayout( MEMOFFSET_64 moduleBase, const SymbolPtr &function );
+
+    MEMOFFSET_64 getModuleBase() const {
+        return m_moduleBase;
+    }
+
+    MEMOFFSET_32 getFunctionRva() const {
+        return m_functionRva;
+    }
+
+    // throws SymbolException if the function variables can not be read
+    FrameScopePtr getScope( MEMOFFSET_64 offset );
+
+private:
+
+    typedef std::pair<MEMOFFSET_64, MEMOFFSET_64>  DebugRange;
+
+    static const size_t  NoParentBlock = ~size_t(0);
+
+    struct FrameBlock
+    {
+        DebugRange  range;
+        size_t  parent;             // NoParentBlock for a block of the function
+        FrameVariableList  locals;
+        FrameVariableList  statics;
+    };
+
+    void readBlocks( const SymbolPtr &symbol, size_t parent );
+
+    FrameScopePtr selectScope( MEMOFFSET_64 offset );
+
+    MEMOFFSET_64  m_moduleBase;
+    MEMOFFSET_32  m_functionRva;
+    SymbolPtr  m_function;
+    DebugRange  m_debugRange;
+
+    // depth first: a block goes after its parent
+    std::vector<FrameBlock>  m_blocks;
+
+    boost::mutex  m_scopeLock;
+    std::map<MEMOFFSET_64, FrameScopePtr>  m_scopes;
+};
+
+typedef boost::shared_ptr<FrameLayout>  FrameLayoutPtr;
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
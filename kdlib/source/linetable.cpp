@@ -0,0 +1,279 @@
+#include "stdafx.h"
+
+#include <algorithm>
+#include <cwctype>
+#include <unordered_map>
+
+#include "kdlib/linetable.h"
+#include "kdlib/exceptions.h"
+
+namespace kdlib {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::wstring normalizeFileName( const std::wstring &fileName )
+{
+    std::wstring  normalized( fileName );
+
+    for ( std::wstring::iterator it = normalized.begin(); it != normalized.end(); ++it )
+        *it = *it == L'/' ? L'\\' : static_cast<wchar_t>( std::towlower(*it) );
+
+    return normalized;
+}
+
+std::wstring getBaseName( const std::wstring &fileName )
+{
+    std::wstring::size_type  pos = fileName.rfind( L'\\' );
+    return pos == std::wstring::npos ? fileName : fileName.substr( pos + 1 );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct LineRvaLess {
+    bool operator()( const SymbolLine &line1, const SymbolLine &line2 ) const {
+        if ( line1.rva != line2.rva )
+            return line1.rva < line2.rva;
+        return line1.length < line2.length;
+    }
+};
+
+struct LineRvaUpperBound {
+    bool operator()( MEMOFFSET_32 rva, const SymbolLine &line ) const {
+        return rva < line.rva;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class SourceLineTableImpl : public SourceLineTable
+{
+public:
+
+    SourceLineTableImpl( const SymbolSessionPtr &session, MEMOFFSET_64 loadBase ) :
+        m_loadBase( loadBase )
+    {
+        session->getLineTable( m_lines, m_fileNames );
+
+        m_lines.erase( std::remove_if( m_lines.begin(), m_lines.end(), BadFileId(m_fileNames.size()) ), m_lines.end() );
+
+        std::sort( m_lines.begin(), m_lines.end(), LineRvaLess() );
+
+        m_normalizedNames.reserve( m_fileNames.size() );
+        for ( unsigned long i = 0; i < m_fileNames.size(); ++i )
+        {
+            m_normalizedNames.push_back( normalizeFileName( m_fileNames[i] ) );
+            m_baseNames[ getBaseName( m_normalizedNames.back() ) ].push_back( i );
+        }
+
+        m_fileLines.resize( m_fileNames.size() );
+        for ( size_t i = 0; i < m_lines.size(); ++i )
+            m_fileLines[ m_lines[i].fileId ].push_back( i );
+
+        // lines are sorted by the address, so the stable sort keeps it for each line number
+        for ( size_t i = 0; i < m_fileLines.size(); ++i )
+            std::stable_sort( m_fileLines[i].begin(), m_fileLines[i].end(), FileLineLess(m_lines) );
+    }
+
+    virtual SourceLineInfo findLine( MEMOFFSET_64 offset )
+    {
+        const SymbolLine  *line = lookup( offset );
+        if ( !line )
+            throw SymbolException( L"failed to find source line" );
+
+        return makeLineInfo( *line );
+    }
+
+    virtual SourceLineList findLines( const std::vector<MEMOFFSET_64> &offsets )
+    {
+        SourceLineList  lines;
+        lines.reserve( offsets.size() );
+
+        for ( std::vector<MEMOFFSET_64>::const_iterator it = offsets.begin(); it != offsets.end(); ++it )
+        {
+            const SymbolLine  *line = lookup( *it );
+            if ( line )
+            {
+                lines.push_back( makeLineInfo( *line ) );
+            }
+            else
+            {
+                SourceLineInfo  noLine = { std::wstring(), 0, 0, 0, 0 };
+                lines.push_back( noLine );
+            }
+        }
+
+        return lines;
+    }
+
+    virtual SourceLineList findLineOffsets( const std::wstring &fileName, unsigned long lineNo )
+    {
+        const std::wstring  name = normalizeFileName( fileName );
+
+        SourceLineList  lines;
+
+        BaseNameIndex::const_iterator  baseIt = m_baseNames.find( getBaseName(name) );
+        if ( baseIt == m_baseNames.end() )
+            return lines;
+
+        const std::vector<unsigned long>  &fileIds = baseIt->second;
+
+        for ( std::vector<unsigned long>::const_iterator it = fileIds.begin(); it != fileIds.end(); ++it )
+        {
+            if ( !isFileNameMatch( m_normalizedNames[*it], name ) )
+                continue;
+
+            const std::vector<size_t>  &fileLines = m_fileLines[*it];
+
+            std::vector<size_t>::const_iterator  lineIt =
+                std::lower_bound( fileLines.begin(), fileLines.end(), lineNo, FileLineNoLess(m_lines) );
+
+            if ( lineIt == fileLines.end() )
+                continue;
+
+            // no code for the line: the next line with code
+            unsigned long  foundLineNo = m_lines[*lineIt].lineNo;
+
+            for ( ; lineIt != fileLines.end() && m_lines[*lineIt].lineNo == foundLineNo; ++lineIt )
+                lines.push_back( makeLineInfo( m_lines[*lineIt] ) );
+        }
+
+        std::sort( lines.begin(), lines.end(), LineInfoOffsetLess() );
+
+        return lines;
+    }
+
+    virtual std::vector<std::wstring> getSourceFiles()
+    {
+        return m_fileNames;
+    }
+
+    virtual size_t getLineCount()
+    {
+        return m_lines.size();
+    }
+
+private:
+
+    struct BadFileId {
+
+        BadFileId( size_t fileCount ) :
+            m_fileCount( fileCount )
+            {}
+
+        bool operator()( const SymbolLine &line ) const {
+            return line.fileId >= m_fileCount;
+        }
+
+        size_t  m_fileCount;
+    };
+
+    struct FileLineLess {
+
+        FileLineLess( const SymbolLineList &lines ) :
+            m_lines( lines )
+            {}
+
+        bool operator()( size_t index1, size_t index2 ) const {
+            return m_lines[index1].lineNo < m_lines[index2].lineNo;
+        }
+
+        const SymbolLineList  &m_lines;
+    };
+
+    struct FileLineNoLess {
+
+        FileLineNoLess( const SymbolLineList &lines ) :
+            m_lines( lines )
+            {}
+
+        bool operator()( size_t index, unsigned long lineNo ) const {
+            return m_lines[index].lineNo < lineNo;
+        }
+
+        const SymbolLineList  &m_lines;
+    };
+
+    struct LineInfoOffsetLess {
+        bool operator()( const SourceLineInfo &line1, const SourceLineInfo &line2 ) const {
+            return line1.offset < line2.offset;
+        }
+    };
+
+    const SymbolLine* lookup( MEMOFFSET_64 offset ) const
+    {
+        if ( offset < m_loadBase || offset - m_loadBase > 0xFFFFFFFF )
+            return NULL;
+
+        MEMOFFSET_32  rva = static_cast<MEMOFFSET_32>( offset - m_loadBase );
+
+        SymbolLineList::const_iterator  it = std::upper_bound( m_lines.begin(), m_lines.end(), rva, LineRvaUpperBound() );
+        if ( it == m_lines.begin() )
+            return NULL;
+
+        --it;
+
+        if ( rva != it->rva && rva - it->rva >= it->length )
+            return NULL;
+
+        return &*it;
+    }
+
+    SourceLineInfo makeLineInfo( const SymbolLine &line ) const
+    {
+        SourceLineInfo  lineInfo;
+        lineInfo.fileName = m_fileNames[line.fileId];
+        lineInfo.lineNo = line.lineNo;
+        lineInfo.columnNo = line.columnNo;
+        lineInfo.offset = m_loadBase + line.rva;
+        lineInfo.length = line.length;
+        return lineInfo;
+    }
+
+    static bool isFileNameMatch( const std::wstring &fullName, const std::wstring &name )
+    {
+        if ( fullName.size() < name.size() )
+            return false;
+
+        if ( fullName.compare( fullName.size() - name.size(), name.size(), name ) != 0 )
+            return false;
+
+        return fullName.size() == name.size() || fullName[ fullName.size() - name.size() - 1 ] == L'\\';
+    }
+
+    typedef std::unordered_map< std::wstring, std::vector<unsigned long> >  BaseNameIndex;
+
+    MEMOFFSET_64  m_loadBase;
+
+    SymbolLineList  m_lines;
+    std::vector<std::wstring>  m_fileNames;
+    std::vector<std::wstring>  m_normalizedNames;
+    std::vector< std::vector<size_t> >  m_fileLines;
+    BaseNameIndex  m_baseNames;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // end nameless namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SymbolSession::getLineTable( SymbolLineList &lines, std::vector<std::wstring> &fileNames )
+{
+    NOT_IMPLEMENTED();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SourceLineTablePtr getSourceLineTable( const SymbolSessionPtr &session, MEMOFFSET_64 loadBase )
+{
+    if ( !session )
+        throw SymbolException( L"there is no symbol session" );
+
+    return SourceLineTablePtr( new SourceLineTableImpl( session, loadBase ) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
@@ -2,12 +2,15 @@
 
 #include <set>
 #include <regex>
+#include <algorithm>
 
 #include "kdlib/memaccess.h"
 #include "kdlib/exceptions.h"
+#include "kdlib/symcache.h"
 
 #include "moduleimp.h"
 #include "processmon.h"
+#include "sympreloadimpl.h"
 #include "typeinfoimp.h"
 
 namespace kdlib {
@@ -69,11 +72,69 @@ ModulePtr loadModule( MEMOFFSET_64 offset )
 
 ///////////////////////////////////////////////////////////////////////////////
 
+SourceLineList getSourceLines( const std::vector<MEMOFFSET_64> &offsets )
+{
+    const SourceLineInfo  noLine = { std::wstring(), 0, 0, 0, 0 };
+
+    SourceLineList  lines( offsets.size(), noLine );
+
+    std::vector< std::pair<MEMOFFSET_64, size_t> >  sorted;
+    sorted.reserve( offsets.size() );
+
+    for ( size_t i = 0; i < offsets.size(); ++i )
+        sorted.push_back( std::make_pair( addr64(offsets[i]), i ) );
+
+    std::sort( sorted.begin(), sorted.end() );
+
+    // one batch for each module
+    for ( size_t i = 0; i < sorted.size(); )
+    {
+        ModulePtr  module;
+
+        try
+        {
+            module = loadModule( sorted[i].first );
+        }
+        catch( const DbgException& )
+        {
+            ++i;
+            continue;
+        }
+
+        std::vector<MEMOFFSET_64>  moduleOffsets;
+        size_t  first = i;
+
+        for ( ; i < sorted.size() && sorted[i].first >= module->getBase() && sorted[i].first < module->getEnd(); ++i )
+            moduleOffsets.push_back( sorted[i].first );
+
+        if ( moduleOffsets.empty() )
+        {
+            ++i;
+            continue;
+        }
+
+        try
+        {
+            SourceLineList  moduleLines = module->getSourceLines( moduleOffsets );
+
+            for ( size_t j = 0; j < moduleLines.size(); ++j )
+                lines[ sorted[first + j].second ] = moduleLines[j];
+        }
+        catch( const DbgException& )
+        {}
+    }
+
+    return lines;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 ModuleImp::ModuleImp(MEMOFFSET_64 offset )
 {
     m_base = findModuleBase( addr64(offset) );
     m_name = getModuleName( m_base );
     m_noSymbols = true;
+    m_noLineTable = false;
     fillFields();
 }
 
@@ -152,10 +213,24 @@ SymbolSessionPtr& ModuleImp::getSymSession()
     m_exportSymbols = false;
     m_noSymbols = false;
 
+    SymbolSessionPtr  preloadedSession;
+    bool  preloaded = takePreloadedSymbols( m_base, m_imageName, preloadedSession );
+
+    if ( preloaded )
+    {
+        m_symSession = getCachingSymbolSession( preloadedSession );
+        if (m_symSession)
+        {
+            return m_symSession;
+        }
+    }
 
     try
     {
-        m_symSession = loadSymbolFile( m_base, m_imageName);
+        // the preload has already failed to load the symbols this way
+        if ( !preloaded )
+            m_symSession = getCachingSymbolSession( loadSymbolFile( m_base, m_imageName) );
+
         if (m_symSession)
         {
             return m_symSession;
@@ -169,7 +244,7 @@ SymbolSessionPtr& ModuleImp::getSymSession()
         std::wstring symfile = getModuleSymbolFileName(m_base);
         if (!symfile.empty() )
         {
-            m_symSession = loadSymbolFile(symfile, m_base);
+            m_symSession = getCachingSymbolSession( loadSymbolFile(symfile, m_base) );
         }
 
         if (m_symSession)
@@ -192,6 +267,22 @@ SymbolSessionPtr& ModuleImp::getSymSession()
     catch(const DbgException&)
     {}
 
+    try
+    {
+        // export directory can be paged out in a dump: try the image file
+        if (!m_imageName.empty())
+        {
+            m_symSession = loadSymbolFromExports(m_imageName, m_base);
+            if (m_symSession)
+            {
+                m_exportSymbols = true;
+                return m_symSession;
+            }
+        }
+    }
+    catch(const DbgException&)
+    {}
+
     m_noSymbols = true;
     m_symSession = loadNoSymbolSession();
 
@@ -218,6 +309,8 @@ std::wstring ModuleImp::getSymFile()
 void ModuleImp::reloadSymbols()
 {
     m_symSession.reset();
+    m_lineTable.reset();
+    m_noLineTable = false;
     getSymSession();
 }
 
@@ -442,10 +535,12 @@ TypedVarPtr ModuleImp::getTypedVarWithPrototype( const std::wstring &symName, co
 
     SymbolPtrList  functions = getSymbolScope()->findChildren(SymTagFunction);
 
+    const InternedName  internedName(symName);
+
     for ( SymbolPtrList::iterator  it = functions.begin(); it != functions.end(); ++it )
     {
         SymbolPtr  sym = *it;
-        if ( sym->getName() == symName  )
+        if ( sym->getNameId() == internedName.getId() )
         {
             TypeInfoPtr  funcType = loadType(sym->getType());
             if ( isPrototypeMatch( funcType, prototype ) )
@@ -560,7 +655,98 @@ void ModuleImp::getSourceLine( MEMOFFSET_64 offset, std::wstring &fileName, unsi
     if ( !inRange(offset) )
         throw SymbolException(L"offset dont has to module");
 
-    getSymSession()->getSourceLine( offset, fileName, lineno, displacement );
+    // a single lookup does not build the line table: it is used once the
+    // batch lookups have built it
+    if ( !m_lineTable )
+    {
+        getSymSession()->getSourceLine( offset, fileName, lineno, displacement );
+        return;
+    }
+
+    SourceLineInfo  line = m_lineTable->findLine( offset );
+
+    fileName = line.fileName;
+    lineno = line.lineNo;
+    displacement = static_cast<long>( offset - line.offset );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SourceLineList ModuleImp::getSourceLines( const std::vector<MEMOFFSET_64> &offsets )
+{
+    std::vector<MEMOFFSET_64>  offsets64;
+    offsets64.reserve( offsets.size() );
+
+    for ( std::vector<MEMOFFSET_64>::const_iterator it = offsets.begin(); it != offsets.end(); ++it )
+        offsets64.push_back( addr64(*it) );
+
+    SourceLineTablePtr  lineTable = getLineTable();
+    if ( lineTable )
+        return lineTable->findLines( offsets64 );
+
+    // the symbols have no line table, ask the session line by line
+    SourceLineList  lines;
+    lines.reserve( offsets64.size() );
+
+    for ( std::vector<MEMOFFSET_64>::const_iterator it = offsets64.begin(); it != offsets64.end(); ++it )
+    {
+        SourceLineInfo  line = { std::wstring(), 0, 0, 0, 0 };
+
+        try
+        {
+            long  displacement = 0;
+
+            if ( inRange(*it) )
+            {
+                getSymSession()->getSourceLine( *it, line.fileName, line.lineNo, displacement );
+                line.offset = *it - displacement;
+            }
+        }
+        catch( const SymbolException& )
+        {
+            line.fileName.clear();
+            line.lineNo = 0;
+        }
+
+        lines.push_back( line );
+    }
+
+    return lines;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SourceLineList ModuleImp::getSourceLineOffsets( const std::wstring &fileName, unsigned long lineNo )
+{
+    SourceLineTablePtr  lineTable = getLineTable();
+    if ( !lineTable )
+        throw SymbolException( L"the module symbols have no line numbers" );
+
+    return lineTable->findLineOffsets( fileName, lineNo );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SourceLineTablePtr ModuleImp::getLineTable()
+{
+    if ( m_lineTable || m_noLineTable )
+        return m_lineTable;
+
+    try
+    {
+        m_lineTable = getSourceLineTable( getSymSession(), m_base );
+    }
+    catch( const SymbolException& )
+    {
+        m_noLineTable = true;
+    }
+    catch( const ImplementException& )
+    {
+        // the session of an external symbol provider
+        m_noLineTable = true;
+    }
+
+    return m_lineTable;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
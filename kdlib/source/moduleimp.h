@@ -222,6 +222,16 @@ protected:
         NOT_IMPLEMENTED();
     }
 
+    virtual SourceLineList getSourceLines( const std::vector<MEMOFFSET_64> &offsets )
+    {
+        NOT_IMPLEMENTED();
+    }
+
+    virtual SourceLineList getSourceLineOffsets( const std::wstring &fileName, unsigned long lineNo )
+    {
+        NOT_IMPLEMENTED();
+    }
+
     virtual std::string getVersionInfo( const std::string &value )
     {
         NOT_IMPLEMENTED();
@@ -353,6 +363,10 @@ protected:
 
     void getSourceLine( MEMOFFSET_64 offset, std::wstring &fileName, unsigned long &lineno, long &displacement );
 
+    SourceLineList getSourceLines( const std::vector<MEMOFFSET_64> &offsets );
+
+    SourceLineList getSourceLineOffsets( const std::wstring &fileName, unsigned long lineNo );
+
     std::string getVersionInfo( const std::string &value );
 
     void getFileVersion(unsigned long& majorVersion, unsigned long& minorVerion, unsigned long& revision, unsigned long& build);
@@ -367,6 +381,8 @@ protected:
 
     SymbolSessionPtr& getSymSession();
 
+    SourceLineTablePtr getLineTable();
+
     bool inRange(MEMOFFSET_64 offset) const {
         return (offset >= m_base) && (offset < (m_base + m_size));
     }
@@ -384,6 +400,8 @@ protected:
     unsigned long  m_timeDataStamp;
     unsigned long  m_checkSum;
     SymbolSessionPtr  m_symSession;
+    SourceLineTablePtr  m_lineTable;
+    bool m_noLineTable;
     bool m_isUnloaded;
     bool m_isUserMode;
     bool m_exportSymbols;
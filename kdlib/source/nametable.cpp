@@ -0,0 +1,265 @@
+#include "stdafx.h"
+
+#include <deque>
+#include <vector>
+#include <unordered_map>
+
+#include <boost/functional/hash.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/atomic.hpp>
+
+#include "kdlib/nametable.h"
+#include "kdlib/exceptions.h"
+
+namespace kdlib {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct NameViewHash
+{
+    size_t operator()( const boost::wstring_view &name ) const
+    {
+        return boost::hash_range( name.begin(), name.end() );
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class NameTable
+{
+public:
+
+    NameTable()
+    {
+        m_names.emplace_back();
+        m_index.insert( std::make_pair( boost::wstring_view( m_names.back().name ), EmptyNameId ) );
+    }
+
+    NAME_ID intern( const std::wstring &name )
+    {
+        NAME_ID  nameId;
+        if ( find( name, nameId ) )
+            return nameId;
+
+        boost::unique_lock<boost::shared_mutex>  writeLock(m_lock);
+
+        NameIndex::const_iterator  it = m_index.find( boost::wstring_view(name) );
+        if ( it != m_index.end() )
+        {
+            addRef( it->second );
+            return it->second;
+        }
+
+        if ( m_freeIds.empty() )
+        {
+            nameId = static_cast<NAME_ID>( m_names.size() );
+            m_names.emplace_back();
+        }
+        else
+        {
+            nameId = m_freeIds.back();
+            m_freeIds.pop_back();
+        }
+
+        // std::deque::emplace_back does not move already stored entries, so
+        // the views used as keys stay valid
+        NameEntry  &entry = m_names[nameId];
+        entry.name = name;
+        entry.refCount = 1;
+        entry.released = false;
+
+        m_index.insert( std::make_pair( boost::wstring_view( entry.name ), nameId ) );
+
+        return nameId;
+    }
+
+    bool find( const std::wstring &name, NAME_ID &nameId )
+    {
+        boost::shared_lock<boost::shared_mutex>  readLock(m_lock);
+
+        NameIndex::const_iterator  it = m_index.find( boost::wstring_view(name) );
+        if ( it == m_index.end() )
+            return false;
+
+        nameId = it->second;
+        addRef( nameId );
+        return true;
+    }
+
+    void acquire( NAME_ID nameId )
+    {
+        if ( nameId == EmptyNameId )
+            return;
+
+        boost::shared_lock<boost::shared_mutex>  readLock(m_lock);
+
+        addRef( nameId );
+    }
+
+    // called by the destructors of the name holders, it does not throw
+    void release( NAME_ID nameId )
+    {
+        if ( nameId == EmptyNameId )
+            return;
+
+        {
+            boost::shared_lock<boost::shared_mutex>  readLock(m_lock);
+
+            if ( nameId >= m_names.size() )
+                return;
+
+            if ( --m_names[nameId].refCount != 0 )
+                return;
+        }
+
+        boost::unique_lock<boost::shared_mutex>  writeLock(m_lock);
+
+        // the name could be found again or already be removed by another
+        // thread while the lock was not held
+        NameEntry  &entry = m_names[nameId];
+        if ( entry.refCount != 0 || entry.released )
+            return;
+
+        m_index.erase( boost::wstring_view( entry.name ) );
+
+        std::wstring().swap( entry.name );
+        entry.released = true;
+
+        m_freeIds.push_back( nameId );
+    }
+
+    const std::wstring& get( NAME_ID nameId ) const
+    {
+        boost::shared_lock<boost::shared_mutex>  readLock(m_lock);
+
+        if ( nameId >= m_names.size() || m_names[nameId].released )
+            throw IndexException( nameId );
+
+        return m_names[nameId].name;
+    }
+
+    NameTableStats getStats() const
+    {
+        boost::shared_lock<boost::shared_mutex>  readLock(m_lock);
+
+        NameTableStats  stats = {};
+
+        stats.nameCount = m_index.size();
+
+        for ( std::deque<NameEntry>::const_iterator it = m_names.begin(); it != m_names.end(); ++it )
+        {
+            stats.charCount += it->name.size();
+            stats.memoryUsage += sizeof(NameEntry);
+            if ( !it->released )
+                stats.memoryUsage += ( it->name.capacity() + 1 ) * sizeof(wchar_t);
+        }
+
+        stats.memoryUsage += m_freeIds.capacity() * sizeof(NAME_ID);
+
+        // rough estimation of the hashed index: one node per name plus the bucket array
+        stats.memoryUsage += m_index.size() * ( sizeof(NameIndex::value_type) + 2 * sizeof(void*) );
+        stats.memoryUsage += m_index.bucket_count() * sizeof(void*);
+
+        return stats;
+    }
+
+private:
+
+    struct NameEntry
+    {
+        NameEntry() :
+            refCount( 0 ),
+            released( false )
+            {}
+
+        std::wstring  name;
+        boost::atomic<long>  refCount;
+        bool  released;         // the id is in the free list
+    };
+
+    typedef std::unordered_map<boost::wstring_view, NAME_ID, NameViewHash>  NameIndex;
+
+    // a reader lock is held: the deque is not grown meanwhile
+    void addRef( NAME_ID nameId )
+    {
+        if ( nameId >= m_names.size() )
+            throw IndexException( nameId );
+
+        ++m_names[nameId].refCount;
+    }
+
+    std::deque<NameEntry>  m_names;
+    std::vector<NAME_ID>  m_freeIds;
+    NameIndex  m_index;
+
+    mutable boost::shared_mutex  m_lock;
+};
+
+// the table is never destroyed: the static objects holding names can release
+// them at exit in any order
+
+NameTable& getNameTable()
+{
+    static NameTable  *nameTable = new NameTable();
+    return *nameTable;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // end nameless namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+NAME_ID internName( const std::wstring &name )
+{
+    return getNameTable().intern(name);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool findNameId( const std::wstring &name, NAME_ID &nameId )
+{
+    return getNameTable().find(name, nameId);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void addNameRef( NAME_ID nameId )
+{
+    getNameTable().acquire(nameId);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void releaseName( NAME_ID nameId )
+{
+    getNameTable().release(nameId);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const std::wstring& getInternedName( NAME_ID nameId )
+{
+    return getNameTable().get(nameId);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+boost::wstring_view getInternedNameView( NAME_ID nameId )
+{
+    return boost::wstring_view( getNameTable().get(nameId) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+NameTableStats getNameTableStats()
+{
+    return getNameTable().getStats();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
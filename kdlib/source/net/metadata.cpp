@@ -1,39 +1,13 @@
 #include "stdafx.h"
 
 #include <boost/make_shared.hpp>
-#include <boost/regex.hpp>
 
 #include <metahost.h>
 
 #include "net/metadata.h"
 #include "net/nettype.h"
 
-
-///////////////////////////////////////////////////////////////////////////////
-
-namespace {
-
-///////////////////////////////////////////////////////////////////////////////
-
-const boost::wregex  r1(L"\\?");
-const boost::wregex  r2(L"\\*");
-const boost::wregex  r3(L"\\.");
-
-bool fnmatch( const std::wstring& pattern, const std::wstring& str)
-{
-    std::wstring mask = pattern;
-    mask = boost::regex_replace(mask, r1, L".");
-    mask = boost::regex_replace(mask, r2, L".*");
-    mask = boost::regex_replace(mask, r3, L"\\.");
-
-    boost::wsmatch  matchResult;
-    boost::wregex  regEx(mask);
-    return boost::regex_match(str, matchResult, regEx);
-}
-
-///////////////////////////////////////////////////////////////////////////////
-
-}
+#include "fnmatch.h"
 
 namespace kdlib {
 
@@ -261,6 +235,8 @@ TypeNameList  MetaDataProvider::getTypeNames(const std::wstring& mask)
     HCORENUM  enumTypeDefs = NULL;
     TypeNameList  typeList;
 
+    GlobMatcher  matcher(mask);
+
     auto enumCloseFn = [=](HCORENUM*){ if ( enumTypeDefs ) m_metaDataImport->CloseEnum(enumTypeDefs); };
     std::unique_ptr<HCORENUM, decltype(enumCloseFn)>  enumCloser(&enumTypeDefs, enumCloseFn);
 
@@ -278,7 +254,7 @@ TypeNameList  MetaDataProvider::getTypeNames(const std::wstring& mask)
 
         std::wstring  typeName = getTypeNameByToken(typeDef);
 
-        if ( mask.empty() || fnmatch(mask, typeName) )
+        if ( mask.empty() || matcher.match(typeName) )
             typeList.push_back(typeName);
     } 
 
@@ -10,8 +10,6 @@
 #include "net/nettype.h"
 #include "net/metadata.h"
 
-#include "fnmatch.h"
-
 namespace kdlib {
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -39,6 +37,7 @@ TargetHeapEnumPtr  NetHeap::getEnum(const std::wstring&  typeName, size_t minSiz
 
 NetHeapEnum::NetHeapEnum(const std::wstring&  typeName, size_t minSize, size_t maxSize) :
     m_typeMask(typeName),
+    m_typeMatcher(typeName),
     m_minSize(minSize),
     m_maxSize(maxSize)
 {
@@ -68,7 +67,7 @@ bool NetHeapEnum::next(MEMOFFSET_64& addr, std::wstring& typeName, size_t& size)
 
         std::wstring  tn = typeObj->getName();
 
-        if ( !m_typeMask.empty() && !fnmatch(m_typeMask, typeObj->getName() ))
+        if ( !m_typeMask.empty() && !m_typeMatcher.match(tn) )
             continue;
 
         if ( m_minSize != 0 && heapObj.size < m_minSize )
@@ -115,7 +114,7 @@ size_t NetHeapEnum::getCount() const
 
             std::wstring  tn = typeObj->getName();
 
-            if ( !m_typeMask.empty() && !fnmatch(m_typeMask, typeObj->getName() ))
+            if ( !m_typeMask.empty() && !m_typeMatcher.match(tn) )
                 continue;
 
             if ( m_minSize != 0 && heapObj.size < m_minSize )
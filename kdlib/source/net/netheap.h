@@ -5,6 +5,8 @@
 
 #include "kdlib/heap.h"
 
+#include "fnmatch.h"
+
 namespace kdlib {
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -35,6 +37,7 @@ public:
 private:
 
     std::wstring  m_typeMask;
+    GlobMatcher  m_typeMatcher;
     size_t  m_minSize;
     size_t  m_maxSize;
     CComPtr<ICorDebugHeapEnum>   m_heapEnum;
@@ -31,6 +31,10 @@ protected:
         NOT_IMPLEMENTED();
     }
 
+    virtual NAME_ID getNameId() {
+        return m_nameId.get( [this]() { return getName(); } );
+    }
+
     virtual std::wstring getScopeName() {
         NOT_IMPLEMENTED();
     }
@@ -312,6 +316,10 @@ protected:
     {
         NOT_IMPLEMENTED();
     }
+
+private:
+
+    LazyInternedName  m_nameId;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,688 @@
+#include "stdafx.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <fstream>
+
+#include "kdlib/memaccess.h"
+#include "kdlib/exceptions.h"
+
+#include "peimage.h"
+
+namespace kdlib {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+
+const boost::uint16_t  DosSignature = 0x5A4D;           // MZ
+const boost::uint32_t  NtSignature = 0x00004550;        // PE00
+const boost::uint16_t  OptionalHeader32Magic = 0x10b;
+const boost::uint16_t  OptionalHeader64Magic = 0x20b;
+
+const size_t  DosHeaderSize = 0x40;
+const size_t  NtHeaderOffsetField = 0x3C;
+const size_t  FileHeaderSize = 0x14;
+const size_t  MaxOptionalHeaderSize = 0xF0;
+const size_t  SectionHeaderSize = 0x28;
+const size_t  ExportDirectorySize = 0x28;
+const size_t  DebugDirectoryEntrySize = 0x1C;
+
+const size_t  ExportDataDirectory = 0;
+const size_t  ExceptionDataDirectory = 3;
+const size_t  DebugDataDirectory = 6;
+
+const size_t  MaxExportCount = 0x100000;
+const size_t  MaxNameLength = 0x1000;
+const size_t  MaxStringRegionSize = 0x1000000;
+const size_t  MaxHeadersSize = 0x10000;
+const size_t  MaxDebugDataSize = 0x100000;
+const size_t  MaxExceptionDataSize = 0x1000000;
+
+///////////////////////////////////////////////////////////////////////////////
+
+void throwInvalidImage()
+{
+    throw SymbolException( L"invalid PE image" );
+}
+
+template<typename T>
+T getField( const std::vector<char> &buffer, size_t offset )
+{
+    if ( offset + sizeof(T) > buffer.size() )
+        throwInvalidImage();
+
+    T  value;
+    memcpy( &value, &buffer[offset], sizeof(T) );
+    return value;
+}
+
+std::vector<char> readBlock( PeImageReader &reader, boost::uint32_t rva, size_t length )
+{
+    std::vector<char>  buffer(length);
+    if ( length > 0 )
+        reader.read( rva, &buffer[0], length );
+    return buffer;
+}
+
+template<typename T>
+std::vector<T> readArray( PeImageReader &reader, boost::uint32_t rva, size_t count )
+{
+    std::vector<T>  table(count);
+    if ( count > 0 )
+        reader.read( rva, &table[0], count * sizeof(T) );
+    return table;
+}
+
+std::string readCString( PeImageReader &reader, boost::uint32_t rva )
+{
+    std::string  str;
+    char  chunk[0x40];
+
+    while ( str.size() < MaxNameLength )
+    {
+        size_t  chunkSize = sizeof(chunk);
+
+        try
+        {
+            reader.read( rva + static_cast<boost::uint32_t>( str.size() ), chunk, chunkSize );
+        }
+        catch( const DbgException& )
+        {
+            // the string can end just before an unreadable page
+            chunkSize = 1;
+            reader.read( rva + static_cast<boost::uint32_t>( str.size() ), chunk, chunkSize );
+        }
+
+        const char  *end = static_cast<const char*>( memchr( chunk, 0, chunkSize ) );
+        if ( end )
+        {
+            str.append( chunk, end - chunk );
+            break;
+        }
+
+        str.append( chunk, chunkSize );
+    }
+
+    return str;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// All the zero terminated strings referenced by the export directory, loaded
+// with one read. Strings out of the loaded region are read one by one.
+
+class StringRegion
+{
+public:
+
+    StringRegion( PeImageReader &reader ) :
+        m_reader( reader ),
+        m_begin( 0 )
+        {}
+
+    void load( const std::vector<boost::uint32_t> &rvas, boost::uint32_t regionEnd )
+    {
+        if ( rvas.empty() )
+            return;
+
+        boost::uint32_t  first = *std::min_element( rvas.begin(), rvas.end() );
+        boost::uint32_t  last = *std::max_element( rvas.begin(), rvas.end() );
+
+        // the last string has to be terminated inside the region
+        if ( regionEnd <= last )
+            regionEnd = last + static_cast<boost::uint32_t>( MaxNameLength );
+
+        if ( regionEnd - first > MaxStringRegionSize )
+            return;
+
+        m_begin = first;
+
+        try
+        {
+            m_region = readBlock( m_reader, first, regionEnd - first );
+            return;
+        }
+        catch( const DbgException& )
+        {}
+
+        try
+        {
+            m_region = readBlock( m_reader, first, last - first + 1 );
+        }
+        catch( const DbgException& )
+        {
+            m_region.clear();
+        }
+    }
+
+    std::string get( boost::uint32_t rva ) const
+    {
+        if ( rva >= m_begin && rva - m_begin < m_region.size() )
+        {
+            const char  *begin = &m_region[0] + ( rva - m_begin );
+            const char  *end = static_cast<const char*>( memchr( begin, 0, m_region.size() - ( rva - m_begin ) ) );
+            if ( end )
+                return std::string( begin, end );
+        }
+
+        return readCString( m_reader, rva );
+    }
+
+private:
+
+    PeImageReader  &m_reader;
+
+    boost::uint32_t  m_begin;
+    std::vector<char>  m_region;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct PeHeaders
+{
+    boost::uint16_t  machine;
+    boost::uint32_t  timeDateStamp;
+    boost::uint32_t  imageSize;
+    boost::uint32_t  headersSize;
+    size_t  dataDirOffset;
+    size_t  dataDirCount;
+    boost::uint32_t  sectionOffset;
+    size_t  sectionCount;
+    std::vector<char>  optionalHeader;
+
+    bool getDataDirectory( size_t index, boost::uint32_t &rva, boost::uint32_t &size ) const
+    {
+        size_t  offset = dataDirOffset + index * 8;
+
+        if ( index >= dataDirCount || offset + 8 > optionalHeader.size() )
+            return false;
+
+        rva = getField<boost::uint32_t>( optionalHeader, offset );
+        size = getField<boost::uint32_t>( optionalHeader, offset + 4 );
+
+        return rva != 0 && size != 0;
+    }
+};
+
+void readPeHeaders( PeImageReader &reader, PeHeaders &headers )
+{
+    std::vector<char>  dosHeader = readBlock( reader, 0, DosHeaderSize );
+    if ( getField<boost::uint16_t>( dosHeader, 0 ) != DosSignature )
+        throwInvalidImage();
+
+    boost::uint32_t  ntOffset = getField<boost::uint32_t>( dosHeader, NtHeaderOffsetField );
+
+    std::vector<char>  ntHeader = readBlock( reader, ntOffset, 4 + FileHeaderSize );
+    if ( getField<boost::uint32_t>( ntHeader, 0 ) != NtSignature )
+        throwInvalidImage();
+
+    headers.machine = getField<boost::uint16_t>( ntHeader, 4 );
+    headers.timeDateStamp = getField<boost::uint32_t>( ntHeader, 4 + 4 );
+
+    boost::uint16_t  fullOptionalHeaderSize = getField<boost::uint16_t>( ntHeader, 4 + 16 );
+    size_t  optionalHeaderSize = std::min<size_t>( fullOptionalHeaderSize, MaxOptionalHeaderSize );
+
+    headers.sectionOffset = ntOffset + 4 + static_cast<boost::uint32_t>( FileHeaderSize ) + fullOptionalHeaderSize;
+    headers.sectionCount = getField<boost::uint16_t>( ntHeader, 4 + 2 );
+
+    headers.optionalHeader = readBlock( reader, ntOffset + 4 + FileHeaderSize, optionalHeaderSize );
+
+    switch ( getField<boost::uint16_t>( headers.optionalHeader, 0 ) )
+    {
+    case OptionalHeader32Magic:
+        headers.dataDirOffset = 96;
+        break;
+
+    case OptionalHeader64Magic:
+        headers.dataDirOffset = 112;
+        break;
+
+    default:
+        throwInvalidImage();
+    }
+
+    // SizeOfImage and SizeOfHeaders have the same offsets in PE32 and PE32+ headers
+    headers.imageSize = getField<boost::uint32_t>( headers.optionalHeader, 56 );
+    headers.headersSize = getField<boost::uint32_t>( headers.optionalHeader, 60 );
+
+    // NumberOfRvaAndSizes is just before the data directories
+    headers.dataDirCount = getField<boost::uint32_t>( headers.optionalHeader, headers.dataDirOffset - 4 );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+class PeMemoryReader : public PeImageReader
+{
+public:
+
+    PeMemoryReader( MEMOFFSET_64 imageBase ) :
+        m_imageBase( imageBase )
+        {}
+
+    virtual void read( boost::uint32_t rva, void* buffer, size_t length )
+    {
+        readMemory( m_imageBase + rva, buffer, length );
+    }
+
+private:
+
+    MEMOFFSET_64  m_imageBase;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class PeFileReader : public PeImageReader
+{
+public:
+
+    // the wide path is opened as is, so a non-ANSI path is not lost
+    PeFileReader( const std::wstring &fileName ) :
+        m_file( fileName.c_str(), std::ios::binary | std::ios::ate ),
+        m_size( 0 ),
+        m_headersSize( 0 )
+    {
+        if ( !m_file )
+            throw SymbolException( L"failed to open the image file: " + fileName );
+
+        m_size = static_cast<size_t>( m_file.tellg() );
+
+        loadSections();
+    }
+
+    virtual void read( boost::uint32_t rva, void* buffer, size_t length )
+    {
+        char  *dest = static_cast<char*>(buffer);
+
+        while ( length > 0 )
+        {
+            size_t  fileOffset = 0;
+            size_t  rawSize = 0;
+            size_t  virtualSize = 0;
+
+            if ( !translate( rva, fileOffset, rawSize, virtualSize ) )
+                throw SymbolException( L"RVA is out of the image file" );
+
+            size_t  chunkSize = std::min( length, virtualSize );
+
+            // the rest of the section after its raw data is zero filled
+            size_t  copySize = std::min( chunkSize, rawSize );
+
+            readFile( fileOffset, dest, copySize );
+            memset( dest + copySize, 0, chunkSize - copySize );
+
+            dest += chunkSize;
+            length -= chunkSize;
+            rva += static_cast<boost::uint32_t>( chunkSize );
+        }
+    }
+
+private:
+
+    struct Section
+    {
+        boost::uint32_t  virtualAddress;
+        boost::uint32_t  virtualSize;
+        boost::uint32_t  rawOffset;
+        boost::uint32_t  rawSize;
+    };
+
+    std::vector<char> getBytes( size_t offset, size_t length )
+    {
+        if ( offset > m_size || length > m_size - offset )
+            throwInvalidImage();
+
+        std::vector<char>  bytes( length );
+        readFile( offset, bytes.data(), length );
+        return bytes;
+    }
+
+    void readFile( size_t offset, char* buffer, size_t length )
+    {
+        if ( length == 0 )
+            return;
+
+        m_file.clear();
+        m_file.seekg( offset );
+
+        if ( !m_file.read( buffer, length ) )
+            throwInvalidImage();
+    }
+
+    void loadSections()
+    {
+        std::vector<char>  dosHeader = getBytes( 0, DosHeaderSize );
+        if ( getField<boost::uint16_t>( dosHeader, 0 ) != DosSignature )
+            throwInvalidImage();
+
+        size_t  ntOffset = getField<boost::uint32_t>( dosHeader, NtHeaderOffsetField );
+
+        std::vector<char>  ntHeader = getBytes( ntOffset, 4 + FileHeaderSize );
+        if ( getField<boost::uint32_t>( ntHeader, 0 ) != NtSignature )
+            throwInvalidImage();
+
+        size_t  sectionCount = getField<boost::uint16_t>( ntHeader, 4 + 2 );
+        size_t  optionalHeaderSize = getField<boost::uint16_t>( ntHeader, 4 + 16 );
+
+        std::vector<char>  optionalHeader = getBytes( ntOffset + 4 + FileHeaderSize, optionalHeaderSize );
+
+        // SizeOfHeaders has the same offset in PE32 and PE32+ headers
+        m_headersSize = getField<boost::uint32_t>( optionalHeader, 60 );
+
+        std::vector<char>  sectionTable = getBytes( ntOffset + 4 + FileHeaderSize + optionalHeaderSize, sectionCount * SectionHeaderSize );
+
+        for ( size_t i = 0; i < sectionCount; ++i )
+        {
+            size_t  offset = i * SectionHeaderSize;
+
+            Section  section;
+            section.virtualSize = getField<boost::uint32_t>( sectionTable, offset + 8 );
+            section.virtualAddress = getField<boost::uint32_t>( sectionTable, offset + 12 );
+            section.rawSize = getField<boost::uint32_t>( sectionTable, offset + 16 );
+            section.rawOffset = getField<boost::uint32_t>( sectionTable, offset + 20 );
+
+            if ( section.virtualSize == 0 )
+                section.virtualSize = section.rawSize;
+
+            m_sections.push_back( section );
+        }
+    }
+
+    bool translate( boost::uint32_t rva, size_t &fileOffset, size_t &rawSize, size_t &virtualSize ) const
+    {
+        if ( rva < m_headersSize )
+        {
+            fileOffset = rva;
+            virtualSize = m_headersSize - rva;
+            rawSize = fileOffset < m_size ? std::min( virtualSize, m_size - fileOffset ) : 0;
+            return true;
+        }
+
+        for ( std::vector<Section>::const_iterator it = m_sections.begin(); it != m_sections.end(); ++it )
+        {
+            if ( rva < it->virtualAddress || rva - it->virtualAddress >= it->virtualSize )
+                continue;
+
+            size_t  delta = rva - it->virtualAddress;
+
+            fileOffset = static_cast<size_t>( it->rawOffset ) + delta;
+            virtualSize = it->virtualSize - delta;
+            rawSize = delta < it->rawSize ? it->rawSize - delta : 0;
+
+            if ( fileOffset >= m_size )
+                rawSize = 0;
+            else
+                rawSize = std::min( rawSize, m_size - fileOffset );
+
+            return true;
+        }
+
+        return false;
+    }
+
+    std::ifstream  m_file;
+    size_t  m_size;
+
+    boost::uint32_t  m_headersSize;
+    std::vector<Section>  m_sections;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class PeSnapshotReader : public PeImageReader
+{
+public:
+
+    void add( boost::uint32_t rva, const std::vector<char> &data )
+    {
+        if ( !data.empty() )
+            m_blocks.push_back( Block(rva, data) );
+    }
+
+    virtual void read( boost::uint32_t rva, void* buffer, size_t length )
+    {
+        for ( std::vector<Block>::const_iterator it = m_blocks.begin(); it != m_blocks.end(); ++it )
+        {
+            if ( rva >= it->first && rva - it->first <= it->second.size() && length <= it->second.size() - ( rva - it->first ) )
+            {
+                memcpy( buffer, &it->second[0] + ( rva - it->first ), length );
+                return;
+            }
+        }
+
+        throw SymbolException( L"RVA is out of the image snapshot" );
+    }
+
+private:
+
+    typedef std::pair<boost::uint32_t, std::vector<char> >  Block;
+
+    std::vector<Block>  m_blocks;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // end nameless namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+PeImageReaderPtr getPeMemoryReader( MEMOFFSET_64 imageBase )
+{
+    return PeImageReaderPtr( new PeMemoryReader(imageBase) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+PeImageReaderPtr getPeFileReader( const std::wstring &fileName )
+{
+    return PeImageReaderPtr( new PeFileReader(fileName) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+PeImageReaderPtr getPeDebugInfoSnapshot( PeImageReader &reader )
+{
+    PeHeaders  headers;
+    readPeHeaders( reader, headers );
+
+    boost::shared_ptr<PeSnapshotReader>  snapshot( new PeSnapshotReader() );
+
+    snapshot->add( 0, readBlock( reader, 0, std::min<size_t>( headers.headersSize, MaxHeadersSize ) ) );
+
+    boost::uint32_t  debugRva = 0;
+    boost::uint32_t  debugSize = 0;
+
+    if ( headers.getDataDirectory( DebugDataDirectory, debugRva, debugSize ) && debugSize <= MaxDebugDataSize )
+    {
+        std::vector<char>  debugDir = readBlock( reader, debugRva, debugSize );
+
+        snapshot->add( debugRva, debugDir );
+
+        for ( size_t offset = 0; offset + DebugDirectoryEntrySize <= debugDir.size(); offset += DebugDirectoryEntrySize )
+        {
+            boost::uint32_t  dataSize = getField<boost::uint32_t>( debugDir, offset + 16 );
+            boost::uint32_t  dataRva = getField<boost::uint32_t>( debugDir, offset + 20 );
+
+            if ( dataRva == 0 || dataSize == 0 || dataSize > MaxDebugDataSize )
+                continue;
+
+            try
+            {
+                snapshot->add( dataRva, readBlock( reader, dataRva, dataSize ) );
+            }
+            catch( const DbgException& )
+            {}
+        }
+    }
+
+    return snapshot;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void readPeExports( PeImageReader &reader, PeExportDirectory &exportDir )
+{
+    exportDir.machine = 0;
+    exportDir.ordinalBase = 0;
+    exportDir.dllName.clear();
+    exportDir.exports.clear();
+
+    PeHeaders  headers;
+    readPeHeaders( reader, headers );
+
+    exportDir.machine = headers.machine;
+
+    boost::uint32_t  exportRva = 0;
+    boost::uint32_t  exportSize = 0;
+
+    if ( !headers.getDataDirectory( ExportDataDirectory, exportRva, exportSize ) )
+        return;
+
+    std::vector<char>  exportHeader = readBlock( reader, exportRva, ExportDirectorySize );
+
+    boost::uint32_t  dllNameRva = getField<boost::uint32_t>( exportHeader, 0x0C );
+    boost::uint32_t  functionCount = getField<boost::uint32_t>( exportHeader, 0x14 );
+    boost::uint32_t  nameCount = getField<boost::uint32_t>( exportHeader, 0x18 );
+    boost::uint32_t  functionsRva = getField<boost::uint32_t>( exportHeader, 0x1C );
+    boost::uint32_t  namesRva = getField<boost::uint32_t>( exportHeader, 0x20 );
+    boost::uint32_t  ordinalsRva = getField<boost::uint32_t>( exportHeader, 0x24 );
+
+    exportDir.ordinalBase = getField<boost::uint32_t>( exportHeader, 0x10 );
+
+    if ( functionCount > MaxExportCount || nameCount > MaxExportCount )
+        throwInvalidImage();
+
+    std::vector<boost::uint32_t>  functions = readArray<boost::uint32_t>( reader, functionsRva, functionCount );
+    std::vector<boost::uint32_t>  names = readArray<boost::uint32_t>( reader, namesRva, nameCount );
+    std::vector<boost::uint16_t>  ordinals = readArray<boost::uint16_t>( reader, ordinalsRva, nameCount );
+
+    // a function RVA inside the export directory points to a forwarder string
+    boost::uint32_t  exportEnd = exportRva + exportSize;
+
+    std::vector<boost::uint32_t>  stringRvas( names );
+
+    if ( dllNameRva != 0 )
+        stringRvas.push_back( dllNameRva );
+
+    for ( size_t i = 0; i < functions.size(); ++i )
+    {
+        if ( functions[i] >= exportRva && functions[i] < exportEnd )
+            stringRvas.push_back( functions[i] );
+    }
+
+    StringRegion  strings( reader );
+    strings.load( stringRvas, exportEnd );
+
+    if ( dllNameRva != 0 )
+        exportDir.dllName = strings.get( dllNameRva );
+
+    std::vector<bool>  named( functionCount, false );
+
+    exportDir.exports.reserve( std::max( nameCount, functionCount ) );
+
+    for ( size_t i = 0; i < names.size(); ++i )
+    {
+        boost::uint16_t  index = ordinals[i];
+        if ( index >= functionCount )
+            continue;
+
+        PeExport  peExport;
+        peExport.name = strings.get( names[i] );
+        peExport.rva = functions[index];
+        peExport.ordinal = exportDir.ordinalBase + index;
+
+        if ( peExport.rva >= exportRva && peExport.rva < exportEnd )
+            peExport.forwarder = strings.get( peExport.rva );
+
+        exportDir.exports.push_back( peExport );
+
+        named[index] = true;
+    }
+
+    for ( boost::uint32_t index = 0; index < functionCount; ++index )
+    {
+        // zero RVA is a gap in the ordinal range
+        if ( named[index] || functions[index] == 0 )
+            continue;
+
+        PeExport  peExport;
+        peExport.rva = functions[index];
+        peExport.ordinal = exportDir.ordinalBase + index;
+
+        if ( peExport.rva >= exportRva && peExport.rva < exportEnd )
+            peExport.forwarder = strings.get( peExport.rva );
+
+        exportDir.exports.push_back( peExport );
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void readPeExceptionDirectory( PeImageReader &reader, PeExceptionDirectory &exceptionDir )
+{
+    exceptionDir.machine = 0;
+    exceptionDir.imageSize = 0;
+    exceptionDir.data.clear();
+
+    PeHeaders  headers;
+    readPeHeaders( reader, headers );
+
+    exceptionDir.machine = headers.machine;
+    exceptionDir.imageSize = headers.imageSize;
+
+    boost::uint32_t  exceptionRva = 0;
+    boost::uint32_t  exceptionSize = 0;
+
+    if ( !headers.getDataDirectory( ExceptionDataDirectory, exceptionRva, exceptionSize ) )
+        return;
+
+    if ( exceptionSize > MaxExceptionDataSize )
+        throwInvalidImage();
+
+    exceptionDir.data = readBlock( reader, exceptionRva, exceptionSize );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void readPeSections( PeImageReader &reader, std::vector<PeSection> &sections )
+{
+    sections.clear();
+
+    PeHeaders  headers;
+    readPeHeaders( reader, headers );
+
+    std::vector<char>  sectionTable = readBlock( reader, headers.sectionOffset, headers.sectionCount * SectionHeaderSize );
+
+    sections.reserve( headers.sectionCount );
+
+    for ( size_t i = 0; i < headers.sectionCount; ++i )
+    {
+        size_t  offset = i * SectionHeaderSize;
+
+        const char  *name = &sectionTable[offset];
+
+        PeSection  section;
+        section.name.assign( name, std::find( name, name + 8, '\0' ) );
+        section.virtualSize = getField<boost::uint32_t>( sectionTable, offset + 8 );
+        section.rva = getField<boost::uint32_t>( sectionTable, offset + 12 );
+        section.characteristics = getField<boost::uint32_t>( sectionTable, offset + 36 );
+
+        sections.push_back( section );
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void readPeImageId( PeImageReader &reader, PeImageId &imageId )
+{
+    PeHeaders  headers;
+    readPeHeaders( reader, headers );
+
+    imageId.timeDateStamp = headers.timeDateStamp;
+    imageId.imageSize = headers.imageSize;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "kdlib/dbgtypedef.h"
+
+namespace kdlib {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Access to a PE image by RVA: either a module loaded into the target memory
+// or an image file on the disk mapped into the debugger process.
+
+class PeImageReader
+{
+public:
+
+    virtual ~PeImageReader() {}
+
+    // throws DbgException if any part of the range can not be read
+    virtual void read( boost::uint32_t rva, void* buffer, size_t length ) = 0;
+};
+
+typedef boost::shared_ptr<PeImageReader>  PeImageReaderPtr;
+
+PeImageReaderPtr getPeMemoryReader( MEMOFFSET_64 imageBase );
+
+PeImageReaderPtr getPeFileReader( const std::wstring &fileName );
+
+// Copy of the image headers and the debug directory with its data: all a
+// symbol loader needs to find the symbol file. Can be read from any thread.
+PeImageReaderPtr getPeDebugInfoSnapshot( PeImageReader &reader );
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct PeExport
+{
+    std::string  name;          // empty for an export by ordinal only
+    std::string  forwarder;     // "dll.func" or "dll.#ordinal", empty if the export is not forwarded
+    boost::uint32_t  rva;
+    boost::uint32_t  ordinal;   // biased by the ordinal base
+};
+
+struct PeExportDirectory
+{
+    boost::uint16_t  machine;
+    boost::uint32_t  ordinalBase;
+    std::string  dllName;
+    std::vector<PeExport>  exports;
+};
+
+// Reads the export directory with one read per table and one read for all
+// the name and forwarder strings. Named exports go first in the order of the
+// name pointer table, then the ordinal only exports.
+void readPeExports( PeImageReader &reader, PeExportDirectory &exportDir );
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct PeExceptionDirectory
+{
+    boost::uint16_t  machine;
+    boost::uint32_t  imageSize;
+    std::vector<char>  data;    // the function table, the entry format depends on the machine
+};
+
+// Reads the exception directory with one read. The data is empty if the
+// image has no exception directory.
+void readPeExceptionDirectory( PeImageReader &reader, PeExceptionDirectory &exceptionDir );
+
+///////////////////////////////////////////////////////////////////////////////
+
+const boost::uint32_t  PeSectionExecute = 0x20000000;     // IMAGE_SCN_MEM_EXECUTE
+
+struct PeSection
+{
+    std::string  name;
+    boost::uint32_t  rva;
+    boost::uint32_t  virtualSize;
+    boost::uint32_t  characteristics;
+};
+
+// Reads the section table with one read
+void readPeSections( PeImageReader &reader, std::vector<PeSection> &sections );
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The build of an image: an image file matches a loaded module if both are
+// the same
+
+struct PeImageId
+{
+    boost::uint32_t  timeDateStamp;
+    boost::uint32_t  imageSize;
+
+    bool operator==( const PeImageId &imageId ) const {
+        return timeDateStamp == imageId.timeDateStamp && imageSize == imageId.imageSize;
+    }
+
+    bool operator!=( const PeImageId &imageId ) const {
+        return !( *this == imageId );
+    }
+};
+
+void readPeImageId( PeImageReader &reader, PeImageId &imageId );
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
@@ -1,5 +1,6 @@
 #include "stdafx.h"
 
+#include <list>
 #include <map>
 
 #include <boost/thread/recursive_mutex.hpp>
@@ -21,6 +22,9 @@ class ProcessInfo {
 
 public:
 
+    ProcessInfo() : m_instructionCount(0)
+    {}
+
     ModulePtr getModule(MEMOFFSET_64  offset);
     void insertModule( ModulePtr& module);
     void removeModule(MEMOFFSET_64  offset );
@@ -28,6 +32,20 @@ public:
     TypeInfoPtr getTypeInfo(const std::wstring& name);
     void insertTypeInfo(const TypeInfoPtr& typeInfo);
 
+    UnwindFunctionTablePtr getFunctionTable(MEMOFFSET_64 imageBase);
+    void insertFunctionTable(const UnwindFunctionTablePtr& table);
+
+    FrameLayoutPtr getFrameLayout(MEMOFFSET_64 moduleBase, MEMOFFSET_32 functionRva);
+    void insertFrameLayout(const FrameLayoutPtr& layout);
+
+    InstructionListPtr getInstructions(MEMOFFSET_64 moduleBase, MEMOFFSET_64 begin, MEMOFFSET_64 end, CPUType cpuMode);
+    void insertInstructions(MEMOFFSET_64 moduleBase, MEMOFFSET_64 begin, MEMOFFSET_64 end, CPUType cpuMode, const InstructionListPtr& instructions);
+    void removeInstructions(MEMOFFSET_64 begin, MEMOFFSET_64 end);
+    void removeInstructions();
+
+    XrefIndexPtr getXrefIndex(MEMOFFSET_64 moduleBase);
+    void insertXrefIndex(const XrefIndexPtr& index);
+
     void insertBreakpoint(const BreakpointPtr& breakpoint);
     void removeBreakpoint(const BreakpointPtr& breakpoint);
 
@@ -44,6 +62,35 @@ private:
     typedef std::map<std::wstring, TypeInfoPtr>  TypeInfoMap;
     TypeInfoMap  m_typeInfoMap;
     boost::recursive_mutex  m_typeInfoLock;
+
+    typedef std::map<MEMOFFSET_64, UnwindFunctionTablePtr>  FunctionTableMap;
+    FunctionTableMap  m_functionTableMap;
+    boost::recursive_mutex  m_functionTableLock;
+
+    typedef std::map<std::pair<MEMOFFSET_64, MEMOFFSET_32>, FrameLayoutPtr>  FrameLayoutMap;
+    FrameLayoutMap  m_frameLayoutMap;
+    boost::recursive_mutex  m_frameLayoutLock;
+
+    typedef std::pair<MEMOFFSET_64, std::pair<MEMOFFSET_64, MEMOFFSET_64> >  CodeRangeKey;
+    typedef std::list<CodeRangeKey>  CodeRangeUsage;
+
+    struct CodeRange {
+        CPUType  cpuMode;
+        InstructionListPtr  instructions;
+        CodeRangeUsage::iterator  usage;
+    };
+
+    typedef std::map<CodeRangeKey, CodeRange>  InstructionMap;
+    InstructionMap  m_instructionMap;
+    CodeRangeUsage  m_instructionUsage;
+    size_t  m_instructionCount;
+    boost::recursive_mutex  m_instructionLock;
+
+    void eraseInstructions(InstructionMap::iterator it);
+
+    typedef std::map<MEMOFFSET_64, XrefIndexPtr>  XrefIndexMap;
+    XrefIndexMap  m_xrefIndexMap;
+    boost::recursive_mutex  m_xrefIndexLock;
     
     typedef std::map<BREAKPOINT_ID, BreakpointPtr>  BreakpointIdMap;
     BreakpointIdMap  m_breakpointMap;
@@ -92,6 +139,19 @@ public:
     TypeInfoPtr getTypeInfo(const std::wstring& name, PROCESS_DEBUG_ID id = -1);
     void insertTypeInfo(const TypeInfoPtr& typeInfo, PROCESS_DEBUG_ID id = -1);
 
+    UnwindFunctionTablePtr getFunctionTable(MEMOFFSET_64 imageBase, PROCESS_DEBUG_ID id);
+    void insertFunctionTable(const UnwindFunctionTablePtr& table, PROCESS_DEBUG_ID id);
+
+    FrameLayoutPtr getFrameLayout(MEMOFFSET_64 moduleBase, MEMOFFSET_32 functionRva, PROCESS_DEBUG_ID id);
+    void insertFrameLayout(const FrameLayoutPtr& layout, PROCESS_DEBUG_ID id);
+
+    InstructionListPtr getInstructions(MEMOFFSET_64 moduleBase, MEMOFFSET_64 begin, MEMOFFSET_64 end, CPUType cpuMode, PROCESS_DEBUG_ID id);
+    void insertInstructions(MEMOFFSET_64 moduleBase, MEMOFFSET_64 begin, MEMOFFSET_64 end, CPUType cpuMode, const InstructionListPtr& instructions, PROCESS_DEBUG_ID id);
+    void removeInstructions(MEMOFFSET_64 begin, MEMOFFSET_64 end, PROCESS_DEBUG_ID id);
+
+    XrefIndexPtr getXrefIndex(MEMOFFSET_64 moduleBase, PROCESS_DEBUG_ID id);
+    void insertXrefIndex(const XrefIndexPtr& index, PROCESS_DEBUG_ID id);
+
     void registerEventsCallback(DebugEventsCallback *callback);
     void removeEventsCallback(DebugEventsCallback *callback);
 
@@ -367,6 +427,96 @@ void ProcessMonitor::insertTypeInfo(const TypeInfoPtr& typeInfo, PROCESS_DEBUG_I
 
 ///////////////////////////////////////////////////////////////////////////////
 
+UnwindFunctionTablePtr ProcessMonitor::getFunctionTable(MEMOFFSET_64 imageBase, PROCESS_DEBUG_ID id)
+{
+    if (id == -1)
+        id = getCurrentProcessId();
+
+    return g_procmon->getFunctionTable(imageBase, id);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ProcessMonitor::insertFunctionTable(const UnwindFunctionTablePtr& table, PROCESS_DEBUG_ID id)
+{
+    if (id == -1)
+        id = getCurrentProcessId();
+
+    return g_procmon->insertFunctionTable(table, id);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+FrameLayoutPtr ProcessMonitor::getFrameLayout(MEMOFFSET_64 moduleBase, MEMOFFSET_32 functionRva, PROCESS_DEBUG_ID id)
+{
+    if (id == -1)
+        id = getCurrentProcessId();
+
+    return g_procmon->getFrameLayout(moduleBase, functionRva, id);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ProcessMonitor::insertFrameLayout(const FrameLayoutPtr& layout, PROCESS_DEBUG_ID id)
+{
+    if (id == -1)
+        id = getCurrentProcessId();
+
+    return g_procmon->insertFrameLayout(layout, id);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+InstructionListPtr ProcessMonitor::getInstructions(MEMOFFSET_64 moduleBase, MEMOFFSET_64 begin, MEMOFFSET_64 end, CPUType cpuMode, PROCESS_DEBUG_ID id)
+{
+    if (id == -1)
+        id = getCurrentProcessId();
+
+    return g_procmon->getInstructions(moduleBase, begin, end, cpuMode, id);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ProcessMonitor::insertInstructions(MEMOFFSET_64 moduleBase, MEMOFFSET_64 begin, MEMOFFSET_64 end, CPUType cpuMode, const InstructionListPtr& instructions, PROCESS_DEBUG_ID id)
+{
+    if (id == -1)
+        id = getCurrentProcessId();
+
+    return g_procmon->insertInstructions(moduleBase, begin, end, cpuMode, instructions, id);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ProcessMonitor::removeInstructions(MEMOFFSET_64 begin, MEMOFFSET_64 end, PROCESS_DEBUG_ID id)
+{
+    if (id == -1)
+        id = getCurrentProcessId();
+
+    return g_procmon->removeInstructions(begin, end, id);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+XrefIndexPtr ProcessMonitor::getXrefIndex(MEMOFFSET_64 moduleBase, PROCESS_DEBUG_ID id)
+{
+    if (id == -1)
+        id = getCurrentProcessId();
+
+    return g_procmon->getXrefIndex(moduleBase, id);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ProcessMonitor::insertXrefIndex(const XrefIndexPtr& index, PROCESS_DEBUG_ID id)
+{
+    if (id == -1)
+        id = getCurrentProcessId();
+
+    return g_procmon->insertXrefIndex(index, id);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 DebugCallbackResult ProcessMonitorImpl::processStart(PROCESS_DEBUG_ID id)
 {
     {
@@ -586,13 +736,24 @@ void ProcessMonitorImpl::currentThreadChange(THREAD_DEBUG_ID threadid)
 
 void ProcessMonitorImpl::executionStatusChange(ExecutionStatus status)
 {
-    boost::recursive_mutex::scoped_lock l(m_callbacksLock);
+    if (status == DebugStatusGo)
+    {
+        // the code of a running target can be patched
+        boost::recursive_mutex::scoped_lock l(m_lock);
 
-    EventsCallbackList::iterator  it = m_callbacks.begin();
+        for ( ProcessMap::iterator  it = m_processMap.begin(); it != m_processMap.end(); ++it)
+           it->second->removeInstructions();
+    }
 
-    for (; it != m_callbacks.end(); ++it)
     {
-        (*it)->onExecutionStatusChange(status);
+        boost::recursive_mutex::scoped_lock l(m_callbacksLock);
+
+        EventsCallbackList::iterator  it = m_callbacks.begin();
+
+        for (; it != m_callbacks.end(); ++it)
+        {
+            (*it)->onExecutionStatusChange(status);
+        }
     }
 }
 
@@ -736,6 +897,95 @@ void ProcessMonitorImpl::insertTypeInfo(const TypeInfoPtr& typeInfo, PROCESS_DEB
 
 ///////////////////////////////////////////////////////////////////////////////
 
+UnwindFunctionTablePtr ProcessMonitorImpl::getFunctionTable(MEMOFFSET_64 imageBase, PROCESS_DEBUG_ID id)
+{
+    ProcessInfoPtr  processInfo = getProcess(id);
+    if ( processInfo )
+        return processInfo->getFunctionTable(imageBase);
+
+    return UnwindFunctionTablePtr();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ProcessMonitorImpl::insertFunctionTable(const UnwindFunctionTablePtr& table, PROCESS_DEBUG_ID id)
+{
+    ProcessInfoPtr  processInfo = getProcess(id);
+    if (processInfo)
+        return processInfo->insertFunctionTable(table);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+FrameLayoutPtr ProcessMonitorImpl::getFrameLayout(MEMOFFSET_64 moduleBase, MEMOFFSET_32 functionRva, PROCESS_DEBUG_ID id)
+{
+    ProcessInfoPtr  processInfo = getProcess(id);
+    if ( processInfo )
+        return processInfo->getFrameLayout(moduleBase, functionRva);
+
+    return FrameLayoutPtr();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ProcessMonitorImpl::insertFrameLayout(const FrameLayoutPtr& layout, PROCESS_DEBUG_ID id)
+{
+    ProcessInfoPtr  processInfo = getProcess(id);
+    if (processInfo)
+        return processInfo->insertFrameLayout(layout);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+InstructionListPtr ProcessMonitorImpl::getInstructions(MEMOFFSET_64 moduleBase, MEMOFFSET_64 begin, MEMOFFSET_64 end, CPUType cpuMode, PROCESS_DEBUG_ID id)
+{
+    ProcessInfoPtr  processInfo = getProcess(id);
+    if ( processInfo )
+        return processInfo->getInstructions(moduleBase, begin, end, cpuMode);
+
+    return InstructionListPtr();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ProcessMonitorImpl::insertInstructions(MEMOFFSET_64 moduleBase, MEMOFFSET_64 begin, MEMOFFSET_64 end, CPUType cpuMode, const InstructionListPtr& instructions, PROCESS_DEBUG_ID id)
+{
+    ProcessInfoPtr  processInfo = getProcess(id);
+    if (processInfo)
+        return processInfo->insertInstructions(moduleBase, begin, end, cpuMode, instructions);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ProcessMonitorImpl::removeInstructions(MEMOFFSET_64 begin, MEMOFFSET_64 end, PROCESS_DEBUG_ID id)
+{
+    ProcessInfoPtr  processInfo = getProcess(id);
+    if (processInfo)
+        return processInfo->removeInstructions(begin, end);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+XrefIndexPtr ProcessMonitorImpl::getXrefIndex(MEMOFFSET_64 moduleBase, PROCESS_DEBUG_ID id)
+{
+    ProcessInfoPtr  processInfo = getProcess(id);
+    if ( processInfo )
+        return processInfo->getXrefIndex(moduleBase);
+
+    return XrefIndexPtr();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ProcessMonitorImpl::insertXrefIndex(const XrefIndexPtr& index, PROCESS_DEBUG_ID id)
+{
+    ProcessInfoPtr  processInfo = getProcess(id);
+    if (processInfo)
+        return processInfo->insertXrefIndex(index);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 ProcessInfoPtr ProcessMonitorImpl::getProcess( PROCESS_DEBUG_ID id )
 {
     boost::recursive_mutex::scoped_lock l(m_lock);
@@ -826,8 +1076,33 @@ void ProcessInfo::insertModule( ModulePtr& module)
 
 void ProcessInfo::removeModule(MEMOFFSET_64  offset )
 {
-    boost::recursive_mutex::scoped_lock l(m_moduleLock);
-    m_moduleMap.erase(offset);
+    {
+        boost::recursive_mutex::scoped_lock l(m_moduleLock);
+        m_moduleMap.erase(offset);
+    }
+
+    {
+        boost::recursive_mutex::scoped_lock l(m_functionTableLock);
+        m_functionTableMap.erase(offset);
+    }
+
+    {
+        boost::recursive_mutex::scoped_lock l(m_frameLayoutLock);
+        m_frameLayoutMap.erase(
+            m_frameLayoutMap.lower_bound(std::make_pair(offset, MEMOFFSET_32(0))),
+            m_frameLayoutMap.upper_bound(std::make_pair(offset, ~MEMOFFSET_32(0))));
+    }
+
+    {
+        boost::recursive_mutex::scoped_lock l(m_instructionLock);
+
+        InstructionMap::iterator  it = m_instructionMap.lower_bound(std::make_pair(offset, std::make_pair(MEMOFFSET_64(0), MEMOFFSET_64(0))));
+        while (it != m_instructionMap.end() && it->first.first == offset)
+            eraseInstructions(it++);
+    }
+
+    boost::recursive_mutex::scoped_lock l(m_xrefIndexLock);
+    m_xrefIndexMap.erase(offset);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -855,6 +1130,160 @@ void ProcessInfo::insertTypeInfo(const TypeInfoPtr& typeInfo)
 
 ///////////////////////////////////////////////////////////////////////////////
 
+UnwindFunctionTablePtr ProcessInfo::getFunctionTable(MEMOFFSET_64 imageBase)
+{
+    boost::recursive_mutex::scoped_lock l(m_functionTableLock);
+
+    FunctionTableMap::iterator  it = m_functionTableMap.find(imageBase);
+
+    if (it != m_functionTableMap.end())
+        return it->second;
+
+    return UnwindFunctionTablePtr();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ProcessInfo::insertFunctionTable(const UnwindFunctionTablePtr& table)
+{
+    boost::recursive_mutex::scoped_lock l(m_functionTableLock);
+
+    m_functionTableMap[table->getImageBase()] = table;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+FrameLayoutPtr ProcessInfo::getFrameLayout(MEMOFFSET_64 moduleBase, MEMOFFSET_32 functionRva)
+{
+    boost::recursive_mutex::scoped_lock l(m_frameLayoutLock);
+
+    FrameLayoutMap::iterator  it = m_frameLayoutMap.find(std::make_pair(moduleBase, functionRva));
+
+    if (it != m_frameLayoutMap.end())
+        return it->second;
+
+    return FrameLayoutPtr();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ProcessInfo::insertFrameLayout(const FrameLayoutPtr& layout)
+{
+    boost::recursive_mutex::scoped_lock l(m_frameLayoutLock);
+
+    m_frameLayoutMap[std::make_pair(layout->getModuleBase(), layout->getFunctionRva())] = layout;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// about 120 bytes per decoded instruction: the .text of a few big modules
+static const size_t  MaxCachedInstructions = 0x80000;
+
+InstructionListPtr ProcessInfo::getInstructions(MEMOFFSET_64 moduleBase, MEMOFFSET_64 begin, MEMOFFSET_64 end, CPUType cpuMode)
+{
+    boost::recursive_mutex::scoped_lock l(m_instructionLock);
+
+    InstructionMap::iterator  it = m_instructionMap.find(std::make_pair(moduleBase, std::make_pair(begin, end)));
+
+    // the effective machine may be changed
+    if (it == m_instructionMap.end() || it->second.cpuMode != cpuMode)
+        return InstructionListPtr();
+
+    m_instructionUsage.splice(m_instructionUsage.begin(), m_instructionUsage, it->second.usage);
+
+    return it->second.instructions;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ProcessInfo::insertInstructions(MEMOFFSET_64 moduleBase, MEMOFFSET_64 begin, MEMOFFSET_64 end, CPUType cpuMode, const InstructionListPtr& instructions)
+{
+    if (instructions->size() > MaxCachedInstructions)
+        return;
+
+    boost::recursive_mutex::scoped_lock l(m_instructionLock);
+
+    CodeRangeKey  key = std::make_pair(moduleBase, std::make_pair(begin, end));
+
+    InstructionMap::iterator  it = m_instructionMap.find(key);
+    if (it != m_instructionMap.end())
+        eraseInstructions(it);
+
+    while (m_instructionCount + instructions->size() > MaxCachedInstructions)
+        eraseInstructions(m_instructionMap.find(m_instructionUsage.back()));
+
+    m_instructionUsage.push_front(key);
+
+    CodeRange  &range = m_instructionMap[key];
+    range.cpuMode = cpuMode;
+    range.instructions = instructions;
+    range.usage = m_instructionUsage.begin();
+
+    m_instructionCount += instructions->size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ProcessInfo::removeInstructions(MEMOFFSET_64 begin, MEMOFFSET_64 end)
+{
+    boost::recursive_mutex::scoped_lock l(m_instructionLock);
+
+    for (InstructionMap::iterator it = m_instructionMap.begin(); it != m_instructionMap.end(); )
+    {
+        const std::pair<MEMOFFSET_64, MEMOFFSET_64>  &range = it->first.second;
+
+        if (range.first < end && begin < range.second)
+            eraseInstructions(it++);
+        else
+            ++it;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ProcessInfo::removeInstructions()
+{
+    boost::recursive_mutex::scoped_lock l(m_instructionLock);
+
+    m_instructionMap.clear();
+    m_instructionUsage.clear();
+    m_instructionCount = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ProcessInfo::eraseInstructions(InstructionMap::iterator it)
+{
+    m_instructionCount -= it->second.instructions->size();
+    m_instructionUsage.erase(it->second.usage);
+    m_instructionMap.erase(it);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+XrefIndexPtr ProcessInfo::getXrefIndex(MEMOFFSET_64 moduleBase)
+{
+    boost::recursive_mutex::scoped_lock l(m_xrefIndexLock);
+
+    XrefIndexMap::iterator  it = m_xrefIndexMap.find(moduleBase);
+
+    if (it != m_xrefIndexMap.end())
+        return it->second;
+
+    return XrefIndexPtr();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ProcessInfo::insertXrefIndex(const XrefIndexPtr& index)
+{
+    boost::recursive_mutex::scoped_lock l(m_xrefIndexLock);
+
+    m_xrefIndexMap[index->getModuleBase()] = index;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void ProcessInfo::insertBreakpoint(const BreakpointPtr& breakpoint)
 {
     boost::recursive_mutex::scoped_lock l(m_breakpointLock);
@@ -911,13 +1340,19 @@ DebugCallbackResult ProcessInfo::breakpointHit(BreakpointPtr& breakpoint)
 
 void ProcessInfo::onChangeSymbolPaths()
 {
-    boost::recursive_mutex::scoped_lock l(m_moduleLock);
-
-    for ( ModuleMap::iterator it = m_moduleMap.begin(); it != m_moduleMap.end(); ++it)
     {
-        if ( !it->second->isSymbolLoaded() )
-            it->second->resetSymbols();
+        boost::recursive_mutex::scoped_lock l(m_moduleLock);
+
+        for ( ModuleMap::iterator it = m_moduleMap.begin(); it != m_moduleMap.end(); ++it)
+        {
+            if ( !it->second->isSymbolLoaded() )
+                it->second->resetSymbols();
+        }
     }
+
+    // the layouts keep the symbols they are read from
+    boost::recursive_mutex::scoped_lock l(m_frameLayoutLock);
+    m_frameLayoutMap.clear();
 }
 
 /////////////////////////////////////////////////////////////////////////////
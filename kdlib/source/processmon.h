@@ -5,6 +5,11 @@
 #include "kdlib/dbgcallbacks.h"
 #include "kdlib/typeinfo.h"
 #include "kdlib/module.h"
+#include "kdlib/instruction.h"
+
+#include "unwind.h"
+#include "framelayout.h"
+#include "xrefindex.h"
 
 namespace kdlib {
 
@@ -61,6 +66,27 @@ public: //
 
     static TypeInfoPtr getTypeInfo(const std::wstring& name, PROCESS_DEBUG_ID id = -1);
     static void insertTypeInfo( const TypeInfoPtr& typeInfo, PROCESS_DEBUG_ID id = -1);
+
+public: // unwind data
+
+    static UnwindFunctionTablePtr getFunctionTable(MEMOFFSET_64 imageBase, PROCESS_DEBUG_ID id = -1);
+    static void insertFunctionTable(const UnwindFunctionTablePtr& table, PROCESS_DEBUG_ID id = -1);
+
+public: // frame variables
+
+    static FrameLayoutPtr getFrameLayout(MEMOFFSET_64 moduleBase, MEMOFFSET_32 functionRva, PROCESS_DEBUG_ID id = -1);
+    static void insertFrameLayout(const FrameLayoutPtr& layout, PROCESS_DEBUG_ID id = -1);
+
+public: // decoded code
+
+    static InstructionListPtr getInstructions(MEMOFFSET_64 moduleBase, MEMOFFSET_64 begin, MEMOFFSET_64 end, CPUType cpuMode, PROCESS_DEBUG_ID id = -1);
+    static void insertInstructions(MEMOFFSET_64 moduleBase, MEMOFFSET_64 begin, MEMOFFSET_64 end, CPUType cpuMode, const InstructionListPtr& instructions, PROCESS_DEBUG_ID id = -1);
+    static void removeInstructions(MEMOFFSET_64 begin, MEMOFFSET_64 end, PROCESS_DEBUG_ID id = -1);
+
+public: // cross references
+
+    static XrefIndexPtr getXrefIndex(MEMOFFSET_64 moduleBase, PROCESS_DEBUG_ID id = -1);
+    static void insertXrefIndex(const XrefIndexPtr& index, PROCESS_DEBUG_ID id = -1);
 };
 
 ///////////////////////////////////////////////////////////////////////////////
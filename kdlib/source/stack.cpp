@@ -1,53 +1,43 @@
 #include "stdafx.h"
 
+#include <map>
+#include <algorithm>
+
 #include "kdlib\module.h"
 #include "kdlib\dbgengine.h"
+#include "kdlib\nametable.h"
 
 #include "stackimpl.h"
+#include "processmon.h"
 
 namespace kdlib {
 
-typedef std::pair<MEMOFFSET_64, MEMOFFSET_64>   DebugRange;
-
 namespace {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-DebugRange getFuncDebugRange(SymbolPtr& sym)
+FrameVariablesPtr makeNoVariables()
 {
-    SymbolPtrList lstFuncDebugStart;
-    SymbolPtrList lstFuncDebugEnd;
-
-    try
-    {
-        lstFuncDebugStart = sym->findChildren(SymTagFuncDebugStart);
-        if ( lstFuncDebugStart.empty() )
-            return std::make_pair(0, 0);
-
-        lstFuncDebugEnd = sym->findChildren(SymTagFuncDebugEnd);
-        if ( lstFuncDebugEnd.empty() )
-            return std::make_pair(0, 0);
-
-        return std::make_pair( (*lstFuncDebugStart.begin())->getVa(), (*lstFuncDebugEnd.begin())->getVa());
-    }
-    catch (const SymbolException&)
-    {
-    }
-
-    return std::make_pair(0, 0);
+    FrameVariableList  variables;
+    return FrameVariablesPtr(new FrameVariables(variables));
 }
 
-DebugRange getBlockRange(SymbolPtr& sym)
+FrameVariablesPtr getNoVariables()
 {
-    MEMOFFSET_64   blockBegin = sym->getVa();
-    MEMOFFSET_64   blockEnd = blockBegin + sym->getSize();
-
-    return std::make_pair(blockBegin, blockEnd);
+    static const FrameVariablesPtr  noVariables = makeNoVariables();
+    return noVariables;
 }
 
-bool inDebugRange( const DebugRange& range, MEMOFFSET_64 offset)
+// The variable names are interned with the frame layout: a name that is not
+// interned is not a variable, it is not added to the name table
+
+const FrameVariable* findVariable(const FrameVariablesPtr& variables, const std::wstring& name)
 {
-    return range.first <= offset && range.second >= offset;
+    InternedName  internedName;
+    if (!InternedName::find(name, internedName))
+        return 0;
+
+    return variables->find(internedName.getId());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -76,7 +66,7 @@ unsigned long StackFrameImpl::getTypedParamCount()
 {
     try {
 
-        return static_cast<unsigned long>(getParams().size());
+        return static_cast<unsigned long>(getParams()->getCount());
 
     }
     catch (DbgException&)
@@ -90,97 +80,24 @@ unsigned long StackFrameImpl::getTypedParamCount()
 
 TypedVarPtr StackFrameImpl::getTypedParam(unsigned long index)
 {
-    SymbolPtrList  vars = getParams();
-
-    SymbolPtrList::iterator it = vars.begin();
-    if (index >= vars.size())
-        throw IndexException(index);
-
-    std::advance(it, index);
-
-    SymbolPtr  sym = *it;
-
-    unsigned long  location = sym->getLocType();
-
-    if (location == LocIsEnregistered)
-    {
-        unsigned long  regId = sym->getRegisterId();
-
-        return loadTypedVar(loadType(sym), getRegisterAccessor(m_cpuContext->getRegisterName(regId)));
-       // return loadTypedVar(loadType(sym), getVariantAccessor(m_cpuContext->getRegisterByIndex(regId)));
-    }
-    else if (location == LocIsRegRel)
-    {
-        MEMOFFSET_REL relOffset = sym->getOffset();
-
-        RELREG_ID regRel = sym->getRegRelativeId();
-
-        MEMOFFSET_64  offset = getOffset(regRel, relOffset);
-
-        return loadTypedVar(loadType(sym), offset);
-    }
-    else if (location == LocIsNull)
-    {
-        return loadTypedVar(loadType(sym), 0);
-    }
-
-    throw DbgException("unknown variable storage");
+    return loadRegisterVar(getParams()->get(index));
 }
 
 /////////////////////////////////////////////////////////////////////////////
 
 std::wstring  StackFrameImpl::getTypedParamName(unsigned long index)
 {
-    SymbolPtrList  vars = getParams();
-
-    SymbolPtrList::iterator it = vars.begin();
-    std::advance(it, index);
-
-    if (it == vars.end())
-        throw IndexException(index);
-
-    return (*it)->getName();
+    return getParams()->get(index).symbol->getName();
 }
 
 /////////////////////////////////////////////////////////////////////////////
 
 TypedVarPtr StackFrameImpl::getTypedParam(const std::wstring& paramName)
 {
-    SymbolPtrList  vars = getParams();
-
-    SymbolPtrList::iterator it = vars.begin();
-    for (; it != vars.end(); ++it)
-    {
-        if ((*it)->getName() == paramName)
-        {
-            SymbolPtr  sym = *it;
-
-            unsigned long  location = sym->getLocType();
-
-            if (location == LocIsEnregistered)
-            {
-                unsigned long  regId = sym->getRegisterId();
-
-                return loadTypedVar(loadType(sym), getCacheAccessor(m_cpuContext->getRegisterByIndex(regId), L"@" + m_cpuContext->getRegisterName(regId)));
-            }
-            else if (location == LocIsRegRel)
-            {
-                MEMOFFSET_REL relOffset = sym->getOffset();
+    const FrameVariable  *var = findVariable(getParams(), paramName);
 
-                RELREG_ID regRel = sym->getRegRelativeId();
-
-                MEMOFFSET_64  offset = getOffset(regRel, relOffset);
-
-                return loadTypedVar(loadType(sym), offset);
-            }
-            else if (location == LocIsNull)
-            {
-                return loadTypedVar(loadType(sym), 0);
-            }
-
-            throw DbgException("unknown variable storage");
-        }
-    }
+    if (var)
+        return loadCachedVar(*var);
 
     std::wstringstream  sstr;
     sstr << L'\'' << paramName << L'\'' << L" - function's parameter not found";
@@ -192,16 +109,7 @@ TypedVarPtr StackFrameImpl::getTypedParam(const std::wstring& paramName)
 
 bool  StackFrameImpl::findParam(const std::wstring& paramName)
 {
-    SymbolPtrList  vars = getParams();
-
-    SymbolPtrList::iterator it = vars.begin();
-    for (; it != vars.end(); ++it)
-    {
-        if ((*it)->getName() == paramName)
-            return true;
-    }
-    
-    return false;
+    return findVariable(getParams(), paramName) != 0;
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -210,7 +118,7 @@ unsigned long StackFrameImpl::getLocalVarCount()
 {
     try
     {
-        return static_cast<unsigned long>(getLocalVars().size());
+        return static_cast<unsigned long>(getLocalVars()->getCount());
     }
     catch (DbgException&)
     {
@@ -223,97 +131,24 @@ unsigned long StackFrameImpl::getLocalVarCount()
 
 TypedVarPtr StackFrameImpl::getLocalVar(unsigned long index)
 {
-    SymbolPtrList  vars = getLocalVars();
-
-    SymbolPtrList::iterator it = vars.begin();
-    if (index >= vars.size())
-        throw IndexException(index);
-
-    std::advance( it, index );
-
-    SymbolPtr  sym = *it;
-
-    unsigned long  location = sym->getLocType();
-
-    if (location  == LocIsEnregistered)
-    {
-        unsigned long  regId = sym->getRegisterId();
-
-        return loadTypedVar(loadType(sym), getRegisterAccessor(m_cpuContext->getRegisterName(regId)));
-
-    }
-    else if (location == LocIsRegRel)
-    {
-        MEMOFFSET_REL relOffset = sym->getOffset();
-
-        RELREG_ID regRel = sym->getRegRelativeId();
-
-        MEMOFFSET_64  offset = getOffset(regRel, relOffset);
-
-        return loadTypedVar(loadType(sym), offset);
-    }
-    else if (location == LocIsNull)
-    {
-        return loadTypedVar(loadType(sym), 0);
-    }
-
-    throw DbgException("unknown variable storage");
+    return loadRegisterVar(getLocalVars()->get(index));
 }
 
 /////////////////////////////////////////////////////////////////////////////
 
 std::wstring  StackFrameImpl::getLocalVarName(unsigned long index)
 {
-    SymbolPtrList  vars = getLocalVars();
-
-    SymbolPtrList::iterator it = vars.begin();
-    std::advance( it, index );
-
-    if ( it == vars.end() )
-        throw IndexException(index);
-
-    return (*it)->getName();
+    return getLocalVars()->get(index).symbol->getName();
 }
 
 /////////////////////////////////////////////////////////////////////////////
 
 TypedVarPtr StackFrameImpl::getLocalVar(const std::wstring& paramName)
 {
-    SymbolPtrList  vars = getLocalVars();
-
-    SymbolPtrList::iterator it = vars.begin();
-    for ( ; it != vars.end(); ++it )
-    {
-        if ( (*it)->getName() == paramName )
-        {
-            SymbolPtr  sym = *it;
-
-            unsigned long  location = sym->getLocType();
-
-            if (location == LocIsEnregistered)
-            {
-                unsigned long  regId = sym->getRegisterId();
-
-                return loadTypedVar(loadType(sym), getCacheAccessor(m_cpuContext->getRegisterByIndex(regId), L"@" + m_cpuContext->getRegisterName(regId)));
-            }
-            else if (location == LocIsRegRel)
-            {
-                MEMOFFSET_REL relOffset = sym->getOffset();
-
-                RELREG_ID regRel = sym->getRegRelativeId();
-
-                MEMOFFSET_64  offset = getOffset(regRel, relOffset);
+    const FrameVariable  *var = findVariable(getLocalVars(), paramName);
 
-                return loadTypedVar(loadType(sym), offset);
-            }
-            else if (location == LocIsNull)
-            {
-                return loadTypedVar(loadType(sym), 0);
-            }
-
-            throw DbgException("unknown variable storage");
-        }
-    }
+    if (var)
+        return loadCachedVar(*var);
 
     std::wstringstream  sstr;
     sstr << L'\'' << paramName << L'\'' << L" - local variable not found";
@@ -324,16 +159,7 @@ TypedVarPtr StackFrameImpl::getLocalVar(const std::wstring& paramName)
 
 bool StackFrameImpl::findLocalVar(const std::wstring& varName)
 {
-    SymbolPtrList  vars = getLocalVars();
-
-    SymbolPtrList::iterator it = vars.begin();
-    for (; it != vars.end(); ++it)
-    {
-        if ((*it)->getName() == varName)
-            return true;
-    }
-
-    return false;
+    return findVariable(getLocalVars(), varName) != 0;
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -342,7 +168,7 @@ unsigned long StackFrameImpl::getStaticVarCount()
 {
     try 
     {
-        return static_cast<unsigned long>(getStaticVars().size());
+        return static_cast<unsigned long>(getStaticVars()->getCount());
     }
     catch (DbgException&)
     {
@@ -355,51 +181,17 @@ unsigned long StackFrameImpl::getStaticVarCount()
 
 TypedVarPtr StackFrameImpl::getStaticVar(unsigned long index)
 {
-    SymbolPtrList  vars = getStaticVars();
-
-    SymbolPtrList::iterator it = vars.begin();
-    if (index >= vars.size())
-        throw IndexException(index);
-
-    std::advance(it, index);
-
-    SymbolPtr  sym = *it;
-
-    unsigned long  location = sym->getLocType();
-
-    if (location == LocIsStatic)
-    {
-        MEMOFFSET_64  offset = sym->getVa();
-        return loadTypedVar(loadType(sym), offset);
-    }
-
-    throw DbgException("unknown variable storage");
+    return loadStaticVar(getStaticVars()->get(index));
 }
 
 /////////////////////////////////////////////////////////////////////////////
 
 TypedVarPtr StackFrameImpl::getStaticVar(const std::wstring& paramName)
 {
-    SymbolPtrList  vars = getStaticVars();
-
-    SymbolPtrList::iterator it = vars.begin();
-    for (; it != vars.end(); ++it)
-    {
-        if ((*it)->getName() == paramName)
-        {
-            SymbolPtr  sym = *it;
+    const FrameVariable  *var = findVariable(getStaticVars(), paramName);
 
-            unsigned long  location = sym->getLocType();
-
-            if (location == LocIsStatic)
-            {
-                MEMOFFSET_64  offset = sym->getVa();
-                return loadTypedVar(loadType(sym), offset);
-            }
-
-            throw DbgException("unknown variable storage");
-        }
-    }
+    if (var)
+        return loadStaticVar(*var);
 
     std::wstringstream  sstr;
     sstr << L'\'' << paramName << L'\'' << L" - static local variable not found";
@@ -410,31 +202,14 @@ TypedVarPtr StackFrameImpl::getStaticVar(const std::wstring& paramName)
 
 std::wstring  StackFrameImpl::getStaticVarName(unsigned long index)
 {
-    SymbolPtrList  vars = getStaticVars();
-
-    SymbolPtrList::iterator it = vars.begin();
-    std::advance(it, index);
-
-    if (it == vars.end())
-        throw IndexException(index);
-
-    return (*it)->getName();
+    return getStaticVars()->get(index).symbol->getName();
 }
 
 /////////////////////////////////////////////////////////////////////////////
 
 bool StackFrameImpl::findStaticVar(const std::wstring& varName)
 {
-    SymbolPtrList  vars = getStaticVars();
-
-    SymbolPtrList::iterator it = vars.begin();
-    for (; it != vars.end(); ++it)
-    {
-        if ((*it)->getName() == varName)
-            return true;
-    }
-
-    return false;
+    return findVariable(getStaticVars(), varName) != 0;
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -483,6 +258,16 @@ void StackFrameImpl::getSourceLine(std::wstring& fileName, unsigned long& lineNo
     if (m_inlineIndex == 0)
     {
         long  displacement;
+
+        // the module line table, the engine if there are no module symbols
+        try
+        {
+            loadModule(m_ip)->getSourceLine(m_ip, fileName, lineNo, displacement);
+            return;
+        }
+        catch (const DbgException&)
+        {}
+
         kdlib::getSourceLine(fileName, lineNo, displacement, m_ip);
         return;
     }
@@ -506,223 +291,273 @@ void StackFrameImpl::getSourceLine(std::wstring& fileName, unsigned long& lineNo
 
 /////////////////////////////////////////////////////////////////////////////
 
-SymbolPtrList  StackFrameImpl::getLocalVars()
+FrameScopePtr StackFrameImpl::getScope()
 {
+    {
+        boost::mutex::scoped_lock  l(m_lock);
 
-    SymbolPtrList  lst;
+        if (m_scope)
+            return m_scope;
+    }
 
-    try {
+    ModulePtr  mod = loadModule(m_ip);
+
+    MEMDISPLACEMENT  displacement;
+    SymbolPtr  symFunc = mod->getSymbolByVa(m_ip, SymTagFunction, &displacement);
 
-        ModulePtr mod  = loadModule(m_ip);
+    MEMOFFSET_32  functionRva = static_cast<MEMOFFSET_32>(symFunc->getRva());
 
-        MEMDISPLACEMENT displacemnt;
-        SymbolPtr symFunc = mod->getSymbolByVa( m_ip, SymTagFunction, &displacemnt );
+    FrameLayoutPtr  layout = ProcessMonitor::getFrameLayout(mod->getBase(), functionRva);
 
-        DebugRange  debugRange = getFuncDebugRange(symFunc);
+    if (!layout)
+    {
+        layout = FrameLayoutPtr(new FrameLayout(mod->getBase(), symFunc));
+        ProcessMonitor::insertFrameLayout(layout);
+    }
 
-        if ( !inDebugRange(debugRange, m_ip) )
-            return lst;
+    FrameScopePtr  scope = layout->getScope(m_ip);
 
-        //find var in current scope
-        SymbolPtrList symList = symFunc->findChildrenByRVA(SymTagData, static_cast<MEMOFFSET_32>(m_ip - mod->getBase()));
+    boost::mutex::scoped_lock  l(m_lock);
 
-        SymbolPtrList::iterator it;
-        for ( it = symList.begin(); it != symList.end(); it++ )
-        {
-            if ( (*it)->getDataKind() == DataIsLocal  )
-                lst.push_back( *it );
-        }
+    if (!m_scope)
+        m_scope = scope;
 
-        //find inners scopes
-        SymbolPtrList scopeList = symFunc->findChildren(SymTagBlock);
-        SymbolPtrList::iterator itScope = scopeList.begin();
+    return m_scope;
+}
 
-        for (; itScope != scopeList.end(); ++itScope)
-        {
-            SymbolPtrList  innerVars = getBlockLocalVars(*itScope);
- 
-            lst.insert( lst.end(), innerVars.begin(), innerVars.end() );
-        }
+/////////////////////////////////////////////////////////////////////////////
 
+FrameVariablesPtr StackFrameImpl::getLocalVars()
+{
+    try
+    {
+        return getScope()->locals;
     }
-    catch(SymbolException&)
+    catch (SymbolException&)
     {
     }
 
-
-    return lst;
+    return getNoVariables();
 }
 
 /////////////////////////////////////////////////////////////////////////////
 
-SymbolPtrList StackFrameImpl::getParams()
+FrameVariablesPtr StackFrameImpl::getParams()
 {
-    SymbolPtrList  lst;
-
-    try 
+    try
     {
+        return getScope()->params;
+    }
+    catch (SymbolException&)
+    {
+    }
 
-        ModulePtr mod = loadModule(m_ip);
+    return getNoVariables();
+}
 
-        MEMDISPLACEMENT displacemnt;
-        SymbolPtr symFunc = mod->getSymbolByVa(m_ip, SymTagFunction, &displacemnt);
+/////////////////////////////////////////////////////////////////////////////
 
+FrameVariablesPtr StackFrameImpl::getStaticVars()
+{
+    return getScope()->statics;
+}
 
-        // find var in current scope
-        SymbolPtrList symList = symFunc->findChildrenByRVA(SymTagData, static_cast<MEMOFFSET_32>(m_ip - mod->getBase()));
+/////////////////////////////////////////////////////////////////////////////
 
-        SymbolPtrList::iterator it;
-        for (it = symList.begin(); it != symList.end(); it++)
-        {
-            unsigned long dataKind = (*it)->getDataKind();
+TypedVarPtr StackFrameImpl::loadRegisterVar(const FrameVariable& var)
+{
+    if (var.locType == LocIsEnregistered)
+        return loadTypedVar(loadType(var.symbol), getRegisterAccessor(getCPUContext()->getRegisterName(var.registerId)));
 
-            if ( dataKind == DataIsParam || dataKind == DataIsObjectPtr )
-                lst.push_back(*it);
-        }
+    return loadMemoryVar(var);
+}
 
-    }
-    catch(SymbolException&)
-    {
-    }
+/////////////////////////////////////////////////////////////////////////////
+
+TypedVarPtr StackFrameImpl::loadCachedVar(const FrameVariable& var)
+{
+    if (var.locType == LocIsEnregistered)
+        return loadTypedVar(loadType(var.symbol), getCacheAccessor(getCPUContext()->getRegisterByIndex(var.registerId), L"@" + getCPUContext()->getRegisterName(var.registerId)));
 
-    return lst;
+    return loadMemoryVar(var);
 }
 
 /////////////////////////////////////////////////////////////////////////////
 
-SymbolPtrList StackFrameImpl::getStaticVars()
+TypedVarPtr StackFrameImpl::loadMemoryVar(const FrameVariable& var)
 {
-    ModulePtr mod = loadModule(m_ip);
-
-    MEMDISPLACEMENT displacemnt;
-    SymbolPtr symFunc = mod->getSymbolByVa(m_ip, SymTagFunction, &displacemnt);
+    if (var.locType == LocIsRegRel)
+        return loadTypedVar(loadType(var.symbol), getOffset(var.regRelativeId, var.offset));
 
-    SymbolPtrList  lst;
+    if (var.locType == LocIsNull)
+        return loadTypedVar(loadType(var.symbol), 0);
 
-    DebugRange  debugRange = getFuncDebugRange(symFunc);
+    throw DbgException("unknown variable storage");
+}
 
-    if (!inDebugRange(debugRange, m_ip))
-        return lst;
+/////////////////////////////////////////////////////////////////////////////
 
-    //find var in current scope
-    SymbolPtrList symList = symFunc->findChildrenByRVA(SymTagData, static_cast<MEMOFFSET_32>(m_ip - mod->getBase()));
+TypedVarPtr StackFrameImpl::loadStaticVar(const FrameVariable& var)
+{
+    if (var.locType == LocIsStatic)
+        return loadTypedVar(loadType(var.symbol), var.va);
 
-    SymbolPtrList::iterator it;
-    for (it = symList.begin(); it != symList.end(); it++)
-    {
-        if ((*it)->getDataKind() == DataIsStaticLocal)
-        {
-            std::wstring  name = (*it)->getName();
-            if (!name.empty())
-                lst.push_back(*it);
-        }
-    }
+    throw DbgException("unknown variable storage");
+}
 
-    //find inners scopes
-    SymbolPtrList scopeList = symFunc->findChildren(SymTagBlock);
-    SymbolPtrList::iterator itScope = scopeList.begin();
+/////////////////////////////////////////////////////////////////////////////
 
-    for (; itScope != scopeList.end(); ++itScope)
+MEMOFFSET_64 StackFrameImpl::getOffset(unsigned long regRel, MEMOFFSET_REL relOffset)
+{
+    switch( regRel )
     {
-        SymbolPtrList  innerVars = getBlockStaticVars(*itScope);
+    case rriInstructionPointer:
+        return (MEMOFFSET_64)( getCPUContext()->getIP() + relOffset );
 
-        lst.insert(lst.end(), innerVars.begin(), innerVars.end());
+    case rriStackFrame:
+        return (MEMOFFSET_64)( getCPUContext()->getFP() + relOffset );
+
+    case rriStackPointer:
+        return (MEMOFFSET_64)( getCPUContext()->getSP() + relOffset );
     }
 
-    return lst;
+    throw DbgException( "unknown relative offset" );
 }
 
 /////////////////////////////////////////////////////////////////////////////
 
-SymbolPtrList  StackFrameImpl::getBlockLocalVars(SymbolPtr& sym)
+StackFramePtr StackImpl::getFrame(unsigned long index)
 {
-    SymbolPtrList  lst;
-
-    DebugRange  debugRange = getBlockRange(sym);
+    if (index >= m_stackTrace.size())
+        throw IndexException(index);
 
-    if ( !inDebugRange(debugRange, m_ip) )
-        return lst;
+    boost::mutex::scoped_lock  l(m_framesLock);
 
-    // find var in current scope
-    SymbolPtrList symList = sym->findChildren(SymTagData);
+    if (m_frames.empty())
+        m_frames.resize(m_stackTrace.size());
 
-    SymbolPtrList::iterator it;
-    for ( it = symList.begin(); it != symList.end(); it++ )
-    {
-        if ( (*it)->getDataKind() == DataIsLocal  )
-            lst.push_back( *it );
-    }
+    if (!m_frames[index])
+        m_frames[index] = StackFramePtr(new StackFrameImpl(index, m_stackTrace[index], m_contexts));
 
-    // find inners scopes
-    SymbolPtrList scopeList = sym->findChildren(SymTagBlock);
-    SymbolPtrList::iterator itScope = scopeList.begin();
+    return m_frames[index];
+}
 
-    for (; itScope != scopeList.end(); ++itScope)
-    {
-        SymbolPtrList  innerVars = getBlockLocalVars(*itScope);
+/////////////////////////////////////////////////////////////////////////////
 
-        lst.insert( lst.end(), innerVars.begin(), innerVars.end() );
-    }
+namespace {
 
-    return lst;
-}
+// FNV-1a
 
-/////////////////////////////////////////////////////////////////////////////
+const unsigned long long  SignatureBasis = 0xcbf29ce484222325ULL;
+const unsigned long long  SignaturePrime = 0x100000001b3ULL;
 
-SymbolPtrList  StackFrameImpl::getBlockStaticVars(SymbolPtr& sym)
+void getFrameOffsets(const StackPtr& stack, std::vector<MEMOFFSET_64>& offsets)
 {
-    SymbolPtrList  lst;
+    offsets.clear();
 
-    DebugRange  debugRange = getBlockRange(sym);
+    if (!stack)
+        return;
+
+    unsigned long  frameCount = stack->getFrameCount();
 
-    if (!inDebugRange(debugRange, m_ip))
-        return lst;
+    offsets.reserve(frameCount);
 
-    // find var in current scope
-    SymbolPtrList symList = sym->findChildren(SymTagData);
+    for (unsigned long i = 0; i < frameCount; ++i)
+        offsets.push_back(stack->getFrame(i)->getIP());
+}
 
-    SymbolPtrList::iterator it;
-    for (it = symList.begin(); it != symList.end(); it++)
+unsigned long long getOffsetsSignature(const std::vector<MEMOFFSET_64>& offsets)
+{
+    unsigned long long  signature = SignatureBasis;
+
+    for (size_t i = 0; i < offsets.size(); ++i)
     {
-        if ((*it)->getDataKind() == DataIsStaticLocal)
+        for (unsigned int shift = 0; shift < 64; shift += 8)
         {
-            std::wstring  name = (*it)->getName();
-            if (!name.empty())
-                lst.push_back(*it);
+            signature ^= (offsets[i] >> shift) & 0xFF;
+            signature *= SignaturePrime;
         }
     }
 
-    // find inners scopes
-    SymbolPtrList scopeList = sym->findChildren(SymTagBlock);
-    SymbolPtrList::iterator itScope = scopeList.begin();
+    return signature;
+}
 
-    for (; itScope != scopeList.end(); ++itScope)
-    {
-        SymbolPtrList  innerVars = getBlockStaticVars(*itScope);
+bool bucketGreater(const StackBucket& bucket1, const StackBucket& bucket2)
+{
+    if (bucket1.threads.size() != bucket2.threads.size())
+        return bucket1.threads.size() > bucket2.threads.size();
 
-        lst.insert(lst.end(), innerVars.begin(), innerVars.end());
-    }
+    return bucket1.threads.front() < bucket2.threads.front();
+}
+
+} // end nameless namespace
 
-    return lst;
+/////////////////////////////////////////////////////////////////////////////
+
+unsigned long long getStackSignature(const StackPtr& stack)
+{
+    std::vector<MEMOFFSET_64>  offsets;
+
+    getFrameOffsets(stack, offsets);
+
+    return getOffsetsSignature(offsets);
 }
 
 /////////////////////////////////////////////////////////////////////////////
 
-MEMOFFSET_64 StackFrameImpl::getOffset(unsigned long regRel, MEMOFFSET_REL relOffset)
+void bucketStacks(AllStacks& allStacks)
 {
-    switch( regRel )
+    std::vector<ThreadStack>  &threads = allStacks.threads;
+    std::vector<StackBucket>  buckets;
+
+    // the frames of the buckets: a signature collision gets its own bucket
+    std::multimap<unsigned long long, size_t>  signatureBuckets;
+    std::vector< std::vector<MEMOFFSET_64> >  bucketOffsets;
+
+    std::vector<MEMOFFSET_64>  offsets;
+
+    for (unsigned long i = 0; i < threads.size(); ++i)
     {
-    case rriInstructionPointer:
-        return (MEMOFFSET_64)( m_cpuContext->getIP() + relOffset );
+        getFrameOffsets(threads[i].stack, offsets);
 
-    case rriStackFrame:
-        return (MEMOFFSET_64)( m_cpuContext->getFP() + relOffset );
+        threads[i].signature = getOffsetsSignature(offsets);
 
-    case rriStackPointer:
-        return (MEMOFFSET_64)( m_cpuContext->getSP() + relOffset );
+        size_t  bucket = buckets.size();
+
+        typedef std::multimap<unsigned long long, size_t>::const_iterator  BucketIterator;
+        std::pair<BucketIterator, BucketIterator>  range = signatureBuckets.equal_range(threads[i].signature);
+
+        for (BucketIterator it = range.first; it != range.second; ++it)
+        {
+            if (bucketOffsets[it->second] == offsets)
+            {
+                bucket = it->second;
+                break;
+            }
+        }
+
+        if (bucket == buckets.size())
+        {
+            StackBucket  stackBucket;
+            stackBucket.signature = threads[i].signature;
+
+            buckets.push_back(stackBucket);
+            bucketOffsets.push_back(offsets);
+            signatureBuckets.insert(std::make_pair(threads[i].signature, bucket));
+        }
+
+        buckets[bucket].threads.push_back(i);
     }
 
-    throw DbgException( "unknown relative offset" );
+    std::sort(buckets.begin(), buckets.end(), bucketGreater);
+
+    for (unsigned long i = 0; i < buckets.size(); ++i)
+    {
+        for (size_t j = 0; j < buckets[i].threads.size(); ++j)
+            threads[buckets[i].threads[j]].bucket = i;
+    }
+
+    allStacks.buckets.swap(buckets);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -3,34 +3,70 @@
 #include <kdlib/stack.h>
 
 #include <boost/enable_shared_from_this.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "framelayout.h"
 
 namespace kdlib {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// A frame without the context
+
+struct StackFrameData
+{
+    MEMOFFSET_64  ip;
+    MEMOFFSET_64  ret;
+    MEMOFFSET_64  fp;
+    MEMOFFSET_64  sp;
+    unsigned long  inlineIndex;
+    unsigned long  contextIndex;    // the frame context in the context source
+};
+
+// The frame contexts of a stack. They are captured with the frames: a source
+// does not read the target after the stack is built.
+
+class StackContextSource
+{
+public:
+
+    virtual ~StackContextSource() {}
+
+    virtual CPUContextPtr getCPUContext(unsigned long index) = 0;
+};
+
+typedef boost::shared_ptr<StackContextSource>  StackContextSourcePtr;
+
+// Fills the signatures and the buckets of the thread stacks
+void bucketStacks(AllStacks& allStacks);
+
+///////////////////////////////////////////////////////////////////////////////
+
 class StackImpl : public Stack
 {
 
 public:
 
-    StackImpl(const std::vector<StackFramePtr>& frames) :
-        m_stackTrace(frames)
-        {}
+    StackImpl(std::vector<StackFrameData>& frames, const StackContextSourcePtr& contexts) :
+        m_contexts(contexts)
+    {
+        m_stackTrace.swap(frames);
+    }
 
     unsigned long getFrameCount()
     {
         return static_cast<unsigned long>(m_stackTrace.size());
     }
 
-    StackFramePtr getFrame(unsigned long index) {
-        if (index < m_stackTrace.size())
-            return m_stackTrace[index];
-        throw IndexException(index);
-    }
+    StackFramePtr getFrame(unsigned long index);
 
 private:
 
-    std::vector<StackFramePtr>  m_stackTrace;
+    std::vector<StackFrameData>  m_stackTrace;
+    StackContextSourcePtr  m_contexts;
+
+    boost::mutex  m_framesLock;
+    std::vector<StackFramePtr>  m_frames;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -47,7 +83,19 @@ public:
         m_fp(fp),
         m_sp(sp),
         m_cpuContext(cpuCtx),
-        m_inlineIndex(inlineIndex)
+        m_inlineIndex(inlineIndex),
+        m_contextIndex(0)
+        {}
+
+    StackFrameImpl(unsigned long number, const StackFrameData& frame, const StackContextSourcePtr& contexts) :
+        m_number(number),
+        m_ip(frame.ip),
+        m_ret(frame.ret),
+        m_fp(frame.fp),
+        m_sp(frame.sp),
+        m_contexts(contexts),
+        m_inlineIndex(frame.inlineIndex),
+        m_contextIndex(frame.contextIndex)
         {}
 
     unsigned long getNumber() const override
@@ -77,6 +125,10 @@ public:
 
     CPUContextPtr getCPUContext() override
     {
+        boost::mutex::scoped_lock  l(m_lock);
+
+        if (!m_cpuContext)
+            m_cpuContext = m_contexts->getCPUContext(m_contextIndex);
         return m_cpuContext;
     }
 
@@ -112,12 +164,18 @@ public:
 
 private:
 
-    SymbolPtrList getLocalVars();
-    SymbolPtrList getParams();
-    SymbolPtrList getStaticVars();
+    FrameScopePtr getScope();
+
+    FrameVariablesPtr getLocalVars();
+    FrameVariablesPtr getParams();
+    FrameVariablesPtr getStaticVars();
 
-    SymbolPtrList getBlockLocalVars(SymbolPtr& sym);
-    SymbolPtrList getBlockStaticVars(SymbolPtr& sym);
+    // a variable by its index is bound to the register, by its name it gets
+    // the register value
+    TypedVarPtr loadRegisterVar(const FrameVariable& var);
+    TypedVarPtr loadCachedVar(const FrameVariable& var);
+    TypedVarPtr loadMemoryVar(const FrameVariable& var);
+    TypedVarPtr loadStaticVar(const FrameVariable& var);
 
     MEMOFFSET_64 getOffset(unsigned long regRel, MEMOFFSET_REL relOffset);
 
@@ -126,8 +184,13 @@ private:
     MEMOFFSET_64  m_fp;
     MEMOFFSET_64  m_sp;
     CPUContextPtr  m_cpuContext;
+    StackContextSourcePtr  m_contexts;
+    FrameScopePtr  m_scope;
     unsigned long  m_number;
     unsigned long  m_inlineIndex;
+    unsigned long  m_contextIndex;
+
+    boost::mutex  m_lock;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
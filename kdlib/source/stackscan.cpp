@@ -0,0 +1,484 @@
+#include "stdafx.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define STACKSCAN_SSE2
+#endif
+
+#include "stackscan.h"
+
+namespace kdlib {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The longest x86 call: REX + FF + ModRM + SIB + disp32
+const size_t  MaxCallLength = 8;
+
+const unsigned long  ScoreCall = 1;
+const unsigned long  ScoreCallTarget = 2;      // the target of the call is known and it is code
+const unsigned long  ScoreFunction = 1;        // the return address is inside a function of the unwind data
+const unsigned long  ScoreChain = 2;           // the call goes to the function of the previous frame
+
+bool rangeLess( const CodeRange &range1, const CodeRange &range2 )
+{
+    return range1.begin < range2.begin;
+}
+
+bool rangeBeginLess( MEMOFFSET_64 offset, const CodeRange &range )
+{
+    return offset < range.begin;
+}
+
+template <typename T>
+T loadSlot( const char *buffer, size_t offset )
+{
+    T  value;
+    memcpy( &value, buffer + offset, sizeof(T) );
+    return value;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void checkCodePointer( MEMOFFSET_64 value, size_t offset, const CodeRangeTable &codeRanges, std::vector<size_t> &slots )
+{
+    if ( value >= codeRanges.getLowest() && value <= codeRanges.getHighest() && codeRanges.find( value ) )
+        slots.push_back( offset );
+}
+
+#ifdef STACKSCAN_SSE2
+
+// The signed compare of SSE2 works for unsigned values with the sign bit flipped
+
+__m128i flipSign( __m128i value )
+{
+    return _mm_xor_si128( value, _mm_set1_epi32( static_cast<int>( 0x80000000 ) ) );
+}
+
+__m128i setBound( boost::uint32_t value )
+{
+    return _mm_set1_epi32( static_cast<int>( value ^ 0x80000000 ) );
+}
+
+// The lanes with the value out of the bounds
+int outOfBounds( __m128i value, __m128i lowest, __m128i highest )
+{
+    __m128i  out = _mm_or_si128( _mm_cmpgt_epi32( lowest, value ), _mm_cmpgt_epi32( value, highest ) );
+    return _mm_movemask_ps( _mm_castsi128_ps( out ) );
+}
+
+// Four slots a step: the high halves of the 64-bit slots are checked against
+// the high halves of the bounds
+
+size_t findCodePointers64( const char *buffer, size_t size, const CodeRangeTable &codeRanges, std::vector<size_t> &slots )
+{
+    __m128i  lowest = setBound( static_cast<boost::uint32_t>( codeRanges.getLowest() >> 32 ) );
+    __m128i  highest = setBound( static_cast<boost::uint32_t>( codeRanges.getHighest() >> 32 ) );
+
+    size_t  offset = 0;
+
+    for ( ; offset + 32 <= size; offset += 32 )
+    {
+        __m128i  slots01 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( buffer + offset ) );
+        __m128i  slots23 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( buffer + offset + 16 ) );
+
+        __m128i  high = _mm_unpacklo_epi64(
+            _mm_shuffle_epi32( slots01, _MM_SHUFFLE(3, 1, 3, 1) ),
+            _mm_shuffle_epi32( slots23, _MM_SHUFFLE(3, 1, 3, 1) ) );
+
+        int  inBounds = ~outOfBounds( flipSign( high ), lowest, highest ) & 0xF;
+
+        for ( size_t i = 0; inBounds != 0; ++i, inBounds >>= 1 )
+        {
+            if ( inBounds & 1 )
+                checkCodePointer( loadSlot<boost::uint64_t>( buffer, offset + i * 8 ), offset + i * 8, codeRanges, slots );
+        }
+    }
+
+    return offset;
+}
+
+size_t findCodePointers32( const char *buffer, size_t size, const CodeRangeTable &codeRanges, std::vector<size_t> &slots )
+{
+    __m128i  lowest = setBound( static_cast<boost::uint32_t>( codeRanges.getLowest() ) );
+    __m128i  highest = setBound( static_cast<boost::uint32_t>( codeRanges.getHighest() ) );
+
+    size_t  offset = 0;
+
+    for ( ; offset + 16 <= size; offset += 16 )
+    {
+        __m128i  values = _mm_loadu_si128( reinterpret_cast<const __m128i*>( buffer + offset ) );
+
+        int  inBounds = ~outOfBounds( flipSign( values ), lowest, highest ) & 0xF;
+
+        for ( size_t i = 0; inBounds != 0; ++i, inBounds >>= 1 )
+        {
+            if ( inBounds & 1 )
+                checkCodePointer( loadSlot<boost::uint32_t>( buffer, offset + i * 4 ), offset + i * 4, codeRanges, slots );
+        }
+    }
+
+    return offset;
+}
+
+#else
+
+size_t findCodePointers64( const char*, size_t, const CodeRangeTable&, std::vector<size_t>& )
+{
+    return 0;
+}
+
+size_t findCodePointers32( const char*, size_t, const CodeRangeTable&, std::vector<size_t>& )
+{
+    return 0;
+}
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The length of ModRM, SIB and the displacement for 32 and 64-bit addressing
+
+size_t getModRMLength( unsigned char modrm, unsigned char sib )
+{
+    unsigned char  mod = modrm >> 6;
+    unsigned char  rm = modrm & 7;
+
+    if ( mod == 3 )
+        return 1;
+
+    size_t  length = 1;
+
+    if ( rm == 4 )
+    {
+        length += 1;
+
+        if ( mod == 0 && ( sib & 7 ) == 5 )
+            length += 4;
+    }
+    else if ( mod == 0 && rm == 5 )
+    {
+        length += 4;
+    }
+
+    if ( mod == 1 )
+        length += 1;
+    else if ( mod == 2 )
+        length += 4;
+
+    return length;
+}
+
+bool decodeCallBeforeX86( bool amd64, const unsigned char *code, size_t length, MEMOFFSET_64 returnAddress, CallSite &callSite )
+{
+    const unsigned char  *end = code + length;
+
+    // E8 rel32
+    if ( length >= 5 && end[-5] == 0xE8 )
+    {
+        boost::int32_t  rel;
+        memcpy( &rel, end - 4, sizeof(rel) );
+
+        callSite.kind = CallDirect;
+        callSite.length = 5;
+        callSite.target = returnAddress + static_cast<boost::int64_t>( rel );
+
+        if ( !amd64 )
+            callSite.target &= 0xFFFFFFFF;
+
+        return true;
+    }
+
+    // [REX] FF /2
+    for ( size_t callLength = 2; callLength < std::min( length + 1, MaxCallLength ); ++callLength )
+    {
+        const unsigned char  *call = end - callLength;
+
+        if ( call[0] != 0xFF || ( ( call[1] >> 3 ) & 7 ) != 2 )
+            continue;
+
+        size_t  modrmLength = getModRMLength( call[1], call + 2 < end ? call[2] : 0 );
+        if ( call + 1 + modrmLength != end )
+            continue;
+
+        callSite.length = callLength;
+
+        if ( amd64 && call > code && ( call[-1] & 0xF0 ) == 0x40 )
+            callSite.length += 1;
+
+        if ( call[1] == 0x15 )
+        {
+            // call [rip + disp32] on AMD64, call [disp32] on x86
+            boost::int32_t  disp;
+            memcpy( &disp, call + 2, sizeof(disp) );
+
+            callSite.kind = CallImport;
+            callSite.target = amd64 ? returnAddress + static_cast<boost::int64_t>( disp ) : static_cast<boost::uint32_t>( disp );
+        }
+        else
+        {
+            callSite.kind = CallIndirect;
+            callSite.target = 0;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+bool decodeCallBeforeArm64( const unsigned char *code, size_t length, MEMOFFSET_64 returnAddress, CallSite &callSite )
+{
+    if ( length < 4 )
+        return false;
+
+    boost::uint32_t  instruction;
+    memcpy( &instruction, code + length - 4, sizeof(instruction) );
+
+    callSite.length = 4;
+
+    // bl imm26
+    if ( ( instruction & 0xFC000000 ) == 0x94000000 )
+    {
+        boost::int64_t  imm = static_cast<boost::int32_t>( instruction << 6 ) >> 6;
+
+        callSite.kind = CallDirect;
+        callSite.target = returnAddress - 4 + imm * 4;
+        return true;
+    }
+
+    // blr, blraa, blrab, blraaz, blrabz
+    if ( ( instruction & 0xFFFFFC1F ) == 0xD63F0000 || ( instruction & 0xFEFFF800 ) == 0xD63F0800 )
+    {
+        callSite.kind = CallIndirect;
+        callSite.target = 0;
+        return true;
+    }
+
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// A return address is met many times on a stack: the decoded calls are kept
+
+class CallDecoder
+{
+public:
+
+    CallDecoder( UnwindTarget &target, CPUType cpuType ) :
+        m_target( target ),
+        m_cpuType( cpuType )
+        {}
+
+    bool decode( MEMOFFSET_64 returnAddress, const CodeRange &range, CallSite &callSite )
+    {
+        callSite = CallSite();
+
+        std::map<MEMOFFSET_64, std::pair<bool, CallSite> >::const_iterator  it = m_calls.find( returnAddress );
+        if ( it != m_calls.end() )
+        {
+            callSite = it->second.second;
+            return it->second.first;
+        }
+
+        bool  found = decodeNew( returnAddress, range, callSite );
+
+        m_calls.insert( std::make_pair( returnAddress, std::make_pair( found, callSite ) ) );
+
+        return found;
+    }
+
+private:
+
+    bool decodeNew( MEMOFFSET_64 returnAddress, const CodeRange &range, CallSite &callSite )
+    {
+        // the call is inside the same section
+        size_t  length = static_cast<size_t>( std::min<MEMOFFSET_64>( MaxCallLength, returnAddress - range.begin ) );
+
+        unsigned char  code[MaxCallLength];
+
+        if ( length == 0 || !m_target.readMemory( returnAddress - length, code, length ) )
+            return false;
+
+        if ( m_cpuType == CPU_ARM64 )
+            return decodeCallBeforeArm64( code, length, returnAddress, callSite );
+
+        return decodeCallBeforeX86( m_cpuType == CPU_AMD64, code, length, returnAddress, callSite );
+    }
+
+    UnwindTarget  &m_target;
+    CPUType  m_cpuType;
+
+    std::map<MEMOFFSET_64, std::pair<bool, CallSite> >  m_calls;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+MEMOFFSET_64 findFunctionBegin( UnwindTarget &target, MEMOFFSET_64 offset )
+{
+    UnwindFunctionTablePtr  table = target.getFunctionTable( offset );
+    if ( !table )
+        return 0;
+
+    const UnwindFunction  *function = table->find( static_cast<boost::uint32_t>( offset - table->getImageBase() ) );
+
+    return function ? table->getImageBase() + function->begin : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // end nameless namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+CodeRangeTable::CodeRangeTable( std::vector<CodeRange> &ranges )
+{
+    std::sort( ranges.begin(), ranges.end(), rangeLess );
+
+    m_ranges.reserve( ranges.size() );
+
+    for ( size_t i = 0; i < ranges.size(); ++i )
+    {
+        if ( ranges[i].begin >= ranges[i].end )
+            continue;
+
+        if ( !m_ranges.empty() && ranges[i].begin < m_ranges.back().end )
+            continue;
+
+        m_ranges.push_back( ranges[i] );
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const CodeRange* CodeRangeTable::find( MEMOFFSET_64 offset ) const
+{
+    std::vector<CodeRange>::const_iterator  it = std::upper_bound( m_ranges.begin(), m_ranges.end(), offset, rangeBeginLess );
+    if ( it == m_ranges.begin() )
+        return 0;
+
+    --it;
+
+    return offset < it->end ? &*it : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void findCodePointers( const void *buffer, size_t size, size_t pointerSize, const CodeRangeTable &codeRanges, std::vector<size_t> &slots )
+{
+    if ( codeRanges.empty() )
+        return;
+
+    const char  *slotBuffer = static_cast<const char*>( buffer );
+
+    if ( pointerSize == 8 )
+    {
+        for ( size_t offset = findCodePointers64( slotBuffer, size, codeRanges, slots ); offset + 8 <= size; offset += 8 )
+            checkCodePointer( loadSlot<boost::uint64_t>( slotBuffer, offset ), offset, codeRanges, slots );
+    }
+    else
+    {
+        for ( size_t offset = findCodePointers32( slotBuffer, size, codeRanges, slots ); offset + 4 <= size; offset += 4 )
+            checkCodePointer( loadSlot<boost::uint32_t>( slotBuffer, offset ), offset, codeRanges, slots );
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool decodeCallBefore( CPUType cpuType, const unsigned char *code, size_t length, MEMOFFSET_64 returnAddress, CallSite &callSite )
+{
+    switch ( cpuType )
+    {
+    case CPU_I386:
+        return decodeCallBeforeX86( false, code, length, returnAddress, callSite );
+
+    case CPU_AMD64:
+        return decodeCallBeforeX86( true, code, length, returnAddress, callSite );
+
+    case CPU_ARM64:
+        return decodeCallBeforeArm64( code, length, returnAddress, callSite );
+
+    default:
+        // no call decoder for the other CPUs: not a call
+        return false;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void scanStackMemory(
+    UnwindTarget &target,
+    CPUType cpuType,
+    MEMOFFSET_64 stackOffset,
+    const std::vector<char> &stack,
+    const CodeRangeTable &codeRanges,
+    size_t maxFrames,
+    std::vector<ScannedFrame> &frames
+    )
+{
+    size_t  pointerSize = cpuType == CPU_I386 ? 4 : 8;
+
+    std::vector<size_t>  slots;
+
+    if ( !stack.empty() )
+        findCodePointers( &stack[0], stack.size(), pointerSize, codeRanges, slots );
+
+    CallDecoder  decoder( target, cpuType );
+
+    for ( size_t i = 0; i < slots.size() && frames.size() < maxFrames; ++i )
+    {
+        MEMOFFSET_64  returnAddress = pointerSize == 8 ? loadSlot<boost::uint64_t>( &stack[0], slots[i] ) : loadSlot<boost::uint32_t>( &stack[0], slots[i] );
+
+        const CodeRange  *range = codeRanges.find( returnAddress );
+
+        CallSite  callSite = {};
+        if ( !decoder.decode( returnAddress, *range, callSite ) )
+            continue;
+
+        ScannedFrame  frame = {};
+        frame.slot = stackOffset + slots[i];
+        frame.returnAddress = returnAddress;
+        frame.callSite = returnAddress - callSite.length;
+        frame.moduleBase = range->moduleBase;
+        frame.score = ScoreCall;
+
+        if ( callSite.kind == CallImport )
+        {
+            MEMOFFSET_64  pointer = 0;
+
+            if ( target.readMemory( callSite.target, &pointer, pointerSize ) && codeRanges.find( pointer ) )
+                frame.callTarget = pointer;
+        }
+        else if ( callSite.kind == CallDirect )
+        {
+            // random bytes can look like a call but hardly to the code
+            if ( !codeRanges.find( callSite.target ) )
+                continue;
+
+            frame.callTarget = callSite.target;
+        }
+
+        if ( frame.callTarget != 0 )
+            frame.score += ScoreCallTarget;
+
+        frame.functionBegin = findFunctionBegin( target, returnAddress );
+
+        if ( frame.functionBegin != 0 )
+            frame.score += ScoreFunction;
+
+        if ( !frames.empty() && frame.callTarget != 0 && frame.callTarget == frames.back().functionBegin )
+            frame.score += ScoreChain;
+
+        frames.push_back( frame );
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include "kdlib/dbgtypedef.h"
+#include "kdlib/stack.h"
+
+#include "unwind.h"
+
+namespace kdlib {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The executable sections of the modules
+
+struct CodeRange
+{
+    MEMOFFSET_64  begin;
+    MEMOFFSET_64  end;
+    MEMOFFSET_64  moduleBase;
+};
+
+class CodeRangeTable
+{
+public:
+
+    // sorts the ranges, an overlapping range is dropped
+    explicit CodeRangeTable( std::vector<CodeRange> &ranges );
+
+    bool empty() const {
+        return m_ranges.empty();
+    }
+
+    // the bounds of all the ranges: a cheap test before the lookup
+    MEMOFFSET_64 getLowest() const {
+        return m_ranges.empty() ? 0 : m_ranges.front().begin;
+    }
+
+    MEMOFFSET_64 getHighest() const {
+        return m_ranges.empty() ? 0 : m_ranges.back().end - 1;
+    }
+
+    // null if no range contains the address
+    const CodeRange* find( MEMOFFSET_64 offset ) const;
+
+private:
+
+    std::vector<CodeRange>  m_ranges;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The offsets in the buffer of the pointer sized slots holding an address
+// inside the code ranges. The bounds of the table are checked by SIMD on the
+// whole buffer, a slot passing them is looked up in the table.
+void findCodePointers( const void *buffer, size_t size, size_t pointerSize, const CodeRangeTable &codeRanges, std::vector<size_t> &slots );
+
+///////////////////////////////////////////////////////////////////////////////
+
+enum CallKind
+{
+    CallDirect,         // call rel32, bl
+    CallIndirect,       // call r/m, blr
+    CallImport          // call [address]: the target is read from the address
+};
+
+struct CallSite
+{
+    CallKind  kind;
+    size_t  length;
+    MEMOFFSET_64  target;       // CallDirect: the target, CallImport: the target pointer address
+};
+
+// Decodes the call instruction just before the return address. The code is
+// the bytes before the return address, the last byte is the nearest one.
+bool decodeCallBefore( CPUType cpuType, const unsigned char *code, size_t length, MEMOFFSET_64 returnAddress, CallSite &callSite );
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Looks for the return addresses in the stack memory starting at the stack
+// offset. The frames go from the lowest slot, the symbols are not filled.
+void scanStackMemory(
+    UnwindTarget &target,
+    CPUType cpuType,
+    MEMOFFSET_64 stackOffset,
+    const std::vector<char> &stack,
+    const CodeRangeTable &codeRanges,
+    size_t maxFrames,
+    std::vector<ScannedFrame> &frames
+    );
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
@@ -0,0 +1,831 @@
+#include "stdafx.h"
+
+#include <vector>
+
+#include <boost/make_shared.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/recursive_mutex.hpp>
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index/tag.hpp>
+
+#include "kdlib/symcache.h"
+#include "kdlib/exceptions.h"
+
+namespace bmi = boost::multi_index;
+
+namespace kdlib {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+
+enum QueryKind {
+    QueryFindChildren,
+    QueryFindChildrenByRva,
+    QueryChildByName,
+    QueryChildByIndex,
+    QueryChildCount,
+    QueryFindByRva
+};
+
+struct QueryKey
+{
+    QueryKey( const void* owner_, QueryKind kind_, unsigned long symTag_, unsigned long param_ = 0, const std::wstring &name_ = L"", bool caseSensitive_ = false ) :
+        owner( owner_ ),
+        kind( kind_ ),
+        symTag( symTag_ ),
+        param( param_ ),
+        name( name_ ),
+        caseSensitive( caseSensitive_ )
+        {}
+
+    bool operator==( const QueryKey &key ) const
+    {
+        return owner == key.owner && kind == key.kind && symTag == key.symTag &&
+            param == key.param && caseSensitive == key.caseSensitive && name == key.name;
+    }
+
+    const void*  owner;
+    QueryKind  kind;
+    unsigned long  symTag;
+    unsigned long  param;
+    std::wstring  name;
+    bool  caseSensitive;
+};
+
+struct QueryKeyHash
+{
+    size_t operator()( const QueryKey &key ) const
+    {
+        size_t  seed = 0;
+        boost::hash_combine( seed, key.owner );
+        boost::hash_combine( seed, static_cast<int>(key.kind) );
+        boost::hash_combine( seed, key.symTag );
+        boost::hash_combine( seed, key.param );
+        boost::hash_combine( seed, key.name );
+        boost::hash_combine( seed, key.caseSensitive );
+        return seed;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class SymbolCache
+{
+public:
+
+    // symbolMemory: the memory of a cached symbol with its wrapper
+    SymbolCache( size_t memoryBudget, size_t symbolMemory ) :
+        m_memoryBudget( memoryBudget ),
+        m_symbolMemory( symbolMemory ),
+        m_memoryUsage( 0 ),
+        m_hitCount( 0 ),
+        m_missCount( 0 ),
+        m_evictionCount( 0 )
+        {}
+
+    ~SymbolCache()
+    {
+        clear();
+    }
+
+    bool lookup( const QueryKey &key, SymbolPtrList &symbols, long long &value )
+    {
+        boost::recursive_mutex::scoped_lock  lock(m_lock);
+
+        KeyIndex::iterator  it = m_entries.get<ByKey>().find(key);
+        if ( it == m_entries.get<ByKey>().end() )
+        {
+            ++m_missCount;
+            return false;
+        }
+
+        ++m_hitCount;
+
+        m_entries.relocate( m_entries.begin(), m_entries.project<ByUsage>(it) );
+
+        symbols = it->symbols;
+        value = it->value;
+        return true;
+    }
+
+    void insert( const QueryKey &key, const SymbolPtrList &symbols, long long value )
+    {
+        // evicted symbols are released after the lock: their destructors
+        // come back to the cache
+        std::vector<SymbolPtrList>  released;
+
+        boost::recursive_mutex::scoped_lock  lock(m_lock);
+
+        size_t  memory = sizeof(Entry) + key.name.size() * sizeof(wchar_t) + symbols.size() * m_symbolMemory;
+
+        if ( memory > m_memoryBudget )
+            return;
+
+        std::pair<UsageIndex::iterator, bool>  result = m_entries.push_front( Entry(key, symbols, value, memory) );
+        if ( !result.second )
+            return;
+
+        m_memoryUsage += memory;
+
+        while ( m_memoryUsage > m_memoryBudget )
+        {
+            UsageIndex::iterator  last = --m_entries.end();
+            release( last, released );
+            ++m_evictionCount;
+        }
+    }
+
+    void eraseOwner( const void* owner )
+    {
+        std::vector<SymbolPtrList>  released;
+
+        boost::recursive_mutex::scoped_lock  lock(m_lock);
+
+        OwnerIndex  &ownerIndex = m_entries.get<ByOwner>();
+
+        std::pair<OwnerIndex::iterator, OwnerIndex::iterator>  range = ownerIndex.equal_range(owner);
+
+        while ( range.first != range.second )
+        {
+            UsageIndex::iterator  it = m_entries.project<ByUsage>( range.first++ );
+            release( it, released );
+        }
+    }
+
+    void clear()
+    {
+        std::vector<SymbolPtrList>  released;
+
+        boost::recursive_mutex::scoped_lock  lock(m_lock);
+
+        while ( !m_entries.empty() )
+            release( m_entries.begin(), released );
+    }
+
+    SymbolCacheStats getStats()
+    {
+        boost::recursive_mutex::scoped_lock  lock(m_lock);
+
+        SymbolCacheStats  stats;
+        stats.entryCount = m_entries.size();
+        stats.memoryUsage = m_memoryUsage;
+        stats.memoryBudget = m_memoryBudget;
+        stats.hitCount = m_hitCount;
+        stats.missCount = m_missCount;
+        stats.evictionCount = m_evictionCount;
+        return stats;
+    }
+
+private:
+
+    struct Entry
+    {
+        Entry( const QueryKey &key_, const SymbolPtrList &symbols_, long long value_, size_t memory_ ) :
+            key( key_ ),
+            owner( key_.owner ),
+            symbols( symbols_ ),
+            value( value_ ),
+            memory( memory_ )
+            {}
+
+        QueryKey  key;
+        const void*  owner;
+        mutable SymbolPtrList  symbols;
+        long long  value;
+        size_t  memory;
+    };
+
+    struct ByUsage {};
+    struct ByKey {};
+    struct ByOwner {};
+
+    typedef bmi::multi_index_container<
+        Entry,
+        bmi::indexed_by<
+            bmi::sequenced<
+                bmi::tag<ByUsage>
+            >,
+            bmi::hashed_unique<
+                bmi::tag<ByKey>,
+                bmi::member<Entry, QueryKey, &Entry::key>,
+                QueryKeyHash
+            >,
+            bmi::hashed_non_unique<
+                bmi::tag<ByOwner>,
+                bmi::member<Entry, const void*, &Entry::owner>
+            >
+        >
+    > Container;
+
+    typedef Container::index<ByUsage>::type UsageIndex;
+    typedef Container::index<ByKey>::type KeyIndex;
+    typedef Container::index<ByOwner>::type OwnerIndex;
+
+    void release( UsageIndex::iterator it, std::vector<SymbolPtrList> &released )
+    {
+        released.push_back( SymbolPtrList() );
+        released.back().swap( it->symbols );
+
+        m_memoryUsage -= it->memory;
+        m_entries.erase(it);
+    }
+
+    boost::recursive_mutex  m_lock;
+
+    Container  m_entries;
+
+    size_t  m_memoryBudget;
+    size_t  m_symbolMemory;
+    size_t  m_memoryUsage;
+
+    size_t  m_hitCount;
+    size_t  m_missCount;
+    size_t  m_evictionCount;
+};
+
+typedef boost::shared_ptr<SymbolCache>  SymbolCachePtr;
+typedef boost::weak_ptr<SymbolCache>  SymbolCacheWeakPtr;
+
+///////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+struct Memo
+{
+    Memo() :
+        ready( false ),
+        value()
+        {}
+
+    bool  ready;
+    T  value;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class CachingSymbol : public Symbol
+{
+public:
+
+    // the root symbol keeps the cache alive, children only refer to it:
+    // the cache holds children lists and children must not hold the cache
+    CachingSymbol( const SymbolPtr &symbol, const SymbolCachePtr &cache, bool ownCache ) :
+        m_symbol( symbol ),
+        m_cache( cache ),
+        m_cacheOwner( ownCache ? cache : SymbolCachePtr() ),
+        m_hasEntries( false )
+        {}
+
+    ~CachingSymbol()
+    {
+        if ( !m_hasEntries )
+            return;
+
+        SymbolCachePtr  cache = m_cache.lock();
+        if ( cache )
+            cache->eraseOwner(this);
+    }
+
+    SymbolCachePtr getCache() const
+    {
+        return m_cache.lock();
+    }
+
+    virtual SymbolPtrList findChildren( unsigned long symTag, const std::wstring &name = L"", bool caseSensitive = false )
+    {
+        return cachedList( QueryKey(this, QueryFindChildren, symTag, 0, name, caseSensitive),
+            [&]() { return m_symbol->findChildren(symTag, name, caseSensitive); } );
+    }
+
+    virtual SymbolPtrList findChildrenByRVA( unsigned long symTag, unsigned long rva )
+    {
+        return cachedList( QueryKey(this, QueryFindChildrenByRva, symTag, rva),
+            [&]() { return m_symbol->findChildrenByRVA(symTag, rva); } );
+    }
+
+    virtual unsigned long getBaseType()
+    {
+        return memoize( m_baseType, [&]() { return m_symbol->getBaseType(); } );
+    }
+
+    virtual BITOFFSET getBitPosition()
+    {
+        return memoize( m_bitPosition, [&]() { return m_symbol->getBitPosition(); } );
+    }
+
+    virtual SymbolPtr getChildByIndex( unsigned long index )
+    {
+        return cachedSymbol( QueryKey(this, QueryChildByIndex, SymTagNull, index),
+            [&]() { return m_symbol->getChildByIndex(index); } );
+    }
+
+    virtual SymbolPtr getChildByIndex( unsigned long symTag, unsigned long index )
+    {
+        // the case flag separates the key from getChildByIndex(index)
+        return cachedSymbol( QueryKey(this, QueryChildByIndex, symTag, index, L"", true),
+            [&]() { return m_symbol->getChildByIndex(symTag, index); } );
+    }
+
+    virtual SymbolPtr getChildByName( const std::wstring &name )
+    {
+        return cachedSymbol( QueryKey(this, QueryChildByName, SymTagNull, 0, name),
+            [&]() { return m_symbol->getChildByName(name); } );
+    }
+
+    virtual size_t getChildCount()
+    {
+        return static_cast<size_t>( cachedValue( QueryKey(this, QueryChildCount, SymTagNull),
+            [&]() { return static_cast<long long>( m_symbol->getChildCount() ); } ) );
+    }
+
+    virtual size_t getChildCount( unsigned long symTag )
+    {
+        return static_cast<size_t>( cachedValue( QueryKey(this, QueryChildCount, symTag, 0, L"", true),
+            [&]() { return static_cast<long long>( m_symbol->getChildCount(symTag) ); } ) );
+    }
+
+    virtual size_t getCount()
+    {
+        return memoize( m_count, [&]() { return m_symbol->getCount(); } );
+    }
+
+    virtual unsigned long getDataKind()
+    {
+        return memoize( m_dataKind, [&]() { return m_symbol->getDataKind(); } );
+    }
+
+    virtual SymbolPtr getIndexType()
+    {
+        return memoize( m_indexType, [&]() { return wrap( m_symbol->getIndexType() ); } );
+    }
+
+    virtual unsigned long getLocType()
+    {
+        return memoize( m_locType, [&]() { return m_symbol->getLocType(); } );
+    }
+
+    virtual MachineTypes getMachineType()
+    {
+        return memoize( m_machineType, [&]() { return m_symbol->getMachineType(); } );
+    }
+
+    virtual std::wstring getName()
+    {
+        return memoize( m_name, [&]() { return m_symbol->getName(); } );
+    }
+
+    virtual NAME_ID getNameId()
+    {
+        return memoize( m_nameId, [&]() { return m_symbol->getNameId(); } );
+    }
+
+    virtual std::wstring getScopeName()
+    {
+        return memoize( m_scopeName, [&]() { return m_symbol->getScopeName(); } );
+    }
+
+    virtual MEMOFFSET_REL getOffset()
+    {
+        return memoize( m_offset, [&]() { return m_symbol->getOffset(); } );
+    }
+
+    virtual unsigned long getRva()
+    {
+        return memoize( m_rva, [&]() { return m_symbol->getRva(); } );
+    }
+
+    virtual size_t getSize()
+    {
+        return memoize( m_size, [&]() { return m_symbol->getSize(); } );
+    }
+
+    virtual SymTags getSymTag()
+    {
+        return memoize( m_symTag, [&]() { return m_symbol->getSymTag(); } );
+    }
+
+    virtual SymbolPtr getType()
+    {
+        return memoize( m_type, [&]() { return wrap( m_symbol->getType() ); } );
+    }
+
+    virtual unsigned long getUdtKind()
+    {
+        return memoize( m_udtKind, [&]() { return m_symbol->getUdtKind(); } );
+    }
+
+    virtual MEMOFFSET_64 getVa()
+    {
+        return memoize( m_va, [&]() { return m_symbol->getVa(); } );
+    }
+
+    virtual void getValue( NumVariant &vtValue )
+    {
+        vtValue = memoize( m_value, [&]() { NumVariant  value; m_symbol->getValue(value); return value; } );
+    }
+
+    virtual unsigned long getVirtualBaseDispIndex()
+    {
+        return memoize( m_virtualBaseDispIndex, [&]() { return m_symbol->getVirtualBaseDispIndex(); } );
+    }
+
+    virtual int getVirtualBasePointerOffset()
+    {
+        return memoize( m_virtualBasePointerOffset, [&]() { return m_symbol->getVirtualBasePointerOffset(); } );
+    }
+
+    virtual unsigned long getVirtualBaseDispSize()
+    {
+        return memoize( m_virtualBaseDispSize, [&]() { return m_symbol->getVirtualBaseDispSize(); } );
+    }
+
+    virtual bool isBasicType()
+    {
+        return memoize( m_isBasicType, [&]() { return m_symbol->isBasicType(); } );
+    }
+
+    virtual bool isConstant()
+    {
+        return memoize( m_isConstant, [&]() { return m_symbol->isConstant(); } );
+    }
+
+    virtual bool isIndirectVirtualBaseClass()
+    {
+        return memoize( m_isIndirectVirtualBaseClass, [&]() { return m_symbol->isIndirectVirtualBaseClass(); } );
+    }
+
+    virtual bool isVirtualBaseClass()
+    {
+        return memoize( m_isVirtualBaseClass, [&]() { return m_symbol->isVirtualBaseClass(); } );
+    }
+
+    virtual bool isVirtual()
+    {
+        return memoize( m_isVirtual, [&]() { return m_symbol->isVirtual(); } );
+    }
+
+    virtual unsigned long getRegisterId()
+    {
+        return memoize( m_registerId, [&]() { return m_symbol->getRegisterId(); } );
+    }
+
+    virtual unsigned long getRegRelativeId()
+    {
+        return memoize( m_regRelativeId, [&]() { return m_symbol->getRegRelativeId(); } );
+    }
+
+    virtual SymbolPtr getObjectPointerType()
+    {
+        return memoize( m_objectPointerType, [&]() { return wrap( m_symbol->getObjectPointerType() ); } );
+    }
+
+    virtual unsigned long getCallingConvention()
+    {
+        return memoize( m_callingConvention, [&]() { return m_symbol->getCallingConvention(); } );
+    }
+
+    // parents are not memoized: a parent keeps its children, so a child
+    // keeping its parent would never be released
+    virtual SymbolPtr getClassParent()
+    {
+        return wrap( m_symbol->getClassParent() );
+    }
+
+    virtual SymbolPtr getVirtualTableShape()
+    {
+        return memoize( m_virtualTableShape, [&]() { return wrap( m_symbol->getVirtualTableShape() ); } );
+    }
+
+    virtual unsigned long getVirtualBaseOffset()
+    {
+        return memoize( m_virtualBaseOffset, [&]() { return m_symbol->getVirtualBaseOffset(); } );
+    }
+
+    virtual SymbolPtrList findInlineFramesByVA( MEMOFFSET_64 va )
+    {
+        return wrapList( m_symbol->findInlineFramesByVA(va) );
+    }
+
+    virtual void getInlineSourceLine( MEMOFFSET_64 va, std::wstring &fileName, unsigned long &lineNo )
+    {
+        m_symbol->getInlineSourceLine(va, fileName, lineNo);
+    }
+
+    virtual SymbolPtr getLexicalParent()
+    {
+        return wrap( m_symbol->getLexicalParent() );
+    }
+
+private:
+
+    template<typename T, typename Getter>
+    T memoize( Memo<T> &memo, Getter getter )
+    {
+        {
+            boost::mutex::scoped_lock  lock(m_lock);
+            if ( memo.ready )
+                return memo.value;
+        }
+
+        // exceptions are not memoized: the backend is asked again
+        T  value = getter();
+
+        boost::mutex::scoped_lock  lock(m_lock);
+        memo.value = value;
+        memo.ready = true;
+        return value;
+    }
+
+    void setHasEntries()
+    {
+        boost::mutex::scoped_lock  lock(m_lock);
+        m_hasEntries = true;
+    }
+
+    SymbolPtr wrap( const SymbolPtr &symbol )
+    {
+        if ( !symbol )
+            return symbol;
+
+        return SymbolPtr( new CachingSymbol(symbol, m_cache.lock(), false) );
+    }
+
+    SymbolPtrList wrapList( const SymbolPtrList &symbols )
+    {
+        SymbolPtrList  wrapped;
+        for ( SymbolPtrList::const_iterator it = symbols.begin(); it != symbols.end(); ++it )
+            wrapped.push_back( wrap(*it) );
+        return wrapped;
+    }
+
+    template<typename Query>
+    SymbolPtrList cachedList( const QueryKey &key, Query query )
+    {
+        SymbolCachePtr  cache = m_cache.lock();
+        if ( !cache )
+            return wrapList( query() );
+
+        SymbolPtrList  symbols;
+        long long  value;
+
+        if ( cache->lookup(key, symbols, value) )
+            return symbols;
+
+        symbols = wrapList( query() );
+
+        setHasEntries();
+        cache->insert( key, symbols, 0 );
+
+        return symbols;
+    }
+
+    template<typename Query>
+    SymbolPtr cachedSymbol( const QueryKey &key, Query query )
+    {
+        SymbolCachePtr  cache = m_cache.lock();
+        if ( !cache )
+            return wrap( query() );
+
+        SymbolPtrList  symbols;
+        long long  value;
+
+        if ( cache->lookup(key, symbols, value) )
+            return symbols.front();
+
+        SymbolPtr  symbol = wrap( query() );
+        if ( !symbol )
+            return symbol;
+
+        symbols.push_back( symbol );
+
+        setHasEntries();
+        cache->insert( key, symbols, 0 );
+
+        return symbol;
+    }
+
+    template<typename Query>
+    long long cachedValue( const QueryKey &key, Query query )
+    {
+        SymbolCachePtr  cache = m_cache.lock();
+        if ( !cache )
+            return query();
+
+        SymbolPtrList  symbols;
+        long long  value;
+
+        if ( cache->lookup(key, symbols, value) )
+            return value;
+
+        value = query();
+
+        setHasEntries();
+        cache->insert( key, symbols, value );
+
+        return value;
+    }
+
+    SymbolPtr  m_symbol;
+
+    SymbolCacheWeakPtr  m_cache;
+    SymbolCachePtr  m_cacheOwner;
+    bool  m_hasEntries;
+
+    boost::mutex  m_lock;
+
+    Memo<unsigned long>  m_baseType;
+    Memo<BITOFFSET>  m_bitPosition;
+    Memo<size_t>  m_count;
+    Memo<unsigned long>  m_dataKind;
+    Memo<SymbolPtr>  m_indexType;
+    Memo<unsigned long>  m_locType;
+    Memo<MachineTypes>  m_machineType;
+    Memo<std::wstring>  m_name;
+    Memo<NAME_ID>  m_nameId;
+    Memo<std::wstring>  m_scopeName;
+    Memo<MEMOFFSET_REL>  m_offset;
+    Memo<unsigned long>  m_rva;
+    Memo<size_t>  m_size;
+    Memo<SymTags>  m_symTag;
+    Memo<SymbolPtr>  m_type;
+    Memo<unsigned long>  m_udtKind;
+    Memo<MEMOFFSET_64>  m_va;
+    Memo<NumVariant>  m_value;
+    Memo<unsigned long>  m_virtualBaseDispIndex;
+    Memo<int>  m_virtualBasePointerOffset;
+    Memo<unsigned long>  m_virtualBaseDispSize;
+    Memo<bool>  m_isBasicType;
+    Memo<bool>  m_isConstant;
+    Memo<bool>  m_isIndirectVirtualBaseClass;
+    Memo<bool>  m_isVirtualBaseClass;
+    Memo<bool>  m_isVirtual;
+    Memo<unsigned long>  m_registerId;
+    Memo<unsigned long>  m_regRelativeId;
+    Memo<SymbolPtr>  m_objectPointerType;
+    Memo<unsigned long>  m_callingConvention;
+    Memo<SymbolPtr>  m_virtualTableShape;
+    Memo<unsigned long>  m_virtualBaseOffset;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// memory charged per cached symbol: the wrapper itself, its shared_ptr control
+// block, the list node holding it and the backend object it keeps alive
+size_t getSymbolMemory( size_t backendSymbolSize )
+{
+    return sizeof(CachingSymbol) + 2 * sizeof(SymbolPtr) + 2 * sizeof(void*) + backendSymbolSize;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+class CachingSymbolSession : public SymbolSession
+{
+public:
+
+    CachingSymbolSession( const SymbolSessionPtr &session, size_t memoryBudget, size_t backendSymbolSize ) :
+        m_session( session ),
+        m_cache( boost::make_shared<SymbolCache>(memoryBudget, getSymbolMemory(backendSymbolSize)) )
+        {}
+
+    virtual SymbolPtr getSymbolScope()
+    {
+        boost::mutex::scoped_lock  lock(m_lock);
+
+        if ( !m_scope )
+            m_scope = SymbolPtr( new CachingSymbol(m_session->getSymbolScope(), m_cache, false) );
+
+        return m_scope;
+    }
+
+    virtual SymbolPtr findByRva( MEMOFFSET_32 rva, unsigned long symTag = SymTagNull, long* displacement = NULL )
+    {
+        QueryKey  key(this, QueryFindByRva, symTag, rva);
+
+        SymbolPtrList  symbols;
+        long long  disp = 0;
+
+        if ( !m_cache->lookup(key, symbols, disp) )
+        {
+            long  backendDisp = 0;
+            SymbolPtr  symbol = m_session->findByRva(rva, symTag, &backendDisp);
+            disp = backendDisp;
+
+            // a miss is cached as an empty list and returned as null
+            if ( symbol )
+                symbols.push_back( SymbolPtr( new CachingSymbol(symbol, m_cache, false) ) );
+
+            m_cache->insert( key, symbols, disp );
+        }
+
+        if ( displacement )
+            *displacement = static_cast<long>( disp );
+
+        return symbols.empty() ? SymbolPtr() : symbols.front();
+    }
+
+    virtual void getSourceLine( MEMOFFSET_64 offset, std::wstring &fileName, unsigned long &lineNo, long &displacement )
+    {
+        m_session->getSourceLine(offset, fileName, lineNo, displacement);
+    }
+
+    virtual void getLineTable( SymbolLineList &lines, std::vector<std::wstring> &fileNames )
+    {
+        m_session->getLineTable(lines, fileNames);
+    }
+
+    virtual std::wstring getSymbolFileName()
+    {
+        return m_session->getSymbolFileName();
+    }
+
+    SymbolCacheStats getStats()
+    {
+        return m_cache->getStats();
+    }
+
+    void clear()
+    {
+        m_cache->clear();
+    }
+
+private:
+
+    SymbolSessionPtr  m_session;
+
+    SymbolCachePtr  m_cache;
+
+    boost::mutex  m_lock;
+    SymbolPtr  m_scope;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // end nameless namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+SymbolSessionPtr getCachingSymbolSession( const SymbolSessionPtr &session, size_t memoryBudget, size_t backendSymbolSize )
+{
+    if ( !session || dynamic_cast<CachingSymbolSession*>( session.get() ) )
+        return session;
+
+    return SymbolSessionPtr( new CachingSymbolSession(session, memoryBudget, backendSymbolSize) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SymbolPtr getCachingSymbol( const SymbolPtr &symbol, size_t memoryBudget, size_t backendSymbolSize )
+{
+    if ( !symbol || dynamic_cast<CachingSymbol*>( symbol.get() ) )
+        return symbol;
+
+    SymbolCachePtr  cache = boost::make_shared<SymbolCache>(memoryBudget, getSymbolMemory(backendSymbolSize));
+
+    return SymbolPtr( new CachingSymbol(symbol, cache, true) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SymbolCacheStats getSymbolCacheStats( const SymbolSessionPtr &session )
+{
+    CachingSymbolSession  *cachingSession = dynamic_cast<CachingSymbolSession*>( session.get() );
+    if ( !cachingSession )
+        throw DbgException( "symbol session is not a caching one" );
+
+    return cachingSession->getStats();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SymbolCacheStats getSymbolCacheStats( const SymbolPtr &symbol )
+{
+    CachingSymbol  *cachingSymbol = dynamic_cast<CachingSymbol*>( symbol.get() );
+    if ( !cachingSymbol )
+        throw DbgException( "symbol is not a caching one" );
+
+    SymbolCachePtr  cache = cachingSymbol->getCache();
+    if ( !cache )
+        throw DbgException( "symbol cache is already released" );
+
+    return cache->getStats();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void clearSymbolCache( const SymbolSessionPtr &session )
+{
+    CachingSymbolSession  *cachingSession = dynamic_cast<CachingSymbolSession*>( session.get() );
+    if ( !cachingSession )
+        throw DbgException( "symbol session is not a caching one" );
+
+    cachingSession->clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
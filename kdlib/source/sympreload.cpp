@@ -0,0 +1,740 @@
+#include "stdafx.h"
+
+#include <map>
+#include <set>
+#include <queue>
+#include <vector>
+#include <algorithm>
+
+#include <boost/atomic.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include "kdlib/dbgengine.h"
+#include "kdlib/process.h"
+#include "kdlib/stack.h"
+#include "kdlib/eventhandler.h"
+#include "kdlib/exceptions.h"
+
+#include "sympreloadimpl.h"
+#include "fnmatch.h"
+
+namespace kdlib {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+
+const unsigned long  MaxPreloadThreads = 8;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Everything the engine is asked for is collected on the calling thread: a
+// job is run by a worker with the image snapshot only.
+
+class PreloadJob
+{
+public:
+
+    PreloadJob( MEMOFFSET_64 base, const std::wstring &imageName, const std::wstring &symbolPath,
+        const PeImageReaderPtr &snapshot ) :
+            m_base( base ),
+            m_imageName( imageName ),
+            m_symbolPath( symbolPath ),
+            m_snapshot( snapshot ),
+            m_started( false ),
+            m_cancelled( false ),
+            m_dequeued( false )
+    {
+        m_future = boost::shared_future<SymbolSessionPtr>( m_promise.get_future() );
+    }
+
+    // returns false if the job has been already started by another thread
+    bool run()
+    {
+        if ( m_started.exchange(true) )
+            return false;
+
+        try
+        {
+            m_promise.set_value( loadSymbolFile( m_base, m_imageName, m_symbolPath, m_snapshot ) );
+        }
+        catch( const SymbolException &e )
+        {
+            m_promise.set_exception( boost::copy_exception(e) );
+        }
+        catch( const DbgException &e )
+        {
+            m_promise.set_exception( boost::copy_exception(e) );
+        }
+        catch(...)
+        {
+            m_promise.set_exception( boost::current_exception() );
+        }
+
+        m_snapshot.reset();
+
+        return true;
+    }
+
+    bool cancel()
+    {
+        if ( m_started.exchange(true) )
+            return false;
+
+        m_cancelled = true;
+        m_promise.set_exception( boost::copy_exception( DbgException("symbol preload is cancelled") ) );
+        m_snapshot.reset();
+
+        return true;
+    }
+
+    // valid after the future is ready
+    bool isCancelled() const {
+        return m_cancelled;
+    }
+
+    bool isLoaded() const
+    {
+        try
+        {
+            return !!m_future.get();
+        }
+        catch(...)
+        {}
+
+        return false;
+    }
+
+    MEMOFFSET_64 getBase() const {
+        return m_base;
+    }
+
+    const std::wstring& getImageName() const {
+        return m_imageName;
+    }
+
+    const boost::shared_future<SymbolSessionPtr>& getFuture() const {
+        return m_future;
+    }
+
+    // a promoted job is queued twice: only the first entry is taken,
+    // called under the preload lock
+    bool dequeue()
+    {
+        if ( m_dequeued )
+            return false;
+
+        m_dequeued = true;
+        return true;
+    }
+
+    bool isDequeued() const {
+        return m_dequeued;
+    }
+
+private:
+
+    MEMOFFSET_64  m_base;
+    std::wstring  m_imageName;
+    std::wstring  m_symbolPath;
+    PeImageReaderPtr  m_snapshot;
+
+    boost::atomic<bool>  m_started;
+    bool  m_cancelled;
+    bool  m_dequeued;
+
+    boost::promise<SymbolSessionPtr>  m_promise;
+    boost::shared_future<SymbolSessionPtr>  m_future;
+};
+
+typedef boost::shared_ptr<PreloadJob>  PreloadJobPtr;
+
+struct QueuedJob {
+
+    PreloadJobPtr  job;
+    int  priority;
+    size_t  sequence;
+
+    bool operator < ( const QueuedJob &queued ) const {
+        if ( priority != queued.priority )
+            return priority < queued.priority;
+        return sequence > queued.sequence;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Jobs of all the preloads not yet taken by the modules
+
+class PreloadRegistry
+{
+public:
+
+    static PreloadRegistry& get() {
+        static PreloadRegistry  registry;
+        return registry;
+    }
+
+    void insert( PROCESS_DEBUG_ID processId, const PreloadJobPtr &job, const void* owner )
+    {
+        boost::mutex::scoped_lock  lock(m_lock);
+        m_jobs[ std::make_pair(processId, job->getBase()) ] = std::make_pair( owner, job );
+    }
+
+    PreloadJobPtr take( PROCESS_DEBUG_ID processId, MEMOFFSET_64 base )
+    {
+        boost::mutex::scoped_lock  lock(m_lock);
+
+        JobMap::iterator  it = m_jobs.find( std::make_pair(processId, base) );
+        if ( it == m_jobs.end() )
+            return PreloadJobPtr();
+
+        PreloadJobPtr  job = it->second.second;
+        m_jobs.erase(it);
+        return job;
+    }
+
+    void erase( PROCESS_DEBUG_ID processId, MEMOFFSET_64 base, const void* owner )
+    {
+        PreloadJobPtr  job;
+
+        boost::mutex::scoped_lock  lock(m_lock);
+
+        JobMap::iterator  it = m_jobs.find( std::make_pair(processId, base) );
+        if ( it != m_jobs.end() && it->second.first == owner )
+        {
+            job = it->second.second;
+            m_jobs.erase(it);
+        }
+    }
+
+    void eraseOwner( const void* owner )
+    {
+        std::vector<PreloadJobPtr>  jobs;
+
+        boost::mutex::scoped_lock  lock(m_lock);
+
+        for ( JobMap::iterator it = m_jobs.begin(); it != m_jobs.end(); )
+        {
+            if ( it->second.first == owner )
+            {
+                jobs.push_back( it->second.second );
+                it = m_jobs.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+private:
+
+    typedef std::map< std::pair<PROCESS_DEBUG_ID, MEMOFFSET_64>, std::pair<const void*, PreloadJobPtr> >  JobMap;
+
+    boost::mutex  m_lock;
+    JobMap  m_jobs;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class SymbolPreloadImpl;
+
+// The module events are watched only with onModuleLoad
+
+class PreloadEvents : public EventHandler
+{
+public:
+
+    explicit PreloadEvents( SymbolPreloadImpl &preload ) :
+        m_preload( preload )
+        {}
+
+    virtual DebugCallbackResult onModuleLoad( MEMOFFSET_64 offset, const std::wstring &name );
+
+    virtual DebugCallbackResult onModuleUnload( MEMOFFSET_64 offset, const std::wstring &name );
+
+    virtual void onChangeSymbolPaths();
+
+private:
+
+    SymbolPreloadImpl  &m_preload;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class SymbolPreloadImpl : public SymbolPreload
+{
+public:
+
+    SymbolPreloadImpl( const SymbolPreloadPolicy &policy ) :
+        m_policy( policy ),
+        m_matcher( policy.moduleMask, false ),
+        m_processId( getCurrentProcessId() ),
+        m_symbolPath( getSymbolPath() ),
+        m_sequence( 0 ),
+        m_activeCount( 0 ),
+        m_completedCount( 0 ),
+        m_failedCount( 0 ),
+        m_filling( true ),
+        m_cancelled( false ),
+        m_stopped( false )
+    {}
+
+    virtual ~SymbolPreloadImpl()
+    {
+        m_events.reset();
+        stop();
+        PreloadRegistry::get().eraseOwner( this );
+    }
+
+    void start()
+    {
+        std::vector<MEMOFFSET_64>  bases;
+
+        for ( unsigned long i = 0; i < getNumberModules(); ++i )
+        {
+            MEMOFFSET_64  base = getModuleOffsetByIndex(i);
+
+            try
+            {
+                if ( m_matcher.match( getModuleName(base) ) )
+                    bases.push_back(base);
+            }
+            catch( const DbgException& )
+            {}
+        }
+
+        unsigned long  threadCount = m_policy.threadCount;
+        if ( threadCount == 0 )
+            threadCount = std::min<unsigned long>( std::max( boost::thread::hardware_concurrency(), 1U ), MaxPreloadThreads );
+
+        if ( !m_policy.onModuleLoad )
+            threadCount = std::min<unsigned long>( threadCount, static_cast<unsigned long>(bases.size()) );
+
+        if ( m_policy.onModuleLoad )
+            m_events.reset( new PreloadEvents(*this) );
+
+        // the workers load the modules while the stacks are walked: the
+        // modules found on the stacks are moved ahead of the queue then
+        for ( unsigned long i = 0; i < threadCount; ++i )
+            m_workers.create_thread( boost::bind( &SymbolPreloadImpl::worker, this ) );
+
+        try
+        {
+            for ( size_t i = 0; i < bases.size(); ++i )
+                enqueue( bases[i], 0 );
+
+            if ( m_policy.stackModulesFirst )
+            {
+                std::set<MEMOFFSET_64>  stackModules;
+                getStackModules( bases, stackModules );
+
+                for ( std::set<MEMOFFSET_64>::const_iterator it = stackModules.begin(); it != stackModules.end(); ++it )
+                    enqueue( *it, 1 );
+            }
+        }
+        catch(...)
+        {
+            stopFilling();
+            throw;
+        }
+
+        stopFilling();
+    }
+
+    virtual SymbolPreloadProgress getProgress()
+    {
+        boost::mutex::scoped_lock  lock(m_lock);
+
+        SymbolPreloadProgress  progress;
+        progress.total = m_jobs.size();
+        progress.completed = m_completedCount;
+        progress.failed = m_failedCount;
+        return progress;
+    }
+
+    virtual bool isCompleted()
+    {
+        boost::mutex::scoped_lock  lock(m_lock);
+        return m_queue.empty() && m_activeCount == 0;
+    }
+
+    virtual void wait()
+    {
+        boost::mutex::scoped_lock  lock(m_lock);
+        while ( !m_queue.empty() || m_activeCount != 0 )
+            m_doneCond.wait(lock);
+    }
+
+    virtual void cancel()
+    {
+        std::vector<PreloadJobPtr>  queued;
+
+        {
+            boost::mutex::scoped_lock  lock(m_lock);
+
+            m_cancelled = true;
+
+            for ( ; !m_queue.empty(); m_queue.pop() )
+            {
+                if ( m_queue.top().job->dequeue() )
+                    queued.push_back( m_queue.top().job );
+            }
+        }
+
+        for ( size_t i = 0; i < queued.size(); ++i )
+        {
+            PreloadRegistry::get().erase( m_processId, queued[i]->getBase(), this );
+            queued[i]->cancel();
+        }
+
+        m_queueCond.notify_all();
+        m_doneCond.notify_all();
+    }
+
+    virtual boost::shared_future<SymbolSessionPtr> getModuleSymbols( MEMOFFSET_64 moduleBase )
+    {
+        boost::mutex::scoped_lock  lock(m_lock);
+
+        JobMap::iterator  it = m_jobs.find( moduleBase );
+        if ( it == m_jobs.end() )
+            throw DbgException("the module symbols are not preloaded");
+
+        return it->second->getFuture();
+    }
+
+    void onModuleLoad( MEMOFFSET_64 offset, const std::wstring &name )
+    {
+        if ( m_matcher.match(name) )
+        {
+            try
+            {
+                enqueue( offset, 0 );
+            }
+            catch( const DbgException& )
+            {}
+        }
+    }
+
+    void onModuleUnload( MEMOFFSET_64 offset )
+    {
+        PreloadRegistry::get().erase( m_processId, offset, this );
+    }
+
+    void onChangeSymbolPaths()
+    {
+        try
+        {
+            std::wstring  symbolPath = getSymbolPath();
+
+            boost::mutex::scoped_lock  lock(m_lock);
+            m_symbolPath = symbolPath;
+        }
+        catch( const DbgException& )
+        {}
+    }
+
+private:
+
+    // a queued module is queued again with a higher priority
+    void enqueue( MEMOFFSET_64 base, int priority )
+    {
+        if ( getCurrentProcessId() != m_processId )
+            return;
+
+        {
+            boost::mutex::scoped_lock  lock(m_lock);
+
+            if ( m_cancelled )
+                return;
+
+            JobMap::iterator  it = m_jobs.find(base);
+            if ( it != m_jobs.end() )
+            {
+                if ( priority > 0 && !it->second->isDequeued() )
+                {
+                    QueuedJob  queued = { it->second, priority, m_sequence++ };
+                    m_queue.push( queued );
+                }
+
+                return;
+            }
+        }
+
+        // a module without an image name or with a paged out loader entry is
+        // skipped, as a module the worker fails to load
+        std::wstring  imageName;
+
+        try
+        {
+            imageName = getModuleImageName(base);
+        }
+        catch( const DbgException& )
+        {
+            return;
+        }
+
+        PeImageReaderPtr  snapshot;
+
+        try
+        {
+            snapshot = getPeDebugInfoSnapshot( *getPeMemoryReader(base) );
+        }
+        catch( const DbgException& )
+        {
+            // the image headers are paged out, try the image file
+            if ( imageName.empty() )
+                return;
+
+            try
+            {
+                snapshot = getPeDebugInfoSnapshot( *getPeFileReader(imageName) );
+            }
+            catch( const DbgException& )
+            {
+                return;
+            }
+        }
+
+        PreloadJobPtr  job;
+
+        {
+            boost::mutex::scoped_lock  lock(m_lock);
+
+            if ( m_cancelled || m_jobs.find(base) != m_jobs.end() )
+                return;
+
+            job = PreloadJobPtr( new PreloadJob( base, imageName, m_symbolPath, snapshot ) );
+
+            m_jobs.insert( std::make_pair(base, job) );
+
+            QueuedJob  queued = { job, priority, m_sequence++ };
+            m_queue.push( queued );
+        }
+
+        PreloadRegistry::get().insert( m_processId, job, this );
+
+        m_queueCond.notify_one();
+    }
+
+    // The stacks are unwound by the worker pool of getAllStacks, the calling
+    // thread only serves the engine requests
+    void getStackModules( const std::vector<MEMOFFSET_64> &bases, std::set<MEMOFFSET_64> &stackModules )
+    {
+        std::vector< std::pair<MEMOFFSET_64, MEMOFFSET_64> >  ranges;
+
+        for ( size_t i = 0; i < bases.size(); ++i )
+            ranges.push_back( std::make_pair( bases[i], bases[i] + getModuleSize(bases[i]) ) );
+
+        std::sort( ranges.begin(), ranges.end() );
+
+        try
+        {
+            AllStacksOptions  options;
+            options.threadCount = m_policy.threadCount;
+
+            AllStacks  allStacks = getAllStacks( options );
+
+            for ( size_t i = 0; i < allStacks.threads.size(); ++i )
+            {
+                StackPtr  stack = allStacks.threads[i].stack;
+
+                for ( unsigned long j = 0; j < stack->getFrameCount(); ++j )
+                {
+                    MEMOFFSET_64  ip = stack->getFrame(j)->getIP();
+
+                    std::vector< std::pair<MEMOFFSET_64, MEMOFFSET_64> >::iterator  it =
+                        std::upper_bound( ranges.begin(), ranges.end(), std::make_pair( ip, ~MEMOFFSET_64(0) ) );
+
+                    if ( it != ranges.begin() && ip < (--it)->second )
+                        stackModules.insert( it->first );
+                }
+            }
+        }
+        catch( const DbgException& )
+        {}
+    }
+
+    void worker()
+    {
+        SymbolLoaderThread  loaderThread;
+
+        while ( true )
+        {
+            PreloadJobPtr  job;
+
+            {
+                boost::mutex::scoped_lock  lock(m_lock);
+
+                while ( true )
+                {
+                    // without the module load events nothing is queued after start
+                    while ( m_queue.empty() && ( m_filling || m_policy.onModuleLoad ) && !m_cancelled && !m_stopped )
+                        m_queueCond.wait(lock);
+
+                    if ( m_queue.empty() )
+                        return;
+
+                    QueuedJob  queued = m_queue.top();
+                    m_queue.pop();
+
+                    if ( queued.job->dequeue() )
+                    {
+                        job = queued.job;
+                        break;
+                    }
+                }
+
+                ++m_activeCount;
+            }
+
+            // the module could be asked for its symbols and load them itself
+            if ( !job->run() )
+                job->getFuture().wait();
+
+            {
+                boost::mutex::scoped_lock  lock(m_lock);
+
+                --m_activeCount;
+
+                if ( job->isLoaded() )
+                    ++m_completedCount;
+                else
+                    ++m_failedCount;
+            }
+
+            m_doneCond.notify_all();
+        }
+    }
+
+    void stopFilling()
+    {
+        {
+            boost::mutex::scoped_lock  lock(m_lock);
+            m_filling = false;
+        }
+
+        m_queueCond.notify_all();
+        m_doneCond.notify_all();
+    }
+
+    void stop()
+    {
+        cancel();
+
+        {
+            boost::mutex::scoped_lock  lock(m_lock);
+            m_stopped = true;
+        }
+
+        m_queueCond.notify_all();
+        m_workers.join_all();
+    }
+
+private:
+
+    typedef std::map<MEMOFFSET_64, PreloadJobPtr>  JobMap;
+    typedef std::priority_queue<QueuedJob>  JobQueue;
+
+    SymbolPreloadPolicy  m_policy;
+    GlobMatcher  m_matcher;
+    PROCESS_DEBUG_ID  m_processId;
+    std::wstring  m_symbolPath;
+
+    boost::mutex  m_lock;
+    boost::condition_variable  m_queueCond;
+    boost::condition_variable  m_doneCond;
+
+    JobMap  m_jobs;
+    JobQueue  m_queue;
+    size_t  m_sequence;
+    size_t  m_activeCount;
+    size_t  m_completedCount;
+    size_t  m_failedCount;
+    bool  m_filling;
+    bool  m_cancelled;
+    bool  m_stopped;
+
+    boost::thread_group  m_workers;
+
+    boost::scoped_ptr<PreloadEvents>  m_events;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+DebugCallbackResult PreloadEvents::onModuleLoad( MEMOFFSET_64 offset, const std::wstring &name )
+{
+    m_preload.onModuleLoad( offset, name );
+    return DebugCallbackNoChange;
+}
+
+DebugCallbackResult PreloadEvents::onModuleUnload( MEMOFFSET_64 offset, const std::wstring &name )
+{
+    m_preload.onModuleUnload( offset );
+    return DebugCallbackNoChange;
+}
+
+void PreloadEvents::onChangeSymbolPaths()
+{
+    m_preload.onChangeSymbolPaths();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // anonymous namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+SymbolPreloadPtr preloadSymbols( const SymbolPreloadPolicy &policy )
+{
+    boost::shared_ptr<SymbolPreloadImpl>  preload( new SymbolPreloadImpl(policy) );
+    preload->start();
+    return preload;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool takePreloadedSymbols( MEMOFFSET_64 moduleBase, const std::wstring &imageName, SymbolSessionPtr &session )
+{
+    PreloadJobPtr  job;
+
+    try
+    {
+        job = PreloadRegistry::get().take( getCurrentProcessId(), moduleBase );
+    }
+    catch( const DbgException& )
+    {}
+
+    // without the module events an unloaded module is not erased: the job of
+    // another image at the same base is dropped
+    if ( !job || job->getImageName() != imageName )
+        return false;
+
+    // still in the queue: load it here instead of waiting for a worker
+    job->run();
+
+    const boost::shared_future<SymbolSessionPtr>  &future = job->getFuture();
+    future.wait();
+
+    if ( job->isCancelled() )
+        return false;
+
+    try
+    {
+        session = future.get();
+    }
+    catch(...)
+    {
+        session.reset();
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
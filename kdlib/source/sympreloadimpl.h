@@ -0,0 +1,41 @@
+#pragma once
+
+#include "kdlib/sympreload.h"
+
+#include "peimage.h"
+
+namespace kdlib {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Prepares a preload worker thread for the DIA loads (COM) for its whole life
+class SymbolLoaderThread
+{
+public:
+
+    SymbolLoaderThread();
+    ~SymbolLoaderThread();
+
+private:
+
+    bool  m_initialized;
+};
+
+// Loads symbols with DIA from a worker thread: the image data comes from the
+// snapshot and the search path is given, so the debug engine is not used
+SymbolSessionPtr loadSymbolFile(
+    MEMOFFSET_64 loadBase,
+    const std::wstring &executable,
+    const std::wstring &symbolSearchPath,
+    const PeImageReaderPtr &imageReader
+);
+
+// Waits for the preloaded session of the current process module.
+// Returns false if the module was not preloaded or another image was
+// preloaded at its base, session is empty if the preload failed. The session
+// is handed out only once.
+bool takePreloadedSymbols( MEMOFFSET_64 moduleBase, const std::wstring &imageName, SymbolSessionPtr &session );
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
@@ -155,7 +155,7 @@ TypedValue castPtrArg(TypeInfoPtr& destType, const TypedValue& arg)
 
 TypedValue castUdt(TypeInfoPtr& destType, const TypedValue& arg)
 {
-    if (destType->getName() == arg.getType()->getName() )
+    if (destType->getNameId() == arg.getType()->getNameId() )
     {
         if ( destType->getPtrSize() == 4 && destType->getSize() <= 4 )
         {
@@ -177,6 +177,55 @@ TypedValue castUdt(TypeInfoPtr& destType, const TypedValue& arg)
     NOT_IMPLEMENTED();
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+// The names of the base types are interned once: a base type variable is read
+// and written by the id of its type name
+
+struct BaseTypeNames
+{
+    BaseTypeNames() :
+        Char( L"Char" ),
+        WChar( L"WChar" ),
+        Long( L"Long" ),
+        ULong( L"ULong" ),
+        Int1B( L"Int1B" ),
+        UInt1B( L"UInt1B" ),
+        Int2B( L"Int2B" ),
+        UInt2B( L"UInt2B" ),
+        Int4B( L"Int4B" ),
+        UInt4B( L"UInt4B" ),
+        Int8B( L"Int8B" ),
+        UInt8B( L"UInt8B" ),
+        Float( L"Float" ),
+        Double( L"Double" ),
+        Bool( L"Bool" ),
+        Hresult( L"Hresult" )
+        {}
+
+    InternedName  Char;
+    InternedName  WChar;
+    InternedName  Long;
+    InternedName  ULong;
+    InternedName  Int1B;
+    InternedName  UInt1B;
+    InternedName  Int2B;
+    InternedName  UInt2B;
+    InternedName  Int4B;
+    InternedName  UInt4B;
+    InternedName  Int8B;
+    InternedName  UInt8B;
+    InternedName  Float;
+    InternedName  Double;
+    InternedName  Bool;
+    InternedName  Hresult;
+};
+
+const BaseTypeNames& getBaseTypeNames()
+{
+    static const BaseTypeNames  baseTypeNames;
+    return baseTypeNames;
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -344,10 +393,12 @@ TypedVarPtr loadTypedVar( const std::wstring &funcName, const std::wstring &prot
 
     SymbolPtrList  functions = module->getSymbolScope()->findChildren(SymTagFunction);
 
+    const InternedName  internedName(funcName);
+
     for ( SymbolPtrList::iterator  it = functions.begin(); it != functions.end(); ++it )
     {
         SymbolPtr  sym = *it;
-        if ( sym->getName() == funcName  )
+        if ( sym->getNameId() == internedName.getId() )
         {
             TypeInfoPtr  funcType = loadType(sym->getType());
             if ( isPrototypeMatch( funcType, prototype ) )
@@ -677,52 +728,55 @@ TypedVarPtr TypedVarImp::castTo(const TypeInfoPtr &typeInfo) const
 
 NumVariant TypedVarBase::getValue() const
 {
-    if ( m_typeInfo->getName() == L"Char" )
+    const BaseTypeNames  &names = getBaseTypeNames();
+    const NAME_ID  nameId = m_typeInfo->getNameId();
+
+    if ( nameId == names.Char.getId() )
         return NumVariant( m_varData->readSignByte() );
 
-    if ( m_typeInfo->getName() == L"WChar" )
+    if ( nameId == names.WChar.getId() )
         return NumVariant( m_varData->readSignWord() );
 
-    if ( m_typeInfo->getName() == L"Long" )
+    if ( nameId == names.Long.getId() )
         return NumVariant( m_varData->readSignDWord() );
 
-    if ( m_typeInfo->getName() == L"ULong" )
+    if ( nameId == names.ULong.getId() )
         return NumVariant( m_varData->readDWord() );
 
-    if ( m_typeInfo->getName() == L"Int1B" )
+    if ( nameId == names.Int1B.getId() )
         return NumVariant( m_varData->readSignByte() );
 
-    if ( m_typeInfo->getName() == L"UInt1B" )
+    if ( nameId == names.UInt1B.getId() )
         return NumVariant( m_varData->readByte() );
 
-    if ( m_typeInfo->getName() == L"Int2B" )
+    if ( nameId == names.Int2B.getId() )
         return NumVariant( m_varData->readSignWord() );
 
-    if ( m_typeInfo->getName() == L"UInt2B" )
+    if ( nameId == names.UInt2B.getId() )
         return NumVariant( m_varData->readWord() );
 
-    if ( m_typeInfo->getName() == L"Int4B" )
+    if ( nameId == names.Int4B.getId() )
         return NumVariant( m_varData->readSignDWord() );
 
-    if ( m_typeInfo->getName() == L"UInt4B" )
+    if ( nameId == names.UInt4B.getId() )
         return NumVariant( m_varData->readDWord() );
 
-    if ( m_typeInfo->getName() == L"Int8B" )
+    if ( nameId == names.Int8B.getId() )
         return NumVariant( m_varData->readSignQWord() );
 
-    if ( m_typeInfo->getName() == L"UInt8B" )
+    if ( nameId == names.UInt8B.getId() )
         return NumVariant( m_varData->readQWord() );
 
-    if ( m_typeInfo->getName() == L"Float" )
+    if ( nameId == names.Float.getId() )
         return NumVariant( m_varData->readFloat() );
 
-    if ( m_typeInfo->getName() == L"Double" )
+    if ( nameId == names.Double.getId() )
         return NumVariant( m_varData->readDouble() );
 
-    if ( m_typeInfo->getName() == L"Bool" )
+    if ( nameId == names.Bool.getId() )
         return NumVariant( 0 != m_varData->readByte() );
 
-    if ( m_typeInfo->getName() == L"Hresult" )
+    if ( nameId == names.Hresult.getId() )
         return NumVariant( m_varData->readDWord() );
 
     throw TypeException(  m_typeInfo->getName(), L" unsupported based type");
@@ -732,52 +786,55 @@ NumVariant TypedVarBase::getValue() const
 
 void TypedVarBase::setValue(const NumVariant& value)
 {
-    if ( m_typeInfo->getName() == L"Char" )
+    const BaseTypeNames  &names = getBaseTypeNames();
+    const NAME_ID  nameId = m_typeInfo->getNameId();
+
+    if ( nameId == names.Char.getId() )
         return m_varData->writeSignByte( value.asChar() );
 
-    if ( m_typeInfo->getName() == L"WChar" )
+    if ( nameId == names.WChar.getId() )
         return m_varData->writeSignWord(value.asShort() );
 
-    if ( m_typeInfo->getName() == L"Long" )
+    if ( nameId == names.Long.getId() )
         return m_varData->writeSignDWord(value.asLong());
 
-    if ( m_typeInfo->getName() == L"ULong" )
+    if ( nameId == names.ULong.getId() )
         return m_varData->writeDWord(value.asULong());
 
-    if ( m_typeInfo->getName() == L"Int1B" )
+    if ( nameId == names.Int1B.getId() )
         return m_varData->writeSignByte(value.asChar());
         
-    if ( m_typeInfo->getName() == L"UInt1B" )
+    if ( nameId == names.UInt1B.getId() )
         return m_varData->writeByte(value.asUChar());
 
-    if ( m_typeInfo->getName() == L"Int2B" )
+    if ( nameId == names.Int2B.getId() )
         return m_varData->writeSignWord(value.asShort());
 
-    if ( m_typeInfo->getName() == L"UInt2B" )
+    if ( nameId == names.UInt2B.getId() )
         return m_varData->writeWord(value.asUShort());
 
-    if ( m_typeInfo->getName() == L"Int4B" )
+    if ( nameId == names.Int4B.getId() )
         return m_varData->writeSignDWord(value.asLong());
 
-    if ( m_typeInfo->getName() == L"UInt4B" )
+    if ( nameId == names.UInt4B.getId() )
         return m_varData->writeDWord(value.asULong());
         
-    if ( m_typeInfo->getName() == L"Int8B" )
+    if ( nameId == names.Int8B.getId() )
         return m_varData->writeSignQWord(value.asLongLong());
 
-    if ( m_typeInfo->getName() == L"UInt8B" )
+    if ( nameId == names.UInt8B.getId() )
         return m_varData->writeQWord(value.asULongLong());
 
-    if ( m_typeInfo->getName() == L"Float" )
+    if ( nameId == names.Float.getId() )
         return m_varData->writeFloat(value.asFloat());
 
-    if ( m_typeInfo->getName() == L"Double" )
+    if ( nameId == names.Double.getId() )
         return m_varData->writeDouble(value.asDouble());
 
-    if ( m_typeInfo->getName() == L"Bool" )
+    if ( nameId == names.Bool.getId() )
         return m_varData->writeByte(value.asUChar());
 
-    if ( m_typeInfo->getName() == L"Hresult" )
+    if ( nameId == names.Hresult.getId() )
         return m_varData->writeDWord(value.asULong());
 
     throw TypeException(  m_typeInfo->getName(), L" unsupported based type");
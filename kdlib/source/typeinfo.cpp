@@ -975,7 +975,8 @@ TypedVarPtr TypeInfoImp::getVar(const DataAccessorPtr &dataSource)
 
 bool TypeInfoImp::isTemplate()
 {
-    return getName().find_first_of(L'<') != std::wstring::npos;
+    // the interned name is not copied
+    return getInternedNameView(getNameId()).find(L'<') != boost::wstring_view::npos;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -2098,6 +2099,20 @@ TypeInfoPtr makeBoolConst(bool val)
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void TypeInfoProvider::appendSource(const std::wstring& source)
+{
+    throw TypeException(L"the type provider can not be extended by a source");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned long TypeInfoProvider::getGeneration()
+{
+    return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 TypeInfoProviderPtr  getTypeInfoProviderFromPdb( const std::wstring&  pdbFile, MEMOFFSET_64  loadBase )
 {
     return TypeInfoProviderPtr( new TypeInfoSymbolProvider(pdbFile, loadBase) );
@@ -2107,7 +2122,9 @@ TypeInfoProviderPtr  getTypeInfoProviderFromPdb( const std::wstring&  pdbFile, M
 
 TypeInfoProviderPtr  getDefaultTypeInfoProvider()
 {
-    return TypeInfoProviderPtr(new TypeInfoDefaultProvider());
+    // the provider has no state, one instance is shared
+    static const TypeInfoProviderPtr  defaultProvider(new TypeInfoDefaultProvider());
+    return defaultProvider;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -2186,6 +2203,8 @@ TypeInfoSymbolEnum::TypeInfoSymbolEnum(SymbolSessionPtr& symSession, const std::
     m_index = 0;
     SymbolPtr  symScope = symSession->getSymbolScope();
     size_t  symCount = symScope->getChildCount();
+
+    GlobMatcher  matcher(mask);
     
     for (size_t index = 0; index < symCount; index++)
     {
@@ -2196,7 +2215,7 @@ TypeInfoSymbolEnum::TypeInfoSymbolEnum(SymbolSessionPtr& symSession, const std::
 
         std::wstring  symName = sym->getName();
 
-        if (mask.empty() || fnmatch(mask, symName))
+        if (mask.empty() || matcher.match(symName))
         {
             m_typeList.push_back(loadType(sym));
         }
@@ -44,6 +44,11 @@ protected:
         NOT_IMPLEMENTED();
     }
 
+    NAME_ID getNameId() override
+    {
+        return m_nameId.get( [this]() { return getName(); } );
+    }
+
     std::wstring getScopeName() override
     {
         throw TypeException( getName(), L"type has no scope name" );
@@ -386,6 +391,8 @@ protected:
 
     NumVariant  m_constantValue;
 
+    LazyInternedName  m_nameId;
+
     virtual NumVariant getValue() const 
     {
         if ( !m_constant )
@@ -422,7 +429,11 @@ protected:
     virtual size_t getElementIndex( const std::wstring &name );
 
     virtual std::wstring getName() {
-        return m_name;
+        return m_name.str();
+    }
+
+    NAME_ID getNameId() override {
+        return m_name.getId();
     }
 
     virtual size_t getElementCount();
@@ -450,7 +461,7 @@ protected:
 
     FieldCollection  m_fields;
 
-    std::wstring  m_name;
+    InternedName  m_name;
 
     virtual void getFields() = 0;
 
@@ -731,11 +742,15 @@ public:
 protected:
 
     virtual std::wstring str() {
-        return m_name;
+        return m_name.str();
     }
 
     virtual std::wstring getName() {
-        return m_name;
+        return m_name.str();
+    }
+
+    NAME_ID getNameId() override {
+        return m_name.getId();
     }
 
     virtual size_t getSize() {
@@ -756,7 +771,7 @@ protected:
 
 protected:
 
-    std::wstring  m_name;
+    InternedName  m_name;
     size_t  m_ptrSize;
 };
 
@@ -8,6 +8,7 @@
 #include "kdlib/dbgengine.h"
 #include "kdlib/typeinfo.h"
 #include "kdlib/exceptions.h"
+#include "kdlib/nametable.h"
 
 namespace kdlib {
 
@@ -41,7 +42,12 @@ public:
 
     const std::wstring& getName() const
     {
-        return m_name;
+        return m_name.str();
+    }
+
+    NAME_ID getNameId() const
+    {
+        return m_name.getId();
     }
 
     const std::wstring& getVirtualBaseClassName() const 
@@ -52,13 +58,13 @@ public:
     MEMOFFSET_REL getOffset() const
     {
         if ( m_staticMember )
-            throw TypeException( m_name, L"static field has no offset" );
+            throw TypeException( m_name.str(), L"static field has no offset" );
 
         if (m_methodMember )
-            throw TypeException(m_name, L"method has no offset");
+            throw TypeException(m_name.str(), L"method has no offset");
 
         if (m_constMember)
-            throw TypeException(m_name, L"constant has no offset");
+            throw TypeException(m_name.str(), L"constant has no offset");
 
         return m_offset;
     }
@@ -103,13 +109,13 @@ public:
         if ( m_staticMember )
             return m_staticOffset;
   
-        throw TypeException( m_name, L"this is not a static field" );
+        throw TypeException( m_name.str(), L"this is not a static field" );
     }
 
     void getVirtualDisplacement( MEMOFFSET_32 &virtualBasePtr, size_t &virtualDispIndex, size_t &virtualDispSize )
     {
         if ( !m_virtualMember )
-            throw TypeException( m_name, L"this is not a virtual member" );
+            throw TypeException( m_name.str(), L"this is not a virtual member" );
 
        virtualBasePtr = m_virtualBasePtr;
        virtualDispIndex = m_virtualDispIndex;
@@ -119,7 +125,7 @@ public:
     virtual TypeInfoPtr getTypeInfo() = 0;
 
     virtual NumVariant getValue() const {
-        throw TypeException(  m_name, L"filed has no value" );
+        throw TypeException(  m_name.str(), L"filed has no value" );
     }
 
 protected:
@@ -139,7 +145,7 @@ protected:
          m_vtblMember(false)
          {}
 
-    std::wstring  m_name;
+    InternedName  m_name;
 
     std::wstring  m_virtualBaseName;
 
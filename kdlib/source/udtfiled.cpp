@@ -3,6 +3,7 @@
 #include <sstream>
 
 #include "kdlib/exceptions.h"
+#include "kdlib/nametable.h"
 
 #include "udtfield.h"
 
@@ -12,17 +13,24 @@ namespace kdlib {
 
 const TypeFieldPtr& FieldCollection::lookup(const std::wstring &name) const
 {
-    FieldList::const_iterator it;
-    for (it = m_fields.begin(); it != m_fields.end(); ++it)
+    // a name which is not interned can not belong to any field
+    InternedName  internedName;
+    if ( InternedName::find(name, internedName) )
     {
-        if ( !(*it)->isInheritedMember() && (*it)->getName() == name)
-            return *it;
-    }
-
-    for (it = m_fields.begin(); it != m_fields.end(); ++it)
-    {
-        if ( (*it)->isInheritedMember() && (*it)->getName() == name )
-            return *it;
+        NAME_ID  nameId = internedName.getId();
+
+        FieldList::const_iterator it;
+        for (it = m_fields.begin(); it != m_fields.end(); ++it)
+        {
+            if ( !(*it)->isInheritedMember() && (*it)->getNameId() == nameId)
+                return *it;
+        }
+
+        for (it = m_fields.begin(); it != m_fields.end(); ++it)
+        {
+            if ( (*it)->isInheritedMember() && (*it)->getNameId() == nameId )
+                return *it;
+        }
     }
 
     std::wstringstream   sstr;
@@ -62,13 +70,17 @@ TypeFieldPtr& FieldCollection::lookup(size_t index)
 
 size_t FieldCollection::getIndex(const std::wstring &name) const
 {
-    size_t  index = 0;
-
-    FieldList::const_iterator it;
-    for ( it = m_fields.begin(); it != m_fields.end(); ++it, ++index )
+    InternedName  internedName;
+    if ( InternedName::find(name, internedName) )
     {
-        if ( (*it)->getName() == name )
-            return index;
+        size_t  index = 0;
+
+        FieldList::const_iterator it;
+        for ( it = m_fields.begin(); it != m_fields.end(); ++it, ++index )
+        {
+            if ( (*it)->getNameId() == internedName.getId() )
+                return index;
+        }
     }
 
     std::wstringstream   sstr;
@@ -0,0 +1,191 @@
+#include "stdafx.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "kdlib/dbgengine.h"
+#include "kdlib/memaccess.h"
+#include "kdlib/exceptions.h"
+
+#include "unwind.h"
+#include "processmon.h"
+
+namespace kdlib {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+
+const boost::uint16_t  MachineAmd64 = 0x8664;
+const boost::uint16_t  MachineArm64 = 0xAA64;
+
+const size_t  RuntimeFunctionAmd64Size = 12;
+const size_t  RuntimeFunctionArm64Size = 8;
+
+bool functionLess( const UnwindFunction &function1, const UnwindFunction &function2 )
+{
+    return function1.begin < function2.begin;
+}
+
+bool functionBeginLess( boost::uint32_t rva, const UnwindFunction &function )
+{
+    return rva < function.begin;
+}
+
+// An ARM64 entry is the function RVA and its unwind data: the packed data
+// keeps the function length, the .xdata record does it too but it is not
+// read here. Such a function ends where the next one begins, the unwinder
+// checks the length by the record.
+
+void readFunctionsArm64( const PeExceptionDirectory &exceptionDir, std::vector<UnwindFunction> &functions )
+{
+    size_t  count = exceptionDir.data.size() / RuntimeFunctionArm64Size;
+
+    functions.reserve( count );
+
+    for ( size_t i = 0; i < count; ++i )
+    {
+        boost::uint32_t  entry[2];
+        memcpy( entry, &exceptionDir.data[i * RuntimeFunctionArm64Size], RuntimeFunctionArm64Size );
+
+        if ( entry[0] == 0 && entry[1] == 0 )
+            continue;
+
+        UnwindFunction  function;
+        function.begin = entry[0];
+        function.unwindData = entry[1];
+        function.end = ( entry[1] & 0x3 ) != 0 ? entry[0] + ( ( entry[1] >> 2 ) & 0x7FF ) * 4 : exceptionDir.imageSize;
+
+        functions.push_back( function );
+    }
+
+    if ( !std::is_sorted( functions.begin(), functions.end(), functionLess ) )
+        std::sort( functions.begin(), functions.end(), functionLess );
+
+    for ( size_t i = 0; i + 1 < functions.size(); ++i )
+    {
+        if ( ( functions[i].unwindData & 0x3 ) == 0 )
+            functions[i].end = functions[i + 1].begin;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // end nameless namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+UnwindFunctionTable::UnwindFunctionTable( MEMOFFSET_64 imageBase, boost::uint32_t imageSize, std::vector<UnwindFunction> &functions ) :
+    m_imageBase( imageBase ),
+    m_imageSize( imageSize )
+{
+    m_functions.swap( functions );
+
+    // the linker sorts the table, but nothing checks it
+    if ( !std::is_sorted( m_functions.begin(), m_functions.end(), functionLess ) )
+        std::sort( m_functions.begin(), m_functions.end(), functionLess );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const UnwindFunction* UnwindFunctionTable::find( boost::uint32_t rva ) const
+{
+    std::vector<UnwindFunction>::const_iterator  it =
+        std::upper_bound( m_functions.begin(), m_functions.end(), rva, functionBeginLess );
+
+    if ( it == m_functions.begin() )
+        return 0;
+
+    --it;
+
+    return rva < it->end ? &*it : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+UnwindFunctionTablePtr getFunctionTable( MEMOFFSET_64 imageBase, const PeExceptionDirectory &exceptionDir )
+{
+    std::vector<UnwindFunction>  functions;
+
+    if ( exceptionDir.machine == MachineAmd64 )
+    {
+        size_t  count = exceptionDir.data.size() / RuntimeFunctionAmd64Size;
+
+        functions.reserve( count );
+
+        for ( size_t i = 0; i < count; ++i )
+        {
+            UnwindFunction  function;
+            memcpy( &function, &exceptionDir.data[i * RuntimeFunctionAmd64Size], RuntimeFunctionAmd64Size );
+
+            // a zero entry pads the end of some tables
+            if ( function.begin < function.end )
+                functions.push_back( function );
+        }
+    }
+    else if ( exceptionDir.machine == MachineArm64 )
+    {
+        readFunctionsArm64( exceptionDir, functions );
+    }
+
+    return UnwindFunctionTablePtr( new UnwindFunctionTable( imageBase, exceptionDir.imageSize, functions ) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool DbgUnwindTarget::readMemory( MEMOFFSET_64 offset, void* buffer, size_t length )
+{
+    return readMemoryUnsafe( offset, buffer, length );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+UnwindFunctionTablePtr DbgUnwindTarget::getFunctionTable( MEMOFFSET_64 offset )
+{
+    // a stack walks through a few modules many times
+    for ( std::vector<UnwindFunctionTablePtr>::const_iterator it = m_tables.begin(); it != m_tables.end(); ++it )
+    {
+        if ( (*it)->inRange( offset ) )
+            return *it;
+    }
+
+    MEMOFFSET_64  imageBase = 0;
+
+    try
+    {
+        imageBase = findModuleBase( offset );
+    }
+    catch( const DbgException& )
+    {
+        return UnwindFunctionTablePtr();
+    }
+
+    UnwindFunctionTablePtr  table = ProcessMonitor::getFunctionTable( imageBase );
+
+    if ( !table )
+    {
+        PeExceptionDirectory  exceptionDir = {};
+
+        try
+        {
+            readPeExceptionDirectory( *getPeMemoryReader( imageBase ), exceptionDir );
+        }
+        catch( const DbgException& )
+        {
+            // the headers are paged out: the module functions are unwound as leaf ones
+            exceptionDir.data.clear();
+        }
+
+        table = kdlib::getFunctionTable( imageBase, exceptionDir );
+
+        ProcessMonitor::insertFunctionTable( table );
+    }
+
+    m_tables.push_back( table );
+
+    return table;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "kdlib/dbgtypedef.h"
+
+#include "peimage.h"
+
+namespace kdlib {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// An entry of the module exception directory
+
+struct UnwindFunction
+{
+    boost::uint32_t  begin;         // RVA of the function
+    boost::uint32_t  end;
+    boost::uint32_t  unwindData;    // RVA of the unwind info, ARM64: or the packed unwind data
+};
+
+// The function table of a module sorted by the function RVA
+
+class UnwindFunctionTable
+{
+public:
+
+    UnwindFunctionTable( MEMOFFSET_64 imageBase, boost::uint32_t imageSize, std::vector<UnwindFunction> &functions );
+
+    MEMOFFSET_64 getImageBase() const {
+        return m_imageBase;
+    }
+
+    boost::uint32_t getImageSize() const {
+        return m_imageSize;
+    }
+
+    bool inRange( MEMOFFSET_64 offset ) const {
+        return offset >= m_imageBase && offset - m_imageBase < m_imageSize;
+    }
+
+    size_t getCount() const {
+        return m_functions.size();
+    }
+
+    const std::vector<UnwindFunction>& getFunctions() const {
+        return m_functions;
+    }
+
+    // null if no function contains the RVA
+    const UnwindFunction* find( boost::uint32_t rva ) const;
+
+private:
+
+    MEMOFFSET_64  m_imageBase;
+    boost::uint32_t  m_imageSize;
+    std::vector<UnwindFunction>  m_functions;
+};
+
+typedef boost::shared_ptr<const UnwindFunctionTable>  UnwindFunctionTablePtr;
+
+// Parses the exception directory of the image. An image without the
+// directory or of an unsupported machine gets an empty table.
+UnwindFunctionTablePtr getFunctionTable( MEMOFFSET_64 imageBase, const PeExceptionDirectory &exceptionDir );
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The memory and the modules an unwinder works over: the debug target or
+// any other memory source
+
+class UnwindTarget
+{
+public:
+
+    virtual ~UnwindTarget() {}
+
+    virtual bool readMemory( MEMOFFSET_64 offset, void* buffer, size_t length ) = 0;
+
+    // the function table of the module containing the address, null if the
+    // address is out of the modules
+    virtual UnwindFunctionTablePtr getFunctionTable( MEMOFFSET_64 offset ) = 0;
+};
+
+// Reads the memory of the current target. The function tables are read from
+// the loaded images and cached per process until the module is unloaded.
+class DbgUnwindTarget : public UnwindTarget
+{
+public:
+
+    bool readMemory( MEMOFFSET_64 offset, void* buffer, size_t length ) override;
+
+    UnwindFunctionTablePtr getFunctionTable( MEMOFFSET_64 offset ) override;
+
+private:
+
+    std::vector<UnwindFunctionTablePtr>  m_tables;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
@@ -0,0 +1,635 @@
+#include "stdafx.h"
+
+#include <cstring>
+
+#include "unwindamd64.h"
+
+namespace kdlib {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+
+enum UnwindOpAmd64
+{
+    UnwindOpPushNonvol = 0,         // push reg
+    UnwindOpAllocLarge = 1,         // sub rsp, nnnn
+    UnwindOpAllocSmall = 2,         // sub rsp, n
+    UnwindOpSetFpreg = 3,           // lea reg, [rsp + n]
+    UnwindOpSaveNonvol = 4,         // mov [rsp + n], reg
+    UnwindOpSaveNonvolFar = 5,
+    UnwindOpEpilog = 6,             // version 2: the epilog location
+    UnwindOpSpare = 7,
+    UnwindOpSaveXmm128 = 8,         // movaps [rsp + n], xmm
+    UnwindOpSaveXmm128Far = 9,
+    UnwindOpPushMachframe = 10      // an interrupt or an exception frame
+};
+
+const unsigned char  UnwindFlagChainInfo = 4;
+
+const size_t  UnwindInfoHeaderSize = 4;
+const size_t  RuntimeFunctionSize = 12;
+const size_t  MaxUnwindCodes = 0x100;
+const size_t  MaxChainDepth = 32;
+const size_t  MaxEpilogInstructions = 32;
+const MEMOFFSET_64  PageSize = 0x1000;
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct UnwindInfoAmd64
+{
+    unsigned char  version;
+    unsigned char  flags;
+    unsigned char  prologSize;
+    unsigned char  codeCount;
+    unsigned char  frameRegister;
+    unsigned char  frameOffset;
+    boost::uint16_t  codes[MaxUnwindCodes];
+    UnwindFunction  chained;
+};
+
+inline unsigned char getCodeOffset( boost::uint16_t code )
+{
+    return static_cast<unsigned char>( code & 0xFF );
+}
+
+inline unsigned char getCodeOp( boost::uint16_t code )
+{
+    return static_cast<unsigned char>( ( code >> 8 ) & 0x0F );
+}
+
+inline unsigned char getCodeInfo( boost::uint16_t code )
+{
+    return static_cast<unsigned char>( code >> 12 );
+}
+
+size_t getCodeSize( boost::uint16_t code )
+{
+    switch ( getCodeOp( code ) )
+    {
+    case UnwindOpAllocLarge:
+        return getCodeInfo( code ) != 0 ? 3 : 2;
+
+    case UnwindOpSaveNonvol:
+    case UnwindOpSaveXmm128:
+    case UnwindOpEpilog:
+        return 2;
+
+    case UnwindOpSaveNonvolFar:
+    case UnwindOpSaveXmm128Far:
+    case UnwindOpSpare:
+        return 3;
+    }
+
+    return 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool readUnwindInfo( UnwindTarget &target, MEMOFFSET_64 imageBase, const UnwindFunction &function, UnwindInfoAmd64 &info )
+{
+    unsigned char  header[UnwindInfoHeaderSize];
+
+    if ( !target.readMemory( imageBase + function.unwindData, header, sizeof(header) ) )
+        return false;
+
+    info.version = header[0] & 0x07;
+    info.flags = header[0] >> 3;
+    info.prologSize = header[1];
+    info.codeCount = header[2];
+    info.frameRegister = header[3] & 0x0F;
+    info.frameOffset = header[3] >> 4;
+
+    if ( info.version != 1 && info.version != 2 )
+        return false;
+
+    // the chained function follows the codes aligned to a DWORD
+    size_t  alignedCount = ( info.codeCount + 1 ) & ~1;
+
+    if ( alignedCount > 0 &&
+        !target.readMemory( imageBase + function.unwindData + UnwindInfoHeaderSize, info.codes, alignedCount * sizeof(boost::uint16_t) ) )
+    {
+        return false;
+    }
+
+    if ( ( info.flags & UnwindFlagChainInfo ) != 0 &&
+        !target.readMemory( imageBase + function.unwindData + UnwindInfoHeaderSize + alignedCount * sizeof(boost::uint16_t), &info.chained, RuntimeFunctionSize ) )
+    {
+        return false;
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool readStack( UnwindTarget &target, MEMOFFSET_64 offset, boost::uint64_t &value )
+{
+    return target.readMemory( offset, &value, sizeof(value) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The code bytes at the IP, read by small blocks
+
+class CodeReader
+{
+public:
+
+    explicit CodeReader( UnwindTarget &target ) :
+        m_target( target ),
+        m_begin( 0 ),
+        m_size( 0 )
+        {}
+
+    template<typename T>
+    bool get( MEMOFFSET_64 offset, T &value )
+    {
+        if ( offset < m_begin || offset - m_begin + sizeof(T) > m_size )
+        {
+            if ( !load( offset ) || sizeof(T) > m_size )
+                return false;
+        }
+
+        memcpy( &value, m_bytes + ( offset - m_begin ), sizeof(T) );
+        return true;
+    }
+
+private:
+
+    bool load( MEMOFFSET_64 offset )
+    {
+        m_size = 0;
+
+        size_t  size = sizeof(m_bytes);
+
+        if ( !m_target.readMemory( offset, m_bytes, size ) )
+        {
+            // the code can end just before an unreadable page
+            size = static_cast<size_t>( PageSize - ( offset & ( PageSize - 1 ) ) );
+
+            if ( size >= sizeof(m_bytes) || !m_target.readMemory( offset, m_bytes, size ) )
+                return false;
+        }
+
+        m_begin = offset;
+        m_size = size;
+        return true;
+    }
+
+    UnwindTarget  &m_target;
+
+    MEMOFFSET_64  m_begin;
+    size_t  m_size;
+    unsigned char  m_bytes[0x40];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+inline bool inFunction( MEMOFFSET_64 offset, MEMOFFSET_64 imageBase, const UnwindFunction &function )
+{
+    return offset >= imageBase + function.begin && offset < imageBase + function.end;
+}
+
+// An epilog is an optional add or lea to rsp, a sequence of pops and a ret
+// or a jmp inside the function
+
+bool isInsideEpilog( CodeReader &code, MEMOFFSET_64 pc, MEMOFFSET_64 imageBase, const UnwindFunction &function )
+{
+    unsigned char  op[3];
+
+    if ( !code.get( pc, op[0] ) )
+        return false;
+
+    // add or lea must be the first instruction, with the REX.W prefix
+    if ( ( op[0] & 0xF8 ) == 0x48 )
+    {
+        if ( !code.get( pc + 1, op[1] ) || !code.get( pc + 2, op[2] ) )
+            return false;
+
+        switch ( op[1] )
+        {
+        case 0x81:  // add rsp, nnnn
+            if ( op[0] != 0x48 || op[2] != 0xC4 )
+                return false;
+            pc += 7;
+            break;
+
+        case 0x83:  // add rsp, n
+            if ( op[0] != 0x48 || op[2] != 0xC4 )
+                return false;
+            pc += 4;
+            break;
+
+        case 0x8D:  // lea rsp, [reg + n]
+            if ( ( op[0] & 0x06 ) != 0 || ( ( op[2] >> 3 ) & 7 ) != 4 || ( op[2] & 7 ) == 4 )
+                return false;
+            if ( ( op[2] >> 6 ) == 1 )
+                pc += 4;
+            else if ( ( op[2] >> 6 ) == 2 )
+                pc += 7;
+            else
+                return false;
+            break;
+        }
+    }
+
+    for ( size_t i = 0; i < MaxEpilogInstructions; ++i )
+    {
+        if ( !code.get( pc, op[0] ) )
+            return false;
+
+        if ( ( op[0] & 0xF0 ) == 0x40 )
+        {
+            ++pc;
+            if ( !code.get( pc, op[0] ) )
+                return false;
+        }
+
+        if ( op[0] >= 0x58 && op[0] <= 0x5F )    // pop reg
+        {
+            ++pc;
+            continue;
+        }
+
+        switch ( op[0] )
+        {
+        case 0xC2:  // ret n
+        case 0xC3:  // ret
+            return true;
+
+        case 0xE9:  // jmp nnnn
+            {
+                boost::int32_t  disp;
+                if ( !code.get( pc + 1, disp ) )
+                    return false;
+                pc += 5 + disp;
+            }
+            if ( inFunction( pc, imageBase, function ) )
+                continue;
+            return false;
+
+        case 0xEB:  // jmp n
+            {
+                boost::int8_t  disp;
+                if ( !code.get( pc + 1, disp ) )
+                    return false;
+                pc += 2 + disp;
+            }
+            if ( inFunction( pc, imageBase, function ) )
+                continue;
+            return false;
+
+        case 0xF3:  // rep ret
+            return code.get( pc + 1, op[1] ) && op[1] == 0xC3;
+        }
+
+        return false;
+    }
+
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Executes the rest of the epilog: the context gets the caller registers
+
+bool interpretEpilog( CodeReader &code, UnwindTarget &target, MEMOFFSET_64 pc, UnwindContextAmd64 &context )
+{
+    boost::uint64_t  &rsp = context.gpr[UnwindRegRspAmd64];
+
+    for ( size_t i = 0; i < MaxEpilogInstructions; ++i )
+    {
+        unsigned char  rex = 0;
+        unsigned char  op;
+
+        if ( !code.get( pc, op ) )
+            return false;
+
+        if ( ( op & 0xF0 ) == 0x40 )
+        {
+            rex = op & 0x0F;
+            ++pc;
+            if ( !code.get( pc, op ) )
+                return false;
+        }
+
+        if ( op >= 0x58 && op <= 0x5F )    // pop reg
+        {
+            if ( !readStack( target, rsp, context.gpr[ ( op - 0x58 ) + ( rex & 1 ) * 8 ] ) )
+                return false;
+            rsp += 8;
+            ++pc;
+            continue;
+        }
+
+        switch ( op )
+        {
+        case 0x81:  // add rsp, nnnn
+            {
+                boost::int32_t  imm;
+                if ( !code.get( pc + 2, imm ) )
+                    return false;
+                rsp += imm;
+                pc += 6;
+            }
+            continue;
+
+        case 0x83:  // add rsp, n
+            {
+                boost::int8_t  imm;
+                if ( !code.get( pc + 2, imm ) )
+                    return false;
+                rsp += imm;
+                pc += 3;
+            }
+            continue;
+
+        case 0x8D:  // lea rsp, [reg + n]
+            {
+                unsigned char  modrm;
+                if ( !code.get( pc + 1, modrm ) )
+                    return false;
+
+                boost::uint64_t  base = context.gpr[ ( modrm & 7 ) + ( rex & 1 ) * 8 ];
+
+                if ( ( modrm >> 6 ) == 1 )
+                {
+                    boost::int8_t  disp;
+                    if ( !code.get( pc + 2, disp ) )
+                        return false;
+                    rsp = base + disp;
+                    pc += 3;
+                }
+                else
+                {
+                    boost::int32_t  disp;
+                    if ( !code.get( pc + 2, disp ) )
+                        return false;
+                    rsp = base + disp;
+                    pc += 6;
+                }
+            }
+            continue;
+
+        case 0xC2:  // ret n
+            {
+                boost::uint16_t  size;
+                if ( !code.get( pc + 1, size ) || !readStack( target, rsp, context.rip ) )
+                    return false;
+                rsp += 8 + size;
+            }
+            return true;
+
+        case 0xC3:  // ret
+        case 0xF3:  // rep ret
+            if ( !readStack( target, rsp, context.rip ) )
+                return false;
+            rsp += 8;
+            return true;
+
+        case 0xE9:  // jmp nnnn
+            {
+                boost::int32_t  disp;
+                if ( !code.get( pc + 1, disp ) )
+                    return false;
+                pc += 5 + disp;
+            }
+            continue;
+
+        case 0xEB:  // jmp n
+            {
+                boost::int8_t  disp;
+                if ( !code.get( pc + 1, disp ) )
+                    return false;
+                pc += 2 + disp;
+            }
+            continue;
+        }
+
+        return false;
+    }
+
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the frame register is set if the IP is out of the prolog or after the lea
+bool isFrameRegisterSet( const UnwindInfoAmd64 &info, size_t prologOffset )
+{
+    for ( size_t i = 0; i < info.codeCount; i += getCodeSize( info.codes[i] ) )
+    {
+        if ( getCodeOp( info.codes[i] ) == UnwindOpSetFpreg )
+            return getCodeOffset( info.codes[i] ) <= prologOffset;
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // end nameless namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool unwindFrameAmd64( UnwindTarget &target, UnwindContextAmd64 &context, bool &machineFrame, MEMOFFSET_64 &establisherFrame )
+{
+    boost::uint64_t  &rsp = context.gpr[UnwindRegRspAmd64];
+
+    MEMOFFSET_64  ip = context.rip;
+
+    // the call can be the last instruction of a function
+    MEMOFFSET_64  lookupIp = machineFrame ? ip : ip - 1;
+
+    bool  checkEpilog = machineFrame;
+
+    establisherFrame = rsp;
+
+    machineFrame = false;
+
+    UnwindFunctionTablePtr  table = target.getFunctionTable( lookupIp );
+
+    const UnwindFunction  *entry = 0;
+
+    if ( table && lookupIp - table->getImageBase() <= 0xFFFFFFFF )
+        entry = table->find( static_cast<boost::uint32_t>( lookupIp - table->getImageBase() ) );
+
+    if ( !entry )
+    {
+        // a leaf function does not touch the stack
+        if ( !readStack( target, rsp, context.rip ) )
+            return false;
+        rsp += 8;
+        return true;
+    }
+
+    MEMOFFSET_64  imageBase = table->getImageBase();
+
+    UnwindFunction  function = *entry;
+
+    // the entry can refer to the entry sharing the unwind info
+    if ( ( function.unwindData & 1 ) != 0 &&
+        !target.readMemory( imageBase + function.unwindData - 1, &function, RuntimeFunctionSize ) )
+    {
+        return false;
+    }
+
+    UnwindInfoAmd64  info;
+
+    for ( size_t depth = 0; depth < MaxChainDepth; ++depth )
+    {
+        if ( !readUnwindInfo( target, imageBase, function, info ) )
+            return false;
+
+        // the prolog of a chained function is complete
+        size_t  prologOffset = ~size_t(0);
+
+        if ( depth == 0 )
+        {
+            MEMOFFSET_64  functionBegin = imageBase + function.begin;
+
+            if ( ip >= functionBegin && ip < functionBegin + info.prologSize )
+            {
+                prologOffset = static_cast<size_t>( ip - functionBegin );
+            }
+            else if ( checkEpilog && ( info.flags & UnwindFlagChainInfo ) == 0 )
+            {
+                CodeReader  code( target );
+
+                if ( isInsideEpilog( code, ip, imageBase, function ) )
+                    return interpretEpilog( code, target, ip, context );
+            }
+        }
+
+        MEMOFFSET_64  frame = rsp;
+
+        if ( info.frameRegister != 0 && isFrameRegisterSet( info, prologOffset ) )
+            frame = context.gpr[info.frameRegister] - info.frameOffset * 16;
+
+        if ( depth == 0 )
+            establisherFrame = frame;
+
+        for ( size_t i = 0; i < info.codeCount; i += getCodeSize( info.codes[i] ) )
+        {
+            boost::uint16_t  code = info.codes[i];
+
+            if ( i + getCodeSize( code ) > info.codeCount )
+                return false;
+
+            // not executed yet
+            if ( prologOffset < getCodeOffset( code ) )
+                continue;
+
+            unsigned char  codeInfo = getCodeInfo( code );
+
+            switch ( getCodeOp( code ) )
+            {
+            case UnwindOpPushNonvol:
+                if ( !readStack( target, rsp, context.gpr[codeInfo] ) )
+                    return false;
+                rsp += 8;
+                break;
+
+            case UnwindOpAllocLarge:
+                if ( codeInfo == 0 )
+                    rsp += info.codes[i + 1] * 8;
+                else
+                    rsp += info.codes[i + 1] + ( static_cast<boost::uint32_t>( info.codes[i + 2] ) << 16 );
+                break;
+
+            case UnwindOpAllocSmall:
+                rsp += ( codeInfo + 1 ) * 8;
+                break;
+
+            case UnwindOpSetFpreg:
+                rsp = frame;
+                break;
+
+            case UnwindOpSaveNonvol:
+                if ( !readStack( target, frame + info.codes[i + 1] * 8, context.gpr[codeInfo] ) )
+                    return false;
+                break;
+
+            case UnwindOpSaveNonvolFar:
+                if ( !readStack( target, frame + info.codes[i + 1] + ( static_cast<boost::uint32_t>( info.codes[i + 2] ) << 16 ), context.gpr[codeInfo] ) )
+                    return false;
+                break;
+
+            case UnwindOpSaveXmm128:
+                if ( !target.readMemory( frame + info.codes[i + 1] * 16, &context.xmm[codeInfo], sizeof(UnwindXmmAmd64) ) )
+                    return false;
+                break;
+
+            case UnwindOpSaveXmm128Far:
+                if ( !target.readMemory( frame + info.codes[i + 1] + ( static_cast<boost::uint32_t>( info.codes[i + 2] ) << 16 ), &context.xmm[codeInfo], sizeof(UnwindXmmAmd64) ) )
+                    return false;
+                break;
+
+            case UnwindOpPushMachframe:
+                // the error code is pushed over the machine frame
+                if ( codeInfo != 0 )
+                    rsp += 8;
+                if ( !readStack( target, rsp, context.rip ) || !readStack( target, rsp + 24, rsp ) )
+                    return false;
+                machineFrame = true;
+                break;
+
+            case UnwindOpEpilog:
+            case UnwindOpSpare:
+                break;
+
+            default:
+                return false;
+            }
+        }
+
+        if ( ( info.flags & UnwindFlagChainInfo ) == 0 )
+        {
+            if ( !machineFrame )
+            {
+                if ( !readStack( target, rsp, context.rip ) )
+                    return false;
+                rsp += 8;
+            }
+
+            return true;
+        }
+
+        function = info.chained;
+    }
+
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void unwindStackAmd64( UnwindTarget &target, const UnwindContextAmd64 &context, std::vector<UnwindFrameAmd64> &frames, size_t maxFrames )
+{
+    frames.clear();
+
+    UnwindContextAmd64  current = context;
+
+    bool  machineFrame = true;
+
+    while ( frames.size() < maxFrames && current.rip != 0 )
+    {
+        frames.push_back( UnwindFrameAmd64() );
+
+        UnwindFrameAmd64  &frame = frames.back();
+
+        frame.context = current;
+        frame.frame = current.gpr[UnwindRegRspAmd64];
+
+        if ( !unwindFrameAmd64( target, current, machineFrame, frame.frame ) )
+            break;
+
+        // the caller frame is above, unless the interrupt switched the stack
+        if ( !machineFrame && current.gpr[UnwindRegRspAmd64] <= frame.context.gpr[UnwindRegRspAmd64] )
+            break;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
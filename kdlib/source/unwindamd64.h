@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include "unwind.h"
+
+namespace kdlib {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The registers the AMD64 unwind info can restore. The integer registers
+// go in the UNWIND_CODE order: rax, rcx, rdx, rbx, rsp, rbp, rsi, rdi, r8 - r15
+
+struct UnwindXmmAmd64
+{
+    boost::uint64_t  low;
+    boost::uint64_t  high;
+};
+
+struct UnwindContextAmd64
+{
+    boost::uint64_t  rip;
+    boost::uint64_t  gpr[16];
+    UnwindXmmAmd64  xmm[16];
+};
+
+const unsigned long  UnwindRegRspAmd64 = 4;
+const unsigned long  UnwindRegRbpAmd64 = 5;
+
+struct UnwindFrameAmd64
+{
+    UnwindContextAmd64  context;    // the registers at the frame
+    MEMOFFSET_64  frame;            // the establisher frame
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Replaces the context with the context of the caller by the unwind info of
+// the function or as a leaf function if there is no info. On input
+// machineFrame tells the IP is not a return address: it is the first frame
+// or the frame is interrupted. On output it tells the caller context is
+// restored from a machine frame. Returns false if the unwind info or the
+// stack can not be read.
+
+bool unwindFrameAmd64( UnwindTarget &target, UnwindContextAmd64 &context, bool &machineFrame, MEMOFFSET_64 &establisherFrame );
+
+// Unwinds from the context until the return address is zero, the stack stops
+// growing up or it is not readable
+void unwindStackAmd64( UnwindTarget &target, const UnwindContextAmd64 &context, std::vector<UnwindFrameAmd64> &frames, size_t maxFrames = 1024 );
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
@@ -0,0 +1,741 @@
+#include "stdafx.h"
+
+#include <cstring>
+#include <vector>
+
+#include "unwindarm64.h"
+
+namespace kdlib {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The kind of the unwind data in the low bits of a .pdata entry
+
+enum PdataFlagArm64
+{
+    PdataFlagXdata = 0,             // RVA of the .xdata record
+    PdataFlagPacked = 1,            // one canonical prolog and epilog
+    PdataFlagPackedFragment = 2     // the same without the prolog and the epilog
+};
+
+// The unwind codes with a fixed first byte
+
+enum UnwindOpArm64
+{
+    UnwindOpAllocLarge = 0xE0,      // sub sp, sp, #n (24 bits)
+    UnwindOpSetFp = 0xE1,           // mov x29, sp
+    UnwindOpAddFp = 0xE2,           // add x29, sp, #n
+    UnwindOpNop = 0xE3,
+    UnwindOpEnd = 0xE4,
+    UnwindOpEndChained = 0xE5,
+    UnwindOpSaveNext = 0xE6,        // the next pair is saved by the following code
+    UnwindOpSaveAnyReg = 0xE7,
+    UnwindOpTrapFrame = 0xE8,
+    UnwindOpMachineFrame = 0xE9,    // sp points to the interrupted sp and pc
+    UnwindOpContext = 0xEA,         // sp points to a CONTEXT record
+    UnwindOpClearUnwoundToCall = 0xEC,
+    UnwindOpPacSignLr = 0xFC        // pacibsp
+};
+
+const size_t  FpRegisterBase = 32;  // a step register number of d0
+const size_t  NoRegister = ~size_t(0);
+const size_t  MaxSavedPair = 16;
+
+// CONTEXT_ARM64 offsets
+const size_t  ContextRecordXOffset = 0x008;
+const size_t  ContextRecordVOffset = 0x110;
+const size_t  ContextRecordVSize = 0x200;
+
+const MEMOFFSET_64  FrameChainAlign = 8;
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t getCodeSize( unsigned char op )
+{
+    if ( op < 0xC0 )
+        return 1;
+
+    if ( op < 0xE0 )
+        return 2;
+
+    switch ( op )
+    {
+    case UnwindOpAllocLarge:
+        return 4;
+
+    case UnwindOpAddFp:
+    case 0xF8:
+        return 2;
+
+    case UnwindOpSaveAnyReg:
+    case 0xF9:
+        return 3;
+
+    case 0xFA:
+        return 4;
+
+    case 0xFB:
+        return 5;
+    }
+
+    return 1;
+}
+
+// The number of the instructions the codes describe up to the end code
+
+size_t getSequenceLength( const unsigned char *code, const unsigned char *end )
+{
+    size_t  length = 0;
+
+    while ( code < end && *code != UnwindOpEnd && *code != UnwindOpEndChained )
+    {
+        // the custom stack codes are not instructions
+        if ( ( *code & 0xF8 ) != UnwindOpTrapFrame )
+            ++length;
+
+        code += getCodeSize( *code );
+    }
+
+    return length;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Restores count registers saved from the slot pos of the stack, pos is in
+// 8-byte units and it is negative for a pre-indexed store: sp is restored too
+
+bool restoreRegisters( UnwindTarget &target, UnwindContextArm64 &context, boost::uint64_t *registers, size_t registerCount, size_t first, size_t count, int pos )
+{
+    if ( count > MaxSavedPair || first + count > registerCount )
+        return false;
+
+    MEMOFFSET_64  offset = context.sp + ( pos > 0 ? pos * 8 : 0 );
+
+    if ( !target.readMemory( offset, registers + first, count * sizeof(boost::uint64_t) ) )
+        return false;
+
+    if ( pos < 0 )
+        context.sp += -pos * 8;
+
+    return true;
+}
+
+bool restoreX( UnwindTarget &target, UnwindContextArm64 &context, size_t first, size_t count, int pos )
+{
+    return restoreRegisters( target, context, context.x, 31, first, count, pos );
+}
+
+bool restoreD( UnwindTarget &target, UnwindContextArm64 &context, size_t first, size_t count, int pos )
+{
+    return restoreRegisters( target, context, context.d, 32, first, count, pos );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool restoreAnyReg( UnwindTarget &target, UnwindContextArm64 &context, unsigned char info, unsigned char location )
+{
+    bool  pair = ( info & 0x40 ) != 0;
+    bool  writeback = ( info & 0x20 ) != 0;
+    size_t  reg = info & 0x1F;
+    unsigned char  kind = location >> 6;       // x, d or q
+    int  scale = pair || kind == 2 ? 16 : 8;
+
+    if ( kind == 3 )
+        return false;
+
+    int  pos = writeback ? -( ( location & 0x3F ) + 1 ) * scale / 8 : ( location & 0x3F ) * scale / 8;
+
+    if ( kind != 2 )
+    {
+        return kind == 0 ?
+            restoreX( target, context, reg, pair ? 2 : 1, pos ) :
+            restoreD( target, context, reg, pair ? 2 : 1, pos );
+    }
+
+    // the low halves of the q registers
+    MEMOFFSET_64  offset = context.sp + ( pos > 0 ? pos * 8 : 0 );
+
+    for ( size_t i = 0; i < ( pair ? 2U : 1U ); ++i )
+    {
+        if ( reg + i >= 32 || !target.readMemory( offset + i * 16, &context.d[reg + i], sizeof(boost::uint64_t) ) )
+            return false;
+    }
+
+    if ( pos < 0 )
+        context.sp += -pos * 8;
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool restoreContextRecord( UnwindTarget &target, UnwindContextArm64 &context )
+{
+    MEMOFFSET_64  record = context.sp;
+
+    // x0 - x28, fp, lr, sp, pc go one by one
+    boost::uint64_t  registers[33];
+
+    if ( !target.readMemory( record + ContextRecordXOffset, registers, sizeof(registers) ) )
+        return false;
+
+    boost::uint64_t  vectors[ContextRecordVSize / sizeof(boost::uint64_t)];
+
+    if ( !target.readMemory( record + ContextRecordVOffset, vectors, sizeof(vectors) ) )
+        return false;
+
+    memcpy( context.x, registers, sizeof(context.x) );
+    context.sp = registers[31];
+    context.pc = registers[32];
+
+    for ( size_t i = 0; i < 32; ++i )
+        context.d[i] = vectors[i * 2];
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Undoes the instructions the codes describe. The first skip codes are of
+// the instructions not executed yet: the ones of the prolog after the PC or
+// the ones of the epilog before it.
+
+bool processCodes( UnwindTarget &target, UnwindContextArm64 &context, const unsigned char *code, const unsigned char *end, size_t skip, bool &machineFrame )
+{
+    for ( ; code < end && skip > 0; --skip )
+    {
+        if ( *code == UnwindOpEnd )
+            break;
+
+        code += getCodeSize( *code );
+    }
+
+    size_t  pairCount = 2;
+
+    while ( code < end )
+    {
+        unsigned char  op = code[0];
+        size_t  size = getCodeSize( op );
+
+        if ( code + size > end )
+            return false;
+
+        unsigned long  value = size >= 2 ? ( op << 8 ) | code[1] : op;
+        bool  restored = true;
+
+        if ( op < 0x20 )                // alloc_s
+            context.sp += 16 * ( op & 0x1F );
+        else if ( op < 0x40 )           // save_r19r20_x
+            restored = restoreX( target, context, 19, pairCount, -( op & 0x1F ) );
+        else if ( op < 0x80 )           // save_fplr
+            restored = restoreX( target, context, 29, 2, op & 0x3F );
+        else if ( op < 0xC0 )           // save_fplr_x
+            restored = restoreX( target, context, 29, 2, -( ( op & 0x3F ) + 1 ) );
+        else if ( op < 0xC8 )           // alloc_m
+            context.sp += 16 * ( value & 0x7FF );
+        else if ( op < 0xCC )           // save_regp
+            restored = restoreX( target, context, 19 + ( ( value >> 6 ) & 0xF ), pairCount, value & 0x3F );
+        else if ( op < 0xD0 )           // save_regp_x
+            restored = restoreX( target, context, 19 + ( ( value >> 6 ) & 0xF ), pairCount, -static_cast<int>( ( value & 0x3F ) + 1 ) );
+        else if ( op < 0xD4 )           // save_reg
+            restored = restoreX( target, context, 19 + ( ( value >> 6 ) & 0xF ), 1, value & 0x3F );
+        else if ( op < 0xD6 )           // save_reg_x
+            restored = restoreX( target, context, 19 + ( ( value >> 5 ) & 0xF ), 1, -static_cast<int>( ( value & 0x1F ) + 1 ) );
+        else if ( op < 0xD8 )           // save_lrpair
+        {
+            restored = restoreX( target, context, 19 + 2 * ( ( value >> 6 ) & 0x7 ), 1, value & 0x3F ) &&
+                restoreX( target, context, UnwindRegLrArm64, 1, ( value & 0x3F ) + 1 );
+        }
+        else if ( op < 0xDA )           // save_fregp
+            restored = restoreD( target, context, 8 + ( ( value >> 6 ) & 0x7 ), pairCount, value & 0x3F );
+        else if ( op < 0xDC )           // save_fregp_x
+            restored = restoreD( target, context, 8 + ( ( value >> 6 ) & 0x7 ), pairCount, -static_cast<int>( ( value & 0x3F ) + 1 ) );
+        else if ( op < 0xDE )           // save_freg
+            restored = restoreD( target, context, 8 + ( ( value >> 6 ) & 0x7 ), 1, value & 0x3F );
+        else if ( op == 0xDE )          // save_freg_x
+            restored = restoreD( target, context, 8 + ( ( value >> 5 ) & 0x7 ), 1, -static_cast<int>( ( value & 0x1F ) + 1 ) );
+        else
+        {
+            switch ( op )
+            {
+            case UnwindOpAllocLarge:
+                context.sp += 16 * ( ( code[1] << 16 ) | ( code[2] << 8 ) | code[3] );
+                break;
+
+            case UnwindOpSetFp:
+                context.sp = context.x[UnwindRegFpArm64];
+                break;
+
+            case UnwindOpAddFp:
+                context.sp = context.x[UnwindRegFpArm64] - 8 * code[1];
+                break;
+
+            case UnwindOpNop:
+            case UnwindOpEndChained:
+            case UnwindOpPacSignLr:
+                break;
+
+            case UnwindOpEnd:
+                return true;
+
+            case UnwindOpSaveNext:
+                pairCount += 2;
+                code += size;
+                continue;
+
+            case UnwindOpSaveAnyReg:
+                restored = restoreAnyReg( target, context, code[1], code[2] );
+                break;
+
+            case UnwindOpMachineFrame:
+                {
+                    boost::uint64_t  frame[2];
+                    restored = target.readMemory( context.sp, frame, sizeof(frame) );
+                    context.sp = frame[0];
+                    context.pc = frame[1];
+                    machineFrame = true;
+                }
+                break;
+
+            case UnwindOpContext:
+                restored = restoreContextRecord( target, context );
+                machineFrame = true;
+                break;
+
+            case UnwindOpClearUnwoundToCall:
+                context.pc = context.x[UnwindRegLrArm64];
+                machineFrame = true;
+                break;
+
+            default:
+                // a trap frame, SVE registers, a custom or a reserved code
+                return false;
+            }
+        }
+
+        if ( !restored )
+            return false;
+
+        pairCount = 2;
+        code += size;
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool unwindFullData( UnwindTarget &target, MEMOFFSET_64 imageBase, const UnwindFunction &function, size_t offset, UnwindContextArm64 &context, bool &machineFrame )
+{
+    MEMOFFSET_64  xdata = imageBase + function.unwindData;
+
+    boost::uint32_t  header;
+    if ( !target.readMemory( xdata, &header, sizeof(header) ) )
+        return false;
+
+    xdata += sizeof(header);
+
+    size_t  functionLength = header & 0x3FFFF;
+    bool  singleEpilog = ( header & 0x200000 ) != 0;
+    size_t  epilogCount = ( header >> 22 ) & 0x1F;
+    size_t  codeWords = header >> 27;
+
+    if ( ( header >> 18 ) & 0x3 )
+        return false;
+
+    if ( epilogCount == 0 && codeWords == 0 )
+    {
+        boost::uint32_t  extension;
+        if ( !target.readMemory( xdata, &extension, sizeof(extension) ) )
+            return false;
+
+        xdata += sizeof(extension);
+
+        epilogCount = extension & 0xFFFF;
+        codeWords = ( extension >> 16 ) & 0xFF;
+    }
+
+    if ( codeWords == 0 )
+        return true;
+
+    // with the single epilog bit the count is the index of its first code
+    size_t  scopeCount = singleEpilog ? 0 : epilogCount;
+
+    std::vector<boost::uint32_t>  data( scopeCount + codeWords );
+
+    if ( !target.readMemory( xdata, &data.front(), data.size() * sizeof(boost::uint32_t) ) )
+        return false;
+
+    const unsigned char  *codes = reinterpret_cast<const unsigned char*>( &data.front() + scopeCount );
+    const unsigned char  *codesEnd = codes + codeWords * sizeof(boost::uint32_t);
+    size_t  codeBytes = codeWords * sizeof(boost::uint32_t);
+
+    size_t  prologLength = getSequenceLength( codes, codesEnd );
+
+    if ( offset < prologLength )
+        return processCodes( target, context, codes, codesEnd, prologLength - offset, machineFrame );
+
+    if ( singleEpilog )
+    {
+        // the epilog is at the end of the function, the last instruction is ret
+        if ( epilogCount < codeBytes )
+        {
+            size_t  epilogLength = getSequenceLength( codes + epilogCount, codesEnd ) + 1;
+
+            if ( offset < functionLength && offset + epilogLength >= functionLength )
+                return processCodes( target, context, codes + epilogCount, codesEnd, offset + epilogLength - functionLength, machineFrame );
+        }
+    }
+    else
+    {
+        // the scopes go by their offsets
+        for ( size_t i = 0; i < scopeCount; ++i )
+        {
+            size_t  epilogStart = data[i] & 0x3FFFF;
+            size_t  epilogIndex = data[i] >> 22;
+
+            if ( offset < epilogStart )
+                break;
+
+            if ( epilogIndex >= codeBytes )
+                return false;
+
+            if ( offset <= epilogStart + getSequenceLength( codes + epilogIndex, codesEnd ) )
+                return processCodes( target, context, codes + epilogIndex, codesEnd, offset - epilogStart, machineFrame );
+        }
+    }
+
+    return processCodes( target, context, codes, codesEnd, 0, machineFrame );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// An instruction of the canonical prolog the packed data describes
+
+struct PackedStep
+{
+    enum Kind {
+        Nop,
+        Alloc,
+        SetFp,
+        Save
+    };
+
+    PackedStep( Kind kind_, size_t reg1_ = NoRegister, size_t reg2_ = NoRegister, int pos_ = 0 ) :
+        kind( kind_ ),
+        reg1( reg1_ ),
+        reg2( reg2_ ),
+        pos( pos_ ),
+        size( 0 ),
+        home( false )
+        {}
+
+    Kind  kind;
+    size_t  reg1;                   // FpRegisterBase + n for dn
+    size_t  reg2;
+    int  pos;                       // as restoreRegisters takes it
+    unsigned long  size;            // Alloc
+    bool  home;                     // the argument registers: not in the epilog
+};
+
+void addAllocSteps( std::vector<PackedStep> &steps, unsigned long localSize )
+{
+    // sub takes 12 bits
+    if ( localSize > 4080 )
+    {
+        steps.push_back( PackedStep( PackedStep::Alloc ) );
+        steps.back().size = 4080;
+        localSize -= 4080;
+    }
+
+    steps.push_back( PackedStep( PackedStep::Alloc ) );
+    steps.back().size = localSize;
+}
+
+// The canonical prolog by the packed data in the order of the instructions
+
+bool getPackedSteps( boost::uint32_t data, std::vector<PackedStep> &steps )
+{
+    unsigned long  regF = ( data >> 13 ) & 0x7;
+    unsigned long  regI = ( data >> 16 ) & 0xF;
+    unsigned long  homing = ( data >> 20 ) & 0x1;
+    unsigned long  cr = ( data >> 21 ) & 0x3;
+    unsigned long  frameSize = ( ( data >> 23 ) & 0x1FF ) * 16;
+
+    // lr goes with the integer registers, regF + 1 FP registers are saved
+    unsigned long  intSize = regI * 8 + ( cr == 1 ? 8 : 0 );
+    unsigned long  fpSize = regF != 0 ? ( regF + 1 ) * 8 : 0;
+    unsigned long  saveSize = ( intSize + fpSize + homing * 64 + 15 ) & ~15UL;
+
+    if ( frameSize < saveSize )
+        return false;
+
+    unsigned long  localSize = frameSize - saveSize;
+
+    steps.clear();
+
+    if ( cr == 2 )
+        steps.push_back( PackedStep( PackedStep::Nop ) );
+
+    size_t  firstSave = steps.size();
+
+    for ( unsigned long i = 0; i + 1 < regI; i += 2 )
+        steps.push_back( PackedStep( PackedStep::Save, 19 + i, 20 + i, i ) );
+
+    if ( regI % 2 != 0 )
+        steps.push_back( PackedStep( PackedStep::Save, 19 + regI - 1, cr == 1 ? UnwindRegLrArm64 : NoRegister, regI - 1 ) );
+    else if ( cr == 1 )
+        steps.push_back( PackedStep( PackedStep::Save, UnwindRegLrArm64, NoRegister, regI ) );
+
+    unsigned long  fpCount = fpSize / 8;
+
+    for ( unsigned long i = 0; i + 1 < fpCount; i += 2 )
+        steps.push_back( PackedStep( PackedStep::Save, FpRegisterBase + 8 + i, FpRegisterBase + 9 + i, intSize / 8 + i ) );
+
+    if ( fpCount % 2 != 0 )
+        steps.push_back( PackedStep( PackedStep::Save, FpRegisterBase + 8 + fpCount - 1, NoRegister, intSize / 8 + fpCount - 1 ) );
+
+    for ( unsigned long i = 0; i < homing * 4; ++i )
+    {
+        steps.push_back( PackedStep( PackedStep::Save, NoRegister, NoRegister, ( intSize + fpSize ) / 8 + i * 2 ) );
+        steps.back().home = true;
+    }
+
+    // the first store allocates the save area
+    if ( steps.size() > firstSave )
+        steps[firstSave].pos = -static_cast<int>( saveSize / 8 );
+
+    if ( cr == 2 || cr == 3 )
+    {
+        if ( localSize <= 512 )
+        {
+            steps.push_back( PackedStep( PackedStep::Save, UnwindRegFpArm64, UnwindRegLrArm64, -static_cast<int>( localSize / 8 ) ) );
+        }
+        else
+        {
+            addAllocSteps( steps, localSize );
+            steps.push_back( PackedStep( PackedStep::Save, UnwindRegFpArm64, UnwindRegLrArm64, 0 ) );
+        }
+
+        steps.push_back( PackedStep( PackedStep::SetFp ) );
+    }
+    else if ( localSize > 0 )
+    {
+        addAllocSteps( steps, localSize );
+    }
+
+    return true;
+}
+
+// In the epilog the argument registers are not restored, their first store
+// is an add to sp if it allocates the save area
+
+bool isEpilogStep( const PackedStep &step )
+{
+    return !step.home || step.pos < 0;
+}
+
+bool restoreStepRegister( UnwindTarget &target, UnwindContextArm64 &context, size_t reg, int pos )
+{
+    if ( reg == NoRegister )
+        return true;
+
+    return reg >= FpRegisterBase ?
+        restoreD( target, context, reg - FpRegisterBase, 1, pos ) :
+        restoreX( target, context, reg, 1, pos );
+}
+
+// Undoes the first count steps from the last one
+
+bool undoSteps( UnwindTarget &target, UnwindContextArm64 &context, const std::vector<PackedStep> &steps, size_t count )
+{
+    for ( size_t i = count; i-- > 0; )
+    {
+        const PackedStep  &step = steps[i];
+
+        switch ( step.kind )
+        {
+        case PackedStep::Alloc:
+            context.sp += step.size;
+            break;
+
+        case PackedStep::SetFp:
+            context.sp = context.x[UnwindRegFpArm64];
+            break;
+
+        case PackedStep::Save:
+            {
+                int  slot = step.pos > 0 ? step.pos : 0;
+
+                if ( !restoreStepRegister( target, context, step.reg1, slot ) ||
+                    !restoreStepRegister( target, context, step.reg2, slot + 1 ) )
+                {
+                    return false;
+                }
+
+                if ( step.pos < 0 )
+                    context.sp += -step.pos * 8;
+            }
+            break;
+
+        case PackedStep::Nop:
+            break;
+        }
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool unwindPackedData( UnwindTarget &target, const UnwindFunction &function, size_t offset, UnwindContextArm64 &context )
+{
+    std::vector<PackedStep>  steps;
+
+    if ( !getPackedSteps( function.unwindData, steps ) )
+        return false;
+
+    size_t  count = steps.size();
+
+    if ( ( function.unwindData & 0x3 ) == PdataFlagPacked )
+    {
+        size_t  functionLength = ( function.unwindData >> 2 ) & 0x7FF;
+
+        // the epilog undoes the prolog from its end and returns
+        size_t  epilogLength = 1;
+        for ( size_t i = 0; i < steps.size(); ++i )
+            epilogLength += isEpilogStep( steps[i] ) ? 1 : 0;
+
+        if ( offset < steps.size() )
+        {
+            count = offset;
+        }
+        else if ( offset < functionLength && offset + epilogLength >= functionLength )
+        {
+            size_t  executed = offset + epilogLength - functionLength;
+            size_t  remaining = executed < epilogLength - 1 ? epilogLength - 1 - executed : 0;
+
+            for ( count = 0; remaining > 0; ++count )
+            {
+                if ( isEpilogStep( steps[count] ) )
+                    --remaining;
+            }
+        }
+    }
+
+    return undoSteps( target, context, steps, count );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// A function without the unwind data out of the first frame: the frame
+// record x29, x30 keeps the caller frame
+
+bool unwindFrameChain( UnwindTarget &target, UnwindContextArm64 &context )
+{
+    MEMOFFSET_64  fp = context.x[UnwindRegFpArm64];
+
+    if ( fp < context.sp || ( fp & ( FrameChainAlign - 1 ) ) != 0 )
+        return false;
+
+    boost::uint64_t  record[2];
+    if ( !target.readMemory( fp, record, sizeof(record) ) )
+        return false;
+
+    context.x[UnwindRegFpArm64] = record[0];
+    context.x[UnwindRegLrArm64] = record[1];
+    context.sp = fp + sizeof(record);
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // end nameless namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool unwindFrameArm64( UnwindTarget &target, UnwindContextArm64 &context, bool &machineFrame, MEMOFFSET_64 &establisherFrame )
+{
+    MEMOFFSET_64  pc = context.pc;
+
+    // the call can be the last instruction of a function
+    MEMOFFSET_64  lookupPc = machineFrame ? pc : pc - 4;
+
+    bool  firstFrame = machineFrame;
+
+    machineFrame = false;
+
+    UnwindFunctionTablePtr  table = target.getFunctionTable( lookupPc );
+
+    const UnwindFunction  *entry = 0;
+
+    if ( table && lookupPc - table->getImageBase() <= 0xFFFFFFFF )
+        entry = table->find( static_cast<boost::uint32_t>( lookupPc - table->getImageBase() ) );
+
+    bool  unwound;
+
+    if ( !entry )
+    {
+        // a leaf function does not touch the stack and lr
+        unwound = firstFrame || unwindFrameChain( target, context );
+    }
+    else
+    {
+        size_t  offset = static_cast<size_t>( ( pc - table->getImageBase() - entry->begin ) / 4 );
+
+        if ( ( entry->unwindData & 0x3 ) == PdataFlagXdata )
+            unwound = unwindFullData( target, table->getImageBase(), *entry, offset, context, machineFrame );
+        else if ( ( entry->unwindData & 0x3 ) == PdataFlagPacked || ( entry->unwindData & 0x3 ) == PdataFlagPackedFragment )
+            unwound = unwindPackedData( target, *entry, offset, context );
+        else
+            unwound = false;
+    }
+
+    if ( !unwound )
+        return false;
+
+    if ( !machineFrame )
+        context.pc = context.x[UnwindRegLrArm64];
+
+    establisherFrame = context.sp;
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void unwindStackArm64( UnwindTarget &target, const UnwindContextArm64 &context, std::vector<UnwindFrameArm64> &frames, size_t maxFrames )
+{
+    frames.clear();
+
+    UnwindContextArm64  current = context;
+
+    bool  machineFrame = true;
+
+    while ( frames.size() < maxFrames && current.pc != 0 )
+    {
+        frames.push_back( UnwindFrameArm64() );
+
+        UnwindFrameArm64  &frame = frames.back();
+
+        frame.context = current;
+        frame.frame = current.sp;
+
+        if ( !unwindFrameArm64( target, current, machineFrame, frame.frame ) )
+            break;
+
+        if ( machineFrame )
+            continue;
+
+        // the caller frame is above, a leaf function shares the frame of its caller
+        if ( current.sp < frame.context.sp || ( current.sp == frame.context.sp && current.pc == frame.context.pc ) )
+            break;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
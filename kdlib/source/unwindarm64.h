@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include "unwind.h"
+
+namespace kdlib {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The registers the ARM64 unwind data can restore. The FP registers are the
+// low halves of v0 - v31: d8 - d15 are nonvolatile
+
+struct UnwindContextArm64
+{
+    boost::uint64_t  pc;
+    boost::uint64_t  sp;
+    boost::uint64_t  x[31];         // x0 - x28, fp, lr
+    boost::uint64_t  d[32];
+};
+
+const unsigned long  UnwindRegFpArm64 = 29;
+const unsigned long  UnwindRegLrArm64 = 30;
+
+struct UnwindFrameArm64
+{
+    UnwindContextArm64  context;    // the registers at the frame
+    MEMOFFSET_64  frame;            // the establisher frame: SP at the function entry
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Replaces the context with the context of the caller by the packed or the
+// full (.xdata) unwind data of the function. A function without the data is
+// a leaf one on the first frame and is unwound by the x29/x30 frame chain on
+// the others. On input machineFrame tells the PC is not a return address: it
+// is the first frame or the frame is interrupted. On output it tells the
+// caller context is restored from a machine frame or a context record.
+// Returns false if the unwind data or the stack can not be read.
+
+bool unwindFrameArm64( UnwindTarget &target, UnwindContextArm64 &context, bool &machineFrame, MEMOFFSET_64 &establisherFrame );
+
+// Unwinds from the context until the return address is zero, the stack stops
+// growing up or it is not readable
+void unwindStackArm64( UnwindTarget &target, const UnwindContextArm64 &context, std::vector<UnwindFrameArm64> &frames, size_t maxFrames = 1024 );
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
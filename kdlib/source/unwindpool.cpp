@@ -0,0 +1,316 @@
+#include "stdafx.h"
+
+#include <map>
+#include <deque>
+#include <cstring>
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/atomic.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include "kdlib/memaccess.h"
+
+#include "unwindpool.h"
+
+namespace kdlib {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+
+const MEMOFFSET_64  PoolPageSize = 0x1000;
+
+typedef boost::shared_ptr<const std::vector<char> >  PoolPagePtr;
+
+struct EngineRequest
+{
+    enum Kind {
+        ReadPage,
+        FindTable
+    };
+
+    EngineRequest( Kind kind_, MEMOFFSET_64 offset_ ) :
+        kind( kind_ ),
+        offset( offset_ ),
+        done( false )
+        {}
+
+    Kind  kind;
+    MEMOFFSET_64  offset;
+    UnwindFunctionTablePtr  table;
+    bool  done;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The requests of the workers to the engine and the memory pages read for them
+
+class EngineProxy
+{
+public:
+
+    EngineProxy( unsigned long workerCount ) :
+        m_running( workerCount )
+        {}
+
+    // worker side: false if the page is not readable
+    bool getPage( MEMOFFSET_64 pageBase, PoolPagePtr &page )
+    {
+        if ( findPage( pageBase, page ) )
+            return !!page;
+
+        EngineRequest  request( EngineRequest::ReadPage, pageBase );
+        call( request );
+
+        findPage( pageBase, page );
+        return !!page;
+    }
+
+    UnwindFunctionTablePtr getFunctionTable( MEMOFFSET_64 offset )
+    {
+        EngineRequest  request( EngineRequest::FindTable, offset );
+        call( request );
+
+        return request.table;
+    }
+
+    void workerDone()
+    {
+        boost::mutex::scoped_lock  lock( m_lock );
+
+        if ( --m_running == 0 )
+            m_requested.notify_one();
+    }
+
+    // engine side: returns when all the workers are done
+    void serve()
+    {
+        boost::mutex::scoped_lock  lock( m_lock );
+
+        while ( true )
+        {
+            while ( m_requests.empty() && m_running > 0 )
+                m_requested.wait( lock );
+
+            if ( m_requests.empty() )
+                break;
+
+            EngineRequest  *request = m_requests.front();
+            m_requests.pop_front();
+
+            lock.unlock();
+
+            try
+            {
+                execute( *request );
+            }
+            catch(...)
+            {
+                // the worker gets an unreadable page or no function table
+            }
+
+            lock.lock();
+
+            request->done = true;
+            m_served.notify_all();
+        }
+    }
+
+private:
+
+    void call( EngineRequest &request )
+    {
+        boost::mutex::scoped_lock  lock( m_lock );
+
+        m_requests.push_back( &request );
+        m_requested.notify_one();
+
+        while ( !request.done )
+            m_served.wait( lock );
+    }
+
+    void execute( EngineRequest &request )
+    {
+        switch ( request.kind )
+        {
+        case EngineRequest::ReadPage:
+            {
+                PoolPagePtr  page;
+
+                // another worker could ask for the page before
+                if ( findPage( request.offset, page ) )
+                    break;
+
+                boost::shared_ptr<std::vector<char> >  buffer( new std::vector<char>( static_cast<size_t>(PoolPageSize) ) );
+
+                if ( readMemoryUnsafe( request.offset, &buffer->front(), buffer->size() ) )
+                    page = buffer;
+
+                boost::mutex::scoped_lock  lock( m_pageLock );
+                m_pages[ request.offset ] = page;
+            }
+            break;
+
+        case EngineRequest::FindTable:
+            request.table = m_target.getFunctionTable( request.offset );
+            break;
+        }
+    }
+
+    bool findPage( MEMOFFSET_64 pageBase, PoolPagePtr &page )
+    {
+        boost::mutex::scoped_lock  lock( m_pageLock );
+
+        std::map<MEMOFFSET_64, PoolPagePtr>::const_iterator  it = m_pages.find( pageBase );
+        if ( it == m_pages.end() )
+            return false;
+
+        page = it->second;
+        return true;
+    }
+
+    boost::mutex  m_lock;
+    boost::condition_variable  m_requested;
+    boost::condition_variable  m_served;
+    std::deque<EngineRequest*>  m_requests;
+    unsigned long  m_running;
+
+    // a null page is not readable
+    boost::mutex  m_pageLock;
+    std::map<MEMOFFSET_64, PoolPagePtr>  m_pages;
+
+    // called by the engine thread only
+    DbgUnwindTarget  m_target;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class PoolUnwindTarget : public UnwindTarget
+{
+public:
+
+    PoolUnwindTarget( EngineProxy &proxy ) :
+        m_proxy( proxy )
+        {}
+
+    bool readMemory( MEMOFFSET_64 offset, void* buffer, size_t length ) override
+    {
+        char  *dest = static_cast<char*>( buffer );
+
+        while ( length > 0 )
+        {
+            MEMOFFSET_64  pageBase = offset & ~( PoolPageSize - 1 );
+            size_t  pageOffset = static_cast<size_t>( offset - pageBase );
+            size_t  copyLength = std::min( length, static_cast<size_t>(PoolPageSize) - pageOffset );
+
+            PoolPagePtr  page;
+            if ( !m_proxy.getPage( pageBase, page ) )
+                return false;
+
+            memcpy( dest, &page->front() + pageOffset, copyLength );
+
+            dest += copyLength;
+            offset += copyLength;
+            length -= copyLength;
+        }
+
+        return true;
+    }
+
+    UnwindFunctionTablePtr getFunctionTable( MEMOFFSET_64 offset ) override
+    {
+        for ( std::vector<UnwindFunctionTablePtr>::const_iterator it = m_tables.begin(); it != m_tables.end(); ++it )
+        {
+            if ( (*it)->inRange( offset ) )
+                return *it;
+        }
+
+        UnwindFunctionTablePtr  table = m_proxy.getFunctionTable( offset );
+
+        if ( table )
+            m_tables.push_back( table );
+
+        return table;
+    }
+
+private:
+
+    EngineProxy  &m_proxy;
+    std::vector<UnwindFunctionTablePtr>  m_tables;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+void unwindWorker( EngineProxy &proxy, std::vector<UnwindJobAmd64> &jobs, boost::atomic<size_t> &nextJob, size_t maxFrames )
+{
+    PoolUnwindTarget  target( proxy );
+
+    for ( size_t i = nextJob++; i < jobs.size(); i = nextJob++ )
+    {
+        try
+        {
+            unwindStackAmd64( target, jobs[i].context, jobs[i].frames, maxFrames );
+        }
+        catch(...)
+        {
+            // the frames unwound before are kept
+        }
+    }
+
+    proxy.workerDone();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // end nameless namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+void unwindStacksAmd64( std::vector<UnwindJobAmd64> &jobs, unsigned long threadCount, size_t maxFrames )
+{
+    if ( jobs.empty() )
+        return;
+
+    if ( threadCount == 0 )
+        threadCount = std::max( boost::thread::hardware_concurrency(), 1U );
+
+    if ( threadCount > jobs.size() )
+        threadCount = static_cast<unsigned long>( jobs.size() );
+
+    EngineProxy  proxy( threadCount );
+    boost::atomic<size_t>  nextJob( 0 );
+    boost::thread_group  workers;
+
+    unsigned long  created = 0;
+
+    try
+    {
+        for ( ; created < threadCount; ++created )
+            workers.create_thread( boost::bind( &unwindWorker, boost::ref(proxy), boost::ref(jobs), boost::ref(nextJob), maxFrames ) );
+    }
+    catch( const boost::thread_resource_error& )
+    {
+        for ( unsigned long i = created; i < threadCount; ++i )
+            proxy.workerDone();
+    }
+
+    proxy.serve();
+
+    // no thread is started: the stacks are unwound here
+    if ( created == 0 )
+    {
+        DbgUnwindTarget  target;
+
+        for ( size_t i = 0; i < jobs.size(); ++i )
+            unwindStackAmd64( target, jobs[i].context, jobs[i].frames, maxFrames );
+    }
+
+    workers.join_all();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <vector>
+
+#include "unwindamd64.h"
+
+namespace kdlib {
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct UnwindJobAmd64
+{
+    UnwindContextAmd64  context;
+    std::vector<UnwindFrameAmd64>  frames;
+};
+
+// Unwinds the stacks of many threads of the current process on a worker pool.
+// The workers read the target memory and the function tables through the
+// calling thread: it serves their requests until the pool is done, the engine
+// is not called by another thread. The memory is cached by pages, so the
+// threads running the same code read its unwind info and its code once.
+// threadCount 0 - one worker per CPU
+
+void unwindStacksAmd64( std::vector<UnwindJobAmd64> &jobs, unsigned long threadCount, size_t maxFrames );
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
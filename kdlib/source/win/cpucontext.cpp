@@ -2,12 +2,22 @@
 
 #include <cvconst.h>
 
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
 #include "kdlib/dbgengine.h"
 #include "kdlib/exceptions.h"
 #include "kdlib/memaccess.h"
+#include "kdlib/typeinfo.h"
+#include "kdlib/typedvar.h"
 
 #include "stackimpl.h"
+#include "stackscan.h"
+#include "unwindamd64.h"
+#include "unwindarm64.h"
+#include "unwindpool.h"
 #include "cpucontextimpl.h"
+#include "autoswitch.h"
 #include "dbgmgr.h"
 
 
@@ -309,97 +319,239 @@ CPUContextPtr loadCPUContext()
 
 ///////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+const ULONG  MaxStackFrames = 1024;
+
+// The frame buffers of the engine stack walker are reused by the thread: a
+// stack is copied out of them with its size
+
+struct StackTraceBuffers
+{
+    std::vector<DEBUG_STACK_FRAME>  frames;
+    std::vector<DEBUG_STACK_FRAME_EX>  framesEx;
+};
+
+boost::thread_specific_ptr<StackTraceBuffers>  stackTraceBuffers;
+
+StackTraceBuffers& getStackTraceBuffers()
+{
+    if (!stackTraceBuffers.get())
+        stackTraceBuffers.reset(new StackTraceBuffers());
+
+    return *stackTraceBuffers;
+}
+
+template <typename RawContextType>
+RawContextType* getContextBuffer(ULONG frameCount)
+{
+    static boost::thread_specific_ptr< std::vector<RawContextType> >  contextBuffers;
+
+    if (!contextBuffers.get())
+        contextBuffers.reset(new std::vector<RawContextType>());
+
+    if (contextBuffers->size() < frameCount)
+        contextBuffers->resize(frameCount);
+
+    return &(*contextBuffers)[0];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Fills the thread buffer by the frames, the contexts are optional
+
+template <typename RawContextType>
+ULONG getStackTrace(const RawContextType& startContext, ULONG frameCount, RawContextType* contexts)
+{
+    std::vector<DEBUG_STACK_FRAME>  &frames = getStackTraceBuffers().frames;
+    if (frames.size() < frameCount)
+        frames.resize(frameCount);
+
+    ULONG  filledFrames = 0;
+
+    g_dbgMgr->setQuietNotiification(true);
+
+    HRESULT  hres =
+        g_dbgMgr->control->GetContextStackTrace(
+            const_cast<RawContextType*>(&startContext),
+            sizeof(RawContextType),
+            &frames[0],
+            frameCount,
+            contexts,
+            frameCount * sizeof(RawContextType),
+            sizeof(RawContextType),
+            &filledFrames
+        );
+
+    g_dbgMgr->setQuietNotiification(false);
+
+    if (S_OK != hres)
+        throw DbgEngException(L"IDebugControl::GetContextStackTrace", hres);
+
+    return filledFrames;
+}
+
+template <typename RawContextType>
+ULONG getStackTraceEx(const RawContextType& startContext, ULONG frameCount, RawContextType* contexts)
+{
+    std::vector<DEBUG_STACK_FRAME_EX>  &frames = getStackTraceBuffers().framesEx;
+    if (frames.size() < frameCount)
+        frames.resize(frameCount);
+
+    ULONG  filledFrames = 0;
+
+    g_dbgMgr->setQuietNotiification(true);
+
+    HRESULT  hres =
+        g_dbgMgr->control->GetContextStackTraceEx(
+            const_cast<RawContextType*>(&startContext),
+            sizeof(RawContextType),
+            &frames[0],
+            frameCount,
+            contexts,
+            frameCount * sizeof(RawContextType),
+            sizeof(RawContextType),
+            &filledFrames
+        );
+
+    g_dbgMgr->setQuietNotiification(false);
+
+    if (S_OK != hres)
+        throw DbgEngException(L"IDebugControl::GetContextStackTrace", hres);
+
+    return filledFrames;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The raw frame contexts are copied out of the walk buffer; a CPUContext is
+// made when a frame asks for it
+
 template <class ContextType>
-StackPtr getStackImpl(bool inlineFrames)
+class EngineStackContexts : public StackContextSource
 {
-    HRESULT  hres;
+public:
 
-    if (inlineFrames)
+    typedef typename ContextType::RawContextType  RawContextType;
+
+    EngineStackContexts(const RawContextType* contexts, ULONG contextCount) :
+        m_contexts(contexts, contexts + contextCount)
+        {}
+
+    CPUContextPtr getCPUContext(unsigned long index) override
     {
-        ULONG   filledFrames = 1024;
-        std::vector<DEBUG_STACK_FRAME_EX>  frames(filledFrames);
-        std::vector<ContextType::RawContextType>  contexts(filledFrames);
+        if (index >= m_contexts.size())
+            throw IndexException(index);
 
-        g_dbgMgr->setQuietNotiification(true);
+        return CPUContextPtr(new ContextType(m_contexts[index]));
+    }
 
-        hres =
-            g_dbgMgr->control->GetContextStackTraceEx(
-                NULL,
-                0,
-                &frames[0],
-                filledFrames,
-                &contexts[0],
-                filledFrames * sizeof(ContextType::RawContextType),
-                sizeof(ContextType::RawContextType),
-                &filledFrames
-            );
-
-        g_dbgMgr->setQuietNotiification(false);
+private:
 
-        if (S_OK != hres)
-            throw DbgEngException(L"IDebugControl::GetContextStackTrace", hres);
+    std::vector<RawContextType>  m_contexts;
+};
 
-        std::vector<StackFramePtr>  stackFrames;
+// Every frame gets the same context
 
-        for (ULONG i = 0; i < filledFrames; ++i)
-        {
-            int j = 0;
-            while ( (frames[i + j].InlineFrameContext & 0x200) != 0 )
-                ++j;
+template <class ContextType>
+class StartStackContext : public StackContextSource
+{
+public:
 
-            stackFrames.push_back(StackFramePtr(new StackFrameImpl(
-                i,
-                frames[i+j].InstructionOffset,
-                frames[i+j].ReturnOffset,
-                frames[i+j].FrameOffset,
-                frames[i+j].StackOffset,
-                CPUContextPtr(new ContextType(contexts[i])),
-                j
-            )));
-        }
+    typedef typename ContextType::RawContextType  RawContextType;
 
-        return StackPtr(new StackImpl(stackFrames));
-    }
-    else
+    explicit StartStackContext(const RawContextType& startContext) :
+        m_startContext(startContext)
+        {}
+
+    CPUContextPtr getCPUContext(unsigned long index) override
     {
-        ULONG   filledFrames = 1024;
-        std::vector<DEBUG_STACK_FRAME>  frames(filledFrames);
-        std::vector<ContextType::RawContextType>  contexts(filledFrames);
+        return CPUContextPtr(new ContextType(m_startContext));
+    }
 
-        g_dbgMgr->setQuietNotiification(true);
+private:
 
-        hres =
-            g_dbgMgr->control->GetContextStackTrace(
-                NULL,
-                0,
-                &frames[0],
-                filledFrames,
-                &contexts[0],
-                filledFrames * sizeof(ContextType::RawContextType),
-                sizeof(ContextType::RawContextType),
-                &filledFrames
-            );
-
-        g_dbgMgr->setQuietNotiification(false);
+    RawContextType  m_startContext;
+};
 
-        if (S_OK != hres)
-            throw DbgEngException(L"IDebugControl::GetContextStackTrace", hres);
+///////////////////////////////////////////////////////////////////////////////
 
-        std::vector<StackFramePtr>  stackFrames;
+StackFrameData makeFrameData(const DEBUG_STACK_FRAME& frame, unsigned long contextIndex, unsigned long inlineIndex = 0)
+{
+    StackFrameData  frameData;
+    frameData.ip = frame.InstructionOffset;
+    frameData.ret = frame.ReturnOffset;
+    frameData.fp = frame.FrameOffset;
+    frameData.sp = frame.StackOffset;
+    frameData.inlineIndex = inlineIndex;
+    frameData.contextIndex = contextIndex;
+    return frameData;
+}
+
+StackFrameData makeFrameData(const DEBUG_STACK_FRAME_EX& frame, unsigned long contextIndex, unsigned long inlineIndex = 0)
+{
+    StackFrameData  frameData;
+    frameData.ip = frame.InstructionOffset;
+    frameData.ret = frame.ReturnOffset;
+    frameData.fp = frame.FrameOffset;
+    frameData.sp = frame.StackOffset;
+    frameData.inlineIndex = inlineIndex;
+    frameData.contextIndex = contextIndex;
+    return frameData;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // end nameless namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <class ContextType>
+StackPtr getStackImpl(bool inlineFrames, ULONG maxFrames)
+{
+    typedef typename ContextType::RawContextType  RawContextType;
+
+    const RawContextType  startContext = ContextType().getRawContext();
+
+    // the contexts are captured by the same walk: the stack does not depend
+    // on the current thread after it is built
+    RawContextType  *contexts = getContextBuffer<RawContextType>(maxFrames);
+
+    std::vector<StackFrameData>  stackFrames;
+    ULONG  filledFrames = 0;
+
+    if (inlineFrames)
+    {
+        filledFrames = getStackTraceEx(startContext, maxFrames, contexts);
+
+        const std::vector<DEBUG_STACK_FRAME_EX>  &frames = getStackTraceBuffers().framesEx;
+
+        stackFrames.reserve(filledFrames);
 
         for (ULONG i = 0; i < filledFrames; ++i)
         {
-            stackFrames.push_back(StackFramePtr(new StackFrameImpl(
-                i,
-                frames[i].InstructionOffset,
-                frames[i].ReturnOffset,
-                frames[i].FrameOffset,
-                frames[i].StackOffset,
-                CPUContextPtr(new ContextType(contexts[i])))));
+            ULONG  j = 0;
+            while ( i + j + 1 < filledFrames && (frames[i + j].InlineFrameContext & 0x200) != 0 )
+                ++j;
+
+            stackFrames.push_back(makeFrameData(frames[i + j], i, j));
         }
+    }
+    else
+    {
+        filledFrames = getStackTrace(startContext, maxFrames, contexts);
+
+        const std::vector<DEBUG_STACK_FRAME>  &frames = getStackTraceBuffers().frames;
 
-        return StackPtr(new StackImpl(stackFrames));
+        stackFrames.reserve(filledFrames);
+
+        for (ULONG i = 0; i < filledFrames; ++i)
+            stackFrames.push_back(makeFrameData(frames[i], i));
     }
+
+    StackContextSourcePtr  stackContexts(new EngineStackContexts<ContextType>(contexts, filledFrames));
+
+    return StackPtr(new StackImpl(stackFrames, stackContexts));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -495,104 +647,45 @@ void ReadWow64Context(WOW64_CONTEXT& wow64Context)
 
 ///////////////////////////////////////////////////////////////////////////////
 
-StackPtr getStackWow64(bool inlineFrames)
+StackPtr getStackWow64(bool inlineFrames, ULONG maxFrames)
 {
     if (getLastEventThreadId() == getCurrentThreadId())
-        return getStackImpl<CPUContextWOW64>(inlineFrames);
+        return getStackImpl<CPUContextWOW64>(inlineFrames, maxFrames);
 
-    HRESULT  hres;
+    WOW64_CONTEXT  wow64Context;
+    ReadWow64Context(wow64Context);
+
+    std::vector<StackFrameData>  stackFrames;
 
     if (inlineFrames)
     {
-        ULONG   filledFrames = 1024;
-        std::vector<DEBUG_STACK_FRAME_EX>  frames(filledFrames);
-
-        WOW64_CONTEXT  wow64Context;
-        ReadWow64Context(wow64Context);
-
-        g_dbgMgr->setQuietNotiification(true);
+        ULONG  filledFrames = getStackTraceEx(wow64Context, maxFrames, static_cast<WOW64_CONTEXT*>(0));
 
-        hres =
-            g_dbgMgr->control->GetContextStackTraceEx(
-                &wow64Context,
-                sizeof(WOW64_CONTEXT),
-                &frames[0],
-                filledFrames,
-                NULL, //&contexts[0],
-                filledFrames * sizeof(WOW64_CONTEXT),
-                sizeof(WOW64_CONTEXT),
-                &filledFrames
-            );
-
-        g_dbgMgr->setQuietNotiification(false);
-
-        if (S_OK != hres)
-            throw DbgEngException(L"IDebugControl::GetContextStackTrace", hres);
+        const std::vector<DEBUG_STACK_FRAME_EX>  &frames = getStackTraceBuffers().framesEx;
 
-        std::vector<StackFramePtr>  stackFrames;
+        stackFrames.reserve(filledFrames);
 
         for (ULONG i = 0; i < filledFrames; ++i)
-        {
-            stackFrames.push_back(StackFramePtr(new StackFrameImpl(
-                i,
-                frames[i].InstructionOffset,
-                frames[i].ReturnOffset,
-                frames[i].FrameOffset,
-                frames[i].StackOffset,
-                CPUContextPtr(new CPUContextWOW64(wow64Context)),
-                (frames[i].InlineFrameContext & 0x200) != 0
-            )));
-        }
-
-        return StackPtr(new StackImpl(stackFrames));
+            stackFrames.push_back(makeFrameData(frames[i], i, (frames[i].InlineFrameContext & 0x200) != 0));
     }
     else
     {
-        ULONG   filledFrames = 1024;
-        std::vector<DEBUG_STACK_FRAME>  frames(filledFrames);
-
-        WOW64_CONTEXT  wow64Context;
-        ReadWow64Context(wow64Context);
+        ULONG  filledFrames = getStackTrace(wow64Context, maxFrames, static_cast<WOW64_CONTEXT*>(0));
 
-        g_dbgMgr->setQuietNotiification(true);
+        const std::vector<DEBUG_STACK_FRAME>  &frames = getStackTraceBuffers().frames;
 
-        hres =
-            g_dbgMgr->control->GetContextStackTrace(
-                &wow64Context,
-                sizeof(WOW64_CONTEXT),
-                &frames[0],
-                filledFrames,
-                NULL, //&contexts[0],
-                filledFrames * sizeof(WOW64_CONTEXT),
-                sizeof(WOW64_CONTEXT),
-                &filledFrames
-            );
-
-        g_dbgMgr->setQuietNotiification(false);
-
-        if (S_OK != hres)
-            throw DbgEngException(L"IDebugControl::GetContextStackTrace", hres);
-
-        std::vector<StackFramePtr>  stackFrames;
+        stackFrames.reserve(filledFrames);
 
         for (ULONG i = 0; i < filledFrames; ++i)
-        {
-            stackFrames.push_back(StackFramePtr(new StackFrameImpl(
-                i,
-                frames[i].InstructionOffset,
-                frames[i].ReturnOffset,
-                frames[i].FrameOffset,
-                frames[i].StackOffset,
-                CPUContextPtr(new CPUContextWOW64(wow64Context)))));
-        }
-
-        return StackPtr(new StackImpl(stackFrames));
+            stackFrames.push_back(makeFrameData(frames[i], i));
     }
+
+    return StackPtr(new StackImpl(stackFrames, StackContextSourcePtr(new StartStackContext<CPUContextWOW64>(wow64Context))));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-StackPtr getStack(bool inlineFrames)
+StackPtr getEngineStack(bool inlineFrames, ULONG maxFrames)
 {
     HRESULT  hres;
     
@@ -603,13 +696,13 @@ StackPtr getStack(bool inlineFrames)
         throw DbgEngException(L"IDebugControl::GetActualProcessorType", hres);
 
     if (cpuType == IMAGE_FILE_MACHINE_I386)
-        return getStackImpl<CPUContextI386>(inlineFrames);
+        return getStackImpl<CPUContextI386>(inlineFrames, maxFrames);
 
     if (cpuType == IMAGE_FILE_MACHINE_ARM64)
-        return getStackImpl<CPUContextArm64>(inlineFrames);
+        return getStackImpl<CPUContextArm64>(inlineFrames, maxFrames);
 
     if (cpuType == IMAGE_FILE_MACHINE_ARMNT)
-        return getStackImpl<CPUContextArm>(inlineFrames);
+        return getStackImpl<CPUContextArm>(inlineFrames, maxFrames);
 
     ULONG  cpuMode;
     hres = g_dbgMgr->control->GetEffectiveProcessorType((PULONG)&cpuMode);
@@ -617,125 +710,658 @@ StackPtr getStack(bool inlineFrames)
         throw DbgEngException(L"IDebugControl::GetEffectiveProcessorType", hres);
 
     if (cpuType == IMAGE_FILE_MACHINE_AMD64 && cpuMode == IMAGE_FILE_MACHINE_AMD64)
-        return getStackImpl<CPUContextAmd64>(inlineFrames);
+        return getStackImpl<CPUContextAmd64>(inlineFrames, maxFrames);
 
     if (cpuType == IMAGE_FILE_MACHINE_AMD64 && cpuMode == IMAGE_FILE_MACHINE_I386)
-        return getStackWow64(inlineFrames);
+        return getStackWow64(inlineFrames, maxFrames);
     
     throw DbgException("Unknown CPU type/mode");
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-template <class ContextType>
-StackFramePtr getStackFrameImpl()
+StackPtr getStack(bool inlineFrames)
 {
-    HRESULT  hres;
-    DEBUG_STACK_FRAME  stackFrame = {};
-    ULONG  frameNumber;
+    return getEngineStack(inlineFrames, MaxStackFrames);
+}
 
-    ULONG   filledFrames = 1024;
-    std::vector<DEBUG_STACK_FRAME>  frames(filledFrames);
-    std::vector<ContextType::RawContextType>  contexts(filledFrames);
-    
-    g_dbgMgr->setQuietNotiification(true);
+///////////////////////////////////////////////////////////////////////////////
 
-    hres = g_dbgMgr->symbols->GetScope(NULL, &stackFrame, NULL, 0);
+namespace {
 
-    frameNumber = stackFrame.FrameNumber;
+// The unwound registers over the registers of the first frame
 
-    if (FAILED(hres))
+class UnwindStackContexts : public StackContextSource
+{
+public:
+
+    UnwindStackContexts(const CONTEXT_X64& startContext, const std::vector<UnwindFrameAmd64>& frames) :
+        m_startContext(startContext)
     {
-        g_dbgMgr->setQuietNotiification(false);
-        throw DbgEngException(L"IDebugSymbols::GetScope", hres);
+        m_frames.reserve(frames.size());
+        for (size_t i = 0; i < frames.size(); ++i)
+            m_frames.push_back(frames[i].context);
     }
 
-    hres =
-        g_dbgMgr->control->GetContextStackTrace(
-        NULL,
-        0,
-        &frames[0],
-        filledFrames,
-        &contexts[0],
-        filledFrames*sizeof(ContextType::RawContextType),
-        sizeof(ContextType::RawContextType),
-        &filledFrames
-        );
+    CPUContextPtr getCPUContext(unsigned long index) override
+    {
+        if (index >= m_frames.size())
+            throw IndexException(index);
 
-    if (FAILED(hres))
+        CONTEXT_X64  rawContext = m_startContext;
+
+        rawContext.Rip = m_frames[index].rip;
+        memcpy(&rawContext.Rax, m_frames[index].gpr, sizeof(m_frames[index].gpr));
+        memcpy(&rawContext.Xmm0, m_frames[index].xmm, sizeof(m_frames[index].xmm));
+
+        return CPUContextPtr(new CPUContextAmd64(rawContext));
+    }
+
+private:
+
+    CONTEXT_X64  m_startContext;
+    std::vector<UnwindContextAmd64>  m_frames;
+};
+
+UnwindContextAmd64 makeUnwindContext(const CONTEXT_X64& rawContext)
+{
+    UnwindContextAmd64  unwindContext;
+    unwindContext.rip = rawContext.Rip;
+    memcpy(unwindContext.gpr, &rawContext.Rax, sizeof(unwindContext.gpr));
+    memcpy(unwindContext.xmm, &rawContext.Xmm0, sizeof(unwindContext.xmm));
+
+    return unwindContext;
+}
+
+StackPtr makeUnwoundStack(const CONTEXT_X64& rawContext, const std::vector<UnwindFrameAmd64>& frames)
+{
+    std::vector<StackFrameData>  stackFrames(frames.size());
+
+    for (size_t i = 0; i < frames.size(); ++i)
     {
-        g_dbgMgr->setQuietNotiification(false);
-        throw DbgEngException(L"IDebugControl4::GetContextStackTrace", hres);
+        stackFrames[i].ip = frames[i].context.rip;
+        stackFrames[i].ret = i + 1 < frames.size() ? frames[i + 1].context.rip : 0;
+        stackFrames[i].fp = frames[i].frame;
+        stackFrames[i].sp = frames[i].context.gpr[UnwindRegRspAmd64];
+        stackFrames[i].inlineIndex = 0;
+        stackFrames[i].contextIndex = static_cast<unsigned long>(i);
     }
 
-    g_dbgMgr->setQuietNotiification(false);
+    return StackPtr(new StackImpl(stackFrames, StackContextSourcePtr(new UnwindStackContexts(rawContext, frames))));
+}
 
-    return StackFramePtr(new StackFrameImpl(
-        frameNumber,
-        frames[frameNumber].InstructionOffset,
-        frames[frameNumber].ReturnOffset,
-        frames[frameNumber].FrameOffset,
-        frames[frameNumber].StackOffset,
-        CPUContextPtr(new ContextType(contexts[frameNumber]))));
+class UnwindStackContextsArm64 : public StackContextSource
+{
+public:
+
+    UnwindStackContextsArm64(const CONTEXT_ARM64& startContext, const std::vector<UnwindFrameArm64>& frames) :
+        m_startContext(startContext)
+    {
+        m_frames.reserve(frames.size());
+        for (size_t i = 0; i < frames.size(); ++i)
+            m_frames.push_back(frames[i].context);
+    }
+
+    CPUContextPtr getCPUContext(unsigned long index) override
+    {
+        if (index >= m_frames.size())
+            throw IndexException(index);
+
+        CONTEXT_ARM64  rawContext = m_startContext;
+
+        rawContext.Pc = m_frames[index].pc;
+        rawContext.Sp = m_frames[index].sp;
+        memcpy(rawContext.X, m_frames[index].x, sizeof(m_frames[index].x));
+
+        for (size_t i = 0; i < 32; ++i)
+            rawContext.V[i].Low = m_frames[index].d[i];
+
+        return CPUContextPtr(new CPUContextArm64(rawContext));
+    }
+
+private:
+
+    CONTEXT_ARM64  m_startContext;
+    std::vector<UnwindContextArm64>  m_frames;
+};
+
+UnwindContextArm64 makeUnwindContext(const CONTEXT_ARM64& rawContext)
+{
+    UnwindContextArm64  unwindContext;
+    unwindContext.pc = rawContext.Pc;
+    unwindContext.sp = rawContext.Sp;
+    memcpy(unwindContext.x, rawContext.X, sizeof(unwindContext.x));
+
+    for (size_t i = 0; i < 32; ++i)
+        unwindContext.d[i] = rawContext.V[i].Low;
+
+    return unwindContext;
 }
 
+StackPtr makeUnwoundStack(const CONTEXT_ARM64& rawContext, const std::vector<UnwindFrameArm64>& frames)
+{
+    std::vector<StackFrameData>  stackFrames(frames.size());
+
+    for (size_t i = 0; i < frames.size(); ++i)
+    {
+        stackFrames[i].ip = frames[i].context.pc;
+        stackFrames[i].ret = i + 1 < frames.size() ? frames[i + 1].context.pc : 0;
+        stackFrames[i].fp = frames[i].frame;
+        stackFrames[i].sp = frames[i].context.sp;
+        stackFrames[i].inlineIndex = 0;
+        stackFrames[i].contextIndex = static_cast<unsigned long>(i);
+    }
+
+    return StackPtr(new StackImpl(stackFrames, StackContextSourcePtr(new UnwindStackContextsArm64(rawContext, frames))));
+}
+
+} // end nameless namespace
+
 ///////////////////////////////////////////////////////////////////////////////
 
-StackFramePtr getStackFrameWow64()
+StackPtr unwindStack(const CPUContextPtr& cpuContext)
 {
-    if (getLastEventThreadId() == getCurrentThreadId())
-        return getStackFrameImpl<CPUContextWOW64>();
+    CPUContextPtr  context = cpuContext ? cpuContext : loadCPUContext();
 
-    HRESULT  hres;
-    DEBUG_STACK_FRAME  stackFrame = {};
-    ULONG  frameNumber;
+    DbgUnwindTarget  target;
 
-    ULONG   filledFrames = 1024;
-    std::vector<DEBUG_STACK_FRAME>  frames(filledFrames);
-    //std::vector<WOW64_CONTEXT>  contexts(filledFrames);
+    const CPUContextAmd64  *amd64Context = dynamic_cast<const CPUContextAmd64*>(context.get());
+    if (amd64Context)
+    {
+        const CONTEXT_X64  &rawContext = amd64Context->getRawContext();
 
-    g_dbgMgr->setQuietNotiification(true);
+        std::vector<UnwindFrameAmd64>  frames;
+        unwindStackAmd64(target, makeUnwindContext(rawContext), frames);
 
-    hres = g_dbgMgr->symbols->GetScope(NULL, &stackFrame, NULL, 0);
+        return makeUnwoundStack(rawContext, frames);
+    }
 
-    frameNumber = stackFrame.FrameNumber;
+    const CPUContextArm64  *arm64Context = dynamic_cast<const CPUContextArm64*>(context.get());
+    if (arm64Context)
+    {
+        const CONTEXT_ARM64  &rawContext = arm64Context->getRawContext();
 
-    if (FAILED(hres))
+        std::vector<UnwindFrameArm64>  frames;
+        unwindStackArm64(target, makeUnwindContext(rawContext), frames);
+
+        return makeUnwoundStack(rawContext, frames);
+    }
+
+    throw DbgException("stack unwinding supports only AMD64 and ARM64 context");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Only the thread registers are read with the thread switched: the AMD64
+// stacks are unwound together after that. The other threads are walked by
+// the engine while switched, with their frame contexts.
+
+struct ThreadUnwindJobs {
+    std::vector<size_t>  threads;   // indices in the thread list
+    std::vector<CONTEXT_X64>  contexts;
+    std::vector<UnwindJobAmd64>  jobs;
+};
+
+// adds the stack of the thread switched to, an AMD64 one is unwound later
+void readThreadStack(const AllStacksOptions& options, ThreadUnwindJobs& unwindJobs, std::vector<ThreadStack>& threads, ThreadStack& threadStack)
+{
+    try
     {
-        g_dbgMgr->setQuietNotiification(false);
-        throw DbgEngException(L"IDebugSymbols::GetScope", hres);
+        if (getCPUType() == CPU_AMD64 && getCPUMode() == CPU_AMD64)
+        {
+            UnwindJobAmd64  job;
+            unwindJobs.contexts.push_back(CPUContextAmd64().getRawContext());
+            job.context = makeUnwindContext(unwindJobs.contexts.back());
+
+            unwindJobs.jobs.push_back(job);
+            unwindJobs.threads.push_back(threads.size());
+        }
+        else if (options.maxFrames > 0)
+        {
+            // the frame contexts are captured here, with the thread switched
+            threadStack.stack = getEngineStack(false, options.maxFrames < MaxStackFrames ? options.maxFrames : MaxStackFrames);
+        }
+        else
+        {
+            std::vector<StackFrameData>  noFrames;
+            threadStack.stack = StackPtr(new StackImpl(noFrames, StackContextSourcePtr()));
+        }
+    }
+    catch (const DbgException&)
+    {
+        // the thread context is not available
+        std::vector<StackFrameData>  noFrames;
+        threadStack.stack = StackPtr(new StackImpl(noFrames, StackContextSourcePtr()));
     }
 
-    WOW64_CONTEXT  wow64Context;
-    ReadWow64Context(wow64Context);
+    threads.push_back(threadStack);
+}
 
-    hres =
-        g_dbgMgr->control->GetContextStackTrace(
-            &wow64Context,
-            sizeof(wow64Context),
-            &frames[0],
-            filledFrames,
-            NULL, //&contexts[0],
-            filledFrames*sizeof(WOW64_CONTEXT),
-            sizeof(WOW64_CONTEXT),
-            &filledFrames
-            );
+void unwindThreadStacks(const AllStacksOptions& options, ThreadUnwindJobs& unwindJobs, std::vector<ThreadStack>& threads)
+{
+    unwindStacksAmd64(unwindJobs.jobs, options.threadCount, options.maxFrames);
 
-    if (FAILED(hres))
+    for (size_t i = 0; i < unwindJobs.jobs.size(); ++i)
+        threads[unwindJobs.threads[i]].stack = makeUnwoundStack(unwindJobs.contexts[i], unwindJobs.jobs[i].frames);
+}
+
+void getProcessStacks(PROCESS_DEBUG_ID processId, const AllStacksOptions& options, std::vector<ThreadStack>& threads)
+{
+    ThreadUnwindJobs  unwindJobs;
+
+    unsigned long  threadCount = getNumberThreads();
+
+    for (unsigned long i = 0; i < threadCount; ++i)
+    {
+        ThreadStack  threadStack = {};
+        threadStack.processId = processId;
+        threadStack.threadId = getThreadIdByIndex(i);
+        threadStack.threadSystemId = getThreadSystemId(threadStack.threadId);
+
+        try
+        {
+            setCurrentThreadById(threadStack.threadId);
+        }
+        catch (const DbgException&)
+        {
+            std::vector<StackFrameData>  noFrames;
+            threadStack.stack = StackPtr(new StackImpl(noFrames, StackContextSourcePtr()));
+            threads.push_back(threadStack);
+            continue;
+        }
+
+        readThreadStack(options, unwindJobs, threads, threadStack);
+    }
+
+    unwindThreadStacks(options, unwindJobs, threads);
+}
+
+// The implicit process and thread are not restored with the current thread
+
+class ImplicitContextRestore
+{
+public:
+
+    ImplicitContextRestore() :
+        m_processOffset(getImplicitProcessOffset()),
+        m_threadOffset(getImplicitThreadOffset())
+        {}
+
+    ~ImplicitContextRestore()
     {
-        g_dbgMgr->setQuietNotiification(false);
-        throw DbgEngException(L"IDebugControl4::GetContextStackTrace", hres);
+        try
+        {
+            setImplicitProcess(m_processOffset);
+            setImplicitThread(m_threadOffset);
+        }
+        catch (const DbgException&)
+        {
+        }
     }
 
+private:
+
+    MEMOFFSET_64  m_processOffset;
+    MEMOFFSET_64  m_threadOffset;
+};
+
+// The engine has a thread per processor on a kernel target: the threads are
+// taken from the thread list of each EPROCESS of the kernel process list. A
+// process being created or destroyed can have no readable thread list, it
+// is skipped.
+
+void getKernelStacks(const AllStacksOptions& options, std::vector<ThreadStack>& threads)
+{
+    ThreadUnwindJobs  unwindJobs;
+
+    PROCESS_DEBUG_ID  processId = getCurrentProcessId();
+
+    ImplicitContextRestore  implicitRestore;
+
+    TypedVarList  processes = loadTypedVarList(getSymbolOffset(L"nt!PsActiveProcessHead"), L"nt!_EPROCESS", L"ActiveProcessLinks");
+
+    for (size_t i = 0; i < processes.size(); ++i)
+    {
+        MEMOFFSET_64  processOffset = processes[i]->getAddress();
+
+        TypedVarList  processThreads;
+
+        try
+        {
+            setImplicitProcess(processOffset);
+
+            processThreads = loadTypedVarList(processes[i]->getElement(L"ThreadListHead")->getAddress(), L"nt!_ETHREAD", L"ThreadListEntry");
+        }
+        catch (const DbgException&)
+        {
+            continue;
+        }
+
+        for (size_t j = 0; j < processThreads.size(); ++j)
+        {
+            ThreadStack  threadStack = {};
+            threadStack.processId = processId;
+            threadStack.processOffset = processOffset;
+            threadStack.threadOffset = processThreads[j]->getAddress();
+
+            try
+            {
+                threadStack.threadId = getThreadIdByOffset(threadStack.threadOffset);
+            }
+            catch (const DbgException&)
+            {
+                // the thread is not running on a processor
+                threadStack.threadId = static_cast<THREAD_DEBUG_ID>(-1);
+            }
+
+            try
+            {
+                threadStack.threadSystemId = static_cast<THREAD_ID>(processThreads[j]->getElement(L"Cid")->getElement(L"UniqueThread")->getValue().asULongLong());
+
+                setImplicitThread(threadStack.threadOffset);
+            }
+            catch (const DbgException&)
+            {
+                std::vector<StackFrameData>  noFrames;
+                threadStack.stack = StackPtr(new StackImpl(noFrames, StackContextSourcePtr()));
+                threads.push_back(threadStack);
+                continue;
+            }
+
+            readThreadStack(options, unwindJobs, threads, threadStack);
+        }
+    }
+
+    unwindThreadStacks(options, unwindJobs, threads);
+}
+
+} // end nameless namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+AllStacks getAllStacks(const AllStacksOptions& options)
+{
+    AllStacks  allStacks;
+
+    if (options.allProcesses && isKernelDebugging())
+    {
+        {
+            ContextAutoRestore  contextRestore;
+
+            getKernelStacks(options, allStacks.threads);
+        }
+
+        bucketStacks(allStacks);
+
+        return allStacks;
+    }
+
+    std::vector<PROCESS_DEBUG_ID>  processes;
+
+    if (options.allProcesses)
+    {
+        unsigned long  processCount = getNumberProcesses();
+        for (unsigned long i = 0; i < processCount; ++i)
+            processes.push_back(getProcessIdByIndex(i));
+    }
+    else
+    {
+        processes.push_back(getCurrentProcessId());
+    }
+
+    {
+        ContextAutoRestore  contextRestore;
+
+        for (size_t i = 0; i < processes.size(); ++i)
+        {
+            setCurrentProcessById(processes[i]);
+
+            getProcessStacks(processes[i], options, allStacks.threads);
+        }
+    }
+
+    bucketStacks(allStacks);
+
+    return allStacks;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// The executable sections of the modules. A module without readable headers
+// is taken as code as a whole: a minidump can have no headers. On a 32-bit
+// target the ranges are kept in the 32-bit space of the stack slots.
+
+CodeRangeTable getCodeRanges(bool pointer32)
+{
+    std::vector<CodeRange>  ranges;
+
+    std::vector<MEMOFFSET_64>  moduleBases = getModuleBasesList();
+
+    for (size_t i = 0; i < moduleBases.size(); ++i)
+    {
+        MEMOFFSET_64  moduleBase = moduleBases[i];
+        MEMOFFSET_64  rangeBase = pointer32 ? moduleBase & 0xFFFFFFFF : moduleBase;
+
+        std::vector<PeSection>  sections;
+
+        try
+        {
+            readPeSections(*getPeMemoryReader(moduleBase), sections);
+        }
+        catch (const DbgException&)
+        {
+            sections.clear();
+        }
+
+        size_t  sectionCount = ranges.size();
+
+        for (size_t j = 0; j < sections.size(); ++j)
+        {
+            if ((sections[j].characteristics & PeSectionExecute) == 0)
+                continue;
+
+            CodeRange  range = { rangeBase + sections[j].rva, rangeBase + sections[j].rva + sections[j].virtualSize, moduleBase };
+            ranges.push_back(range);
+        }
+
+        if (ranges.size() != sectionCount)
+            continue;
+
+        try
+        {
+            CodeRange  range = { rangeBase, rangeBase + getModuleSize(moduleBase), moduleBase };
+            ranges.push_back(range);
+        }
+        catch (const DbgException&)
+        {
+        }
+    }
+
+    return CodeRangeTable(ranges);
+}
+
+// The stack region of the current thread: the kernel stack by KTHREAD, the
+// user stack by NT_TIB at the beginning of TEB
+
+void getStackRegion(MEMOFFSET_64& stackLimit, MEMOFFSET_64& stackBase)
+{
+    MEMOFFSET_64  threadOffset = getThreadOffset();
+
+    if (isKernelDebugging())
+    {
+        TypedVarPtr  thread = loadTypedVar(L"nt!_KTHREAD", threadOffset);
+        stackBase = addr64(thread->getElement(L"StackBase")->getValue().asULongLong());
+        stackLimit = addr64(thread->getElement(L"StackLimit")->getValue().asULongLong());
+        return;
+    }
+
+    if (getCPUType() == CPU_AMD64 && getCPUMode() == CPU_I386)
+    {
+        // the 32-bit TEB of a WOW64 thread follows the 64-bit one
+        threadOffset += 0x2000;
+    }
+
+    if (getCPUMode() == CPU_I386)
+    {
+        stackBase = addr64(ptrDWord(threadOffset + 4));
+        stackLimit = addr64(ptrDWord(threadOffset + 8));
+    }
+    else
+    {
+        stackBase = ptrQWord(threadOffset + 8);
+        stackLimit = ptrQWord(threadOffset + 16);
+    }
+}
+
+void findScannedSymbol(ScannedFrame& frame)
+{
+    try
+    {
+        frame.moduleName = getModuleName(frame.moduleBase);
+    }
+    catch (const DbgException&)
+    {
+    }
+
+    try
+    {
+        frame.symbol = findSymbol(frame.returnAddress, frame.displacement);
+        return;
+    }
+    catch (const DbgException&)
+    {
+        // the module has no symbols
+    }
+
+    frame.symbol.clear();
+    frame.displacement = static_cast<MEMDISPLACEMENT>(frame.returnAddress - frame.moduleBase);
+}
+
+} // end nameless namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::vector<ScannedFrame> scanStackForReturnAddresses(THREAD_DEBUG_ID threadId, unsigned long depth)
+{
+    ContextAutoRestore  contextRestore;
+
+    if (threadId != CURRENT_THREAD_ID)
+        setCurrentThreadById(threadId);
+
+    CPUType  cpuType = getCPUMode();
+    if (cpuType != CPU_I386 && cpuType != CPU_AMD64 && cpuType != CPU_ARM64)
+        throw DbgException("stack scanning supports only x86, AMD64 and ARM64");
+
+    bool  pointer32 = cpuType == CPU_I386;
+
+    MEMOFFSET_64  stackLimit = 0;
+    MEMOFFSET_64  stackBase = 0;
+    getStackRegion(stackLimit, stackBase);
+
+    if (stackBase <= stackLimit)
+        throw DbgException("the thread has no valid stack region");
+
+    // a smashed stack pointer can be anywhere
+    MEMOFFSET_64  stackOffset = getStackOffset();
+    if (stackOffset < stackLimit || stackOffset >= stackBase)
+        stackOffset = stackLimit;
+
+    stackOffset &= ~static_cast<MEMOFFSET_64>(pointer32 ? 3 : 7);
+
+    std::vector<char>  stack(static_cast<size_t>(stackBase - stackOffset));
+
+    unsigned long  readBytes = 0;
+    readMemoryUnsafe(stackOffset, &stack[0], stack.size(), false, &readBytes);
+    stack.resize(readBytes);
+
+    CodeRangeTable  codeRanges = getCodeRanges(pointer32);
+
+    DbgUnwindTarget  target;
+    std::vector<ScannedFrame>  frames;
+
+    scanStackMemory(target, cpuType, pointer32 ? stackOffset & 0xFFFFFFFF : stackOffset, stack, codeRanges, depth, frames);
+
+    for (size_t i = 0; i < frames.size(); ++i)
+    {
+        if (pointer32)
+        {
+            frames[i].slot = addr64(frames[i].slot);
+            frames[i].returnAddress = addr64(frames[i].returnAddress);
+            frames[i].callSite = addr64(frames[i].callSite);
+            frames[i].callTarget = frames[i].callTarget ? addr64(frames[i].callTarget) : 0;
+        }
+
+        findScannedSymbol(frames[i]);
+    }
+
+    return frames;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ULONG getScopeFrameNumber()
+{
+    DEBUG_STACK_FRAME  stackFrame = {};
+
+    g_dbgMgr->setQuietNotiification(true);
+
+    HRESULT  hres = g_dbgMgr->symbols->GetScope(NULL, &stackFrame, NULL, 0);
+
     g_dbgMgr->setQuietNotiification(false);
 
+    if (FAILED(hres))
+        throw DbgEngException(L"IDebugSymbols::GetScope", hres);
+
+    return stackFrame.FrameNumber;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <class ContextType>
+StackFramePtr getStackFrameImpl()
+{
+    ULONG  frameNumber = getScopeFrameNumber();
+
+    typedef typename ContextType::RawContextType  RawContextType;
+
+    const RawContextType  startContext = ContextType().getRawContext();
+
+    // the stack is walked down to the scope frame only
+    RawContextType  *contexts = getContextBuffer<RawContextType>(frameNumber + 1);
+
+    ULONG  filledFrames = getStackTrace(startContext, frameNumber + 1, contexts);
+    if (frameNumber >= filledFrames)
+        throw IndexException(frameNumber);
+
+    StackContextSourcePtr  frameContext(new StartStackContext<ContextType>(contexts[frameNumber]));
+
+    return StackFramePtr(new StackFrameImpl(frameNumber, makeFrameData(getStackTraceBuffers().frames[frameNumber], frameNumber), frameContext));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+StackFramePtr getStackFrameWow64()
+{
+    if (getLastEventThreadId() == getCurrentThreadId())
+        return getStackFrameImpl<CPUContextWOW64>();
+
+    ULONG  frameNumber = getScopeFrameNumber();
+
+    WOW64_CONTEXT  wow64Context;
+    ReadWow64Context(wow64Context);
+
+    ULONG  filledFrames = getStackTrace(wow64Context, frameNumber + 1, static_cast<WOW64_CONTEXT*>(0));
+    if (frameNumber >= filledFrames)
+        throw IndexException(frameNumber);
+
     return StackFramePtr(new StackFrameImpl(
         frameNumber,
-        frames[frameNumber].InstructionOffset,
-        frames[frameNumber].ReturnOffset,
-        frames[frameNumber].FrameOffset,
-        frames[frameNumber].StackOffset,
-        CPUContextPtr(new CPUContextWOW64(wow64Context))));
+        makeFrameData(getStackTraceBuffers().frames[frameNumber], frameNumber),
+        StackContextSourcePtr(new StartStackContext<CPUContextWOW64>(wow64Context))));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
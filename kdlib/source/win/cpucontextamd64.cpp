@@ -1,5 +1,7 @@
 #include "stdafx.h"
 
+#include <cstddef>
+
 #include <cvconst.h>
 
 #include "kdlib/dbgengine.h"
@@ -12,496 +14,146 @@
 
 namespace kdlib {
 
-///////////////////////////////////////////////////////////////////////////////
+namespace {
 
-NumVariant CPUContextWOW64::getRegisterByIndex(unsigned long index)
-{
-    switch (index)
-    {
-    case CV_REG_AL:
-        return NumVariant(static_cast<unsigned char>(m_context.Eax & 0xFF));
-    case CV_REG_CL:
-        return NumVariant(static_cast<unsigned char>(m_context.Ecx & 0xFF));
-    case CV_REG_DL:
-        return NumVariant(static_cast<unsigned char>(m_context.Edx & 0xFF));
-    case CV_REG_BL:
-        return NumVariant(static_cast<unsigned char>(m_context.Ebx & 0xFF));
-    case CV_REG_AH:
-        return NumVariant(static_cast<unsigned char>((m_context.Eax & 0xFF00) >> 8));
-    case CV_REG_CH:
-        return NumVariant(static_cast<unsigned char>((m_context.Ecx & 0xFF00) >> 8));
-    case CV_REG_DH:
-        return NumVariant(static_cast<unsigned char>((m_context.Edx & 0xFF00) >> 8));
-    case CV_REG_BH:
-        return NumVariant(static_cast<unsigned char>((m_context.Ebx & 0xFF00) >> 8));
-    case CV_REG_AX:
-        return NumVariant(static_cast<unsigned short>(m_context.Eax & 0xFFFF));
-    case CV_REG_CX:
-        return NumVariant(static_cast<unsigned short>(m_context.Ecx & 0xFFFF));
-    case CV_REG_DX:
-        return NumVariant(static_cast<unsigned short>(m_context.Edx & 0xFFFF));
-    case CV_REG_BX:
-        return NumVariant(static_cast<unsigned short>(m_context.Ebx & 0xFFFF));
-    case CV_REG_SP:
-        return NumVariant(static_cast<unsigned short>(m_context.Esp & 0xFFFF));
-    case CV_REG_BP:
-        return NumVariant(static_cast<unsigned short>(m_context.Ebp & 0xFFFF));
-    case CV_REG_SI:
-        return NumVariant(static_cast<unsigned short>(m_context.Esi & 0xFFFF));
-    case CV_REG_DI:
-        return NumVariant(static_cast<unsigned short>(m_context.Edi & 0xFFFF));
-    case CV_REG_EAX:
-        return NumVariant(m_context.Eax);
-    case CV_REG_ECX:
-        return NumVariant(m_context.Ecx);
-    case CV_REG_EDX:
-        return NumVariant(m_context.Edx);
-    case CV_REG_EBX:
-        return NumVariant(m_context.Ebx);
-    case CV_REG_ESP:
-        return NumVariant(m_context.Esp);
-    case CV_REG_EBP:
-        return NumVariant(m_context.Ebp);
-    case CV_REG_ESI:
-        return NumVariant(m_context.Esi);
-    case CV_REG_EDI:
-        return NumVariant(m_context.Edi);
-    case CV_REG_ES:
-        return NumVariant(m_context.SegEs);
-    case CV_REG_CS:
-        return NumVariant(m_context.SegCs);
-    case CV_REG_SS:
-        return NumVariant(m_context.SegSs);
-    case CV_REG_DS:
-        return NumVariant(m_context.SegDs);
-    case CV_REG_FS:
-        return NumVariant(m_context.SegFs);
-    case CV_REG_GS:
-        return NumVariant(m_context.SegGs);
-    case CV_REG_IP:
-        return NumVariant(static_cast<unsigned short>(m_context.Eip & 0xFFFF));
-    case CV_REG_FLAGS:
-        return NumVariant(static_cast<unsigned short>(m_context.EFlags & 0xFFFF));
-    case CV_REG_EIP:
-        return NumVariant(m_context.Eip);
-    case CV_REG_EFLAGS:
-        return NumVariant(m_context.EFlags);
-    }
+///////////////////////////////////////////////////////////////////////////////
 
-    std::stringstream sstr;
-    sstr << "WOW64 context: unsupported register index " << std::dec << index;
-    throw DbgException(sstr.str());
-}
+const CPURegisterDesc  wow64Registers[] = {
+    { L"al",        CV_REG_AL,     offsetof(WOW64_CONTEXT, Eax),     RegInt8 },
+    { L"cl",        CV_REG_CL,     offsetof(WOW64_CONTEXT, Ecx),     RegInt8 },
+    { L"dl",        CV_REG_DL,     offsetof(WOW64_CONTEXT, Edx),     RegInt8 },
+    { L"bl",        CV_REG_BL,     offsetof(WOW64_CONTEXT, Ebx),     RegInt8 },
+    { L"ah",        CV_REG_AH,     offsetof(WOW64_CONTEXT, Eax) + 1, RegInt8 },
+    { L"ch",        CV_REG_CH,     offsetof(WOW64_CONTEXT, Ecx) + 1, RegInt8 },
+    { L"dh",        CV_REG_DH,     offsetof(WOW64_CONTEXT, Edx) + 1, RegInt8 },
+    { L"bh",        CV_REG_BH,     offsetof(WOW64_CONTEXT, Ebx) + 1, RegInt8 },
+    { L"ax",        CV_REG_AX,     offsetof(WOW64_CONTEXT, Eax),     RegInt16 },
+    { L"cx",        CV_REG_CX,     offsetof(WOW64_CONTEXT, Ecx),     RegInt16 },
+    { L"dx",        CV_REG_DX,     offsetof(WOW64_CONTEXT, Edx),     RegInt16 },
+    { L"bx",        CV_REG_BX,     offsetof(WOW64_CONTEXT, Ebx),     RegInt16 },
+    { L"sp",        CV_REG_SP,     offsetof(WOW64_CONTEXT, Esp),     RegInt16 },
+    { L"bp",        CV_REG_BP,     offsetof(WOW64_CONTEXT, Ebp),     RegInt16 },
+    { L"si",        CV_REG_SI,     offsetof(WOW64_CONTEXT, Esi),     RegInt16 },
+    { L"di",        CV_REG_DI,     offsetof(WOW64_CONTEXT, Edi),     RegInt16 },
+    { L"eax",       CV_REG_EAX,    offsetof(WOW64_CONTEXT, Eax),     RegInt32 },
+    { L"ecx",       CV_REG_ECX,    offsetof(WOW64_CONTEXT, Ecx),     RegInt32 },
+    { L"edx",       CV_REG_EDX,    offsetof(WOW64_CONTEXT, Edx),     RegInt32 },
+    { L"ebx",       CV_REG_EBX,    offsetof(WOW64_CONTEXT, Ebx),     RegInt32 },
+    { L"esp",       CV_REG_ESP,    offsetof(WOW64_CONTEXT, Esp),     RegInt32 },
+    { L"ebp",       CV_REG_EBP,    offsetof(WOW64_CONTEXT, Ebp),     RegInt32 },
+    { L"esi",       CV_REG_ESI,    offsetof(WOW64_CONTEXT, Esi),     RegInt32 },
+    { L"edi",       CV_REG_EDI,    offsetof(WOW64_CONTEXT, Edi),     RegInt32 },
+    { L"es",        CV_REG_ES,     offsetof(WOW64_CONTEXT, SegEs),   RegInt32 },
+    { L"cs",        CV_REG_CS,     offsetof(WOW64_CONTEXT, SegCs),   RegInt32 },
+    { L"ss",        CV_REG_SS,     offsetof(WOW64_CONTEXT, SegSs),   RegInt32 },
+    { L"ds",        CV_REG_DS,     offsetof(WOW64_CONTEXT, SegDs),   RegInt32 },
+    { L"fs",        CV_REG_FS,     offsetof(WOW64_CONTEXT, SegFs),   RegInt32 },
+    { L"gs",        CV_REG_GS,     offsetof(WOW64_CONTEXT, SegGs),   RegInt32 },
+    { L"ip",        CV_REG_IP,     offsetof(WOW64_CONTEXT, Eip),     RegInt16 },
+    { L"flags",     CV_REG_FLAGS,  offsetof(WOW64_CONTEXT, EFlags),  RegInt16 },
+    { L"eip",       CV_REG_EIP,    offsetof(WOW64_CONTEXT, Eip),     RegInt32 },
+    { L"eflags",    CV_REG_EFLAGS, offsetof(WOW64_CONTEXT, EFlags),  RegInt32 }
+};
 
 ///////////////////////////////////////////////////////////////////////////////
 
-std::wstring  CPUContextWOW64::getRegisterName(unsigned long index)
-{
-    switch (index)
-    {
-    case CV_REG_AL:
-        return L"al";
-    case CV_REG_CL:
-        return L"cl";
-    case CV_REG_DL:
-        return L"dl";
-    case CV_REG_BL:
-        return L"bl";
-    case CV_REG_AH:
-        return L"ah";
-    case CV_REG_CH:
-        return L"ch";
-    case CV_REG_DH:
-        return L"dh";
-    case CV_REG_BH:
-        return L"bh";
-    case CV_REG_AX:
-        return L"ax";
-    case CV_REG_CX:
-        return L"cx";
-    case CV_REG_DX:
-        return L"dx";
-    case CV_REG_BX:
-        return L"bx";
-    case CV_REG_SP:
-        return L"sp";
-    case CV_REG_BP:
-        return L"bp";
-    case CV_REG_SI:
-        return L"si";
-    case CV_REG_DI:
-        return L"di";
-    case CV_REG_EAX:
-        return L"eax";
-    case CV_REG_ECX:
-        return L"ecx";
-    case CV_REG_EDX:
-        return L"edx";
-    case CV_REG_EBX:
-        return L"ebx";
-    case CV_REG_ESP:
-        return L"esp";
-    case CV_REG_EBP:
-        return L"ebp";
-    case CV_REG_ESI:
-        return L"esi";
-    case CV_REG_EDI:
-        return L"edi";
-    case CV_REG_ES:
-        return L"es";
-    case CV_REG_CS:
-        return L"cs";
-    case CV_REG_SS:
-        return L"ss";
-    case CV_REG_DS:
-        return L"ds";
-    case CV_REG_FS:
-        return L"fs";
-    case CV_REG_GS:
-        return L"gs";
-    case CV_REG_IP:
-        return L"ip";
-    case CV_REG_FLAGS:
-        return L"flags";
-    case CV_REG_EIP:
-        return L"eip";
-    case CV_REG_EFLAGS:
-        return L"eflags";
-    }
+const CPURegisterDesc  amd64Registers[] = {
+    { L"al",        CV_AMD64_AL,    offsetof(CONTEXT_X64, Rax),     RegInt8 },
+    { L"cl",        CV_AMD64_CL,    offsetof(CONTEXT_X64, Rcx),     RegInt8 },
+    { L"dl",        CV_AMD64_DL,    offsetof(CONTEXT_X64, Rdx),     RegInt8 },
+    { L"bl",        CV_AMD64_BL,    offsetof(CONTEXT_X64, Rbx),     RegInt8 },
+    { L"ah",        CV_AMD64_AH,    offsetof(CONTEXT_X64, Rax) + 1, RegInt8 },
+    { L"ch",        CV_AMD64_CH,    offsetof(CONTEXT_X64, Rcx) + 1, RegInt8 },
+    { L"dh",        CV_AMD64_DH,    offsetof(CONTEXT_X64, Rdx) + 1, RegInt8 },
+    { L"bh",        CV_AMD64_BH,    offsetof(CONTEXT_X64, Rbx) + 1, RegInt8 },
+    { L"ax",        CV_AMD64_AX,    offsetof(CONTEXT_X64, Rax),     RegInt16 },
+    { L"cx",        CV_AMD64_CX,    offsetof(CONTEXT_X64, Rcx),     RegInt16 },
+    { L"dx",        CV_AMD64_DX,    offsetof(CONTEXT_X64, Rdx),     RegInt16 },
+    { L"bx",        CV_AMD64_BX,    offsetof(CONTEXT_X64, Rbx),     RegInt16 },
+    { L"sp",        CV_AMD64_SP,    offsetof(CONTEXT_X64, Rsp),     RegInt16 },
+    { L"bp",        CV_AMD64_BP,    offsetof(CONTEXT_X64, Rbp),     RegInt16 },
+    { L"si",        CV_AMD64_SI,    offsetof(CONTEXT_X64, Rsi),     RegInt16 },
+    { L"di",        CV_AMD64_DI,    offsetof(CONTEXT_X64, Rdi),     RegInt16 },
+    { L"eax",       CV_AMD64_EAX,   offsetof(CONTEXT_X64, Rax),     RegInt32 },
+    { L"ecx",       CV_AMD64_ECX,   offsetof(CONTEXT_X64, Rcx),     RegInt32 },
+    { L"edx",       CV_AMD64_EDX,   offsetof(CONTEXT_X64, Rdx),     RegInt32 },
+    { L"ebx",       CV_AMD64_EBX,   offsetof(CONTEXT_X64, Rbx),     RegInt32 },
+    { L"esp",       CV_AMD64_ESP,   offsetof(CONTEXT_X64, Rsp),     RegInt32 },
+    { L"ebp",       CV_AMD64_EBP,   offsetof(CONTEXT_X64, Rbp),     RegInt32 },
+    { L"esi",       CV_AMD64_ESI,   offsetof(CONTEXT_X64, Rsi),     RegInt32 },
+    { L"edi",       CV_AMD64_EDI,   offsetof(CONTEXT_X64, Rdi),     RegInt32 },
+    { L"es",        CV_AMD64_ES,    offsetof(CONTEXT_X64, SegEs),   RegInt16 },
+    { L"cs",        CV_AMD64_CS,    offsetof(CONTEXT_X64, SegCs),   RegInt16 },
+    { L"ss",        CV_AMD64_SS,    offsetof(CONTEXT_X64, SegSs),   RegInt16 },
+    { L"ds",        CV_AMD64_DS,    offsetof(CONTEXT_X64, SegDs),   RegInt16 },
+    { L"fs",        CV_AMD64_FS,    offsetof(CONTEXT_X64, SegFs),   RegInt16 },
+    { L"gs",        CV_AMD64_GS,    offsetof(CONTEXT_X64, SegGs),   RegInt16 },
+    { L"eflags",    CV_AMD64_FLAGS, offsetof(CONTEXT_X64, EFlags),  RegInt32 },
+    { L"rip",       CV_AMD64_RIP,   offsetof(CONTEXT_X64, Rip),     RegInt64 },
+    { L"sil",       CV_AMD64_SIL,   offsetof(CONTEXT_X64, Rsi),     RegInt8 },
+    { L"dil",       CV_AMD64_DIL,   offsetof(CONTEXT_X64, Rdi),     RegInt8 },
+    { L"bpl",       CV_AMD64_BPL,   offsetof(CONTEXT_X64, Rbp),     RegInt8 },
+    { L"spl",       CV_AMD64_SPL,   offsetof(CONTEXT_X64, Rsp),     RegInt8 },
+    { L"rax",       CV_AMD64_RAX,   offsetof(CONTEXT_X64, Rax),     RegInt64 },
+    { L"rbx",       CV_AMD64_RBX,   offsetof(CONTEXT_X64, Rbx),     RegInt64 },
+    { L"rcx",       CV_AMD64_RCX,   offsetof(CONTEXT_X64, Rcx),     RegInt64 },
+    { L"rdx",       CV_AMD64_RDX,   offsetof(CONTEXT_X64, Rdx),     RegInt64 },
+    { L"rsi",       CV_AMD64_RSI,   offsetof(CONTEXT_X64, Rsi),     RegInt64 },
+    { L"rdi",       CV_AMD64_RDI,   offsetof(CONTEXT_X64, Rdi),     RegInt64 },
+    { L"rbp",       CV_AMD64_RBP,   offsetof(CONTEXT_X64, Rbp),     RegInt64 },
+    { L"rsp",       CV_AMD64_RSP,   offsetof(CONTEXT_X64, Rsp),     RegInt64 },
+    { L"r8",        CV_AMD64_R8,    offsetof(CONTEXT_X64, R8),      RegInt64 },
+    { L"r9",        CV_AMD64_R9,    offsetof(CONTEXT_X64, R9),      RegInt64 },
+    { L"r10",       CV_AMD64_R10,   offsetof(CONTEXT_X64, R10),     RegInt64 },
+    { L"r11",       CV_AMD64_R11,   offsetof(CONTEXT_X64, R11),     RegInt64 },
+    { L"r12",       CV_AMD64_R12,   offsetof(CONTEXT_X64, R12),     RegInt64 },
+    { L"r13",       CV_AMD64_R13,   offsetof(CONTEXT_X64, R13),     RegInt64 },
+    { L"r14",       CV_AMD64_R14,   offsetof(CONTEXT_X64, R14),     RegInt64 },
+    { L"r15",       CV_AMD64_R15,   offsetof(CONTEXT_X64, R15),     RegInt64 },
+    { L"r8b",       CV_AMD64_R8B,   offsetof(CONTEXT_X64, R8),      RegInt8 },
+    { L"r9b",       CV_AMD64_R9B,   offsetof(CONTEXT_X64, R9),      RegInt8 },
+    { L"r10b",      CV_AMD64_R10B,  offsetof(CONTEXT_X64, R10),     RegInt8 },
+    { L"r11b",      CV_AMD64_R11B,  offsetof(CONTEXT_X64, R11),     RegInt8 },
+    { L"r12b",      CV_AMD64_R12B,  offsetof(CONTEXT_X64, R12),     RegInt8 },
+    { L"r13b",      CV_AMD64_R13B,  offsetof(CONTEXT_X64, R13),     RegInt8 },
+    { L"r14b",      CV_AMD64_R14B,  offsetof(CONTEXT_X64, R14),     RegInt8 },
+    { L"r15b",      CV_AMD64_R15B,  offsetof(CONTEXT_X64, R15),     RegInt8 },
+    { L"r8w",       CV_AMD64_R8W,   offsetof(CONTEXT_X64, R8),      RegInt16 },
+    { L"r9w",       CV_AMD64_R9W,   offsetof(CONTEXT_X64, R9),      RegInt16 },
+    { L"r10w",      CV_AMD64_R10W,  offsetof(CONTEXT_X64, R10),     RegInt16 },
+    { L"r11w",      CV_AMD64_R11W,  offsetof(CONTEXT_X64, R11),     RegInt16 },
+    { L"r12w",      CV_AMD64_R12W,  offsetof(CONTEXT_X64, R12),     RegInt16 },
+    { L"r13w",      CV_AMD64_R13W,  offsetof(CONTEXT_X64, R13),     RegInt16 },
+    { L"r14w",      CV_AMD64_R14W,  offsetof(CONTEXT_X64, R14),     RegInt16 },
+    { L"r15w",      CV_AMD64_R15W,  offsetof(CONTEXT_X64, R15),     RegInt16 },
+    { L"r8d",       CV_AMD64_R8D,   offsetof(CONTEXT_X64, R8),      RegInt32 },
+    { L"r9d",       CV_AMD64_R9D,   offsetof(CONTEXT_X64, R9),      RegInt32 },
+    { L"r10d",      CV_AMD64_R10D,  offsetof(CONTEXT_X64, R10),     RegInt32 },
+    { L"r11d",      CV_AMD64_R11D,  offsetof(CONTEXT_X64, R11),     RegInt32 },
+    { L"r12d",      CV_AMD64_R12D,  offsetof(CONTEXT_X64, R12),     RegInt32 },
+    { L"r13d",      CV_AMD64_R13D,  offsetof(CONTEXT_X64, R13),     RegInt32 },
+    { L"r14d",      CV_AMD64_R14D,  offsetof(CONTEXT_X64, R14),     RegInt32 },
+    { L"r15d",      CV_AMD64_R15D,  offsetof(CONTEXT_X64, R15),     RegInt32 }
+};
 
-    std::stringstream sstr;
-    sstr << "I386 context: unsupported register index " << std::dec << index;
-    throw DbgException(sstr.str());
-}
+///////////////////////////////////////////////////////////////////////////////
+
+} // end nameless namespace
 
 ///////////////////////////////////////////////////////////////////////////////
 
-NumVariant CPUContextAmd64::getRegisterByIndex(unsigned long index)
+const CPURegisterTable& CPUContextWOW64::getRegisterTable() const
 {
-    switch (index)
-    {
-    case CV_AMD64_AL:
-        return NumVariant(static_cast<unsigned char>(m_context.Rax & 0xFF));
-    case CV_AMD64_CL:
-        return NumVariant(static_cast<unsigned char>(m_context.Rcx & 0xFF));
-    case CV_AMD64_DL:
-        return NumVariant(static_cast<unsigned char>(m_context.Rdx & 0xFF));
-    case CV_AMD64_BL:
-        return NumVariant(static_cast<unsigned char>(m_context.Rbx & 0xFF));
-    case CV_AMD64_AH:
-        return NumVariant(static_cast<unsigned char>((m_context.Rax & 0xFF00) >> 8));
-    case CV_AMD64_CH:
-        return NumVariant(static_cast<unsigned char>((m_context.Rcx & 0xFF00) >> 8));
-    case CV_AMD64_DH:
-        return NumVariant(static_cast<unsigned char>((m_context.Rdx & 0xFF00) >> 8));
-    case CV_AMD64_BH:
-        return NumVariant(static_cast<unsigned char>((m_context.Rbx & 0xFF00) >> 8));
-    case CV_AMD64_AX:
-        return NumVariant(static_cast<unsigned short>(m_context.Rax & 0xFFFF));
-    case CV_AMD64_CX:
-        return NumVariant(static_cast<unsigned short>(m_context.Rcx & 0xFFFF));
-    case CV_AMD64_DX:
-        return NumVariant(static_cast<unsigned short>(m_context.Rdx & 0xFFFF));
-    case CV_AMD64_BX:
-        return NumVariant(static_cast<unsigned short>(m_context.Rbx & 0xFFFF));
-    case CV_AMD64_SP:
-        return NumVariant(static_cast<unsigned short>(m_context.Rsp & 0xFFFF));
-    case CV_AMD64_BP:
-        return NumVariant(static_cast<unsigned short>(m_context.Rbp & 0xFFFF));
-    case CV_AMD64_SI:
-        return NumVariant(static_cast<unsigned short>(m_context.Rsi & 0xFFFF));
-    case CV_AMD64_DI:
-        return NumVariant(static_cast<unsigned short>(m_context.Rdi & 0xFFFF));
-    case CV_AMD64_EAX:
-        return NumVariant(static_cast<unsigned long>(m_context.Rax & 0xFFFFFFFF));
-    case CV_AMD64_ECX:
-        return NumVariant(static_cast<unsigned long>(m_context.Rcx & 0xFFFFFFFF));
-    case CV_AMD64_EDX:
-        return NumVariant(static_cast<unsigned long>(m_context.Rdx & 0xFFFFFFFF));
-    case CV_AMD64_EBX:
-        return NumVariant(static_cast<unsigned long>(m_context.Rbx & 0xFFFFFFFF));
-    case CV_AMD64_ESP:
-        return NumVariant(static_cast<unsigned long>(m_context.Rsp & 0xFFFFFFFF));
-    case CV_AMD64_EBP:
-        return NumVariant(static_cast<unsigned long>(m_context.Rbp & 0xFFFFFFFF));
-    case CV_AMD64_ESI:
-        return NumVariant(static_cast<unsigned long>(m_context.Rsi & 0xFFFFFFFF));
-    case CV_AMD64_EDI:
-        return NumVariant(static_cast<unsigned long>(m_context.Rdi & 0xFFFFFFFF));
-    case CV_AMD64_ES:
-        return NumVariant(m_context.SegEs);
-    case CV_AMD64_CS:
-        return NumVariant(m_context.SegCs);
-    case CV_AMD64_SS:
-        return NumVariant(m_context.SegSs);
-    case CV_AMD64_DS:
-        return NumVariant(m_context.SegDs);
-    case CV_AMD64_FS:
-        return NumVariant(m_context.SegFs);
-    case CV_AMD64_GS:
-        return NumVariant(m_context.SegGs);
-    case CV_AMD64_FLAGS:
-        return NumVariant(m_context.EFlags);
-    case CV_AMD64_RIP:
-        return NumVariant(m_context.Rip);
-    case CV_AMD64_SIL:
-        return NumVariant(static_cast<unsigned char>(m_context.Rsi & 0xFF));
-    case CV_AMD64_DIL:
-        return NumVariant(static_cast<unsigned char>(m_context.Rdi & 0xFF));
-    case CV_AMD64_BPL:
-        return NumVariant(static_cast<unsigned char>(m_context.Rbp & 0xFF));
-    case CV_AMD64_SPL:
-       return NumVariant(static_cast<unsigned char>(m_context.Rsp & 0xFF));
-    case CV_AMD64_RAX:
-        return NumVariant(m_context.Rax);
-    case CV_AMD64_RBX:
-        return NumVariant(m_context.Rbx);
-    case  CV_AMD64_RDX:
-        return NumVariant(m_context.Rdx);
-    case CV_AMD64_RCX:
-        return NumVariant(m_context.Rcx);
-    case CV_AMD64_RSI:
-        return NumVariant(m_context.Rsi);
-    case CV_AMD64_RDI:
-        return NumVariant(m_context.Rdi);
-    case CV_AMD64_RBP:
-        return NumVariant(m_context.Rbp);
-    case CV_AMD64_RSP:
-        return NumVariant(m_context.Rsp);
-    case CV_AMD64_R8:
-        return NumVariant(m_context.R8);
-    case CV_AMD64_R9:
-        return NumVariant(m_context.R9);
-    case CV_AMD64_R10:
-        return NumVariant(m_context.R10);
-    case CV_AMD64_R11:
-        return NumVariant(m_context.R11);
-    case CV_AMD64_R12:
-        return NumVariant(m_context.R12);
-    case CV_AMD64_R13:
-        return NumVariant(m_context.R13);
-    case CV_AMD64_R14:
-        return NumVariant(m_context.R14);
-    case CV_AMD64_R15:
-        return NumVariant(m_context.R15);
-    case CV_AMD64_R8B:
-        return NumVariant(static_cast<unsigned char>(m_context.R8 & 0xFF));
-    case CV_AMD64_R9B:
-        return NumVariant(static_cast<unsigned char>(m_context.R9 & 0xFF));
-    case CV_AMD64_R10B:
-        return NumVariant(static_cast<unsigned char>(m_context.R10 & 0xFF));
-    case CV_AMD64_R11B:
-        return NumVariant(static_cast<unsigned char>(m_context.R11 & 0xFF));
-    case CV_AMD64_R12B:
-        return NumVariant(static_cast<unsigned char>(m_context.R12 & 0xFF));
-    case CV_AMD64_R13B:
-        return NumVariant(static_cast<unsigned char>(m_context.R13 & 0xFF));
-    case CV_AMD64_R14B:
-        return NumVariant(static_cast<unsigned char>(m_context.R14 & 0xFF));
-    case CV_AMD64_R15B:
-        return NumVariant(static_cast<unsigned char>(m_context.R15 & 0xFF));
-    case CV_AMD64_R8W:
-        return NumVariant(static_cast<unsigned short>(m_context.R8 & 0xFFFF));
-    case CV_AMD64_R9W:
-        return NumVariant(static_cast<unsigned short>(m_context.R9 & 0xFFFF));
-    case CV_AMD64_R10W:
-        return NumVariant(static_cast<unsigned short>(m_context.R10 & 0xFFFF));
-    case CV_AMD64_R11W:
-        return NumVariant(static_cast<unsigned short>(m_context.R11 & 0xFFFF));
-    case CV_AMD64_R12W:
-        return NumVariant(static_cast<unsigned short>(m_context.R12 & 0xFFFF));
-    case CV_AMD64_R13W:
-        return NumVariant(static_cast<unsigned short>(m_context.R13 & 0xFFFF));
-    case CV_AMD64_R14W:
-        return NumVariant(static_cast<unsigned short>(m_context.R14 & 0xFFFF));
-    case CV_AMD64_R15W:
-        return NumVariant(static_cast<unsigned short>(m_context.R15 & 0xFFFF));
-    case CV_AMD64_R8D:
-        return NumVariant(static_cast<unsigned long>(m_context.R8 & 0xFFFFFFFF));
-    case CV_AMD64_R9D:
-        return NumVariant(static_cast<unsigned long>(m_context.R9 & 0xFFFFFFFF));
-    case CV_AMD64_R10D:
-        return NumVariant(static_cast<unsigned long>(m_context.R10 & 0xFFFFFFFF));
-    case CV_AMD64_R11D:
-        return NumVariant(static_cast<unsigned long>(m_context.R11 & 0xFFFFFFFF));
-    case CV_AMD64_R12D:
-        return NumVariant(static_cast<unsigned long>(m_context.R12 & 0xFFFFFFFF));
-    case CV_AMD64_R13D:
-        return NumVariant(static_cast<unsigned long>(m_context.R13 & 0xFFFFFFFF));
-    case CV_AMD64_R14D:
-        return NumVariant(static_cast<unsigned long>(m_context.R14 & 0xFFFFFFFF));
-    case CV_AMD64_R15D:
-        return NumVariant(static_cast<unsigned long>(m_context.R15 & 0xFFFFFFFF));
-    }
-
-    std::stringstream sstr;
-    sstr << "AMD64 context: unsupported register index " << std::dec << index;
-    throw DbgException(sstr.str());
+    static const CPURegisterTable  registerTable("WOW64", wow64Registers);
+    return registerTable;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-std::wstring CPUContextAmd64::getRegisterName(unsigned long index)
+const CPURegisterTable& CPUContextAmd64::getRegisterTable() const
 {
-    switch (index)
-    {
-    case CV_AMD64_AL:
-        return L"al";
-    case CV_AMD64_CL:
-        return L"cl";
-    case CV_AMD64_DL:
-        return L"dl";
-    case CV_AMD64_BL:
-        return L"bl";
-    case CV_AMD64_AH:
-        return L"ah";
-    case CV_AMD64_CH:
-        return L"ch";
-    case CV_AMD64_DH:
-        return L"dh";
-    case CV_AMD64_BH:
-        return L"bh";
-    case CV_AMD64_AX:
-        return L"ax";
-    case CV_AMD64_CX:
-        return L"cx";
-    case CV_AMD64_DX:
-        return L"dx";
-    case CV_AMD64_BX:
-        return L"bx";
-    case CV_AMD64_SP:
-        return L"sp";
-    case CV_AMD64_BP:
-        return L"bp";
-    case CV_AMD64_SI:
-        return L"si";
-    case CV_AMD64_DI:
-        return L"di";
-    case CV_AMD64_EAX:
-        return L"eax";
-    case CV_AMD64_ECX:
-        return L"ecx";
-    case CV_AMD64_EDX:
-        return L"edx";
-    case CV_AMD64_EBX:
-        return L"ebx";
-    case CV_AMD64_ESP:
-        return L"esp";
-    case CV_AMD64_EBP:
-        return L"ebp";
-    case CV_AMD64_ESI:
-        return L"esi";
-    case CV_AMD64_EDI:
-        return L"edi";
-    case CV_AMD64_ES:
-        return L"es";
-    case CV_AMD64_CS:
-        return L"cs";
-    case CV_AMD64_SS:
-        return L"ss";
-    case CV_AMD64_DS:
-        return L"ds";
-    case CV_AMD64_FS:
-        return L"fs";
-    case CV_AMD64_GS:
-        return L"gs";
-    case CV_AMD64_FLAGS:
-        return L"eflags";
-    case CV_AMD64_RIP:
-        return L"rip";
-    case CV_AMD64_SIL:
-        return L"sil";
-    case CV_AMD64_DIL:
-        return L"dil";
-    case CV_AMD64_BPL:
-        return L"bpl";
-    case CV_AMD64_SPL:
-        return L"spl";
-    case CV_AMD64_RAX:
-        return L"rax";
-    case CV_AMD64_RBX:
-        return L"rbx";
-    case  CV_AMD64_RDX:
-        return L"rdx";
-    case CV_AMD64_RCX:
-        return L"rcx";
-    case CV_AMD64_RSI:
-        return L"rsi";
-    case CV_AMD64_RDI:
-        return L"rdi";
-    case CV_AMD64_RBP:
-        return L"rbp";
-    case CV_AMD64_RSP:
-        return L"rsp";
-    case CV_AMD64_R8:
-        return L"r8";
-    case CV_AMD64_R9:
-        return L"r9";
-    case CV_AMD64_R10:
-        return L"r10";
-    case CV_AMD64_R11:
-        return L"r11";
-    case CV_AMD64_R12:
-        return L"r12";
-    case CV_AMD64_R13:
-        return L"r13";
-    case CV_AMD64_R14:
-        return L"r14";
-    case CV_AMD64_R15:
-        return L"r15";
-    case CV_AMD64_R8B:
-        return L"r8b";
-    case CV_AMD64_R9B:
-        return L"r9b";
-    case CV_AMD64_R10B:
-        return L"r10b";
-    case CV_AMD64_R11B:
-        return L"r11b";
-    case CV_AMD64_R12B:
-        return L"r12b";
-    case CV_AMD64_R13B:
-        return L"r13b";
-    case CV_AMD64_R14B:
-        return L"r14b";
-    case CV_AMD64_R15B:
-        return L"r15b";
-    case CV_AMD64_R8W:
-        return L"r8w";
-    case CV_AMD64_R9W:
-        return L"r9w";
-    case CV_AMD64_R10W:
-        return L"r10w";
-    case CV_AMD64_R11W:
-        return L"r11w";
-    case CV_AMD64_R12W:
-        return L"r12w";
-    case CV_AMD64_R13W:
-        return L"r13w";
-    case CV_AMD64_R14W:
-        return L"r14w";
-    case CV_AMD64_R15W:
-        return L"r15w";
-    case CV_AMD64_R8D:
-        return L"r8d";
-    case CV_AMD64_R9D:
-        return L"r9d";
-    case CV_AMD64_R10D:
-        return L"r10d";
-    case CV_AMD64_R11D:
-        return L"r11d";
-    case CV_AMD64_R12D:
-        return L"r12d";
-    case CV_AMD64_R13D:
-        return L"r13d";
-    case CV_AMD64_R14D:
-        return L"r14d";
-    case CV_AMD64_R15D:
-        return L"r15d";
-    }
-
-    std::stringstream sstr;
-    sstr << "AMD64 context: unsupported register index " << std::dec << index;
-    throw DbgException(sstr.str());
+    static const CPURegisterTable  registerTable("AMD64", amd64Registers);
+    return registerTable;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1,5 +1,7 @@
 #include "stdafx.h"
 
+#include <cstddef>
+
 #include <cvconst.h>
 
 #include "kdlib/dbgengine.h"
@@ -12,270 +14,89 @@
 
 namespace kdlib {
 
-///////////////////////////////////////////////////////////////////////////////
+namespace {
 
-NumVariant CPUContextArm::getRegisterByIndex(unsigned long index)
-{
-    switch (index)
-    {
-    case CV_ARM_R0:
-        return NumVariant(m_context.R0);
-    case CV_ARM_R1:
-        return NumVariant(m_context.R1);
-    case CV_ARM_R2:
-        return NumVariant(m_context.R2);
-    case CV_ARM_R3:
-        return NumVariant(m_context.R3);
-    case CV_ARM_R4:
-        return NumVariant(m_context.R4);
-    case CV_ARM_R5:
-        return NumVariant(m_context.R5);
-    case CV_ARM_R6:
-        return NumVariant(m_context.R6);
-    case CV_ARM_R7:
-        return NumVariant(m_context.R7);
-    case CV_ARM_R8:
-        return NumVariant(m_context.R8);
-    case CV_ARM_R9:
-        return NumVariant(m_context.R9);
-    case CV_ARM_R10:
-        return NumVariant(m_context.R10);
-    case CV_ARM_R11:
-        return NumVariant(m_context.R11);
-    case CV_ARM_R12:
-        return NumVariant(m_context.R12);
+///////////////////////////////////////////////////////////////////////////////
 
-    case CV_ARM_SP:
-        return NumVariant(m_context.Sp);
-    case CV_ARM_LR:
-        return NumVariant(m_context.Lr);
-    case CV_ARM_PC:
-        return NumVariant(m_context.Pc);
-    case CV_ARM_CPSR:
-        return NumVariant(m_context.Cpsr);
-    case CV_ARM_FPSCR:
-        return NumVariant(m_context.Fpscr);
+const CPURegisterDesc  armRegisters[] = {
+    { L"r0",       CV_ARM_R0,    offsetof(CONTEXT_ARM, R0),    RegInt32 },
+    { L"r1",       CV_ARM_R1,    offsetof(CONTEXT_ARM, R1),    RegInt32 },
+    { L"r2",       CV_ARM_R2,    offsetof(CONTEXT_ARM, R2),    RegInt32 },
+    { L"r3",       CV_ARM_R3,    offsetof(CONTEXT_ARM, R3),    RegInt32 },
+    { L"r4",       CV_ARM_R4,    offsetof(CONTEXT_ARM, R4),    RegInt32 },
+    { L"r5",       CV_ARM_R5,    offsetof(CONTEXT_ARM, R5),    RegInt32 },
+    { L"r6",       CV_ARM_R6,    offsetof(CONTEXT_ARM, R6),    RegInt32 },
+    { L"r7",       CV_ARM_R7,    offsetof(CONTEXT_ARM, R7),    RegInt32 },
+    { L"r8",       CV_ARM_R8,    offsetof(CONTEXT_ARM, R8),    RegInt32 },
+    { L"r9",       CV_ARM_R9,    offsetof(CONTEXT_ARM, R9),    RegInt32 },
+    { L"r10",      CV_ARM_R10,   offsetof(CONTEXT_ARM, R10),   RegInt32 },
+    { L"r11",      CV_ARM_R11,   offsetof(CONTEXT_ARM, R11),   RegInt32 },
+    { L"r12",      CV_ARM_R12,   offsetof(CONTEXT_ARM, R12),   RegInt32 },
+    { L"sp",       CV_ARM_SP,    offsetof(CONTEXT_ARM, Sp),    RegInt32 },
+    { L"lr",       CV_ARM_LR,    offsetof(CONTEXT_ARM, Lr),    RegInt32 },
+    { L"pc",       CV_ARM_PC,    offsetof(CONTEXT_ARM, Pc),    RegInt32 },
+    { L"psr",      CV_ARM_CPSR,  offsetof(CONTEXT_ARM, Cpsr),  RegInt32 },
+    { L"fpscr",    CV_ARM_FPSCR, offsetof(CONTEXT_ARM, Fpscr), RegInt32 },
+    { L"d0",       CV_ARM_ND0,   offsetof(CONTEXT_ARM, D[0]),  RegInt64 },
+    { L"d1",       CV_ARM_ND1,   offsetof(CONTEXT_ARM, D[1]),  RegInt64 },
+    { L"d2",       CV_ARM_ND2,   offsetof(CONTEXT_ARM, D[2]),  RegInt64 },
+    { L"d3",       CV_ARM_ND3,   offsetof(CONTEXT_ARM, D[3]),  RegInt64 },
+    { L"d4",       CV_ARM_ND4,   offsetof(CONTEXT_ARM, D[4]),  RegInt64 },
+    { L"d5",       CV_ARM_ND5,   offsetof(CONTEXT_ARM, D[5]),  RegInt64 },
+    { L"d6",       CV_ARM_ND6,   offsetof(CONTEXT_ARM, D[6]),  RegInt64 },
+    { L"d7",       CV_ARM_ND7,   offsetof(CONTEXT_ARM, D[7]),  RegInt64 },
+    { L"d8",       CV_ARM_ND8,   offsetof(CONTEXT_ARM, D[8]),  RegInt64 },
+    { L"d9",       CV_ARM_ND9,   offsetof(CONTEXT_ARM, D[9]),  RegInt64 },
+    { L"d10",      CV_ARM_ND10,  offsetof(CONTEXT_ARM, D[10]), RegInt64 },
+    { L"d11",      CV_ARM_ND11,  offsetof(CONTEXT_ARM, D[11]), RegInt64 },
+    { L"d12",      CV_ARM_ND12,  offsetof(CONTEXT_ARM, D[12]), RegInt64 },
+    { L"d13",      CV_ARM_ND13,  offsetof(CONTEXT_ARM, D[13]), RegInt64 },
+    { L"d14",      CV_ARM_ND14,  offsetof(CONTEXT_ARM, D[14]), RegInt64 },
+    { L"d15",      CV_ARM_ND15,  offsetof(CONTEXT_ARM, D[15]), RegInt64 },
+    { L"d16",      CV_ARM_ND16,  offsetof(CONTEXT_ARM, D[16]), RegInt64 },
+    { L"d17",      CV_ARM_ND17,  offsetof(CONTEXT_ARM, D[17]), RegInt64 },
+    { L"d18",      CV_ARM_ND18,  offsetof(CONTEXT_ARM, D[18]), RegInt64 },
+    { L"d19",      CV_ARM_ND19,  offsetof(CONTEXT_ARM, D[19]), RegInt64 },
+    { L"d20",      CV_ARM_ND20,  offsetof(CONTEXT_ARM, D[20]), RegInt64 },
+    { L"d21",      CV_ARM_ND21,  offsetof(CONTEXT_ARM, D[21]), RegInt64 },
+    { L"d22",      CV_ARM_ND22,  offsetof(CONTEXT_ARM, D[22]), RegInt64 },
+    { L"d23",      CV_ARM_ND23,  offsetof(CONTEXT_ARM, D[23]), RegInt64 },
+    { L"d24",      CV_ARM_ND24,  offsetof(CONTEXT_ARM, D[24]), RegInt64 },
+    { L"d25",      CV_ARM_ND25,  offsetof(CONTEXT_ARM, D[25]), RegInt64 },
+    { L"d26",      CV_ARM_ND26,  offsetof(CONTEXT_ARM, D[26]), RegInt64 },
+    { L"d27",      CV_ARM_ND27,  offsetof(CONTEXT_ARM, D[27]), RegInt64 },
+    { L"d28",      CV_ARM_ND28,  offsetof(CONTEXT_ARM, D[28]), RegInt64 },
+    { L"d29",      CV_ARM_ND29,  offsetof(CONTEXT_ARM, D[29]), RegInt64 },
+    { L"d30",      CV_ARM_ND30,  offsetof(CONTEXT_ARM, D[30]), RegInt64 },
+    { L"d31",      CV_ARM_ND31,  offsetof(CONTEXT_ARM, D[31]), RegInt64 },
+    { L"q0",       CV_ARM_NQ0,   offsetof(CONTEXT_ARM, Q[0]),  RegVector128 },
+    { L"q1",       CV_ARM_NQ1,   offsetof(CONTEXT_ARM, Q[1]),  RegVector128 },
+    { L"q2",       CV_ARM_NQ2,   offsetof(CONTEXT_ARM, Q[2]),  RegVector128 },
+    { L"q3",       CV_ARM_NQ3,   offsetof(CONTEXT_ARM, Q[3]),  RegVector128 },
+    { L"q4",       CV_ARM_NQ4,   offsetof(CONTEXT_ARM, Q[4]),  RegVector128 },
+    { L"q5",       CV_ARM_NQ5,   offsetof(CONTEXT_ARM, Q[5]),  RegVector128 },
+    { L"q6",       CV_ARM_NQ6,   offsetof(CONTEXT_ARM, Q[6]),  RegVector128 },
+    { L"q7",       CV_ARM_NQ7,   offsetof(CONTEXT_ARM, Q[7]),  RegVector128 },
+    { L"q8",       CV_ARM_NQ8,   offsetof(CONTEXT_ARM, Q[8]),  RegVector128 },
+    { L"q9",       CV_ARM_NQ9,   offsetof(CONTEXT_ARM, Q[9]),  RegVector128 },
+    { L"q10",      CV_ARM_NQ10,  offsetof(CONTEXT_ARM, Q[10]), RegVector128 },
+    { L"q11",      CV_ARM_NQ11,  offsetof(CONTEXT_ARM, Q[11]), RegVector128 },
+    { L"q12",      CV_ARM_NQ12,  offsetof(CONTEXT_ARM, Q[12]), RegVector128 },
+    { L"q13",      CV_ARM_NQ13,  offsetof(CONTEXT_ARM, Q[13]), RegVector128 },
+    { L"q14",      CV_ARM_NQ14,  offsetof(CONTEXT_ARM, Q[14]), RegVector128 },
+    { L"q15",      CV_ARM_NQ15,  offsetof(CONTEXT_ARM, Q[15]), RegVector128 }
+};
 
-    case CV_ARM_ND0:
-        return NumVariant(m_context.D[0]);
-    case CV_ARM_ND1:
-        return NumVariant(m_context.D[1]);
-    case CV_ARM_ND2:
-        return NumVariant(m_context.D[2]);
-    case CV_ARM_ND3:
-        return NumVariant(m_context.D[3]);
-    case CV_ARM_ND4:
-        return NumVariant(m_context.D[4]);
-    case CV_ARM_ND5:
-        return NumVariant(m_context.D[5]);
-    case CV_ARM_ND6:
-        return NumVariant(m_context.D[6]);
-    case CV_ARM_ND7:
-        return NumVariant(m_context.D[7]);
-    case CV_ARM_ND8:
-        return NumVariant(m_context.D[8]);
-    case CV_ARM_ND9:
-        return NumVariant(m_context.D[9]);
-    case CV_ARM_ND10:
-        return NumVariant(m_context.D[10]);
-    case CV_ARM_ND11:
-        return NumVariant(m_context.D[11]);
-    case CV_ARM_ND12:
-        return NumVariant(m_context.D[12]);
-    case CV_ARM_ND13:
-        return NumVariant(m_context.D[13]);
-    case CV_ARM_ND14:
-        return NumVariant(m_context.D[14]);
-    case CV_ARM_ND15:
-        return NumVariant(m_context.D[15]);
-    case CV_ARM_ND16:
-        return NumVariant(m_context.D[16]);
-    case CV_ARM_ND17:
-        return NumVariant(m_context.D[17]);
-    case CV_ARM_ND18:
-        return NumVariant(m_context.D[18]);
-    case CV_ARM_ND19:
-        return NumVariant(m_context.D[19]);
-    case CV_ARM_ND20:
-        return NumVariant(m_context.D[20]);
-    case CV_ARM_ND21:
-        return NumVariant(m_context.D[21]);
-    case CV_ARM_ND22:
-        return NumVariant(m_context.D[22]);
-    case CV_ARM_ND23:
-        return NumVariant(m_context.D[23]);
-    case CV_ARM_ND24:
-        return NumVariant(m_context.D[24]);
-    case CV_ARM_ND25:
-        return NumVariant(m_context.D[25]);
-    case CV_ARM_ND26:
-        return NumVariant(m_context.D[26]);
-    case CV_ARM_ND27:
-        return NumVariant(m_context.D[27]);
-    case CV_ARM_ND28:
-        return NumVariant(m_context.D[28]);
-    case CV_ARM_ND29:
-        return NumVariant(m_context.D[29]);
-    case CV_ARM_ND30:
-        return NumVariant(m_context.D[30]);
-    case CV_ARM_ND31:
-        return NumVariant(m_context.D[31]);
+///////////////////////////////////////////////////////////////////////////////
 
-    /* NumVariant can not provide 128-bit registers :( */
-    // CV_ARM_NQ0 ... CV_ARM_NQ15
-
-    }
-    std::stringstream sstr;
-    sstr << "ARM context: unsupported register index " << std::dec << index;
-    throw DbgException(sstr.str());
-}
+} // end nameless namespace
 
 ///////////////////////////////////////////////////////////////////////////////
 
-std::wstring CPUContextArm::getRegisterName(unsigned long index)
+const CPURegisterTable& CPUContextArm::getRegisterTable() const
 {
-    switch (index)
-    {
-    case CV_ARM_R0:
-        return L"r0";
-    case CV_ARM_R1:
-        return L"r1";
-    case CV_ARM_R2:
-        return L"r2";
-    case CV_ARM_R3:
-        return L"r3";
-    case CV_ARM_R4:
-        return L"r4";
-    case CV_ARM_R5:
-        return L"r5";
-    case CV_ARM_R6:
-        return L"r6";
-    case CV_ARM_R7:
-        return L"r7";
-    case CV_ARM_R8:
-        return L"r8";
-    case CV_ARM_R9:
-        return L"r9";
-    case CV_ARM_R10:
-        return L"r10";
-    case CV_ARM_R11:
-        return L"r11";
-    case CV_ARM_R12:
-        return L"r12";
-
-    case CV_ARM_SP:
-        return L"sp";
-    case CV_ARM_LR:
-        return L"lr";
-    case CV_ARM_PC:
-        return L"pc";
-    case CV_ARM_CPSR:
-        return L"psr";
-    case CV_ARM_FPSCR:
-        return L"fpscr";
-
-    case CV_ARM_ND0:
-        return L"d0";
-    case CV_ARM_ND1:
-        return L"d1";
-    case CV_ARM_ND2:
-        return L"d2";
-    case CV_ARM_ND3:
-        return L"d3";
-    case CV_ARM_ND4:
-        return L"d4";
-    case CV_ARM_ND5:
-        return L"d5";
-    case CV_ARM_ND6:
-        return L"d6";
-    case CV_ARM_ND7:
-        return L"d7";
-    case CV_ARM_ND8:
-        return L"d8";
-    case CV_ARM_ND9:
-        return L"d9";
-    case CV_ARM_ND10:
-        return L"d10";
-    case CV_ARM_ND11:
-        return L"d11";
-    case CV_ARM_ND12:
-        return L"d12";
-    case CV_ARM_ND13:
-        return L"d13";
-    case CV_ARM_ND14:
-        return L"d14";
-    case CV_ARM_ND15:
-        return L"d15";
-    case CV_ARM_ND16:
-        return L"d16";
-    case CV_ARM_ND17:
-        return L"d17";
-    case CV_ARM_ND18:
-        return L"d18";
-    case CV_ARM_ND19:
-        return L"d19";
-    case CV_ARM_ND20:
-        return L"d20";
-    case CV_ARM_ND21:
-        return L"d21";
-    case CV_ARM_ND22:
-        return L"d22";
-    case CV_ARM_ND23:
-        return L"d23";
-    case CV_ARM_ND24:
-        return L"d24";
-    case CV_ARM_ND25:
-        return L"d25";
-    case CV_ARM_ND26:
-        return L"d26";
-    case CV_ARM_ND27:
-        return L"d27";
-    case CV_ARM_ND28:
-        return L"d28";
-    case CV_ARM_ND29:
-        return L"d29";
-    case CV_ARM_ND30:
-        return L"d30";
-    case CV_ARM_ND31:
-        return L"d31";
-
-    case CV_ARM_NQ0:
-        return L"q0";
-    case CV_ARM_NQ1:
-        return L"q1";
-    case CV_ARM_NQ2:
-        return L"q2";
-    case CV_ARM_NQ3:
-        return L"q3";
-    case CV_ARM_NQ4:
-        return L"q4";
-    case CV_ARM_NQ5:
-        return L"q5";
-    case CV_ARM_NQ6:
-        return L"q6";
-    case CV_ARM_NQ7:
-        return L"q7";
-    case CV_ARM_NQ8:
-        return L"q8";
-    case CV_ARM_NQ9:
-        return L"q9";
-    case CV_ARM_NQ10:
-        return L"q10";
-    case CV_ARM_NQ11:
-        return L"q11";
-    case CV_ARM_NQ12:
-        return L"q12";
-    case CV_ARM_NQ13:
-        return L"q13";
-    case CV_ARM_NQ14:
-        return L"q14";
-    case CV_ARM_NQ15:
-        return L"q15";
-    }
-
-    std::stringstream sstr;
-    sstr << "ARM context: unsupported register index " << std::dec << index;
-    throw DbgException(sstr.str());
+    static const CPURegisterTable  registerTable("ARM", armRegisters);
+    return registerTable;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1,5 +1,7 @@
 #include "stdafx.h"
 
+#include <cstddef>
+
 #include <cvconst.h>
 
 #include "kdlib/dbgengine.h"
@@ -12,628 +14,185 @@
 
 namespace kdlib {
 
-///////////////////////////////////////////////////////////////////////////////
-
-NumVariant CPUContextArm64::getRegisterByIndex(unsigned long index)
-{
-    switch (index)
-    {
-    case CV_ARM64_W0:
-        return NumVariant(static_cast<unsigned long>(m_context.X0 & 0xFFFFFFFF));
-    case CV_ARM64_W1:
-        return NumVariant(static_cast<unsigned long>(m_context.X1 & 0xFFFFFFFF));
-    case CV_ARM64_W2:
-        return NumVariant(static_cast<unsigned long>(m_context.X2 & 0xFFFFFFFF));
-    case CV_ARM64_W3:
-        return NumVariant(static_cast<unsigned long>(m_context.X3 & 0xFFFFFFFF));
-    case CV_ARM64_W4:
-        return NumVariant(static_cast<unsigned long>(m_context.X4 & 0xFFFFFFFF));
-    case CV_ARM64_W5:
-        return NumVariant(static_cast<unsigned long>(m_context.X5 & 0xFFFFFFFF));
-    case CV_ARM64_W6:
-        return NumVariant(static_cast<unsigned long>(m_context.X6 & 0xFFFFFFFF));
-    case CV_ARM64_W7:
-        return NumVariant(static_cast<unsigned long>(m_context.X7 & 0xFFFFFFFF));
-    case CV_ARM64_W8:
-        return NumVariant(static_cast<unsigned long>(m_context.X8 & 0xFFFFFFFF));
-    case CV_ARM64_W9:
-        return NumVariant(static_cast<unsigned long>(m_context.X9 & 0xFFFFFFFF));
-    case CV_ARM64_W10:
-        return NumVariant(static_cast<unsigned long>(m_context.X10 & 0xFFFFFFFF));
-    case CV_ARM64_W11:
-        return NumVariant(static_cast<unsigned long>(m_context.X11 & 0xFFFFFFFF));
-    case CV_ARM64_W12:
-        return NumVariant(static_cast<unsigned long>(m_context.X12 & 0xFFFFFFFF));
-    case CV_ARM64_W13:
-        return NumVariant(static_cast<unsigned long>(m_context.X13 & 0xFFFFFFFF));
-    case CV_ARM64_W14:
-        return NumVariant(static_cast<unsigned long>(m_context.X14 & 0xFFFFFFFF));
-    case CV_ARM64_W15:
-        return NumVariant(static_cast<unsigned long>(m_context.X15 & 0xFFFFFFFF));
-    case CV_ARM64_W16:
-        return NumVariant(static_cast<unsigned long>(m_context.X16 & 0xFFFFFFFF));
-    case CV_ARM64_W17:
-        return NumVariant(static_cast<unsigned long>(m_context.X17 & 0xFFFFFFFF));
-    case CV_ARM64_W18:
-        return NumVariant(static_cast<unsigned long>(m_context.X18 & 0xFFFFFFFF));
-    case CV_ARM64_W19:
-        return NumVariant(static_cast<unsigned long>(m_context.X19 & 0xFFFFFFFF));
-    case CV_ARM64_W20:
-        return NumVariant(static_cast<unsigned long>(m_context.X20 & 0xFFFFFFFF));
-    case CV_ARM64_W21:
-        return NumVariant(static_cast<unsigned long>(m_context.X21 & 0xFFFFFFFF));
-    case CV_ARM64_W22:
-        return NumVariant(static_cast<unsigned long>(m_context.X22 & 0xFFFFFFFF));
-    case CV_ARM64_W23:
-        return NumVariant(static_cast<unsigned long>(m_context.X23 & 0xFFFFFFFF));
-    case CV_ARM64_W24:
-        return NumVariant(static_cast<unsigned long>(m_context.X24 & 0xFFFFFFFF));
-    case CV_ARM64_W25:
-        return NumVariant(static_cast<unsigned long>(m_context.X25 & 0xFFFFFFFF));
-    case CV_ARM64_W26:
-        return NumVariant(static_cast<unsigned long>(m_context.X26 & 0xFFFFFFFF));
-    case CV_ARM64_W27:
-        return NumVariant(static_cast<unsigned long>(m_context.X27 & 0xFFFFFFFF));
-    case CV_ARM64_W28:
-        return NumVariant(static_cast<unsigned long>(m_context.X28 & 0xFFFFFFFF));
-    case CV_ARM64_W29:
-        return NumVariant(static_cast<unsigned long>(m_context.Fp & 0xFFFFFFFF));
-    case CV_ARM64_W30:
-        return NumVariant(static_cast<unsigned long>(m_context.Lr & 0xFFFFFFFF));
-
-    case CV_ARM64_X0:
-        return NumVariant(m_context.X0);
-    case CV_ARM64_X1:
-        return NumVariant(m_context.X1);
-    case CV_ARM64_X2:
-        return NumVariant(m_context.X2);
-    case CV_ARM64_X3:
-        return NumVariant(m_context.X3);
-    case CV_ARM64_X4:
-        return NumVariant(m_context.X4);
-    case CV_ARM64_X5:
-        return NumVariant(m_context.X5);
-    case CV_ARM64_X6:
-        return NumVariant(m_context.X6);
-    case CV_ARM64_X7:
-        return NumVariant(m_context.X7);
-    case CV_ARM64_X8:
-        return NumVariant(m_context.X8);
-    case CV_ARM64_X9:
-        return NumVariant(m_context.X9);
-    case CV_ARM64_X10:
-        return NumVariant(m_context.X10);
-    case CV_ARM64_X11:
-        return NumVariant(m_context.X11);
-    case CV_ARM64_X12:
-        return NumVariant(m_context.X12);
-    case CV_ARM64_X13:
-        return NumVariant(m_context.X13);
-    case CV_ARM64_X14:
-        return NumVariant(m_context.X14);
-    case CV_ARM64_X15:
-        return NumVariant(m_context.X15);
-    /* CV_ARM64_IP0 / CV_ARM64_IP1 ??? */
-    case CV_ARM64_X18:
-        return NumVariant(m_context.X18);
-    case CV_ARM64_X19:
-        return NumVariant(m_context.X19);
-    case CV_ARM64_X20:
-        return NumVariant(m_context.X20);
-    case CV_ARM64_X21:
-        return NumVariant(m_context.X21);
-    case CV_ARM64_X22:
-        return NumVariant(m_context.X22);
-    case CV_ARM64_X23:
-        return NumVariant(m_context.X23);
-    case CV_ARM64_X24:
-        return NumVariant(m_context.X24);
-    case CV_ARM64_X25:
-        return NumVariant(m_context.X25);
-    case CV_ARM64_X26:
-        return NumVariant(m_context.X26);
-    case CV_ARM64_X27:
-        return NumVariant(m_context.X27);
-    case CV_ARM64_X28:
-        return NumVariant(m_context.X28);
-    case CV_ARM64_FP:
-        return NumVariant(m_context.Fp);
-    case CV_ARM64_LR:
-        return NumVariant(m_context.Lr);
-    case CV_ARM64_SP:
-        return NumVariant(m_context.Sp);
-    case CV_ARM64_PC:
-        return NumVariant(m_context.Pc);
+namespace {
 
-    case CV_ARM64_NZCV:
-        return NumVariant(m_context.ContextFlags);
-    case CV_ARM64_CPSR:
-        return NumVariant(m_context.Cpsr);
-
-    case CV_ARM64_S0:
-        return NumVariant(m_context.V[0].S);
-    case CV_ARM64_S1:
-        return NumVariant(m_context.V[1].S);
-    case CV_ARM64_S2:
-        return NumVariant(m_context.V[2].S);
-    case CV_ARM64_S3:
-        return NumVariant(m_context.V[3].S);
-    case CV_ARM64_S4:
-        return NumVariant(m_context.V[4].S);
-    case CV_ARM64_S5:
-        return NumVariant(m_context.V[5].S);
-    case CV_ARM64_S6:
-        return NumVariant(m_context.V[6].S);
-    case CV_ARM64_S7:
-        return NumVariant(m_context.V[7].S);
-    case CV_ARM64_S8:
-        return NumVariant(m_context.V[8].S);
-    case CV_ARM64_S9:
-        return NumVariant(m_context.V[9].S);
-    case CV_ARM64_S10:
-        return NumVariant(m_context.V[10].S);
-    case CV_ARM64_S11:
-        return NumVariant(m_context.V[11].S);
-    case CV_ARM64_S12:
-        return NumVariant(m_context.V[12].S);
-    case CV_ARM64_S13:
-        return NumVariant(m_context.V[13].S);
-    case CV_ARM64_S14:
-        return NumVariant(m_context.V[14].S);
-    case CV_ARM64_S15:
-        return NumVariant(m_context.V[15].S);
-    case CV_ARM64_S16:
-        return NumVariant(m_context.V[16].S);
-    case CV_ARM64_S17:
-        return NumVariant(m_context.V[17].S);
-    case CV_ARM64_S18:
-        return NumVariant(m_context.V[18].S);
-    case CV_ARM64_S19:
-        return NumVariant(m_context.V[19].S);
-    case CV_ARM64_S20:
-        return NumVariant(m_context.V[20].S);
-    case CV_ARM64_S21:
-        return NumVariant(m_context.V[21].S);
-    case CV_ARM64_S22:
-        return NumVariant(m_context.V[22].S);
-    case CV_ARM64_S23:
-        return NumVariant(m_context.V[23].S);
-    case CV_ARM64_S24:
-        return NumVariant(m_context.V[24].S);
-    case CV_ARM64_S25:
-        return NumVariant(m_context.V[25].S);
-    case CV_ARM64_S26:
-        return NumVariant(m_context.V[26].S);
-    case CV_ARM64_S27:
-        return NumVariant(m_context.V[27].S);
-    case CV_ARM64_S28:
-        return NumVariant(m_context.V[28].S);
-    case CV_ARM64_S29:
-        return NumVariant(m_context.V[29].S);
-    case CV_ARM64_S30:
-        return NumVariant(m_context.V[30].S);
-    case CV_ARM64_S31:
-        return NumVariant(m_context.V[31].S);
-
-    case CV_ARM64_D0:
-        return NumVariant(m_context.V[0].D);
-    case CV_ARM64_D1:
-        return NumVariant(m_context.V[1].D);
-    case CV_ARM64_D2:
-        return NumVariant(m_context.V[2].D);
-    case CV_ARM64_D3:
-        return NumVariant(m_context.V[3].D);
-    case CV_ARM64_D4:
-        return NumVariant(m_context.V[4].D);
-    case CV_ARM64_D5:
-        return NumVariant(m_context.V[5].D);
-    case CV_ARM64_D6:
-        return NumVariant(m_context.V[6].D);
-    case CV_ARM64_D7:
-        return NumVariant(m_context.V[7].D);
-    case CV_ARM64_D8:
-        return NumVariant(m_context.V[8].D);
-    case CV_ARM64_D9:
-        return NumVariant(m_context.V[9].D);
-    case CV_ARM64_D10:
-        return NumVariant(m_context.V[10].D);
-    case CV_ARM64_D11:
-        return NumVariant(m_context.V[11].D);
-    case CV_ARM64_D12:
-        return NumVariant(m_context.V[12].D);
-    case CV_ARM64_D13:
-        return NumVariant(m_context.V[13].D);
-    case CV_ARM64_D14:
-        return NumVariant(m_context.V[14].D);
-    case CV_ARM64_D15:
-        return NumVariant(m_context.V[15].D);
-    case CV_ARM64_D16:
-        return NumVariant(m_context.V[16].D);
-    case CV_ARM64_D17:
-        return NumVariant(m_context.V[17].D);
-    case CV_ARM64_D18:
-        return NumVariant(m_context.V[18].D);
-    case CV_ARM64_D19:
-        return NumVariant(m_context.V[19].D);
-    case CV_ARM64_D20:
-        return NumVariant(m_context.V[20].D);
-    case CV_ARM64_D21:
-        return NumVariant(m_context.V[21].D);
-    case CV_ARM64_D22:
-        return NumVariant(m_context.V[22].D);
-    case CV_ARM64_D23:
-        return NumVariant(m_context.V[23].D);
-    case CV_ARM64_D24:
-        return NumVariant(m_context.V[24].D);
-    case CV_ARM64_D25:
-        return NumVariant(m_context.V[25].D);
-    case CV_ARM64_D26:
-        return NumVariant(m_context.V[26].D);
-    case CV_ARM64_D27:
-        return NumVariant(m_context.V[27].D);
-    case CV_ARM64_D28:
-        return NumVariant(m_context.V[28].D);
-    case CV_ARM64_D29:
-        return NumVariant(m_context.V[29].D);
-    case CV_ARM64_D30:
-        return NumVariant(m_context.V[30].D);
-    case CV_ARM64_D31:
-        return NumVariant(m_context.V[31].D);
+///////////////////////////////////////////////////////////////////////////////
 
-    /* NumVariant can not provide 128-bit registers :( */
-    // CV_ARM64_Q0 ... CV_ARM64_Q31
+const CPURegisterDesc  arm64Registers[] = {
+    { L"w0",      CV_ARM64_W0,   offsetof(CONTEXT_ARM64, X0),           RegInt32 },
+    { L"w1",      CV_ARM64_W1,   offsetof(CONTEXT_ARM64, X1),           RegInt32 },
+    { L"w2",      CV_ARM64_W2,   offsetof(CONTEXT_ARM64, X2),           RegInt32 },
+    { L"w3",      CV_ARM64_W3,   offsetof(CONTEXT_ARM64, X3),           RegInt32 },
+    { L"w4",      CV_ARM64_W4,   offsetof(CONTEXT_ARM64, X4),           RegInt32 },
+    { L"w5",      CV_ARM64_W5,   offsetof(CONTEXT_ARM64, X5),           RegInt32 },
+    { L"w6",      CV_ARM64_W6,   offsetof(CONTEXT_ARM64, X6),           RegInt32 },
+    { L"w7",      CV_ARM64_W7,   offsetof(CONTEXT_ARM64, X7),           RegInt32 },
+    { L"w8",      CV_ARM64_W8,   offsetof(CONTEXT_ARM64, X8),           RegInt32 },
+    { L"w9",      CV_ARM64_W9,   offsetof(CONTEXT_ARM64, X9),           RegInt32 },
+    { L"w10",     CV_ARM64_W10,  offsetof(CONTEXT_ARM64, X10),          RegInt32 },
+    { L"w11",     CV_ARM64_W11,  offsetof(CONTEXT_ARM64, X11),          RegInt32 },
+    { L"w12",     CV_ARM64_W12,  offsetof(CONTEXT_ARM64, X12),          RegInt32 },
+    { L"w13",     CV_ARM64_W13,  offsetof(CONTEXT_ARM64, X13),          RegInt32 },
+    { L"w14",     CV_ARM64_W14,  offsetof(CONTEXT_ARM64, X14),          RegInt32 },
+    { L"w15",     CV_ARM64_W15,  offsetof(CONTEXT_ARM64, X15),          RegInt32 },
+    { L"w16",     CV_ARM64_W16,  offsetof(CONTEXT_ARM64, X16),          RegInt32 },
+    { L"w17",     CV_ARM64_W17,  offsetof(CONTEXT_ARM64, X17),          RegInt32 },
+    { L"w18",     CV_ARM64_W18,  offsetof(CONTEXT_ARM64, X18),          RegInt32 },
+    { L"w19",     CV_ARM64_W19,  offsetof(CONTEXT_ARM64, X19),          RegInt32 },
+    { L"w20",     CV_ARM64_W20,  offsetof(CONTEXT_ARM64, X20),          RegInt32 },
+    { L"w21",     CV_ARM64_W21,  offsetof(CONTEXT_ARM64, X21),          RegInt32 },
+    { L"w22",     CV_ARM64_W22,  offsetof(CONTEXT_ARM64, X22),          RegInt32 },
+    { L"w23",     CV_ARM64_W23,  offsetof(CONTEXT_ARM64, X23),          RegInt32 },
+    { L"w24",     CV_ARM64_W24,  offsetof(CONTEXT_ARM64, X24),          RegInt32 },
+    { L"w25",     CV_ARM64_W25,  offsetof(CONTEXT_ARM64, X25),          RegInt32 },
+    { L"w26",     CV_ARM64_W26,  offsetof(CONTEXT_ARM64, X26),          RegInt32 },
+    { L"w27",     CV_ARM64_W27,  offsetof(CONTEXT_ARM64, X27),          RegInt32 },
+    { L"w28",     CV_ARM64_W28,  offsetof(CONTEXT_ARM64, X28),          RegInt32 },
+    { L"w29",     CV_ARM64_W29,  offsetof(CONTEXT_ARM64, Fp),           RegInt32 },
+    { L"w30",     CV_ARM64_W30,  offsetof(CONTEXT_ARM64, Lr),           RegInt32 },
+    { L"x0",      CV_ARM64_X0,   offsetof(CONTEXT_ARM64, X0),           RegInt64 },
+    { L"x1",      CV_ARM64_X1,   offsetof(CONTEXT_ARM64, X1),           RegInt64 },
+    { L"x2",      CV_ARM64_X2,   offsetof(CONTEXT_ARM64, X2),           RegInt64 },
+    { L"x3",      CV_ARM64_X3,   offsetof(CONTEXT_ARM64, X3),           RegInt64 },
+    { L"x4",      CV_ARM64_X4,   offsetof(CONTEXT_ARM64, X4),           RegInt64 },
+    { L"x5",      CV_ARM64_X5,   offsetof(CONTEXT_ARM64, X5),           RegInt64 },
+    { L"x6",      CV_ARM64_X6,   offsetof(CONTEXT_ARM64, X6),           RegInt64 },
+    { L"x7",      CV_ARM64_X7,   offsetof(CONTEXT_ARM64, X7),           RegInt64 },
+    { L"x8",      CV_ARM64_X8,   offsetof(CONTEXT_ARM64, X8),           RegInt64 },
+    { L"x9",      CV_ARM64_X9,   offsetof(CONTEXT_ARM64, X9),           RegInt64 },
+    { L"x10",     CV_ARM64_X10,  offsetof(CONTEXT_ARM64, X10),          RegInt64 },
+    { L"x11",     CV_ARM64_X11,  offsetof(CONTEXT_ARM64, X11),          RegInt64 },
+    { L"x12",     CV_ARM64_X12,  offsetof(CONTEXT_ARM64, X12),          RegInt64 },
+    { L"x13",     CV_ARM64_X13,  offsetof(CONTEXT_ARM64, X13),          RegInt64 },
+    { L"x14",     CV_ARM64_X14,  offsetof(CONTEXT_ARM64, X14),          RegInt64 },
+    { L"x15",     CV_ARM64_X15,  offsetof(CONTEXT_ARM64, X15),          RegInt64 },
+    { L"x18",     CV_ARM64_X18,  offsetof(CONTEXT_ARM64, X18),          RegInt64 },
+    { L"x19",     CV_ARM64_X19,  offsetof(CONTEXT_ARM64, X19),          RegInt64 },
+    { L"x20",     CV_ARM64_X20,  offsetof(CONTEXT_ARM64, X20),          RegInt64 },
+    { L"x21",     CV_ARM64_X21,  offsetof(CONTEXT_ARM64, X21),          RegInt64 },
+    { L"x22",     CV_ARM64_X22,  offsetof(CONTEXT_ARM64, X22),          RegInt64 },
+    { L"x23",     CV_ARM64_X23,  offsetof(CONTEXT_ARM64, X23),          RegInt64 },
+    { L"x24",     CV_ARM64_X24,  offsetof(CONTEXT_ARM64, X24),          RegInt64 },
+    { L"x25",     CV_ARM64_X25,  offsetof(CONTEXT_ARM64, X25),          RegInt64 },
+    { L"x26",     CV_ARM64_X26,  offsetof(CONTEXT_ARM64, X26),          RegInt64 },
+    { L"x27",     CV_ARM64_X27,  offsetof(CONTEXT_ARM64, X27),          RegInt64 },
+    { L"x28",     CV_ARM64_X28,  offsetof(CONTEXT_ARM64, X28),          RegInt64 },
+    { L"fp",      CV_ARM64_FP,   offsetof(CONTEXT_ARM64, Fp),           RegInt64 },
+    { L"lr",      CV_ARM64_LR,   offsetof(CONTEXT_ARM64, Lr),           RegInt64 },
+    { L"sp",      CV_ARM64_SP,   offsetof(CONTEXT_ARM64, Sp),           RegInt64 },
+    { L"pc",      CV_ARM64_PC,   offsetof(CONTEXT_ARM64, Pc),           RegInt64 },
+    { 0,          CV_ARM64_NZCV, offsetof(CONTEXT_ARM64, ContextFlags), RegInt32 },
+    { L"cpsr",    CV_ARM64_CPSR, offsetof(CONTEXT_ARM64, Cpsr),         RegInt32 },
+    { L"s0",      CV_ARM64_S0,   offsetof(CONTEXT_ARM64, V[0].S[0]),    RegFloat32 },
+    { L"s1",      CV_ARM64_S1,   offsetof(CONTEXT_ARM64, V[1].S[0]),    RegFloat32 },
+    { L"s2",      CV_ARM64_S2,   offsetof(CONTEXT_ARM64, V[2].S[0]),    RegFloat32 },
+    { L"s3",      CV_ARM64_S3,   offsetof(CONTEXT_ARM64, V[3].S[0]),    RegFloat32 },
+    { L"s4",      CV_ARM64_S4,   offsetof(CONTEXT_ARM64, V[4].S[0]),    RegFloat32 },
+    { L"s5",      CV_ARM64_S5,   offsetof(CONTEXT_ARM64, V[5].S[0]),    RegFloat32 },
+    { L"s6",      CV_ARM64_S6,   offsetof(CONTEXT_ARM64, V[6].S[0]),    RegFloat32 },
+    { L"s7",      CV_ARM64_S7,   offsetof(CONTEXT_ARM64, V[7].S[0]),    RegFloat32 },
+    { L"s8",      CV_ARM64_S8,   offsetof(CONTEXT_ARM64, V[8].S[0]),    RegFloat32 },
+    { L"s9",      CV_ARM64_S9,   offsetof(CONTEXT_ARM64, V[9].S[0]),    RegFloat32 },
+    { L"s10",     CV_ARM64_S10,  offsetof(CONTEXT_ARM64, V[10].S[0]),   RegFloat32 },
+    { L"s11",     CV_ARM64_S11,  offsetof(CONTEXT_ARM64, V[11].S[0]),   RegFloat32 },
+    { L"s12",     CV_ARM64_S12,  offsetof(CONTEXT_ARM64, V[12].S[0]),   RegFloat32 },
+    { L"s13",     CV_ARM64_S13,  offsetof(CONTEXT_ARM64, V[13].S[0]),   RegFloat32 },
+    { L"s14",     CV_ARM64_S14,  offsetof(CONTEXT_ARM64, V[14].S[0]),   RegFloat32 },
+    { L"s15",     CV_ARM64_S15,  offsetof(CONTEXT_ARM64, V[15].S[0]),   RegFloat32 },
+    { L"s16",     CV_ARM64_S16,  offsetof(CONTEXT_ARM64, V[16].S[0]),   RegFloat32 },
+    { L"s17",     CV_ARM64_S17,  offsetof(CONTEXT_ARM64, V[17].S[0]),   RegFloat32 },
+    { L"s18",     CV_ARM64_S18,  offsetof(CONTEXT_ARM64, V[18].S[0]),   RegFloat32 },
+    { L"s19",     CV_ARM64_S19,  offsetof(CONTEXT_ARM64, V[19].S[0]),   RegFloat32 },
+    { L"s20",     CV_ARM64_S20,  offsetof(CONTEXT_ARM64, V[20].S[0]),   RegFloat32 },
+    { L"s21",     CV_ARM64_S21,  offsetof(CONTEXT_ARM64, V[21].S[0]),   RegFloat32 },
+    { L"s22",     CV_ARM64_S22,  offsetof(CONTEXT_ARM64, V[22].S[0]),   RegFloat32 },
+    { L"s23",     CV_ARM64_S23,  offsetof(CONTEXT_ARM64, V[23].S[0]),   RegFloat32 },
+    { L"s24",     CV_ARM64_S24,  offsetof(CONTEXT_ARM64, V[24].S[0]),   RegFloat32 },
+    { L"s25",     CV_ARM64_S25,  offsetof(CONTEXT_ARM64, V[25].S[0]),   RegFloat32 },
+    { L"s26",     CV_ARM64_S26,  offsetof(CONTEXT_ARM64, V[26].S[0]),   RegFloat32 },
+    { L"s27",     CV_ARM64_S27,  offsetof(CONTEXT_ARM64, V[27].S[0]),   RegFloat32 },
+    { L"s28",     CV_ARM64_S28,  offsetof(CONTEXT_ARM64, V[28].S[0]),   RegFloat32 },
+    { L"s29",     CV_ARM64_S29,  offsetof(CONTEXT_ARM64, V[29].S[0]),   RegFloat32 },
+    { L"s30",     CV_ARM64_S30,  offsetof(CONTEXT_ARM64, V[30].S[0]),   RegFloat32 },
+    { L"s31",     CV_ARM64_S31,  offsetof(CONTEXT_ARM64, V[31].S[0]),   RegFloat32 },
+    { L"d0",      CV_ARM64_D0,   offsetof(CONTEXT_ARM64, V[0].D[0]),    RegFloat64 },
+    { L"d1",      CV_ARM64_D1,   offsetof(CONTEXT_ARM64, V[1].D[0]),    RegFloat64 },
+    { L"d2",      CV_ARM64_D2,   offsetof(CONTEXT_ARM64, V[2].D[0]),    RegFloat64 },
+    { L"d3",      CV_ARM64_D3,   offsetof(CONTEXT_ARM64, V[3].D[0]),    RegFloat64 },
+    { L"d4",      CV_ARM64_D4,   offsetof(CONTEXT_ARM64, V[4].D[0]),    RegFloat64 },
+    { L"d5",      CV_ARM64_D5,   offsetof(CONTEXT_ARM64, V[5].D[0]),    RegFloat64 },
+    { L"d6",      CV_ARM64_D6,   offsetof(CONTEXT_ARM64, V[6].D[0]),    RegFloat64 },
+    { L"d7",      CV_ARM64_D7,   offsetof(CONTEXT_ARM64, V[7].D[0]),    RegFloat64 },
+    { L"d8",      CV_ARM64_D8,   offsetof(CONTEXT_ARM64, V[8].D[0]),    RegFloat64 },
+    { L"d9",      CV_ARM64_D9,   offsetof(CONTEXT_ARM64, V[9].D[0]),    RegFloat64 },
+    { L"d10",     CV_ARM64_D10,  offsetof(CONTEXT_ARM64, V[10].D[0]),   RegFloat64 },
+    { L"d11",     CV_ARM64_D11,  offsetof(CONTEXT_ARM64, V[11].D[0]),   RegFloat64 },
+    { L"d12",     CV_ARM64_D12,  offsetof(CONTEXT_ARM64, V[12].D[0]),   RegFloat64 },
+    { L"d13",     CV_ARM64_D13,  offsetof(CONTEXT_ARM64, V[13].D[0]),   RegFloat64 },
+    { L"d14",     CV_ARM64_D14,  offsetof(CONTEXT_ARM64, V[14].D[0]),   RegFloat64 },
+    { L"d15",     CV_ARM64_D15,  offsetof(CONTEXT_ARM64, V[15].D[0]),   RegFloat64 },
+    { L"d16",     CV_ARM64_D16,  offsetof(CONTEXT_ARM64, V[16].D[0]),   RegFloat64 },
+    { L"d17",     CV_ARM64_D17,  offsetof(CONTEXT_ARM64, V[17].D[0]),   RegFloat64 },
+    { L"d18",     CV_ARM64_D18,  offsetof(CONTEXT_ARM64, V[18].D[0]),   RegFloat64 },
+    { L"d19",     CV_ARM64_D19,  offsetof(CONTEXT_ARM64, V[19].D[0]),   RegFloat64 },
+    { L"d20",     CV_ARM64_D20,  offsetof(CONTEXT_ARM64, V[20].D[0]),   RegFloat64 },
+    { L"d21",     CV_ARM64_D21,  offsetof(CONTEXT_ARM64, V[21].D[0]),   RegFloat64 },
+    { L"d22",     CV_ARM64_D22,  offsetof(CONTEXT_ARM64, V[22].D[0]),   RegFloat64 },
+    { L"d23",     CV_ARM64_D23,  offsetof(CONTEXT_ARM64, V[23].D[0]),   RegFloat64 },
+    { L"d24",     CV_ARM64_D24,  offsetof(CONTEXT_ARM64, V[24].D[0]),   RegFloat64 },
+    { L"d25",     CV_ARM64_D25,  offsetof(CONTEXT_ARM64, V[25].D[0]),   RegFloat64 },
+    { L"d26",     CV_ARM64_D26,  offsetof(CONTEXT_ARM64, V[26].D[0]),   RegFloat64 },
+    { L"d27",     CV_ARM64_D27,  offsetof(CONTEXT_ARM64, V[27].D[0]),   RegFloat64 },
+    { L"d28",     CV_ARM64_D28,  offsetof(CONTEXT_ARM64, V[28].D[0]),   RegFloat64 },
+    { L"d29",     CV_ARM64_D29,  offsetof(CONTEXT_ARM64, V[29].D[0]),   RegFloat64 },
+    { L"d30",     CV_ARM64_D30,  offsetof(CONTEXT_ARM64, V[30].D[0]),   RegFloat64 },
+    { L"d31",     CV_ARM64_D31,  offsetof(CONTEXT_ARM64, V[31].D[0]),   RegFloat64 },
+    { L"fpsr",    CV_ARM64_FPSR, offsetof(CONTEXT_ARM64, Fpsr),         RegInt32 },
+    { L"fpcr",    CV_ARM64_FPCR, offsetof(CONTEXT_ARM64, Fpcr),         RegInt32 },
+    { L"q0",      CV_ARM64_Q0,   offsetof(CONTEXT_ARM64, V[0]),         RegVector128 },
+    { L"q1",      CV_ARM64_Q1,   offsetof(CONTEXT_ARM64, V[1]),         RegVector128 },
+    { L"q2",      CV_ARM64_Q2,   offsetof(CONTEXT_ARM64, V[2]),         RegVector128 },
+    { L"q3",      CV_ARM64_Q3,   offsetof(CONTEXT_ARM64, V[3]),         RegVector128 },
+    { L"q4",      CV_ARM64_Q4,   offsetof(CONTEXT_ARM64, V[4]),         RegVector128 },
+    { L"q5",      CV_ARM64_Q5,   offsetof(CONTEXT_ARM64, V[5]),         RegVector128 },
+    { L"q6",      CV_ARM64_Q6,   offsetof(CONTEXT_ARM64, V[6]),         RegVector128 },
+    { L"q7",      CV_ARM64_Q7,   offsetof(CONTEXT_ARM64, V[7]),         RegVector128 },
+    { L"q8",      CV_ARM64_Q8,   offsetof(CONTEXT_ARM64, V[8]),         RegVector128 },
+    { L"q9",      CV_ARM64_Q9,   offsetof(CONTEXT_ARM64, V[9]),         RegVector128 },
+    { L"q10",     CV_ARM64_Q10,  offsetof(CONTEXT_ARM64, V[10]),        RegVector128 },
+    { L"q11",     CV_ARM64_Q11,  offsetof(CONTEXT_ARM64, V[11]),        RegVector128 },
+    { L"q12",     CV_ARM64_Q12,  offsetof(CONTEXT_ARM64, V[12]),        RegVector128 },
+    { L"q13",     CV_ARM64_Q13,  offsetof(CONTEXT_ARM64, V[13]),        RegVector128 },
+    { L"q14",     CV_ARM64_Q14,  offsetof(CONTEXT_ARM64, V[14]),        RegVector128 },
+    { L"q15",     CV_ARM64_Q15,  offsetof(CONTEXT_ARM64, V[15]),        RegVector128 },
+    { L"q16",     CV_ARM64_Q16,  offsetof(CONTEXT_ARM64, V[16]),        RegVector128 },
+    { L"q17",     CV_ARM64_Q17,  offsetof(CONTEXT_ARM64, V[17]),        RegVector128 },
+    { L"q18",     CV_ARM64_Q18,  offsetof(CONTEXT_ARM64, V[18]),        RegVector128 },
+    { L"q19",     CV_ARM64_Q19,  offsetof(CONTEXT_ARM64, V[19]),        RegVector128 },
+    { L"q20",     CV_ARM64_Q20,  offsetof(CONTEXT_ARM64, V[20]),        RegVector128 },
+    { L"q21",     CV_ARM64_Q21,  offsetof(CONTEXT_ARM64, V[21]),        RegVector128 },
+    { L"q22",     CV_ARM64_Q22,  offsetof(CONTEXT_ARM64, V[22]),        RegVector128 },
+    { L"q23",     CV_ARM64_Q23,  offsetof(CONTEXT_ARM64, V[23]),        RegVector128 },
+    { L"q24",     CV_ARM64_Q24,  offsetof(CONTEXT_ARM64, V[24]),        RegVector128 },
+    { L"q25",     CV_ARM64_Q25,  offsetof(CONTEXT_ARM64, V[25]),        RegVector128 },
+    { L"q26",     CV_ARM64_Q26,  offsetof(CONTEXT_ARM64, V[26]),        RegVector128 },
+    { L"q27",     CV_ARM64_Q27,  offsetof(CONTEXT_ARM64, V[27]),        RegVector128 },
+    { L"q28",     CV_ARM64_Q28,  offsetof(CONTEXT_ARM64, V[28]),        RegVector128 },
+    { L"q29",     CV_ARM64_Q29,  offsetof(CONTEXT_ARM64, V[29]),        RegVector128 },
+    { L"q30",     CV_ARM64_Q30,  offsetof(CONTEXT_ARM64, V[30]),        RegVector128 },
+    { L"q31",     CV_ARM64_Q31,  offsetof(CONTEXT_ARM64, V[31]),        RegVector128 }
+};
 
-    case CV_ARM64_FPSR:
-        return NumVariant(m_context.Fpsr);
-    case CV_ARM64_FPCR:
-        return NumVariant(m_context.Fpcr);
-    }
+///////////////////////////////////////////////////////////////////////////////
 
-    std::stringstream sstr;
-    sstr << "ARM64 context: unsupported register index " << std::dec << index;
-    throw DbgException(sstr.str());
-}
+} // end nameless namespace
 
 ///////////////////////////////////////////////////////////////////////////////
 
-std::wstring CPUContextArm64::getRegisterName(unsigned long index)
+const CPURegisterTable& CPUContextArm64::getRegisterTable() const
 {
-    switch (index)
-    {
-    case CV_ARM64_W0:
-        return L"w0";
-    case CV_ARM64_W1:
-        return L"w1";
-    case CV_ARM64_W2:
-        return L"w2";
-    case CV_ARM64_W3:
-        return L"w3";
-    case CV_ARM64_W4:
-        return L"w4";
-    case CV_ARM64_W5:
-        return L"w5";
-    case CV_ARM64_W6:
-        return L"w6";
-    case CV_ARM64_W7:
-        return L"w7";
-    case CV_ARM64_W8:
-        return L"w8";
-    case CV_ARM64_W9:
-        return L"w9";
-    case CV_ARM64_W10:
-        return L"w10";
-    case CV_ARM64_W11:
-        return L"w11";
-    case CV_ARM64_W12:
-        return L"w12";
-    case CV_ARM64_W13:
-        return L"w13";
-    case CV_ARM64_W14:
-        return L"w14";
-    case CV_ARM64_W15:
-        return L"w15";
-    case CV_ARM64_W16:
-        return L"w16";
-    case CV_ARM64_W17:
-        return L"w17";
-    case CV_ARM64_W18:
-        return L"w18";
-    case CV_ARM64_W19:
-        return L"w19";
-    case CV_ARM64_W20:
-        return L"w20";
-    case CV_ARM64_W21:
-        return L"w21";
-    case CV_ARM64_W22:
-        return L"w22";
-    case CV_ARM64_W23:
-        return L"w23";
-    case CV_ARM64_W24:
-        return L"w24";
-    case CV_ARM64_W25:
-        return L"w25";
-    case CV_ARM64_W26:
-        return L"w26";
-    case CV_ARM64_W27:
-        return L"w27";
-    case CV_ARM64_W28:
-        return L"w28";
-    case CV_ARM64_W29:
-        return L"w29";
-    case CV_ARM64_W30:
-        return L"w30";
-
-    case CV_ARM64_X0:
-        return L"x0";
-    case CV_ARM64_X1:
-        return L"x1";
-    case CV_ARM64_X2:
-        return L"x2";
-    case CV_ARM64_X3:
-        return L"x3";
-    case CV_ARM64_X4:
-        return L"x4";
-    case CV_ARM64_X5:
-        return L"x5";
-    case CV_ARM64_X6:
-        return L"x6";
-    case CV_ARM64_X7:
-        return L"x7";
-    case CV_ARM64_X8:
-        return L"x8";
-    case CV_ARM64_X9:
-        return L"x9";
-    case CV_ARM64_X10:
-        return L"x10";
-    case CV_ARM64_X11:
-        return L"x11";
-    case CV_ARM64_X12:
-        return L"x12";
-    case CV_ARM64_X13:
-        return L"x13";
-    case CV_ARM64_X14:
-        return L"x14";
-    case CV_ARM64_X15:
-        return L"x15";
-    case CV_ARM64_X18:
-        return L"x18";
-    case CV_ARM64_X19:
-        return L"x19";
-    case CV_ARM64_X20:
-        return L"x20";
-    case CV_ARM64_X21:
-        return L"x21";
-    case CV_ARM64_X22:
-        return L"x22";
-    case CV_ARM64_X23:
-        return L"x23";
-    case CV_ARM64_X24:
-        return L"x24";
-    case CV_ARM64_X25:
-        return L"x25";
-    case CV_ARM64_X26:
-        return L"x26";
-    case CV_ARM64_X27:
-        return L"x27";
-    case CV_ARM64_X28:
-        return L"x28";
-
-    case CV_ARM64_FP:
-        return L"fp";
-    case CV_ARM64_LR:
-        return L"lr";
-    case CV_ARM64_SP:
-        return L"sp";
-    case CV_ARM64_PC:
-        return L"pc";
-
-    case CV_ARM64_CPSR:
-        return L"cpsr";
-
-    case CV_ARM64_S0:
-        return L"s0";
-    case CV_ARM64_S1:
-        return L"s1";
-    case CV_ARM64_S2:
-        return L"s2";
-    case CV_ARM64_S3:
-        return L"s3";
-    case CV_ARM64_S4:
-        return L"s4";
-    case CV_ARM64_S5:
-        return L"s5";
-    case CV_ARM64_S6:
-        return L"s6";
-    case CV_ARM64_S7:
-        return L"s7";
-    case CV_ARM64_S8:
-        return L"s8";
-    case CV_ARM64_S9:
-        return L"s9";
-    case CV_ARM64_S10:
-        return L"s10";
-    case CV_ARM64_S11:
-        return L"s11";
-    case CV_ARM64_S12:
-        return L"s12";
-    case CV_ARM64_S13:
-        return L"s13";
-    case CV_ARM64_S14:
-        return L"s14";
-    case CV_ARM64_S15:
-        return L"s15";
-    case CV_ARM64_S16:
-        return L"s16";
-    case CV_ARM64_S17:
-        return L"s17";
-    case CV_ARM64_S18:
-        return L"s18";
-    case CV_ARM64_S19:
-        return L"s19";
-    case CV_ARM64_S20:
-        return L"s20";
-    case CV_ARM64_S21:
-        return L"s21";
-    case CV_ARM64_S22:
-        return L"s22";
-    case CV_ARM64_S23:
-        return L"s23";
-    case CV_ARM64_S24:
-        return L"s24";
-    case CV_ARM64_S25:
-        return L"s25";
-    case CV_ARM64_S26:
-        return L"s26";
-    case CV_ARM64_S27:
-        return L"s27";
-    case CV_ARM64_S28:
-        return L"s28";
-    case CV_ARM64_S29:
-        return L"s29";
-    case CV_ARM64_S30:
-        return L"s30";
-    case CV_ARM64_S31:
-        return L"s31";
-
-    case CV_ARM64_D0:
-        return L"d0";
-    case CV_ARM64_D1:
-        return L"d1";
-    case CV_ARM64_D2:
-        return L"d2";
-    case CV_ARM64_D3:
-        return L"d3";
-    case CV_ARM64_D4:
-        return L"d4";
-    case CV_ARM64_D5:
-        return L"d5";
-    case CV_ARM64_D6:
-        return L"d6";
-    case CV_ARM64_D7:
-        return L"d7";
-    case CV_ARM64_D8:
-        return L"d8";
-    case CV_ARM64_D9:
-        return L"d9";
-    case CV_ARM64_D10:
-        return L"d10";
-    case CV_ARM64_D11:
-        return L"d11";
-    case CV_ARM64_D12:
-        return L"d12";
-    case CV_ARM64_D13:
-        return L"d13";
-    case CV_ARM64_D14:
-        return L"d14";
-    case CV_ARM64_D15:
-        return L"d15";
-    case CV_ARM64_D16:
-        return L"d16";
-    case CV_ARM64_D17:
-        return L"d17";
-    case CV_ARM64_D18:
-        return L"d18";
-    case CV_ARM64_D19:
-        return L"d19";
-    case CV_ARM64_D20:
-        return L"d20";
-    case CV_ARM64_D21:
-        return L"d21";
-    case CV_ARM64_D22:
-        return L"d22";
-    case CV_ARM64_D23:
-        return L"d23";
-    case CV_ARM64_D24:
-        return L"d24";
-    case CV_ARM64_D25:
-        return L"d25";
-    case CV_ARM64_D26:
-        return L"d26";
-    case CV_ARM64_D27:
-        return L"d27";
-    case CV_ARM64_D28:
-        return L"d28";
-    case CV_ARM64_D29:
-        return L"d29";
-    case CV_ARM64_D30:
-        return L"d30";
-    case CV_ARM64_D31:
-        return L"d31";
-
-    case CV_ARM64_Q0:
-        return L"q0";
-    case CV_ARM64_Q1:
-        return L"q1";
-    case CV_ARM64_Q2:
-        return L"q2";
-    case CV_ARM64_Q3:
-        return L"q3";
-    case CV_ARM64_Q4:
-        return L"q4";
-    case CV_ARM64_Q5:
-        return L"q5";
-    case CV_ARM64_Q6:
-        return L"q6";
-    case CV_ARM64_Q7:
-        return L"q7";
-    case CV_ARM64_Q8:
-        return L"q8";
-    case CV_ARM64_Q9:
-        return L"q9";
-    case CV_ARM64_Q10:
-        return L"q10";
-    case CV_ARM64_Q11:
-        return L"q11";
-    case CV_ARM64_Q12:
-        return L"q12";
-    case CV_ARM64_Q13:
-        return L"q13";
-    case CV_ARM64_Q14:
-        return L"q14";
-    case CV_ARM64_Q15:
-        return L"q15";
-    case CV_ARM64_Q16:
-        return L"q16";
-    case CV_ARM64_Q17:
-        return L"q17";
-    case CV_ARM64_Q18:
-        return L"q18";
-    case CV_ARM64_Q19:
-        return L"q19";
-    case CV_ARM64_Q20:
-        return L"q20";
-    case CV_ARM64_Q21:
-        return L"q21";
-    case CV_ARM64_Q22:
-        return L"q22";
-    case CV_ARM64_Q23:
-        return L"q23";
-    case CV_ARM64_Q24:
-        return L"q24";
-    case CV_ARM64_Q25:
-        return L"q25";
-    case CV_ARM64_Q26:
-        return L"q26";
-    case CV_ARM64_Q27:
-        return L"q27";
-    case CV_ARM64_Q28:
-        return L"q28";
-    case CV_ARM64_Q29:
-        return L"q29";
-    case CV_ARM64_Q30:
-        return L"q30";
-    case CV_ARM64_Q31:
-        return L"q31";
-
-    case CV_ARM64_FPSR:
-        return L"fpsr";
-    case CV_ARM64_FPCR:
-        return L"fpcr";
-    }
-
-    std::stringstream sstr;
-    sstr << "ARM64 context: unsupported register index " << std::dec << index;
-    throw DbgException(sstr.str());
+    static const CPURegisterTable  registerTable("ARM64", arm64Registers);
+    return registerTable;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
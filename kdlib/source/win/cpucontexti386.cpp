@@ -1,5 +1,7 @@
 #include "stdafx.h"
 
+#include <cstddef>
+
 #include <cvconst.h>
 
 #include "kdlib/dbgengine.h"
@@ -12,166 +14,57 @@
 
 namespace kdlib {
 
+namespace {
+
 ///////////////////////////////////////////////////////////////////////////////
 
-NumVariant CPUContextI386::getRegisterByIndex(unsigned long index)
-{
-    switch (index)
-    {
-    case CV_REG_AL:
-        return NumVariant(static_cast<unsigned char>(m_context.Eax & 0xFF));
-    case CV_REG_CL:
-        return NumVariant(static_cast<unsigned char>(m_context.Ecx & 0xFF));
-    case CV_REG_DL:
-        return NumVariant(static_cast<unsigned char>(m_context.Edx & 0xFF));
-    case CV_REG_BL:
-        return NumVariant(static_cast<unsigned char>(m_context.Ebx & 0xFF));
-    case CV_REG_AH:
-        return NumVariant(static_cast<unsigned char>((m_context.Eax & 0xFF00) >> 8));
-    case CV_REG_CH:
-        return NumVariant(static_cast<unsigned char>((m_context.Ecx & 0xFF00) >> 8));
-    case CV_REG_DH:
-        return NumVariant(static_cast<unsigned char>((m_context.Edx & 0xFF00) >> 8));
-    case CV_REG_BH:
-       return NumVariant(static_cast<unsigned char>((m_context.Ebx & 0xFF00) >> 8));
-    case CV_REG_AX:
-        return NumVariant(static_cast<unsigned short>(m_context.Eax & 0xFFFF));
-    case CV_REG_CX:
-        return NumVariant(static_cast<unsigned short>(m_context.Ecx & 0xFFFF));
-    case CV_REG_DX:
-        return NumVariant(static_cast<unsigned short>(m_context.Edx & 0xFFFF));
-    case CV_REG_BX:
-        return NumVariant(static_cast<unsigned short>(m_context.Ebx & 0xFFFF));
-    case CV_REG_SP:
-        return NumVariant(static_cast<unsigned short>(m_context.Esp & 0xFFFF));
-    case CV_REG_BP:
-        return NumVariant(static_cast<unsigned short>(m_context.Ebp & 0xFFFF));
-    case CV_REG_SI:
-        return NumVariant(static_cast<unsigned short>(m_context.Esi & 0xFFFF));
-    case CV_REG_DI:
-        return NumVariant(static_cast<unsigned short>(m_context.Edi & 0xFFFF));
-    case CV_REG_EAX:
-        return NumVariant(m_context.Eax);
-    case CV_REG_ECX:
-        return NumVariant(m_context.Ecx);
-    case CV_REG_EDX:
-        return NumVariant(m_context.Edx);
-    case CV_REG_EBX:
-        return NumVariant(m_context.Ebx);
-    case CV_REG_ESP:
-        return NumVariant(m_context.Esp);
-    case CV_REG_EBP:
-        return NumVariant(m_context.Ebp);
-    case CV_REG_ESI:
-        return NumVariant(m_context.Esi);
-    case CV_REG_EDI:
-       return NumVariant(m_context.Edi);
-    case CV_REG_ES:
-       return NumVariant(m_context.SegEs);
-    case CV_REG_CS:
-       return NumVariant(m_context.SegCs);
-    case CV_REG_SS:
-       return NumVariant(m_context.SegSs);
-    case CV_REG_DS:
-       return NumVariant(m_context.SegDs);
-    case CV_REG_FS:
-        return NumVariant(m_context.SegFs);
-    case CV_REG_GS:
-        return NumVariant(m_context.SegGs);
-    case CV_REG_IP:
-        return NumVariant(static_cast<unsigned short>(m_context.Eip & 0xFFFF));
-    case CV_REG_FLAGS:
-        return NumVariant(static_cast<unsigned short>(m_context.EFlags & 0xFFFF));
-    case CV_REG_EIP:
-        return NumVariant(m_context.Eip);
-    case CV_REG_EFLAGS:
-        return NumVariant(m_context.EFlags);
-    }
+const CPURegisterDesc  i386Registers[] = {
+    { L"al",        CV_REG_AL,     offsetof(CONTEXT_X86, Eax),     RegInt8 },
+    { L"cl",        CV_REG_CL,     offsetof(CONTEXT_X86, Ecx),     RegInt8 },
+    { L"dl",        CV_REG_DL,     offsetof(CONTEXT_X86, Edx),     RegInt8 },
+    { L"bl",        CV_REG_BL,     offsetof(CONTEXT_X86, Ebx),     RegInt8 },
+    { L"ah",        CV_REG_AH,     offsetof(CONTEXT_X86, Eax) + 1, RegInt8 },
+    { L"ch",        CV_REG_CH,     offsetof(CONTEXT_X86, Ecx) + 1, RegInt8 },
+    { L"dh",        CV_REG_DH,     offsetof(CONTEXT_X86, Edx) + 1, RegInt8 },
+    { L"bh",        CV_REG_BH,     offsetof(CONTEXT_X86, Ebx) + 1, RegInt8 },
+    { L"ax",        CV_REG_AX,     offsetof(CONTEXT_X86, Eax),     RegInt16 },
+    { L"cx",        CV_REG_CX,     offsetof(CONTEXT_X86, Ecx),     RegInt16 },
+    { L"dx",        CV_REG_DX,     offsetof(CONTEXT_X86, Edx),     RegInt16 },
+    { L"bx",        CV_REG_BX,     offsetof(CONTEXT_X86, Ebx),     RegInt16 },
+    { L"sp",        CV_REG_SP,     offsetof(CONTEXT_X86, Esp),     RegInt16 },
+    { L"bp",        CV_REG_BP,     offsetof(CONTEXT_X86, Ebp),     RegInt16 },
+    { L"si",        CV_REG_SI,     offsetof(CONTEXT_X86, Esi),     RegInt16 },
+    { L"di",        CV_REG_DI,     offsetof(CONTEXT_X86, Edi),     RegInt16 },
+    { L"eax",       CV_REG_EAX,    offsetof(CONTEXT_X86, Eax),     RegInt32 },
+    { L"ecx",       CV_REG_ECX,    offsetof(CONTEXT_X86, Ecx),     RegInt32 },
+    { L"edx",       CV_REG_EDX,    offsetof(CONTEXT_X86, Edx),     RegInt32 },
+    { L"ebx",       CV_REG_EBX,    offsetof(CONTEXT_X86, Ebx),     RegInt32 },
+    { L"esp",       CV_REG_ESP,    offsetof(CONTEXT_X86, Esp),     RegInt32 },
+    { L"ebp",       CV_REG_EBP,    offsetof(CONTEXT_X86, Ebp),     RegInt32 },
+    { L"esi",       CV_REG_ESI,    offsetof(CONTEXT_X86, Esi),     RegInt32 },
+    { L"edi",       CV_REG_EDI,    offsetof(CONTEXT_X86, Edi),     RegInt32 },
+    { L"es",        CV_REG_ES,     offsetof(CONTEXT_X86, SegEs),   RegInt32 },
+    { L"cs",        CV_REG_CS,     offsetof(CONTEXT_X86, SegCs),   RegInt32 },
+    { L"ss",        CV_REG_SS,     offsetof(CONTEXT_X86, SegSs),   RegInt32 },
+    { L"ds",        CV_REG_DS,     offsetof(CONTEXT_X86, SegDs),   RegInt32 },
+    { L"fs",        CV_REG_FS,     offsetof(CONTEXT_X86, SegFs),   RegInt32 },
+    { L"gs",        CV_REG_GS,     offsetof(CONTEXT_X86, SegGs),   RegInt32 },
+    { L"ip",        CV_REG_IP,     offsetof(CONTEXT_X86, Eip),     RegInt16 },
+    { L"flags",     CV_REG_FLAGS,  offsetof(CONTEXT_X86, EFlags),  RegInt16 },
+    { L"eip",       CV_REG_EIP,    offsetof(CONTEXT_X86, Eip),     RegInt32 },
+    { L"eflags",    CV_REG_EFLAGS, offsetof(CONTEXT_X86, EFlags),  RegInt32 }
+};
 
-    std::stringstream sstr;
-    sstr << "I386 context: unsupported register index " << std::dec << index;
-    throw DbgException(sstr.str());
-}
+///////////////////////////////////////////////////////////////////////////////
+
+} // end nameless namespace
 
 ///////////////////////////////////////////////////////////////////////////////
 
-std::wstring  CPUContextI386::getRegisterName(unsigned long index)
+const CPURegisterTable& CPUContextI386::getRegisterTable() const
 {
-    switch (index)
-    {
-    case CV_REG_AL:
-        return L"al";
-    case CV_REG_CL:
-        return L"cl";
-    case CV_REG_DL:
-        return L"dl";
-    case CV_REG_BL:
-        return L"bl";
-    case CV_REG_AH:
-        return L"ah";
-    case CV_REG_CH:
-        return L"ch";
-    case CV_REG_DH:
-        return L"dh";
-    case CV_REG_BH:
-        return L"bh";
-    case CV_REG_AX:
-        return L"ax";
-    case CV_REG_CX:
-        return L"cx";
-    case CV_REG_DX:
-        return L"dx";
-    case CV_REG_BX:
-        return L"bx";
-    case CV_REG_SP:
-        return L"sp";
-    case CV_REG_BP:
-        return L"bp";
-    case CV_REG_SI:
-        return L"si";
-    case CV_REG_DI:
-        return L"di";
-    case CV_REG_EAX:
-        return L"eax";
-    case CV_REG_ECX:
-        return L"ecx";
-    case CV_REG_EDX:
-        return L"edx";
-    case CV_REG_EBX:
-        return L"ebx";
-    case CV_REG_ESP:
-        return L"esp";
-    case CV_REG_EBP:
-        return L"ebp";
-    case CV_REG_ESI:
-        return L"esi";
-    case CV_REG_EDI:
-        return L"edi";
-    case CV_REG_ES:
-        return L"es";
-    case CV_REG_CS:
-        return L"cs";
-    case CV_REG_SS:
-        return L"ss";
-    case CV_REG_DS:
-        return L"ds";
-    case CV_REG_FS:
-        return L"fs";
-    case CV_REG_GS:
-        return L"gs";
-    case CV_REG_IP:
-        return L"ip";
-    case CV_REG_FLAGS:
-        return L"flags";
-    case CV_REG_EIP:
-        return L"eip";
-    case CV_REG_EFLAGS:
-        return L"eflags";
-    }
-
-    std::stringstream sstr;
-    sstr << "I386 context: unsupported register index " << std::dec << index;
-    throw DbgException(sstr.str());
+    static const CPURegisterTable  registerTable("I386", i386Registers);
+    return registerTable;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
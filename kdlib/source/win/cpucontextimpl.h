@@ -5,6 +5,7 @@
 #include "kdlib/cpucontext.h"
 
 #include "threadctx.h"
+#include "cpuregisters.h"
 
 namespace kdlib {
 
@@ -32,13 +33,23 @@ public:
     }
 
     virtual NumVariant getRegisterByName(const std::wstring &name) {
-        NOT_IMPLEMENTED();
+        const CPURegisterTable  &registers = getRegisterTable();
+        return registers.read(registers.findByName(name), &m_context);
     }
     virtual void setRegisterByName(const std::wstring &name, const NumVariant& value) {
-        NOT_IMPLEMENTED();
+        const CPURegisterTable  &registers = getRegisterTable();
+        registers.write(registers.findByName(name), &m_context, value);
+    }
+    virtual NumVariant getRegisterByIndex(unsigned long index) {
+        const CPURegisterTable  &registers = getRegisterTable();
+        return registers.read(registers.findByIndex(index), &m_context);
     }
     virtual void setRegisterByIndex(unsigned long index, const NumVariant& value) {
-        NOT_IMPLEMENTED();
+        const CPURegisterTable  &registers = getRegisterTable();
+        registers.write(registers.findByIndex(index), &m_context, value);
+    }
+    virtual std::wstring getRegisterName(unsigned long index) {
+        return getRegisterTable().getName(index);
     }
     virtual unsigned long getRegisterNumber() {
         NOT_IMPLEMENTED();
@@ -54,6 +65,10 @@ public:
         NOT_IMPLEMENTED();
     }
 
+    const RawContextType& getRawContext() const {
+        return m_context;
+    }
+
 protected:
     CPUContextImpl(CPUType cpuType, CPUType cpuMode, const CONTEXT_TYPE *context = nullptr)
         : m_cpuType{ cpuType }, m_cpuMode{ cpuMode }
@@ -71,6 +86,10 @@ protected:
         }
     }
 
+protected:
+    // the registers of the raw context: read and written in place
+    virtual const CPURegisterTable& getRegisterTable() const = 0;
+
 protected:
     CONTEXT_TYPE m_context;
 
@@ -95,10 +114,6 @@ public:
     {
     }
 
-    virtual NumVariant getRegisterByIndex(unsigned long index); 
-
-    virtual std::wstring getRegisterName(unsigned long index);
-
     virtual MEMOFFSET_64 getIP() {
         return m_context.Rip;
     }
@@ -110,6 +125,9 @@ public:
     virtual MEMOFFSET_64 getFP() {
         return m_context.Rbp;
     }
+
+protected:
+    virtual const CPURegisterTable& getRegisterTable() const;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -128,10 +146,6 @@ public:
     {
     }
 
-    virtual NumVariant getRegisterByIndex(unsigned long index);
-
-    virtual std::wstring getRegisterName(unsigned long index);
-
     virtual MEMOFFSET_64 getIP() {
         return m_context.Eip;
     }
@@ -143,6 +157,9 @@ public:
     virtual MEMOFFSET_64 getFP() {
         return m_context.Ebp;
     }
+
+protected:
+    virtual const CPURegisterTable& getRegisterTable() const;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -161,10 +178,6 @@ public:
     {
     }
 
-    virtual NumVariant getRegisterByIndex(unsigned long index);
-    
-    virtual std::wstring getRegisterName(unsigned long index);
-
     virtual MEMOFFSET_64 getIP() {
         return m_context.Eip;
     }
@@ -176,6 +189,9 @@ public:
     virtual MEMOFFSET_64 getFP() {
         return m_context.Ebp;
     }
+
+protected:
+    virtual const CPURegisterTable& getRegisterTable() const;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -194,10 +210,6 @@ public:
     {
     }
 
-    virtual NumVariant getRegisterByIndex(unsigned long index);
-
-    virtual std::wstring getRegisterName(unsigned long index);
-
     virtual MEMOFFSET_64 getIP() {
         return m_context.Pc;
     }
@@ -209,6 +221,9 @@ public:
     virtual MEMOFFSET_64 getFP() {
         return m_context.Fp;
     }
+
+protected:
+    virtual const CPURegisterTable& getRegisterTable() const;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -227,10 +242,6 @@ public:
     {
     }
 
-    virtual NumVariant getRegisterByIndex(unsigned long index);
-
-    virtual std::wstring getRegisterName(unsigned long index);
-
     virtual MEMOFFSET_64 getIP() {
         return m_context.Pc;
     }
@@ -242,6 +253,9 @@ public:
     virtual MEMOFFSET_64 getFP() {
         return m_context.R11;
     }
+
+protected:
+    virtual const CPURegisterTable& getRegisterTable() const;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,306 @@
+#include "stdafx.h"
+
+#include <cstring>
+#include <algorithm>
+
+#include "kdlib/exceptions.h"
+
+#include "cpuregisters.h"
+
+namespace kdlib {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+
+const unsigned short  NoRegister = 0xFFFF;
+
+// FNV-1a of the lower case name, the seed selects the function of the family
+
+unsigned long hashRegisterName( const wchar_t *name, size_t length, unsigned long seed )
+{
+    unsigned long  hash = 2166136261UL ^ ( seed * 0x9E3779B9UL );
+
+    for ( size_t i = 0; i < length; ++i )
+    {
+        wchar_t  ch = name[i];
+        if ( ch >= L'A' && ch <= L'Z' )
+            ch += L'a' - L'A';
+
+        hash ^= static_cast<unsigned short>(ch);
+        hash *= 16777619UL;
+    }
+
+    hash ^= hash >> 15;
+    hash *= 0x2C1B3C6DUL;
+    hash ^= hash >> 12;
+
+    return hash;
+}
+
+bool equalRegisterNames( const wchar_t *name1, const wchar_t *name2, size_t length )
+{
+    for ( size_t i = 0; i < length; ++i )
+    {
+        wchar_t  ch1 = name1[i];
+        wchar_t  ch2 = name2[i];
+
+        if ( ch2 == L'\0' )
+            return false;
+
+        if ( ch1 >= L'A' && ch1 <= L'Z' )
+            ch1 += L'a' - L'A';
+
+        if ( ch2 >= L'A' && ch2 <= L'Z' )
+            ch2 += L'a' - L'A';
+
+        if ( ch1 != ch2 )
+            return false;
+    }
+
+    return name2[length] == L'\0';
+}
+
+template <typename T>
+NumVariant loadRegister( const void *rawContext, size_t offset )
+{
+    T  value;
+    memcpy( &value, static_cast<const char*>(rawContext) + offset, sizeof(T) );
+    return NumVariant( value );
+}
+
+template <typename T>
+void storeRegister( void *rawContext, size_t offset, T value )
+{
+    memcpy( static_cast<char*>(rawContext) + offset, &value, sizeof(T) );
+}
+
+bool biggerBucket( const std::vector<unsigned short> *bucket1, const std::vector<unsigned short> *bucket2 )
+{
+    return bucket1->size() > bucket2->size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // end nameless namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+const CPURegisterDesc& CPURegisterTable::findByName( const std::wstring &name ) const
+{
+    const CPURegisterDesc  *reg = lookupName( name.c_str(), name.length() );
+    if ( reg )
+        return *reg;
+
+    std::wstringstream  sstr;
+    sstr << m_cpuName << L" context: unsupported register name " << name;
+    throw DbgWideException( sstr.str() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const CPURegisterDesc& CPURegisterTable::findByIndex( unsigned long index ) const
+{
+    if ( index < m_indexLookup.size() && m_indexLookup[index] != NoRegister )
+        return m_registers[ m_indexLookup[index] ];
+
+    std::stringstream  sstr;
+    sstr << m_cpuName << " context: unsupported register index " << std::dec << index;
+    throw DbgException( sstr.str() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::wstring CPURegisterTable::getName( unsigned long index ) const
+{
+    const CPURegisterDesc  &reg = findByIndex( index );
+    if ( reg.name )
+        return reg.name;
+
+    std::stringstream  sstr;
+    sstr << m_cpuName << " context: unsupported register index " << std::dec << index;
+    throw DbgException( sstr.str() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+NumVariant CPURegisterTable::read( const CPURegisterDesc &reg, const void *rawContext ) const
+{
+    switch ( reg.type )
+    {
+    case RegInt8:
+        return loadRegister<unsigned char>( rawContext, reg.offset );
+    case RegInt16:
+        return loadRegister<unsigned short>( rawContext, reg.offset );
+    case RegInt32:
+        return loadRegister<unsigned long>( rawContext, reg.offset );
+    case RegInt64:
+        return loadRegister<unsigned long long>( rawContext, reg.offset );
+    case RegFloat32:
+        return loadRegister<float>( rawContext, reg.offset );
+    case RegFloat64:
+        return loadRegister<double>( rawContext, reg.offset );
+    }
+
+    /* NumVariant can not provide 80 and 128-bit registers :( */
+
+    std::stringstream  sstr;
+    sstr << m_cpuName << " context: unsupported register index " << std::dec << reg.index;
+    throw DbgException( sstr.str() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CPURegisterTable::write( const CPURegisterDesc &reg, void *rawContext, const NumVariant &value ) const
+{
+    switch ( reg.type )
+    {
+    case RegInt8:
+        storeRegister( rawContext, reg.offset, value.asUChar() );
+        return;
+    case RegInt16:
+        storeRegister( rawContext, reg.offset, value.asUShort() );
+        return;
+    case RegInt32:
+        storeRegister( rawContext, reg.offset, value.asULong() );
+        return;
+    case RegInt64:
+        storeRegister( rawContext, reg.offset, value.asULongLong() );
+        return;
+    case RegFloat32:
+        storeRegister( rawContext, reg.offset, value.asFloat() );
+        return;
+    case RegFloat64:
+        storeRegister( rawContext, reg.offset, value.asDouble() );
+        return;
+    }
+
+    std::stringstream  sstr;
+    sstr << m_cpuName << " context: unsupported register index " << std::dec << reg.index;
+    throw DbgException( sstr.str() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CPURegisterTable::buildIndexLookup()
+{
+    unsigned long  maxIndex = 0;
+
+    for ( size_t i = 0; i < m_count; ++i )
+        maxIndex = std::max( maxIndex, m_registers[i].index );
+
+    m_indexLookup.assign( maxIndex + 1, NoRegister );
+
+    for ( size_t i = 0; i < m_count; ++i )
+    {
+        if ( m_indexLookup[ m_registers[i].index ] == NoRegister )
+            m_indexLookup[ m_registers[i].index ] = static_cast<unsigned short>(i);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CPURegisterTable::buildNameHash()
+{
+    size_t  nameCount = 0;
+
+    for ( size_t i = 0; i < m_count; ++i )
+    {
+        if ( m_registers[i].name )
+            ++nameCount;
+    }
+
+    size_t  slotCount = 1;
+
+    while ( slotCount < nameCount )
+        slotCount <<= 1;
+
+    m_hashMask = static_cast<unsigned long>(slotCount - 1);
+    m_bucketSeeds.assign( slotCount, 0 );
+    m_nameSlots.assign( slotCount, NoRegister );
+
+    std::vector< std::vector<unsigned short> >  buckets( slotCount );
+
+    for ( size_t i = 0; i < m_count; ++i )
+    {
+        const wchar_t  *name = m_registers[i].name;
+        if ( !name )
+            continue;
+
+        unsigned long  bucket = hashRegisterName( name, wcslen(name), 0 ) & m_hashMask;
+        buckets[bucket].push_back( static_cast<unsigned short>(i) );
+    }
+
+    // the biggest buckets are placed first while the most of the slots are free
+    std::vector< std::vector<unsigned short>* >  order;
+
+    for ( size_t i = 0; i < buckets.size(); ++i )
+    {
+        if ( !buckets[i].empty() )
+            order.push_back( &buckets[i] );
+    }
+
+    std::stable_sort( order.begin(), order.end(), biggerBucket );
+
+    std::vector<unsigned long>  slots;
+
+    for ( size_t i = 0; i < order.size(); ++i )
+    {
+        const std::vector<unsigned short>  &bucket = *order[i];
+
+        unsigned long  seed = 1;
+
+        for ( ; seed <= 0x100000; ++seed )
+        {
+            slots.clear();
+
+            for ( size_t j = 0; j < bucket.size(); ++j )
+            {
+                const wchar_t  *name = m_registers[ bucket[j] ].name;
+                unsigned long  slot = hashRegisterName( name, wcslen(name), seed ) & m_hashMask;
+
+                if ( m_nameSlots[slot] != NoRegister || std::find( slots.begin(), slots.end(), slot ) != slots.end() )
+                    break;
+
+                slots.push_back( slot );
+            }
+
+            if ( slots.size() == bucket.size() )
+                break;
+        }
+
+        if ( slots.size() != bucket.size() )
+        {
+            // the same name is twice in the table
+            std::stringstream  sstr;
+            sstr << m_cpuName << " context: the register names are not unique";
+            throw DbgException( sstr.str() );
+        }
+
+        const wchar_t  *name = m_registers[ bucket.front() ].name;
+        m_bucketSeeds[ hashRegisterName( name, wcslen(name), 0 ) & m_hashMask ] = seed;
+
+        for ( size_t j = 0; j < bucket.size(); ++j )
+            m_nameSlots[ slots[j] ] = bucket[j];
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const CPURegisterDesc* CPURegisterTable::lookupName( const wchar_t *name, size_t length ) const
+{
+    unsigned long  bucket = hashRegisterName( name, length, 0 ) & m_hashMask;
+    unsigned long  slot = hashRegisterName( name, length, m_bucketSeeds[bucket] ) & m_hashMask;
+
+    unsigned short  i = m_nameSlots[slot];
+    if ( i == NoRegister )
+        return 0;
+
+    const CPURegisterDesc  &reg = m_registers[i];
+
+    return equalRegisterNames( name, reg.name, length ) ? &reg : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
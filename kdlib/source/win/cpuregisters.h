@@ -0,0 +1,76 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "kdlib/dbgtypedef.h"
+#include "kdlib/variant.h"
+
+namespace kdlib {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// A register of a raw thread context
+
+struct CPURegisterDesc
+{
+    const wchar_t  *name;           // null if the register is known by the index only
+    unsigned long  index;           // CV_REG_*, CV_AMD64_*, CV_ARM_*, CV_ARM64_*
+    size_t  offset;                 // in the raw context
+    CPURegType  type;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The registers of a raw context by names and by indexes. The names are found
+// by a perfect hash built once for the table, the indexes by a direct lookup.
+// A register is read and written in place of the raw context: no engine call.
+
+class CPURegisterTable
+{
+public:
+
+    template <size_t N>
+    CPURegisterTable( const char *cpuName, const CPURegisterDesc (&registers)[N] ) :
+        m_cpuName( cpuName ),
+        m_registers( registers ),
+        m_count( N )
+    {
+        buildIndexLookup();
+        buildNameHash();
+    }
+
+    // throw DbgException if the register is unknown
+    const CPURegisterDesc& findByName( const std::wstring &name ) const;
+    const CPURegisterDesc& findByIndex( unsigned long index ) const;
+
+    // throws DbgException if the register has no name
+    std::wstring getName( unsigned long index ) const;
+
+    // throw DbgException if NumVariant can not hold the register
+    NumVariant read( const CPURegisterDesc &reg, const void *rawContext ) const;
+    void write( const CPURegisterDesc &reg, void *rawContext, const NumVariant &value ) const;
+
+private:
+
+    void buildIndexLookup();
+    void buildNameHash();
+
+    const CPURegisterDesc* lookupName( const wchar_t *name, size_t length ) const;
+
+    const char  *m_cpuName;
+    const CPURegisterDesc  *m_registers;
+    size_t  m_count;
+
+    std::vector<unsigned short>  m_indexLookup;     // by a register index, 0xFFFF - no register
+
+    // two levels: a name goes to a bucket, the seed of the bucket puts it
+    // to its own slot
+    unsigned long  m_hashMask;
+    std::vector<unsigned long>  m_bucketSeeds;
+    std::vector<unsigned short>  m_nameSlots;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
@@ -10,6 +10,7 @@
 
 #include "win/dbgmgr.h"
 #include "win/exceptions.h"
+#include "processmon.h"
 
 using boost::numeric_cast;
 
@@ -104,6 +105,13 @@ void writeMemory( MEMOFFSET_64 offset, const void* buffer, size_t length, bool p
         hres = g_dbgMgr->dataspace->WritePhysical( offset, const_cast<PVOID>(buffer),  numeric_cast<ULONG>(length), written );
     }
 
+    // the decoded code may be patched, even by a partial write; a physical
+    // page can be mapped to any virtual address
+    if ( phyAddr == false )
+        ProcessMonitor::removeInstructions( offset, offset + length );
+    else
+        ProcessMonitor::removeInstructions( 0, ~MEMOFFSET_64(0) );
+
     if ( FAILED( hres ) )
         throw MemoryException( offset, phyAddr );
 }
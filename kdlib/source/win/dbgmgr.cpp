@@ -213,6 +213,26 @@ HRESULT STDMETHODCALLTYPE DebugManager::ChangeEngineState(
     return S_OK;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+HRESULT STDMETHODCALLTYPE DebugManager::ChangeDebuggeeState(
+    __in ULONG Flags,
+    __in ULONG64 Argument )
+{
+    try {
+
+        // the memory was changed by the engine ( a command, an extension ):
+        // the changed range is not reported, so drop all the decoded code
+        if ((Flags & DEBUG_CDS_DATA) != 0)
+            ProcessMonitor::removeInstructions(0, ~MEMOFFSET_64(0));
+    }
+    catch (kdlib::DbgException&)
+    {
+    }
+
+    return S_OK;
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -284,7 +304,19 @@ HRESULT STDMETHODCALLTYPE DebugManager::UnloadModule(
 
     try {
 
-        std::wstring  moduleName = getModuleName(BaseOffset);
+        // the engine can remove the module from its list before the event:
+        // the module caches must be dropped even if the name is not available
+        std::wstring  moduleName = ImageBaseName ? ImageBaseName : L"";
+
+        try {
+            moduleName = getModuleName(BaseOffset);
+        }
+        catch (kdlib::DbgException&)
+        {}
+
+        // an unload event without a base does not say which code is gone
+        if (BaseOffset == 0)
+            ProcessMonitor::removeInstructions(0, ~MEMOFFSET_64(0));
 
         result = ProcessMonitor::moduleUnload(getCurrentProcessId(), BaseOffset, moduleName);
 
@@ -0,0 +1,4303 @@
+#include "stdafx.h"
+
+#include <cstring>
+#include <sstream>
+#include <iomanip>
+
+#include "kdlib/instruction.h"
+#include "kdlib/exceptions.h"
+
+namespace kdlib {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+
+const size_t  MaxInstructionLength = 15;
+
+// Operand specifications of the opcode maps: the Intel SDM appendix A notation
+
+enum OperandSpec {
+    OpNone,
+    OpEb,
+    OpEw,
+    OpEd,
+    OpEv,
+    OpEy,
+    OpGb,
+    OpGw,
+    OpGd,
+    OpGv,
+    OpGy,
+    OpGz,
+    OpRv,
+    OpRy,
+    OpBy,
+    OpM,
+    OpMb,
+    OpMw,
+    OpMd,
+    OpMq,
+    OpMt,
+    OpMp,
+    OpMdq,
+    OpMv,
+    OpMy,
+    OpMx,
+    OpIb,
+    OpIbs,
+    OpIw,
+    OpIz,
+    OpIv,
+    OpOne,
+    OpThree,
+    OpJb,
+    OpJz,
+    OpAp,
+    OpOb,
+    OpOv,
+    OpAL,
+    OpCL,
+    OpDX,
+    OpAX,
+    OpAXv,
+    OpAXz,
+    OpZb,
+    OpZv,
+    OpZy,
+    OpSw,
+    OpES,
+    OpCS,
+    OpSS,
+    OpDS,
+    OpFS,
+    OpGS,
+    OpXb,
+    OpXv,
+    OpXz,
+    OpYb,
+    OpYv,
+    OpYz,
+    OpXlat,
+    OpCd,
+    OpDd,
+    OpPq,
+    OpQq,
+    OpNq,
+    OpPx,
+    OpQx,
+    OpNx,
+    OpVx,
+    OpWx,
+    OpUx,
+    OpWb,
+    OpWw,
+    OpWss,
+    OpWsd,
+    OpWdq,
+    OpWsx,
+    OpHx,
+    OpLx,
+    OpST,
+    OpSTi,
+    OpKg,
+    OpKe,
+    OpKh,
+    OpKr
+};
+
+enum OpcodeFlag {
+    FlagModRM           = 0x0001,
+    FlagDefault64       = 0x0002,   // 64-bit operand size by default in the 64-bit mode
+    FlagForce64         = 0x0004,   // 64-bit operand size whatever the prefixes are
+    FlagInvalid64       = 0x0008,
+    FlagGroup           = 0x0010,   // extension: groupMap index, ModRM.reg selects the entry
+    FlagPrefixed        = 0x0020,   // extension: prefixedMap index, the mandatory prefix selects the entry
+    FlagVexOnly         = 0x0040,
+    FlagVexNds          = 0x0080,   // the VEX form has the vvvv source after the first operand
+    FlagVexNdsRegister  = 0x0100,   // the same for the register form only
+    FlagVexWide         = 0x0200,   // extension: vexWideMnemonics index, the VEX.W1 mnemonic
+    FlagOperand4Lx      = 0x0400,   // the fourth operand is a register in imm8[7:4]
+    FlagOperand4Ib      = 0x0800,
+    FlagVexValid        = 0x1000,   // the opcode has VEX and EVEX forms
+    FlagEvexMask        = 0x2000,   // the EVEX form writes a mask register
+    FlagEvexWide        = 0x4000    // extension: evexWideMnemonics index, the EVEX form has the element size suffix
+};
+
+struct OpcodeEntry {
+    unsigned short  mnemonic;
+    unsigned char  operands[3];
+    unsigned short  flags;
+    unsigned char  extension;
+    unsigned char  flow;
+};
+
+// x87 register forms selected by the whole ModRM byte
+struct X87Special {
+    unsigned char  opcode;
+    unsigned char  modrm;
+    unsigned short  mnemonic;
+    unsigned char  operand;
+};
+
+// VEX mask register instructions: the mnemonics by the size b, w, d, q
+struct MaskOpcode {
+    unsigned char  opcode;
+    unsigned char  operands[3];
+    unsigned short  mnemonics[4];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+const OpcodeEntry oneByteMap[0x100] = {
+    { MnemonicAdd, { OpEb, OpGb, OpNone }, FlagModRM, 0, FlowNone },    // 00
+    { MnemonicAdd, { OpEv, OpGv, OpNone }, FlagModRM, 0, FlowNone },    // 01
+    { MnemonicAdd, { OpGb, OpEb, OpNone }, FlagModRM, 0, FlowNone },    // 02
+    { MnemonicAdd, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 03
+    { MnemonicAdd, { OpAL, OpIb, OpNone }, 0, 0, FlowNone },    // 04
+    { MnemonicAdd, { OpAXv, OpIz, OpNone }, 0, 0, FlowNone },    // 05
+    { MnemonicPush, { OpES, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 06
+    { MnemonicPop, { OpES, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 07
+    { MnemonicOr, { OpEb, OpGb, OpNone }, FlagModRM, 0, FlowNone },    // 08
+    { MnemonicOr, { OpEv, OpGv, OpNone }, FlagModRM, 0, FlowNone },    // 09
+    { MnemonicOr, { OpGb, OpEb, OpNone }, FlagModRM, 0, FlowNone },    // 0A
+    { MnemonicOr, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 0B
+    { MnemonicOr, { OpAL, OpIb, OpNone }, 0, 0, FlowNone },    // 0C
+    { MnemonicOr, { OpAXv, OpIz, OpNone }, 0, 0, FlowNone },    // 0D
+    { MnemonicPush, { OpCS, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 0E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 0F
+    { MnemonicAdc, { OpEb, OpGb, OpNone }, FlagModRM, 0, FlowNone },    // 10
+    { MnemonicAdc, { OpEv, OpGv, OpNone }, FlagModRM, 0, FlowNone },    // 11
+    { MnemonicAdc, { OpGb, OpEb, OpNone }, FlagModRM, 0, FlowNone },    // 12
+    { MnemonicAdc, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 13
+    { MnemonicAdc, { OpAL, OpIb, OpNone }, 0, 0, FlowNone },    // 14
+    { MnemonicAdc, { OpAXv, OpIz, OpNone }, 0, 0, FlowNone },    // 15
+    { MnemonicPush, { OpSS, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 16
+    { MnemonicPop, { OpSS, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 17
+    { MnemonicSbb, { OpEb, OpGb, OpNone }, FlagModRM, 0, FlowNone },    // 18
+    { MnemonicSbb, { OpEv, OpGv, OpNone }, FlagModRM, 0, FlowNone },    // 19
+    { MnemonicSbb, { OpGb, OpEb, OpNone }, FlagModRM, 0, FlowNone },    // 1A
+    { MnemonicSbb, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 1B
+    { MnemonicSbb, { OpAL, OpIb, OpNone }, 0, 0, FlowNone },    // 1C
+    { MnemonicSbb, { OpAXv, OpIz, OpNone }, 0, 0, FlowNone },    // 1D
+    { MnemonicPush, { OpDS, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 1E
+    { MnemonicPop, { OpDS, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 1F
+    { MnemonicAnd, { OpEb, OpGb, OpNone }, FlagModRM, 0, FlowNone },    // 20
+    { MnemonicAnd, { OpEv, OpGv, OpNone }, FlagModRM, 0, FlowNone },    // 21
+    { MnemonicAnd, { OpGb, OpEb, OpNone }, FlagModRM, 0, FlowNone },    // 22
+    { MnemonicAnd, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 23
+    { MnemonicAnd, { OpAL, OpIb, OpNone }, 0, 0, FlowNone },    // 24
+    { MnemonicAnd, { OpAXv, OpIz, OpNone }, 0, 0, FlowNone },    // 25
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 26
+    { MnemonicDaa, { OpNone, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 27
+    { MnemonicSub, { OpEb, OpGb, OpNone }, FlagModRM, 0, FlowNone },    // 28
+    { MnemonicSub, { OpEv, OpGv, OpNone }, FlagModRM, 0, FlowNone },    // 29
+    { MnemonicSub, { OpGb, OpEb, OpNone }, FlagModRM, 0, FlowNone },    // 2A
+    { MnemonicSub, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 2B
+    { MnemonicSub, { OpAL, OpIb, OpNone }, 0, 0, FlowNone },    // 2C
+    { MnemonicSub, { OpAXv, OpIz, OpNone }, 0, 0, FlowNone },    // 2D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 2E
+    { MnemonicDas, { OpNone, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 2F
+    { MnemonicXor, { OpEb, OpGb, OpNone }, FlagModRM, 0, FlowNone },    // 30
+    { MnemonicXor, { OpEv, OpGv, OpNone }, FlagModRM, 0, FlowNone },    // 31
+    { MnemonicXor, { OpGb, OpEb, OpNone }, FlagModRM, 0, FlowNone },    // 32
+    { MnemonicXor, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 33
+    { MnemonicXor, { OpAL, OpIb, OpNone }, 0, 0, FlowNone },    // 34
+    { MnemonicXor, { OpAXv, OpIz, OpNone }, 0, 0, FlowNone },    // 35
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 36
+    { MnemonicAaa, { OpNone, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 37
+    { MnemonicCmp, { OpEb, OpGb, OpNone }, FlagModRM, 0, FlowNone },    // 38
+    { MnemonicCmp, { OpEv, OpGv, OpNone }, FlagModRM, 0, FlowNone },    // 39
+    { MnemonicCmp, { OpGb, OpEb, OpNone }, FlagModRM, 0, FlowNone },    // 3A
+    { MnemonicCmp, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 3B
+    { MnemonicCmp, { OpAL, OpIb, OpNone }, 0, 0, FlowNone },    // 3C
+    { MnemonicCmp, { OpAXv, OpIz, OpNone }, 0, 0, FlowNone },    // 3D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 3E
+    { MnemonicAas, { OpNone, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 3F
+    { MnemonicInc, { OpZv, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 40
+    { MnemonicInc, { OpZv, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 41
+    { MnemonicInc, { OpZv, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 42
+    { MnemonicInc, { OpZv, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 43
+    { MnemonicInc, { OpZv, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 44
+    { MnemonicInc, { OpZv, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 45
+    { MnemonicInc, { OpZv, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 46
+    { MnemonicInc, { OpZv, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 47
+    { MnemonicDec, { OpZv, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 48
+    { MnemonicDec, { OpZv, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 49
+    { MnemonicDec, { OpZv, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 4A
+    { MnemonicDec, { OpZv, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 4B
+    { MnemonicDec, { OpZv, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 4C
+    { MnemonicDec, { OpZv, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 4D
+    { MnemonicDec, { OpZv, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 4E
+    { MnemonicDec, { OpZv, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 4F
+    { MnemonicPush, { OpZv, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // 50
+    { MnemonicPush, { OpZv, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // 51
+    { MnemonicPush, { OpZv, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // 52
+    { MnemonicPush, { OpZv, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // 53
+    { MnemonicPush, { OpZv, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // 54
+    { MnemonicPush, { OpZv, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // 55
+    { MnemonicPush, { OpZv, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // 56
+    { MnemonicPush, { OpZv, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // 57
+    { MnemonicPop, { OpZv, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // 58
+    { MnemonicPop, { OpZv, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // 59
+    { MnemonicPop, { OpZv, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // 5A
+    { MnemonicPop, { OpZv, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // 5B
+    { MnemonicPop, { OpZv, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // 5C
+    { MnemonicPop, { OpZv, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // 5D
+    { MnemonicPop, { OpZv, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // 5E
+    { MnemonicPop, { OpZv, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // 5F
+    { MnemonicPushad, { OpNone, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 60
+    { MnemonicPopad, { OpNone, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // 61
+    { MnemonicBound, { OpGv, OpMq, OpNone }, FlagInvalid64 | FlagModRM, 0, FlowNone },    // 62
+    { MnemonicArpl, { OpEw, OpGw, OpNone }, FlagModRM, 0, FlowNone },    // 63
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 64
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 65
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 66
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 67
+    { MnemonicPush, { OpIz, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // 68
+    { MnemonicImul, { OpGv, OpEv, OpIz }, FlagModRM, 0, FlowNone },    // 69
+    { MnemonicPush, { OpIbs, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // 6A
+    { MnemonicImul, { OpGv, OpEv, OpIbs }, FlagModRM, 0, FlowNone },    // 6B
+    { MnemonicIns, { OpYb, OpDX, OpNone }, 0, 0, FlowNone },    // 6C
+    { MnemonicIns, { OpYz, OpDX, OpNone }, 0, 0, FlowNone },    // 6D
+    { MnemonicOuts, { OpDX, OpXb, OpNone }, 0, 0, FlowNone },    // 6E
+    { MnemonicOuts, { OpDX, OpXz, OpNone }, 0, 0, FlowNone },    // 6F
+    { MnemonicJo, { OpJb, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 70
+    { MnemonicJno, { OpJb, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 71
+    { MnemonicJb, { OpJb, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 72
+    { MnemonicJae, { OpJb, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 73
+    { MnemonicJe, { OpJb, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 74
+    { MnemonicJne, { OpJb, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 75
+    { MnemonicJbe, { OpJb, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 76
+    { MnemonicJa, { OpJb, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 77
+    { MnemonicJs, { OpJb, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 78
+    { MnemonicJns, { OpJb, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 79
+    { MnemonicJp, { OpJb, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 7A
+    { MnemonicJnp, { OpJb, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 7B
+    { MnemonicJl, { OpJb, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 7C
+    { MnemonicJge, { OpJb, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 7D
+    { MnemonicJle, { OpJb, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 7E
+    { MnemonicJg, { OpJb, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 7F
+    { MnemonicInvalid, { OpEb, OpIb, OpNone }, FlagGroup | FlagModRM, 0, FlowNone },    // 80
+    { MnemonicInvalid, { OpEv, OpIz, OpNone }, FlagGroup | FlagModRM, 0, FlowNone },    // 81
+    { MnemonicInvalid, { OpEb, OpIb, OpNone }, FlagInvalid64 | FlagGroup | FlagModRM, 0, FlowNone },    // 82
+    { MnemonicInvalid, { OpEv, OpIbs, OpNone }, FlagGroup | FlagModRM, 0, FlowNone },    // 83
+    { MnemonicTest, { OpEb, OpGb, OpNone }, FlagModRM, 0, FlowNone },    // 84
+    { MnemonicTest, { OpEv, OpGv, OpNone }, FlagModRM, 0, FlowNone },    // 85
+    { MnemonicXchg, { OpEb, OpGb, OpNone }, FlagModRM, 0, FlowNone },    // 86
+    { MnemonicXchg, { OpEv, OpGv, OpNone }, FlagModRM, 0, FlowNone },    // 87
+    { MnemonicMov, { OpEb, OpGb, OpNone }, FlagModRM, 0, FlowNone },    // 88
+    { MnemonicMov, { OpEv, OpGv, OpNone }, FlagModRM, 0, FlowNone },    // 89
+    { MnemonicMov, { OpGb, OpEb, OpNone }, FlagModRM, 0, FlowNone },    // 8A
+    { MnemonicMov, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 8B
+    { MnemonicMov, { OpEv, OpSw, OpNone }, FlagModRM, 0, FlowNone },    // 8C
+    { MnemonicLea, { OpGv, OpM, OpNone }, FlagModRM, 0, FlowNone },    // 8D
+    { MnemonicMov, { OpSw, OpEw, OpNone }, FlagModRM, 0, FlowNone },    // 8E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 1, FlowNone },    // 8F
+    { MnemonicNop, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 90
+    { MnemonicXchg, { OpZv, OpAXv, OpNone }, 0, 0, FlowNone },    // 91
+    { MnemonicXchg, { OpZv, OpAXv, OpNone }, 0, 0, FlowNone },    // 92
+    { MnemonicXchg, { OpZv, OpAXv, OpNone }, 0, 0, FlowNone },    // 93
+    { MnemonicXchg, { OpZv, OpAXv, OpNone }, 0, 0, FlowNone },    // 94
+    { MnemonicXchg, { OpZv, OpAXv, OpNone }, 0, 0, FlowNone },    // 95
+    { MnemonicXchg, { OpZv, OpAXv, OpNone }, 0, 0, FlowNone },    // 96
+    { MnemonicXchg, { OpZv, OpAXv, OpNone }, 0, 0, FlowNone },    // 97
+    { MnemonicCbw, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 98
+    { MnemonicCwd, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 99
+    { MnemonicCall, { OpAp, OpNone, OpNone }, FlagInvalid64, 0, FlowCall },    // 9A
+    { MnemonicWait, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 9B
+    { MnemonicPushfd, { OpNone, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // 9C
+    { MnemonicPopfd, { OpNone, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // 9D
+    { MnemonicSahf, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 9E
+    { MnemonicLahf, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 9F
+    { MnemonicMov, { OpAL, OpOb, OpNone }, 0, 0, FlowNone },    // A0
+    { MnemonicMov, { OpAXv, OpOv, OpNone }, 0, 0, FlowNone },    // A1
+    { MnemonicMov, { OpOb, OpAL, OpNone }, 0, 0, FlowNone },    // A2
+    { MnemonicMov, { OpOv, OpAXv, OpNone }, 0, 0, FlowNone },    // A3
+    { MnemonicMovs, { OpYb, OpXb, OpNone }, 0, 0, FlowNone },    // A4
+    { MnemonicMovs, { OpYv, OpXv, OpNone }, 0, 0, FlowNone },    // A5
+    { MnemonicCmps, { OpXb, OpYb, OpNone }, 0, 0, FlowNone },    // A6
+    { MnemonicCmps, { OpXv, OpYv, OpNone }, 0, 0, FlowNone },    // A7
+    { MnemonicTest, { OpAL, OpIb, OpNone }, 0, 0, FlowNone },    // A8
+    { MnemonicTest, { OpAXv, OpIz, OpNone }, 0, 0, FlowNone },    // A9
+    { MnemonicStos, { OpYb, OpNone, OpNone }, 0, 0, FlowNone },    // AA
+    { MnemonicStos, { OpYv, OpNone, OpNone }, 0, 0, FlowNone },    // AB
+    { MnemonicLods, { OpXb, OpNone, OpNone }, 0, 0, FlowNone },    // AC
+    { MnemonicLods, { OpXv, OpNone, OpNone }, 0, 0, FlowNone },    // AD
+    { MnemonicScas, { OpYb, OpNone, OpNone }, 0, 0, FlowNone },    // AE
+    { MnemonicScas, { OpYv, OpNone, OpNone }, 0, 0, FlowNone },    // AF
+    { MnemonicMov, { OpZb, OpIb, OpNone }, 0, 0, FlowNone },    // B0
+    { MnemonicMov, { OpZb, OpIb, OpNone }, 0, 0, FlowNone },    // B1
+    { MnemonicMov, { OpZb, OpIb, OpNone }, 0, 0, FlowNone },    // B2
+    { MnemonicMov, { OpZb, OpIb, OpNone }, 0, 0, FlowNone },    // B3
+    { MnemonicMov, { OpZb, OpIb, OpNone }, 0, 0, FlowNone },    // B4
+    { MnemonicMov, { OpZb, OpIb, OpNone }, 0, 0, FlowNone },    // B5
+    { MnemonicMov, { OpZb, OpIb, OpNone }, 0, 0, FlowNone },    // B6
+    { MnemonicMov, { OpZb, OpIb, OpNone }, 0, 0, FlowNone },    // B7
+    { MnemonicMov, { OpZv, OpIv, OpNone }, 0, 0, FlowNone },    // B8
+    { MnemonicMov, { OpZv, OpIv, OpNone }, 0, 0, FlowNone },    // B9
+    { MnemonicMov, { OpZv, OpIv, OpNone }, 0, 0, FlowNone },    // BA
+    { MnemonicMov, { OpZv, OpIv, OpNone }, 0, 0, FlowNone },    // BB
+    { MnemonicMov, { OpZv, OpIv, OpNone }, 0, 0, FlowNone },    // BC
+    { MnemonicMov, { OpZv, OpIv, OpNone }, 0, 0, FlowNone },    // BD
+    { MnemonicMov, { OpZv, OpIv, OpNone }, 0, 0, FlowNone },    // BE
+    { MnemonicMov, { OpZv, OpIv, OpNone }, 0, 0, FlowNone },    // BF
+    { MnemonicInvalid, { OpEb, OpIb, OpNone }, FlagGroup | FlagModRM, 2, FlowNone },    // C0
+    { MnemonicInvalid, { OpEv, OpIb, OpNone }, FlagGroup | FlagModRM, 2, FlowNone },    // C1
+    { MnemonicRet, { OpIw, OpNone, OpNone }, FlagForce64, 0, FlowReturn },    // C2
+    { MnemonicRet, { OpNone, OpNone, OpNone }, FlagForce64, 0, FlowReturn },    // C3
+    { MnemonicLes, { OpGz, OpMp, OpNone }, FlagInvalid64 | FlagModRM, 0, FlowNone },    // C4
+    { MnemonicLds, { OpGz, OpMp, OpNone }, FlagInvalid64 | FlagModRM, 0, FlowNone },    // C5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 3, FlowNone },    // C6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 4, FlowNone },    // C7
+    { MnemonicEnter, { OpIw, OpIb, OpNone }, 0, 0, FlowNone },    // C8
+    { MnemonicLeave, { OpNone, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // C9
+    { MnemonicRetf, { OpIw, OpNone, OpNone }, 0, 0, FlowReturn },    // CA
+    { MnemonicRetf, { OpNone, OpNone, OpNone }, 0, 0, FlowReturn },    // CB
+    { MnemonicInt, { OpThree, OpNone, OpNone }, 0, 0, FlowInterrupt },    // CC
+    { MnemonicInt, { OpIb, OpNone, OpNone }, 0, 0, FlowInterrupt },    // CD
+    { MnemonicInto, { OpNone, OpNone, OpNone }, FlagInvalid64, 0, FlowInterrupt },    // CE
+    { MnemonicIretd, { OpNone, OpNone, OpNone }, 0, 0, FlowReturn },    // CF
+    { MnemonicInvalid, { OpEb, OpOne, OpNone }, FlagGroup | FlagModRM, 2, FlowNone },    // D0
+    { MnemonicInvalid, { OpEv, OpOne, OpNone }, FlagGroup | FlagModRM, 2, FlowNone },    // D1
+    { MnemonicInvalid, { OpEb, OpCL, OpNone }, FlagGroup | FlagModRM, 2, FlowNone },    // D2
+    { MnemonicInvalid, { OpEv, OpCL, OpNone }, FlagGroup | FlagModRM, 2, FlowNone },    // D3
+    { MnemonicAam, { OpIb, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // D4
+    { MnemonicAad, { OpIb, OpNone, OpNone }, FlagInvalid64, 0, FlowNone },    // D5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // D6
+    { MnemonicXlat, { OpXlat, OpNone, OpNone }, 0, 0, FlowNone },    // D7
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 5, FlowNone },    // D8
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 6, FlowNone },    // D9
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 7, FlowNone },    // DA
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 8, FlowNone },    // DB
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 9, FlowNone },    // DC
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 10, FlowNone },    // DD
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 11, FlowNone },    // DE
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 12, FlowNone },    // DF
+    { MnemonicLoopne, { OpJb, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // E0
+    { MnemonicLoope, { OpJb, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // E1
+    { MnemonicLoop, { OpJb, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // E2
+    { MnemonicJecxz, { OpJb, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // E3
+    { MnemonicIn, { OpAL, OpIb, OpNone }, 0, 0, FlowNone },    // E4
+    { MnemonicIn, { OpAXz, OpIb, OpNone }, 0, 0, FlowNone },    // E5
+    { MnemonicOut, { OpIb, OpAL, OpNone }, 0, 0, FlowNone },    // E6
+    { MnemonicOut, { OpIb, OpAXz, OpNone }, 0, 0, FlowNone },    // E7
+    { MnemonicCall, { OpJz, OpNone, OpNone }, FlagForce64, 0, FlowCall },    // E8
+    { MnemonicJmp, { OpJz, OpNone, OpNone }, FlagForce64, 0, FlowJump },    // E9
+    { MnemonicJmp, { OpAp, OpNone, OpNone }, FlagInvalid64, 0, FlowJump },    // EA
+    { MnemonicJmp, { OpJb, OpNone, OpNone }, FlagForce64, 0, FlowJump },    // EB
+    { MnemonicIn, { OpAL, OpDX, OpNone }, 0, 0, FlowNone },    // EC
+    { MnemonicIn, { OpAXz, OpDX, OpNone }, 0, 0, FlowNone },    // ED
+    { MnemonicOut, { OpDX, OpAL, OpNone }, 0, 0, FlowNone },    // EE
+    { MnemonicOut, { OpDX, OpAXz, OpNone }, 0, 0, FlowNone },    // EF
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // F0
+    { MnemonicInt1, { OpNone, OpNone, OpNone }, 0, 0, FlowInterrupt },    // F1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // F2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // F3
+    { MnemonicHlt, { OpNone, OpNone, OpNone }, 0, 0, FlowStop },    // F4
+    { MnemonicCmc, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // F5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 13, FlowNone },    // F6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 14, FlowNone },    // F7
+    { MnemonicClc, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // F8
+    { MnemonicStc, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // F9
+    { MnemonicCli, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // FA
+    { MnemonicSti, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // FB
+    { MnemonicCld, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // FC
+    { MnemonicStd, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // FD
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 15, FlowNone },    // FE
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 16, FlowNone },    // FF
+};
+
+const OpcodeEntry twoByteMap[0x100] = {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 17, FlowNone },    // 00
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 18, FlowNone },    // 01
+    { MnemonicLar, { OpGv, OpEw, OpNone }, FlagModRM, 0, FlowNone },    // 02
+    { MnemonicLsl, { OpGv, OpEw, OpNone }, FlagModRM, 0, FlowNone },    // 03
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 04
+    { MnemonicSyscall, { OpNone, OpNone, OpNone }, 0, 0, FlowInterrupt },    // 05
+    { MnemonicClts, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 06
+    { MnemonicSysret, { OpNone, OpNone, OpNone }, 0, 0, FlowReturn },    // 07
+    { MnemonicInvd, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 08
+    { MnemonicWbinvd, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 09
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 0A
+    { MnemonicUd2, { OpNone, OpNone, OpNone }, 0, 0, FlowStop },    // 0B
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 0C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 19, FlowNone },    // 0D
+    { MnemonicFemms, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 0E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 0F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 0, FlowNone },    // 10
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 1, FlowNone },    // 11
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 2, FlowNone },    // 12
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 3, FlowNone },    // 13
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 4, FlowNone },    // 14
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 5, FlowNone },    // 15
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 6, FlowNone },    // 16
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 7, FlowNone },    // 17
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 20, FlowNone },    // 18
+    { MnemonicNop, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 19
+    { MnemonicNop, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 1A
+    { MnemonicNop, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 1B
+    { MnemonicNop, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 1C
+    { MnemonicNop, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 1D
+    { MnemonicNop, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 1E
+    { MnemonicNop, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 1F
+    { MnemonicMov, { OpRy, OpCd, OpNone }, FlagModRM, 0, FlowNone },    // 20
+    { MnemonicMov, { OpRy, OpDd, OpNone }, FlagModRM, 0, FlowNone },    // 21
+    { MnemonicMov, { OpCd, OpRy, OpNone }, FlagModRM, 0, FlowNone },    // 22
+    { MnemonicMov, { OpDd, OpRy, OpNone }, FlagModRM, 0, FlowNone },    // 23
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 24
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 25
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 26
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 27
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 8, FlowNone },    // 28
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 9, FlowNone },    // 29
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 10, FlowNone },    // 2A
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 11, FlowNone },    // 2B
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 12, FlowNone },    // 2C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 13, FlowNone },    // 2D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 14, FlowNone },    // 2E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 15, FlowNone },    // 2F
+    { MnemonicWrmsr, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 30
+    { MnemonicRdtsc, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 31
+    { MnemonicRdmsr, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 32
+    { MnemonicRdpmc, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 33
+    { MnemonicSysenter, { OpNone, OpNone, OpNone }, 0, 0, FlowInterrupt },    // 34
+    { MnemonicSysexit, { OpNone, OpNone, OpNone }, 0, 0, FlowReturn },    // 35
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 36
+    { MnemonicGetsec, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 37
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 38
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 39
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 3A
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 3B
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 3C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 3D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 3E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 3F
+    { MnemonicCmovo, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 40
+    { MnemonicCmovno, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 41
+    { MnemonicCmovb, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 42
+    { MnemonicCmovae, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 43
+    { MnemonicCmove, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 44
+    { MnemonicCmovne, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 45
+    { MnemonicCmovbe, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 46
+    { MnemonicCmova, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 47
+    { MnemonicCmovs, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 48
+    { MnemonicCmovns, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 49
+    { MnemonicCmovp, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 4A
+    { MnemonicCmovnp, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 4B
+    { MnemonicCmovl, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 4C
+    { MnemonicCmovge, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 4D
+    { MnemonicCmovle, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 4E
+    { MnemonicCmovg, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // 4F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 16, FlowNone },    // 50
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 17, FlowNone },    // 51
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 18, FlowNone },    // 52
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 19, FlowNone },    // 53
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 20, FlowNone },    // 54
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 21, FlowNone },    // 55
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 22, FlowNone },    // 56
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 23, FlowNone },    // 57
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 24, FlowNone },    // 58
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 25, FlowNone },    // 59
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 26, FlowNone },    // 5A
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 27, FlowNone },    // 5B
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 28, FlowNone },    // 5C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 29, FlowNone },    // 5D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 30, FlowNone },    // 5E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 31, FlowNone },    // 5F
+    { MnemonicPunpcklbw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // 60
+    { MnemonicPunpcklwd, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // 61
+    { MnemonicPunpckldq, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // 62
+    { MnemonicPacksswb, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // 63
+    { MnemonicPcmpgtb, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid | FlagEvexMask, 0, FlowNone },    // 64
+    { MnemonicPcmpgtw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid | FlagEvexMask, 0, FlowNone },    // 65
+    { MnemonicPcmpgtd, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid | FlagEvexMask, 0, FlowNone },    // 66
+    { MnemonicPackuswb, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // 67
+    { MnemonicPunpckhbw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // 68
+    { MnemonicPunpckhwd, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // 69
+    { MnemonicPunpckhdq, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // 6A
+    { MnemonicPackssdw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // 6B
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 32, FlowNone },    // 6C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 33, FlowNone },    // 6D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 34, FlowNone },    // 6E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 35, FlowNone },    // 6F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 36, FlowNone },    // 70
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 21, FlowNone },    // 71
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 22, FlowNone },    // 72
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 23, FlowNone },    // 73
+    { MnemonicPcmpeqb, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid | FlagEvexMask, 0, FlowNone },    // 74
+    { MnemonicPcmpeqw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid | FlagEvexMask, 0, FlowNone },    // 75
+    { MnemonicPcmpeqd, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid | FlagEvexMask, 0, FlowNone },    // 76
+    { MnemonicEmms, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 77
+    { MnemonicVmread, { OpEy, OpGy, OpNone }, FlagModRM, 0, FlowNone },    // 78
+    { MnemonicVmwrite, { OpGy, OpEy, OpNone }, FlagModRM, 0, FlowNone },    // 79
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 7A
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 7B
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 37, FlowNone },    // 7C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 38, FlowNone },    // 7D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 39, FlowNone },    // 7E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 40, FlowNone },    // 7F
+    { MnemonicJo, { OpJz, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 80
+    { MnemonicJno, { OpJz, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 81
+    { MnemonicJb, { OpJz, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 82
+    { MnemonicJae, { OpJz, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 83
+    { MnemonicJe, { OpJz, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 84
+    { MnemonicJne, { OpJz, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 85
+    { MnemonicJbe, { OpJz, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 86
+    { MnemonicJa, { OpJz, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 87
+    { MnemonicJs, { OpJz, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 88
+    { MnemonicJns, { OpJz, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 89
+    { MnemonicJp, { OpJz, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 8A
+    { MnemonicJnp, { OpJz, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 8B
+    { MnemonicJl, { OpJz, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 8C
+    { MnemonicJge, { OpJz, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 8D
+    { MnemonicJle, { OpJz, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 8E
+    { MnemonicJg, { OpJz, OpNone, OpNone }, FlagForce64, 0, FlowBranch },    // 8F
+    { MnemonicSeto, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 90
+    { MnemonicSetno, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 91
+    { MnemonicSetb, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 92
+    { MnemonicSetae, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 93
+    { MnemonicSete, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 94
+    { MnemonicSetne, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 95
+    { MnemonicSetbe, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 96
+    { MnemonicSeta, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 97
+    { MnemonicSets, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 98
+    { MnemonicSetns, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 99
+    { MnemonicSetp, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 9A
+    { MnemonicSetnp, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 9B
+    { MnemonicSetl, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 9C
+    { MnemonicSetge, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 9D
+    { MnemonicSetle, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 9E
+    { MnemonicSetg, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // 9F
+    { MnemonicPush, { OpFS, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // A0
+    { MnemonicPop, { OpFS, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // A1
+    { MnemonicCpuid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // A2
+    { MnemonicBt, { OpEv, OpGv, OpNone }, FlagModRM, 0, FlowNone },    // A3
+    { MnemonicShld, { OpEv, OpGv, OpIb }, FlagModRM, 0, FlowNone },    // A4
+    { MnemonicShld, { OpEv, OpGv, OpCL }, FlagModRM, 0, FlowNone },    // A5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // A6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // A7
+    { MnemonicPush, { OpGS, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // A8
+    { MnemonicPop, { OpGS, OpNone, OpNone }, FlagDefault64, 0, FlowNone },    // A9
+    { MnemonicRsm, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // AA
+    { MnemonicBts, { OpEv, OpGv, OpNone }, FlagModRM, 0, FlowNone },    // AB
+    { MnemonicShrd, { OpEv, OpGv, OpIb }, FlagModRM, 0, FlowNone },    // AC
+    { MnemonicShrd, { OpEv, OpGv, OpCL }, FlagModRM, 0, FlowNone },    // AD
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 24, FlowNone },    // AE
+    { MnemonicImul, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },    // AF
+    { MnemonicCmpxchg, { OpEb, OpGb, OpNone }, FlagModRM, 0, FlowNone },    // B0
+    { MnemonicCmpxchg, { OpEv, OpGv, OpNone }, FlagModRM, 0, FlowNone },    // B1
+    { MnemonicLss, { OpGz, OpMp, OpNone }, FlagModRM, 0, FlowNone },    // B2
+    { MnemonicBtr, { OpEv, OpGv, OpNone }, FlagModRM, 0, FlowNone },    // B3
+    { MnemonicLfs, { OpGz, OpMp, OpNone }, FlagModRM, 0, FlowNone },    // B4
+    { MnemonicLgs, { OpGz, OpMp, OpNone }, FlagModRM, 0, FlowNone },    // B5
+    { MnemonicMovzx, { OpGv, OpEb, OpNone }, FlagModRM, 0, FlowNone },    // B6
+    { MnemonicMovzx, { OpGv, OpEw, OpNone }, FlagModRM, 0, FlowNone },    // B7
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 41, FlowNone },    // B8
+    { MnemonicUd1, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowStop },    // B9
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 25, FlowNone },    // BA
+    { MnemonicBtc, { OpEv, OpGv, OpNone }, FlagModRM, 0, FlowNone },    // BB
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 42, FlowNone },    // BC
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 43, FlowNone },    // BD
+    { MnemonicMovsx, { OpGv, OpEb, OpNone }, FlagModRM, 0, FlowNone },    // BE
+    { MnemonicMovsx, { OpGv, OpEw, OpNone }, FlagModRM, 0, FlowNone },    // BF
+    { MnemonicXadd, { OpEb, OpGb, OpNone }, FlagModRM, 0, FlowNone },    // C0
+    { MnemonicXadd, { OpEv, OpGv, OpNone }, FlagModRM, 0, FlowNone },    // C1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 44, FlowNone },    // C2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 45, FlowNone },    // C3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 46, FlowNone },    // C4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 47, FlowNone },    // C5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 48, FlowNone },    // C6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM, 26, FlowNone },    // C7
+    { MnemonicBswap, { OpZy, OpNone, OpNone }, 0, 0, FlowNone },    // C8
+    { MnemonicBswap, { OpZy, OpNone, OpNone }, 0, 0, FlowNone },    // C9
+    { MnemonicBswap, { OpZy, OpNone, OpNone }, 0, 0, FlowNone },    // CA
+    { MnemonicBswap, { OpZy, OpNone, OpNone }, 0, 0, FlowNone },    // CB
+    { MnemonicBswap, { OpZy, OpNone, OpNone }, 0, 0, FlowNone },    // CC
+    { MnemonicBswap, { OpZy, OpNone, OpNone }, 0, 0, FlowNone },    // CD
+    { MnemonicBswap, { OpZy, OpNone, OpNone }, 0, 0, FlowNone },    // CE
+    { MnemonicBswap, { OpZy, OpNone, OpNone }, 0, 0, FlowNone },    // CF
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 49, FlowNone },    // D0
+    { MnemonicPsrlw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // D1
+    { MnemonicPsrld, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // D2
+    { MnemonicPsrlq, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // D3
+    { MnemonicPaddq, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // D4
+    { MnemonicPmullw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // D5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 50, FlowNone },    // D6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 51, FlowNone },    // D7
+    { MnemonicPsubusb, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // D8
+    { MnemonicPsubusw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // D9
+    { MnemonicPminub, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // DA
+    { MnemonicPand, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid | FlagEvexWide, 0, FlowNone },    // DB
+    { MnemonicPaddusb, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // DC
+    { MnemonicPaddusw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // DD
+    { MnemonicPmaxub, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // DE
+    { MnemonicPandn, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid | FlagEvexWide, 1, FlowNone },    // DF
+    { MnemonicPavgb, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // E0
+    { MnemonicPsraw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // E1
+    { MnemonicPsrad, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // E2
+    { MnemonicPavgw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // E3
+    { MnemonicPmulhuw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // E4
+    { MnemonicPmulhw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // E5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 52, FlowNone },    // E6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 53, FlowNone },    // E7
+    { MnemonicPsubsb, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // E8
+    { MnemonicPsubsw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // E9
+    { MnemonicPminsw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // EA
+    { MnemonicPor, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid | FlagEvexWide, 2, FlowNone },    // EB
+    { MnemonicPaddsb, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // EC
+    { MnemonicPaddsw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // ED
+    { MnemonicPmaxsw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // EE
+    { MnemonicPxor, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid | FlagEvexWide, 3, FlowNone },    // EF
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 54, FlowNone },    // F0
+    { MnemonicPsllw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // F1
+    { MnemonicPslld, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // F2
+    { MnemonicPsllq, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // F3
+    { MnemonicPmuludq, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // F4
+    { MnemonicPmaddwd, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // F5
+    { MnemonicPsadbw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // F6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 55, FlowNone },    // F7
+    { MnemonicPsubb, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // F8
+    { MnemonicPsubw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // F9
+    { MnemonicPsubd, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // FA
+    { MnemonicPsubq, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // FB
+    { MnemonicPaddb, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // FC
+    { MnemonicPaddw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // FD
+    { MnemonicPaddd, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // FE
+    { MnemonicUd0, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowStop },    // FF
+};
+
+const OpcodeEntry threeByteMap38[0x100] = {
+    { MnemonicPshufb, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // 00
+    { MnemonicPhaddw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // 01
+    { MnemonicPhaddd, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // 02
+    { MnemonicPhaddsw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // 03
+    { MnemonicPmaddubsw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // 04
+    { MnemonicPhsubw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // 05
+    { MnemonicPhsubd, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // 06
+    { MnemonicPhsubsw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // 07
+    { MnemonicPsignb, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // 08
+    { MnemonicPsignw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // 09
+    { MnemonicPsignd, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // 0A
+    { MnemonicPmulhrsw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // 0B
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 0C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 0D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 0E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 0F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 56, FlowNone },    // 10
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 11
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 12
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 13
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 57, FlowNone },    // 14
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 58, FlowNone },    // 15
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 16
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 59, FlowNone },    // 17
+    { MnemonicVbroadcastss, { OpVx, OpWss, OpNone }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // 18
+    { MnemonicVbroadcastsd, { OpVx, OpWsd, OpNone }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // 19
+    { MnemonicVbroadcastf128, { OpVx, OpMdq, OpNone }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // 1A
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 1B
+    { MnemonicPabsb, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // 1C
+    { MnemonicPabsw, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // 1D
+    { MnemonicPabsd, { OpPx, OpQx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // 1E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 1F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 60, FlowNone },    // 20
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 61, FlowNone },    // 21
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 62, FlowNone },    // 22
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 63, FlowNone },    // 23
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 64, FlowNone },    // 24
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 65, FlowNone },    // 25
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 66, FlowNone },    // 26
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 67, FlowNone },    // 27
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 68, FlowNone },    // 28
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 69, FlowNone },    // 29
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 70, FlowNone },    // 2A
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 71, FlowNone },    // 2B
+    { MnemonicVmaskmovps, { OpVx, OpHx, OpMx }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // 2C
+    { MnemonicVmaskmovpd, { OpVx, OpHx, OpMx }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // 2D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 2E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 2F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 72, FlowNone },    // 30
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 73, FlowNone },    // 31
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 74, FlowNone },    // 32
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 75, FlowNone },    // 33
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 76, FlowNone },    // 34
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 77, FlowNone },    // 35
+    { MnemonicVpermd, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // 36
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 78, FlowNone },    // 37
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 79, FlowNone },    // 38
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 80, FlowNone },    // 39
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 81, FlowNone },    // 3A
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 82, FlowNone },    // 3B
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 83, FlowNone },    // 3C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 84, FlowNone },    // 3D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 85, FlowNone },    // 3E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 86, FlowNone },    // 3F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 87, FlowNone },    // 40
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 88, FlowNone },    // 41
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 42
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 43
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 44
+    { MnemonicVpsrlvd, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 30, FlowNone },    // 45
+    { MnemonicVpsravd, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // 46
+    { MnemonicVpsllvd, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 31, FlowNone },    // 47
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 48
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 49
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 4A
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 4B
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 4C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 4D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 4E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 4F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 50
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 51
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 52
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 53
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 54
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 55
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 56
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 57
+    { MnemonicVpbroadcastd, { OpVx, OpWss, OpNone }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // 58
+    { MnemonicVpbroadcastq, { OpVx, OpWsd, OpNone }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // 59
+    { MnemonicVbroadcasti128, { OpVx, OpMdq, OpNone }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // 5A
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 5B
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 5C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 5D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 5E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 5F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 60
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 61
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 62
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 63
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 64
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 65
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 66
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 67
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 68
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 69
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 6A
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 6B
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 6C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 6D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 6E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 6F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 70
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 71
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 72
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 73
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 74
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 75
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 76
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 77
+    { MnemonicVpbroadcastb, { OpVx, OpWb, OpNone }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // 78
+    { MnemonicVpbroadcastw, { OpVx, OpWw, OpNone }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // 79
+    { MnemonicVpbroadcastb, { OpVx, OpEd, OpNone }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // 7A
+    { MnemonicVpbroadcastw, { OpVx, OpEd, OpNone }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // 7B
+    { MnemonicVpbroadcastd, { OpVx, OpEy, OpNone }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 38, FlowNone },    // 7C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 7D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 7E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 7F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 80
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 81
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 82
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 83
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 84
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 85
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 86
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 87
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 88
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 89
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 8A
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 8B
+    { MnemonicVpmaskmovd, { OpVx, OpHx, OpMx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 32, FlowNone },    // 8C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 8D
+    { MnemonicVpmaskmovd, { OpMx, OpHx, OpVx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 33, FlowNone },    // 8E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 8F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 90
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 91
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 92
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 93
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 94
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 95
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 89, FlowNone },    // 96
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 90, FlowNone },    // 97
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 91, FlowNone },    // 98
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 92, FlowNone },    // 99
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 93, FlowNone },    // 9A
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 94, FlowNone },    // 9B
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 95, FlowNone },    // 9C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 96, FlowNone },    // 9D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 97, FlowNone },    // 9E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 98, FlowNone },    // 9F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // A0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // A1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // A2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // A3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // A4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // A5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 99, FlowNone },    // A6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 100, FlowNone },    // A7
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 101, FlowNone },    // A8
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 102, FlowNone },    // A9
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 103, FlowNone },    // AA
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 104, FlowNone },    // AB
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 105, FlowNone },    // AC
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 106, FlowNone },    // AD
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 107, FlowNone },    // AE
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 108, FlowNone },    // AF
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // B0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // B1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // B2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // B3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // B4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // B5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 109, FlowNone },    // B6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 110, FlowNone },    // B7
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 111, FlowNone },    // B8
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 112, FlowNone },    // B9
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 113, FlowNone },    // BA
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 114, FlowNone },    // BB
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 115, FlowNone },    // BC
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 116, FlowNone },    // BD
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 117, FlowNone },    // BE
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 118, FlowNone },    // BF
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // C0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // C1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // C2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // C3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // C4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // C5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // C6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // C7
+    { MnemonicSha1nexte, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // C8
+    { MnemonicSha1msg1, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // C9
+    { MnemonicSha1msg2, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // CA
+    { MnemonicSha256rnds2, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // CB
+    { MnemonicSha256msg1, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // CC
+    { MnemonicSha256msg2, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // CD
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // CE
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // CF
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // D0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // D1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // D2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // D3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // D4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // D5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // D6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // D7
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // D8
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // D9
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // DA
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 119, FlowNone },    // DB
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 120, FlowNone },    // DC
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 121, FlowNone },    // DD
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 122, FlowNone },    // DE
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 123, FlowNone },    // DF
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // E0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // E1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // E2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // E3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // E4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // E5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // E6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // E7
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // E8
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // E9
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // EA
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // EB
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // EC
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // ED
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // EE
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // EF
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 124, FlowNone },    // F0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 125, FlowNone },    // F1
+    { MnemonicAndn, { OpGy, OpBy, OpEy }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // F2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagGroup | FlagModRM | FlagVexOnly | FlagVexValid, 27, FlowNone },    // F3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // F4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 126, FlowNone },    // F5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 127, FlowNone },    // F6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 128, FlowNone },    // F7
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // F8
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // F9
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // FA
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // FB
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // FC
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // FD
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // FE
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // FF
+};
+
+const OpcodeEntry threeByteMap3A[0x100] = {
+    { MnemonicVpermq, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // 00
+    { MnemonicVpermpd, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // 01
+    { MnemonicVpblendd, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagOperand4Ib, 0, FlowNone },    // 02
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 03
+    { MnemonicVpermilps, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // 04
+    { MnemonicVpermilpd, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // 05
+    { MnemonicVperm2f128, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagOperand4Ib, 0, FlowNone },    // 06
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 07
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 129, FlowNone },    // 08
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 130, FlowNone },    // 09
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 131, FlowNone },    // 0A
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 132, FlowNone },    // 0B
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 133, FlowNone },    // 0C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 134, FlowNone },    // 0D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 135, FlowNone },    // 0E
+    { MnemonicPalignr, { OpPx, OpQx, OpIb }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // 0F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 10
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 11
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 12
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 13
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 136, FlowNone },    // 14
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 137, FlowNone },    // 15
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 138, FlowNone },    // 16
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 139, FlowNone },    // 17
+    { MnemonicVinsertf128, { OpVx, OpHx, OpWdq }, FlagModRM | FlagVexOnly | FlagVexValid | FlagOperand4Ib, 0, FlowNone },    // 18
+    { MnemonicVextractf128, { OpWdq, OpVx, OpIb }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // 19
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 1A
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 1B
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 1C
+    { MnemonicVcvtps2ph, { OpWsd, OpVx, OpIb }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // 1D
+    { MnemonicVpcmpud, { OpKg, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide | FlagOperand4Ib, 40, FlowNone },    // 1E
+    { MnemonicVpcmpd, { OpKg, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide | FlagOperand4Ib, 41, FlowNone },    // 1F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 140, FlowNone },    // 20
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 141, FlowNone },    // 21
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 142, FlowNone },    // 22
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 23
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 24
+    { MnemonicVpternlogd, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide | FlagOperand4Ib, 39, FlowNone },    // 25
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 26
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 27
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 28
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 29
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 2A
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 2B
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 2C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 2D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 2E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 2F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 30
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 31
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 32
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 33
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 34
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 35
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 36
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 37
+    { MnemonicVinserti128, { OpVx, OpHx, OpWdq }, FlagModRM | FlagVexOnly | FlagVexValid | FlagOperand4Ib, 0, FlowNone },    // 38
+    { MnemonicVextracti128, { OpWdq, OpVx, OpIb }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // 39
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 3A
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 3B
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 3C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 3D
+    { MnemonicVpcmpub, { OpKg, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide | FlagOperand4Ib, 42, FlowNone },    // 3E
+    { MnemonicVpcmpb, { OpKg, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide | FlagOperand4Ib, 43, FlowNone },    // 3F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 143, FlowNone },    // 40
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 144, FlowNone },    // 41
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 145, FlowNone },    // 42
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 43
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 146, FlowNone },    // 44
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 45
+    { MnemonicVperm2i128, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagOperand4Ib, 0, FlowNone },    // 46
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 47
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 48
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 49
+    { MnemonicVblendvps, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagOperand4Lx, 0, FlowNone },    // 4A
+    { MnemonicVblendvpd, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagOperand4Lx, 0, FlowNone },    // 4B
+    { MnemonicVpblendvb, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagOperand4Lx, 0, FlowNone },    // 4C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 4D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 4E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 4F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 50
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 51
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 52
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 53
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 54
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 55
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 56
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 57
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 58
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 59
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 5A
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 5B
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 5C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 5D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 5E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 5F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 147, FlowNone },    // 60
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 148, FlowNone },    // 61
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 149, FlowNone },    // 62
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 150, FlowNone },    // 63
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 64
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 65
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 66
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 67
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 68
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 69
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 6A
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 6B
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 6C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 6D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 6E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 6F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 70
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 71
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 72
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 73
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 74
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 75
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 76
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 77
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 78
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 79
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 7A
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 7B
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 7C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 7D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 7E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 7F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 80
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 81
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 82
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 83
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 84
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 85
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 86
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 87
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 88
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 89
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 8A
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 8B
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 8C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 8D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 8E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 8F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 90
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 91
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 92
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 93
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 94
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 95
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 96
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 97
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 98
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 99
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 9A
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 9B
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 9C
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 9D
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 9E
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // 9F
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // A0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // A1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // A2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // A3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // A4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // A5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // A6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // A7
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // A8
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // A9
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // AA
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // AB
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // AC
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // AD
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // AE
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // AF
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // B0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // B1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // B2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // B3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // B4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // B5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // B6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // B7
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // B8
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // B9
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // BA
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // BB
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // BC
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // BD
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // BE
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // BF
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // C0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // C1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // C2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // C3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // C4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // C5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // C6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // C7
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // C8
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // C9
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // CA
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // CB
+    { MnemonicSha1rnds4, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },    // CC
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // CD
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // CE
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // CF
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // D0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // D1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // D2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // D3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // D4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // D5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // D6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // D7
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // D8
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // D9
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // DA
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // DB
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // DC
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // DD
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // DE
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, FlagPrefixed, 151, FlowNone },    // DF
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // E0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // E1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // E2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // E3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // E4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // E5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // E6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // E7
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // E8
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // E9
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // EA
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // EB
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // EC
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // ED
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // EE
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // EF
+    { MnemonicRorx, { OpGy, OpEy, OpIb }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },    // F0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // F1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // F2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // F3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // F4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // F5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // F6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // F7
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // F8
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // F9
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // FA
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // FB
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // FC
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // FD
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // FE
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // FF
+};
+
+const OpcodeEntry groupMap[][0x10] = {
+  { // 0: grp1
+    { MnemonicAdd, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /0
+    { MnemonicOr, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /1
+    { MnemonicAdc, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /2
+    { MnemonicSbb, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /3
+    { MnemonicAnd, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /4
+    { MnemonicSub, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /5
+    { MnemonicXor, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /6
+    { MnemonicCmp, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /7
+    { MnemonicAdd, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /0
+    { MnemonicOr, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /1
+    { MnemonicAdc, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /2
+    { MnemonicSbb, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /3
+    { MnemonicAnd, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /4
+    { MnemonicSub, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /5
+    { MnemonicXor, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /6
+    { MnemonicCmp, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /7
+  },
+  { // 1: grp1a
+    { MnemonicPop, { OpEv, OpNone, OpNone }, FlagDefault64 | FlagModRM, 0, FlowNone },    // mem /0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /7
+    { MnemonicPop, { OpEv, OpNone, OpNone }, FlagDefault64 | FlagModRM, 0, FlowNone },    // reg /0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /7
+  },
+  { // 2: grp2
+    { MnemonicRol, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /0
+    { MnemonicRor, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /1
+    { MnemonicRcl, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /2
+    { MnemonicRcr, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /3
+    { MnemonicShl, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /4
+    { MnemonicShr, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /5
+    { MnemonicSal, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /6
+    { MnemonicSar, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /7
+    { MnemonicRol, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /0
+    { MnemonicRor, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /1
+    { MnemonicRcl, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /2
+    { MnemonicRcr, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /3
+    { MnemonicShl, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /4
+    { MnemonicShr, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /5
+    { MnemonicSal, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /6
+    { MnemonicSar, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /7
+  },
+  { // 3: grp11b
+    { MnemonicMov, { OpEb, OpIb, OpNone }, FlagModRM, 0, FlowNone },    // mem /0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /7
+    { MnemonicMov, { OpEb, OpIb, OpNone }, FlagModRM, 0, FlowNone },    // reg /0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /6
+    { MnemonicXabort, { OpIb, OpNone, OpNone }, 0, 0, FlowNone },    // reg /7
+  },
+  { // 4: grp11v
+    { MnemonicMov, { OpEv, OpIz, OpNone }, FlagModRM, 0, FlowNone },    // mem /0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /7
+    { MnemonicMov, { OpEv, OpIz, OpNone }, FlagModRM, 0, FlowNone },    // reg /0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /6
+    { MnemonicXbegin, { OpJz, OpNone, OpNone }, 0, 0, FlowBranch },    // reg /7
+  },
+  { // 5: x87_D8
+    { MnemonicFadd, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /0
+    { MnemonicFmul, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /1
+    { MnemonicFcom, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /2
+    { MnemonicFcomp, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /3
+    { MnemonicFsub, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /4
+    { MnemonicFsubr, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /5
+    { MnemonicFdiv, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /6
+    { MnemonicFdivr, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /7
+    { MnemonicFadd, { OpST, OpSTi, OpNone }, FlagModRM, 0, FlowNone },    // reg /0
+    { MnemonicFmul, { OpST, OpSTi, OpNone }, FlagModRM, 0, FlowNone },    // reg /1
+    { MnemonicFcom, { OpST, OpSTi, OpNone }, FlagModRM, 0, FlowNone },    // reg /2
+    { MnemonicFcomp, { OpST, OpSTi, OpNone }, FlagModRM, 0, FlowNone },    // reg /3
+    { MnemonicFsub, { OpST, OpSTi, OpNone }, FlagModRM, 0, FlowNone },    // reg /4
+    { MnemonicFsubr, { OpST, OpSTi, OpNone }, FlagModRM, 0, FlowNone },    // reg /5
+    { MnemonicFdiv, { OpST, OpSTi, OpNone }, FlagModRM, 0, FlowNone },    // reg /6
+    { MnemonicFdivr, { OpST, OpSTi, OpNone }, FlagModRM, 0, FlowNone },    // reg /7
+  },
+  { // 6: x87_D9
+    { MnemonicFld, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /1
+    { MnemonicFst, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /2
+    { MnemonicFstp, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /3
+    { MnemonicFldenv, { OpM, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /4
+    { MnemonicFldcw, { OpMw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /5
+    { MnemonicFnstenv, { OpM, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /6
+    { MnemonicFnstcw, { OpMw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /7
+    { MnemonicFld, { OpSTi, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /0
+    { MnemonicFxch, { OpSTi, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /7
+  },
+  { // 7: x87_DA
+    { MnemonicFiadd, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /0
+    { MnemonicFimul, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /1
+    { MnemonicFicom, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /2
+    { MnemonicFicomp, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /3
+    { MnemonicFisub, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /4
+    { MnemonicFisubr, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /5
+    { MnemonicFidiv, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /6
+    { MnemonicFidivr, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /7
+    { MnemonicFcmovb, { OpST, OpSTi, OpNone }, FlagModRM, 0, FlowNone },    // reg /0
+    { MnemonicFcmove, { OpST, OpSTi, OpNone }, FlagModRM, 0, FlowNone },    // reg /1
+    { MnemonicFcmovbe, { OpST, OpSTi, OpNone }, FlagModRM, 0, FlowNone },    // reg /2
+    { MnemonicFcmovu, { OpST, OpSTi, OpNone }, FlagModRM, 0, FlowNone },    // reg /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /7
+  },
+  { // 8: x87_DB
+    { MnemonicFild, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /0
+    { MnemonicFisttp, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /1
+    { MnemonicFist, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /2
+    { MnemonicFistp, { OpMd, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /4
+    { MnemonicFld, { OpMt, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /6
+    { MnemonicFstp, { OpMt, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /7
+    { MnemonicFcmovnb, { OpST, OpSTi, OpNone }, FlagModRM, 0, FlowNone },    // reg /0
+    { MnemonicFcmovne, { OpST, OpSTi, OpNone }, FlagModRM, 0, FlowNone },    // reg /1
+    { MnemonicFcmovnbe, { OpST, OpSTi, OpNone }, FlagModRM, 0, FlowNone },    // reg /2
+    { MnemonicFcmovnu, { OpST, OpSTi, OpNone }, FlagModRM, 0, FlowNone },    // reg /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /4
+    { MnemonicFucomi, { OpST, OpSTi, OpNone }, FlagModRM, 0, FlowNone },    // reg /5
+    { MnemonicFcomi, { OpST, OpSTi, OpNone }, FlagModRM, 0, FlowNone },    // reg /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /7
+  },
+  { // 9: x87_DC
+    { MnemonicFadd, { OpMq, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /0
+    { MnemonicFmul, { OpMq, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /1
+    { MnemonicFcom, { OpMq, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /2
+    { MnemonicFcomp, { OpMq, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /3
+    { MnemonicFsub, { OpMq, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /4
+    { MnemonicFsubr, { OpMq, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /5
+    { MnemonicFdiv, { OpMq, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /6
+    { MnemonicFdivr, { OpMq, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /7
+    { MnemonicFadd, { OpSTi, OpST, OpNone }, FlagModRM, 0, FlowNone },    // reg /0
+    { MnemonicFmul, { OpSTi, OpST, OpNone }, FlagModRM, 0, FlowNone },    // reg /1
+    { MnemonicFcom, { OpSTi, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /2
+    { MnemonicFcomp, { OpSTi, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /3
+    { MnemonicFsubr, { OpSTi, OpST, OpNone }, FlagModRM, 0, FlowNone },    // reg /4
+    { MnemonicFsub, { OpSTi, OpST, OpNone }, FlagModRM, 0, FlowNone },    // reg /5
+    { MnemonicFdivr, { OpSTi, OpST, OpNone }, FlagModRM, 0, FlowNone },    // reg /6
+    { MnemonicFdiv, { OpSTi, OpST, OpNone }, FlagModRM, 0, FlowNone },    // reg /7
+  },
+  { // 10: x87_DD
+    { MnemonicFld, { OpMq, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /0
+    { MnemonicFisttp, { OpMq, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /1
+    { MnemonicFst, { OpMq, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /2
+    { MnemonicFstp, { OpMq, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /3
+    { MnemonicFrstor, { OpM, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /5
+    { MnemonicFnsave, { OpM, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /6
+    { MnemonicFnstsw, { OpMw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /7
+    { MnemonicFfree, { OpSTi, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /1
+    { MnemonicFst, { OpSTi, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /2
+    { MnemonicFstp, { OpSTi, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /3
+    { MnemonicFucom, { OpSTi, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /4
+    { MnemonicFucomp, { OpSTi, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /7
+  },
+  { // 11: x87_DE
+    { MnemonicFiadd, { OpMw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /0
+    { MnemonicFimul, { OpMw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /1
+    { MnemonicFicom, { OpMw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /2
+    { MnemonicFicomp, { OpMw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /3
+    { MnemonicFisub, { OpMw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /4
+    { MnemonicFisubr, { OpMw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /5
+    { MnemonicFidiv, { OpMw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /6
+    { MnemonicFidivr, { OpMw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /7
+    { MnemonicFaddp, { OpSTi, OpST, OpNone }, FlagModRM, 0, FlowNone },    // reg /0
+    { MnemonicFmulp, { OpSTi, OpST, OpNone }, FlagModRM, 0, FlowNone },    // reg /1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /3
+    { MnemonicFsubrp, { OpSTi, OpST, OpNone }, FlagModRM, 0, FlowNone },    // reg /4
+    { MnemonicFsubp, { OpSTi, OpST, OpNone }, FlagModRM, 0, FlowNone },    // reg /5
+    { MnemonicFdivrp, { OpSTi, OpST, OpNone }, FlagModRM, 0, FlowNone },    // reg /6
+    { MnemonicFdivp, { OpSTi, OpST, OpNone }, FlagModRM, 0, FlowNone },    // reg /7
+  },
+  { // 12: x87_DF
+    { MnemonicFild, { OpMw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /0
+    { MnemonicFisttp, { OpMw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /1
+    { MnemonicFist, { OpMw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /2
+    { MnemonicFistp, { OpMw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /3
+    { MnemonicFbld, { OpMt, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /4
+    { MnemonicFild, { OpMq, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /5
+    { MnemonicFbstp, { OpMt, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /6
+    { MnemonicFistp, { OpMq, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /7
+    { MnemonicFfreep, { OpSTi, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /4
+    { MnemonicFucomip, { OpST, OpSTi, OpNone }, FlagModRM, 0, FlowNone },    // reg /5
+    { MnemonicFcomip, { OpST, OpSTi, OpNone }, FlagModRM, 0, FlowNone },    // reg /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /7
+  },
+  { // 13: grp3b
+    { MnemonicTest, { OpEb, OpIb, OpNone }, FlagModRM, 0, FlowNone },    // mem /0
+    { MnemonicTest, { OpEb, OpIb, OpNone }, FlagModRM, 0, FlowNone },    // mem /1
+    { MnemonicNot, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /2
+    { MnemonicNeg, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /3
+    { MnemonicMul, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /4
+    { MnemonicImul, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /5
+    { MnemonicDiv, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /6
+    { MnemonicIdiv, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /7
+    { MnemonicTest, { OpEb, OpIb, OpNone }, FlagModRM, 0, FlowNone },    // reg /0
+    { MnemonicTest, { OpEb, OpIb, OpNone }, FlagModRM, 0, FlowNone },    // reg /1
+    { MnemonicNot, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /2
+    { MnemonicNeg, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /3
+    { MnemonicMul, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /4
+    { MnemonicImul, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /5
+    { MnemonicDiv, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /6
+    { MnemonicIdiv, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /7
+  },
+  { // 14: grp3v
+    { MnemonicTest, { OpEv, OpIz, OpNone }, FlagModRM, 0, FlowNone },    // mem /0
+    { MnemonicTest, { OpEv, OpIz, OpNone }, FlagModRM, 0, FlowNone },    // mem /1
+    { MnemonicNot, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /2
+    { MnemonicNeg, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /3
+    { MnemonicMul, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /4
+    { MnemonicImul, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /5
+    { MnemonicDiv, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /6
+    { MnemonicIdiv, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /7
+    { MnemonicTest, { OpEv, OpIz, OpNone }, FlagModRM, 0, FlowNone },    // reg /0
+    { MnemonicTest, { OpEv, OpIz, OpNone }, FlagModRM, 0, FlowNone },    // reg /1
+    { MnemonicNot, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /2
+    { MnemonicNeg, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /3
+    { MnemonicMul, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /4
+    { MnemonicImul, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /5
+    { MnemonicDiv, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /6
+    { MnemonicIdiv, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /7
+  },
+  { // 15: grp4
+    { MnemonicInc, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /0
+    { MnemonicDec, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /7
+    { MnemonicInc, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /0
+    { MnemonicDec, { OpEb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /7
+  },
+  { // 16: grp5
+    { MnemonicInc, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /0
+    { MnemonicDec, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /1
+    { MnemonicCall, { OpEv, OpNone, OpNone }, FlagForce64 | FlagModRM, 0, FlowCall },    // mem /2
+    { MnemonicCall, { OpMp, OpNone, OpNone }, FlagModRM, 0, FlowCall },    // mem /3
+    { MnemonicJmp, { OpEv, OpNone, OpNone }, FlagForce64 | FlagModRM, 0, FlowJump },    // mem /4
+    { MnemonicJmp, { OpMp, OpNone, OpNone }, FlagModRM, 0, FlowJump },    // mem /5
+    { MnemonicPush, { OpEv, OpNone, OpNone }, FlagDefault64 | FlagModRM, 0, FlowNone },    // mem /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /7
+    { MnemonicInc, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /0
+    { MnemonicDec, { OpEv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /1
+    { MnemonicCall, { OpEv, OpNone, OpNone }, FlagForce64 | FlagModRM, 0, FlowCall },    // reg /2
+    { MnemonicCall, { OpMp, OpNone, OpNone }, FlagModRM, 0, FlowCall },    // reg /3
+    { MnemonicJmp, { OpEv, OpNone, OpNone }, FlagForce64 | FlagModRM, 0, FlowJump },    // reg /4
+    { MnemonicJmp, { OpMp, OpNone, OpNone }, FlagModRM, 0, FlowJump },    // reg /5
+    { MnemonicPush, { OpEv, OpNone, OpNone }, FlagDefault64 | FlagModRM, 0, FlowNone },    // reg /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /7
+  },
+  { // 17: grp6
+    { MnemonicSldt, { OpMw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /0
+    { MnemonicStr, { OpMw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /1
+    { MnemonicLldt, { OpEw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /2
+    { MnemonicLtr, { OpEw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /3
+    { MnemonicVerr, { OpEw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /4
+    { MnemonicVerw, { OpEw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /7
+    { MnemonicSldt, { OpRv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /0
+    { MnemonicStr, { OpRv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /1
+    { MnemonicLldt, { OpEw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /2
+    { MnemonicLtr, { OpEw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /3
+    { MnemonicVerr, { OpEw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /4
+    { MnemonicVerw, { OpEw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /7
+  },
+  { // 18: grp7
+    { MnemonicSgdt, { OpMp, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /0
+    { MnemonicSidt, { OpMp, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /1
+    { MnemonicLgdt, { OpMp, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /2
+    { MnemonicLidt, { OpMp, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /3
+    { MnemonicSmsw, { OpMw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /5
+    { MnemonicLmsw, { OpEw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /6
+    { MnemonicInvlpg, { OpMb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /7
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /3
+    { MnemonicSmsw, { OpRv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /5
+    { MnemonicLmsw, { OpEw, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /7
+  },
+  { // 19: grpP
+    { MnemonicPrefetch, { OpMb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /0
+    { MnemonicPrefetchw, { OpMb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /1
+    { MnemonicPrefetchwt1, { OpMb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /7
+    { MnemonicPrefetch, { OpMb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /0
+    { MnemonicPrefetchw, { OpMb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /1
+    { MnemonicPrefetchwt1, { OpMb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /7
+  },
+  { // 20: grp16
+    { MnemonicPrefetchnta, { OpMb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /0
+    { MnemonicPrefetcht0, { OpMb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /1
+    { MnemonicPrefetcht1, { OpMb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /2
+    { MnemonicPrefetcht2, { OpMb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /7
+    { MnemonicPrefetchnta, { OpMb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /0
+    { MnemonicPrefetcht0, { OpMb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /1
+    { MnemonicPrefetcht1, { OpMb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /2
+    { MnemonicPrefetcht2, { OpMb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /7
+  },
+  { // 21: grp12
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /1
+    { MnemonicPsrlw, { OpNx, OpIb, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // mem /2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /3
+    { MnemonicPsraw, { OpNx, OpIb, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // mem /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /5
+    { MnemonicPsllw, { OpNx, OpIb, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // mem /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /7
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /1
+    { MnemonicPsrlw, { OpNx, OpIb, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // reg /2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /3
+    { MnemonicPsraw, { OpNx, OpIb, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // reg /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /5
+    { MnemonicPsllw, { OpNx, OpIb, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // reg /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /7
+  },
+  { // 22: grp13
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /1
+    { MnemonicPsrld, { OpNx, OpIb, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // mem /2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /3
+    { MnemonicPsrad, { OpNx, OpIb, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // mem /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /5
+    { MnemonicPslld, { OpNx, OpIb, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // mem /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /7
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /1
+    { MnemonicPsrld, { OpNx, OpIb, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // reg /2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /3
+    { MnemonicPsrad, { OpNx, OpIb, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // reg /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /5
+    { MnemonicPslld, { OpNx, OpIb, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // reg /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /7
+  },
+  { // 23: grp14
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /1
+    { MnemonicPsrlq, { OpNx, OpIb, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // mem /2
+    { MnemonicPsrldq, { OpNx, OpIb, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // mem /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /5
+    { MnemonicPsllq, { OpNx, OpIb, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // mem /6
+    { MnemonicPslldq, { OpNx, OpIb, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // mem /7
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /1
+    { MnemonicPsrlq, { OpNx, OpIb, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // reg /2
+    { MnemonicPsrldq, { OpNx, OpIb, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // reg /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /5
+    { MnemonicPsllq, { OpNx, OpIb, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // reg /6
+    { MnemonicPslldq, { OpNx, OpIb, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // reg /7
+  },
+  { // 24: grp15
+    { MnemonicFxsave, { OpM, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /0
+    { MnemonicFxrstor, { OpM, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /1
+    { MnemonicLdmxcsr, { OpMd, OpNone, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // mem /2
+    { MnemonicStmxcsr, { OpMd, OpNone, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // mem /3
+    { MnemonicXsave, { OpM, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /4
+    { MnemonicXrstor, { OpM, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /5
+    { MnemonicXsaveopt, { OpM, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /6
+    { MnemonicClflush, { OpMb, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /7
+    { MnemonicRdfsbase, { OpRy, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /0
+    { MnemonicRdgsbase, { OpRy, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /1
+    { MnemonicWrfsbase, { OpRy, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /2
+    { MnemonicWrgsbase, { OpRy, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /4
+    { MnemonicLfence, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /5
+    { MnemonicMfence, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /6
+    { MnemonicSfence, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /7
+  },
+  { // 25: grp8
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /3
+    { MnemonicBt, { OpEv, OpIb, OpNone }, FlagModRM, 0, FlowNone },    // mem /4
+    { MnemonicBts, { OpEv, OpIb, OpNone }, FlagModRM, 0, FlowNone },    // mem /5
+    { MnemonicBtr, { OpEv, OpIb, OpNone }, FlagModRM, 0, FlowNone },    // mem /6
+    { MnemonicBtc, { OpEv, OpIb, OpNone }, FlagModRM, 0, FlowNone },    // mem /7
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /3
+    { MnemonicBt, { OpEv, OpIb, OpNone }, FlagModRM, 0, FlowNone },    // reg /4
+    { MnemonicBts, { OpEv, OpIb, OpNone }, FlagModRM, 0, FlowNone },    // reg /5
+    { MnemonicBtr, { OpEv, OpIb, OpNone }, FlagModRM, 0, FlowNone },    // reg /6
+    { MnemonicBtc, { OpEv, OpIb, OpNone }, FlagModRM, 0, FlowNone },    // reg /7
+  },
+  { // 26: grp9
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /0
+    { MnemonicCmpxchg8b, { OpMq, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /2
+    { MnemonicXrstors, { OpM, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /3
+    { MnemonicXsavec, { OpM, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /4
+    { MnemonicXsaves, { OpM, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /5
+    { MnemonicVmptrld, { OpMq, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /6
+    { MnemonicVmptrst, { OpMq, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // mem /7
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /0
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /1
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /2
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /5
+    { MnemonicRdrand, { OpRv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /6
+    { MnemonicRdseed, { OpRv, OpNone, OpNone }, FlagModRM, 0, FlowNone },    // reg /7
+  },
+  { // 27: grpBmi
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /0
+    { MnemonicBlsr, { OpBy, OpEy, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // mem /1
+    { MnemonicBlsmsk, { OpBy, OpEy, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // mem /2
+    { MnemonicBlsi, { OpBy, OpEy, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // mem /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // mem /7
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /0
+    { MnemonicBlsr, { OpBy, OpEy, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // reg /1
+    { MnemonicBlsmsk, { OpBy, OpEy, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // reg /2
+    { MnemonicBlsi, { OpBy, OpEy, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },    // reg /3
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /4
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /5
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /6
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },    // reg /7
+  },
+};
+
+// none, 66, F3, F2
+const OpcodeEntry prefixedMap[][4] = {
+  {
+    { MnemonicMovups, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicMovupd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicMovss, { OpVx, OpWss, OpNone }, FlagModRM | FlagVexNdsRegister | FlagVexValid, 0, FlowNone },
+    { MnemonicMovsd, { OpVx, OpWsd, OpNone }, FlagModRM | FlagVexNdsRegister | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicMovups, { OpWx, OpVx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicMovupd, { OpWx, OpVx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicMovss, { OpWss, OpVx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicMovsd, { OpWsd, OpVx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicMovlps, { OpVx, OpWsd, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicMovlpd, { OpVx, OpMq, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicMovsldup, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicMovddup, { OpVx, OpWsd, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicMovlps, { OpMq, OpVx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicMovlpd, { OpMq, OpVx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicUnpcklps, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicUnpcklpd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicUnpckhps, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicUnpckhpd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicMovhps, { OpVx, OpWsd, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicMovhpd, { OpVx, OpMq, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicMovshdup, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicMovhps, { OpMq, OpVx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicMovhpd, { OpMq, OpVx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicMovaps, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicMovapd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicMovaps, { OpWx, OpVx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicMovapd, { OpWx, OpVx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicCvtpi2ps, { OpVx, OpQq, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicCvtpi2pd, { OpVx, OpQq, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicCvtsi2ss, { OpVx, OpEy, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicCvtsi2sd, { OpVx, OpEy, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicMovntps, { OpMx, OpVx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicMovntpd, { OpMx, OpVx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicCvttps2pi, { OpPq, OpWsd, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicCvttpd2pi, { OpPq, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicCvttss2si, { OpGy, OpWss, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicCvttsd2si, { OpGy, OpWsd, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicCvtps2pi, { OpPq, OpWsd, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicCvtpd2pi, { OpPq, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicCvtss2si, { OpGy, OpWss, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicCvtsd2si, { OpGy, OpWsd, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicUcomiss, { OpVx, OpWss, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicUcomisd, { OpVx, OpWsd, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicComiss, { OpVx, OpWss, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicComisd, { OpVx, OpWsd, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicMovmskps, { OpGd, OpUx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicMovmskpd, { OpGd, OpUx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicSqrtps, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicSqrtpd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicSqrtss, { OpVx, OpWss, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicSqrtsd, { OpVx, OpWsd, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicRsqrtps, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicRsqrtss, { OpVx, OpWss, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicRcpps, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicRcpss, { OpVx, OpWss, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicAndps, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicAndpd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicAndnps, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicAndnpd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicOrps, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicOrpd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicXorps, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicXorpd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicAddps, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicAddpd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicAddss, { OpVx, OpWss, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicAddsd, { OpVx, OpWsd, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicMulps, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicMulpd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicMulss, { OpVx, OpWss, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicMulsd, { OpVx, OpWsd, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicCvtps2pd, { OpVx, OpWsd, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicCvtpd2ps, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicCvtss2sd, { OpVx, OpWss, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicCvtsd2ss, { OpVx, OpWsd, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicCvtdq2ps, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicCvtps2dq, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicCvttps2dq, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicSubps, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicSubpd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicSubss, { OpVx, OpWss, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicSubsd, { OpVx, OpWsd, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicMinps, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicMinpd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicMinss, { OpVx, OpWss, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicMinsd, { OpVx, OpWsd, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicDivps, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicDivpd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicDivss, { OpVx, OpWss, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicDivsd, { OpVx, OpWsd, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicMaxps, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicMaxpd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicMaxss, { OpVx, OpWss, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicMaxsd, { OpVx, OpWsd, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPunpcklqdq, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPunpckhqdq, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicMovd, { OpPq, OpEy, OpNone }, FlagModRM, 0, FlowNone },
+    { MnemonicMovd, { OpVx, OpEy, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicMovq, { OpPq, OpQq, OpNone }, FlagModRM, 0, FlowNone },
+    { MnemonicMovdqa, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicMovdqu, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicVmovdqu8, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicPshufw, { OpPq, OpQq, OpIb }, FlagModRM, 0, FlowNone },
+    { MnemonicPshufd, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicPshufhw, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicPshuflw, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicHaddpd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicHaddps, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicHsubpd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicHsubps, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicMovd, { OpEy, OpPq, OpNone }, FlagModRM, 0, FlowNone },
+    { MnemonicMovd, { OpEy, OpVx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicMovq, { OpVx, OpWsd, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicMovq, { OpQq, OpPq, OpNone }, FlagModRM, 0, FlowNone },
+    { MnemonicMovdqa, { OpWx, OpVx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicMovdqu, { OpWx, OpVx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicVmovdqu8, { OpWx, OpVx, OpNone }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPopcnt, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicBsf, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicTzcnt, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicBsr, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicLzcnt, { OpGv, OpEv, OpNone }, FlagModRM, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicCmpps, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicCmppd, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicCmpss, { OpVx, OpWss, OpIb }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicCmpsd, { OpVx, OpWsd, OpIb }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicMovnti, { OpMy, OpGy, OpNone }, FlagModRM, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicPinsrw, { OpPq, OpEd, OpIb }, FlagModRM, 0, FlowNone },
+    { MnemonicPinsrw, { OpVx, OpEd, OpIb }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicPextrw, { OpGd, OpNq, OpIb }, FlagModRM, 0, FlowNone },
+    { MnemonicPextrw, { OpGd, OpUx, OpIb }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicShufps, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicShufpd, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicAddsubpd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicAddsubps, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicMovq, { OpWsd, OpVx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicPmovmskb, { OpGd, OpNq, OpNone }, FlagModRM, 0, FlowNone },
+    { MnemonicPmovmskb, { OpGd, OpUx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicCvttpd2dq, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicCvtdq2pd, { OpVx, OpWsd, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicCvtpd2dq, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicMovntq, { OpMq, OpPq, OpNone }, FlagModRM, 0, FlowNone },
+    { MnemonicMovntdq, { OpMx, OpVx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicLddqu, { OpVx, OpMx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicMaskmovq, { OpPq, OpNq, OpNone }, FlagModRM, 0, FlowNone },
+    { MnemonicMaskmovdqu, { OpVx, OpUx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPblendvb, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicBlendvps, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicBlendvpd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPtest, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPmovsxbw, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPmovsxbd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPmovsxbq, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPmovsxwd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPmovsxwq, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPmovsxdq, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVptestmb, { OpKg, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 34, FlowNone },
+    { MnemonicVptestnmb, { OpKg, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 35, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVptestmd, { OpKg, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 36, FlowNone },
+    { MnemonicVptestnmd, { OpKg, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 37, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPmuldq, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPcmpeqq, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid | FlagEvexMask, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicMovntdqa, { OpVx, OpMx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPackusdw, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPmovzxbw, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPmovzxbd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPmovzxbq, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPmovzxwd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPmovzxwq, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPmovzxdq, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPcmpgtq, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid | FlagEvexMask, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPminsb, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPminsd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPminuw, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPminud, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPmaxsb, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPmaxsd, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPmaxuw, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPmaxud, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPmulld, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPhminposuw, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfmaddsub132ps, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfmsubadd132ps, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 1, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfmadd132ps, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 2, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfmadd132ss, { OpVx, OpHx, OpWsx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 3, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfmsub132ps, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 4, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfmsub132ss, { OpVx, OpHx, OpWsx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 5, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfnmadd132ps, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 6, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfnmadd132ss, { OpVx, OpHx, OpWsx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 7, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfnmsub132ps, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 8, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfnmsub132ss, { OpVx, OpHx, OpWsx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 9, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfmaddsub213ps, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 10, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfmsubadd213ps, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 11, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfmadd213ps, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 12, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfmadd213ss, { OpVx, OpHx, OpWsx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 13, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfmsub213ps, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 14, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfmsub213ss, { OpVx, OpHx, OpWsx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 15, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfnmadd213ps, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 16, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfnmadd213ss, { OpVx, OpHx, OpWsx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 17, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfnmsub213ps, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 18, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfnmsub213ss, { OpVx, OpHx, OpWsx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 19, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfmaddsub231ps, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 20, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfmsubadd231ps, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 21, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfmadd231ps, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 22, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfmadd231ss, { OpVx, OpHx, OpWsx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 23, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfmsub231ps, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 24, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfmsub231ss, { OpVx, OpHx, OpWsx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 25, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfnmadd231ps, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 26, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfnmadd231ss, { OpVx, OpHx, OpWsx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 27, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfnmsub231ps, { OpVx, OpHx, OpWx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 28, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicVfnmsub231ss, { OpVx, OpHx, OpWsx }, FlagModRM | FlagVexOnly | FlagVexValid | FlagVexWide, 29, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicAesimc, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicAesenc, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicAesenclast, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicAesdec, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicAesdeclast, { OpVx, OpWx, OpNone }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicMovbe, { OpGv, OpMv, OpNone }, FlagModRM, 0, FlowNone },
+    { MnemonicMovbe, { OpGv, OpMv, OpNone }, FlagModRM, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicCrc32, { OpGd, OpEb, OpNone }, FlagModRM, 0, FlowNone },
+  },
+  {
+    { MnemonicMovbe, { OpMv, OpGv, OpNone }, FlagModRM, 0, FlowNone },
+    { MnemonicMovbe, { OpMv, OpGv, OpNone }, FlagModRM, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicCrc32, { OpGy, OpEv, OpNone }, FlagModRM, 0, FlowNone },
+  },
+  {
+    { MnemonicBzhi, { OpGy, OpEy, OpBy }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPext, { OpGy, OpBy, OpEy }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },
+    { MnemonicPdep, { OpGy, OpBy, OpEy }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicAdcx, { OpGy, OpEy, OpNone }, FlagModRM, 0, FlowNone },
+    { MnemonicAdox, { OpGy, OpEy, OpNone }, FlagModRM, 0, FlowNone },
+    { MnemonicMulx, { OpGy, OpBy, OpEy }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicBextr, { OpGy, OpEy, OpBy }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },
+    { MnemonicShlx, { OpGy, OpEy, OpBy }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },
+    { MnemonicSarx, { OpGy, OpEy, OpBy }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },
+    { MnemonicShrx, { OpGy, OpEy, OpBy }, FlagModRM | FlagVexOnly | FlagVexValid, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicRoundps, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicRoundpd, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicRoundss, { OpVx, OpWss, OpIb }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicRoundsd, { OpVx, OpWsd, OpIb }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicBlendps, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicBlendpd, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPblendw, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPextrb, { OpEb, OpVx, OpIb }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPextrw, { OpEw, OpVx, OpIb }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPextrd, { OpEy, OpVx, OpIb }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicExtractps, { OpEd, OpVx, OpIb }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPinsrb, { OpVx, OpEb, OpIb }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInsertps, { OpVx, OpWss, OpIb }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPinsrd, { OpVx, OpEy, OpIb }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicDpps, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicDppd, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicMpsadbw, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPclmulqdq, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexNds | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPcmpestrm, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPcmpestri, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPcmpistrm, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicPcmpistri, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+  {
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicAeskeygenassist, { OpVx, OpWx, OpIb }, FlagModRM | FlagVexValid, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+    { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone },
+  },
+};
+
+const unsigned short vexWideMnemonics[] = {
+    MnemonicVfmaddsub132pd,
+    MnemonicVfmsubadd132pd,
+    MnemonicVfmadd132pd,
+    MnemonicVfmadd132sd,
+    MnemonicVfmsub132pd,
+    MnemonicVfmsub132sd,
+    MnemonicVfnmadd132pd,
+    MnemonicVfnmadd132sd,
+    MnemonicVfnmsub132pd,
+    MnemonicVfnmsub132sd,
+    MnemonicVfmaddsub213pd,
+    MnemonicVfmsubadd213pd,
+    MnemonicVfmadd213pd,
+    MnemonicVfmadd213sd,
+    MnemonicVfmsub213pd,
+    MnemonicVfmsub213sd,
+    MnemonicVfnmadd213pd,
+    MnemonicVfnmadd213sd,
+    MnemonicVfnmsub213pd,
+    MnemonicVfnmsub213sd,
+    MnemonicVfmaddsub231pd,
+    MnemonicVfmsubadd231pd,
+    MnemonicVfmadd231pd,
+    MnemonicVfmadd231sd,
+    MnemonicVfmsub231pd,
+    MnemonicVfmsub231sd,
+    MnemonicVfnmadd231pd,
+    MnemonicVfnmadd231sd,
+    MnemonicVfnmsub231pd,
+    MnemonicVfnmsub231sd,
+    MnemonicVpsrlvq,
+    MnemonicVpsllvq,
+    MnemonicVpmaskmovq,
+    MnemonicVpmaskmovq,
+    MnemonicVptestmw,
+    MnemonicVptestnmw,
+    MnemonicVptestmq,
+    MnemonicVptestnmq,
+    MnemonicVpbroadcastq,
+    MnemonicVpternlogq,
+    MnemonicVpcmpuq,
+    MnemonicVpcmpq,
+    MnemonicVpcmpuw,
+    MnemonicVpcmpw
+};
+
+// EVEX.W0 and EVEX.W1 mnemonics
+const unsigned short evexWideMnemonics[][2] = {
+    { MnemonicVpandd, MnemonicVpandq },
+    { MnemonicVpandnd, MnemonicVpandnq },
+    { MnemonicVpord, MnemonicVporq },
+    { MnemonicVpxord, MnemonicVpxorq }
+};
+
+// b, w, d, q
+const MaskOpcode maskOpcodeMap[] = {
+    { 0x41, { OpKg, OpKh, OpKr }, { MnemonicKandb, MnemonicKandw, MnemonicKandd, MnemonicKandq } },
+    { 0x42, { OpKg, OpKh, OpKr }, { MnemonicKandnb, MnemonicKandnw, MnemonicKandnd, MnemonicKandnq } },
+    { 0x44, { OpKg, OpKr, OpNone }, { MnemonicKnotb, MnemonicKnotw, MnemonicKnotd, MnemonicKnotq } },
+    { 0x45, { OpKg, OpKh, OpKr }, { MnemonicKorb, MnemonicKorw, MnemonicKord, MnemonicKorq } },
+    { 0x46, { OpKg, OpKh, OpKr }, { MnemonicKxnorb, MnemonicKxnorw, MnemonicKxnord, MnemonicKxnorq } },
+    { 0x47, { OpKg, OpKh, OpKr }, { MnemonicKxorb, MnemonicKxorw, MnemonicKxord, MnemonicKxorq } },
+    { 0x4A, { OpKg, OpKh, OpKr }, { MnemonicKaddb, MnemonicKaddw, MnemonicKaddd, MnemonicKaddq } },
+    { 0x4B, { OpKg, OpKh, OpKr }, { MnemonicKunpckbw, MnemonicKunpckwd, MnemonicInvalid, MnemonicKunpckdq } },
+    { 0x90, { OpKg, OpKe, OpNone }, { MnemonicKmovb, MnemonicKmovw, MnemonicKmovd, MnemonicKmovq } },
+    { 0x91, { OpKe, OpKg, OpNone }, { MnemonicKmovb, MnemonicKmovw, MnemonicKmovd, MnemonicKmovq } },
+    { 0x92, { OpKg, OpEy, OpNone }, { MnemonicKmovb, MnemonicKmovw, MnemonicKmovd, MnemonicKmovq } },
+    { 0x93, { OpGy, OpKr, OpNone }, { MnemonicKmovb, MnemonicKmovw, MnemonicKmovd, MnemonicKmovq } },
+    { 0x98, { OpKg, OpKr, OpNone }, { MnemonicKortestb, MnemonicKortestw, MnemonicKortestd, MnemonicKortestq } },
+    { 0x99, { OpKg, OpKr, OpNone }, { MnemonicKtestb, MnemonicKtestw, MnemonicKtestd, MnemonicKtestq } },
+};
+
+// ps, pd, ss, sd
+const unsigned short cmpPredicateMnemonics[8][4] = {
+    { MnemonicCmpeqps, MnemonicCmpeqpd, MnemonicCmpeqss, MnemonicCmpeqsd },
+    { MnemonicCmpltps, MnemonicCmpltpd, MnemonicCmpltss, MnemonicCmpltsd },
+    { MnemonicCmpleps, MnemonicCmplepd, MnemonicCmpless, MnemonicCmplesd },
+    { MnemonicCmpunordps, MnemonicCmpunordpd, MnemonicCmpunordss, MnemonicCmpunordsd },
+    { MnemonicCmpneqps, MnemonicCmpneqpd, MnemonicCmpneqss, MnemonicCmpneqsd },
+    { MnemonicCmpnltps, MnemonicCmpnltpd, MnemonicCmpnltss, MnemonicCmpnltsd },
+    { MnemonicCmpnleps, MnemonicCmpnlepd, MnemonicCmpnless, MnemonicCmpnlesd },
+    { MnemonicCmpordps, MnemonicCmpordpd, MnemonicCmpordss, MnemonicCmpordsd },
+};
+
+const unsigned short group7Register[8][8] = {
+    { MnemonicInvalid, MnemonicVmcall, MnemonicVmlaunch, MnemonicVmresume, MnemonicVmxoff, MnemonicInvalid, MnemonicInvalid, MnemonicInvalid },
+    { MnemonicMonitor, MnemonicMwait, MnemonicClac, MnemonicStac, MnemonicInvalid, MnemonicInvalid, MnemonicInvalid, MnemonicEncls },
+    { MnemonicXgetbv, MnemonicXsetbv, MnemonicInvalid, MnemonicInvalid, MnemonicVmfunc, MnemonicXend, MnemonicXtest, MnemonicEnclu },
+    { MnemonicVmrun, MnemonicVmmcall, MnemonicVmload, MnemonicVmsave, MnemonicStgi, MnemonicClgi, MnemonicSkinit, MnemonicInvlpga },
+    { MnemonicInvalid, MnemonicInvalid, MnemonicInvalid, MnemonicInvalid, MnemonicInvalid, MnemonicInvalid, MnemonicInvalid, MnemonicInvalid },
+    { MnemonicInvalid, MnemonicInvalid, MnemonicInvalid, MnemonicInvalid, MnemonicInvalid, MnemonicInvalid, MnemonicRdpkru, MnemonicWrpkru },
+    { MnemonicInvalid, MnemonicInvalid, MnemonicInvalid, MnemonicInvalid, MnemonicInvalid, MnemonicInvalid, MnemonicInvalid, MnemonicInvalid },
+    { MnemonicSwapgs, MnemonicRdtscp, MnemonicMonitorx, MnemonicMwaitx, MnemonicClzero, MnemonicRdpru, MnemonicInvalid, MnemonicInvalid },
+};
+
+const X87Special x87SpecialMap[] = {
+    { 0xD9, 0xD0, MnemonicFnop, OpNone },
+    { 0xD9, 0xE0, MnemonicFchs, OpNone },
+    { 0xD9, 0xE1, MnemonicFabs, OpNone },
+    { 0xD9, 0xE4, MnemonicFtst, OpNone },
+    { 0xD9, 0xE5, MnemonicFxam, OpNone },
+    { 0xD9, 0xE8, MnemonicFld1, OpNone },
+    { 0xD9, 0xE9, MnemonicFldl2t, OpNone },
+    { 0xD9, 0xEA, MnemonicFldl2e, OpNone },
+    { 0xD9, 0xEB, MnemonicFldpi, OpNone },
+    { 0xD9, 0xEC, MnemonicFldlg2, OpNone },
+    { 0xD9, 0xED, MnemonicFldln2, OpNone },
+    { 0xD9, 0xEE, MnemonicFldz, OpNone },
+    { 0xD9, 0xF0, MnemonicF2xm1, OpNone },
+    { 0xD9, 0xF1, MnemonicFyl2x, OpNone },
+    { 0xD9, 0xF2, MnemonicFptan, OpNone },
+    { 0xD9, 0xF3, MnemonicFpatan, OpNone },
+    { 0xD9, 0xF4, MnemonicFxtract, OpNone },
+    { 0xD9, 0xF5, MnemonicFprem1, OpNone },
+    { 0xD9, 0xF6, MnemonicFdecstp, OpNone },
+    { 0xD9, 0xF7, MnemonicFincstp, OpNone },
+    { 0xD9, 0xF8, MnemonicFprem, OpNone },
+    { 0xD9, 0xF9, MnemonicFyl2xp1, OpNone },
+    { 0xD9, 0xFA, MnemonicFsqrt, OpNone },
+    { 0xD9, 0xFB, MnemonicFsincos, OpNone },
+    { 0xD9, 0xFC, MnemonicFrndint, OpNone },
+    { 0xD9, 0xFD, MnemonicFscale, OpNone },
+    { 0xD9, 0xFE, MnemonicFsin, OpNone },
+    { 0xD9, 0xFF, MnemonicFcos, OpNone },
+    { 0xDA, 0xE9, MnemonicFucompp, OpNone },
+    { 0xDB, 0xE2, MnemonicFnclex, OpNone },
+    { 0xDB, 0xE3, MnemonicFninit, OpNone },
+    { 0xDE, 0xD9, MnemonicFcompp, OpNone },
+    { 0xDF, 0xE0, MnemonicFnstsw, OpAX },
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+const char*  mnemonicNames[MnemonicMax] = {
+    "???", "aaa", "aad", "aam", "aas", "adc", "adcx", "add", "addpd", "addps", "addsd", "addss", "addsubpd",
+    "addsubps", "adox", "aesdec", "aesdeclast", "aesenc", "aesenclast", "aesimc", "aeskeygenassist", "and",
+    "andn", "andnpd", "andnps", "andpd", "andps", "arpl", "bextr", "blendpd", "blendps", "blendvpd",
+    "blendvps", "blsi", "blsmsk", "blsr", "bound", "bsf", "bsr", "bswap", "bt", "btc", "btr", "bts", "bzhi",
+    "call", "cbw", "cdq", "cdqe", "clac", "clc", "cld", "clflush", "clgi", "cli", "clts", "clzero", "cmc",
+    "cmova", "cmovae", "cmovb", "cmovbe", "cmove", "cmovg", "cmovge", "cmovl", "cmovle", "cmovne", "cmovno",
+    "cmovnp", "cmovns", "cmovo", "cmovp", "cmovs", "cmp", "cmpeqpd", "cmpeqps", "cmpeqsd", "cmpeqss",
+    "cmplepd", "cmpleps", "cmplesd", "cmpless", "cmpltpd", "cmpltps", "cmpltsd", "cmpltss", "cmpneqpd",
+    "cmpneqps", "cmpneqsd", "cmpneqss", "cmpnlepd", "cmpnleps", "cmpnlesd", "cmpnless", "cmpnltpd",
+    "cmpnltps", "cmpnltsd", "cmpnltss", "cmpordpd", "cmpordps", "cmpordsd", "cmpordss", "cmppd", "cmpps",
+    "cmps", "cmpsd", "cmpss", "cmpunordpd", "cmpunordps", "cmpunordsd", "cmpunordss", "cmpxchg", "cmpxchg16b",
+    "cmpxchg8b", "comisd", "comiss", "cpuid", "cqo", "crc32", "cvtdq2pd", "cvtdq2ps", "cvtpd2dq", "cvtpd2pi",
+    "cvtpd2ps", "cvtpi2pd", "cvtpi2ps", "cvtps2dq", "cvtps2pd", "cvtps2pi", "cvtsd2si", "cvtsd2ss",
+    "cvtsi2sd", "cvtsi2ss", "cvtss2sd", "cvtss2si", "cvttpd2dq", "cvttpd2pi", "cvttps2dq", "cvttps2pi",
+    "cvttsd2si", "cvttss2si", "cwd", "cwde", "daa", "das", "dec", "div", "divpd", "divps", "divsd", "divss",
+    "dppd", "dpps", "emms", "encls", "enclu", "endbr32", "endbr64", "enter", "extractps", "f2xm1", "fabs",
+    "fadd", "faddp", "fbld", "fbstp", "fchs", "fcmovb", "fcmovbe", "fcmove", "fcmovnb", "fcmovnbe", "fcmovne",
+    "fcmovnu", "fcmovu", "fcom", "fcomi", "fcomip", "fcomp", "fcompp", "fcos", "fdecstp", "fdiv", "fdivp",
+    "fdivr", "fdivrp", "femms", "ffree", "ffreep", "fiadd", "ficom", "ficomp", "fidiv", "fidivr", "fild",
+    "fimul", "fincstp", "fist", "fistp", "fisttp", "fisub", "fisubr", "fld", "fld1", "fldcw", "fldenv",
+    "fldl2e", "fldl2t", "fldlg2", "fldln2", "fldpi", "fldz", "fmul", "fmulp", "fnclex", "fninit", "fnop",
+    "fnsave", "fnstcw", "fnstenv", "fnstsw", "fpatan", "fprem", "fprem1", "fptan", "frndint", "frstor",
+    "fscale", "fsin", "fsincos", "fsqrt", "fst", "fstp", "fsub", "fsubp", "fsubr", "fsubrp", "ftst", "fucom",
+    "fucomi", "fucomip", "fucomp", "fucompp", "fxam", "fxch", "fxrstor", "fxsave", "fxtract", "fyl2x",
+    "fyl2xp1", "getsec", "haddpd", "haddps", "hlt", "hsubpd", "hsubps", "idiv", "imul", "in", "inc", "ins",
+    "insertps", "int", "int1", "into", "invd", "invlpg", "invlpga", "iret", "iretd", "iretq", "ja", "jae",
+    "jb", "jbe", "jcxz", "je", "jecxz", "jg", "jge", "jl", "jle", "jmp", "jne", "jno", "jnp", "jns", "jo",
+    "jp", "jrcxz", "js", "kaddb", "kaddd", "kaddq", "kaddw", "kandb", "kandd", "kandnb", "kandnd", "kandnq",
+    "kandnw", "kandq", "kandw", "kmovb", "kmovd", "kmovq", "kmovw", "knotb", "knotd", "knotq", "knotw",
+    "korb", "kord", "korq", "kortestb", "kortestd", "kortestq", "kortestw", "korw", "ktestb", "ktestd",
+    "ktestq", "ktestw", "kunpckbw", "kunpckdq", "kunpckwd", "kxnorb", "kxnord", "kxnorq", "kxnorw", "kxorb",
+    "kxord", "kxorq", "kxorw", "lahf", "lar", "lddqu", "ldmxcsr", "lds", "lea", "leave", "les", "lfence",
+    "lfs", "lgdt", "lgs", "lidt", "lldt", "lmsw", "lods", "loop", "loope", "loopne", "lsl", "lss", "ltr",
+    "lzcnt", "maskmovdqu", "maskmovq", "maxpd", "maxps", "maxsd", "maxss", "mfence", "minpd", "minps",
+    "minsd", "minss", "monitor", "monitorx", "mov", "movapd", "movaps", "movbe", "movd", "movddup", "movdqa",
+    "movdqu", "movhlps", "movhpd", "movhps", "movlhps", "movlpd", "movlps", "movmskpd", "movmskps", "movntdq",
+    "movntdqa", "movnti", "movntpd", "movntps", "movntq", "movq", "movs", "movsd", "movshdup", "movsldup",
+    "movss", "movsx", "movsxd", "movupd", "movups", "movzx", "mpsadbw", "mul", "mulpd", "mulps", "mulsd",
+    "mulss", "mulx", "mwait", "mwaitx", "neg", "nop", "not", "or", "orpd", "orps", "out", "outs", "pabsb",
+    "pabsd", "pabsw", "packssdw", "packsswb", "packusdw", "packuswb", "paddb", "paddd", "paddq", "paddsb",
+    "paddsw", "paddusb", "paddusw", "paddw", "palignr", "pand", "pandn", "pause", "pavgb", "pavgw",
+    "pblendvb", "pblendw", "pclmulqdq", "pcmpeqb", "pcmpeqd", "pcmpeqq", "pcmpeqw", "pcmpestri", "pcmpestrm",
+    "pcmpgtb", "pcmpgtd", "pcmpgtq", "pcmpgtw", "pcmpistri", "pcmpistrm", "pdep", "pext", "pextrb", "pextrd",
+    "pextrw", "phaddd", "phaddsw", "phaddw", "phminposuw", "phsubd", "phsubsw", "phsubw", "pinsrb", "pinsrd",
+    "pinsrw", "pmaddubsw", "pmaddwd", "pmaxsb", "pmaxsd", "pmaxsw", "pmaxub", "pmaxud", "pmaxuw", "pminsb",
+    "pminsd", "pminsw", "pminub", "pminud", "pminuw", "pmovmskb", "pmovsxbd", "pmovsxbq", "pmovsxbw",
+    "pmovsxdq", "pmovsxwd", "pmovsxwq", "pmovzxbd", "pmovzxbq", "pmovzxbw", "pmovzxdq", "pmovzxwd",
+    "pmovzxwq", "pmuldq", "pmulhrsw", "pmulhuw", "pmulhw", "pmulld", "pmullw", "pmuludq", "pop", "popa",
+    "popad", "popcnt", "popf", "popfd", "popfq", "por", "prefetch", "prefetchnta", "prefetcht0", "prefetcht1",
+    "prefetcht2", "prefetchw", "prefetchwt1", "psadbw", "pshufb", "pshufd", "pshufhw", "pshuflw", "pshufw",
+    "psignb", "psignd", "psignw", "pslld", "pslldq", "psllq", "psllw", "psrad", "psraw", "psrld", "psrldq",
+    "psrlq", "psrlw", "psubb", "psubd", "psubq", "psubsb", "psubsw", "psubusb", "psubusw", "psubw", "ptest",
+    "punpckhbw", "punpckhdq", "punpckhqdq", "punpckhwd", "punpcklbw", "punpckldq", "punpcklqdq", "punpcklwd",
+    "push", "pusha", "pushad", "pushf", "pushfd", "pushfq", "pxor", "rcl", "rcpps", "rcpss", "rcr",
+    "rdfsbase", "rdgsbase", "rdmsr", "rdpid", "rdpkru", "rdpmc", "rdpru", "rdrand", "rdseed", "rdtsc",
+    "rdtscp", "ret", "retf", "rol", "ror", "rorx", "roundpd", "roundps", "roundsd", "roundss", "rsm",
+    "rsqrtps", "rsqrtss", "sahf", "sal", "sar", "sarx", "sbb", "scas", "seta", "setae", "setb", "setbe",
+    "sete", "setg", "setge", "setl", "setle", "setne", "setno", "setnp", "setns", "seto", "setp", "sets",
+    "sfence", "sgdt", "sha1msg1", "sha1msg2", "sha1nexte", "sha1rnds4", "sha256msg1", "sha256msg2",
+    "sha256rnds2", "shl", "shld", "shlx", "shr", "shrd", "shrx", "shufpd", "shufps", "sidt", "skinit", "sldt",
+    "smsw", "sqrtpd", "sqrtps", "sqrtsd", "sqrtss", "stac", "stc", "std", "stgi", "sti", "stmxcsr", "stos",
+    "str", "sub", "subpd", "subps", "subsd", "subss", "swapgs", "syscall", "sysenter", "sysexit", "sysret",
+    "test", "tzcnt", "ucomisd", "ucomiss", "ud0", "ud1", "ud2", "unpckhpd", "unpckhps", "unpcklpd",
+    "unpcklps", "vblendvpd", "vblendvps", "vbroadcastf128", "vbroadcasti128", "vbroadcastsd", "vbroadcastss",
+    "vcvtps2ph", "verr", "verw", "vextractf128", "vextracti128", "vfmadd132pd", "vfmadd132ps", "vfmadd132sd",
+    "vfmadd132ss", "vfmadd213pd", "vfmadd213ps", "vfmadd213sd", "vfmadd213ss", "vfmadd231pd", "vfmadd231ps",
+    "vfmadd231sd", "vfmadd231ss", "vfmaddsub132pd", "vfmaddsub132ps", "vfmaddsub213pd", "vfmaddsub213ps",
+    "vfmaddsub231pd", "vfmaddsub231ps", "vfmsub132pd", "vfmsub132ps", "vfmsub132sd", "vfmsub132ss",
+    "vfmsub213pd", "vfmsub213ps", "vfmsub213sd", "vfmsub213ss", "vfmsub231pd", "vfmsub231ps", "vfmsub231sd",
+    "vfmsub231ss", "vfmsubadd132pd", "vfmsubadd132ps", "vfmsubadd213pd", "vfmsubadd213ps", "vfmsubadd231pd",
+    "vfmsubadd231ps", "vfnmadd132pd", "vfnmadd132ps", "vfnmadd132sd", "vfnmadd132ss", "vfnmadd213pd",
+    "vfnmadd213ps", "vfnmadd213sd", "vfnmadd213ss", "vfnmadd231pd", "vfnmadd231ps", "vfnmadd231sd",
+    "vfnmadd231ss", "vfnmsub132pd", "vfnmsub132ps", "vfnmsub132sd", "vfnmsub132ss", "vfnmsub213pd",
+    "vfnmsub213ps", "vfnmsub213sd", "vfnmsub213ss", "vfnmsub231pd", "vfnmsub231ps", "vfnmsub231sd",
+    "vfnmsub231ss", "vinsertf128", "vinserti128", "vmaskmovpd", "vmaskmovps", "vmcall", "vmfunc", "vmlaunch",
+    "vmload", "vmmcall", "vmovdqa32", "vmovdqa64", "vmovdqu16", "vmovdqu32", "vmovdqu64", "vmovdqu8",
+    "vmptrld", "vmptrst", "vmread", "vmresume", "vmrun", "vmsave", "vmwrite", "vmxoff", "vpandd", "vpandnd",
+    "vpandnq", "vpandq", "vpblendd", "vpblendvb", "vpbroadcastb", "vpbroadcastd", "vpbroadcastq",
+    "vpbroadcastw", "vpcmpb", "vpcmpd", "vpcmpq", "vpcmpub", "vpcmpud", "vpcmpuq", "vpcmpuw", "vpcmpw",
+    "vperm2f128", "vperm2i128", "vpermd", "vpermilpd", "vpermilps", "vpermpd", "vpermq", "vpmaskmovd",
+    "vpmaskmovq", "vpord", "vporq", "vpsllvd", "vpsllvq", "vpsravd", "vpsrlvd", "vpsrlvq", "vpternlogd",
+    "vpternlogq", "vptestmb", "vptestmd", "vptestmq", "vptestmw", "vptestnmb", "vptestnmd", "vptestnmq",
+    "vptestnmw", "vpxord", "vpxorq", "vzeroall", "vzeroupper", "wait", "wbinvd", "wrfsbase", "wrgsbase",
+    "wrmsr", "wrpkru", "xabort", "xadd", "xbegin", "xchg", "xend", "xgetbv", "xlat", "xor", "xorpd", "xorps",
+    "xrstor", "xrstors", "xsave", "xsavec", "xsaveopt", "xsaves", "xsetbv", "xtest",
+};
+
+const OpcodeEntry  invalidEntry = { MnemonicInvalid, { OpNone, OpNone, OpNone }, 0, 0, FlowNone };
+const OpcodeEntry  movsxdEntry = { MnemonicMovsxd, { OpGv, OpEd, OpNone }, FlagModRM, 0, FlowNone };
+const OpcodeEntry  xchgEntry = { MnemonicXchg, { OpZv, OpAXv, OpNone }, 0, 0, FlowNone };
+const OpcodeEntry  pauseEntry = { MnemonicPause, { OpNone, OpNone, OpNone }, 0, 0, FlowNone };
+const OpcodeEntry  vzeroupperEntry = { MnemonicVzeroupper, { OpNone, OpNone, OpNone }, FlagVexValid, 0, FlowNone };
+const OpcodeEntry  vzeroallEntry = { MnemonicVzeroall, { OpNone, OpNone, OpNone }, FlagVexValid, 0, FlowNone };
+const OpcodeEntry  vexShiftEntry = { MnemonicInvalid, { OpHx, OpUx, OpIb }, FlagModRM, 0, FlowNone };
+
+const char*  gp8Names[] = {
+    "al", "cl", "dl", "bl", "spl", "bpl", "sil", "dil", "r8b", "r9b", "r10b", "r11b", "r12b", "r13b", "r14b", "r15b",
+    "ah", "ch", "dh", "bh" };
+
+const char*  gp16Names[] = {
+    "ax", "cx", "dx", "bx", "sp", "bp", "si", "di", "r8w", "r9w", "r10w", "r11w", "r12w", "r13w", "r14w", "r15w" };
+
+const char*  gp32Names[] = {
+    "eax", "ecx", "edx", "ebx", "esp", "ebp", "esi", "edi", "r8d", "r9d", "r10d", "r11d", "r12d", "r13d", "r14d", "r15d" };
+
+const char*  gp64Names[] = {
+    "rax", "rcx", "rdx", "rbx", "rsp", "rbp", "rsi", "rdi", "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15" };
+
+const char*  segmentNames[] = { "es", "cs", "ss", "ds", "fs", "gs" };
+
+enum SegmentRegister {
+    SegmentES,
+    SegmentCS,
+    SegmentSS,
+    SegmentDS,
+    SegmentFS,
+    SegmentGS
+};
+
+const unsigned char  NoRegister = 0xFF;
+
+// 16-bit addressing: base and index registers by ModRM.rm
+const unsigned char  memory16Registers[8][2] = {
+    { 3, 6 }, { 3, 7 }, { 5, 6 }, { 5, 7 }, { 6, NoRegister }, { 7, NoRegister }, { 5, NoRegister }, { 3, NoRegister } };
+
+unsigned char gpRegisterClass( size_t size )
+{
+    switch( size )
+    {
+    case 1: return RegClassGp8;
+    case 2: return RegClassGp16;
+    case 4: return RegClassGp32;
+    }
+    return RegClassGp64;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+class X86Decoder
+{
+public:
+
+    X86Decoder( const void* buffer, size_t length, MEMOFFSET_64 offset, CPUType cpuMode, Instruction& instruction );
+
+    bool decode();
+
+private:
+
+    unsigned char fetch() {
+        if ( m_pos >= m_length )
+        {
+            m_truncated = true;
+            return 0;
+        }
+        return m_code[m_pos++];
+    }
+
+    long long fetchSigned( size_t size );
+
+    unsigned char decodePrefixes();
+    const OpcodeEntry* decodeOpcode( unsigned char opcode );
+    const OpcodeEntry* selectPrefixed( const OpcodeEntry* entry );
+    const OpcodeEntry* selectGroup( const OpcodeEntry* entry, OpcodeEntry& merged );
+    const OpcodeEntry* selectMaskOpcode( const OpcodeEntry* entry, OpcodeEntry& merged );
+    void decodeVex( unsigned char prefix );
+    void decodeModRM();
+    void decodeMemory();
+    void decodeMemory16();
+    void decodeOperand( unsigned char spec, InstructionOperand& operand );
+    void renameMnemonic();
+
+    void setImmediate( InstructionOperand& operand, long long value, size_t size );
+    void setGpRegister( InstructionOperand& operand, size_t size, unsigned char number );
+    void setRegister( InstructionOperand& operand, unsigned char regClass, unsigned char number );
+    void setMemory( InstructionOperand& operand, size_t size );
+    void setRm( InstructionOperand& operand, unsigned char regClass, unsigned char number, size_t size );
+    void setStringMemory( InstructionOperand& operand, unsigned char base, size_t size, unsigned char segment );
+
+    unsigned char vectorClass() const {
+        return m_vexL == 0 ? RegClassXmm : m_vexL == 1 ? RegClassYmm : RegClassZmm;
+    }
+
+    size_t vectorSize() const {
+        return (size_t)16 << m_vexL;
+    }
+
+    size_t wideSize() const {
+        return m_mode64 && m_wide ? 8 : 4;
+    }
+
+    unsigned char rmVector() const {
+        return ( m_modrm & 7 ) | m_rexB | m_evexX;
+    }
+
+    const unsigned char  *m_code;
+    size_t  m_length;
+    size_t  m_pos;
+    bool  m_mode64;
+    bool  m_truncated;
+    bool  m_invalid;
+    Instruction  &m_instruction;
+
+    unsigned char  m_opcode;
+    unsigned char  m_map;           // 0 - one byte, 1 - 0F, 2 - 0F 38, 3 - 0F 3A
+    unsigned char  m_lastRep;       // F2 or F3
+    unsigned char  m_segment;       // segment register number + 1
+    bool  m_prefix66;
+    bool  m_prefix67;
+    bool  m_wide;                   // REX.W or VEX.W
+
+    unsigned char  m_rexR;          // REX and VEX register extensions: 8 or 0
+    unsigned char  m_rexX;
+    unsigned char  m_rexB;
+
+    bool  m_vex;
+    bool  m_evex;
+    unsigned char  m_vexL;
+    unsigned char  m_vexPrefix;     // VEX.pp: none, 66, F3, F2
+    unsigned char  m_vexRegister;   // vvvv
+    unsigned char  m_evexR;         // EVEX.R': 16 or 0
+    unsigned char  m_evexX;         // EVEX.X for the vector registers in ModRM.rm: 16 or 0
+    bool  m_evexBroadcast;
+
+    bool  m_hasModRM;
+    unsigned char  m_modrm;
+    unsigned char  m_mod;
+    unsigned char  m_reg;           // with REX.R
+    bool  m_disp8;
+    bool  m_dispScaled;
+    InstructionOperand  m_memory;
+
+    size_t  m_operandSize;
+    size_t  m_maskSize;
+    size_t  m_immediateCount;
+    long long  m_branch;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+X86Decoder::X86Decoder( const void* buffer, size_t length, MEMOFFSET_64 offset, CPUType cpuMode, Instruction& instruction ) :
+    m_code( static_cast<const unsigned char*>(buffer) ),
+    m_length( length < MaxInstructionLength ? length : MaxInstructionLength ),
+    m_pos( 0 ),
+    m_mode64( cpuMode == CPU_AMD64 ),
+    m_truncated( false ),
+    m_invalid( false ),
+    m_instruction( instruction ),
+    m_opcode( 0 ),
+    m_map( 0 ),
+    m_lastRep( 0 ),
+    m_segment( 0 ),
+    m_prefix66( false ),
+    m_prefix67( false ),
+    m_wide( false ),
+    m_rexR( 0 ),
+    m_rexX( 0 ),
+    m_rexB( 0 ),
+    m_vex( false ),
+    m_evex( false ),
+    m_vexL( 0 ),
+    m_vexPrefix( 0 ),
+    m_vexRegister( 0 ),
+    m_evexR( 0 ),
+    m_evexX( 0 ),
+    m_evexBroadcast( false ),
+    m_hasModRM( false ),
+    m_modrm( 0 ),
+    m_mod( 0 ),
+    m_reg( 0 ),
+    m_disp8( false ),
+    m_dispScaled( false ),
+    m_operandSize( 4 ),
+    m_maskSize( 0 ),
+    m_immediateCount( 0 ),
+    m_branch( 0 )
+{
+    memset( &m_instruction, 0, sizeof(Instruction) );
+    memset( &m_memory, 0, sizeof(InstructionOperand) );
+
+    m_instruction.offset = offset;
+    m_instruction.cpuMode = static_cast<unsigned char>(cpuMode);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+long long X86Decoder::fetchSigned( size_t size )
+{
+    unsigned long long  value = 0;
+
+    for ( size_t i = 0; i < size; ++i )
+        value |= (unsigned long long)fetch() << ( i * 8 );
+
+    if ( size < 8 && ( value & ( 1ULL << ( size * 8 - 1 ) ) ) != 0 )
+        value |= ~0ULL << ( size * 8 );
+
+    return (long long)value;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned char X86Decoder::decodePrefixes()
+{
+    unsigned char  rex = 0;
+
+    while ( true )
+    {
+        unsigned char  byte = fetch();
+
+        if ( m_truncated )
+            return 0;
+
+        switch( byte )
+        {
+        case 0xF0:
+            m_instruction.prefixes |= PrefixLock;
+            break;
+
+        case 0xF2:
+        case 0xF3:
+            m_lastRep = byte;
+            break;
+
+        case 0x26: m_segment = SegmentES + 1; break;
+        case 0x2E: m_segment = SegmentCS + 1; break;
+        case 0x36: m_segment = SegmentSS + 1; break;
+        case 0x3E: m_segment = SegmentDS + 1; break;
+        case 0x64: m_segment = SegmentFS + 1; break;
+        case 0x65: m_segment = SegmentGS + 1; break;
+
+        case 0x66:
+            m_prefix66 = true;
+            break;
+
+        case 0x67:
+            m_prefix67 = true;
+            break;
+
+        default:
+            if ( m_mode64 && ( byte & 0xF0 ) == 0x40 )
+            {
+                // REX is ignored if a legacy prefix follows it
+                rex = byte;
+                continue;
+            }
+
+            if ( rex != 0 )
+            {
+                m_instruction.rex = rex;
+                m_instruction.prefixes |= PrefixRex;
+                m_wide = ( rex & 8 ) != 0;
+                m_rexR = ( rex & 4 ) << 1;
+                m_rexX = ( rex & 2 ) << 2;
+                m_rexB = ( rex & 1 ) << 3;
+            }
+
+            return byte;
+        }
+
+        rex = 0;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void X86Decoder::decodeVex( unsigned char prefix )
+{
+    unsigned char  byte1 = fetch();
+
+    if ( prefix == 0xC5 )
+    {
+        m_rexR = ( byte1 & 0x80 ) ? 0 : 8;
+        m_map = 1;
+        m_vexRegister = ( ~byte1 >> 3 ) & 0xF;
+        m_vexL = ( byte1 >> 2 ) & 1;
+        m_vexPrefix = byte1 & 3;
+    }
+    else
+    {
+        unsigned char  byte2 = fetch();
+
+        m_rexR = ( byte1 & 0x80 ) ? 0 : 8;
+        m_rexX = ( byte1 & 0x40 ) ? 0 : 8;
+        m_rexB = ( byte1 & 0x20 ) ? 0 : 8;
+        m_wide = ( byte2 & 0x80 ) != 0;
+        m_vexRegister = ( ~byte2 >> 3 ) & 0xF;
+        m_vexPrefix = byte2 & 3;
+
+        if ( prefix == 0xC4 )
+        {
+            m_map = byte1 & 0x1F;
+            m_vexL = ( byte2 >> 2 ) & 1;
+        }
+        else
+        {
+            unsigned char  byte3 = fetch();
+
+            m_evex = true;
+            m_map = byte1 & 7;
+            m_evexR = ( byte1 & 0x10 ) ? 0 : 16;
+            m_evexX = m_rexX << 1;
+            m_vexL = ( byte3 >> 5 ) & 3;
+            m_evexBroadcast = ( byte3 & 0x10 ) != 0;
+            m_instruction.opmask = byte3 & 7;
+
+            if ( ( byte3 & 0x08 ) == 0 )
+                m_vexRegister |= 16;
+
+            if ( byte3 & 0x80 )
+                m_instruction.prefixes |= PrefixMaskZeroing;
+        }
+    }
+
+    if ( !m_mode64 )
+    {
+        m_rexR = m_rexX = m_rexB = m_evexR = m_evexX = 0;
+        m_vexRegister &= 7;
+    }
+
+    m_vex = true;
+    m_instruction.prefixes |= m_evex ? PrefixEvex : PrefixVex;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const OpcodeEntry* X86Decoder::decodeOpcode( unsigned char opcode )
+{
+    // AMD XOP: the VEX layout with the maps 8, 9 and 10, only the length is decoded
+    if ( opcode == 0x8F && m_pos < m_length && ( m_code[m_pos] & 0x1F ) >= 8 )
+    {
+        decodeVex( 0xC4 );
+
+        unsigned char  map = m_map;
+
+        m_map = 0;
+        m_opcode = fetch();
+        decodeModRM();
+        fetchSigned( map == 8 ? 1 : map == 10 ? 4 : 0 );
+
+        m_invalid = true;
+        return &invalidEntry;
+    }
+
+    // C4, C5 and 62 are VEX and EVEX in the 64-bit mode or with ModRM.mod = 11 ( les, lds, bound )
+    if ( ( opcode == 0xC4 || opcode == 0xC5 || opcode == 0x62 ) &&
+        ( m_mode64 || ( m_pos < m_length && ( m_code[m_pos] & 0xC0 ) == 0xC0 ) ) )
+    {
+        decodeVex( opcode );
+
+        m_opcode = fetch();
+
+        switch( m_map )
+        {
+        case 1:
+            if ( m_opcode == 0x77 )
+                return m_vexL ? &vzeroallEntry : &vzeroupperEntry;
+            return &twoByteMap[m_opcode];
+        case 2:
+            return &threeByteMap38[m_opcode];
+        case 3:
+            return &threeByteMap3A[m_opcode];
+        }
+
+        m_invalid = true;
+        return &invalidEntry;
+    }
+
+    m_opcode = opcode;
+
+    if ( opcode != 0x0F )
+    {
+        if ( m_mode64 && opcode == 0x63 )
+            return &movsxdEntry;
+
+        if ( opcode == 0x90 )
+        {
+            if ( m_lastRep == 0xF3 )
+            {
+                m_lastRep = 0;
+                return &pauseEntry;
+            }
+
+            if ( m_rexB != 0 || m_prefix66 )
+                return &xchgEntry;
+        }
+
+        return &oneByteMap[opcode];
+    }
+
+    m_opcode = fetch();
+
+    if ( m_opcode == 0x38 )
+    {
+        m_map = 2;
+        m_opcode = fetch();
+        return &threeByteMap38[m_opcode];
+    }
+
+    if ( m_opcode == 0x3A )
+    {
+        m_map = 3;
+        m_opcode = fetch();
+        return &threeByteMap3A[m_opcode];
+    }
+
+    m_map = 1;
+
+    // AMD 3DNow!: the opcode is the imm8 suffix, only the length is decoded
+    if ( m_opcode == 0x0F )
+    {
+        decodeModRM();
+        fetch();
+
+        m_invalid = true;
+        return &invalidEntry;
+    }
+
+    return &twoByteMap[m_opcode];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const OpcodeEntry* X86Decoder::selectPrefixed( const OpcodeEntry* entry )
+{
+    const OpcodeEntry  *entries = prefixedMap[entry->extension];
+
+    if ( m_vex )
+        return &entries[m_vexPrefix];
+
+    // F2 and F3 take precedence over 66, the prefix of the opcode is not a
+    // legacy prefix any more
+
+    if ( m_lastRep != 0 )
+    {
+        const OpcodeEntry  *selected = &entries[m_lastRep == 0xF3 ? 2 : 3];
+
+        if ( selected->mnemonic != MnemonicInvalid )
+        {
+            m_lastRep = 0;
+            return selected;
+        }
+    }
+
+    if ( m_prefix66 && entries[1].mnemonic != MnemonicInvalid )
+    {
+        m_prefix66 = false;
+        return &entries[1];
+    }
+
+    return &entries[0];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const OpcodeEntry* X86Decoder::selectGroup( const OpcodeEntry* entry, OpcodeEntry& merged )
+{
+    decodeModRM();
+
+    const OpcodeEntry  *member = &groupMap[entry->extension][ ( m_mod == 3 ? 8 : 0 ) + ( ( m_modrm >> 3 ) & 7 ) ];
+
+    merged = *member;
+    merged.flags |= entry->flags & ~( FlagGroup | FlagPrefixed );
+
+    if ( merged.operands[0] == OpNone )
+        memcpy( merged.operands, entry->operands, sizeof(merged.operands) );
+
+    if ( merged.flow == FlowNone )
+        merged.flow = entry->flow;
+
+    if ( m_map == 0 && m_opcode >= 0xD8 && m_opcode <= 0xDF && m_mod == 3 )
+    {
+        for ( size_t i = 0; i < sizeof(x87SpecialMap) / sizeof(x87SpecialMap[0]); ++i )
+        {
+            if ( x87SpecialMap[i].opcode == m_opcode && x87SpecialMap[i].modrm == m_modrm )
+            {
+                merged.mnemonic = x87SpecialMap[i].mnemonic;
+                merged.operands[0] = x87SpecialMap[i].operand;
+                merged.operands[1] = OpNone;
+                break;
+            }
+        }
+    }
+
+    if ( m_map == 1 )
+    {
+        switch( m_opcode )
+        {
+        case 0x01:
+            if ( m_mod == 3 && merged.mnemonic == MnemonicInvalid )
+                merged.mnemonic = group7Register[ ( m_modrm >> 3 ) & 7 ][ m_modrm & 7 ];
+            break;
+
+        case 0x71:
+        case 0x72:
+        case 0x73:
+            if ( m_vex )
+                memcpy( merged.operands, vexShiftEntry.operands, sizeof(merged.operands) );
+            break;
+
+        case 0xAE:
+            // rdfsbase .. wrgsbase
+            if ( m_mod == 3 && ( m_modrm & 0x20 ) == 0 && m_lastRep == 0xF3 )
+                m_lastRep = 0;
+            break;
+
+        case 0xC7:
+            if ( m_mod != 3 && merged.mnemonic == MnemonicCmpxchg8b && m_wide )
+                merged.mnemonic = MnemonicCmpxchg16b;
+            if ( m_mod == 3 && ( ( m_modrm >> 3 ) & 7 ) == 7 && m_lastRep == 0xF3 )
+            {
+                m_lastRep = 0;
+                merged.mnemonic = MnemonicRdpid;
+                merged.operands[0] = OpRy;
+            }
+            break;
+        }
+    }
+
+    return &merged;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const OpcodeEntry* X86Decoder::selectMaskOpcode( const OpcodeEntry* entry, OpcodeEntry& merged )
+{
+    for ( size_t i = 0; i < sizeof(maskOpcodeMap) / sizeof(maskOpcodeMap[0]); ++i )
+    {
+        const MaskOpcode  &maskOpcode = maskOpcodeMap[i];
+
+        if ( maskOpcode.opcode != m_opcode )
+            continue;
+
+        // b: 66 W0, w: W0, d: 66 W1, q: W1; kmov with a general register: d and q by F2
+        size_t  sizeIndex;
+
+        if ( ( m_opcode == 0x92 || m_opcode == 0x93 ) && m_vexPrefix == 3 )
+            sizeIndex = m_mode64 && m_wide ? 3 : 2;
+        else if ( m_vexPrefix == 1 )
+            sizeIndex = m_wide ? 2 : 0;
+        else
+            sizeIndex = m_wide ? 3 : 1;
+
+        m_maskSize = (size_t)1 << sizeIndex;
+
+        merged = invalidEntry;
+        merged.mnemonic = maskOpcode.mnemonics[sizeIndex];
+        merged.flags = FlagModRM | FlagVexValid;
+        memcpy( merged.operands, maskOpcode.operands, sizeof(merged.operands) );
+
+        return &merged;
+    }
+
+    return entry;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void X86Decoder::decodeModRM()
+{
+    if ( m_hasModRM )
+        return;
+
+    m_hasModRM = true;
+    m_modrm = fetch();
+    m_mod = m_modrm >> 6;
+
+    // mov to and from the control and debug registers ignores ModRM.mod
+    if ( m_map == 1 && ( m_opcode & 0xFC ) == 0x20 )
+        m_mod = 3;
+    m_reg = ( ( m_modrm >> 3 ) & 7 ) | m_rexR;
+
+    if ( m_mod != 3 )
+    {
+        if ( m_instruction.addressSize == 2 )
+            decodeMemory16();
+        else
+            decodeMemory();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void X86Decoder::decodeMemory()
+{
+    unsigned char  regClass = m_instruction.addressSize == 8 ? RegClassGp64 : RegClassGp32;
+    unsigned char  rm = m_modrm & 7;
+    size_t  dispSize = m_mod == 1 ? 1 : m_mod == 2 ? 4 : 0;
+
+    m_memory.kind = OperandMemory;
+    m_memory.segment = m_segment;
+    m_memory.base.number = NoRegister;
+    m_memory.index.number = NoRegister;
+
+    if ( rm == 4 )
+    {
+        unsigned char  sib = fetch();
+        unsigned char  index = ( ( sib >> 3 ) & 7 ) | m_rexX;
+
+        if ( index != 4 )
+        {
+            m_memory.index.regClass = regClass;
+            m_memory.index.number = index;
+            m_memory.scale = 1 << ( sib >> 6 );
+        }
+
+        if ( ( sib & 7 ) == 5 && m_mod == 0 )
+        {
+            dispSize = 4;
+        }
+        else
+        {
+            m_memory.base.regClass = regClass;
+            m_memory.base.number = ( sib & 7 ) | m_rexB;
+        }
+    }
+    else if ( rm == 5 && m_mod == 0 )
+    {
+        dispSize = 4;
+
+        if ( m_mode64 )
+        {
+            m_memory.base.regClass = RegClassIp;
+            m_memory.base.number = 0;
+        }
+    }
+    else
+    {
+        m_memory.base.regClass = regClass;
+        m_memory.base.number = rm | m_rexB;
+    }
+
+    m_disp8 = dispSize == 1;
+    m_instruction.displacement = fetchSigned( dispSize );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void X86Decoder::decodeMemory16()
+{
+    unsigned char  rm = m_modrm & 7;
+    size_t  dispSize = m_mod == 1 ? 1 : m_mod == 2 ? 2 : 0;
+
+    m_memory.kind = OperandMemory;
+    m_memory.segment = m_segment;
+    m_memory.base.number = NoRegister;
+    m_memory.index.number = NoRegister;
+
+    if ( rm == 6 && m_mod == 0 )
+    {
+        dispSize = 2;
+    }
+    else
+    {
+        m_memory.base.regClass = RegClassGp16;
+        m_memory.base.number = memory16Registers[rm][0];
+
+        if ( memory16Registers[rm][1] != NoRegister )
+        {
+            m_memory.index.regClass = RegClassGp16;
+            m_memory.index.number = memory16Registers[rm][1];
+            m_memory.scale = 1;
+        }
+    }
+
+    m_disp8 = dispSize == 1;
+    m_instruction.displacement = fetchSigned( dispSize );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void X86Decoder::setImmediate( InstructionOperand& operand, long long value, size_t size )
+{
+    operand.kind = OperandImmediate;
+    operand.size = static_cast<unsigned char>(size);
+
+    if ( m_immediateCount++ == 0 )
+        m_instruction.immediate = value;
+    else
+        m_instruction.immediate2 = value;
+}
+
+void X86Decoder::setGpRegister( InstructionOperand& operand, size_t size, unsigned char number )
+{
+    // ah, ch, dh, bh without REX
+    if ( size == 1 && number >= 4 && number < 8 && ( m_instruction.prefixes & ( PrefixRex | PrefixVex | PrefixEvex ) ) == 0 )
+        number += 12;
+
+    setRegister( operand, gpRegisterClass(size), number );
+    operand.size = static_cast<unsigned char>(size);
+}
+
+void X86Decoder::setRegister( InstructionOperand& operand, unsigned char regClass, unsigned char number )
+{
+    operand.kind = OperandRegister;
+    operand.reg.regClass = regClass;
+    operand.reg.number = number;
+
+    switch( regClass )
+    {
+    case RegClassMmx: operand.size = 8; break;
+    case RegClassXmm: operand.size = 16; break;
+    case RegClassYmm: operand.size = 32; break;
+    case RegClassZmm: operand.size = 64; break;
+    case RegClassSt: operand.size = 10; break;
+    case RegClassSegment: operand.size = 2; break;
+    case RegClassControl:
+    case RegClassDebug: operand.size = m_mode64 ? 8 : 4; break;
+    }
+}
+
+void X86Decoder::setMemory( InstructionOperand& operand, size_t size )
+{
+    if ( m_mod == 3 )
+        m_invalid = true;
+
+    operand = m_memory;
+    operand.size = static_cast<unsigned char>(size);
+
+    // EVEX disp8 is scaled by the memory access size
+    if ( m_evex && m_disp8 && !m_dispScaled )
+    {
+        size_t  scale = m_evexBroadcast ? ( m_wide ? 8 : 4 ) : size;
+
+        if ( scale != 0 )
+            m_instruction.displacement *= (long long)scale;
+
+        m_dispScaled = true;
+    }
+}
+
+void X86Decoder::setRm( InstructionOperand& operand, unsigned char regClass, unsigned char number, size_t size )
+{
+    if ( m_mod == 3 )
+    {
+        if ( regClass >= RegClassGp8 && regClass <= RegClassGp64 )
+            setGpRegister( operand, size, number );
+        else
+            setRegister( operand, regClass, number );
+    }
+    else
+    {
+        setMemory( operand, size );
+    }
+}
+
+void X86Decoder::setStringMemory( InstructionOperand& operand, unsigned char base, size_t size, unsigned char segment )
+{
+    operand.kind = OperandMemory;
+    operand.size = static_cast<unsigned char>(size);
+    operand.base.regClass = gpRegisterClass( m_instruction.addressSize );
+    operand.base.number = base;
+    operand.index.number = NoRegister;
+    operand.segment = segment;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void X86Decoder::decodeOperand( unsigned char spec, InstructionOperand& operand )
+{
+    size_t  opsize = m_operandSize;
+    size_t  zsize = opsize == 2 ? 2 : 4;
+
+    switch( spec )
+    {
+    case OpEb: setRm( operand, RegClassGp8, ( m_modrm & 7 ) | m_rexB, 1 ); break;
+    case OpEw: setRm( operand, RegClassGp16, ( m_modrm & 7 ) | m_rexB, 2 ); break;
+    case OpEd: setRm( operand, RegClassGp32, ( m_modrm & 7 ) | m_rexB, 4 ); break;
+    case OpEv: setRm( operand, gpRegisterClass(opsize), ( m_modrm & 7 ) | m_rexB, opsize ); break;
+    case OpEy: setRm( operand, gpRegisterClass(wideSize()), ( m_modrm & 7 ) | m_rexB, wideSize() ); break;
+
+    case OpGb: setGpRegister( operand, 1, m_reg ); break;
+    case OpGw: setGpRegister( operand, 2, m_reg ); break;
+    case OpGd: setGpRegister( operand, 4, m_reg ); break;
+    case OpGv: setGpRegister( operand, opsize, m_reg ); break;
+    case OpGy: setGpRegister( operand, wideSize(), m_reg ); break;
+    case OpGz: setGpRegister( operand, zsize, m_reg ); break;
+
+    case OpRv: setGpRegister( operand, opsize, ( m_modrm & 7 ) | m_rexB ); break;
+    case OpRy: setGpRegister( operand, m_mode64 ? 8 : 4, ( m_modrm & 7 ) | m_rexB ); break;
+    case OpBy: setGpRegister( operand, wideSize(), m_vexRegister & 0xF ); break;
+
+    case OpM: setMemory( operand, 0 ); break;
+    case OpMb: setMemory( operand, 1 ); break;
+    case OpMw: setMemory( operand, 2 ); break;
+    case OpMd: setMemory( operand, 4 ); break;
+    case OpMq: setMemory( operand, 8 ); break;
+    case OpMt: setMemory( operand, 10 ); break;
+    case OpMp: setMemory( operand, opsize + 2 ); break;
+    case OpMdq: setMemory( operand, 16 ); break;
+    case OpMv: setMemory( operand, opsize ); break;
+    case OpMy: setMemory( operand, wideSize() ); break;
+    case OpMx: setMemory( operand, vectorSize() ); break;
+
+    case OpIb: setImmediate( operand, fetch(), 1 ); break;
+    case OpIbs: setImmediate( operand, fetchSigned(1), opsize ); break;
+    case OpIw: setImmediate( operand, fetchSigned(2) & 0xFFFF, 2 ); break;
+    case OpIz: setImmediate( operand, fetchSigned(zsize), opsize ); break;
+    case OpIv: setImmediate( operand, fetchSigned(opsize), opsize ); break;
+    case OpOne: setImmediate( operand, 1, 1 ); break;
+    case OpThree: setImmediate( operand, 3, 1 ); break;
+
+    case OpJb:
+    case OpJz:
+        m_branch = fetchSigned( spec == OpJb ? 1 : ( m_prefix66 && !m_mode64 ? 2 : 4 ) );
+        operand.kind = OperandBranch;
+        operand.size = m_mode64 ? 8 : 4;
+        break;
+
+    case OpAp:
+        m_instruction.immediate = fetchSigned( zsize ) & ( zsize == 2 ? 0xFFFF : 0xFFFFFFFF );
+        m_instruction.immediate2 = fetchSigned( 2 ) & 0xFFFF;
+        operand.kind = OperandFarPointer;
+        operand.size = static_cast<unsigned char>(zsize + 2);
+        break;
+
+    case OpOb:
+    case OpOv:
+        m_memory.kind = OperandMemory;
+        m_memory.segment = m_segment;
+        m_memory.base.number = NoRegister;
+        m_memory.index.number = NoRegister;
+        m_instruction.displacement = fetchSigned( m_instruction.addressSize );
+        operand = m_memory;
+        operand.size = static_cast<unsigned char>( spec == OpOb ? 1 : opsize );
+        break;
+
+    case OpAL: setGpRegister( operand, 1, 0 ); break;
+    case OpCL: setGpRegister( operand, 1, 1 ); break;
+    case OpDX: setGpRegister( operand, 2, 2 ); break;
+    case OpAX: setGpRegister( operand, 2, 0 ); break;
+    case OpAXv: setGpRegister( operand, opsize, 0 ); break;
+    case OpAXz: setGpRegister( operand, zsize, 0 ); break;
+
+    case OpZb: setGpRegister( operand, 1, ( m_opcode & 7 ) | m_rexB ); break;
+    case OpZv: setGpRegister( operand, opsize, ( m_opcode & 7 ) | m_rexB ); break;
+    case OpZy: setGpRegister( operand, wideSize(), ( m_opcode & 7 ) | m_rexB ); break;
+
+    case OpSw:
+        if ( ( m_reg & 7 ) > SegmentGS )
+            m_invalid = true;
+        setRegister( operand, RegClassSegment, m_reg & 7 );
+        break;
+
+    case OpES: setRegister( operand, RegClassSegment, SegmentES ); break;
+    case OpCS: setRegister( operand, RegClassSegment, SegmentCS ); break;
+    case OpSS: setRegister( operand, RegClassSegment, SegmentSS ); break;
+    case OpDS: setRegister( operand, RegClassSegment, SegmentDS ); break;
+    case OpFS: setRegister( operand, RegClassSegment, SegmentFS ); break;
+    case OpGS: setRegister( operand, RegClassSegment, SegmentGS ); break;
+
+    case OpXb: setStringMemory( operand, 6, 1, m_segment ); break;
+    case OpXv: setStringMemory( operand, 6, opsize, m_segment ); break;
+    case OpXz: setStringMemory( operand, 6, zsize, m_segment ); break;
+    case OpYb: setStringMemory( operand, 7, 1, m_mode64 ? 0 : SegmentES + 1 ); break;
+    case OpYv: setStringMemory( operand, 7, opsize, m_mode64 ? 0 : SegmentES + 1 ); break;
+    case OpYz: setStringMemory( operand, 7, zsize, m_mode64 ? 0 : SegmentES + 1 ); break;
+    case OpXlat: setStringMemory( operand, 3, 1, m_segment ); break;
+
+    case OpCd: setRegister( operand, RegClassControl, m_reg ); break;
+    case OpDd: setRegister( operand, RegClassDebug, m_reg ); break;
+
+    case OpPq: setRegister( operand, RegClassMmx, m_reg & 7 ); break;
+    case OpQq: setRm( operand, RegClassMmx, m_modrm & 7, 8 ); break;
+    case OpNq: setRegister( operand, RegClassMmx, m_modrm & 7 ); break;
+
+    case OpPx:
+        if ( m_prefix66 || m_vex )
+            setRegister( operand, vectorClass(), m_reg | m_evexR );
+        else
+            setRegister( operand, RegClassMmx, m_reg & 7 );
+        break;
+
+    case OpQx:
+        if ( m_prefix66 || m_vex )
+            setRm( operand, vectorClass(), rmVector(), vectorSize() );
+        else
+            setRm( operand, RegClassMmx, m_modrm & 7, 8 );
+        break;
+
+    case OpNx:
+        if ( m_prefix66 || m_vex )
+            setRegister( operand, vectorClass(), rmVector() );
+        else
+            setRegister( operand, RegClassMmx, m_modrm & 7 );
+        break;
+
+    case OpVx: setRegister( operand, vectorClass(), m_reg | m_evexR ); break;
+    case OpWx: setRm( operand, vectorClass(), rmVector(), vectorSize() ); break;
+    case OpUx: setRegister( operand, vectorClass(), rmVector() ); break;
+    case OpWb: setRm( operand, RegClassXmm, rmVector(), 1 ); break;
+    case OpWw: setRm( operand, RegClassXmm, rmVector(), 2 ); break;
+    case OpWss: setRm( operand, RegClassXmm, rmVector(), 4 ); break;
+    case OpWsd: setRm( operand, RegClassXmm, rmVector(), 8 ); break;
+    case OpWdq: setRm( operand, RegClassXmm, rmVector(), 16 ); break;
+    case OpWsx: setRm( operand, RegClassXmm, rmVector(), m_wide ? 8 : 4 ); break;
+    case OpHx: setRegister( operand, vectorClass(), m_vexRegister ); break;
+    case OpLx: setRegister( operand, vectorClass(), ( fetch() >> 4 ) & ( m_mode64 ? 0xF : 7 ) ); break;
+
+    case OpKg: setRegister( operand, RegClassMask, m_reg & 7 ); break;
+    case OpKe: setRm( operand, RegClassMask, m_modrm & 7, m_maskSize ); break;
+    case OpKh: setRegister( operand, RegClassMask, m_vexRegister & 7 ); break;
+    case OpKr: setRegister( operand, RegClassMask, m_modrm & 7 ); break;
+
+    case OpST: setRegister( operand, RegClassSt, 0 ); break;
+    case OpSTi: setRegister( operand, RegClassSt, m_modrm & 7 ); break;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void X86Decoder::renameMnemonic()
+{
+    Instruction  &instruction = m_instruction;
+
+    switch( instruction.mnemonic )
+    {
+    case MnemonicCbw:
+        instruction.mnemonic = m_operandSize == 8 ? MnemonicCdqe : m_operandSize == 4 ? MnemonicCwde : MnemonicCbw;
+        break;
+
+    case MnemonicCwd:
+        instruction.mnemonic = m_operandSize == 8 ? MnemonicCqo : m_operandSize == 4 ? MnemonicCdq : MnemonicCwd;
+        break;
+
+    case MnemonicPushfd:
+        instruction.mnemonic = m_operandSize == 8 ? MnemonicPushfq : m_operandSize == 4 ? MnemonicPushfd : MnemonicPushf;
+        break;
+
+    case MnemonicPopfd:
+        instruction.mnemonic = m_operandSize == 8 ? MnemonicPopfq : m_operandSize == 4 ? MnemonicPopfd : MnemonicPopf;
+        break;
+
+    case MnemonicPushad:
+        if ( m_operandSize == 2 )
+            instruction.mnemonic = MnemonicPusha;
+        break;
+
+    case MnemonicPopad:
+        if ( m_operandSize == 2 )
+            instruction.mnemonic = MnemonicPopa;
+        break;
+
+    case MnemonicIretd:
+        instruction.mnemonic = m_wide ? MnemonicIretq : m_prefix66 ? MnemonicIret : MnemonicIretd;
+        break;
+
+    case MnemonicJecxz:
+        instruction.mnemonic = instruction.addressSize == 8 ? MnemonicJrcxz : instruction.addressSize == 4 ? MnemonicJecxz : MnemonicJcxz;
+        break;
+
+    case MnemonicMovd:
+        if ( m_mode64 && m_wide )
+        {
+            instruction.mnemonic = MnemonicMovq;
+            for ( size_t i = 0; i < instruction.operandCount; ++i )
+                if ( instruction.operands[i].kind == OperandMemory )
+                    instruction.operands[i].size = 8;
+        }
+        break;
+
+    case MnemonicMovdqu:
+    case MnemonicMovdqa:
+        if ( m_evex )
+        {
+            if ( m_vexPrefix == 1 )
+                instruction.mnemonic = m_wide ? MnemonicVmovdqa64 : MnemonicVmovdqa32;
+            else if ( m_vexPrefix == 2 )
+                instruction.mnemonic = m_wide ? MnemonicVmovdqu64 : MnemonicVmovdqu32;
+        }
+        break;
+
+    case MnemonicMovlps:
+        if ( m_mod == 3 )
+            instruction.mnemonic = MnemonicMovhlps;
+        break;
+
+    case MnemonicMovhps:
+        if ( m_mod == 3 )
+            instruction.mnemonic = MnemonicMovlhps;
+        break;
+
+    case MnemonicCmpps:
+    case MnemonicCmppd:
+    case MnemonicCmpss:
+    case MnemonicCmpsd:
+        // the predicate pseudo-ops: cmpltsd xmm0,xmm1
+        if ( instruction.immediate < 8 && !m_evex )
+        {
+            size_t  type = instruction.mnemonic == MnemonicCmpps ? 0 : instruction.mnemonic == MnemonicCmppd ? 1 : instruction.mnemonic == MnemonicCmpss ? 2 : 3;
+            instruction.mnemonic = cmpPredicateMnemonics[instruction.immediate][type];
+            instruction.operandCount--;
+        }
+        break;
+
+    case MnemonicVmovdqu8:
+        if ( m_wide )
+            instruction.mnemonic = MnemonicVmovdqu16;
+        break;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool X86Decoder::decode()
+{
+    Instruction  &instruction = m_instruction;
+
+    unsigned char  opcode = decodePrefixes();
+
+    instruction.addressSize = m_mode64 ? ( m_prefix67 ? 4 : 8 ) : ( m_prefix67 ? 2 : 4 );
+
+    const OpcodeEntry  *entry = m_truncated ? &invalidEntry : decodeOpcode( opcode );
+    OpcodeEntry  merged;
+
+    // endbr64, endbr32
+    if ( m_map == 1 && m_opcode == 0x1E && m_lastRep == 0xF3 && m_pos < m_length &&
+        ( m_code[m_pos] == 0xFA || m_code[m_pos] == 0xFB ) )
+    {
+        merged = invalidEntry;
+        merged.mnemonic = m_code[m_pos] == 0xFA ? MnemonicEndbr64 : MnemonicEndbr32;
+        m_lastRep = 0;
+        m_pos++;
+        entry = &merged;
+    }
+
+    if ( m_vex && m_map == 1 && !m_evex )
+        entry = selectMaskOpcode( entry, merged );
+
+    if ( entry->flags & FlagPrefixed )
+        entry = selectPrefixed( entry );
+
+    if ( ( entry->flags & FlagVexOnly ) != 0 && !m_vex )
+        entry = &invalidEntry;
+
+    if ( entry->flags & FlagGroup )
+        entry = selectGroup( entry, merged );
+
+    if ( m_mode64 && ( entry->flags & FlagInvalid64 ) != 0 )
+        m_invalid = true;
+
+    if ( m_vex && ( entry->flags & FlagVexValid ) == 0 )
+        m_invalid = true;
+
+    // operand size
+    if ( m_mode64 && ( m_wide || ( entry->flags & FlagForce64 ) != 0 ) )
+        m_operandSize = 8;
+    else if ( m_prefix66 )
+        m_operandSize = 2;
+    else if ( m_mode64 && ( entry->flags & FlagDefault64 ) != 0 )
+        m_operandSize = 8;
+
+    if ( ( entry->flags & FlagModRM ) != 0 || m_map >= 2 )
+        decodeModRM();
+
+    instruction.mnemonic = entry->mnemonic;
+    instruction.flow = entry->flow;
+    instruction.operandSize = static_cast<unsigned char>(m_operandSize);
+
+    if ( ( entry->flags & FlagVexWide ) != 0 && m_vex && m_wide )
+        instruction.mnemonic = vexWideMnemonics[entry->extension];
+
+    if ( ( entry->flags & FlagEvexWide ) != 0 && m_evex )
+        instruction.mnemonic = evexWideMnemonics[entry->extension][m_wide ? 1 : 0];
+
+    // operands
+    for ( size_t i = 0; i < 3 && entry->operands[i] != OpNone; ++i )
+    {
+        unsigned char  spec = entry->operands[i];
+
+        if ( i == 0 && m_evex && ( entry->flags & FlagEvexMask ) != 0 )
+            spec = OpKg;
+
+        if ( i == 1 && m_vex && ( ( entry->flags & FlagVexNds ) != 0 || ( ( entry->flags & FlagVexNdsRegister ) != 0 && m_mod == 3 ) ) )
+            decodeOperand( OpHx, instruction.operands[instruction.operandCount++] );
+
+        decodeOperand( spec, instruction.operands[instruction.operandCount++] );
+    }
+
+    if ( entry->flags & FlagOperand4Lx )
+        decodeOperand( OpLx, instruction.operands[instruction.operandCount++] );
+    else if ( entry->flags & FlagOperand4Ib )
+        decodeOperand( OpIb, instruction.operands[instruction.operandCount++] );
+
+    // the unknown opcodes of the 0F 3A map have an imm8 too
+    if ( m_map == 3 && instruction.mnemonic == MnemonicInvalid )
+        fetch();
+
+    renameMnemonic();
+
+    if ( m_truncated || m_invalid || instruction.mnemonic == MnemonicInvalid )
+    {
+        size_t  length = m_truncated ? 1 : m_pos;
+        MEMOFFSET_64  offset = instruction.offset;
+
+        memset( &instruction, 0, sizeof(Instruction) );
+        instruction.offset = offset;
+        instruction.cpuMode = m_mode64 ? CPU_AMD64 : CPU_I386;
+        instruction.length = static_cast<unsigned char>(length);
+        memcpy( instruction.bytes, m_code, length );
+        return false;
+    }
+
+    // the prefixes left
+    if ( m_lastRep == 0xF3 )
+        instruction.prefixes |= PrefixRep;
+    else if ( m_lastRep == 0xF2 )
+        instruction.prefixes |= PrefixRepne;
+
+    if ( m_prefix66 )
+        instruction.prefixes |= PrefixOperandSize;
+
+    if ( m_prefix67 )
+        instruction.prefixes |= PrefixAddressSize;
+
+    if ( m_segment != 0 )
+        instruction.prefixes |= PrefixSegment;
+
+    instruction.length = static_cast<unsigned char>(m_pos);
+    memcpy( instruction.bytes, m_code, m_pos );
+
+    MEMOFFSET_64  next = instruction.offset + m_pos;
+    MEMOFFSET_64  addressMask = m_mode64 ? ~0ULL : 0xFFFFFFFFULL;
+
+    for ( size_t i = 0; i < instruction.operandCount; ++i )
+    {
+        const InstructionOperand  &operand = instruction.operands[i];
+
+        if ( operand.kind == OperandBranch )
+        {
+            instruction.target = ( next + m_branch ) & addressMask;
+
+            if ( m_prefix66 && !m_mode64 )
+                instruction.target &= 0xFFFF;
+        }
+
+        if ( operand.kind == OperandMemory && operand.index.number == NoRegister && operand.segment <= SegmentDS + 1 )
+        {
+            if ( operand.base.regClass == RegClassIp )
+                instruction.ea = next + instruction.displacement;
+            else if ( operand.base.number == NoRegister )
+                instruction.ea = (MEMOFFSET_64)instruction.displacement & ( addressMask >> ( 64 - instruction.addressSize * 8 ) );
+        }
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::wstring toWide( const char* str )
+{
+    return std::wstring( str, str + strlen(str) );
+}
+
+// windbg style numbers: decimal below 10, hex with the "h" suffix otherwise
+std::wstring formatNumber( unsigned long long value )
+{
+    if ( value < 10 )
+        return std::to_wstring( value );
+
+    std::wstringstream  sstr;
+    sstr << std::hex << std::uppercase << value;
+
+    std::wstring  str = sstr.str();
+    if ( str[0] >= L'A' )
+        str = L'0' + str;
+
+    return str + L'h';
+}
+
+std::wstring formatAddress( MEMOFFSET_64 offset, bool mode64 )
+{
+    std::wstringstream  sstr;
+    sstr << std::hex << std::setfill(L'0');
+
+    if ( mode64 )
+        sstr << std::setw(8) << ( offset >> 32 ) << L'`' << std::setw(8) << ( offset & 0xFFFFFFFF );
+    else
+        sstr << std::setw(8) << ( offset & 0xFFFFFFFF );
+
+    return sstr.str();
+}
+
+std::wstring formatMemorySize( size_t size )
+{
+    switch( size )
+    {
+    case 1: return L"byte ptr ";
+    case 2: return L"word ptr ";
+    case 4: return L"dword ptr ";
+    case 6: return L"fword ptr ";
+    case 8: return L"qword ptr ";
+    case 10: return L"tbyte ptr ";
+    case 16: return L"xmmword ptr ";
+    case 32: return L"ymmword ptr ";
+    case 64: return L"zmmword ptr ";
+    }
+    return L"";
+}
+
+std::wstring formatOperand( const Instruction& instruction, const InstructionOperand& operand, long long immediate )
+{
+    bool  mode64 = instruction.cpuMode == CPU_AMD64;
+    unsigned long long  sizeMask = operand.size >= 8 ? ~0ULL : ( 1ULL << ( operand.size * 8 ) ) - 1;
+
+    switch( operand.kind )
+    {
+    case OperandRegister:
+        return getInstructionRegisterName( operand.reg );
+
+    case OperandImmediate:
+        return formatNumber( immediate & sizeMask );
+
+    case OperandBranch:
+        return formatAddress( instruction.target, mode64 );
+
+    case OperandFarPointer:
+    {
+        std::wstringstream  sstr;
+        sstr << std::hex << std::setfill(L'0') << std::setw(4) << instruction.immediate2 << L':' << std::setw(8) << instruction.immediate;
+        return sstr.str();
+    }
+
+    case OperandMemory:
+        break;
+
+    default:
+        return L"";
+    }
+
+    bool  absolute = operand.base.number == NoRegister && operand.index.number == NoRegister;
+
+    std::wstring  str = instruction.mnemonic == MnemonicLea ? L"" : formatMemorySize( operand.size );
+
+    if ( operand.segment != 0 )
+        str += toWide( segmentNames[operand.segment - 1] ) + L":";
+    else if ( absolute && !mode64 )
+        str += L"ds:";
+
+    str += L'[';
+
+    if ( operand.base.regClass == RegClassIp )
+    {
+        str += formatAddress( instruction.ea, mode64 );
+    }
+    else if ( absolute )
+    {
+        unsigned long long  displacement = (unsigned long long)instruction.displacement;
+
+        if ( instruction.addressSize < 8 )
+            displacement &= ( 1ULL << ( instruction.addressSize * 8 ) ) - 1;
+
+        if ( mode64 )
+        {
+            str += formatNumber( displacement );
+        }
+        else
+        {
+            std::wstringstream  sstr;
+            sstr << std::hex << std::uppercase << std::setfill(L'0') << std::setw(instruction.addressSize * 2) << displacement << L'h';
+            str += sstr.str();
+        }
+    }
+    else
+    {
+        if ( operand.base.number != NoRegister )
+            str += getInstructionRegisterName( operand.base );
+
+        if ( operand.index.number != NoRegister )
+        {
+            if ( operand.base.number != NoRegister )
+                str += L'+';
+
+            str += getInstructionRegisterName( operand.index );
+
+            if ( operand.scale > 1 )
+                str += L'*' + std::to_wstring( operand.scale );
+        }
+
+        if ( instruction.displacement > 0 )
+            str += L'+' + formatNumber( instruction.displacement );
+        else if ( instruction.displacement < 0 )
+            str += L'-' + formatNumber( 0 - (unsigned long long)instruction.displacement );
+    }
+
+    str += L']';
+
+    return str;
+}
+
+// The VEX and EVEX forms of the SSE instructions get the "v" prefix
+std::wstring getVexName( const Instruction& instruction, const std::wstring& name )
+{
+    if ( ( instruction.prefixes & ( PrefixVex | PrefixEvex ) ) == 0 || name[0] == L'v' )
+        return name;
+
+    if ( instruction.mnemonic == MnemonicLdmxcsr || instruction.mnemonic == MnemonicStmxcsr )
+        return L'v' + name;
+
+    for ( size_t i = 0; i < instruction.operandCount; ++i )
+    {
+        const InstructionOperand  &operand = instruction.operands[i];
+
+        if ( operand.kind == OperandRegister && operand.reg.regClass >= RegClassXmm && operand.reg.regClass <= RegClassZmm )
+            return L'v' + name;
+    }
+
+    return name;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // end nameless namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool decodeInstruction( const void* buffer, size_t length, MEMOFFSET_64 offset, CPUType cpuMode, Instruction& instruction )
+{
+    if ( cpuMode != CPU_I386 && cpuMode != CPU_AMD64 )
+        throw DbgException( "the instruction decoder supports only I386 and AMD64 modes" );
+
+    return X86Decoder( buffer, length, offset, cpuMode, instruction ).decode();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::wstring getMnemonicName( unsigned short mnemonic )
+{
+    if ( mnemonic >= MnemonicMax )
+        throw IndexException( mnemonic );
+
+    return toWide( mnemonicNames[mnemonic] );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::wstring getInstructionRegisterName( const InstructionRegister& reg )
+{
+    unsigned char  number = reg.number;
+
+    switch( reg.regClass )
+    {
+    case RegClassGp8:
+        if ( number < sizeof(gp8Names) / sizeof(gp8Names[0]) )
+            return toWide( gp8Names[number] );
+        break;
+
+    case RegClassGp16:
+        if ( number < 16 )
+            return toWide( gp16Names[number] );
+        break;
+
+    case RegClassGp32:
+        if ( number < 16 )
+            return toWide( gp32Names[number] );
+        break;
+
+    case RegClassGp64:
+        if ( number < 16 )
+            return toWide( gp64Names[number] );
+        break;
+
+    case RegClassSegment:
+        if ( number < 6 )
+            return toWide( segmentNames[number] );
+        break;
+
+    case RegClassIp:
+        return L"rip";
+
+    case RegClassMmx:
+        return L"mm" + std::to_wstring( number );
+
+    case RegClassXmm:
+        return L"xmm" + std::to_wstring( number );
+
+    case RegClassYmm:
+        return L"ymm" + std::to_wstring( number );
+
+    case RegClassZmm:
+        return L"zmm" + std::to_wstring( number );
+
+    case RegClassSt:
+        return number == 0 ? std::wstring( L"st" ) : L"st(" + std::to_wstring( number ) + L")";
+
+    case RegClassControl:
+        return L"cr" + std::to_wstring( number );
+
+    case RegClassDebug:
+        return L"dr" + std::to_wstring( number );
+
+    case RegClassMask:
+        return L"k" + std::to_wstring( number );
+    }
+
+    throw DbgException( "unknown instruction register" );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::wstring formatInstruction( const Instruction& instruction )
+{
+    std::wstringstream  sstr;
+
+    sstr << formatAddress( instruction.offset, instruction.cpuMode == CPU_AMD64 ) << L' ';
+
+    std::wstringstream  bytes;
+    bytes << std::hex << std::setfill(L'0');
+    for ( size_t i = 0; i < instruction.length; ++i )
+        bytes << std::setw(2) << (unsigned int)instruction.bytes[i];
+
+    sstr << std::left << std::setw(15) << bytes.str() << L' ';
+
+    std::wstring  mnemonic;
+
+    if ( instruction.prefixes & PrefixLock )
+        mnemonic += L"lock ";
+
+    if ( instruction.prefixes & PrefixRep )
+        mnemonic += instruction.mnemonic == MnemonicCmps || instruction.mnemonic == MnemonicScas ? L"repe " : L"rep ";
+    else if ( instruction.prefixes & PrefixRepne )
+        mnemonic += L"repne ";
+
+    mnemonic += getVexName( instruction, getMnemonicName( instruction.mnemonic ) );
+
+    if ( instruction.operandCount == 0 )
+        return sstr.str() + mnemonic;
+
+    sstr << std::setw(7) << mnemonic << L' ';
+
+    size_t  immediates = 0;
+
+    for ( size_t i = 0; i < instruction.operandCount; ++i )
+    {
+        const InstructionOperand  &operand = instruction.operands[i];
+
+        if ( i > 0 )
+            sstr << L',';
+
+        long long  immediate = 0;
+        if ( operand.kind == OperandImmediate )
+            immediate = immediates++ == 0 ? instruction.immediate : instruction.immediate2;
+
+        sstr << formatOperand( instruction, operand, immediate );
+
+        if ( i == 0 && instruction.opmask != 0 )
+        {
+            sstr << L"{k" << (unsigned int)instruction.opmask << L'}';
+            if ( instruction.prefixes & PrefixMaskZeroing )
+                sstr << L"{z}";
+        }
+    }
+
+    return sstr.str();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
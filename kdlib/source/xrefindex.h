@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "kdlib/dbgtypedef.h"
+#include "kdlib/codeflow.h"
+
+namespace kdlib {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// A cross reference inside a module by RVAs
+
+struct XrefEntry
+{
+    boost::uint32_t  from;
+    boost::uint32_t  to;
+    boost::uint32_t  kind;          // CrossReferenceKind
+};
+
+// The references of a module sorted by the target, the source order is kept
+// as indices: both queries are binary searches
+
+class XrefIndex
+{
+public:
+
+    XrefIndex( MEMOFFSET_64 moduleBase, std::vector<XrefEntry> &entries );
+
+    MEMOFFSET_64 getModuleBase() const {
+        return m_moduleBase;
+    }
+
+    // by the target and the source
+    const std::vector<XrefEntry>& getEntries() const {
+        return m_byTarget;
+    }
+
+    void findTo( MEMOFFSET_64 offset, CrossReferenceList &references ) const;
+
+    void findFrom( MEMOFFSET_64 offset, CrossReferenceList &references ) const;
+
+private:
+
+    CrossReference makeReference( const XrefEntry &entry ) const;
+
+    MEMOFFSET_64  m_moduleBase;
+    std::vector<XrefEntry>  m_byTarget;
+    std::vector<boost::uint32_t>  m_bySource;   // indices in m_byTarget
+};
+
+typedef boost::shared_ptr<const XrefIndex>  XrefIndexPtr;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The index file of a module is valid while the module has the same timestamp
+// and checksum and is decoded in the same mode. The loader returns null if
+// there is no valid file, the errors of the saving are ignored: the file is
+// only a cache.
+
+XrefIndexPtr loadXrefIndex( const std::wstring &fileName, MEMOFFSET_64 moduleBase, CPUType cpuMode, unsigned long timeStamp, unsigned long checkSum );
+
+void saveXrefIndex( const std::wstring &fileName, const XrefIndex &index, CPUType cpuMode, unsigned long timeStamp, unsigned long checkSum );
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // kdlib namespace end
@@ -0,0 +1,156 @@
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "kdlib/instruction.h"
+#include "kdlib/exceptions.h"
+
+using namespace kdlib;
+
+static Instruction decode(const std::vector<unsigned char>& bytes, CPUType cpuMode = CPU_AMD64)
+{
+    Instruction  instruction;
+    EXPECT_TRUE(decodeInstruction(&bytes[0], bytes.size(), 0x140001000, cpuMode, instruction));
+    return instruction;
+}
+
+TEST(X86DecoderTest, Format)
+{
+    EXPECT_EQ(std::wstring(L"00000001`40001000 4883ec28        sub     rsp,28h"), formatInstruction(decode({ 0x48, 0x83, 0xEC, 0x28 })));
+    EXPECT_EQ(std::wstring(L"00000001`40001000 65488b042530000000 mov     rax,qword ptr gs:[30h]"), formatInstruction(decode({ 0x65, 0x48, 0x8B, 0x04, 0x25, 0x30, 0x00, 0x00, 0x00 })));
+    EXPECT_EQ(std::wstring(L"00000001`40001000 f3aa            rep stos byte ptr [rdi]"), formatInstruction(decode({ 0xF3, 0xAA })));
+    EXPECT_EQ(std::wstring(L"00000001`40001000 c5fc28c1        vmovaps ymm0,ymm1"), formatInstruction(decode({ 0xC5, 0xFC, 0x28, 0xC1 })));
+    EXPECT_EQ(std::wstring(L"40001000 8b442404        mov     eax,dword ptr [esp+4]"), formatInstruction(decode({ 0x8B, 0x44, 0x24, 0x04 }, CPU_I386)));
+    EXPECT_EQ(std::wstring(L"40001000 a100104000      mov     eax,dword ptr ds:[00401000h]"), formatInstruction(decode({ 0xA1, 0x00, 0x10, 0x40, 0x00 }, CPU_I386)));
+}
+
+struct FormatVector {
+    CPUType  cpuMode;
+    std::vector<unsigned char>  bytes;
+    const wchar_t*  text;
+};
+
+TEST(X86DecoderTest, FormatTable)
+{
+    const FormatVector  vectors[] = {
+        // ModRM and SIB
+        { CPU_AMD64, { 0x8B, 0x04, 0x24 }, L"mov     eax,dword ptr [rsp]" },
+        { CPU_AMD64, { 0x8B, 0x44, 0x8D, 0x10 }, L"mov     eax,dword ptr [rbp+rcx*4+10h]" },
+        { CPU_AMD64, { 0x8B, 0x04, 0xCD, 0x00, 0x10, 0x00, 0x00 }, L"mov     eax,dword ptr [rcx*8+1000h]" },
+        { CPU_AMD64, { 0x42, 0x8B, 0x04, 0xA0 }, L"mov     eax,dword ptr [rax+r12*4]" },
+        { CPU_AMD64, { 0x41, 0x8B, 0x45, 0x00 }, L"mov     eax,dword ptr [r13]" },
+        { CPU_AMD64, { 0x8B, 0x84, 0x24, 0x00, 0x01, 0x00, 0x00 }, L"mov     eax,dword ptr [rsp+100h]" },
+        { CPU_AMD64, { 0x8B, 0x44, 0x24, 0xF8 }, L"mov     eax,dword ptr [rsp-8]" },
+        { CPU_I386, { 0x8B, 0x04, 0x8D, 0x00, 0x20, 0x40, 0x00 }, L"mov     eax,dword ptr [ecx*4+402000h]" },
+        { CPU_I386, { 0x8B, 0x45, 0xFC }, L"mov     eax,dword ptr [ebp-4]" },
+
+        // RIP relative
+        { CPU_AMD64, { 0x4C, 0x8D, 0x05, 0x10, 0x00, 0x00, 0x00 }, L"lea     r8,[00000001`40001017]" },
+        { CPU_AMD64, { 0xFF, 0x15, 0xFA, 0x0F, 0x00, 0x00 }, L"call    qword ptr [00000001`40002000]" },
+        { CPU_AMD64, { 0xFF, 0x25, 0xFA, 0x0F, 0x00, 0x00 }, L"jmp     qword ptr [00000001`40002000]" },
+        { CPU_AMD64, { 0x66, 0x0F, 0x6F, 0x05, 0xF8, 0x0F, 0x00, 0x00 }, L"movdqa  xmm0,xmmword ptr [00000001`40002000]" },
+
+        // prefixes
+        { CPU_AMD64, { 0xF0, 0x0F, 0xB1, 0x0A }, L"lock cmpxchg dword ptr [rdx],ecx" },
+        { CPU_AMD64, { 0x66, 0x89, 0x08 }, L"mov     word ptr [rax],cx" },
+        { CPU_AMD64, { 0x67, 0x8B, 0x00 }, L"mov     eax,dword ptr [eax]" },
+        { CPU_AMD64, { 0xF2, 0xAE }, L"repne scas byte ptr [rdi]" },
+        { CPU_AMD64, { 0xF3, 0x48, 0xA5 }, L"rep movs qword ptr [rdi],qword ptr [rsi]" },
+        { CPU_I386, { 0x64, 0x8B, 0x00 }, L"mov     eax,dword ptr fs:[eax]" },
+
+        // VEX
+        { CPU_AMD64, { 0xC5, 0xF8, 0x77 }, L"vzeroupper" },
+        { CPU_AMD64, { 0xC5, 0xF1, 0xEF, 0xC2 }, L"vpxor   xmm0,xmm1,xmm2" },
+        { CPU_AMD64, { 0xC4, 0xC1, 0x7C, 0x28, 0xC0 }, L"vmovaps ymm0,ymm8" },
+        { CPU_AMD64, { 0xC4, 0xE2, 0x7D, 0x18, 0x05, 0xF7, 0x0F, 0x00, 0x00 }, L"vbroadcastss ymm0,dword ptr [00000001`40002000]" },
+        { CPU_AMD64, { 0xC4, 0xE2, 0x78, 0xF2, 0xC1 }, L"andn    eax,eax,ecx" },
+    };
+
+    for (const FormatVector& vector : vectors)
+    {
+        Instruction  instruction = decode(vector.bytes, vector.cpuMode);
+        EXPECT_EQ(vector.bytes.size(), instruction.length) << vector.text;
+
+        // the text after the address and the bytes
+        std::wstring  text = formatInstruction(instruction);
+        size_t  pos = text.find(L' ');
+        pos = text.find_first_not_of(L' ', text.find(L' ', pos + 1));
+        EXPECT_EQ(std::wstring(vector.text), text.substr(pos));
+    }
+}
+
+TEST(X86DecoderTest, LengthLimit)
+{
+    Instruction  instruction;
+
+    // 14 prefixes and the opcode: 15 bytes
+    std::vector<unsigned char>  code(14, 0x66);
+    code.push_back(0x90);
+    EXPECT_TRUE(decodeInstruction(&code[0], code.size(), 0x140001000, CPU_AMD64, instruction));
+    EXPECT_EQ(15, instruction.length);
+
+    // one more prefix makes it 16 bytes
+    code.insert(code.begin(), 0x66);
+    EXPECT_FALSE(decodeInstruction(&code[0], code.size(), 0x140001000, CPU_AMD64, instruction));
+    EXPECT_EQ(MnemonicInvalid, instruction.mnemonic);
+
+    // the prefixes and the operands: 15 bytes are valid, 16 are not
+    code.assign(11, 0x2E);
+    code.insert(code.end(), { 0x48, 0x8B, 0x04, 0x24 });
+    EXPECT_TRUE(decodeInstruction(&code[0], code.size(), 0x140001000, CPU_AMD64, instruction));
+    EXPECT_EQ(15, instruction.length);
+
+    code.insert(code.begin(), 0x2E);
+    EXPECT_FALSE(decodeInstruction(&code[0], code.size(), 0x140001000, CPU_AMD64, instruction));
+
+    // a 16 byte instruction is rejected even if the buffer is longer
+    code.insert(code.end(), 8, 0x90);
+    EXPECT_FALSE(decodeInstruction(&code[0], code.size(), 0x140001000, CPU_AMD64, instruction));
+}
+
+TEST(X86DecoderTest, Decode)
+{
+    Instruction  instruction = decode({ 0x48, 0x83, 0xEC, 0x28 });
+    EXPECT_EQ(4, instruction.length);
+    EXPECT_EQ(MnemonicSub, instruction.mnemonic);
+    EXPECT_EQ(2, instruction.operandCount);
+    EXPECT_EQ(OperandRegister, instruction.operands[0].kind);
+    EXPECT_EQ(std::wstring(L"rsp"), getInstructionRegisterName(instruction.operands[0].reg));
+    EXPECT_EQ(OperandImmediate, instruction.operands[1].kind);
+    EXPECT_EQ(0x28, instruction.immediate);
+
+    instruction = decode({ 0xE8, 0xFB, 0x0F, 0x00, 0x00 });
+    EXPECT_EQ(MnemonicCall, instruction.mnemonic);
+    EXPECT_EQ(FlowCall, instruction.flow);
+    EXPECT_EQ(0x140002000, instruction.target);
+
+    instruction = decode({ 0x48, 0x8B, 0x05, 0x12, 0x00, 0x00, 0x00 });
+    EXPECT_EQ(7, instruction.length);
+    EXPECT_EQ(OperandMemory, instruction.operands[1].kind);
+    EXPECT_EQ(0x140001019, instruction.ea);
+
+    instruction = decode({ 0xF3, 0xAA });
+    EXPECT_EQ(MnemonicStos, instruction.mnemonic);
+    EXPECT_NE(0, instruction.prefixes & PrefixRep);
+
+    EXPECT_EQ(FlowReturn, decode({ 0xC3 }).flow);
+    EXPECT_EQ(FlowStop, decode({ 0x0F, 0x0B }).flow);
+}
+
+TEST(X86DecoderTest, Invalid)
+{
+    Instruction  instruction;
+
+    // push es is not valid in the 64-bit mode
+    const unsigned char  pushEs[] = { 0x06 };
+    EXPECT_FALSE(decodeInstruction(pushEs, sizeof(pushEs), 0x140001000, CPU_AMD64, instruction));
+    EXPECT_EQ(MnemonicInvalid, instruction.mnemonic);
+    EXPECT_EQ(1, instruction.length);
+
+    EXPECT_TRUE(decodeInstruction(pushEs, sizeof(pushEs), 0x40001000, CPU_I386, instruction));
+    EXPECT_EQ(1, instruction.length);
+
+    // truncated
+    const unsigned char  movRax[] = { 0x48, 0xB8, 0x00, 0x00 };
+    EXPECT_FALSE(decodeInstruction(movRax, sizeof(movRax), 0x140001000, CPU_AMD64, instruction));
+    EXPECT_THROW(getMnemonicName(MnemonicMax), IndexException);
+}
@@ -0,0 +1,162 @@
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "../../source/fnmatch.h"
+#include "../kdlibtest/benchmark.h"
+
+using namespace kdlib;
+
+TEST(GlobMatcherTest, Literal)
+{
+    EXPECT_TRUE(GlobMatcher(L"GetProcAddress").match(L"GetProcAddress"));
+    EXPECT_FALSE(GlobMatcher(L"GetProcAddress").match(L"GetProcAddressA"));
+    EXPECT_FALSE(GlobMatcher(L"GetProcAddress").match(L"getprocaddress"));
+    EXPECT_TRUE(GlobMatcher(L"").match(L""));
+    EXPECT_FALSE(GlobMatcher(L"").match(L"a"));
+    EXPECT_TRUE(GlobMatcher(L"a.b(c)+d").match(L"a.b(c)+d"));
+}
+
+TEST(GlobMatcherTest, Star)
+{
+    EXPECT_TRUE(GlobMatcher(L"*").match(L""));
+    EXPECT_TRUE(GlobMatcher(L"**").match(L"anything"));
+    EXPECT_TRUE(GlobMatcher(L"Get*").match(L"Get"));
+    EXPECT_TRUE(GlobMatcher(L"Get*").match(L"GetProcAddress"));
+    EXPECT_FALSE(GlobMatcher(L"Get*").match(L"LdrGetProcedureAddress"));
+    EXPECT_TRUE(GlobMatcher(L"*Address").match(L"GetProcAddress"));
+    EXPECT_FALSE(GlobMatcher(L"*Address").match(L"GetProcAddressA"));
+    EXPECT_TRUE(GlobMatcher(L"*Proc*").match(L"GetProcAddress"));
+    EXPECT_FALSE(GlobMatcher(L"*Proc*").match(L"GetModuleHandle"));
+    EXPECT_TRUE(GlobMatcher(L"G*P*s").match(L"GetProcAddress"));
+    EXPECT_FALSE(GlobMatcher(L"G*P*A").match(L"GetProcAddress"));
+    EXPECT_TRUE(GlobMatcher(L"*d*ss").match(L"GetProcAddress"));
+    EXPECT_TRUE(GlobMatcher(L"a*a*a").match(L"aaa"));
+    EXPECT_FALSE(GlobMatcher(L"a*a*a").match(L"aa"));
+}
+
+TEST(GlobMatcherTest, Any)
+{
+    EXPECT_TRUE(GlobMatcher(L"?").match(L"a"));
+    EXPECT_FALSE(GlobMatcher(L"?").match(L""));
+    EXPECT_FALSE(GlobMatcher(L"?").match(L"ab"));
+    EXPECT_TRUE(GlobMatcher(L"Get?rocAddress").match(L"GetProcAddress"));
+    EXPECT_TRUE(GlobMatcher(L"*Address?").match(L"GetProcAddressA"));
+    EXPECT_FALSE(GlobMatcher(L"*Address?").match(L"GetProcAddress"));
+    EXPECT_TRUE(GlobMatcher(L"?*?").match(L"ab"));
+    EXPECT_FALSE(GlobMatcher(L"?*?").match(L"a"));
+}
+
+TEST(GlobMatcherTest, Set)
+{
+    EXPECT_TRUE(GlobMatcher(L"CreateFile[AW]").match(L"CreateFileA"));
+    EXPECT_TRUE(GlobMatcher(L"CreateFile[AW]").match(L"CreateFileW"));
+    EXPECT_FALSE(GlobMatcher(L"CreateFile[AW]").match(L"CreateFile"));
+    EXPECT_FALSE(GlobMatcher(L"CreateFile[AW]").match(L"CreateFile2"));
+    EXPECT_TRUE(GlobMatcher(L"r[0-9]").match(L"r8"));
+    EXPECT_FALSE(GlobMatcher(L"r[0-9]").match(L"rx"));
+    EXPECT_TRUE(GlobMatcher(L"r[9-0]").match(L"r5"));
+    EXPECT_TRUE(GlobMatcher(L"r[!0-9]").match(L"rx"));
+    EXPECT_FALSE(GlobMatcher(L"r[!0-9]").match(L"r8"));
+    EXPECT_FALSE(GlobMatcher(L"r[^0-9]").match(L"r8"));
+    EXPECT_TRUE(GlobMatcher(L"[]]").match(L"]"));
+    EXPECT_TRUE(GlobMatcher(L"[a-]").match(L"-"));
+    EXPECT_TRUE(GlobMatcher(L"*[AW]").match(L"CreateFileW"));
+
+    // not closed set is literal
+    EXPECT_TRUE(GlobMatcher(L"a[b").match(L"a[b"));
+    EXPECT_FALSE(GlobMatcher(L"a[b").match(L"ab"));
+}
+
+TEST(GlobMatcherTest, NoSetClasses)
+{
+    EXPECT_TRUE(GlobMatcher(L"operator[]", true, false).match(L"operator[]"));
+    EXPECT_TRUE(GlobMatcher(L"*[]", true, false).match(L"operator[]"));
+    EXPECT_TRUE(GlobMatcher(L"CreateFile[AW]", true, false).match(L"CreateFile[AW]"));
+    EXPECT_FALSE(GlobMatcher(L"CreateFile[AW]", true, false).match(L"CreateFileA"));
+}
+
+TEST(GlobMatcherTest, CaseInsensitive)
+{
+    EXPECT_TRUE(GlobMatcher(L"getprocaddress", false).match(L"GetProcAddress"));
+    EXPECT_TRUE(GlobMatcher(L"get*", false).match(L"GetProcAddress"));
+    EXPECT_TRUE(GlobMatcher(L"*ADDRESS", false).match(L"GetProcAddress"));
+    EXPECT_TRUE(GlobMatcher(L"*pROC*", false).match(L"GetProcAddress"));
+    EXPECT_TRUE(GlobMatcher(L"g?t*ADD*s", false).match(L"GetProcAddress"));
+    EXPECT_TRUE(GlobMatcher(L"createfile[aw]", false).match(L"CreateFileW"));
+    EXPECT_TRUE(GlobMatcher(L"createfile[A-Z]", false).match(L"CreateFilew"));
+    EXPECT_FALSE(GlobMatcher(L"createfile[!aw]", false).match(L"CreateFileW"));
+    EXPECT_FALSE(GlobMatcher(L"get*", true).match(L"GetProcAddress"));
+
+    EXPECT_TRUE(GlobMatcherA("*proc*", false).match("GetProcAddress"));
+    EXPECT_FALSE(GlobMatcherA("*proc*", true).match("GetProcAddress"));
+}
+
+TEST(GlobMatcherTest, Fnmatch)
+{
+    EXPECT_TRUE(fnmatch(std::wstring(L"Get*Address"), std::wstring(L"GetProcAddress")));
+    EXPECT_TRUE(fnmatch(std::string("CreateFile[AW]"), std::string("CreateFileA")));
+    EXPECT_FALSE(fnmatch(std::string("createfile*"), std::string("CreateFileA")));
+}
+
+// the mask matching replaced by GlobMatcher: the mask is rewritten to a regex
+// and compiled for each name (the dots are escaped first, unlike the old code)
+static bool regexFnmatch(const std::wstring& pattern, const std::wstring& str)
+{
+    std::wstring  mask = pattern;
+    mask = std::regex_replace(mask, std::wregex(L"\\."), L"\\.");
+    mask = std::regex_replace(mask, std::wregex(L"\\?"), L".");
+    mask = std::regex_replace(mask, std::wregex(L"\\*"), L".*");
+
+    return std::regex_match(str, std::wregex(mask));
+}
+
+TEST(GlobMatcherTest, RegexBaseline)
+{
+    const wchar_t*  masks[] = { L"Module*", L"*W", L"M?dule*[0-4]?", L"*f*1*2*" };
+    const wchar_t*  names[] = { L"ModuleFunction12W", L"ModuleFunction3A", L"Other" };
+
+    for (auto mask : masks)
+    {
+        for (auto name : names)
+            EXPECT_EQ(regexFnmatch(mask, name), GlobMatcher(mask).match(name)) << mask << L" " << name;
+    }
+}
+
+TEST(GlobMatcherTest, DISABLED_Benchmark)
+{
+    std::vector<std::wstring>  names;
+    for (int i = 0; i < 100000; ++i)
+        names.push_back(L"ModuleFunction" + std::to_wstring(i) + (i % 2 ? L"A" : L"W"));
+
+    const wchar_t*  masks[] = { L"ModuleFunction12345W", L"Module*", L"*W", L"*Function1*", L"M?dule*[0-4]?", L"*f*1*2*" };
+
+    for (size_t i = 0; i < sizeof(masks) / sizeof(masks[0]); ++i)
+    {
+        GlobMatcher  matcher(masks[i]);
+
+        size_t  globCount = 0;
+
+        long long  globElapsed = measureMicroseconds([&] {
+            for (auto& name : names)
+                globCount += matcher.match(name) ? 1 : 0;
+        });
+
+        size_t  regexCount = 0;
+
+        long long  regexElapsed = measureMicroseconds([&] {
+            for (auto& name : names)
+                regexCount += regexFnmatch(masks[i], name) ? 1 : 0;
+        });
+
+        EXPECT_EQ(regexCount, globCount);
+
+        const std::string  key = "mask" + std::to_string(i);
+
+        recordRate(key + "_glob_names_per_s", names.size(), globElapsed);
+        recordRate(key + "_regex_names_per_s", names.size(), regexElapsed);
+        recordBenchmark(key + "_speedup", regexElapsed / (globElapsed + 1));
+    }
+}
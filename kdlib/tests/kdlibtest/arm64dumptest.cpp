@@ -1,6 +1,10 @@
 #include <stdafx.h>
 
+#include <algorithm>
+
 #include "memdumpfixture.h"
+#include "benchmark.h"
+#include "regnames.h"
 
 #include "kdlib/typeinfo.h"
 #include "kdlib/memaccess.h"
@@ -96,3 +100,62 @@ TEST_F(ARM64KernelMiniDump, DumpType)
     EXPECT_TRUE(isKernelDebugging());
     EXPECT_EQ(DumpType::KernelSmall, getDumpType());
 }
+
+TEST_F(ARM64KernelMiniDump, RegisterTable)
+{
+    CPUContextPtr  cpu;
+    ASSERT_NO_THROW( cpu = loadCPUContext() );
+
+    checkRegisterNames( cpu, arm64RegisterNames );
+}
+
+TEST_F(ARM64KernelMiniDump, UnwindStack)
+{
+    const auto engineStack = getStack();
+    const auto stack = unwindStack();
+
+    ASSERT_LE( engineStack->getFrameCount(), stack->getFrameCount() );
+
+    for ( unsigned long i = 0; i < engineStack->getFrameCount(); ++i )
+    {
+        EXPECT_EQ( engineStack->getFrame(i)->getIP(), stack->getFrame(i)->getIP() );
+        EXPECT_EQ( engineStack->getFrame(i)->getSP(), stack->getFrame(i)->getSP() );
+        EXPECT_EQ( engineStack->getFrame(i)->getRET(), stack->getFrame(i)->getRET() );
+    }
+
+    EXPECT_EQ( std::wstring(L"KeBugCheck2"), findSymbol(stack->getFrame(0)->getIP()) );
+    EXPECT_EQ( std::wstring(L"FxRequest::CompleteInternal"), findSymbol(stack->getFrame(11)->getIP()) );
+
+    auto frame = stack->getFrame(11);
+    EXPECT_EQ( frame->getIP(), frame->getCPUContext()->getIP() );
+    EXPECT_EQ( frame->getSP(), frame->getCPUContext()->getSP() );
+}
+
+TEST_F(ARM64KernelMiniDump, DISABLED_UnwindStackBenchmark)
+{
+    const size_t  iterations = 1000;
+
+    unwindStack();
+
+    size_t  frames = 0;
+
+    long long  elapsed = measureMicroseconds([&frames] { frames += unwindStack()->getFrameCount(); }, iterations);
+
+    recordRate("unwind_frames_per_s", frames, elapsed);
+}
+
+TEST_F(ARM64KernelMiniDump, ScanStack)
+{
+    const auto stack = getStack();
+    const auto frames = scanStackForReturnAddresses();
+
+    for ( unsigned long i = 0; i < 11; ++i )
+    {
+        MEMOFFSET_64  returnAddress = stack->getFrame(i)->getRET();
+
+        auto it = std::find_if( frames.begin(), frames.end(), [=](const ScannedFrame &frame) { return frame.returnAddress == returnAddress; } );
+        ASSERT_NE( frames.end(), it );
+
+        EXPECT_EQ( returnAddress - 4, it->callSite );
+    }
+}
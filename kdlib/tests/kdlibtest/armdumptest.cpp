@@ -1,6 +1,7 @@
 #include <stdafx.h>
 
 #include "memdumpfixture.h"
+#include "regnames.h"
 
 #include "kdlib/typeinfo.h"
 #include "kdlib/memaccess.h"
@@ -85,3 +86,11 @@ TEST_F(ARMKernelMiniDump, DumpType)
     EXPECT_EQ(DumpType::KernelSmall, getDumpType());
 }
 
+TEST_F(ARMKernelMiniDump, RegisterTable)
+{
+    CPUContextPtr  cpu;
+    ASSERT_NO_THROW( cpu = loadCPUContext() );
+
+    checkRegisterNames( cpu, armRegisterNames );
+}
+
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+#include "gtest/gtest.h"
+
+// Helpers for the DISABLED_*Benchmark tests. The results are recorded as test
+// properties and appear in the --gtest_output=xml report, not on the console
+
+// Runs func count times and returns the elapsed time in microseconds
+template<typename Func>
+long long measureMicroseconds( Func func, size_t count = 1 )
+{
+    auto  start = std::chrono::steady_clock::now();
+
+    for ( size_t i = 0; i < count; ++i )
+        func();
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+inline void recordBenchmark( const std::string& key, long long value )
+{
+    ::testing::Test::RecordProperty( key, std::to_string(value) );
+}
+
+// Records the count of operations done in the elapsed time as a per second rate
+inline void recordRate( const std::string& key, size_t count, long long microseconds )
+{
+    recordBenchmark( key, static_cast<long long>(count) * 1000000 / ( microseconds + 1 ) );
+}
@@ -1,6 +1,14 @@
 #include <stdafx.h>
 
+#include <algorithm>
+#include <sstream>
+
+#include <windows.h>
+
+#include <boost/thread/thread.hpp>
+
 #include "procfixture.h"
+#include "benchmark.h"
 
 #include "kdlib/typeinfo.h"
 
@@ -389,6 +397,16 @@ TEST_F(ClangTest, TypeProviderEnum)
     ASSERT_NO_THROW( typeEnum = typeProvider->getTypeEnumerator(L"struct*") );
     for ( count = 0; 0 != typeEnum->Next(); ++count);
     EXPECT_EQ(14, count);
+
+    // the types come sorted by name
+    std::vector<std::wstring>  names;
+    TypeInfoPtr  typeInfo;
+
+    ASSERT_NO_THROW( typeEnum = typeProvider->getTypeEnumerator(L"struct*") );
+    while ( 0 != ( typeInfo = typeEnum->Next() ) )
+        names.push_back( typeInfo->getName() );
+
+    EXPECT_TRUE( std::is_sorted(names.begin(), names.end()) );
 }
 
 
@@ -639,3 +657,403 @@ TEST_F(ClangTest, Func)
     EXPECT_THROW(compileType(srcCode, L"testcls1::method"), TypeException);
     EXPECT_THROW(compileType(srcCode, L"testcls1<char>::method"), TypeException);
 }
+
+TEST_F(ClangTest, ASTCache)
+{
+    TypeInfoProviderPtr  provider1, provider2;
+
+    clearClangASTCache();
+    ClangASTCacheStats  stats = getClangASTCacheStats();
+
+    // the second provider takes the parsed AST from the cache
+    ASSERT_NO_THROW( provider1 = getTypeInfoProviderFromSource(test_code1) );
+    ASSERT_NO_THROW( provider2 = getTypeInfoProviderFromSource(test_code1) );
+
+    EXPECT_EQ( stats.parseCount + 1, getClangASTCacheStats().parseCount );
+    EXPECT_EQ( stats.hitCount + 1, getClangASTCacheStats().hitCount );
+    EXPECT_EQ( 1, getClangASTCacheStats().entryCount );
+
+    EXPECT_EQ( provider1->getTypeByName(L"TestStruct")->getSize(), provider2->getTypeByName(L"TestStruct")->getSize() );
+
+    clearClangASTCache();
+    EXPECT_EQ( L"TestStruct", provider1->getTypeByName(L"TestStruct")->getName() );
+
+    setClangASTCacheSize(0);
+    EXPECT_NO_THROW( compileType(test_code1, L"TestStruct") );
+    setClangASTCacheSize(4);
+}
+
+static void buildTypesThread( size_t structSize, int* errors )
+{
+    for ( int i = 0; i < 100; ++i )
+    {
+        try {
+
+            // each provider builds its own types from the shared AST
+            TypeInfoPtr  compiledStruct = getTypeInfoProviderFromSource(test_code1)->getTypeByName(L"TestStruct");
+
+            if ( compiledStruct->getSize() != structSize || !compiledStruct->getElement(L"b2")->isArray() )
+                ++*errors;
+
+        } catch ( DbgException& )
+        {
+            ++*errors;
+        }
+    }
+}
+
+TEST_F(ClangTest, ASTCacheThreads)
+{
+    size_t  structSize = 0;
+    ASSERT_NO_THROW( structSize = getTypeInfoProviderFromSource(test_code1)->getTypeByName(L"TestStruct")->getSize() );
+
+    std::vector<int>  errors(4, 0);
+    boost::thread_group  threads;
+
+    for ( size_t i = 0; i < errors.size(); ++i )
+        threads.create_thread( boost::bind( &buildTypesThread, structSize, &errors[i] ) );
+
+    threads.join_all();
+
+    for ( size_t i = 0; i < errors.size(); ++i )
+        EXPECT_EQ( 0, errors[i] );
+}
+
+TEST_F(ClangTest, CompileTypeCache)
+{
+    static const wchar_t  srcCode[] = L"struct Test1 { int a; }; struct Test2 { Test1 b[2]; };";
+
+    TypeInfoPtr  type1, type2;
+
+    // the source is indexed once, a type is built once
+    ASSERT_NO_THROW( type1 = compileType(srcCode, L"Test1") );
+    ASSERT_NO_THROW( type2 = compileType(srcCode, L"Test2") );
+
+    EXPECT_EQ( type1, compileType(srcCode, L"Test1") );
+    EXPECT_EQ( type2, compileType(srcCode, L"Test2") );
+
+    EXPECT_NE( type1, compileType(srcCode, L"Test1", L"-m32") );
+
+    clearClangASTCache();
+    EXPECT_NE( type1, compileType(srcCode, L"Test1") );
+    EXPECT_EQ( type1->getSize(), compileType(srcCode, L"Test1")->getSize() );
+}
+
+TEST_F(ClangTest, ProviderFromSources)
+{
+    std::vector<std::wstring>  sources;
+    sources.push_back(L"struct Test1; struct Test2 { int a; };");
+    sources.push_back(L"struct Test1 { char b[3]; }; struct Test2 { char a[5]; };");
+    sources.push_back(L"typedef unsigned char Test3;");
+
+    TypeInfoProviderPtr  typeProvider;
+    SourceParseResultList  results;
+
+    ASSERT_NO_THROW( typeProvider = getTypeInfoProviderFromSources(sources, L"", 2, &results) );
+
+    ASSERT_EQ( sources.size(), results.size() );
+    for ( auto it = results.begin(); it != results.end(); ++it )
+        EXPECT_TRUE( it->parsed );
+
+    // the definition wins over the forward declaration, else the first source wins
+    EXPECT_EQ( 3, typeProvider->getTypeByName(L"Test1")->getSize() );
+    EXPECT_EQ( 4, typeProvider->getTypeByName(L"Test2")->getSize() );
+    EXPECT_EQ( 1, typeProvider->getTypeByName(L"Test3")->getSize() );
+    EXPECT_THROW( typeProvider->getTypeByName(L"Test4"), TypeException );
+
+    TypeInfoEnumeratorPtr  typeEnum;
+    size_t  count;
+
+    ASSERT_NO_THROW( typeEnum = typeProvider->getTypeEnumerator(L"Test*") );
+    for ( count = 0; 0 != typeEnum->Next(); ++count);
+    EXPECT_EQ( 3, count );
+
+    // sorted by name over all the sources
+    ASSERT_NO_THROW( typeEnum = typeProvider->getTypeEnumerator(L"Test*") );
+    EXPECT_EQ( L"Test1", typeEnum->Next()->getName() );
+    EXPECT_EQ( L"Test2", typeEnum->Next()->getName() );
+
+    // a failed source does not fail the batch
+    ASSERT_NO_THROW( typeProvider = getTypeInfoProviderFromSources(sources, L"--target=unknown-target", 0, &results) );
+
+    ASSERT_EQ( sources.size(), results.size() );
+    for ( auto it = results.begin(); it != results.end(); ++it )
+    {
+        EXPECT_FALSE( it->parsed );
+        EXPECT_FALSE( it->error.empty() );
+    }
+
+    EXPECT_THROW( typeProvider->getTypeByName(L"Test1"), TypeException );
+}
+
+TEST_F(ClangTest, AppendSource)
+{
+    TypeInfoProviderPtr  typeProvider;
+    ASSERT_NO_THROW( typeProvider = getTypeInfoProviderFromSource(L"struct Base { int a; }; struct Later;") );
+
+    TypeInfoPtr  baseType = typeProvider->getTypeByName(L"Base");
+    EXPECT_THROW( typeProvider->getTypeByName(L"Ext1"), TypeException );
+
+    ASSERT_NO_THROW( typeProvider->appendSource(L"struct Ext1 { Base b[2]; };") );
+    ASSERT_NO_THROW( typeProvider->appendSource(L"struct Ext2 { Ext1 e; char c; }; struct Later { char d[3]; };") );
+
+    // the types returned before stay the same
+    EXPECT_EQ( baseType, typeProvider->getTypeByName(L"Base") );
+    EXPECT_EQ( 4, baseType->getSize() );
+
+    EXPECT_EQ( 8, typeProvider->getTypeByName(L"Ext1")->getSize() );
+    EXPECT_EQ( 12, typeProvider->getTypeByName(L"Ext2")->getSize() );
+    EXPECT_EQ( 8, typeProvider->getTypeByName(L"Ext2")->getElement(L"e")->getElement(L"b")->getSize() );
+    EXPECT_EQ( 3, typeProvider->getTypeByName(L"Later")->getSize() );
+
+    TypeInfoEnumeratorPtr  typeEnum;
+    size_t  count;
+
+    ASSERT_NO_THROW( typeEnum = typeProvider->getTypeEnumerator(L"Ext*") );
+    for ( count = 0; 0 != typeEnum->Next(); ++count);
+    EXPECT_EQ( 2, count );
+
+    EXPECT_THROW( getDefaultTypeInfoProvider()->appendSource(L"struct Ext3 {};"), TypeException );
+}
+
+TEST_F(ClangTest, AppendSourcePrecompiled)
+{
+    TypeInfoProviderPtr  typeProvider;
+    ASSERT_NO_THROW( typeProvider = getTypeInfoProviderFromSource(L"struct Base { int a; };") );
+
+    // more than the appended source parsed again by each append
+    std::wstringstream  largeSource;
+    for ( int i = 0; i < 2000; ++i )
+        largeSource << L"struct Large" << i << L" { Base b; char c[" << i % 7 + 1 << L"]; };\n";
+
+    ASSERT_NO_THROW( typeProvider->appendSource(largeSource.str()) );
+
+    TypeInfoPtr  largeType = typeProvider->getTypeByName(L"Large1999");
+
+    // the next appends are parsed over the source precompiled with the first one
+    ASSERT_NO_THROW( typeProvider->appendSource(L"struct Ext1 { Large3 l; Base b; };") );
+    ASSERT_NO_THROW( typeProvider->appendSource(L"struct Ext2 { Ext1 e[2]; };") );
+
+    EXPECT_EQ( largeType, typeProvider->getTypeByName(L"Large1999") );
+    EXPECT_EQ( 12, typeProvider->getTypeByName(L"Ext1")->getSize() );
+    EXPECT_EQ( 24, typeProvider->getTypeByName(L"Ext2")->getSize() );
+
+    TypeInfoEnumeratorPtr  typeEnum;
+    size_t  count;
+
+    // a precompiled declaration is indexed once
+    ASSERT_NO_THROW( typeEnum = typeProvider->getTypeEnumerator(L"Large*") );
+    for ( count = 0; 0 != typeEnum->Next(); ++count);
+    EXPECT_EQ( 2000, count );
+}
+
+TEST_F(ClangTest, AppendSourceEvalType)
+{
+    TypeInfoProviderPtr  typeProvider;
+    ASSERT_NO_THROW( typeProvider = getTypeInfoProviderFromSource(L"struct Later;") );
+
+    // the evaluated type is cached for the provider
+    TypeInfoPtr  forwardType = evalType(L"Later*", typeProvider);
+    EXPECT_EQ( forwardType, evalType(L"Later*", typeProvider) );
+    EXPECT_THROW( forwardType->deref()->getSize(), TypeException );
+
+    unsigned long  generation = typeProvider->getGeneration();
+
+    ASSERT_NO_THROW( typeProvider->appendSource(L"struct Later { char d[3]; };") );
+    EXPECT_NE( generation, typeProvider->getGeneration() );
+
+    // the append defines the type: the cached forward declaration is not used
+    TypeInfoPtr  definedType = evalType(L"Later*", typeProvider);
+    EXPECT_NE( forwardType, definedType );
+    EXPECT_EQ( 3, definedType->deref()->getSize() );
+    EXPECT_EQ( definedType, evalType(L"Later*", typeProvider) );
+}
+
+TEST_F(ClangTest, DISABLED_AppendSourceBenchmark)
+{
+    std::wstringstream  preamble;
+    for ( int i = 0; i < 5000; ++i )
+        preamble << L"struct Preamble" << i << L" { int a; char b[" << i % 7 + 1 << L"]; void* c; };\n";
+
+    static const wchar_t  fragment[] = L"\
+        struct Fragment {               \n\
+            int  a;                     \n\
+            char  b[3];                 \n\
+            Preamble1  c;               \n\
+            Preamble2*  d;              \n\
+            unsigned long long  e;      \n\
+            short  f;                   \n\
+            float  g;                   \n\
+        };                              \n";
+
+    TypeInfoProviderPtr  typeProvider = getTypeInfoProviderFromSource(preamble.str());
+
+    // the first append precompiles the source
+    typeProvider->appendSource(L"struct First { int a; };");
+
+    long long  elapsed = measureMicroseconds([&typeProvider] {
+        typeProvider->appendSource(fragment);
+        typeProvider->getTypeByName(L"Fragment");
+    });
+
+    recordBenchmark("append_us", elapsed);
+
+    clearClangASTCache();
+
+    elapsed = measureMicroseconds([&preamble] {
+        getTypeInfoProviderFromSource(preamble.str() + fragment)->getTypeByName(L"Fragment");
+    });
+
+    recordBenchmark("full_parse_us", elapsed);
+
+    // the appends chained on the previous ones: the parsed appended source is
+    // capped, so the last appends take about the time of the first ones
+    const int  appendCount = 1000;
+    const int  sampleCount = 100;
+
+    std::vector<std::wstring>  fragments;
+    for ( int i = 0; i < appendCount; ++i )
+    {
+        std::wstringstream  sstr;
+        sstr << L"struct Chained" << i << L" { int a; char b[" << i % 7 + 1 << L"]; Preamble" << i << L" c; ";
+        if ( i > 0 )
+            sstr << L"Chained" << i - 1 << L"* d; ";
+        sstr << L"};";
+        fragments.push_back(sstr.str());
+    }
+
+    typeProvider = getTypeInfoProviderFromSource(preamble.str());
+    typeProvider->appendSource(L"struct First { int a; };");
+
+    long long  firstElapsed = 0, lastElapsed = 0, totalElapsed = 0;
+
+    for ( int i = 0; i < appendCount; ++i )
+    {
+        elapsed = measureMicroseconds([&typeProvider, &fragments, i] {
+            typeProvider->appendSource(fragments[i]);
+        });
+
+        totalElapsed += elapsed;
+
+        if ( i < sampleCount )
+            firstElapsed += elapsed;
+        else if ( i >= appendCount - sampleCount )
+            lastElapsed += elapsed;
+    }
+
+    EXPECT_NO_THROW( typeProvider->getTypeByName(L"Chained999") );
+
+    recordBenchmark("chained_append_count", appendCount);
+    recordBenchmark("chained_append_total_us", totalElapsed);
+    recordBenchmark("chained_append_first_avg_us", firstElapsed / sampleCount);
+    recordBenchmark("chained_append_last_avg_us", lastElapsed / sampleCount);
+
+    clearClangASTCache();
+
+    // the same declarations parsed at once
+    std::wstring  fullSource = preamble.str();
+    for ( int i = 0; i < appendCount; ++i )
+        fullSource += fragments[i] + L"\n";
+
+    elapsed = measureMicroseconds([&fullSource] {
+        getTypeInfoProviderFromSource(fullSource)->getTypeByName(L"Chained999");
+    });
+
+    recordBenchmark("chained_full_parse_us", elapsed);
+}
+
+// a directory in %TEMP% removed with its files
+class TempDirectory
+{
+public:
+
+    TempDirectory(const std::wstring& name)
+    {
+        wchar_t  tempPath[MAX_PATH + 1];
+        DWORD  length = GetTempPathW(MAX_PATH + 1, tempPath);
+
+        m_path = std::wstring(tempPath, length) + name + L"." + std::to_wstring(GetCurrentProcessId());
+    }
+
+    ~TempDirectory()
+    {
+        std::vector<std::wstring>  files = getFiles();
+        for ( size_t i = 0; i < files.size(); ++i )
+            DeleteFileW( (m_path + L"\\" + files[i]).c_str() );
+
+        RemoveDirectoryW(m_path.c_str());
+    }
+
+    const std::wstring& getPath() const {
+        return m_path;
+    }
+
+    std::vector<std::wstring> getFiles() const
+    {
+        std::vector<std::wstring>  files;
+
+        WIN32_FIND_DATAW  findData;
+        HANDLE  findHandle = FindFirstFileW( (m_path + L"\\*").c_str(), &findData );
+        if ( findHandle == INVALID_HANDLE_VALUE )
+            return files;
+
+        do {
+            if ( ( findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY ) == 0 )
+                files.push_back(findData.cFileName);
+        } while ( FindNextFileW(findHandle, &findData) );
+
+        FindClose(findHandle);
+
+        return files;
+    }
+
+private:
+
+    std::wstring  m_path;
+};
+
+TEST_F(ClangTest, ASTCacheDirectory)
+{
+    TempDirectory  cacheDirectory(L"kdlibtest.astcache");
+
+    ASSERT_NO_THROW( setClangASTCacheDirectory(cacheDirectory.getPath()) );
+
+    size_t  structSize = 0;
+
+    // the first call parses the source and saves the AST, the second one loads it
+    for ( int i = 0; i < 2; ++i )
+    {
+        clearClangASTCache();
+
+        ClangASTCacheStats  stats = getClangASTCacheStats();
+
+        TypeInfoPtr  compiledStruct;
+        ASSERT_NO_THROW( compiledStruct = compileType(test_code1, L"TestStruct") );
+        EXPECT_TRUE( compiledStruct->getElement(L"b2")->isArray() );
+
+        if ( i == 0 )
+        {
+            structSize = compiledStruct->getSize();
+
+            EXPECT_EQ( stats.parseCount + 1, getClangASTCacheStats().parseCount );
+            EXPECT_EQ( stats.loadCount, getClangASTCacheStats().loadCount );
+
+            // only the AST: the source is parsed from the memory
+            EXPECT_EQ( 1, cacheDirectory.getFiles().size() );
+        }
+        else
+        {
+            EXPECT_EQ( structSize, compiledStruct->getSize() );
+
+            EXPECT_EQ( stats.parseCount, getClangASTCacheStats().parseCount );
+            EXPECT_EQ( stats.loadCount + 1, getClangASTCacheStats().loadCount );
+        }
+    }
+
+    // a quoted include is looked up from the current directory, as without the cache
+    EXPECT_NO_THROW( compileType(L"#include \"../../../kdlib/include/test/testvars.h\"", L"structTest") );
+
+    // the loaded AST keeps its file open
+    setClangASTCacheDirectory(L"");
+    clearClangASTCache();
+}
@@ -0,0 +1,129 @@
+#include <stdafx.h>
+
+#include "procfixture.h"
+#include "benchmark.h"
+#include "kdlib/codeflow.h"
+#include "kdlib/disasm.h"
+
+using namespace kdlib;
+
+class CodeFlowTest : public ProcessFixture
+{
+public:
+
+    CodeFlowTest() : ProcessFixture(L"disasmtest") {}
+};
+
+TEST_F(CodeFlowTest, functionGraph)
+{
+    MEMOFFSET_64  funcOffset = m_targetModule->getSymbolVa(L"CdeclFunc");
+
+    FunctionGraphPtr  graph;
+    ASSERT_NO_THROW(graph = getFunctionGraph(funcOffset));
+
+    EXPECT_EQ(funcOffset, graph->begin);
+    ASSERT_FALSE(graph->blocks.empty());
+    EXPECT_EQ(funcOffset, graph->blocks[0].begin);
+
+    size_t  instructionCount = 0;
+
+    for (size_t i = 0; i < graph->blocks.size(); ++i)
+    {
+        const BasicBlock  &block = graph->blocks[i];
+
+        ASSERT_GT(block.instructionCount, 0U);
+        EXPECT_EQ(block.begin, graph->instructions[block.firstInstruction].offset);
+        EXPECT_EQ(i, findBasicBlock(*graph, block.begin));
+        EXPECT_EQ(i, findBasicBlock(*graph, block.end - 1));
+
+        instructionCount += block.instructionCount;
+    }
+
+    EXPECT_EQ(graph->instructions.size(), instructionCount);
+
+    for (size_t i = 0; i < graph->edges.size(); ++i)
+    {
+        EXPECT_LT(graph->edges[i].from, graph->blocks.size());
+        EXPECT_LT(graph->edges[i].to, graph->blocks.size());
+    }
+
+    EXPECT_EQ(NoBasicBlock, findBasicBlock(*graph, graph->end));
+
+    EXPECT_THROW(getFunctionGraph(funcOffset, funcOffset), DbgException);
+}
+
+TEST(CodeFlowBufferTest, overlappedGap)
+{
+    // jmp $+3; db 0E8h; ret: the gap byte decodes as a call overlapping the ret
+    const unsigned char  code[] = { 0xEB, 0x01, 0xE8, 0xC3 };
+
+    FunctionGraphPtr  graph = getFunctionGraph(code, sizeof(code), 0x1000, CPU_AMD64);
+
+    ASSERT_EQ(2, graph->instructions.size());
+    EXPECT_EQ(0x1000, graph->instructions[0].offset);
+    EXPECT_EQ(0x1003, graph->instructions[1].offset);
+
+    ASSERT_EQ(2, graph->blocks.size());
+    EXPECT_EQ(NoBasicBlock, findBasicBlock(*graph, 0x1002));
+
+    ASSERT_EQ(1, graph->edges.size());
+    EXPECT_EQ(EdgeJump, graph->edges[0].kind);
+    EXPECT_EQ(1, graph->edges[0].to);
+}
+
+TEST(CodeFlowBufferTest, branches)
+{
+    // test ecx,ecx; je $+5; xor eax,eax; ret; mov eax,1; ret
+    const unsigned char  code[] = { 0x85, 0xC9, 0x74, 0x03, 0x31, 0xC0, 0xC3, 0xB8, 0x01, 0x00, 0x00, 0x00, 0xC3 };
+
+    FunctionGraphPtr  graph = getFunctionGraph(code, sizeof(code), 0x1000, CPU_AMD64);
+
+    ASSERT_EQ(3, graph->blocks.size());
+    EXPECT_EQ(0x1000, graph->blocks[0].begin);
+    EXPECT_EQ(0x1004, graph->blocks[1].begin);
+    EXPECT_EQ(0x1007, graph->blocks[2].begin);
+
+    ASSERT_EQ(2, graph->edges.size());
+    EXPECT_EQ(EdgeBranch, graph->edges[0].kind);
+    EXPECT_EQ(2, graph->edges[0].to);
+    EXPECT_EQ(EdgeFallThrough, graph->edges[1].kind);
+    EXPECT_EQ(1, graph->edges[1].to);
+
+    EXPECT_THROW(getFunctionGraph(code, sizeof(code), 0x1000, CPU_ARM64), DbgException);
+}
+
+TEST_F(CodeFlowTest, crossReferences)
+{
+    MEMOFFSET_64  funcOffset = m_targetModule->getSymbolVa(L"CdeclFunc");
+
+    CrossReferenceList  references = getReferencesTo(funcOffset);
+    ASSERT_FALSE(references.empty());
+
+    for (size_t i = 0; i < references.size(); ++i)
+    {
+        EXPECT_EQ(funcOffset, references[i].to);
+
+        CrossReferenceList  fromReferences = getReferencesFrom(references[i].from);
+
+        bool  found = false;
+        for (size_t j = 0; j < fromReferences.size(); ++j)
+            found = found || fromReferences[j].to == funcOffset;
+
+        EXPECT_TRUE(found);
+    }
+}
+
+TEST_F(CodeFlowTest, DISABLED_crossReferencesBenchmark)
+{
+    long long  elapsed = measureMicroseconds([this] { buildCrossReferences(m_targetModule->getBase()); });
+
+    recordBenchmark("buildCrossReferences_us", elapsed);
+
+    const size_t  iterations = 10000;
+
+    MEMOFFSET_64  funcOffset = m_targetModule->getSymbolVa(L"CdeclFunc");
+
+    elapsed = measureMicroseconds([funcOffset] { getReferencesTo(funcOffset); }, iterations);
+
+    recordRate("getReferencesTo_queries_per_s", iterations, elapsed);
+}
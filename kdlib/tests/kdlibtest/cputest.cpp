@@ -2,6 +2,7 @@
 
 #include "procfixture.h"
 #include "kdlib/cpucontext.h"
+#include "regnames.h"
 
 using namespace kdlib;
 
@@ -41,6 +42,34 @@ TEST_F( CPUContextTest, RestoreContext )
     EXPECT_EQ( reg2, getRegisterByName(L"eax") );
 }
 
+TEST_F( CPUContextTest, RegistersByName )
+{
+    CPUContextPtr  cpu;
+    ASSERT_NO_THROW( cpu = loadCPUContext() );
+
+    std::wstring  name;
+    ASSERT_NO_THROW( name = cpu->getRegisterName(10) );
+    EXPECT_EQ( cpu->getRegisterByIndex(10), cpu->getRegisterByName(name) );
+
+    EXPECT_EQ( cpu->getRegisterByName(L"eax"), cpu->getRegisterByName(L"EAX") );
+    EXPECT_THROW( cpu->getRegisterByName(L"eaxx"), DbgException );
+
+    NumVariant  eax = cpu->getRegisterByName(L"eax");
+    ASSERT_NO_THROW( cpu->setRegisterByName(L"eax", eax.asULong() + 1) );
+    EXPECT_EQ( eax.asULong() + 1, cpu->getRegisterByName(L"eax").asULong() );
+}
+
+TEST_F( CPUContextTest, RegisterTable )
+{
+    CPUContextPtr  cpu;
+    ASSERT_NO_THROW( cpu = loadCPUContext() );
+
+    if ( cpu->getCPUMode() == CPU_AMD64 )
+        checkRegisterNames( cpu, amd64RegisterNames );
+    else
+        checkRegisterNames( cpu, i386RegisterNames );
+}
+
 TEST_F( CPUContextTest, GetStackRegs )
 {
     EXPECT_NO_THROW( getStackOffset() );
@@ -1,7 +1,14 @@
 #include <stdafx.h>
 
+#include <algorithm>
+#include <cwctype>
+#include <regex>
+
 #include "procfixture.h"
+#include "benchmark.h"
 #include "kdlib/disasm.h"
+#include "kdlib/instruction.h"
+#include "kdlib/memaccess.h"
 
 using namespace kdlib;
 
@@ -33,3 +40,135 @@ TEST_F(DisasmTest, disasm)
         dasm.disassemble();
     }
 }
+
+
+// The engine shows an address with a symbol as "module!symbol+offset (address)"
+// and the decoder shows the address only: the text is compared up to the
+// operand with the symbol, the operand must have the same address
+static void expectSameText(const std::wstring& engineText, const std::wstring& decodedText)
+{
+    static const std::wregex  symbolRegex(L"[^ ,\\[]+ \\(([0-9a-f]{8}(`[0-9a-f]{8})?)\\)");
+
+    std::wsmatch  match;
+    if (!std::regex_search(engineText, match, symbolRegex))
+    {
+        EXPECT_EQ(engineText, decodedText);
+        return;
+    }
+
+    size_t  operandBegin = engineText.find_last_of(L", ", match.position(0)) + 1;
+
+    EXPECT_EQ(engineText.substr(0, operandBegin), decodedText.substr(0, operandBegin)) << engineText;
+
+    // the decoder may drop the leading zeros and the ` separator
+    std::wstring  address = match[1].str();
+    address.erase(std::remove(address.begin(), address.end(), L'`'), address.end());
+    size_t  digitsBegin = address.find_first_not_of(L'0');
+    address.erase(0, digitsBegin == std::wstring::npos ? address.size() - 1 : digitsBegin);
+
+    std::wstring  operands = operandBegin < decodedText.size() ? decodedText.substr(operandBegin) : std::wstring();
+    operands.erase(std::remove(operands.begin(), operands.end(), L'`'), operands.end());
+    std::transform(operands.begin(), operands.end(), operands.begin(), ::towlower);
+
+    EXPECT_NE(std::wstring::npos, operands.find(address)) << engineText;
+}
+
+TEST_F(DisasmTest, decodeInstruction)
+{
+    Disasm   dasm;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        Instruction  instruction = decodeInstruction(dasm.current());
+
+        EXPECT_EQ(dasm.current(), instruction.offset);
+        EXPECT_EQ(dasm.length(), instruction.length);
+        EXPECT_EQ(dasm.opcode(), std::vector<unsigned char>(instruction.bytes, instruction.bytes + instruction.length));
+
+        std::wstring  opmnemo = dasm.opmnemo();
+        std::wstring  mnemonic = getMnemonicName(instruction.mnemonic);
+        EXPECT_EQ(0, opmnemo.find(mnemonic)) << opmnemo;
+
+        expectSameText(dasm.instruction(), formatInstruction(instruction));
+
+        dasm.disassemble();
+    }
+}
+
+TEST_F(DisasmTest, disassembleRange)
+{
+    Disasm   dasm;
+
+    MEMOFFSET_64  begin = dasm.begin();
+    MEMOFFSET_64  end = begin + 0x100;
+
+    InstructionListPtr  instructions = disassembleRange(begin, end);
+    ASSERT_FALSE(instructions->empty());
+
+    MEMOFFSET_64  offset = begin;
+
+    for (size_t i = 0; i < instructions->size(); ++i)
+    {
+        const Instruction  &instruction = (*instructions)[i];
+
+        EXPECT_EQ(offset, instruction.offset);
+        EXPECT_EQ(decodeInstruction(offset).length, instruction.length);
+
+        offset += instruction.length;
+    }
+
+    EXPECT_LE(end, offset);
+    EXPECT_GT(end + 15, offset);
+
+    // the same range is cached
+    EXPECT_EQ(instructions, disassembleRange(begin, end));
+
+    EXPECT_THROW(disassembleRange(end, begin), DbgException);
+}
+
+TEST_F(DisasmTest, disassembleRangeAfterWrite)
+{
+    Disasm   dasm;
+
+    MEMOFFSET_64  begin = dasm.begin();
+    MEMOFFSET_64  end = begin + 0x100;
+
+    InstructionListPtr  instructions = disassembleRange(begin, end);
+
+    std::vector<unsigned char>  original = loadBytes(begin, 1);
+
+    // int 3
+    writeBytes(begin, std::vector<unsigned char>(1, 0xCC));
+
+    InstructionListPtr  patched = disassembleRange(begin, end);
+
+    writeBytes(begin, original);
+
+    EXPECT_NE(instructions, patched);
+    ASSERT_FALSE(patched->empty());
+    EXPECT_EQ(1, patched->front().length);
+    EXPECT_EQ(0xCC, patched->front().bytes[0]);
+
+    InstructionListPtr  restored = disassembleRange(begin, end);
+    EXPECT_NE(patched, restored);
+    EXPECT_EQ(instructions->front().length, restored->front().length);
+}
+
+TEST_F(DisasmTest, DISABLED_disassembleRangeBenchmark)
+{
+    size_t  count = 0;
+
+    long long  elapsed = measureMicroseconds([this, &count] {
+        count = disassembleRange(m_targetModule->getBase(), m_targetModule->getEnd())->size();
+    });
+
+    recordRate("disassembleRange_instructions_per_s", count, elapsed);
+
+    const size_t  iterations = 10000;
+
+    Disasm  dasm(m_targetModule->getBase());
+
+    elapsed = measureMicroseconds([&dasm] { dasm.disassemble(); }, iterations);
+
+    recordRate("Disasm_instructions_per_s", iterations, elapsed);
+}
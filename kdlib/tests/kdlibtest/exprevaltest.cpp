@@ -6,6 +6,7 @@
 #include "test/testvars.h"
 
 #include "procfixture.h"
+#include "benchmark.h"
 
 using namespace kdlib;
 
@@ -316,6 +317,36 @@ TEST(ExprEval, NullPtr)
     EXPECT_EQ(0, evalExpr("(int**)nullptr"));
 }
 
+TEST(ExprEval, CompiledExpr)
+{
+    CompiledExprPtr  expr;
+    ASSERT_NO_THROW(expr = compileExpr(L"a * 2 + (b > 0 ? sizeof(a) : -1)"));
+
+    EXPECT_EQ(10 * 2 + sizeof(int), expr->evaluate(makeScope({ { L"a", 10 }, { L"b", 1 } })));
+    EXPECT_EQ(-3 * 2 - 1, expr->evaluate(makeScope({ { L"a", -3 }, { L"b", 0 } })));
+
+    EXPECT_THROW(expr->evaluate(makeScope({ { L"a", 10 } })), DbgException);
+
+    EXPECT_EQ(-3 * 2 - 1, expr->evaluate(makeScope({ { L"a", -3 }, { L"b", -5 } })));
+
+    EXPECT_EQ(1, compileExpr(L"(long*)10 - (long*)6")->evaluate());
+
+    EXPECT_THROW(compileExpr(L"a + "), DbgException);
+    EXPECT_THROW(compileExpr(L"(a * 2"), DbgException);
+    EXPECT_THROW(compileExpr(L"a ? : 1"), DbgException);
+}
+
+TEST(ExprEval, ShortCircuit)
+{
+    EXPECT_FALSE((bool)evalExpr(L"0 && undefinedVar"));
+    EXPECT_TRUE((bool)evalExpr(L"1 || undefinedVar"));
+    EXPECT_EQ(2, evalExpr(L"1 ? 2 : undefinedVar"));
+    EXPECT_EQ(3, evalExpr(L"0 ? undefinedVar : 3"));
+
+    EXPECT_THROW(evalExpr(L"1 && undefinedVar"), DbgException);
+    EXPECT_THROW(evalExpr(L"0 ? 2 : undefinedVar"), DbgException);
+}
+
 class ExprEvalTarget : public ProcessFixture
 {
 public:
@@ -439,6 +470,99 @@ TEST_F(ExprEvalTarget, Eval1)
     EXPECT_EQ( (g_testArray + 1)->m_field1 % 4, evalExpr("(g_testArray + 1)->m_field1 % 4", m_targetModule->getScope()));
 }
 
+TEST_F(ExprEvalTarget, CompiledFields)
+{
+    CompiledExprPtr  expr = compileExpr(L"g_structTest1.m_field4->m_field1 + g_testArray[1].m_field1 * 2 - (g_structTestPtr ? g_structTestPtr->m_field0 : 0)");
+
+    for (int i = 0; i < 2; ++i)
+        EXPECT_EQ(g_structTest1.m_field4->m_field1 + g_testArray[1].m_field1 * 2 - g_structTestPtr->m_field0, expr->evaluate(m_targetModule->getScope()));
+
+    TypedValue  field = evalExpr(L"g_testArray[1].m_field1", m_targetModule->getScope());
+    EXPECT_EQ(loadTypedVar(L"g_testArray")->getElement(1)->getElement(L"m_field1")->getAddress(), field.getAddress());
+    EXPECT_EQ(L"UInt8B", field.getType()->getName());
+
+    EXPECT_TRUE((bool)evalExpr(L"*g_structTestPtrPtr == g_structTestPtr", m_targetModule->getScope()));
+}
+
+TEST_F(ExprEvalTarget, CompiledNegativeIndex)
+{
+    CompiledExprPtr  expr = compileExpr(L"(g_testArray + 1)[-1].m_field1");
+
+    EXPECT_EQ(g_testArray[0].m_field1, expr->evaluate(m_targetModule->getScope()));
+    EXPECT_EQ(evalExpr(L"(g_testArray + 1)[-1].m_field1", m_targetModule->getScope()), expr->evaluate(m_targetModule->getScope()));
+
+    TypedValue  field = expr->evaluate(m_targetModule->getScope());
+    EXPECT_EQ(loadTypedVar(L"g_testArray")->getElement(0)->getElement(L"m_field1")->getAddress(), field.getAddress());
+}
+
+TEST_F(ExprEvalTarget, FilterArray)
+{
+    TypeInfoPtr  structType = loadType(L"structTest");
+    MEMOFFSET_64  arrayOffset = m_targetModule->getSymbolVa(L"g_testArray");
+
+    std::vector<size_t>  indices = compileExpr(L"m_field1 > 1000")->filterArray(arrayOffset, structType, 2);
+    ASSERT_EQ(1, indices.size());
+    EXPECT_EQ(1, indices[0]);
+
+    indices = compileExpr(L"m_field2 || m_field0 == 2 && m_field3 != 0")->filterArray(arrayOffset, structType, 2);
+    EXPECT_EQ(2, indices.size());
+
+    indices = compileExpr(L"!m_field2 && m_field0 > 1")->filterArray(arrayOffset, structType, 2);
+    ASSERT_EQ(1, indices.size());
+    EXPECT_EQ(1, indices[0]);
+
+    // the comparison is unsigned as the field is
+    EXPECT_TRUE(compileExpr(L"-1 < m_field0")->filterArray(arrayOffset, structType, 2).empty());
+
+    // not a simple comparison: evaluated by the element
+    indices = compileExpr(L"m_field1 * 3 == 1500")->filterArray(arrayOffset, structType, 2);
+    ASSERT_EQ(1, indices.size());
+    EXPECT_EQ(0, indices[0]);
+
+    // other names are looked up in the scope
+    indices = compileExpr(L"m_field1 == limit")->filterArray(arrayOffset, structType, 2, makeScope({ { L"limit", 1500 } }));
+    ASSERT_EQ(1, indices.size());
+    EXPECT_EQ(1, indices[0]);
+
+    EXPECT_TRUE(compileExpr(L"m_field0 == 100")->filterArray(arrayOffset, structType, 2).empty());
+    EXPECT_TRUE(compileExpr(L"m_field0 == 0")->filterArray(arrayOffset, structType, 0).empty());
+}
+
+TEST_F(ExprEvalTarget, FilterList)
+{
+    TypeInfoPtr  listType = loadType(L"listStruct");
+    MEMOFFSET_64  headOffset = m_targetModule->getSymbolVa(L"g_listHead");
+
+    TypedVarList  entries = loadTypedVarList(headOffset, listType, L"next.flink");
+
+    std::vector<MEMOFFSET_64>  offsets = compileExpr(L"num >= 2")->filterList(headOffset, listType, L"next.flink");
+    ASSERT_EQ(3, offsets.size());
+    EXPECT_EQ(entries[2]->getAddress(), offsets[0]);
+
+    offsets = compileExpr(L"num == 1 || num % 2 == 1")->filterList(headOffset, listType, L"next.flink");
+    ASSERT_EQ(2, offsets.size());
+    EXPECT_EQ(entries[3]->getAddress(), offsets[1]);
+}
+
+TEST_F(ExprEvalTarget, DISABLED_Benchmark)
+{
+    const int  iterations = 10000;
+
+    CompiledExprPtr  arithmetic = compileExpr(L"(a * 3 + b / 2) % 7 - (a << 2) + (b > a ? a : b) * (a - b)");
+    ScopePtr  arithmeticScope = makeScope({ { L"a", 10 }, { L"b", 20 } });
+
+    CompiledExprPtr  fields = compileExpr(L"g_structTest1.m_field4->m_field1 + g_testArray[1].m_field1 * g_structTestPtr->m_field3");
+    ScopePtr  fieldScope = m_targetModule->getScope();
+
+    long long  elapsed = measureMicroseconds([&] { arithmetic->evaluate(arithmeticScope); }, iterations);
+
+    recordBenchmark("arithmetic_ns_per_call", elapsed * 1000 / iterations);
+
+    elapsed = measureMicroseconds([&] { fields->evaluate(fieldScope); }, iterations);
+
+    recordBenchmark("fields_ns_per_call", elapsed * 1000 / iterations);
+}
+
 TEST_F(ExprEvalTarget, TemplateConstCast)
 {
     TypedValue  evalResult;
@@ -0,0 +1,520 @@
+#include <stdafx.h>
+
+#include "gtest/gtest.h"
+#include "kdlib/kdlib.h"
+
+#include "../../source/clang/exprtokens.h"
+
+#include "benchmark.h"
+
+using namespace kdlib;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the expressions of exprevaltest.cpp and typeevaltest.cpp
+static const char*  exprCorpus[] = {
+    "1",
+    "0",
+    "0x1234",
+    "077",
+    "2147483648",
+    "0x80000000",
+    "2147483648L",
+    "0x80000000L",
+    "9223372036854775808",
+    "0x8000000000000000",
+    "9223372036854775808ULL",
+    "0x8000000000000000ULL",
+    "92233720368547758080",
+    "0x80000000000000000",
+    "1e10",
+    "1e-5L",
+    "1.",
+    ".1",
+    ".2f",
+    "0.2e+3f",
+    "'a'",
+    "L'A'",
+    "'\xFF'",
+    "'abc'",
+    "'\t'",
+    "'\13'",
+    "L'AA'",
+    "L'AAAAA'",
+    "''",
+    "'aaaaa'",
+    "2 + 2",
+    "2 + 2 * 2",
+    "2 * 2 + 2",
+    "2 * 2 + 2 * 2 ",
+    "5 - 5 * 5  + 5",
+    "5 / 5 * 5 - 5",
+    "5 */ 5",
+    "**5",
+    "5/",
+    "5/0",
+    "5/0.0",
+    "-2 + 3",
+    "2 + -3",
+    "+2 - 3",
+    "50 % 3",
+    "4 + 0x20 % 3",
+    "2 << 3",
+    "7000 >> 3",
+    "5 + 6 << 2",
+    "7 >> 3 - 1",
+    "3 >>",
+    ">> 2",
+    "0xFA01894B & 0xC58F6ACD",
+    "0xFA01894B | 0xC58F6ACD",
+    "0xFA01894B ^ 0xC58F6ACD",
+    "~0xFA01894B",
+    "++a",
+    "a++",
+    "--a",
+    "a--",
+    "a + 10",
+    "a * b * 10",
+    "-10 == -10",
+    "-10 == 1 - 10",
+    "5 != -1 * 5",
+    "5 != 2 + 3",
+    "3 + 8 < 3 * 8",
+    "3 + 8 < -3 * 8",
+    "3 + 8 <= 3 + 8",
+    "3 * 8 <= 3 + 9",
+    "-10 > -20",
+    "4 % 2 > +0",
+    "5 >= 10 - 5",
+    "7 >= 49 / 8",
+    "0 >= 5%4",
+    "arrayOrig[3]",
+    "arrayOrig[i]",
+    "arrayOrig[]",
+    "arrayOrig[[1",
+    "arrayOrig]1[",
+    "arrayOrig[1[]",
+    "st.field1",
+    "st.field2",
+    "st.field3.field1",
+    "st.",
+    "st..",
+    "st.aaaaa",
+    "2 * (2 + 2)",
+    "-(2 * (2 + 2))",
+    "((( 2 + 2 ) / 2 ) * 4)",
+    "2 * (2 +",
+    "(2 * (2 + 2)",
+    "((((",
+    "sizeof(int)",
+    "sizeof(int*)",
+    "sizeof(const int)",
+    "sizeof 1",
+    "sizeof(1)",
+    "sizeof(int[4])",
+    "sizeof int",
+    "sizeof(int*[10])",
+    "sizeof(int(*)[10])",
+    "sizeof(int(&)[10])",
+    "sizeof(int((*)[1])[10])",
+    "sizeof(int([1](*))[10])",
+    "sizeof(int[10]&)",
+    "sizeof(long int) >> 2",
+    "1 << sizeof(long int)",
+    "sizeof(2 < 4)",
+    "true",
+    "false",
+    "sizeof(bool)",
+    "sizeof(true)",
+    "True",
+    "true || false",
+    "false || false",
+    "true && true",
+    "false && true",
+    "!false",
+    "!!true",
+    "!true",
+    "2 < 3 || 3 < 2",
+    "2 > 3 || 3 > 2",
+    "2 == 3 && 5 > 2",
+    "2 < 3 ? 2 : 3",
+    "2 > 3 ? 2 : 3 + 2",
+    "true ? (2 + 3) : (2 - 3)",
+    "false ? 7 : 8 ? 2 : 3",
+    "(false ? 7 : 8 ) ? ( true ? 0 : 1) : 3",
+    "?",
+    "?:",
+    "0 ? : 5",
+    "(int*)10 + 1",
+    "1 + (int*)10",
+    "(int*)10 + (int*)20",
+    "(long*)10 - 1",
+    "(long*)100 - (long*)90",
+    "10 - (long*)1",
+    "10 / (long*)2",
+    "(long*)10 / 2",
+    "10 % (long*)2",
+    "(long*)10 % 2",
+    "(long*)10 << 2",
+    "(long*)10 >> 2",
+    "10 << (long*)2",
+    "10 >> (long*)2",
+    "(long*)10 & 0xFF",
+    "0xFF & (long*)10",
+    "(long*)10 | 0xFF",
+    "0xFF | (long*)10",
+    "(long*)10 ^ 0xFF",
+    "0xFF ^ (long*)10",
+    "!(long*)10",
+    "~(long*)10",
+    "-(long*)10",
+    "(void*)0",
+    "(int**)nullptr",
+    "g_structTestPtr->m_field0",
+    "*pbigValue",
+    "**ppbigValue",
+    "(*g_structTestPtr).m_field0",
+    "*2",
+    "*bigValue",
+    "(&g_classChild)->m_childField",
+    "*(&g_classChild.m_childField)",
+    "(&&g_classChild)->m_childField",
+    "(g_classChild&)->m_childField",
+    "(__int64)charVar",
+    "(double)charVar",
+    "(__int64)&charVar",
+    "(long long)g_testArray",
+    "(short)enumType::THREE",
+    "(int)g_classChild",
+    "*(unsigned char*)pbigValue",
+    "*(char*)pbigValue",
+    "*(unsigned char*)(__int64)pbigValue",
+    "*(long*)shortArray",
+    "((char[8])pbigValue)[3]",
+    "((char[])pbigValue)[3]",
+    "(int&)longlongVar",
+    "(const int&)longlongVar",
+    "(int*)g_classChild",
+    "(structTest)g_classChild",
+    "enumType::THREE",
+    "classChild::m_staticField",
+    "classChild::m_staticConst",
+    "testspace::constInt",
+    "testspace::testClass1::m_constLong",
+    "sizeof(std::list<int,std::allocator<int> >)",
+    "sizeof(TestStructTemplate<int>)",
+    "sizeof(TestClassTemplate<int>)",
+    "sizeof(ClassNoField<UnusedStruct>)",
+    "g_testArray[1].m_field1",
+    "g_structTest1.m_field4->m_field1 + 200",
+    "(g_testArray + 1)->m_field1 % 4",
+    "(std::_Compressed_pair<std::allocator<std::_Tree_node<std::pair<const int, TemplateStruct<int> >, void *> >, std::_Tree_val<std::_Tree_simple_types<std::pair<const int, TemplateStruct<int> > > >, 1>*)nullptr",
+    "intMatrix[1][2]",
+    "intMatrix[0][1]",
+    "char",
+    "short",
+    "int",
+    "long",
+    "long long",
+    "unsigned",
+    "unsigned char",
+    "unsigned short",
+    "unsigned int",
+    "unsigned long",
+    "unsigned long long",
+    "__int64",
+    "unsigned __int64",
+    "signed",
+    "signed char",
+    "signed short",
+    "signed int",
+    "signed long",
+    "signed long long",
+    "short unsigned",
+    "long unsigned",
+    "short signed",
+    "long signed",
+    "long char",
+    "long short",
+    "long long long",
+    "signed unsigned long",
+    "unsigned signed int",
+    "wchar_t",
+    "int8_t",
+    "uint8_t",
+    "int16_t",
+    "uint16_t",
+    "int32_t",
+    "uint32_t",
+    "int64_t",
+    "uint64_t",
+    "size_t",
+    "intptr_t",
+    "uintptr_t",
+    "long int8_t",
+    "int8_t int8_t",
+    "const long const",
+    "const const",
+    "const *",
+    "const uint32_t",
+    "uint32_t const const",
+    "const TestStruct",
+    "const TestStruct const",
+    "float",
+    "double",
+    "long float",
+    "long double",
+    "float long",
+    "long long float",
+    "long long double",
+    "unsigned double",
+    "double int",
+    "long*",
+    "unsigned short **",
+    "short (***)",
+    "int16_t**",
+    "*long",
+    "long&",
+    "long&&",
+    "char&",
+    "int*&",
+    "int(&)[10]",
+    "long&[1]",
+    "long&*",
+    "long&&&",
+    "int[10]",
+    "long long[2][3]",
+    "uint64_t[1]",
+    "short[10][2]",
+    "int[]",
+    "int[][2]",
+    "int[][]",
+    "int[2][]",
+    "char (*)[20]",
+    "char (*[5])[20]",
+    "char (*(*)[5])[20]",
+    "int(*)[]",
+    "int(*)[][4]",
+    "sizeof(TestStruct)",
+    "sizeof(TestStruct::field1)",
+    "TestStruct*",
+    "TestStruct**",
+    "TestStruct[20]",
+    "TestStruct(*)[20]",
+    "NotExist",
+    "TestStruct::notExist",
+    "TestStruct::",
+    "TestEnum::TEN",
+    "testspace::TestStruct",
+    "testspace::TestStruct::field1",
+    "TestStruct1<unsigned>",
+    "TestStruct1<short*>",
+    "TestStruct1<long double>",
+    "TestStruct2<TestStruct1<double> >",
+    "TestStruct4<int, signed char>",
+    "TestStruct4<TestStruct1<int>, unsigned long>",
+    "TestStruct1<float>",
+    "TestStruct1<unsigned",
+    "TestStruct1<unsigned, unsigned",
+    "TestStruct0<'a'>",
+    "TestStruct0<0x4>",
+    "TestStruct0<-4>",
+    "TestStruct1<2,0xFFFF>",
+    "TestStruct0<0.1>",
+    "TestStruct1<int const>",
+    "TestStruct1<const int>",
+    "TestStruct1<const int const>",
+    "TestStruct1<const const int>",
+    "TestStruct1<const int, const char>",
+    "TestStruct1<const TestStruct>",
+    "TestStruct1<TestStruct const>",
+    "TestStruct1<const TestStruct1<char>>",
+    "TestStruct1<const TestStruct1<char>, int>",
+    "TestStruct1<const>",
+    "TestStruct1<int, char>",
+    "TestStruct1<const int*>",
+    "TestStruct1<int const *>",
+    "TestStruct1<const int* const>",
+    "TestStruct1<const int const * const>",
+    "TestStruct1<const int *const *const>",
+    "TestStruct1<const*>",
+    "TestStruct1<const *int>",
+    "TestStruct1<long&>",
+    "TestStruct1<long &&>",
+    "TestStruct1<const long&>",
+    "TestStruct1<const long&&>",
+    "TestStruct1<const long& const>",
+    "TestStruct1<const long&& const>",
+    "testspace::TestStruct<float>",
+    "testspace::TestStruct<float>::field1",
+    "testspace::TestStruct<int,testspace::TestStruct<int,int> >",
+    "testspace::TestStruct<int,testspace::TestStruct<int,int> >::field1",
+    "TestStruct<-10>",
+    "TestStruct<+10>",
+    "TestStruct<!1>",
+    "TestStruct<~0xFFFFFFFF>",
+    "TestStruct<5+5>",
+    "TestStruct<15-5>",
+    "TestStruct<2+3+5>",
+    "TestStruct<(10-5)+5>",
+    "TestStruct<5+(10-(2+3))>",
+    "TestStruct<(10-5)*2>",
+    "TestStruct<20/2>",
+    "TestStruct<120%11>",
+    "TestStruct<5<<1>",
+    "TestStruct<20>>1>",
+    "TestStruct<11 & 0xFE>",
+    "TestStruct<0x2|8>",
+    "TestStruct<0x18 ^ 0x12>",
+    "TestStruct0<5+(10-(2+3)>",
+    "TestStruct0<1/0>",
+    "TestStruct<true>",
+    "TestStruct<false>",
+    "TestStruct<1==1>",
+    "TestStruct<1!=0>",
+    "TestStruct<1<2>",
+    "TestStruct<1<=2>",
+    "TestStruct<1>2>",
+    "TestStruct<true>=false>",
+    "TestStruct<true || 0>",
+    "TestStruct<0x11 && 1>",
+    "TestStruct0<5&&&5>",
+    "TestStruct<int,TestStruct<int,int> >",
+    "TestStruct<int,TestStruct<int,int>>",
+    "TestStruct<int,TestStruct<int,TestStruct<int,int> > >",
+    "TestStruct<int,TestStruct<int,TestStruct<int,int>>>",
+    "TestStruct<int,TestStruct<int,TestStruct<int,int>> >",
+    "TestStruct<int,TestStruct<int,TestStruct<int,int> >>",
+    "TestStruct<int,TestStruct<int,TestStruct<int,TestStruct<int,int>>>>",
+    "TestStruct<int,TestStruct<int,TestStruct<int,TestStruct<int,TestStruct<int,int>>>>>",
+    "void",
+    "void *",
+    "void *[1]",
+    "void&",
+    "void&&",
+    "void[5]",
+    "TestStruct<int[]>",
+    "TestStruct<int*[]>",
+    "TestStruct<void*[]>",
+    "TestStruct<void>",
+    "TestStruct<void const>",
+    "TestStruct<const void>",
+    "TestStruct<void,void*,void *[1]>",
+    "TestStruct<void,void *,void*[]>",
+    "TestStruct<int, const int, long *const>",
+    "TestStruct<wchar_t>",
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the tokens of the clang preprocessor evalExpr used before the built-in lexer
+static bool getReferenceTokens(const char* expr, ExprTokenList& tokens)
+{
+    try
+    {
+        tokens = getExprTokens(expr, ExprLexerPreprocessor);
+        return true;
+    }
+    catch (const DbgException&)
+    {
+        return false;
+    }
+}
+
+TEST(ExprLexer, SameTokens)
+{
+    for (auto expr : exprCorpus)
+    {
+        ExprTokenList  reference;
+
+        // an empty character constant is a preprocessor error
+        if (std::string(expr) == "''")
+        {
+            EXPECT_FALSE(getReferenceTokens(expr, reference));
+            continue;
+        }
+
+        ASSERT_TRUE(getReferenceTokens(expr, reference)) << expr;
+
+        EXPECT_EQ(reference, getExprTokens(expr)) << expr;
+        EXPECT_EQ(reference, getExprTokens(expr, ExprLexerClang)) << expr;
+    }
+}
+
+TEST(ExprLexer, BuiltinCoverage)
+{
+    for (auto expr : exprCorpus)
+    {
+        if (std::string(expr) == "''")
+            continue;
+
+        EXPECT_NO_THROW(getExprTokens(expr, ExprLexerBuiltin)) << expr;
+    }
+}
+
+TEST(ExprLexer, Fallback)
+{
+    const char*  exprs[] = {
+        "''",
+        "'a",
+        "\"str\"",
+        "a /* comment */ + 1",
+        "a$b + 1",
+        "0x1p+3",
+        "a \\\n+ b"
+    };
+
+    for (auto expr : exprs)
+    {
+        EXPECT_THROW(getExprTokens(expr, ExprLexerBuiltin), TypeException) << expr;
+        EXPECT_EQ(getExprTokens(expr, ExprLexerClang), getExprTokens(expr)) << expr;
+
+        // the expressions the preprocessor rejects fail later, in the parser
+        ExprTokenList  reference;
+        if (getReferenceTokens(expr, reference))
+            EXPECT_EQ(reference, getExprTokens(expr)) << expr;
+    }
+}
+
+TEST(ExprLexer, Tokens)
+{
+    ExprTokenList  tokens = getExprTokens("p->x[1] >>= L'a' + 1.5e-3f", ExprLexerBuiltin);
+
+    ASSERT_EQ(11, tokens.size());
+    EXPECT_EQ(std::make_pair(std::string("identifier"), std::string("p")), tokens[0]);
+    EXPECT_EQ(std::make_pair(std::string("arrow"), std::string("->")), tokens[1]);
+    EXPECT_EQ(std::make_pair(std::string("greatergreaterequal"), std::string(">>=")), tokens[6]);
+    EXPECT_EQ(std::make_pair(std::string("wide_char_constant"), std::string("L'a'")), tokens[7]);
+    EXPECT_EQ(std::make_pair(std::string("numeric_constant"), std::string("1.5e-3f")), tokens[9]);
+    EXPECT_EQ(std::make_pair(std::string("eof"), std::string()), tokens[10]);
+}
+
+TEST(ExprLexer, DISABLED_Benchmark)
+{
+    const int  iterations = 1000;
+
+    const std::pair<ExprLexerKind, const char*>  lexers[] = {
+        { ExprLexerPreprocessor, "preprocessor_us" },
+        { ExprLexerClang, "clang_lexer_us" },
+        { ExprLexerDefault, "builtin_lexer_us" }
+    };
+
+    for (auto& lexer : lexers)
+    {
+        long long  elapsed = measureMicroseconds([&lexer] {
+            for (auto expr : exprCorpus)
+            {
+                if (std::string(expr) != "''")
+                    getExprTokens(expr, lexer.first);
+            }
+        }, iterations);
+
+        recordBenchmark(lexer.second, elapsed);
+    }
+
+    long long  elapsed = measureMicroseconds([] { evalExpr("(2 + 3) * 4 - sizeof(int) % 3"); }, iterations);
+
+    recordBenchmark("evalExpr_us_per_call", elapsed / iterations);
+}
+
+///////////////////////////////////////////////////////////////////////////////
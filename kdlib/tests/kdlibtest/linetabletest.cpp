@@ -0,0 +1,158 @@
+#include <stdafx.h>
+
+#include "gtest/gtest.h"
+
+#include "kdlib/linetable.h"
+#include "kdlib/exceptions.h"
+
+using namespace kdlib;
+
+///////////////////////////////////////////////////////////////////////////////
+
+class LineSessionMock : public SymbolSession
+{
+public:
+
+    LineSessionMock() :
+        lineTableCalls( 0 )
+    {
+        m_fileNames.push_back( L"c:\\src\\main.cpp" );
+        m_fileNames.push_back( L"c:\\src\\util\\Helper.cpp" );
+        m_fileNames.push_back( L"d:\\other\\main.cpp" );
+
+        // not in the address order, as a symbol file gives them
+        addLine( 0x1100, 0x10, 1, 20 );
+        addLine( 0x1000, 0x08, 0, 10 );
+        addLine( 0x1008, 0x08, 0, 11 );
+        addLine( 0x1010, 0x10, 0, 13 );
+        addLine( 0x1020, 0x04, 0, 11 );
+        addLine( 0x2000, 0x20, 2, 10 );
+    }
+
+    virtual void getLineTable( SymbolLineList &lines, std::vector<std::wstring> &fileNames ) {
+        ++lineTableCalls;
+        lines = m_lines;
+        fileNames = m_fileNames;
+    }
+
+    virtual SymbolPtr getSymbolScope() { NOT_IMPLEMENTED(); }
+    virtual SymbolPtr findByRva( MEMOFFSET_32 rva, unsigned long symTag = SymTagNull, long* displacement = NULL ) { NOT_IMPLEMENTED(); }
+    virtual void getSourceLine( MEMOFFSET_64 offset, std::wstring &fileName, unsigned long &lineNo, long &displacement ) { NOT_IMPLEMENTED(); }
+    virtual std::wstring getSymbolFileName() { return L"mock"; }
+
+    int  lineTableCalls;
+
+private:
+
+    void addLine( MEMOFFSET_32 rva, unsigned long length, unsigned long fileId, unsigned long lineNo ) {
+        SymbolLine  line = { rva, length, fileId, lineNo, 0 };
+        m_lines.push_back( line );
+    }
+
+    SymbolLineList  m_lines;
+    std::vector<std::wstring>  m_fileNames;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+const MEMOFFSET_64  LoadBase = 0x400000;
+
+class LineTableTest : public ::testing::Test {
+
+protected:
+
+    virtual void SetUp() {
+        m_session = boost::shared_ptr<LineSessionMock>( new LineSessionMock() );
+        m_lineTable = getSourceLineTable( m_session, LoadBase );
+    }
+
+    boost::shared_ptr<LineSessionMock>  m_session;
+    SourceLineTablePtr  m_lineTable;
+};
+
+TEST_F( LineTableTest, FindLine )
+{
+    SourceLineInfo  line = m_lineTable->findLine( LoadBase + 0x100A );
+
+    EXPECT_EQ( L"c:\\src\\main.cpp", line.fileName );
+    EXPECT_EQ( 11, line.lineNo );
+    EXPECT_EQ( LoadBase + 0x1008, line.offset );
+    EXPECT_EQ( 8, line.length );
+
+    EXPECT_EQ( 20, m_lineTable->findLine( LoadBase + 0x110F ).lineNo );
+
+    EXPECT_THROW( m_lineTable->findLine( LoadBase + 0x1024 ), SymbolException );
+    EXPECT_THROW( m_lineTable->findLine( LoadBase + 0x0FFF ), SymbolException );
+    EXPECT_THROW( m_lineTable->findLine( 0x1000 ), SymbolException );
+
+    EXPECT_EQ( 6, m_lineTable->getLineCount() );
+    EXPECT_EQ( 3, m_lineTable->getSourceFiles().size() );
+    EXPECT_EQ( 1, m_session->lineTableCalls );
+}
+
+TEST_F( LineTableTest, FindLines )
+{
+    std::vector<MEMOFFSET_64>  offsets;
+    offsets.push_back( LoadBase + 0x2010 );
+    offsets.push_back( LoadBase + 0x5000 );
+    offsets.push_back( LoadBase + 0x1000 );
+
+    SourceLineList  lines = m_lineTable->findLines( offsets );
+
+    ASSERT_EQ( 3, lines.size() );
+    EXPECT_EQ( L"d:\\other\\main.cpp", lines[0].fileName );
+    EXPECT_EQ( 10, lines[0].lineNo );
+    EXPECT_TRUE( lines[1].fileName.empty() );
+    EXPECT_EQ( 0, lines[1].lineNo );
+    EXPECT_EQ( L"c:\\src\\main.cpp", lines[2].fileName );
+    EXPECT_EQ( 10, lines[2].lineNo );
+}
+
+TEST_F( LineTableTest, FindLineOffsets )
+{
+    SourceLineList  lines = m_lineTable->findLineOffsets( L"C:/SRC/main.cpp", 11 );
+
+    ASSERT_EQ( 2, lines.size() );
+    EXPECT_EQ( LoadBase + 0x1008, lines[0].offset );
+    EXPECT_EQ( LoadBase + 0x1020, lines[1].offset );
+
+    // the next line with code
+    lines = m_lineTable->findLineOffsets( L"src\\main.cpp", 12 );
+    ASSERT_EQ( 1, lines.size() );
+    EXPECT_EQ( 13, lines[0].lineNo );
+
+    // both main.cpp files
+    lines = m_lineTable->findLineOffsets( L"main.cpp", 10 );
+    ASSERT_EQ( 2, lines.size() );
+    EXPECT_EQ( LoadBase + 0x1000, lines[0].offset );
+    EXPECT_EQ( LoadBase + 0x2000, lines[1].offset );
+
+    EXPECT_EQ( 1, m_lineTable->findLineOffsets( L"helper.cpp", 1 ).size() );
+
+    EXPECT_TRUE( m_lineTable->findLineOffsets( L"main.cpp", 100 ).empty() );
+    EXPECT_TRUE( m_lineTable->findLineOffsets( L"in.cpp", 10 ).empty() );
+    EXPECT_TRUE( m_lineTable->findLineOffsets( L"x\\main.cpp", 10 ).empty() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// A session of an external provider does not implement the line table
+
+class NoLineSessionMock : public SymbolSession
+{
+public:
+
+    virtual SymbolPtr getSymbolScope() { NOT_IMPLEMENTED(); }
+    virtual SymbolPtr findByRva( MEMOFFSET_32 rva, unsigned long symTag = SymTagNull, long* displacement = NULL ) { NOT_IMPLEMENTED(); }
+    virtual void getSourceLine( MEMOFFSET_64 offset, std::wstring &fileName, unsigned long &lineNo, long &displacement ) { NOT_IMPLEMENTED(); }
+    virtual std::wstring getSymbolFileName() { return L"mock"; }
+};
+
+TEST( LineTableDefaultTest, NotImplemented )
+{
+    SymbolSessionPtr  session( new NoLineSessionMock() );
+
+    EXPECT_THROW( getSourceLineTable( session, LoadBase ), ImplementException );
+}
+
+///////////////////////////////////////////////////////////////////////////////
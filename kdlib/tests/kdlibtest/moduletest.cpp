@@ -148,6 +148,19 @@ TEST_F( ModuleTest, getSourceLine )
     EXPECT_EQ( 30, lineNo );
     EXPECT_EQ( 2, displacement );
 
+    // the same line by the line table the batch lookup builds
+    std::vector<MEMOFFSET_64>  offsets( 1, m_targetModule->getSymbolVa(L"CdeclFunc") + 2 );
+    ASSERT_EQ( 1, m_targetModule->getSourceLines( offsets ).size() );
+
+    std::wstring  tableFileName;
+    unsigned long  tableLineNo;
+    long  tableDisplacement;
+
+    EXPECT_NO_THROW( m_targetModule->getSourceLine( offsets[0], tableFileName, tableLineNo, tableDisplacement ) );
+    EXPECT_EQ( fileName, tableFileName );
+    EXPECT_EQ( lineNo, tableLineNo );
+    EXPECT_EQ( displacement, tableDisplacement );
+
     //EXPECT_NO_THROW( m_targetModule->getSourceLine( m_targetModule->getSymbolVa(L"ucharVar"), fileName, lineNo, displacement ) );
 
     //EXPECT_TRUE( fileName.find(L"testvars.cpp") != std::wstring::npos );
@@ -155,6 +168,33 @@ TEST_F( ModuleTest, getSourceLine )
     //EXPECT_EQ( 0, displacement );
 }
 
+TEST_F( ModuleTest, getSourceLines )
+{
+    MEMOFFSET_64  funcOffset = m_targetModule->getSymbolVa(L"CdeclFunc");
+
+    std::vector<MEMOFFSET_64>  offsets;
+    offsets.push_back( funcOffset + 2 );
+    offsets.push_back( m_targetModule->getBase() );
+    offsets.push_back( funcOffset + 2 );
+
+    SourceLineList  lines;
+    ASSERT_NO_THROW( lines = m_targetModule->getSourceLines( offsets ) );
+    ASSERT_EQ( 3, lines.size() );
+
+    EXPECT_TRUE( lines[0].fileName.find(L"testfunc.cpp") != std::wstring::npos );
+    EXPECT_EQ( 30, lines[0].lineNo );
+    EXPECT_EQ( funcOffset, lines[0].offset );
+    EXPECT_TRUE( lines[1].fileName.empty() );
+    EXPECT_EQ( lines[0].lineNo, lines[2].lineNo );
+
+    lines = getSourceLines( offsets );
+    EXPECT_EQ( 30, lines[2].lineNo );
+
+    SourceLineList  lineOffsets = m_targetModule->getSourceLineOffsets( L"testfunc.cpp", 30 );
+    ASSERT_FALSE( lineOffsets.empty() );
+    EXPECT_EQ( funcOffset, lineOffsets.front().offset );
+}
+
 
 TEST_F( ModuleTest, getFunction )
 {
@@ -175,6 +215,35 @@ TEST_F( ModuleTest, getFunction )
     EXPECT_THROW( m_targetModule->getFunctionByAddr( addr + funcSize ), SymbolException );
 }
 
+TEST_F( ModuleTest, exportsFromImageFile )
+{
+    ModulePtr  kernel32;
+    ASSERT_NO_THROW( kernel32 = loadModule( L"kernel32" ) );
+
+    SymbolSessionPtr  memorySession = loadSymbolFromExports( kernel32->getBase() );
+
+    SymbolSessionPtr  fileSession;
+    ASSERT_NO_THROW( fileSession = loadSymbolFromExports( kernel32->getImageName(), kernel32->getBase() ) );
+
+    EXPECT_EQ( memorySession->getSymbolScope()->getChildByName( L"GetProcAddress" )->getVa(),
+        fileSession->getSymbolScope()->getChildByName( L"GetProcAddress" )->getVa() );
+}
+
+TEST_F( ModuleTest, exportsFromOtherImageFile )
+{
+    ModulePtr  kernel32 = loadModule( L"kernel32" );
+    ModulePtr  ntdll = loadModule( L"ntdll" );
+
+    // ntdll.dll is not the image of kernel32: the memory exports are taken
+    SymbolSessionPtr  session;
+    ASSERT_NO_THROW( session = loadSymbolFromExports( ntdll->getImageName(), kernel32->getBase() ) );
+
+    EXPECT_EQ( loadSymbolFromExports( kernel32->getBase() )->getSymbolScope()->getChildByName( L"GetProcAddress" )->getVa(),
+        session->getSymbolScope()->getChildByName( L"GetProcAddress" )->getVa() );
+
+    EXPECT_THROW( session->getSymbolScope()->getChildByName( L"NtClose" ), SymbolException );
+}
+
 class ModuleCallbackTest : public ProcessFixture 
 {
 public:
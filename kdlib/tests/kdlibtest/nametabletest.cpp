@@ -0,0 +1,224 @@
+#include <stdafx.h>
+
+#include <vector>
+
+#include <boost/thread/thread.hpp>
+
+#include "gtest/gtest.h"
+
+#include "kdlib/nametable.h"
+#include "kdlib/exceptions.h"
+
+#include "benchmark.h"
+
+using namespace kdlib;
+
+class NameTableTest : public ::testing::Test {
+};
+
+TEST_F( NameTableTest, Intern )
+{
+    NAME_ID  id1 = internName(L"NameTableTest::field1");
+    NAME_ID  id2 = internName(L"NameTableTest::field2");
+
+    EXPECT_NE( id1, id2 );
+    EXPECT_EQ( id1, internName(std::wstring(L"NameTableTest::") + L"field1") );
+    EXPECT_EQ( EmptyNameId, internName(L"") );
+
+    EXPECT_EQ( L"NameTableTest::field1", getInternedName(id1) );
+    EXPECT_EQ( L"NameTableTest::field2", std::wstring(getInternedNameView(id2).data(), getInternedNameView(id2).size()) );
+
+    releaseName(id1);
+    releaseName(id1);
+    releaseName(id2);
+}
+
+TEST_F( NameTableTest, Find )
+{
+    NAME_ID  id;
+
+    EXPECT_FALSE( findNameId(L"NameTableTest::notInterned", id) );
+
+    NAME_ID  id1 = internName(L"NameTableTest::interned");
+    EXPECT_TRUE( findNameId(L"NameTableTest::interned", id) );
+    EXPECT_EQ( id1, id );
+
+    releaseName(id);
+    releaseName(id1);
+}
+
+TEST_F( NameTableTest, Release )
+{
+    NAME_ID  id;
+
+    NAME_ID  id1 = internName(L"NameTableTest::released");
+    NAME_ID  id2 = internName(L"NameTableTest::released");
+    EXPECT_EQ( id1, id2 );
+
+    releaseName(id1);
+    EXPECT_TRUE( findNameId(L"NameTableTest::released", id) );
+    releaseName(id);
+
+    releaseName(id2);
+    EXPECT_FALSE( findNameId(L"NameTableTest::released", id) );
+
+    EXPECT_THROW( getInternedName(id1), IndexException );
+
+    // the id of a released name is reused
+    NAME_ID  id3 = internName(L"NameTableTest::reused");
+    EXPECT_EQ( id1, id3 );
+    releaseName(id3);
+}
+
+TEST_F( NameTableTest, InternedName )
+{
+    InternedName  name1(L"NameTableTest::name");
+    InternedName  name2(L"NameTableTest::name");
+    InternedName  name3(L"NameTableTest::other");
+
+    EXPECT_TRUE( name1 == name2 );
+    EXPECT_TRUE( name1 != name3 );
+    EXPECT_EQ( L"NameTableTest::name", name1.str() );
+    EXPECT_TRUE( InternedName().empty() );
+
+    InternedName  found;
+    EXPECT_TRUE( InternedName::find(L"NameTableTest::name", found) );
+    EXPECT_TRUE( found == name1 );
+    EXPECT_FALSE( InternedName::find(L"NameTableTest::notInterned", found) );
+}
+
+TEST_F( NameTableTest, InternedNameCopy )
+{
+    InternedName  copy;
+
+    {
+        InternedName  name(L"NameTableTest::copied");
+        copy = name;
+
+        InternedName  copy2(name);
+        EXPECT_TRUE( copy2 == name );
+    }
+
+    InternedName  found;
+    EXPECT_TRUE( InternedName::find(L"NameTableTest::copied", found) );
+    EXPECT_EQ( L"NameTableTest::copied", copy.str() );
+
+    copy = InternedName();
+    found = InternedName();
+
+    EXPECT_FALSE( InternedName::find(L"NameTableTest::copied", found) );
+}
+
+TEST_F( NameTableTest, LazyInternedName )
+{
+    int  calls = 0;
+
+    InternedName  found;
+
+    {
+        LazyInternedName  name;
+
+        auto  getName = [&calls]() { ++calls; return std::wstring(L"NameTableTest::lazy"); };
+
+        NAME_ID  id = name.get(getName);
+        EXPECT_EQ( id, name.get(getName) );
+        EXPECT_EQ( 1, calls );
+
+        EXPECT_TRUE( InternedName::find(L"NameTableTest::lazy", found) );
+        EXPECT_EQ( id, found.getId() );
+    }
+
+    found = InternedName();
+    EXPECT_FALSE( InternedName::find(L"NameTableTest::lazy", found) );
+}
+
+TEST_F( NameTableTest, Stats )
+{
+    NameTableStats  before = getNameTableStats();
+
+    NAME_ID  id = internName(L"NameTableTest::statsName");
+
+    NameTableStats  after = getNameTableStats();
+
+    EXPECT_EQ( before.nameCount + 1, after.nameCount );
+    EXPECT_LE( before.charCount + wcslen(L"NameTableTest::statsName"), after.charCount );
+    EXPECT_LT( before.memoryUsage, after.memoryUsage );
+
+    releaseName(id);
+
+    EXPECT_EQ( before.nameCount, getNameTableStats().nameCount );
+}
+
+TEST_F( NameTableTest, Threads )
+{
+    NameTableStats  before = getNameTableStats();
+
+    // the names are interned, found and released at once by all threads
+    auto  internNames = [] {
+        for ( int i = 0; i < 10000; ++i )
+        {
+            InternedName  name( L"NameTableTest::thread" + std::to_wstring(i % 10) );
+            EXPECT_EQ( L"NameTableTest::thread" + std::to_wstring(i % 10), name.str() );
+
+            InternedName  found;
+            EXPECT_TRUE( InternedName::find( name.str(), found ) );
+            EXPECT_TRUE( found == name );
+        }
+    };
+
+    boost::thread_group  threads;
+    for ( int i = 0; i < 4; ++i )
+        threads.create_thread( internNames );
+    threads.join_all();
+
+    EXPECT_EQ( before.nameCount, getNameTableStats().nameCount );
+}
+
+TEST_F( NameTableTest, DISABLED_FootprintBenchmark )
+{
+    // the fields of the types of a module: many fields share a few names
+    const size_t  fieldCount = 100000;
+    const size_t  distinctCount = 2000;
+
+    std::vector<std::wstring>  names;
+    for ( size_t i = 0; i < fieldCount; ++i )
+        names.push_back( L"m_fieldName" + std::to_wstring(i % distinctCount) );
+
+    // a name held by each field
+    size_t  stringsMemory = 0;
+    const size_t  inplaceCapacity = std::wstring().capacity();
+    for ( size_t i = 0; i < names.size(); ++i )
+    {
+        stringsMemory += sizeof(std::wstring);
+        if ( names[i].capacity() > inplaceCapacity )
+            stringsMemory += ( names[i].capacity() + 1 ) * sizeof(wchar_t);
+    }
+
+    // an interned name held by each field
+    NameTableStats  before = getNameTableStats();
+
+    std::vector<InternedName>  internedNames;
+    internedNames.reserve( fieldCount );
+
+    long long  elapsed = measureMicroseconds([&names, &internedNames] {
+        for ( size_t i = 0; i < names.size(); ++i )
+            internedNames.push_back( InternedName(names[i]) );
+    });
+
+    NameTableStats  after = getNameTableStats();
+
+    const size_t  internedMemory = internedNames.size() * sizeof(InternedName) + after.memoryUsage - before.memoryUsage;
+
+    EXPECT_EQ( before.nameCount + distinctCount, after.nameCount );
+    EXPECT_LT( internedMemory, stringsMemory );
+
+    internedNames.clear();
+
+    EXPECT_EQ( before.nameCount, getNameTableStats().nameCount );
+
+    recordBenchmark( "field_count", fieldCount );
+    recordBenchmark( "distinct_name_count", distinctCount );
+    recordBenchmark( "string_names_bytes", stringsMemory );
+    recordBenchmark( "interned_names_bytes", internedMemory );
+    recordBenchmark( "intern_us", elapsed );
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "kdlib/cpucontext.h"
+#include "kdlib/exceptions.h"
+
+// The registers of the getRegisterName switches before the register tables:
+// every one must be found by the name and by the index
+
+static const wchar_t* const  amd64RegisterNames[] = {
+    L"al", L"cl", L"dl", L"bl", L"ah", L"ch", L"dh", L"bh", L"ax", L"cx", L"dx", L"bx", L"sp",
+    L"bp", L"si", L"di", L"eax", L"ecx", L"edx", L"ebx", L"esp", L"ebp", L"esi", L"edi", L"es",
+    L"cs", L"ss", L"ds", L"fs", L"gs", L"eflags", L"rip", L"sil", L"dil", L"bpl", L"spl", L"rax",
+    L"rbx", L"rdx", L"rcx", L"rsi", L"rdi", L"rbp", L"rsp", L"r8", L"r9", L"r10", L"r11", L"r12",
+    L"r13", L"r14", L"r15", L"r8b", L"r9b", L"r10b", L"r11b", L"r12b", L"r13b", L"r14b", L"r15b",
+    L"r8w", L"r9w", L"r10w", L"r11w", L"r12w", L"r13w", L"r14w", L"r15w", L"r8d", L"r9d", L"r10d",
+    L"r11d", L"r12d", L"r13d", L"r14d", L"r15d"
+};
+
+static const wchar_t* const  i386RegisterNames[] = {
+    L"al", L"cl", L"dl", L"bl", L"ah", L"ch", L"dh", L"bh", L"ax", L"cx", L"dx", L"bx", L"sp",
+    L"bp", L"si", L"di", L"eax", L"ecx", L"edx", L"ebx", L"esp", L"ebp", L"esi", L"edi", L"es",
+    L"cs", L"ss", L"ds", L"fs", L"gs", L"ip", L"flags", L"eip", L"eflags"
+};
+
+static const wchar_t* const  armRegisterNames[] = {
+    L"r0", L"r1", L"r2", L"r3", L"r4", L"r5", L"r6", L"r7", L"r8", L"r9", L"r10", L"r11", L"r12",
+    L"sp", L"lr", L"pc", L"psr", L"fpscr", L"d0", L"d1", L"d2", L"d3", L"d4", L"d5", L"d6", L"d7",
+    L"d8", L"d9", L"d10", L"d11", L"d12", L"d13", L"d14", L"d15", L"d16", L"d17", L"d18", L"d19",
+    L"d20", L"d21", L"d22", L"d23", L"d24", L"d25", L"d26", L"d27", L"d28", L"d29", L"d30", L"d31",
+    L"q0", L"q1", L"q2", L"q3", L"q4", L"q5", L"q6", L"q7", L"q8", L"q9", L"q10", L"q11", L"q12",
+    L"q13", L"q14", L"q15"
+};
+
+static const wchar_t* const  arm64RegisterNames[] = {
+    L"w0", L"w1", L"w2", L"w3", L"w4", L"w5", L"w6", L"w7", L"w8", L"w9", L"w10", L"w11", L"w12",
+    L"w13", L"w14", L"w15", L"w16", L"w17", L"w18", L"w19", L"w20", L"w21", L"w22", L"w23", L"w24",
+    L"w25", L"w26", L"w27", L"w28", L"w29", L"w30", L"x0", L"x1", L"x2", L"x3", L"x4", L"x5", L"x6",
+    L"x7", L"x8", L"x9", L"x10", L"x11", L"x12", L"x13", L"x14", L"x15", L"x18", L"x19", L"x20",
+    L"x21", L"x22", L"x23", L"x24", L"x25", L"x26", L"x27", L"x28", L"fp", L"lr", L"sp", L"pc",
+    L"cpsr", L"s0", L"s1", L"s2", L"s3", L"s4", L"s5", L"s6", L"s7", L"s8", L"s9", L"s10", L"s11",
+    L"s12", L"s13", L"s14", L"s15", L"s16", L"s17", L"s18", L"s19", L"s20", L"s21", L"s22", L"s23",
+    L"s24", L"s25", L"s26", L"s27", L"s28", L"s29", L"s30", L"s31", L"d0", L"d1", L"d2", L"d3",
+    L"d4", L"d5", L"d6", L"d7", L"d8", L"d9", L"d10", L"d11", L"d12", L"d13", L"d14", L"d15",
+    L"d16", L"d17", L"d18", L"d19", L"d20", L"d21", L"d22", L"d23", L"d24", L"d25", L"d26", L"d27",
+    L"d28", L"d29", L"d30", L"d31", L"q0", L"q1", L"q2", L"q3", L"q4", L"q5", L"q6", L"q7", L"q8",
+    L"q9", L"q10", L"q11", L"q12", L"q13", L"q14", L"q15", L"q16", L"q17", L"q18", L"q19", L"q20",
+    L"q21", L"q22", L"q23", L"q24", L"q25", L"q26", L"q27", L"q28", L"q29", L"q30", L"q31", L"fpsr",
+    L"fpcr"
+};
+
+template<size_t count>
+void checkRegisterNames( kdlib::CPUContextPtr cpu, const wchar_t* const (&names)[count] )
+{
+    std::map<std::wstring, unsigned long>  indices;
+
+    for ( unsigned long i = 0; i < 0x400; ++i )
+    {
+        try {
+            indices[cpu->getRegisterName(i)] = i;
+        }
+        catch( kdlib::DbgException& )
+        {}
+    }
+
+    for ( size_t i = 0; i < count; ++i )
+    {
+        kdlib::NumVariant  value;
+        ASSERT_NO_THROW( value = cpu->getRegisterByName(names[i]) ) << names[i];
+
+        std::map<std::wstring, unsigned long>::const_iterator  it = indices.find(names[i]);
+        ASSERT_TRUE( it != indices.end() ) << names[i];
+
+        EXPECT_EQ( value, cpu->getRegisterByIndex(it->second) ) << names[i];
+    }
+}
@@ -1,9 +1,13 @@
 #include <stdafx.h>
 
+#include <algorithm>
+#include <set>
+
 #include "memdumpfixture.h"
 #include "eventhandlermock.h"
 
 #include "kdlib/kdlib.h"
+#include "kdlib/nametable.h"
 
 using namespace kdlib;
 
@@ -198,6 +202,47 @@ TEST_P( StackTest, StaticVars )
     EXPECT_THROW(frame->getStaticVar(L"Notexist"), SymbolException);
 }
 
+TEST_P( StackTest, LocalVarsOfSameFunction )
+{
+    StackFramePtr  frame1;
+    StackFramePtr  frame2;
+
+    ASSERT_NO_THROW( frame1 = getStack()->getFrame(2) );
+    ASSERT_NO_THROW( frame2 = getStack()->getFrame(2) );
+
+    ASSERT_EQ( frame1->getLocalVarCount(), frame2->getLocalVarCount() );
+
+    for ( unsigned long i = 0; i < frame1->getLocalVarCount(); ++i )
+    {
+        std::wstring  varName = frame1->getLocalVarName(i);
+
+        EXPECT_EQ( varName, frame2->getLocalVarName(i) );
+        EXPECT_TRUE( frame2->findLocalVar(varName) );
+        EXPECT_EQ( frame1->getLocalVar(i)->getSize(), frame2->getLocalVar(varName)->getSize() );
+    }
+
+    EXPECT_EQ( frame1->getTypedParamCount(), frame2->getTypedParamCount() );
+    EXPECT_EQ( frame1->getStaticVarCount(), frame2->getStaticVarCount() );
+}
+
+TEST_P( StackTest, NotInternedVarName )
+{
+    StackFramePtr  frame;
+    ASSERT_NO_THROW( frame = getStack()->getFrame(2) );
+
+    ASSERT_TRUE( frame->findLocalVar(L"localFloat") );
+
+    size_t  nameCount = getNameTableStats().nameCount;
+
+    // a misspelled name is not found and not interned
+    EXPECT_FALSE( frame->findLocalVar(L"localFloat_NotInterned") );
+    EXPECT_FALSE( frame->findParam(L"param_NotInterned") );
+    EXPECT_FALSE( frame->findStaticVar(L"static_NotInterned") );
+    EXPECT_THROW( frame->getLocalVar(L"localFloat_NotInterned"), SymbolException );
+
+    EXPECT_EQ( nameCount, getNameTableStats().nameCount );
+}
+
 TEST_P( StackTest, ChangeCurrentFrame )
 {
     StackPtr  stack;
@@ -286,6 +331,113 @@ TEST_F(Wow64StackTest, NotCurrentThread)
     EXPECT_EQ(std::wstring(L"TppWorkerThread"), findSymbol(stack->getFrame(1)->getIP()));
 }
 
+TEST_F(Wow64StackTest, ContextsAfterThreadSwitch)
+{
+    THREAD_DEBUG_ID  threadId = getCurrentThreadId();
+
+    StackPtr stack;
+    ASSERT_NO_THROW(stack = getStack());
+    ASSERT_TRUE(stack->getFrameCount() > 2);
+
+    EXPECT_EQ(stack->getFrame(1), stack->getFrame(1));
+
+    // the frame contexts belong to the thread of the stack
+    ASSERT_NO_THROW(setCurrentThreadById(2));
+
+    for (unsigned long i = 0; i < stack->getFrameCount(); ++i)
+    {
+        auto frame = stack->getFrame(i);
+        EXPECT_EQ(frame->getIP(), frame->getCPUContext()->getIP());
+        EXPECT_EQ(frame->getSP(), frame->getCPUContext()->getSP());
+    }
+
+    setCurrentThreadById(threadId);
+}
+
+TEST_F(Wow64StackTest, AllStacks)
+{
+    THREAD_DEBUG_ID  threadId = getCurrentThreadId();
+
+    AllStacksOptions  options;
+    options.maxFrames = 2;
+
+    AllStacks  allStacks = getAllStacks(options);
+
+    EXPECT_EQ(threadId, getCurrentThreadId());
+    ASSERT_EQ(getNumberThreads(), allStacks.threads.size());
+
+    for (auto& threadStack : allStacks.threads)
+    {
+        ASSERT_GE(2UL, threadStack.stack->getFrameCount());
+
+        // the contexts were captured with the thread of the stack
+        for (unsigned long i = 0; i < threadStack.stack->getFrameCount(); ++i)
+        {
+            auto frame = threadStack.stack->getFrame(i);
+            EXPECT_EQ(frame->getIP(), frame->getCPUContext()->getIP());
+        }
+    }
+
+    StackPtr  stack = getStack();
+    for (auto& threadStack : allStacks.threads)
+    {
+        if (threadStack.threadId == threadId && stack->getFrameCount() > 0)
+            EXPECT_EQ(stack->getFrame(0)->getIP(), threadStack.stack->getFrame(0)->getIP());
+    }
+}
+
+class KernelStackTest : public MemDumpFixture
+{
+public:
+    KernelStackTest() :
+        MemDumpFixture(makeDumpFullName(MemDumps::WIN8_X64))
+    {
+    }
+};
+
+TEST_F(KernelStackTest, AllProcesses)
+{
+    AllStacksOptions  options;
+    options.allProcesses = true;
+
+    MEMOFFSET_64  implicitProcess = getImplicitProcessOffset();
+    MEMOFFSET_64  implicitThread = getImplicitThreadOffset();
+
+    AllStacks  allStacks;
+    ASSERT_NO_THROW(allStacks = getAllStacks(options));
+
+    // a kernel target has one engine process with a thread per processor:
+    // the threads of the kernel process list are walked instead
+    EXPECT_EQ(1UL, getNumberProcesses());
+    ASSERT_LT(getNumberThreads(), allStacks.threads.size());
+
+    std::set<MEMOFFSET_64>  processes;
+    unsigned long  processorThreads = 0;
+    unsigned long  unwoundThreads = 0;
+
+    for (auto& threadStack : allStacks.threads)
+    {
+        EXPECT_EQ(getCurrentProcessId(), threadStack.processId);
+        EXPECT_NE(0, threadStack.processOffset);
+        EXPECT_NE(0, threadStack.threadOffset);
+
+        processes.insert(threadStack.processOffset);
+
+        if (threadStack.threadId != static_cast<THREAD_DEBUG_ID>(-1))
+            ++processorThreads;
+
+        if (threadStack.stack->getFrameCount() > 0)
+            ++unwoundThreads;
+    }
+
+    EXPECT_LT(1UL, processes.size());
+    EXPECT_EQ(getNumberThreads(), processorThreads);
+    EXPECT_LT(getNumberThreads(), unwoundThreads);
+
+    EXPECT_EQ(implicitProcess, getImplicitProcessOffset());
+    EXPECT_EQ(implicitThread, getImplicitThreadOffset());
+}
+
 
 class MemDumpSymPathFixture : public MemDumpFixture
 {
@@ -484,3 +636,196 @@ TEST_F(DiaRegToRegRelativeAmd64Test, CV_ALLREG_VFRAME)
   for (unsigned long i = 0; i < localCount; ++i)
     ASSERT_NO_THROW(frame->getLocalVar(i));
 }
+
+class UnwindStackTest : public ::testing::WithParamInterface<const wchar_t*>, public MemDumpSymPathFixture
+{
+public:
+
+    UnwindStackTest() : MemDumpSymPathFixture( makeDumpFullName(GetParam()), makeDumpDirName(GetParam()))
+    {}
+};
+
+TEST_P(UnwindStackTest, CompareWithEngine)
+{
+    auto engineStack = getStack();
+    auto stack = unwindStack();
+
+    ASSERT_LE(engineStack->getFrameCount(), stack->getFrameCount());
+
+    for (unsigned long i = 0; i < engineStack->getFrameCount(); ++i)
+    {
+        EXPECT_EQ(engineStack->getFrame(i)->getIP(), stack->getFrame(i)->getIP());
+        EXPECT_EQ(engineStack->getFrame(i)->getSP(), stack->getFrame(i)->getSP());
+        EXPECT_EQ(engineStack->getFrame(i)->getRET(), stack->getFrame(i)->getRET());
+    }
+}
+
+TEST_P(UnwindStackTest, FrameContext)
+{
+    auto stack = unwindStack();
+
+    for (unsigned long i = 0; i < stack->getFrameCount(); ++i)
+    {
+        auto frame = stack->getFrame(i);
+        EXPECT_EQ(i, frame->getNumber());
+        EXPECT_EQ(frame->getIP(), frame->getCPUContext()->getIP());
+        EXPECT_EQ(frame->getSP(), frame->getCPUContext()->getSP());
+    }
+}
+
+TEST_P(UnwindStackTest, EngineFrameContext)
+{
+    auto stack = getStack();
+
+    for (unsigned long i = stack->getFrameCount(); i-- > 0; )
+    {
+        auto frame = stack->getFrame(i);
+        EXPECT_EQ(frame->getIP(), frame->getCPUContext()->getIP());
+        EXPECT_EQ(frame->getSP(), frame->getCPUContext()->getSP());
+    }
+
+    EXPECT_THROW(stack->getFrame(stack->getFrameCount()), IndexException);
+}
+
+TEST_P(UnwindStackTest, CurrentFrameContext)
+{
+    setCurrentStackFrameByIndex(1);
+
+    auto frame = getCurrentStackFrame();
+    EXPECT_EQ(1, frame->getNumber());
+    EXPECT_EQ(getStack()->getFrame(1)->getIP(), frame->getCPUContext()->getIP());
+
+    resetCurrentStackFrame();
+}
+
+TEST_P(UnwindStackTest, FromContext)
+{
+    auto stack = unwindStack();
+    auto callerStack = unwindStack(stack->getFrame(1)->getCPUContext());
+
+    ASSERT_EQ(stack->getFrameCount() - 1, callerStack->getFrameCount());
+    EXPECT_EQ(stack->getFrame(1)->getIP(), callerStack->getFrame(0)->getIP());
+    EXPECT_EQ(stack->getFrame(2)->getSP(), callerStack->getFrame(1)->getSP());
+}
+
+TEST_P(UnwindStackTest, FindSymbol)
+{
+    auto engineStack = getStack();
+    auto stack = unwindStack();
+
+    MEMDISPLACEMENT  displacement;
+    EXPECT_EQ(engineStack->getFrame(0)->findSymbol(displacement), stack->getFrame(0)->findSymbol(displacement));
+    EXPECT_EQ(engineStack->getFrame(1)->findSymbol(displacement), stack->getFrame(1)->findSymbol(displacement));
+}
+
+TEST_P(UnwindStackTest, AllStacks)
+{
+    THREAD_DEBUG_ID  currentThread = getCurrentThreadId();
+
+    AllStacks  allStacks = getAllStacks();
+
+    EXPECT_EQ(currentThread, getCurrentThreadId());
+    ASSERT_EQ(getNumberThreads(), allStacks.threads.size());
+
+    auto stack = unwindStack();
+
+    for (auto& threadStack : allStacks.threads)
+    {
+        if (threadStack.threadId != currentThread)
+            continue;
+
+        ASSERT_EQ(stack->getFrameCount(), threadStack.stack->getFrameCount());
+        for (unsigned long i = 0; i < stack->getFrameCount(); ++i)
+        {
+            EXPECT_EQ(stack->getFrame(i)->getIP(), threadStack.stack->getFrame(i)->getIP());
+            EXPECT_EQ(stack->getFrame(i)->getSP(), threadStack.stack->getFrame(i)->getSP());
+        }
+
+        EXPECT_EQ(getStackSignature(stack), threadStack.signature);
+    }
+}
+
+TEST_P(UnwindStackTest, AllStacksBuckets)
+{
+    AllStacks  allStacks = getAllStacks();
+
+    size_t  bucketedThreads = 0;
+
+    for (unsigned long i = 0; i < allStacks.buckets.size(); ++i)
+    {
+        auto& bucket = allStacks.buckets[i];
+
+        ASSERT_FALSE(bucket.threads.empty());
+        if (i > 0)
+            EXPECT_GE(allStacks.buckets[i - 1].threads.size(), bucket.threads.size());
+
+        for (auto threadIndex : bucket.threads)
+        {
+            EXPECT_EQ(i, allStacks.threads[threadIndex].bucket);
+            EXPECT_EQ(bucket.signature, allStacks.threads[threadIndex].signature);
+        }
+
+        bucketedThreads += bucket.threads.size();
+    }
+
+    EXPECT_EQ(allStacks.threads.size(), bucketedThreads);
+}
+
+TEST_P(UnwindStackTest, AllStacksOneWorker)
+{
+    AllStacksOptions  options;
+    options.threadCount = 1;
+
+    AllStacks  allStacks = getAllStacks();
+    AllStacks  oneWorkerStacks = getAllStacks(options);
+
+    ASSERT_EQ(allStacks.threads.size(), oneWorkerStacks.threads.size());
+    for (size_t i = 0; i < allStacks.threads.size(); ++i)
+        EXPECT_EQ(allStacks.threads[i].signature, oneWorkerStacks.threads[i].signature);
+}
+
+TEST_P(UnwindStackTest, AllStacksMaxFrames)
+{
+    AllStacksOptions  options;
+    options.maxFrames = 2;
+
+    AllStacks  allStacks = getAllStacks(options);
+
+    for (auto& threadStack : allStacks.threads)
+        EXPECT_GE(2UL, threadStack.stack->getFrameCount());
+}
+
+TEST_P(UnwindStackTest, ScanStack)
+{
+    auto stack = getStack();
+    auto frames = scanStackForReturnAddresses();
+
+    ASSERT_FALSE(frames.empty());
+
+    for (size_t i = 1; i < frames.size(); ++i)
+        EXPECT_LT(frames[i - 1].slot, frames[i].slot);
+
+    // the real return addresses are found with the callers' symbols
+    for (unsigned long i = 0; i + 1 < stack->getFrameCount(); ++i)
+    {
+        MEMOFFSET_64  returnAddress = stack->getFrame(i)->getRET();
+
+        auto it = std::find_if(frames.begin(), frames.end(), [=](const ScannedFrame& frame) { return frame.returnAddress == returnAddress; });
+        ASSERT_NE(frames.end(), it);
+
+        MEMDISPLACEMENT  displacement;
+        EXPECT_EQ(stack->getFrame(i + 1)->findSymbol(displacement), it->symbol);
+        EXPECT_LT(it->callSite, it->returnAddress);
+        EXPECT_LE(1UL, it->score);
+    }
+}
+
+TEST_P(UnwindStackTest, ScanStackDepth)
+{
+    EXPECT_EQ(2U, scanStackForReturnAddresses(CURRENT_THREAD_ID, 2).size());
+}
+
+INSTANTIATE_TEST_CASE_P(Amd64StackDumps, UnwindStackTest, ::testing::Values(
+    MemDumps::STACKTEST_X64_RELEASE
+    ,MemDumps::STACKTEST_CV_ALLREG_AMD64
+));
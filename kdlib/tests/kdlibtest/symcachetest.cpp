@@ -0,0 +1,320 @@
+#include <stdafx.h>
+
+#include <vector>
+
+#include <boost/thread/thread.hpp>
+#include <boost/atomic.hpp>
+
+#include "gtest/gtest.h"
+
+#include "kdlib/symcache.h"
+#include "kdlib/exceptions.h"
+
+using namespace kdlib;
+
+///////////////////////////////////////////////////////////////////////////////
+
+class SymbolMock : public Symbol
+{
+public:
+
+    SymbolMock( const std::wstring &name, size_t size = 0 ) :
+        m_name( name ),
+        m_size( size ),
+        nameCalls( 0 ),
+        sizeCalls( 0 ),
+        findChildrenCalls( 0 ),
+        childByNameCalls( 0 ),
+        childCountCalls( 0 )
+        {}
+
+    void addChild( const SymbolPtr &child ) {
+        m_children.push_back( child );
+    }
+
+    virtual SymbolPtrList findChildren( unsigned long symTag, const std::wstring &name = L"", bool caseSensitive = false ) {
+        ++findChildrenCalls;
+        SymbolPtrList  lst;
+        for ( SymbolPtrList::iterator it = m_children.begin(); it != m_children.end(); ++it )
+            if ( name.empty() || (*it)->getName() == name )
+                lst.push_back( *it );
+        return lst;
+    }
+
+    virtual SymbolPtr getChildByName( const std::wstring &name ) {
+        ++childByNameCalls;
+        for ( SymbolPtrList::iterator it = m_children.begin(); it != m_children.end(); ++it )
+            if ( (*it)->getName() == name )
+                return *it;
+        throw SymbolException( name + L" is not found" );
+    }
+
+    virtual size_t getChildCount() {
+        ++childCountCalls;
+        return m_children.size();
+    }
+
+    virtual std::wstring getName() {
+        ++nameCalls;
+        return m_name;
+    }
+
+    virtual size_t getSize() {
+        ++sizeCalls;
+        if ( m_size == 0 )
+            throw SymbolException( L"no size" );
+        return m_size;
+    }
+
+    virtual SymbolPtrList findChildrenByRVA( unsigned long symTag, unsigned long rva ) { NOT_IMPLEMENTED(); }
+    virtual unsigned long getBaseType() { NOT_IMPLEMENTED(); }
+    virtual BITOFFSET getBitPosition() { NOT_IMPLEMENTED(); }
+    virtual SymbolPtr getChildByIndex( unsigned long index ) { NOT_IMPLEMENTED(); }
+    virtual SymbolPtr getChildByIndex( unsigned long symTag, unsigned long index ) { NOT_IMPLEMENTED(); }
+    virtual size_t getChildCount( unsigned long symTag ) { NOT_IMPLEMENTED(); }
+    virtual size_t getCount() { NOT_IMPLEMENTED(); }
+    virtual unsigned long getDataKind() { NOT_IMPLEMENTED(); }
+    virtual SymbolPtr getIndexType() { NOT_IMPLEMENTED(); }
+    virtual unsigned long getLocType() { NOT_IMPLEMENTED(); }
+    virtual MachineTypes getMachineType() { NOT_IMPLEMENTED(); }
+    virtual std::wstring getScopeName() { NOT_IMPLEMENTED(); }
+    virtual NAME_ID getNameId() { NOT_IMPLEMENTED(); }
+    virtual MEMOFFSET_REL getOffset() { NOT_IMPLEMENTED(); }
+    virtual unsigned long getRva() { NOT_IMPLEMENTED(); }
+    virtual SymTags getSymTag() { NOT_IMPLEMENTED(); }
+    virtual SymbolPtr getType() { NOT_IMPLEMENTED(); }
+    virtual unsigned long getUdtKind() { NOT_IMPLEMENTED(); }
+    virtual MEMOFFSET_64 getVa() { NOT_IMPLEMENTED(); }
+    virtual void getValue( NumVariant &vtValue ) { NOT_IMPLEMENTED(); }
+    virtual unsigned long getVirtualBaseDispIndex() { NOT_IMPLEMENTED(); }
+    virtual int getVirtualBasePointerOffset() { NOT_IMPLEMENTED(); }
+    virtual unsigned long getVirtualBaseDispSize() { NOT_IMPLEMENTED(); }
+    virtual bool isBasicType() { NOT_IMPLEMENTED(); }
+    virtual bool isConstant() { NOT_IMPLEMENTED(); }
+    virtual bool isIndirectVirtualBaseClass() { NOT_IMPLEMENTED(); }
+    virtual bool isVirtualBaseClass() { NOT_IMPLEMENTED(); }
+    virtual bool isVirtual() { NOT_IMPLEMENTED(); }
+    virtual unsigned long getRegisterId() { NOT_IMPLEMENTED(); }
+    virtual unsigned long getRegRelativeId() { NOT_IMPLEMENTED(); }
+    virtual SymbolPtr getObjectPointerType() { NOT_IMPLEMENTED(); }
+    virtual unsigned long getCallingConvention() { NOT_IMPLEMENTED(); }
+    virtual SymbolPtr getClassParent() { NOT_IMPLEMENTED(); }
+    virtual SymbolPtr getVirtualTableShape() { NOT_IMPLEMENTED(); }
+    virtual unsigned long getVirtualBaseOffset() { NOT_IMPLEMENTED(); }
+    virtual SymbolPtrList findInlineFramesByVA( MEMOFFSET_64 ) { NOT_IMPLEMENTED(); }
+    virtual void getInlineSourceLine( MEMOFFSET_64, std::wstring &fileName, unsigned long &lineNo ) { NOT_IMPLEMENTED(); }
+    virtual SymbolPtr getLexicalParent() { NOT_IMPLEMENTED(); }
+
+    boost::atomic<int>  nameCalls;
+    boost::atomic<int>  sizeCalls;
+    boost::atomic<int>  findChildrenCalls;
+    boost::atomic<int>  childByNameCalls;
+    boost::atomic<int>  childCountCalls;
+
+private:
+
+    std::wstring  m_name;
+    size_t  m_size;
+    SymbolPtrList  m_children;
+};
+
+typedef boost::shared_ptr<SymbolMock>  SymbolMockPtr;
+
+///////////////////////////////////////////////////////////////////////////////
+
+class SymbolSessionMock : public SymbolSession
+{
+public:
+
+    SymbolSessionMock( const SymbolPtr &scope ) :
+        m_scope( scope ),
+        findByRvaCalls( 0 )
+        {}
+
+    virtual SymbolPtr getSymbolScope() {
+        return m_scope;
+    }
+
+    virtual SymbolPtr findByRva( MEMOFFSET_32 rva, unsigned long symTag = SymTagNull, long* displacement = NULL ) {
+        ++findByRvaCalls;
+        if ( displacement )
+            *displacement = rva % 0x10;
+        // nothing below the first page
+        return rva < 0x1000 ? SymbolPtr() : m_scope;
+    }
+
+    virtual void getSourceLine( MEMOFFSET_64 offset, std::wstring &fileName, unsigned long &lineNo, long &displacement ) {
+        NOT_IMPLEMENTED();
+    }
+
+    virtual void getLineTable( SymbolLineList &lines, std::vector<std::wstring> &fileNames ) {
+        NOT_IMPLEMENTED();
+    }
+
+    virtual std::wstring getSymbolFileName() {
+        return L"mock";
+    }
+
+    boost::atomic<int>  findByRvaCalls;
+
+private:
+
+    SymbolPtr  m_scope;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class SymbolCacheTest : public ::testing::Test {
+
+protected:
+
+    virtual void SetUp() {
+        m_root = SymbolMockPtr( new SymbolMock(L"root") );
+        for ( int i = 0; i < 10; ++i )
+            m_root->addChild( SymbolPtr( new SymbolMock(L"child" + std::to_wstring(i), i + 1) ) );
+    }
+
+    SymbolMockPtr  m_root;
+};
+
+TEST_F( SymbolCacheTest, Properties )
+{
+    SymbolPtr  sym = getCachingSymbol( m_root );
+
+    EXPECT_EQ( L"root", sym->getName() );
+    EXPECT_EQ( L"root", sym->getName() );
+    EXPECT_EQ( 1, m_root->nameCalls );
+
+    // exceptions are not memoized
+    EXPECT_THROW( sym->getSize(), SymbolException );
+    EXPECT_THROW( sym->getSize(), SymbolException );
+    EXPECT_EQ( 2, m_root->sizeCalls );
+}
+
+TEST_F( SymbolCacheTest, Children )
+{
+    SymbolPtr  sym = getCachingSymbol( m_root );
+
+    SymbolPtrList  children1 = sym->findChildren( SymTagData );
+    SymbolPtrList  children2 = sym->findChildren( SymTagData );
+
+    EXPECT_EQ( 1, m_root->findChildrenCalls );
+    ASSERT_EQ( 10, children1.size() );
+    EXPECT_TRUE( children1 == children2 );
+
+    EXPECT_EQ( 1, sym->findChildren( SymTagData, L"child5" ).size() );
+    EXPECT_EQ( 2, m_root->findChildrenCalls );
+
+    EXPECT_EQ( 10, sym->getChildCount() );
+    EXPECT_EQ( 10, sym->getChildCount() );
+    EXPECT_EQ( 1, m_root->childCountCalls );
+
+    SymbolPtr  child = sym->getChildByName( L"child3" );
+    EXPECT_EQ( child, sym->getChildByName( L"child3" ) );
+    EXPECT_EQ( 1, m_root->childByNameCalls );
+    EXPECT_EQ( 4, child->getSize() );
+
+    EXPECT_THROW( sym->getChildByName( L"notExist" ), SymbolException );
+
+    SymbolCacheStats  stats = getSymbolCacheStats( sym );
+    EXPECT_EQ( 4, stats.entryCount );
+    EXPECT_EQ( 3, stats.hitCount );
+    EXPECT_LE( stats.memoryUsage, stats.memoryBudget );
+}
+
+TEST_F( SymbolCacheTest, MemoryBudget )
+{
+    SymbolPtr  sym = getCachingSymbol( m_root, 4 * 1024 );
+
+    for ( int i = 0; i < 100; ++i )
+        sym->findChildren( SymTagData, L"child" + std::to_wstring(i % 10) + L"*" + std::to_wstring(i) );
+
+    SymbolCacheStats  stats = getSymbolCacheStats( sym );
+    EXPECT_LT( 0, stats.evictionCount );
+    EXPECT_GT( 100, stats.entryCount );
+    EXPECT_LE( stats.memoryUsage, stats.memoryBudget );
+}
+
+TEST_F( SymbolCacheTest, BackendSymbolSize )
+{
+    SymbolPtr  sym1 = getCachingSymbol( m_root, DefaultSymbolCacheBudget, 0 );
+    SymbolPtr  sym2 = getCachingSymbol( m_root, DefaultSymbolCacheBudget, 1024 );
+
+    sym1->findChildren( SymTagData );
+    sym2->findChildren( SymTagData );
+
+    EXPECT_EQ( getSymbolCacheStats(sym1).memoryUsage + 10 * 1024, getSymbolCacheStats(sym2).memoryUsage );
+}
+
+TEST_F( SymbolCacheTest, Session )
+{
+    SymbolSessionPtr  mockSession( new SymbolSessionMock( m_root ) );
+    SymbolSessionPtr  session = getCachingSymbolSession( mockSession );
+
+    EXPECT_EQ( session, getCachingSymbolSession( session ) );
+    EXPECT_EQ( session->getSymbolScope(), session->getSymbolScope() );
+
+    long  displacement = 0;
+    SymbolPtr  sym = session->findByRva( 0x1234, SymTagFunction, &displacement );
+    EXPECT_EQ( 4, displacement );
+
+    displacement = 0;
+    EXPECT_EQ( sym, session->findByRva( 0x1234, SymTagFunction, &displacement ) );
+    EXPECT_EQ( 4, displacement );
+    EXPECT_EQ( 1, static_cast<SymbolSessionMock*>( mockSession.get() )->findByRvaCalls );
+
+    // a miss is returned as null and not queried again
+    EXPECT_FALSE( session->findByRva( 0x12, SymTagFunction, &displacement ) );
+    EXPECT_EQ( 2, displacement );
+    EXPECT_FALSE( session->findByRva( 0x12, SymTagFunction, &displacement ) );
+    EXPECT_EQ( 2, static_cast<SymbolSessionMock*>( mockSession.get() )->findByRvaCalls );
+
+    sym->findChildren( SymTagData );
+    EXPECT_LT( 0, getSymbolCacheStats(session).entryCount );
+
+    clearSymbolCache( session );
+    EXPECT_EQ( 0, getSymbolCacheStats(session).entryCount );
+
+    EXPECT_THROW( getSymbolCacheStats( mockSession ), DbgException );
+}
+
+TEST_F( SymbolCacheTest, SymbolOutlivesSession )
+{
+    SymbolPtr  child;
+
+    {
+        SymbolSessionPtr  session = getCachingSymbolSession( SymbolSessionPtr( new SymbolSessionMock( m_root ) ) );
+        child = session->getSymbolScope()->findChildren( SymTagData ).front();
+    }
+
+    EXPECT_EQ( L"child0", child->getName() );
+    EXPECT_EQ( 1, child->getSize() );
+}
+
+static void findChildrenThread( SymbolPtr sym, int* errors )
+{
+    for ( int i = 0; i < 1000; ++i )
+    {
+        SymbolPtrList  lst = sym->findChildren( SymTagData, L"child" + std::to_wstring(i % 10) );
+        if ( lst.size() != 1 || lst.front()->getName() != L"child" + std::to_wstring(i % 10) )
+            ++*errors;
+    }
+}
+
+TEST_F( SymbolCacheTest, Threads )
+{
+    SymbolPtr  sym = getCachingSymbol( m_root, 8 * 1024 );
+
+    std::vector<int>  errors(4, 0);
+    boost::thread_group  threads;
+
+    for ( size_t i = 0; i < errors.size(); ++i )
+        threads.create_thread( boost::bind( &findChildrenThread, sym, &errors[i] ) );
+
+    threads.join_all();
+
+    for ( size_t i = 0; i < errors.size(); ++i )
+        EXPECT_EQ( 0, errors[i] );
+}
+
+///////////////////////////////////////////////////////////////////////////////
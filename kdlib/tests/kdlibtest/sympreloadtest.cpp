@@ -0,0 +1,119 @@
+#include <stdafx.h>
+
+#include "kdlib/sympreload.h"
+#include "kdlib/module.h"
+#include "kdlib/exceptions.h"
+
+#include "procfixture.h"
+
+using namespace kdlib;
+
+class SymbolPreloadTest : public ProcessFixture
+{
+public:
+
+    SymbolPreloadTest() : ProcessFixture(L"stacktest") {}
+};
+
+TEST_F(SymbolPreloadTest, TargetModule)
+{
+    SymbolPreloadPolicy  policy;
+    policy.moduleMask = L"TARGETAPP*";
+
+    SymbolPreloadPtr  preload;
+    ASSERT_NO_THROW(preload = preloadSymbols(policy));
+
+    preload->wait();
+    EXPECT_TRUE(preload->isCompleted());
+
+    SymbolPreloadProgress  progress = preload->getProgress();
+    EXPECT_EQ(1, progress.total);
+    EXPECT_EQ(1, progress.completed);
+    EXPECT_EQ(0, progress.failed);
+
+    boost::shared_future<SymbolSessionPtr>  future = preload->getModuleSymbols(m_targetModule->getBase());
+    ASSERT_TRUE(future.is_ready());
+    EXPECT_TRUE(!!future.get());
+
+    EXPECT_NE(0, m_targetModule->getSymbolVa(L"CdeclFunc"));
+}
+
+TEST_F(SymbolPreloadTest, NoModules)
+{
+    SymbolPreloadPolicy  policy;
+    policy.moduleMask = L"nosuchmodule";
+
+    SymbolPreloadPtr  preload = preloadSymbols(policy);
+
+    EXPECT_TRUE(preload->isCompleted());
+    EXPECT_EQ(0, preload->getProgress().total);
+    EXPECT_THROW(preload->getModuleSymbols(m_targetModule->getBase()), DbgException);
+}
+
+TEST_F(SymbolPreloadTest, OneWorker)
+{
+    SymbolPreloadPolicy  policy;
+    policy.threadCount = 1;
+    policy.stackModulesFirst = false;
+
+    SymbolPreloadPtr  preload = preloadSymbols(policy);
+    preload->wait();
+
+    SymbolPreloadProgress  progress = preload->getProgress();
+    EXPECT_EQ(getNumberModules(), progress.total);
+    EXPECT_EQ(progress.total, progress.completed + progress.failed);
+}
+
+TEST_F(SymbolPreloadTest, StackModulesFirst)
+{
+    SymbolPreloadPolicy  policy;
+    policy.stackModulesFirst = true;
+
+    SymbolPreloadPtr  preload = preloadSymbols(policy);
+    preload->wait();
+
+    // a module promoted by the stack walk is loaded once
+    SymbolPreloadProgress  progress = preload->getProgress();
+    EXPECT_EQ(getNumberModules(), progress.total);
+    EXPECT_EQ(progress.total, progress.completed + progress.failed);
+}
+
+TEST_F(SymbolPreloadTest, Cancel)
+{
+    SymbolPreloadPolicy  policy;
+    policy.threadCount = 1;
+
+    SymbolPreloadPtr  preload = preloadSymbols(policy);
+
+    preload->cancel();
+    preload->wait();
+    EXPECT_TRUE(preload->isCompleted());
+
+    SymbolPreloadProgress  progress = preload->getProgress();
+    EXPECT_GE(progress.total, progress.completed + progress.failed);
+
+    // the module loads its symbols itself
+    EXPECT_NE(0, m_targetModule->getSymbolVa(L"CdeclFunc"));
+}
+
+TEST_F(SymbolPreloadTest, ReleaseNotCompleted)
+{
+    SymbolPreloadPtr  preload = preloadSymbols();
+    preload.reset();
+
+    EXPECT_NE(0, m_targetModule->getSymbolVa(L"CdeclFunc"));
+}
+
+TEST_F(SymbolPreloadTest, TakenByModule)
+{
+    SymbolPreloadPolicy  policy;
+    policy.moduleMask = L"targetapp*";
+
+    SymbolPreloadPtr  preload = preloadSymbols(policy);
+
+    // the module waits for the preload instead of loading the symbols again
+    EXPECT_NE(0, m_targetModule->getSymbolVa(L"CdeclFunc"));
+
+    preload->wait();
+    EXPECT_EQ(1, preload->getProgress().completed);
+}
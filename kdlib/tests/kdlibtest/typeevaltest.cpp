@@ -614,3 +614,38 @@ TEST(TypeEvalTest, TemplateWcharT)
 
     EXPECT_EQ(L"TestStruct<wchar_t>", evalType("TestStruct<wchar_t>", typeProvider)->getName());
 }
+
+
+TEST(TypeEvalTest, Cache)
+{
+    static const char sourceCode[] = " \
+    struct TestStruct {                \
+        int  field;                    \
+    };                                 \
+    ";
+
+    TypeInfoProviderPtr  typeProvider = getTypeInfoProviderFromSource(sourceCode);
+
+    TypeInfoPtr  typeInfo = evalType("TestStruct*[3]", typeProvider);
+
+    EXPECT_EQ(L"TestStruct*[3]", typeInfo->getName());
+    EXPECT_EQ(typeInfo, evalType("TestStruct*[3]", typeProvider));
+
+    // the types are kept for the provider
+    TypeInfoProviderPtr  otherProvider = getTypeInfoProviderFromSource(sourceCode);
+    EXPECT_NE(typeInfo, evalType("TestStruct*[3]", otherProvider));
+
+    // a failed evaluation is not kept
+    EXPECT_THROW(evalType("NoStruct*", typeProvider), TypeException);
+    EXPECT_THROW(evalType("NoStruct*", typeProvider), TypeException);
+
+    // a new provider at the address of a destroyed one does not get its types
+    TypeInfoProvider  *address = typeProvider.get();
+    typeProvider.reset();
+
+    TypeInfoProviderPtr  newProvider = getTypeInfoProviderFromSource("struct TestStruct { char  field; };");
+    if (newProvider.get() == address)
+        EXPECT_NE(typeInfo, evalType("TestStruct*[3]", newProvider));
+
+    EXPECT_EQ(getDefaultTypeInfoProvider(), getDefaultTypeInfoProvider());
+}
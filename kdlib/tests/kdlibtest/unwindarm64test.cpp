@@ -0,0 +1,554 @@
+#include <stdafx.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "../../source/unwindarm64.h"
+
+#include "benchmark.h"
+
+using namespace kdlib;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The unwinder over a synthetic memory image: the functions are given by
+// their prolog and epilog instructions, the unwind data is built by hand and
+// the unwound context is compared with the caller context at every prolog
+// and epilog instruction
+
+namespace {
+
+const MEMOFFSET_64  ImageBase = 0x140000000;
+const size_t  ImageSize = 0x10000;
+
+const MEMOFFSET_64  StackBase = 0x100000;
+const size_t  StackSize = 0x10000;
+
+// 0 - 30: x0 - x30, 32 - 63: d0 - d31
+const int  NoReg = -1;
+const int  RegD0 = 32;
+
+enum OpKind {
+    OpSavePreIndex,     // stp/str reg1, reg2, [sp, #-offset]!
+    OpSave,             // stp/str reg1, reg2, [sp, #offset]
+    OpAlloc,            // sub sp, sp, #offset
+    OpSetFp             // mov x29, sp
+};
+
+struct PrologOp {
+    OpKind  kind;
+    int  reg1;
+    int  reg2;
+    boost::uint32_t  offset;
+};
+
+typedef std::vector<PrologOp>  PrologOps;
+
+class SyntheticTarget : public UnwindTarget
+{
+public:
+
+    SyntheticTarget() :
+        m_image( ImageSize ),
+        m_stack( StackSize )
+        {}
+
+    bool readMemory( MEMOFFSET_64 offset, void* buffer, size_t length ) override
+    {
+        const unsigned char*  ptr = at( offset, length );
+        if ( !ptr )
+            return false;
+
+        memcpy( buffer, ptr, length );
+        return true;
+    }
+
+    UnwindFunctionTablePtr getFunctionTable( MEMOFFSET_64 offset ) override
+    {
+        return m_table && m_table->inRange(offset) ? m_table : UnwindFunctionTablePtr();
+    }
+
+    void write( MEMOFFSET_64 offset, const void* buffer, size_t length )
+    {
+        memcpy( at( offset, length ), buffer, length );
+    }
+
+    boost::uint64_t read64( MEMOFFSET_64 offset )
+    {
+        boost::uint64_t  value;
+        memcpy( &value, at( offset, sizeof(value) ), sizeof(value) );
+        return value;
+    }
+
+    void addFunction( boost::uint32_t begin, boost::uint32_t length, boost::uint32_t unwindData )
+    {
+        UnwindFunction  function = { begin, begin + length * 4, unwindData };
+        m_functions.push_back( function );
+
+        std::vector<UnwindFunction>  functions( m_functions );
+        m_table.reset( new UnwindFunctionTable( ImageBase, ImageSize, functions ) );
+    }
+
+private:
+
+    unsigned char* at( MEMOFFSET_64 offset, size_t length )
+    {
+        if ( offset >= ImageBase && offset + length <= ImageBase + m_image.size() )
+            return &m_image[static_cast<size_t>(offset - ImageBase)];
+
+        if ( offset >= StackBase && offset + length <= StackBase + m_stack.size() )
+            return &m_stack[static_cast<size_t>(offset - StackBase)];
+
+        return 0;
+    }
+
+    std::vector<unsigned char>  m_image;
+    std::vector<unsigned char>  m_stack;
+
+    std::vector<UnwindFunction>  m_functions;
+    UnwindFunctionTablePtr  m_table;
+};
+
+boost::uint64_t& reg( UnwindContextArm64 &context, int regIndex )
+{
+    return regIndex >= RegD0 ? context.d[regIndex - RegD0] : context.x[regIndex];
+}
+
+void storeReg( SyntheticTarget &target, UnwindContextArm64 &context, int regIndex, MEMOFFSET_64 offset )
+{
+    if ( regIndex != NoReg )
+        target.write( offset, &reg( context, regIndex ), sizeof(boost::uint64_t) );
+}
+
+void loadReg( SyntheticTarget &target, UnwindContextArm64 &context, int regIndex, MEMOFFSET_64 offset )
+{
+    if ( regIndex != NoReg )
+        reg( context, regIndex ) = target.read64( offset );
+}
+
+void runProlog( SyntheticTarget &target, UnwindContextArm64 &context, const PrologOp &op )
+{
+    switch ( op.kind )
+    {
+    case OpSavePreIndex:
+        context.sp -= op.offset;
+        storeReg( target, context, op.reg1, context.sp );
+        storeReg( target, context, op.reg2, context.sp + 8 );
+        break;
+
+    case OpSave:
+        storeReg( target, context, op.reg1, context.sp + op.offset );
+        storeReg( target, context, op.reg2, context.sp + op.offset + 8 );
+        break;
+
+    case OpAlloc:
+        context.sp -= op.offset;
+        break;
+
+    case OpSetFp:
+        context.x[UnwindRegFpArm64] = context.sp;
+        break;
+    }
+}
+
+void runEpilog( SyntheticTarget &target, UnwindContextArm64 &context, const PrologOp &op )
+{
+    switch ( op.kind )
+    {
+    case OpSavePreIndex:
+        loadReg( target, context, op.reg1, context.sp );
+        loadReg( target, context, op.reg2, context.sp + 8 );
+        context.sp += op.offset;
+        break;
+
+    case OpSave:
+        loadReg( target, context, op.reg1, context.sp + op.offset );
+        loadReg( target, context, op.reg2, context.sp + op.offset + 8 );
+        break;
+
+    case OpAlloc:
+        context.sp += op.offset;
+        break;
+
+    case OpSetFp:
+        context.sp = context.x[UnwindRegFpArm64];
+        break;
+    }
+}
+
+// the function body changes the saved nonvolatile registers
+void changeSavedRegs( UnwindContextArm64 &context, const PrologOps &prolog, boost::uint64_t mask )
+{
+    for ( size_t i = 0; i < prolog.size(); ++i )
+    {
+        if ( prolog[i].kind != OpSavePreIndex && prolog[i].kind != OpSave )
+            continue;
+
+        int  regs[] = { prolog[i].reg1, prolog[i].reg2 };
+
+        for ( size_t j = 0; j < 2; ++j )
+        {
+            if ( regs[j] >= 19 && regs[j] != static_cast<int>(UnwindRegFpArm64) )
+                reg( context, regs[j] ) ^= mask;
+        }
+    }
+}
+
+PrologOps reversed( PrologOps ops )
+{
+    std::reverse( ops.begin(), ops.end() );
+    return ops;
+}
+
+UnwindContextArm64 makeCallerContext()
+{
+    UnwindContextArm64  context = {};
+
+    context.sp = StackBase + 0x8000;
+
+    for ( int i = 0; i < 31; ++i )
+        context.x[i] = 0x1000 + i;
+
+    context.x[UnwindRegFpArm64] = StackBase + 0xA000;
+    context.x[UnwindRegLrArm64] = ImageBase + 0x800;
+
+    for ( int i = 0; i < 32; ++i )
+        context.d[i] = 0xD000 + i;
+
+    return context;
+}
+
+void expectCallerContext( const UnwindContextArm64 &caller, const UnwindContextArm64 &context )
+{
+    EXPECT_EQ( caller.sp, context.sp );
+    EXPECT_EQ( caller.x[UnwindRegLrArm64], context.pc );
+
+    for ( int i = 19; i <= 30; ++i )
+        EXPECT_EQ( caller.x[i], context.x[i] ) << "x" << i;
+
+    for ( int i = 8; i <= 15; ++i )
+        EXPECT_EQ( caller.d[i], context.d[i] ) << "d" << i;
+}
+
+// packed unwind data: Flag = 1
+boost::uint32_t packedData( boost::uint32_t length, boost::uint32_t regF, boost::uint32_t regI, boost::uint32_t h, boost::uint32_t cr, boost::uint32_t frameSize )
+{
+    return 1 | ( length << 2 ) | ( regF << 13 ) | ( regI << 16 ) | ( h << 20 ) | ( cr << 21 ) | ( frameSize << 23 );
+}
+
+} // end nameless namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+class UnwindArm64Test : public ::testing::Test
+{
+protected:
+
+    // Unwinds at every prolog instruction, at every epilog instruction and
+    // at a call in the body. The epilog ends with ret at the function end
+    void checkFunction( boost::uint32_t rva, const PrologOps &prolog, const PrologOps &epilog, size_t epilogStart )
+    {
+        UnwindContextArm64  caller = makeCallerContext();
+
+        for ( size_t i = 0; i <= prolog.size(); ++i )
+        {
+            SCOPED_TRACE( ::testing::Message() << "prolog instruction " << i );
+
+            UnwindContextArm64  context = caller;
+
+            for ( size_t j = 0; j < i; ++j )
+                runProlog( m_target, context, prolog[j] );
+
+            if ( i == prolog.size() )
+                changeSavedRegs( context, prolog, 0xFF00 );
+
+            context.pc = ImageBase + rva + 4 * i;
+
+            expectUnwind( caller, context, true );
+        }
+
+        UnwindContextArm64  body = caller;
+
+        for ( size_t i = 0; i < prolog.size(); ++i )
+            runProlog( m_target, body, prolog[i] );
+
+        changeSavedRegs( body, prolog, 0x5500 );
+
+        for ( size_t i = 0; i <= epilog.size(); ++i )
+        {
+            SCOPED_TRACE( ::testing::Message() << "epilog instruction " << i );
+
+            UnwindContextArm64  context = body;
+
+            for ( size_t j = 0; j < i; ++j )
+                runEpilog( m_target, context, epilog[j] );
+
+            context.pc = ImageBase + rva + 4 * ( epilogStart + i );
+
+            expectUnwind( caller, context, true );
+        }
+
+        SCOPED_TRACE( "return address in the body" );
+
+        body.pc = ImageBase + rva + 4 * ( prolog.size() + 1 );
+
+        expectUnwind( caller, body, false );
+    }
+
+    void expectUnwind( const UnwindContextArm64 &caller, UnwindContextArm64 context, bool firstFrame )
+    {
+        bool  machineFrame = firstFrame;
+        MEMOFFSET_64  establisherFrame = 0;
+
+        ASSERT_TRUE( unwindFrameArm64( m_target, context, machineFrame, establisherFrame ) );
+        EXPECT_FALSE( machineFrame );
+
+        expectCallerContext( caller, context );
+    }
+
+    // stp x19,x20,[sp,#-32]!; stp x21,x22,[sp,#16]; stp x29,lr,[sp,#-16]!; mov x29,sp; sub sp,sp,#64
+    // ... mov sp,x29; ldp x29,lr,[sp],#16; ldp x21,x22,[sp,#16]; ldp x19,x20,[sp],#32; ret
+    PrologOps fullProlog() const
+    {
+        PrologOp  ops[] = {
+            { OpSavePreIndex, 19, 20, 32 },
+            { OpSave, 21, 22, 16 },
+            { OpSavePreIndex, 29, 30, 16 },
+            { OpSetFp, NoReg, NoReg, 0 },
+            { OpAlloc, NoReg, NoReg, 64 }
+        };
+
+        return PrologOps( ops, ops + sizeof(ops) / sizeof(ops[0]) );
+    }
+
+    PrologOps fullEpilog() const
+    {
+        PrologOps  ops = reversed( fullProlog() );
+        ops.erase( ops.begin() );
+        return ops;
+    }
+
+    static const boost::uint32_t  FullLength = 20;
+    static const size_t  FullEpilogStart = FullLength - 5;
+
+    // alloc_s(4) set_fp save_fplr_x(1) save_next save_r19r20_x(4) end,
+    // the epilog codes from the index 6: set_fp save_fplr_x save_next save_r19r20_x end
+    void writeFullCodes( MEMOFFSET_64 offset )
+    {
+        const unsigned char  codes[16] = { 0x04, 0xE1, 0x81, 0xE6, 0x24, 0xE4, 0xE1, 0x81, 0xE6, 0x24, 0xE4 };
+        m_target.write( offset, codes, sizeof(codes) );
+    }
+
+    SyntheticTarget  m_target;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST_F(UnwindArm64Test, FullUnwindData)
+{
+    // one epilog scope, 4 code words
+    boost::uint32_t  header = FullLength | ( 1 << 22 ) | ( 4u << 27 );
+    boost::uint32_t  scope = FullEpilogStart | ( 6u << 22 );
+
+    m_target.write( ImageBase + 0x8000, &header, sizeof(header) );
+    m_target.write( ImageBase + 0x8004, &scope, sizeof(scope) );
+    writeFullCodes( ImageBase + 0x8008 );
+
+    m_target.addFunction( 0x1000, FullLength, 0x8000 );
+
+    checkFunction( 0x1000, fullProlog(), fullEpilog(), FullEpilogStart );
+}
+
+TEST_F(UnwindArm64Test, FullUnwindDataSingleEpilog)
+{
+    // E bit: the epilog code index is in the header
+    boost::uint32_t  header = FullLength | ( 1 << 21 ) | ( 6u << 22 ) | ( 4u << 27 );
+
+    m_target.write( ImageBase + 0x8100, &header, sizeof(header) );
+    writeFullCodes( ImageBase + 0x8104 );
+
+    m_target.addFunction( 0x2000, FullLength, 0x8100 );
+
+    checkFunction( 0x2000, fullProlog(), fullEpilog(), FullEpilogStart );
+}
+
+TEST_F(UnwindArm64Test, PackedFramePointer)
+{
+    // stp x19,x20,[sp,#-48]!; str x21,[sp,#16]; stp d8,d9,[sp,#24]; stp x29,lr,[sp,#-64]!; mov x29,sp
+    PrologOp  ops[] = {
+        { OpSavePreIndex, 19, 20, 48 },
+        { OpSave, 21, NoReg, 16 },
+        { OpSave, RegD0 + 8, RegD0 + 9, 24 },
+        { OpSavePreIndex, 29, 30, 64 },
+        { OpSetFp, NoReg, NoReg, 0 }
+    };
+
+    PrologOps  prolog( ops, ops + sizeof(ops) / sizeof(ops[0]) );
+
+    m_target.addFunction( 0x3000, 20, packedData( 20, 1, 3, 0, 3, 7 ) );
+
+    checkFunction( 0x3000, prolog, reversed(prolog), 20 - 6 );
+}
+
+TEST_F(UnwindArm64Test, PackedHomedArgs)
+{
+    // stp x19,x20,[sp,#-96]!; str lr,[sp,#16]; stp x0,x1,[sp,#24] ... stp x6,x7,[sp,#72]; sub sp,sp,#32
+    PrologOp  ops[] = {
+        { OpSavePreIndex, 19, 20, 96 },
+        { OpSave, 30, NoReg, 16 },
+        { OpSave, 0, 1, 24 },
+        { OpSave, 2, 3, 40 },
+        { OpSave, 4, 5, 56 },
+        { OpSave, 6, 7, 72 },
+        { OpAlloc, NoReg, NoReg, 32 }
+    };
+
+    // the epilog does not restore the homed args
+    PrologOp  epilogOps[] = {
+        { OpAlloc, NoReg, NoReg, 32 },
+        { OpSave, 30, NoReg, 16 },
+        { OpSavePreIndex, 19, 20, 96 }
+    };
+
+    PrologOps  prolog( ops, ops + sizeof(ops) / sizeof(ops[0]) );
+    PrologOps  epilog( epilogOps, epilogOps + sizeof(epilogOps) / sizeof(epilogOps[0]) );
+
+    m_target.addFunction( 0x4000, 24, packedData( 24, 0, 2, 1, 1, 8 ) );
+
+    checkFunction( 0x4000, prolog, epilog, 24 - 4 );
+}
+
+TEST_F(UnwindArm64Test, PackedLargeLocals)
+{
+    // sub sp,sp,#4080; sub sp,sp,#192
+    PrologOp  ops[] = {
+        { OpAlloc, NoReg, NoReg, 4080 },
+        { OpAlloc, NoReg, NoReg, 0x1100 - 4080 }
+    };
+
+    PrologOps  prolog( ops, ops + sizeof(ops) / sizeof(ops[0]) );
+
+    m_target.addFunction( 0x5000, 16, packedData( 16, 0, 0, 0, 0, 0x110 ) );
+
+    checkFunction( 0x5000, prolog, reversed(prolog), 16 - 3 );
+}
+
+TEST_F(UnwindArm64Test, PackedOddFloatRegs)
+{
+    // stp x19,lr,[sp,#-48]!; stp d8,d9,[sp,#16]; str d10,[sp,#32]; sub sp,sp,#16
+    PrologOp  ops[] = {
+        { OpSavePreIndex, 19, 30, 48 },
+        { OpSave, RegD0 + 8, RegD0 + 9, 16 },
+        { OpSave, RegD0 + 10, NoReg, 32 },
+        { OpAlloc, NoReg, NoReg, 16 }
+    };
+
+    PrologOps  prolog( ops, ops + sizeof(ops) / sizeof(ops[0]) );
+
+    m_target.addFunction( 0x6000, 16, packedData( 16, 2, 1, 0, 1, 4 ) );
+
+    checkFunction( 0x6000, prolog, reversed(prolog), 16 - 5 );
+}
+
+TEST_F(UnwindArm64Test, PackedLargeFrame)
+{
+    // stp x19,x20,[sp,#-16]!; sub sp,sp,#0x300; stp x29,lr,[sp]; mov x29,sp
+    PrologOp  ops[] = {
+        { OpSavePreIndex, 19, 20, 16 },
+        { OpAlloc, NoReg, NoReg, 0x300 },
+        { OpSave, 29, 30, 0 },
+        { OpSetFp, NoReg, NoReg, 0 }
+    };
+
+    PrologOps  prolog( ops, ops + sizeof(ops) / sizeof(ops[0]) );
+
+    m_target.addFunction( 0x7000, 16, packedData( 16, 0, 2, 0, 3, 0x31 ) );
+
+    checkFunction( 0x7000, prolog, reversed(prolog), 16 - 5 );
+}
+
+TEST_F(UnwindArm64Test, Stack)
+{
+    PrologOp  ops[] = {
+        { OpSavePreIndex, 19, 20, 16 },
+        { OpAlloc, NoReg, NoReg, 0x300 },
+        { OpSave, 29, 30, 0 },
+        { OpSetFp, NoReg, NoReg, 0 }
+    };
+
+    PrologOps  prolog( ops, ops + sizeof(ops) / sizeof(ops[0]) );
+
+    m_target.addFunction( 0x7000, 16, packedData( 16, 0, 2, 0, 3, 0x31 ) );
+
+    // the function calls itself: the return address is after the call in the body
+    const size_t  depth = 10;
+    const MEMOFFSET_64  returnAddress = ImageBase + 0x7000 + 4 * ( prolog.size() + 1 );
+
+    UnwindContextArm64  context = {};
+    context.sp = StackBase + 0xF000;
+
+    for ( size_t i = 0; i < depth; ++i )
+    {
+        context.x[UnwindRegLrArm64] = i == 0 ? 0 : returnAddress;
+
+        for ( size_t j = 0; j < prolog.size(); ++j )
+            runProlog( m_target, context, prolog[j] );
+    }
+
+    context.pc = returnAddress;
+
+    std::vector<UnwindFrameArm64>  frames;
+    unwindStackArm64( m_target, context, frames );
+
+    ASSERT_EQ( depth, frames.size() );
+
+    for ( size_t i = 1; i < frames.size(); ++i )
+    {
+        EXPECT_EQ( returnAddress, frames[i].context.pc );
+        EXPECT_EQ( frames[i - 1].context.sp + 0x310, frames[i].context.sp );
+    }
+}
+
+TEST_F(UnwindArm64Test, DISABLED_Benchmark)
+{
+    PrologOps  prolog = fullProlog();
+
+    boost::uint32_t  header = FullLength | ( 1 << 21 ) | ( 6u << 22 ) | ( 4u << 27 );
+
+    m_target.write( ImageBase + 0x8100, &header, sizeof(header) );
+    writeFullCodes( ImageBase + 0x8104 );
+
+    m_target.addFunction( 0x2000, FullLength, 0x8100 );
+
+    const MEMOFFSET_64  returnAddress = ImageBase + 0x2000 + 4 * ( prolog.size() + 1 );
+
+    UnwindContextArm64  context = {};
+    context.sp = StackBase + 0xF000;
+
+    for ( size_t i = 0; i < 100; ++i )
+    {
+        context.x[UnwindRegLrArm64] = i == 0 ? 0 : returnAddress;
+
+        for ( size_t j = 0; j < prolog.size(); ++j )
+            runProlog( m_target, context, prolog[j] );
+    }
+
+    context.pc = returnAddress;
+
+    const size_t  iterations = 10000;
+
+    std::vector<UnwindFrameArm64>  frames;
+    size_t  frameCount = 0;
+
+    long long  elapsed = measureMicroseconds( [&] {
+        unwindStackArm64( m_target, context, frames );
+        frameCount += frames.size();
+    }, iterations );
+
+    recordRate( "unwind_frames_per_s", frameCount, elapsed );
+}
+
+///////////////////////////////////////////////////////////////////////////////